@@ -894,6 +894,31 @@ ODE_API int dWorldGetAutoDisableFlag (dWorldID);
  */
 ODE_API void dWorldSetAutoDisableFlag (dWorldID, int do_auto_disable);
 
+/**
+ * @brief Get whether bodies are disabled by island.
+ * @ingroup disable
+ * @return 0 or 1
+ */
+ODE_API int dWorldGetAutoDisableIslands (dWorldID);
+
+/**
+ * @brief Disable bodies by island instead of one by one.
+ *
+ * An island is a set of bodies connected by enabled joints, including
+ * contact joints. The bodies of an island are only disabled once all of
+ * them are idle, so a resting stack sleeps at once and a body without
+ * auto-disable keeps the bodies it touches awake.
+ * @ingroup disable
+ * @param islands default is false.
+ */
+ODE_API void dWorldSetAutoDisableIslands (dWorldID, int islands);
+
+/**
+ * @brief Get the number of disabled bodies after the last step.
+ * @ingroup disable
+ */
+ODE_API int dWorldGetDisabledBodyCount (dWorldID);
+
 
 /**
  * @defgroup damping Damping
@@ -1132,6 +1157,65 @@ ODE_API int dBodyGetAutoDisableFlag (dBodyID);
  */
 ODE_API void dBodySetAutoDisableFlag (dBodyID, int do_auto_disable);
 
+/**
+ * @brief Get the idle time and steps left before the body is auto disabled.
+ * @ingroup bodies disable
+ * @param time_left seconds left, may be 0.
+ * @param steps_left steps left, may be 0.
+ */
+ODE_API void dBodyGetAutoDisableState (dBodyID, dReal *time_left,
+                                       int *steps_left);
+
+/**
+ * @brief Set the idle time and steps left before the body is auto disabled.
+ * @remarks
+ * The buffers of the average velocities are restarted.
+ * @ingroup bodies disable
+ * @param time_left seconds left.
+ * @param steps_left steps left.
+ */
+ODE_API void dBodySetAutoDisableState (dBodyID, dReal time_left,
+                                       int steps_left);
+
+/**
+ * @brief Get the state of the buffers of the average velocities.
+ * @ingroup bodies disable
+ * @param counter index of the next sample, may be 0.
+ * @param ready 1 if the buffers are full, may be 0.
+ */
+ODE_API void dBodyGetAutoDisableAverageState (dBodyID, unsigned int *counter,
+                                              int *ready);
+
+/**
+ * @brief Set the state of the buffers of the average velocities.
+ * @ingroup bodies disable
+ * @param counter index of the next sample, less than the samples count.
+ * @param ready 1 if the buffers are full.
+ */
+ODE_API void dBodySetAutoDisableAverageState (dBodyID, unsigned int counter,
+                                              int ready);
+
+/**
+ * @brief Get a sample of the buffers of the average velocities.
+ * @ingroup bodies disable
+ * @param index index of the sample, less than the samples count.
+ * @param lvel linear velocity, 3 values.
+ * @param avel angular velocity, 3 values.
+ */
+ODE_API void dBodyGetAutoDisableAverageSample (dBodyID, unsigned int index,
+                                               dReal *lvel, dReal *avel);
+
+/**
+ * @brief Set a sample of the buffers of the average velocities.
+ * @ingroup bodies disable
+ * @param index index of the sample, less than the samples count.
+ * @param lvel linear velocity, 3 values.
+ * @param avel angular velocity, 3 values.
+ */
+ODE_API void dBodySetAutoDisableAverageSample (dBodyID, unsigned int index,
+                                               const dReal *lvel,
+                                               const dReal *avel);
+
 /**
  * @brief Set auto disable defaults.
  * @remarks
@@ -2131,6 +2215,25 @@ ODE_API void dJointSetFeedback (dJointID, dJointFeedback *);
  */
 ODE_API dJointFeedback *dJointGetFeedback (dJointID);
 
+/**
+ * @brief Get the constraint forces of the last step, which warm start the
+ * quickstep solver at the next step.
+ * @ingroup joints
+ * @param lambda array of 6 values to fill.
+ * @param lambda_erp array of 6 values to fill.
+ */
+ODE_API void dJointGetWarmStart (dJointID, dReal *lambda, dReal *lambda_erp);
+
+/**
+ * @brief Set the constraint forces which warm start the quickstep solver
+ * at the next step.
+ * @ingroup joints
+ * @param lambda array of 6 values.
+ * @param lambda_erp array of 6 values.
+ */
+ODE_API void dJointSetWarmStart (dJointID, const dReal *lambda,
+                                 const dReal *lambda_erp);
+
 /**
  * @brief Set the joint anchor point.
  * @ingroup joints
@@ -0,0 +1,580 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001-2003 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+/*
+ *  Dynamic bounding volume hierarchy space.
+ *
+ *  Geoms with finite bounds are stored in the leaves of a balanced binary
+ *  tree of AABBs. Leaf boxes are slightly enlarged, so geoms that move a
+ *  little don't need to be reinserted every step. Geoms with infinite bounds,
+ *  such as planes, are kept out of the tree and tested against everything.
+ *
+ *  The geoms are also kept in the linked list of dxSpace, so enumeration,
+ *  dirty tracking and dSpaceCollide2 behave as for the other spaces.
+ */
+
+#include <vector>
+#include <unordered_map>
+
+#include <gazebo/ode/common.h>
+#include <gazebo/ode/matrix.h>
+#include <gazebo/ode/collision_space.h>
+#include <gazebo/ode/collision.h>
+#include "config.h"
+#include "collision_kernel.h"
+#include "collision_space_internal.h"
+
+#define GEOM_ENABLED(g) (((g)->gflags & GEOM_ENABLE_TEST_MASK) == GEOM_ENABLE_TEST_VALUE)
+
+// leaf boxes are enlarged by this fraction of their size, plus a minimum
+// margin, on each side
+#define BVH_MARGIN_RATIO REAL(0.1)
+#define BVH_MARGIN_MIN REAL(0.01)
+
+// maximum depth of the traversal stack. the tree is height balanced, so
+// this is never reached in practice
+#define BVH_STACK_SIZE 256
+
+static const int BVH_NULL_NODE = -1;
+
+
+static inline bool bvhFinite (const dReal *aabb)
+{
+  for (int i=0; i<6; i++) {
+    if (!(aabb[i] > -dInfinity && aabb[i] < dInfinity)) return false;
+  }
+  return true;
+}
+
+
+static inline bool bvhOverlap (const dReal *a, const dReal *b)
+{
+  return !(a[0] > b[1] || a[1] < b[0] ||
+	   a[2] > b[3] || a[3] < b[2] ||
+	   a[4] > b[5] || a[5] < b[4]);
+}
+
+
+static inline bool bvhContains (const dReal *outer, const dReal *inner)
+{
+  return outer[0] <= inner[0] && outer[1] >= inner[1] &&
+    outer[2] <= inner[2] && outer[3] >= inner[3] &&
+    outer[4] <= inner[4] && outer[5] >= inner[5];
+}
+
+
+static inline void bvhCombine (dReal *out, const dReal *a, const dReal *b)
+{
+  for (int i=0; i<6; i += 2) {
+    out[i] = a[i] < b[i] ? a[i] : b[i];
+    out[i+1] = a[i+1] > b[i+1] ? a[i+1] : b[i+1];
+  }
+}
+
+
+static inline dReal bvhArea (const dReal *a)
+{
+  dReal x = a[1] - a[0];
+  dReal y = a[3] - a[2];
+  dReal z = a[5] - a[4];
+  return 2 * (x*y + y*z + z*x);
+}
+
+
+struct dxBVHSpace : public dxSpace {
+  struct Node {
+    dReal aabb[6];	// enlarged box for leaves, union of children otherwise
+    dxGeom *geom;	// geom of a leaf, 0 for internal and free nodes
+    int parent;		// next free node when the node is free
+    int child1;
+    int child2;
+    int height;		// 0 for leaves, -1 for free nodes
+  };
+
+  std::vector<Node> nodes;
+  int root;
+  int free_list;
+
+  // leaf of each geom, BVH_NULL_NODE if the geom is not in the tree
+  std::unordered_map<dxGeom*, int> leaves;
+
+  dxBVHSpace (dSpaceID _space);
+
+  void add (dxGeom *);
+  void remove (dxGeom *);
+  void cleanGeoms();
+  void collide (void *data, dNearCallback *callback);
+  void collide2 (void *data, dxGeom *geom, dNearCallback *callback);
+
+private:
+  int allocateNode();
+  void freeNode (int id);
+  void insertLeaf (int leaf);
+  void removeLeaf (int leaf);
+  void refit (int id);
+  int balance (int id);
+  void updateGeom (dxGeom *g);
+  dReal insertionCost (int id, const dReal *box) const;
+
+  // call fn with every leaf whose box overlaps box
+  template <class Fn> void query (const dReal *box, Fn fn) const;
+};
+
+
+dxBVHSpace::dxBVHSpace (dSpaceID _space) : dxSpace (_space)
+{
+  type = dBVHSpaceClass;
+  root = BVH_NULL_NODE;
+  free_list = BVH_NULL_NODE;
+}
+
+
+int dxBVHSpace::allocateNode()
+{
+  int id;
+  if (free_list == BVH_NULL_NODE) {
+    id = (int) nodes.size();
+    nodes.push_back (Node());
+  }
+  else {
+    id = free_list;
+    free_list = nodes[id].parent;
+  }
+
+  Node &node = nodes[id];
+  node.geom = 0;
+  node.parent = BVH_NULL_NODE;
+  node.child1 = BVH_NULL_NODE;
+  node.child2 = BVH_NULL_NODE;
+  node.height = 0;
+  return id;
+}
+
+
+void dxBVHSpace::freeNode (int id)
+{
+  nodes[id].geom = 0;
+  nodes[id].height = -1;
+  nodes[id].parent = free_list;
+  free_list = id;
+}
+
+
+dReal dxBVHSpace::insertionCost (int id, const dReal *box) const
+{
+  dReal combined[6];
+  bvhCombine (combined, box, nodes[id].aabb);
+  if (nodes[id].child1 == BVH_NULL_NODE)
+    return bvhArea (combined);
+  return bvhArea (combined) - bvhArea (nodes[id].aabb);
+}
+
+
+void dxBVHSpace::insertLeaf (int leaf)
+{
+  if (root == BVH_NULL_NODE) {
+    root = leaf;
+    nodes[root].parent = BVH_NULL_NODE;
+    return;
+  }
+
+  // find the sibling that increases the surface area of the tree the least
+  dReal box[6];
+  memcpy (box,nodes[leaf].aabb,6*sizeof(dReal));
+
+  int index = root;
+  while (nodes[index].child1 != BVH_NULL_NODE) {
+    dReal combined[6];
+    bvhCombine (combined, nodes[index].aabb, box);
+    dReal area = bvhArea (nodes[index].aabb);
+    dReal combinedArea = bvhArea (combined);
+
+    // cost of a new parent for this node and the leaf, and the minimum cost
+    // of pushing the leaf further down
+    dReal cost = 2 * combinedArea;
+    dReal inheritance = 2 * (combinedArea - area);
+    dReal cost1 = insertionCost (nodes[index].child1, box) + inheritance;
+    dReal cost2 = insertionCost (nodes[index].child2, box) + inheritance;
+
+    if (cost < cost1 && cost < cost2) break;
+    index = cost1 < cost2 ? nodes[index].child1 : nodes[index].child2;
+  }
+
+  int sibling = index;
+  int oldParent = nodes[sibling].parent;
+  int newParent = allocateNode();
+  nodes[newParent].parent = oldParent;
+  bvhCombine (nodes[newParent].aabb, box, nodes[sibling].aabb);
+  nodes[newParent].height = nodes[sibling].height + 1;
+
+  if (oldParent != BVH_NULL_NODE) {
+    if (nodes[oldParent].child1 == sibling)
+      nodes[oldParent].child1 = newParent;
+    else
+      nodes[oldParent].child2 = newParent;
+  }
+  else {
+    root = newParent;
+  }
+  nodes[newParent].child1 = sibling;
+  nodes[newParent].child2 = leaf;
+  nodes[sibling].parent = newParent;
+  nodes[leaf].parent = newParent;
+
+  refit (newParent);
+}
+
+
+void dxBVHSpace::removeLeaf (int leaf)
+{
+  if (leaf == root) {
+    root = BVH_NULL_NODE;
+    return;
+  }
+
+  int parent = nodes[leaf].parent;
+  int grandParent = nodes[parent].parent;
+  int sibling = nodes[parent].child1 == leaf ?
+    nodes[parent].child2 : nodes[parent].child1;
+
+  // replace the parent with the sibling
+  if (grandParent != BVH_NULL_NODE) {
+    if (nodes[grandParent].child1 == parent)
+      nodes[grandParent].child1 = sibling;
+    else
+      nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    freeNode (parent);
+    refit (grandParent);
+  }
+  else {
+    root = sibling;
+    nodes[sibling].parent = BVH_NULL_NODE;
+    freeNode (parent);
+  }
+  nodes[leaf].parent = BVH_NULL_NODE;
+}
+
+
+void dxBVHSpace::refit (int id)
+{
+  while (id != BVH_NULL_NODE) {
+    id = balance (id);
+
+    Node &node = nodes[id];
+    const Node &child1 = nodes[node.child1];
+    const Node &child2 = nodes[node.child2];
+    node.height = 1 + (child1.height > child2.height ?
+		       child1.height : child2.height);
+    bvhCombine (node.aabb, child1.aabb, child2.aabb);
+
+    id = node.parent;
+  }
+}
+
+
+// rotate the taller child of id up if the subtree is unbalanced. returns the
+// new root of the subtree.
+int dxBVHSpace::balance (int iA)
+{
+  Node *A = &nodes[iA];
+  if (A->child1 == BVH_NULL_NODE || A->height < 2) return iA;
+
+  int iB = A->child1;
+  int iC = A->child2;
+  Node *B = &nodes[iB];
+  Node *C = &nodes[iC];
+
+  int balance = C->height - B->height;
+
+  // rotate C up
+  if (balance > 1) {
+    int iF = C->child1;
+    int iG = C->child2;
+    Node *F = &nodes[iF];
+    Node *G = &nodes[iG];
+
+    C->child1 = iA;
+    C->parent = A->parent;
+    A->parent = iC;
+
+    if (C->parent != BVH_NULL_NODE) {
+      if (nodes[C->parent].child1 == iA)
+	nodes[C->parent].child1 = iC;
+      else
+	nodes[C->parent].child2 = iC;
+    }
+    else {
+      root = iC;
+    }
+
+    if (F->height > G->height) {
+      C->child2 = iF;
+      A->child2 = iG;
+      G->parent = iA;
+      bvhCombine (A->aabb, B->aabb, G->aabb);
+      bvhCombine (C->aabb, A->aabb, F->aabb);
+      A->height = 1 + (B->height > G->height ? B->height : G->height);
+      C->height = 1 + (A->height > F->height ? A->height : F->height);
+    }
+    else {
+      C->child2 = iG;
+      A->child2 = iF;
+      F->parent = iA;
+      bvhCombine (A->aabb, B->aabb, F->aabb);
+      bvhCombine (C->aabb, A->aabb, G->aabb);
+      A->height = 1 + (B->height > F->height ? B->height : F->height);
+      C->height = 1 + (A->height > G->height ? A->height : G->height);
+    }
+    return iC;
+  }
+
+  // rotate B up
+  if (balance < -1) {
+    int iD = B->child1;
+    int iE = B->child2;
+    Node *D = &nodes[iD];
+    Node *E = &nodes[iE];
+
+    B->child1 = iA;
+    B->parent = A->parent;
+    A->parent = iB;
+
+    if (B->parent != BVH_NULL_NODE) {
+      if (nodes[B->parent].child1 == iA)
+	nodes[B->parent].child1 = iB;
+      else
+	nodes[B->parent].child2 = iB;
+    }
+    else {
+      root = iB;
+    }
+
+    if (D->height > E->height) {
+      B->child2 = iD;
+      A->child1 = iE;
+      E->parent = iA;
+      bvhCombine (A->aabb, C->aabb, E->aabb);
+      bvhCombine (B->aabb, A->aabb, D->aabb);
+      A->height = 1 + (C->height > E->height ? C->height : E->height);
+      B->height = 1 + (A->height > D->height ? A->height : D->height);
+    }
+    else {
+      B->child2 = iE;
+      A->child1 = iD;
+      D->parent = iA;
+      bvhCombine (A->aabb, C->aabb, D->aabb);
+      bvhCombine (B->aabb, A->aabb, E->aabb);
+      A->height = 1 + (C->height > D->height ? C->height : D->height);
+      B->height = 1 + (A->height > E->height ? A->height : E->height);
+    }
+    return iB;
+  }
+
+  return iA;
+}
+
+
+template <class Fn>
+void dxBVHSpace::query (const dReal *box, Fn fn) const
+{
+  if (root == BVH_NULL_NODE) return;
+
+  // a local stack keeps the query reentrant from the near callback
+  int stack[BVH_STACK_SIZE];
+  int size = 0;
+  stack[size++] = root;
+
+  while (size > 0) {
+    const Node &node = nodes[stack[--size]];
+    if (!bvhOverlap (node.aabb, box)) continue;
+
+    if (node.child1 == BVH_NULL_NODE) {
+      fn ((int) (&node - &nodes[0]));
+    }
+    else {
+      dIASSERT (size + 2 <= BVH_STACK_SIZE);
+      stack[size++] = node.child1;
+      stack[size++] = node.child2;
+    }
+  }
+}
+
+
+// update the tree after the AABB of a geom has been recomputed
+
+void dxBVHSpace::updateGeom (dxGeom *g)
+{
+  std::unordered_map<dxGeom*, int>::iterator it = leaves.find (g);
+  dIASSERT (it != leaves.end());
+  int leaf = it->second;
+
+  if (!bvhFinite (g->aabb)) {
+    if (leaf != BVH_NULL_NODE) {
+      removeLeaf (leaf);
+      freeNode (leaf);
+      it->second = BVH_NULL_NODE;
+    }
+    return;
+  }
+
+  if (leaf != BVH_NULL_NODE) {
+    // still inside its enlarged box
+    if (bvhContains (nodes[leaf].aabb, g->aabb)) return;
+    removeLeaf (leaf);
+  }
+  else {
+    leaf = allocateNode();
+    nodes[leaf].geom = g;
+    it->second = leaf;
+  }
+
+  dReal *box = nodes[leaf].aabb;
+  for (int i=0; i<6; i += 2) {
+    dReal margin = BVH_MARGIN_RATIO * (g->aabb[i+1] - g->aabb[i]) +
+      BVH_MARGIN_MIN;
+    box[i] = g->aabb[i] - margin;
+    box[i+1] = g->aabb[i+1] + margin;
+  }
+  insertLeaf (leaf);
+}
+
+
+void dxBVHSpace::add (dxGeom *g)
+{
+  CHECK_NOT_LOCKED (this);
+  // the geom is inserted in the tree once its AABB is known, in cleanGeoms()
+  leaves[g] = BVH_NULL_NODE;
+  dxSpace::add (g);
+}
+
+
+void dxBVHSpace::remove (dxGeom *g)
+{
+  CHECK_NOT_LOCKED (this);
+  std::unordered_map<dxGeom*, int>::iterator it = leaves.find (g);
+  if (it != leaves.end()) {
+    if (it->second != BVH_NULL_NODE) {
+      removeLeaf (it->second);
+      freeNode (it->second);
+    }
+    leaves.erase (it);
+  }
+  dxSpace::remove (g);
+}
+
+
+void dxBVHSpace::cleanGeoms()
+{
+  // compute the AABBs of all dirty geoms, which are at the front of the
+  // list, and move them in the tree
+  lock_count++;
+  for (dxGeom *g=first; g && (g->gflags & GEOM_DIRTY); g=g->next) {
+    if (IS_SPACE(g)) {
+      ((dxSpace*)g)->cleanGeoms();
+    }
+    g->recomputeAABB();
+    g->gflags &= (~(GEOM_DIRTY|GEOM_AABB_BAD));
+    updateGeom (g);
+  }
+  lock_count--;
+}
+
+
+void dxBVHSpace::collide (void *data, dNearCallback *callback)
+{
+  dAASSERT (callback);
+
+  lock_count++;
+  cleanGeoms();
+
+  // pairs of geoms in the tree, each pair is reported by the leaf with the
+  // lowest index
+  for (int i=0; i < (int) nodes.size(); i++) {
+    dxGeom *g1 = nodes[i].geom;
+    if (!g1 || !GEOM_ENABLED(g1)) continue;
+
+    query (g1->aabb, [&](int j) {
+      if (j <= i) return;
+      dxGeom *g2 = nodes[j].geom;
+      if (GEOM_ENABLED(g2)) collideAABBs (g1,g2,data,callback);
+    });
+  }
+
+  // geoms with infinite bounds are tested against everything else, and
+  // against the other infinite geoms that follow them in the list
+  for (dxGeom *g1=first; g1; g1=g1->next) {
+    if (!GEOM_ENABLED(g1) || bvhFinite (g1->aabb)) continue;
+
+    bool after = false;
+    for (dxGeom *g2=first; g2; g2=g2->next) {
+      if (g2 == g1) {
+	after = true;
+	continue;
+      }
+      if (!GEOM_ENABLED(g2)) continue;
+      if (!after && !bvhFinite (g2->aabb)) continue;
+      collideAABBs (g1,g2,data,callback);
+    }
+  }
+
+  lock_count--;
+}
+
+
+void dxBVHSpace::collide2 (void *data, dxGeom *geom,
+			   dNearCallback *callback)
+{
+  dAASSERT (geom && callback);
+
+  lock_count++;
+  cleanGeoms();
+  geom->recomputeAABB();
+
+  if (bvhFinite (geom->aabb)) {
+    query (geom->aabb, [&](int j) {
+      dxGeom *g = nodes[j].geom;
+      if (GEOM_ENABLED(g)) collideAABBs (g,geom,data,callback);
+    });
+  }
+  else {
+    for (int i=0; i < (int) nodes.size(); i++) {
+      dxGeom *g = nodes[i].geom;
+      if (g && GEOM_ENABLED(g)) collideAABBs (g,geom,data,callback);
+    }
+  }
+
+  for (dxGeom *g=first; g; g=g->next) {
+    if (GEOM_ENABLED(g) && !bvhFinite (g->aabb))
+      collideAABBs (g,geom,data,callback);
+  }
+
+  lock_count--;
+}
+
+//****************************************************************************
+// space functions
+
+dxSpace *dBVHSpaceCreate (dxSpace *space)
+{
+  return new dxBVHSpace (space);
+}
@@ -27,6 +27,7 @@
 #define _ODE_OBJECT_H_
 
 #include <limits>
+#include <vector>
 #include <gazebo/ode/common.h>
 #include <gazebo/ode/memory.h>
 #include <gazebo/ode/mass.h>
@@ -193,6 +194,9 @@ struct dxWorld : public dBase {
   dReal global_erp;    // global error reduction parameter
   dReal global_cfm;    // global constraint force mixing parameter
   dxAutoDisable adis;    // auto-disable parameters
+  int adis_islands;      // only disable islands whose bodies are all idle
+  std::vector<dxBody *> adis_island; // bodies of an island being disabled
+  int nb_disabled;       // number of disabled bodies at the last step
   int body_flags;               // flags for new bodies
   dxStepWorkingMemory *wmem; // Working memory object for dWorldStep/dWorldQuickStep
   std::vector<dxStepWorkingMemory *> island_wmems; // Working memory object for dWorldStep/dWorldQuickStep
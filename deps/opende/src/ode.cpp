@@ -1048,6 +1048,74 @@ void dBodySetAutoDisableFlag (dBodyID b, int do_auto_disable)
 }
 
 
+void dBodyGetAutoDisableState (dBodyID b, dReal *time_left, int *steps_left)
+{
+  dAASSERT(b);
+  if (time_left)
+    *time_left = b->adis_timeleft;
+  if (steps_left)
+    *steps_left = b->adis_stepsleft;
+}
+
+
+void dBodySetAutoDisableState (dBodyID b, dReal time_left, int steps_left)
+{
+  dAASSERT(b);
+  b->adis_timeleft = time_left;
+  b->adis_stepsleft = steps_left;
+  b->average_counter = 0;
+  b->average_ready = 0;
+}
+
+
+void dBodyGetAutoDisableAverageState (dBodyID b, unsigned int *counter,
+                                      int *ready)
+{
+  dAASSERT(b);
+  if (counter)
+    *counter = b->average_counter;
+  if (ready)
+    *ready = b->average_ready;
+}
+
+
+void dBodySetAutoDisableAverageState (dBodyID b, unsigned int counter,
+                                      int ready)
+{
+  dAASSERT(b);
+  dUASSERT(counter == 0 || counter < b->adis.average_samples,
+           "average counter out of range");
+  b->average_counter = counter;
+  b->average_ready = ready;
+}
+
+
+void dBodyGetAutoDisableAverageSample (dBodyID b, unsigned int index,
+                                       dReal *lvel, dReal *avel)
+{
+  dAASSERT(b && lvel && avel);
+  dUASSERT(index < b->adis.average_samples, "average sample out of range");
+  for (int i = 0; i < 3; ++i)
+  {
+    lvel[i] = b->average_lvel_buffer[index][i];
+    avel[i] = b->average_avel_buffer[index][i];
+  }
+}
+
+
+void dBodySetAutoDisableAverageSample (dBodyID b, unsigned int index,
+                                       const dReal *lvel, const dReal *avel)
+{
+  dAASSERT(b && lvel && avel);
+  dUASSERT(index < b->adis.average_samples, "average sample out of range");
+  for (int i = 0; i < 3; ++i)
+  {
+    b->average_lvel_buffer[index][i] = lvel[i];
+    b->average_avel_buffer[index][i] = avel[i];
+  }
+}
+
+
 void dBodySetAutoDisableDefaults (dBodyID b)
 {
   dAASSERT(b);
@@ -1543,6 +1611,23 @@ dJointFeedback *dJointGetFeedback (dxJoint *joint)
 }
 
 
+void dJointGetWarmStart (dxJoint *joint, dReal *lambda, dReal *lambda_erp)
+{
+  dAASSERT (joint && lambda && lambda_erp);
+  memcpy (lambda, joint->lambda, sizeof(joint->lambda));
+  memcpy (lambda_erp, joint->lambda_erp, sizeof(joint->lambda_erp));
+}
+
+
+void dJointSetWarmStart (dxJoint *joint, const dReal *lambda,
+                         const dReal *lambda_erp)
+{
+  dAASSERT (joint && lambda && lambda_erp);
+  memcpy (joint->lambda, lambda, sizeof(joint->lambda));
+  memcpy (joint->lambda_erp, lambda_erp, sizeof(joint->lambda_erp));
+}
+
+
 
 dJointID dConnectingJoint (dBodyID in_b1, dBodyID in_b2)
 {
@@ -1646,6 +1731,8 @@ dxWorld * dWorldCreate()
   w->adis.average_samples = 1;    // Default is 1 sample => Instantaneous velocity
   w->adis.angular_average_threshold = REAL(0.01)*REAL(0.01);  // (magnitude squared)
   w->adis.linear_average_threshold = REAL(0.01)*REAL(0.01);    // (magnitude squared)
+  w->adis_islands = 0;
+  w->nb_disabled = 0;
 
   w->qs.num_iterations = 20;
   w->qs.precon_iterations = 0;
@@ -2110,6 +2197,27 @@ void dWorldSetAutoDisableFlag (dWorldID w, int do_auto_disable)
 }
 
 
+int dWorldGetAutoDisableIslands (dWorldID w)
+{
+  dAASSERT(w);
+  return w->adis_islands;
+}
+
+
+void dWorldSetAutoDisableIslands (dWorldID w, int islands)
+{
+  dAASSERT(w);
+  w->adis_islands = islands ? 1 : 0;
+}
+
+
+int dWorldGetDisabledBodyCount (dWorldID w)
+{
+  dAASSERT(w);
+  return w->nb_disabled;
+}
+
+
 // world damping functions
 
 dReal dWorldGetLinearDampingThreshold(dWorldID w)
@@ -113,141 +113,221 @@ void dxWorldProcessContext::FreePreallocationsContext()
 //****************************************************************************
 // Auto disabling
 
-void dInternalHandleAutoDisabling (dxWorld *world, dReal stepsize)
+// update the idle countdown of an enabled auto-disable body from its
+// velocity samples, and return 1 if the body has been idle long enough
+// to be disabled.
+static int dxBodyIdleCountdown (dxBody *bb, dReal stepsize)
 {
-  dxBody *bb;
-  for ( bb=world->firstbody; bb; bb=(dxBody*)bb->next )
+  // if sampling / threshold testing is disabled, we can never sleep.
+  if ( bb->adis.average_samples == 0 ) return 0;
+
+  //
+  // see if the body is idle
+  //
+
+#ifndef dNODEBUG
+  // sanity check
+  if ( bb->average_counter >= bb->adis.average_samples )
   {
-    // don't freeze objects mid-air (patch 1586738)
-    if ( bb->firstjoint == NULL ) continue;
+    dUASSERT( bb->average_counter < bb->adis.average_samples, "buffer overflow" );
 
-    // nothing to do unless this body is currently enabled and has
-    // the auto-disable flag set
-    if ( (bb->flags & (dxBodyAutoDisable|dxBodyDisabled)) != dxBodyAutoDisable ) continue;
+    // something is going wrong, reset the average-calculations
+    bb->average_ready = 0; // not ready for average calculation
+    bb->average_counter = 0; // reset the buffer index
+  }
+#endif // dNODEBUG
 
-    // if sampling / threshold testing is disabled, we can never sleep.
-    if ( bb->adis.average_samples == 0 ) continue;
+  // sample the linear and angular velocity
+  bb->average_lvel_buffer[bb->average_counter][0] = bb->lvel[0];
+  bb->average_lvel_buffer[bb->average_counter][1] = bb->lvel[1];
+  bb->average_lvel_buffer[bb->average_counter][2] = bb->lvel[2];
+  bb->average_avel_buffer[bb->average_counter][0] = bb->avel[0];
+  bb->average_avel_buffer[bb->average_counter][1] = bb->avel[1];
+  bb->average_avel_buffer[bb->average_counter][2] = bb->avel[2];
+  bb->average_counter++;
+
+  // buffer ready test
+  if ( bb->average_counter >= bb->adis.average_samples )
+  {
+    bb->average_counter = 0; // fill the buffer from the beginning
+    bb->average_ready = 1; // this body is ready now for average calculation
+  }
 
-    //
-    // see if the body is idle
-    //
+  int idle = 0; // Assume it's in motion unless we have samples to disprove it.
 
-#ifndef dNODEBUG
-    // sanity check
-    if ( bb->average_counter >= bb->adis.average_samples )
+  // enough samples?
+  if ( bb->average_ready )
+  {
+    idle = 1; // Initial assumption: IDLE
+
+    // the sample buffers are filled and ready for calculation
+    dVector3 average_lvel, average_avel;
+
+    // Store first velocity samples
+    average_lvel[0] = bb->average_lvel_buffer[0][0];
+    average_avel[0] = bb->average_avel_buffer[0][0];
+    average_lvel[1] = bb->average_lvel_buffer[0][1];
+    average_avel[1] = bb->average_avel_buffer[0][1];
+    average_lvel[2] = bb->average_lvel_buffer[0][2];
+    average_avel[2] = bb->average_avel_buffer[0][2];
+
+    // If we're not in "instantaneous mode"
+    if ( bb->adis.average_samples > 1 )
     {
-      dUASSERT( bb->average_counter < bb->adis.average_samples, "buffer overflow" );
+      // add remaining velocities together
+      for ( unsigned int i = 1; i < bb->adis.average_samples; ++i )
+      {
+        average_lvel[0] += bb->average_lvel_buffer[i][0];
+        average_avel[0] += bb->average_avel_buffer[i][0];
+        average_lvel[1] += bb->average_lvel_buffer[i][1];
+        average_avel[1] += bb->average_avel_buffer[i][1];
+        average_lvel[2] += bb->average_lvel_buffer[i][2];
+        average_avel[2] += bb->average_avel_buffer[i][2];
+      }
+
+      // make average
+      dReal r1 = dReal( 1.0 ) / dReal( bb->adis.average_samples );
 
-      // something is going wrong, reset the average-calculations
-      bb->average_ready = 0; // not ready for average calculation
-      bb->average_counter = 0; // reset the buffer index
+      average_lvel[0] *= r1;
+      average_avel[0] *= r1;
+      average_lvel[1] *= r1;
+      average_avel[1] *= r1;
+      average_lvel[2] *= r1;
+      average_avel[2] *= r1;
     }
-#endif // dNODEBUG
 
-    // sample the linear and angular velocity
-    bb->average_lvel_buffer[bb->average_counter][0] = bb->lvel[0];
-    bb->average_lvel_buffer[bb->average_counter][1] = bb->lvel[1];
-    bb->average_lvel_buffer[bb->average_counter][2] = bb->lvel[2];
-    bb->average_avel_buffer[bb->average_counter][0] = bb->avel[0];
-    bb->average_avel_buffer[bb->average_counter][1] = bb->avel[1];
-    bb->average_avel_buffer[bb->average_counter][2] = bb->avel[2];
-    bb->average_counter++;
-
-    // buffer ready test
-    if ( bb->average_counter >= bb->adis.average_samples )
+    // threshold test
+    dReal av_lspeed, av_aspeed;
+    av_lspeed = dCalcVectorDot3( average_lvel, average_lvel );
+    if ( av_lspeed > bb->adis.linear_average_threshold )
     {
-      bb->average_counter = 0; // fill the buffer from the beginning
-      bb->average_ready = 1; // this body is ready now for average calculation
+      idle = 0; // average linear velocity is too high for idle
     }
-
-    int idle = 0; // Assume it's in motion unless we have samples to disprove it.
-
-    // enough samples?
-    if ( bb->average_ready )
+    else
     {
-      idle = 1; // Initial assumption: IDLE
+      av_aspeed = dCalcVectorDot3( average_avel, average_avel );
+      if ( av_aspeed > bb->adis.angular_average_threshold )
+      {
+        idle = 0; // average angular velocity is too high for idle
+      }
+    }
+  }
 
-      // the sample buffers are filled and ready for calculation
-      dVector3 average_lvel, average_avel;
+  // if it's idle, accumulate steps and time.
+  // the counters stop at zero, since an idle body can stay enabled while
+  // the rest of its island moves.
+  if (idle) {
+    if (bb->adis_stepsleft > 0)
+      bb->adis_stepsleft--;
+    if (bb->adis_timeleft > 0)
+      bb->adis_timeleft -= stepsize;
+  }
+  else {
+    // Reset countdowns
+    bb->adis_stepsleft = bb->adis.idle_steps;
+    bb->adis_timeleft = bb->adis.idle_time;
+  }
 
-      // Store first velocity samples
-      average_lvel[0] = bb->average_lvel_buffer[0][0];
-      average_avel[0] = bb->average_avel_buffer[0][0];
-      average_lvel[1] = bb->average_lvel_buffer[0][1];
-      average_avel[1] = bb->average_avel_buffer[0][1];
-      average_lvel[2] = bb->average_lvel_buffer[0][2];
-      average_avel[2] = bb->average_avel_buffer[0][2];
+  return bb->adis_stepsleft <= 0 && bb->adis_timeleft <= 0;
+}
 
-      // If we're not in "instantaneous mode"
-      if ( bb->adis.average_samples > 1 )
-      {
-        // add remaining velocities together
-        for ( unsigned int i = 1; i < bb->adis.average_samples; ++i )
-        {
-          average_lvel[0] += bb->average_lvel_buffer[i][0];
-          average_avel[0] += bb->average_avel_buffer[i][0];
-          average_lvel[1] += bb->average_lvel_buffer[i][1];
-          average_avel[1] += bb->average_avel_buffer[i][1];
-          average_lvel[2] += bb->average_lvel_buffer[i][2];
-          average_avel[2] += bb->average_avel_buffer[i][2];
-        }
+// disable a body and reset its velocity
+static void dxDisableIdleBody (dxBody *bb)
+{
+  bb->flags |= dxBodyDisabled; // set the disable flag
+  if (bb->disabled_callback)
+    bb->disabled_callback(bb);
+
+  // disabling bodies should also include resetting the velocity
+  // should prevent jittering in big "islands"
+  bb->lvel[0] = 0;
+  bb->lvel[1] = 0;
+  bb->lvel[2] = 0;
+  bb->avel[0] = 0;
+  bb->avel[1] = 0;
+  bb->avel[2] = 0;
+}
 
-        // make average
-        dReal r1 = dReal( 1.0 ) / dReal( bb->adis.average_samples );
+// disable the islands of bodies which are all idle. an island is a set
+// of bodies connected by enabled joints, including contact joints, so a
+// resting stack only sleeps once all of its bodies are idle, and a body
+// without auto-disable keeps the bodies it touches awake.
+static void dxHandleIslandAutoDisabling (dxWorld *world, dReal stepsize)
+{
+  dxBody *bb;
 
-        average_lvel[0] *= r1;
-        average_avel[0] *= r1;
-        average_lvel[1] *= r1;
-        average_avel[1] *= r1;
-        average_lvel[2] *= r1;
-        average_avel[2] *= r1;
-      }
+  // tag the enabled bodies which are ready to sleep. disabled bodies are
+  // ready too, so an idle island may include bodies which already sleep.
+  for ( bb=world->firstbody; bb; bb=(dxBody*)bb->next )
+  {
+    bb->island_tag = 0;
+    if ( bb->flags & dxBodyDisabled )
+      bb->tag = 1;
+    // don't freeze objects mid-air (patch 1586738)
+    else if ( bb->firstjoint == NULL || !(bb->flags & dxBodyAutoDisable) )
+      bb->tag = 0;
+    else
+      bb->tag = dxBodyIdleCountdown (bb, stepsize);
+  }
 
-      // threshold test
-      dReal av_lspeed, av_aspeed;
-      av_lspeed = dCalcVectorDot3( average_lvel, average_lvel );
-      if ( av_lspeed > bb->adis.linear_average_threshold )
-      {
-        idle = 0; // average linear velocity is too high for idle
-      }
-      else
+  std::vector<dxBody *> &island = world->adis_island;
+  for ( bb=world->firstbody; bb; bb=(dxBody*)bb->next )
+  {
+    // start an island from every enabled body which is ready to sleep
+    if ( bb->island_tag || !bb->tag || (bb->flags & dxBodyDisabled) )
+      continue;
+
+    island.clear();
+    island.push_back(bb);
+    bb->island_tag = 1;
+    int idle = 1;
+    for ( size_t i = 0; i < island.size(); ++i )
+    {
+      dxBody *b = island[i];
+      idle = idle && b->tag;
+      for ( dxJointNode *n=b->firstjoint; n; n=n->next )
       {
-        av_aspeed = dCalcVectorDot3( average_avel, average_avel );
-        if ( av_aspeed > bb->adis.angular_average_threshold )
+        dxBody *nbody = n->body;
+        if ( nbody && !nbody->island_tag && n->joint->isEnabled() )
         {
-          idle = 0; // average angular velocity is too high for idle
+          nbody->island_tag = 1;
+          island.push_back(nbody);
         }
       }
     }
 
-    // if it's idle, accumulate steps and time.
-    // these counters won't overflow because this code doesn't run for disabled bodies.
-    if (idle) {
-      bb->adis_stepsleft--;
-      bb->adis_timeleft -= stepsize;
-    }
-    else {
-      // Reset countdowns
-      bb->adis_stepsleft = bb->adis.idle_steps;
-      bb->adis_timeleft = bb->adis.idle_time;
+    if ( idle )
+    {
+      for ( size_t i = 0; i < island.size(); ++i )
+      {
+        if ( !(island[i]->flags & dxBodyDisabled) )
+          dxDisableIdleBody (island[i]);
+      }
     }
+  }
+}
+
+void dInternalHandleAutoDisabling (dxWorld *world, dReal stepsize)
+{
+  if ( world->adis_islands )
+  {
+    dxHandleIslandAutoDisabling (world, stepsize);
+    return;
+  }
+
+  dxBody *bb;
+  for ( bb=world->firstbody; bb; bb=(dxBody*)bb->next )
+  {
+    // don't freeze objects mid-air (patch 1586738)
+    if ( bb->firstjoint == NULL ) continue;
+
+    // nothing to do unless this body is currently enabled and has
+    // the auto-disable flag set
+    if ( (bb->flags & (dxBodyAutoDisable|dxBodyDisabled)) != dxBodyAutoDisable ) continue;
 
     // disable the body if it's idle for a long enough time
-    if ( bb->adis_stepsleft <= 0 && bb->adis_timeleft <= 0 )
-    {
-      bb->flags |= dxBodyDisabled; // set the disable flag
-      if (bb->disabled_callback)
-        bb->disabled_callback(bb);
-
-      // disabling bodies should also include resetting the velocity
-      // should prevent jittering in big "islands"
-      bb->lvel[0] = 0;
-      bb->lvel[1] = 0;
-      bb->lvel[2] = 0;
-      bb->avel[0] = 0;
-      bb->avel[1] = 0;
-      bb->avel[2] = 0;
-    }
+    if ( dxBodyIdleCountdown (bb, stepsize) )
+      dxDisableIdleBody (bb);
   }
 }
 
@@ -518,6 +598,9 @@ static size_t BuildIslandsAndEstimateStepperMemoryRequirements(dxWorldProcessCon
         }
       }
     }
+
+    // every enabled body belongs to an island
+    world->nb_disabled = world->nb - (int)(bodystart - body);
   } END_STATE_SAVE(context, stackstate);  // restores contex pointer m_pAllocCurrent back to what it was before this block
 
 # ifndef dNODEBUG
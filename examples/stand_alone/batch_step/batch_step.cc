@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <gazebo/gazebo.hh>
+#include <gazebo/common/common.hh>
+#include <gazebo/physics/physics.hh>
+
+/// \brief Total number of iterations measured for each batch size.
+static const unsigned int kIterations = 10000;
+
+/////////////////////////////////////////////////
+int main(int _argc, char **_argv)
+{
+  // Initialize gazebo.
+  gazebo::setupServer(_argc, _argv);
+
+  // Load a world. The world isn't run in its own thread, so the batches
+  // are stepped in this thread.
+  gazebo::physics::WorldPtr world = gazebo::loadWorld("worlds/empty.world");
+
+  // A pendulum driven by a torque
+  std::ostringstream sdf;
+  sdf << "<sdf version='1.6'><model name='pendulum'>"
+      << "<pose>0 0 1 0 0 0</pose>"
+      << "<link name='arm'><pose>0.25 0 0 0 0 0</pose>"
+      << "<inertial><mass>1</mass></inertial>"
+      << "<collision name='collision'><geometry><box>"
+      << "<size>0.5 0.05 0.05</size></box></geometry></collision></link>"
+      << "<joint name='hinge' type='revolute'>"
+      << "<parent>world</parent><child>arm</child>"
+      << "<pose>-0.25 0 0 0 0 0</pose>"
+      << "<axis><xyz>0 1 0</xyz></axis></joint>"
+      << "</model></sdf>";
+  world->InsertModelString(sdf.str());
+
+  // The model is inserted at the end of the first batch
+  gazebo::physics::BatchStepper stepper(world);
+  gazebo::physics::BatchObservation obs;
+  std::vector<gazebo::physics::BatchCommand> commands;
+  stepper.Step(1, commands, obs);
+
+  const int hinge = stepper.AddJoint("pendulum::hinge");
+  const int arm = stepper.AddLink("pendulum::arm");
+  if (hinge < 0 || arm < 0)
+  {
+    gazebo::shutdown();
+    return 1;
+  }
+
+  // Alternate the torque every 100 iterations
+  gazebo::physics::BatchCommand torque;
+  torque.type = gazebo::physics::BatchCommand::JOINT_FORCE;
+  torque.index = hinge;
+
+  for (unsigned int batch : {1u, 10u, 100u, 1000u})
+  {
+    gazebo::common::Time start = gazebo::common::Time::GetWallTime();
+    for (unsigned int i = 0; i < kIterations; i += batch)
+    {
+      commands.clear();
+      for (unsigned int j = 0; j < batch; j += 100)
+      {
+        torque.iteration = j;
+        torque.value = ((i + j) / 100) % 2 ? -5.0 : 5.0;
+        commands.push_back(torque);
+      }
+      stepper.Step(batch, commands, obs);
+    }
+    double elapsed = (gazebo::common::Time::GetWallTime() - start).Double();
+
+    std::cout << "Batch size[" << batch << "] steps per second["
+              << kIterations / elapsed << "] hinge angle["
+              << obs.jointPositions[0] << "]\n";
+  }
+
+  // Close everything.
+  gazebo::shutdown();
+}
@@ -24,7 +24,12 @@
 
 #include <stdio.h>
 #include <signal.h>
+#include <algorithm>
+#include <fstream>
 #include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
@@ -104,6 +109,9 @@ namespace gazebo
 
     /// \brief Set whether to lockstep physics and rendering
     bool lockstep = false;
+
+    /// \brief Number of copies of the world to load.
+    unsigned int worldCopies = 1;
   };
 }
 
@@ -169,6 +177,9 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("record_resources", "Recording with model meshes and materials.")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
+    ("world_copies", po::value<unsigned int>(),
+     "Number of independent copies of the world, each stepped in its own "
+     "thread.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
     ("server-plugin,s", po::value<std::vector<std::string> >(),
      "Load a plugin.")
@@ -287,6 +298,12 @@ bool Server::ParseArgs(int _argc, char **_argv)
     }
   }
 
+  if (this->dataPtr->vm.count("world_copies"))
+  {
+    this->dataPtr->worldCopies =
+      std::max(1u, this->dataPtr->vm["world_copies"].as<unsigned int>());
+  }
+
   if (this->dataPtr->vm.count("lockstep"))
   {
     this->dataPtr->lockstep = true;
@@ -358,7 +375,8 @@ bool Server::ParseArgs(int _argc, char **_argv)
       std::string profileName = this->dataPtr->vm["profile"].as<std::string>();
       if (physics::get_world()->PresetMgr()->HasProfile(profileName))
       {
-        physics::get_world()->PresetMgr()->CurrentProfile(profileName);
+        for (auto const &world : physics::get_worlds())
+          world->PresetMgr()->CurrentProfile(profileName);
         gzmsg << "Setting physics profile to [" << profileName << "]."
               << std::endl;
       }
@@ -394,6 +412,15 @@ bool Server::LoadFile(const std::string &_filename,
   }
   fclose(test);
 
+  // Start downloading the included models in parallel, the parser then
+  // waits for each of them as it resolves the includes.
+  {
+    std::ifstream file(common::find_file(_filename));
+    std::stringstream content;
+    content << file.rdbuf();
+    common::ModelDatabase::Instance()->PrefetchIncludes(content.str());
+  }
+
   // Load the world file
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
@@ -414,6 +441,9 @@ bool Server::LoadFile(const std::string &_filename,
 /////////////////////////////////////////////////
 bool Server::LoadString(const std::string &_sdfString)
 {
+  // Start downloading the included models in parallel
+  common::ModelDatabase::Instance()->PrefetchIncludes(_sdfString);
+
   // Load the world file
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
@@ -467,7 +497,32 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
   }
 
   sdf::ElementPtr worldElem = _elem->GetElement("world");
-  if (worldElem)
+  if (worldElem && this->dataPtr->worldCopies > 1)
+  {
+    // The copies share the meshes loaded in the MeshManager. Each copy is
+    // pinned to its own CPU when there are enough of them.
+    const unsigned int cpuCount = std::thread::hardware_concurrency();
+    const std::string worldName = worldElem->Get<std::string>("name");
+    for (unsigned int i = 0; i < this->dataPtr->worldCopies; ++i)
+    {
+      sdf::ElementPtr copyElem = worldElem->Clone();
+      copyElem->GetAttribute("name")->Set(worldName + "_" + std::to_string(i));
+
+      physics::WorldPtr world = physics::create_world();
+      if (this->dataPtr->worldCopies <= cpuCount)
+        world->SetCpuAffinity(i);
+
+      try
+      {
+        physics::load_world(world, copyElem);
+      }
+      catch(common::Exception &e)
+      {
+        gzthrow("Failed to load the World\n"  << e);
+      }
+    }
+  }
+  else if (worldElem)
   {
     physics::WorldPtr world = physics::create_world();
 
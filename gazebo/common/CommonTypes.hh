@@ -75,6 +75,7 @@ namespace gazebo
     class Battery;
     class Color;
     class DiagnosticTimer;
+    class FrameWriter;
     class Image;
     class Mesh;
     class SubMesh;
@@ -123,6 +124,10 @@ namespace gazebo
     /// \def BatteryPtr
     /// \brief Standrd shared pointer to a Battery object
     typedef std::shared_ptr<Battery> BatteryPtr;
+
+    /// \def FrameWriterPtr
+    /// \brief Standard shared pointer to a FrameWriter object
+    typedef std::shared_ptr<FrameWriter> FrameWriterPtr;
   }
 
   namespace event
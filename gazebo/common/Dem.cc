@@ -16,6 +16,8 @@
 */
 
 #include <algorithm>
+#include <cmath>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <gazebo/gazebo_config.h>
 
@@ -38,6 +40,9 @@ using namespace common;
 
 #ifdef HAVE_GDAL
 
+/// \brief Number of rows read at once when scanning the whole DEM.
+static const unsigned int kStripRows = 256;
+
 //////////////////////////////////////////////////
 Dem::Dem()
   : dataPtr(new DemPrivate)
@@ -49,8 +54,6 @@ Dem::Dem()
 //////////////////////////////////////////////////
 Dem::~Dem()
 {
-  this->dataPtr->demData.clear();
-
   if (this->dataPtr->dataSet)
     GDALClose(reinterpret_cast<GDALDataset *>(this->dataPtr->dataSet));
 
@@ -100,6 +103,7 @@ int Dem::Load(const std::string &_filename)
 
   // Set the pointer to the band
   this->dataPtr->band = this->dataPtr->dataSet->GetRasterBand(1);
+  this->dataPtr->demData.clear();
 
   // Raster width and height
   xSize = this->dataPtr->dataSet->GetRasterXSize();
@@ -154,14 +158,24 @@ int Dem::Load(const std::string &_filename)
   if (validNoData <= 0)
     noDataValue = defaultNoDataValue;
 
+  // Scan the terrain one strip of rows at a time, so that the whole DEM
+  // is never held in memory.
   double min = ignition::math::MAX_D;
   double max = -ignition::math::MAX_D;
-  for (auto d : this->dataPtr->demData)
+  std::vector<float> strip;
+  for (unsigned int y = 0; y < this->dataPtr->side; y += kStripRows)
   {
-    if (d < min && d > noDataValue)
-      min = d;
-    if (d > max && d > noDataValue)
-      max = d;
+    unsigned int rows = std::min(kStripRows, this->dataPtr->side - y);
+    if (this->ReadRegion(0, y, this->dataPtr->side, rows, strip) != 0)
+      return -1;
+
+    for (auto d : strip)
+    {
+      if (d < min && d > noDataValue)
+        min = d;
+      if (d > max && d > noDataValue)
+        max = d;
+    }
   }
   if (ignition::math::equal(min, ignition::math::MAX_D) ||
       ignition::math::equal(max, -ignition::math::MAX_D))
@@ -183,7 +197,17 @@ double Dem::GetElevation(double _x, double _y)
            " x " << this->GetHeight() << "]\n");
   }
 
-  return this->dataPtr->demData.at(_y * this->GetWidth() + _x);
+  // Elevations are usually queried for every point, read them all at once
+  if (this->LoadBuffer() != 0)
+    return this->dataPtr->minElevation;
+
+  // All the points outside of the resampled DEM are extra padding
+  unsigned int x = _x;
+  unsigned int y = _y;
+  if (x >= this->dataPtr->destWidth || y >= this->dataPtr->destHeight)
+    return 0.0;
+
+  return this->dataPtr->demData[y * this->dataPtr->destWidth + x];
 }
 
 //////////////////////////////////////////////////
@@ -265,6 +289,18 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
     const ignition::math::Vector3d &_size,
     const ignition::math::Vector3d &_scale,
     bool _flipY, std::vector<float> &_heights)
+{
+  this->FillHeightMapRegion(_subSampling, _vertSize, _size, _scale, _flipY,
+      0, 0, _vertSize, _vertSize, _heights);
+}
+
+//////////////////////////////////////////////////
+void Dem::FillHeightMapRegion(int _subSampling, unsigned int _vertSize,
+    const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale,
+    bool _flipY, unsigned int _x, unsigned int _y,
+    unsigned int _width, unsigned int _height,
+    std::vector<float> &_heights)
 {
   if (_subSampling <= 0)
   {
@@ -272,12 +308,45 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
     return;
   }
 
-  // Resize the vector to match the size of the vertices.
-  _heights.resize(_vertSize * _vertSize);
+  if (_x + _width > _vertSize || _y + _height > _vertSize)
+  {
+    gzerr << "Heightmap region [" << _x << ", " << _y << ", " << _width
+          << ", " << _height << "] is outside of the " << _vertSize << "x"
+          << _vertSize << " heightmap" << std::endl;
+    _heights.clear();
+    return;
+  }
+
+  // Resize the vector to match the size of the region.
+  _heights.resize(_width * _height);
+  if (_width == 0 || _height == 0)
+    return;
+
+  // The whole terrain is read at once when it is all needed. Otherwise
+  // read only the DEM window covering the region.
+  if (_width == _vertSize && _height == _vertSize && this->LoadBuffer() != 0)
+    return;
 
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
+  unsigned int sub = _subSampling;
+  unsigned int firstY = _flipY ? _vertSize - _y - _height : _y;
+  unsigned int lastY = _flipY ? _vertSize - _y - 1 : _y + _height - 1;
+  unsigned int demX = _x / sub;
+  unsigned int demY = firstY / sub;
+  unsigned int demWidth = std::min((_x + _width - 1 + sub - 1) / sub,
+      this->dataPtr->side - 1) - demX + 1;
+  unsigned int demHeight = std::min((lastY + sub - 1) / sub,
+      this->dataPtr->side - 1) - demY + 1;
+
+  std::vector<float> demData;
+  if (this->ReadRegion(demX, demY, demWidth, demHeight, demData) != 0)
+    return;
+
+  // Iterate over the vertices of the region
+  for (unsigned int row = _y; row < _y + _height; ++row)
   {
+    // Row of the terrain sampled by this row of the region
+    unsigned int y = _flipY ? _vertSize - row - 1 : row;
+
     double yf = y / static_cast<double>(_subSampling);
     unsigned int y1 = floor(yf);
     unsigned int y2 = ceil(yf);
@@ -285,7 +354,7 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
       y2 = this->dataPtr->side - 1;
     double dy = yf - y1;
 
-    for (unsigned int x = 0; x < _vertSize; ++x)
+    for (unsigned int x = _x; x < _x + _width; ++x)
     {
       double xf = x / static_cast<double>(_subSampling);
       unsigned int x1 = floor(xf);
@@ -294,12 +363,12 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
         x2 = this->dataPtr->side - 1;
       double dx = xf - x1;
 
-      double px1 = this->dataPtr->demData[y1 * this->dataPtr->side + x1];
-      double px2 = this->dataPtr->demData[y1 * this->dataPtr->side + x2];
+      double px1 = demData[(y1 - demY) * demWidth + x1 - demX];
+      double px2 = demData[(y1 - demY) * demWidth + x2 - demX];
       float h1 = (px1 - ((px1 - px2) * dx));
 
-      double px3 = this->dataPtr->demData[y2 * this->dataPtr->side + x1];
-      double px4 = this->dataPtr->demData[y2 * this->dataPtr->side + x2];
+      double px3 = demData[(y2 - demY) * demWidth + x1 - demX];
+      double px4 = demData[(y2 - demY) * demWidth + x2 - demX];
       float h2 = (px3 - ((px3 - px4) * dx));
 
       float h = this->dataPtr->minElevation +
@@ -316,10 +385,7 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
         h = this->dataPtr->minElevation;
 
       // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      _heights[(row - _y) * _width + (x - _x)] = h;
     }
   }
 }
@@ -327,12 +393,9 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
 //////////////////////////////////////////////////
 int Dem::LoadData()
 {
-    unsigned int destWidth;
-    unsigned int destHeight;
     unsigned int nXSize = this->dataPtr->dataSet->GetRasterXSize();
     unsigned int nYSize = this->dataPtr->dataSet->GetRasterYSize();
     float ratio;
-    std::vector<float> buffer;
 
     if (nXSize == 0 || nYSize == 0)
     {
@@ -345,40 +408,125 @@ int Dem::LoadData()
     if (nXSize > nYSize)
     {
       ratio = static_cast<float>(nXSize) / static_cast<float>(nYSize);
-      destWidth = this->dataPtr->side;
+      this->dataPtr->destWidth = this->dataPtr->side;
       // The decimal part is discarted for interpret the result as pixels
-      destHeight = static_cast<float>(destWidth) / static_cast<float>(ratio);
+      this->dataPtr->destHeight = static_cast<float>(
+          this->dataPtr->destWidth) / static_cast<float>(ratio);
     }
     else
     {
       ratio = static_cast<float>(nYSize) / static_cast<float>(nXSize);
-      destHeight = this->dataPtr->side;
+      this->dataPtr->destHeight = this->dataPtr->side;
       // The decimal part is discarted for interpret the result as pixels
-      destWidth = static_cast<float>(destHeight) / static_cast<float>(ratio);
+      this->dataPtr->destWidth = static_cast<float>(
+          this->dataPtr->destHeight) / static_cast<float>(ratio);
     }
 
-    // Read the whole raster data and convert it to a GDT_Float32 array.
-    // In this step the DEM is scaled to destWidth x destHeight
-    buffer.resize(destWidth * destHeight);
-    if (this->dataPtr->band->RasterIO(GF_Read, 0, 0, nXSize, nYSize, &buffer[0],
-                         destWidth, destHeight, GDT_Float32, 0, 0) != CE_None)
-    {
-      gzerr << "Failure calling RasterIO while loading a DEM file\n";
+#if GDAL_VERSION_NUM < 2000000
+    if (this->LoadBuffer() != 0)
       return -1;
-    }
+#endif
+
+    return 0;
+}
+
+//////////////////////////////////////////////////
+int Dem::LoadBuffer()
+{
+  if (!this->dataPtr->demData.empty())
+    return 0;
+
+  // Read the whole raster data and convert it to a GDT_Float32 array.
+  // In this step the DEM is scaled to destWidth x destHeight
+  std::vector<float> demData(
+      this->dataPtr->destWidth * this->dataPtr->destHeight);
+  if (this->dataPtr->band->RasterIO(GF_Read, 0, 0,
+        this->dataPtr->dataSet->GetRasterXSize(),
+        this->dataPtr->dataSet->GetRasterYSize(), &demData[0],
+        this->dataPtr->destWidth, this->dataPtr->destHeight,
+        GDT_Float32, 0, 0) != CE_None)
+  {
+    gzerr << "Failure calling RasterIO while loading a DEM file\n";
+    return -1;
+  }
+
+  this->dataPtr->demData.swap(demData);
+  return 0;
+}
 
-    // Copy and align 'buffer' into the target vector. The destination vector is
-    // initialized to 0, so all the points not contained in 'buffer' will be
-    // extra padding
-    this->dataPtr->demData.resize(this->GetWidth() * this->GetHeight());
-    for (unsigned int y = 0; y < destHeight; ++y)
+//////////////////////////////////////////////////
+int Dem::ReadRegion(unsigned int _x, unsigned int _y, unsigned int _width,
+    unsigned int _height, std::vector<float> &_data)
+{
+  // All the points outside of the resampled DEM are extra padding
+  _data.assign(_width * _height, 0.0f);
+
+  unsigned int destWidth = this->dataPtr->destWidth;
+  unsigned int destHeight = this->dataPtr->destHeight;
+  if (_x >= destWidth || _y >= destHeight || _width == 0 || _height == 0)
+    return 0;
+
+  unsigned int width = std::min(_x + _width, destWidth) - _x;
+  unsigned int height = std::min(_y + _height, destHeight) - _y;
+
+  // Copy from the whole terrain when it is in memory
+  if (!this->dataPtr->demData.empty())
+  {
+    for (unsigned int y = 0; y < height; ++y)
     {
-        std::copy(&buffer[destWidth * y], &buffer[destWidth * y] + destWidth,
-                  this->dataPtr->demData.begin() + this->GetWidth() * y);
+      auto row = this->dataPtr->demData.begin() + (_y + y) * destWidth + _x;
+      std::copy(row, row + width, _data.begin() + _width * y);
     }
-    buffer.clear();
-
     return 0;
+  }
+
+#if GDAL_VERSION_NUM >= 2000000
+  std::vector<float> buffer(width * height);
+
+  // Read the window of the raster that maps to the region when the whole
+  // raster is scaled to destWidth x destHeight. The floating point window
+  // keeps the nearest neighbour sampling identical to a full read.
+  int nXSize = this->dataPtr->dataSet->GetRasterXSize();
+  int nYSize = this->dataPtr->dataSet->GetRasterYSize();
+  double ratioX = nXSize / static_cast<double>(destWidth);
+  double ratioY = nYSize / static_cast<double>(destHeight);
+
+  GDALRasterIOExtraArg extraArg;
+  INIT_RASTERIO_EXTRA_ARG(extraArg);
+  extraArg.eResampleAlg = GRIORA_NearestNeighbour;
+  extraArg.bFloatingPointWindowValidity = TRUE;
+  extraArg.dfXOff = _x * ratioX;
+  extraArg.dfYOff = _y * ratioY;
+  extraArg.dfXSize = width * ratioX;
+  extraArg.dfYSize = height * ratioY;
+
+  int xOff = static_cast<int>(floor(extraArg.dfXOff));
+  int yOff = static_cast<int>(floor(extraArg.dfYOff));
+  int xEnd = std::min(nXSize, static_cast<int>(
+      ceil(extraArg.dfXOff + extraArg.dfXSize)));
+  int yEnd = std::min(nYSize, static_cast<int>(
+      ceil(extraArg.dfYOff + extraArg.dfYSize)));
+
+  if (this->dataPtr->band->RasterIO(GF_Read, xOff, yOff,
+        std::max(1, xEnd - xOff), std::max(1, yEnd - yOff), &buffer[0],
+        width, height, GDT_Float32, 0, 0, &extraArg) != CE_None)
+  {
+    gzerr << "Failure calling RasterIO while reading a DEM file\n";
+    return -1;
+  }
+
+  // Copy and align 'buffer' into the target vector
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    std::copy(&buffer[width * y], &buffer[width * y] + width,
+              _data.begin() + _width * y);
+  }
+
+  return 0;
+#else
+  gzerr << "DEM data isn't loaded\n";
+  return -1;
+#endif
 }
 
 #endif
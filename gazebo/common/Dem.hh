@@ -54,7 +54,8 @@ namespace gazebo
       /// \return 0 when the operation succeeds to open a file.
       public: int Load(const std::string &_filename="");
 
-      /// \brief Get the elevation of a terrain's point in meters.
+      /// \brief Get the elevation of a terrain's point in meters. The whole
+      /// terrain is read in memory on the first call.
       /// \param[in] _x X coordinate of the terrain.
       /// \param[in] _y Y coordinate of the terrain.
       /// \return Terrain's elevation at (x,y) in meters.
@@ -118,6 +119,15 @@ namespace gazebo
                   const bool _flipY,
                   std::vector<float> &_heights);
 
+      // Documentation inherited.
+      public: void FillHeightMapRegion(int _subSampling,
+                  unsigned int _vertSize,
+                  const ignition::math::Vector3d &_size,
+                  const ignition::math::Vector3d &_scale,
+                  bool _flipY, unsigned int _x, unsigned int _y,
+                  unsigned int _width, unsigned int _height,
+                  std::vector<float> &_heights);
+
       /// \brief Get the georeferenced coordinates (lat, long) of a terrain's
       /// pixel in WGS84.
       /// \param[in] _x X coordinate of the terrain.
@@ -128,12 +138,31 @@ namespace gazebo
                                     ignition::math::Angle &_latitude,
                                     ignition::math::Angle &_longitude) const;
 
-      /// \brief Get the terrain file as a data array. Due to the Ogre
-      /// constrains, the data might be stored in a bigger vector representing
-      /// a squared terrain with padding.
-      /// \return 0 when the operation succeeds to open a file.
+      /// \brief Compute the size of the resampled terrain. Due to the Ogre
+      /// constrains, the data is accessed as a bigger squared terrain with
+      /// padding.
+      /// \return 0 when the operation succeeds.
       private: int LoadData();
 
+      /// \brief Read the whole resampled terrain in memory, if it isn't
+      /// already.
+      /// \return 0 when the operation succeeds.
+      private: int LoadBuffer();
+
+      /// \brief Read a region of the resampled and padded terrain. Unless
+      /// the whole terrain is in memory, only the part of the DEM file
+      /// covering the region is read.
+      /// \param[in] _x First column of the region.
+      /// \param[in] _y First row of the region.
+      /// \param[in] _width Number of columns of the region.
+      /// \param[in] _height Number of rows of the region.
+      /// \param[out] _data Row-major elevations of the region, 0 in the
+      /// padding.
+      /// \return 0 when the operation succeeds.
+      private: int ReadRegion(unsigned int _x, unsigned int _y,
+                   unsigned int _width, unsigned int _height,
+                   std::vector<float> &_data);
+
       /// internal
       /// \brief Pointer to the private data.
       private: DemPrivate *dataPtr;
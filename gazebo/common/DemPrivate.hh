@@ -57,7 +57,15 @@ namespace gazebo
       /// \brief Maximum elevation in meters.
       public: double maxElevation;
 
-      /// \brief DEM data converted to be OGRE-compatible.
+      /// \brief Width of the resampled DEM, before the padding.
+      public: unsigned int destWidth;
+
+      /// \brief Height of the resampled DEM, before the padding.
+      public: unsigned int destHeight;
+
+      /// \brief Whole resampled DEM, before the padding. Only read when the
+      /// whole terrain is needed, or with GDAL versions that can't read a
+      /// window with the same resampling as a full read.
       public: std::vector<float> demData;
     };
     /// \}
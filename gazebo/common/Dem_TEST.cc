@@ -167,6 +167,55 @@ TEST_F(DemTest, FillHeightmap)
   EXPECT_FLOAT_EQ(213.42966, elevations.at(elevations.size() / 2));
 }
 
+/////////////////////////////////////////////////
+TEST_F(DemTest, FillHeightmapRegion)
+{
+  common::Dem dem;
+  boost::filesystem::path path = TEST_PATH;
+
+  path /= "data/dem_portrait.tif";
+  EXPECT_EQ(dem.Load(path.string()), 0);
+
+  int subsampling = 2;
+  unsigned int vertSize = (dem.GetWidth() * subsampling) - 1;
+  ignition::math::Vector3d size(dem.GetWorldWidth(), dem.GetWorldHeight(),
+      dem.GetMaxElevation() - dem.GetMinElevation());
+  ignition::math::Vector3d scale(size.X() / vertSize, size.Y() / vertSize,
+      fabs(size.Z()) / dem.GetMaxElevation());
+
+  // A region, read from a window of the DEM file, must match the same part
+  // of the full lookup table, including the padding
+  for (bool flipY : {false, true})
+  {
+    std::vector<float> elevations;
+    dem.FillHeightMap(subsampling, vertSize, size, scale, flipY, elevations);
+    ASSERT_EQ(vertSize * vertSize, elevations.size());
+
+    const unsigned int regions[][4] = {
+      {0, 0, vertSize, 1},
+      {17, 3, 33, 65},
+      {vertSize / 3, vertSize - 20, vertSize - vertSize / 3, 20},
+      {vertSize - 1, vertSize - 1, 1, 1}};
+
+    for (auto const &r : regions)
+    {
+      std::vector<float> region;
+      dem.FillHeightMapRegion(subsampling, vertSize, size, scale, flipY,
+          r[0], r[1], r[2], r[3], region);
+      ASSERT_EQ(r[2] * r[3], region.size());
+
+      for (unsigned int y = 0; y < r[3]; ++y)
+      {
+        for (unsigned int x = 0; x < r[2]; ++x)
+        {
+          EXPECT_FLOAT_EQ(elevations[(r[1] + y) * vertSize + r[0] + x],
+              region[y * r[2] + x]);
+        }
+      }
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 TEST_F(DemTest, NegDem)
 {
@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <FreeImage.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/FrameWriter.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Private data for the FrameWriter class
+class gazebo::common::FrameWriterPrivate
+{
+  /// \brief Worker threads.
+  public: std::vector<std::thread> threads;
+
+  /// \brief Queued jobs.
+  public: std::deque<std::function<void()>> jobs;
+
+  /// \brief Maximum number of queued jobs.
+  public: unsigned int capacity = 16;
+
+  /// \brief Number of jobs being run.
+  public: unsigned int running = 0;
+
+  /// \brief Number of dropped frames.
+  public: uint64_t dropped = 0;
+
+  /// \brief Backpressure policy.
+  public: FrameWriter::Policy policy = FrameWriter::BLOCK;
+
+  /// \brief File format of the saved frames.
+  public: FrameWriter::FileFormat format = FrameWriter::PNG;
+
+  /// \brief PNG compression level or JPEG quality.
+  public: int level = -1;
+
+  /// \brief True when the workers must stop.
+  public: bool stop = false;
+
+  /// \brief Protects the members above.
+  public: mutable std::mutex mutex;
+
+  /// \brief Signaled when a job is queued or the workers must stop.
+  public: std::condition_variable queued;
+
+  /// \brief Signaled when a job is started or done.
+  public: std::condition_variable done;
+};
+
+/////////////////////////////////////////////////
+FrameWriter::FrameWriter(const unsigned int _threads,
+    const unsigned int _capacity, const Policy _policy)
+  : dataPtr(new FrameWriterPrivate)
+{
+  this->dataPtr->capacity = std::max(_capacity, 1u);
+  this->dataPtr->policy = _policy;
+
+  for (unsigned int i = 0; i < std::max(_threads, 1u); ++i)
+    this->dataPtr->threads.emplace_back(&FrameWriter::Run, this);
+}
+
+/////////////////////////////////////////////////
+FrameWriter::~FrameWriter()
+{
+  this->Flush();
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->queued.notify_all();
+
+  for (auto &thread : this->dataPtr->threads)
+    thread.join();
+}
+
+/////////////////////////////////////////////////
+void FrameWriter::SetFileFormat(const FileFormat _format, const int _level)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->format = _format;
+  this->dataPtr->level = _level;
+}
+
+/////////////////////////////////////////////////
+FrameWriter::FileFormat FrameWriter::Format() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->format;
+}
+
+/////////////////////////////////////////////////
+int FrameWriter::Level() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->level;
+}
+
+/////////////////////////////////////////////////
+std::string FrameWriter::Extension() const
+{
+  switch (this->Format())
+  {
+    case JPEG:
+      return "jpg";
+    case RAW:
+      return "raw";
+    case PNG:
+    default:
+      return "png";
+  }
+}
+
+/////////////////////////////////////////////////
+void FrameWriter::SetPolicy(const Policy _policy)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->policy = _policy;
+  }
+
+  // Blocked callers drop their frame
+  this->dataPtr->done.notify_all();
+}
+
+/////////////////////////////////////////////////
+FrameWriter::Policy FrameWriter::BackpressurePolicy() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->policy;
+}
+
+/////////////////////////////////////////////////
+unsigned int FrameWriter::Capacity() const
+{
+  return this->dataPtr->capacity;
+}
+
+/////////////////////////////////////////////////
+unsigned int FrameWriter::ThreadCount() const
+{
+  return this->dataPtr->threads.size();
+}
+
+/////////////////////////////////////////////////
+bool FrameWriter::Supports(const Image::PixelFormat _format) const
+{
+  switch (this->Format())
+  {
+    case RAW:
+      return PixelSize(_format) > 0;
+    case PNG:
+    case JPEG:
+    default:
+      return _format == Image::L_INT8 || _format == Image::RGB_INT8 ||
+          _format == Image::BGR_INT8 || _format == Image::RGBA_INT8 ||
+          _format == Image::BGRA_INT8;
+  }
+}
+
+/////////////////////////////////////////////////
+bool FrameWriter::Save(const unsigned char *_data,
+    const unsigned int _width, const unsigned int _height,
+    const Image::PixelFormat _format, const std::string &_filename)
+{
+  if (!_data || !this->Supports(_format))
+  {
+    gzerr << "Unable to save frame[" << _filename << "] with pixel format["
+          << PixelFormatNames[_format] << "] in the ." << this->Extension()
+          << " format\n";
+    return false;
+  }
+
+  FileFormat fileFormat;
+  int level;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    fileFormat = this->dataPtr->format;
+    level = this->dataPtr->level;
+  }
+
+  // The caller reuses its buffer for the next frame
+  auto frame = std::make_shared<std::vector<unsigned char>>(_data,
+      _data + _width * _height * PixelSize(_format));
+
+  return this->Push([frame, _width, _height, _format, _filename, fileFormat,
+      level]()
+      {
+        FrameWriter::Write(frame->data(), _width, _height, _format,
+            _filename, fileFormat, level);
+      });
+}
+
+/////////////////////////////////////////////////
+bool FrameWriter::Push(const std::function<void()> &_job)
+{
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+    while (this->dataPtr->jobs.size() >= this->dataPtr->capacity &&
+           this->dataPtr->policy == BLOCK)
+    {
+      this->dataPtr->done.wait(lock);
+    }
+
+    if (this->dataPtr->jobs.size() >= this->dataPtr->capacity)
+    {
+      ++this->dataPtr->dropped;
+      return false;
+    }
+
+    this->dataPtr->jobs.push_back(_job);
+  }
+
+  this->dataPtr->queued.notify_one();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void FrameWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  while (!this->dataPtr->jobs.empty() || this->dataPtr->running > 0)
+    this->dataPtr->done.wait(lock);
+}
+
+/////////////////////////////////////////////////
+unsigned int FrameWriter::Pending() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->jobs.size() + this->dataPtr->running;
+}
+
+/////////////////////////////////////////////////
+uint64_t FrameWriter::Dropped() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->dropped;
+}
+
+/////////////////////////////////////////////////
+void FrameWriter::Run()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  while (true)
+  {
+    while (this->dataPtr->jobs.empty() && !this->dataPtr->stop)
+      this->dataPtr->queued.wait(lock);
+
+    if (this->dataPtr->jobs.empty())
+      return;
+
+    std::function<void()> job = std::move(this->dataPtr->jobs.front());
+    this->dataPtr->jobs.pop_front();
+    ++this->dataPtr->running;
+
+    // There is room for a blocked caller
+    this->dataPtr->done.notify_all();
+
+    lock.unlock();
+    job();
+    lock.lock();
+
+    --this->dataPtr->running;
+    this->dataPtr->done.notify_all();
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int FrameWriter::PixelSize(const Image::PixelFormat _format)
+{
+  switch (_format)
+  {
+    case Image::L_INT8:
+    case Image::BAYER_RGGB8:
+    case Image::BAYER_BGGR8:
+    case Image::BAYER_GBRG8:
+    case Image::BAYER_GRBG8:
+      return 1;
+    case Image::L_INT16:
+    case Image::R_FLOAT16:
+      return 2;
+    case Image::RGB_INT8:
+    case Image::BGR_INT8:
+      return 3;
+    case Image::RGBA_INT8:
+    case Image::BGRA_INT8:
+    case Image::R_FLOAT32:
+      return 4;
+    case Image::RGB_INT16:
+    case Image::BGR_INT16:
+    case Image::RGB_FLOAT16:
+      return 6;
+    case Image::RGB_INT32:
+    case Image::BGR_INT32:
+    case Image::RGB_FLOAT32:
+      return 12;
+    default:
+      return 0;
+  }
+}
+
+/////////////////////////////////////////////////
+bool FrameWriter::Write(const unsigned char *_data,
+    const unsigned int _width, const unsigned int _height,
+    const Image::PixelFormat _format, const std::string &_filename,
+    const FileFormat _fileFormat, const int _level)
+{
+  const unsigned int pixelSize = PixelSize(_format);
+
+  if (_fileFormat == RAW)
+  {
+    std::ofstream file(_filename, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char *>(_data),
+        static_cast<std::streamsize>(_width) * _height * pixelSize);
+    if (!file)
+    {
+      gzerr << "Unable to write frame[" << _filename << "]\n";
+      return false;
+    }
+    return true;
+  }
+
+  // Channel offsets in the input pixels
+  int red, green, blue, alpha = -1;
+  switch (_format)
+  {
+    case Image::L_INT8:
+      red = green = blue = 0;
+      break;
+    case Image::RGB_INT8:
+      red = 0; green = 1; blue = 2;
+      break;
+    case Image::BGR_INT8:
+      red = 2; green = 1; blue = 0;
+      break;
+    case Image::RGBA_INT8:
+      red = 0; green = 1; blue = 2; alpha = 3;
+      break;
+    case Image::BGRA_INT8:
+      red = 2; green = 1; blue = 0; alpha = 3;
+      break;
+    default:
+      gzerr << "Unable to encode frame[" << _filename << "] with pixel format["
+            << PixelFormatNames[_format] << "]\n";
+      return false;
+  }
+
+  // JPEG has no alpha channel
+  const bool grey = _format == Image::L_INT8;
+  const bool keepAlpha = alpha >= 0 && _fileFormat == PNG;
+  const unsigned int bpp = grey ? 8 : (keepAlpha ? 32 : 24);
+
+  FIBITMAP *bitmap = FreeImage_Allocate(_width, _height, bpp);
+  if (!bitmap)
+  {
+    gzerr << "Unable to allocate frame[" << _filename << "]\n";
+    return false;
+  }
+
+  if (grey)
+  {
+    RGBQUAD *palette = FreeImage_GetPalette(bitmap);
+    for (unsigned int i = 0; i < 256; ++i)
+    {
+      palette[i].rgbRed = palette[i].rgbGreen = palette[i].rgbBlue =
+          static_cast<BYTE>(i);
+    }
+  }
+
+  // FreeImage stores the rows bottom up, with its own channel order
+  const unsigned int outSize = bpp / 8;
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    const unsigned char *in = _data + y * _width * pixelSize;
+    BYTE *out = FreeImage_GetScanLine(bitmap, _height - 1 - y);
+    if (grey)
+    {
+      std::copy(in, in + _width, out);
+      continue;
+    }
+
+    for (unsigned int x = 0; x < _width; ++x, in += pixelSize, out += outSize)
+    {
+      out[FI_RGBA_RED] = in[red];
+      out[FI_RGBA_GREEN] = in[green];
+      out[FI_RGBA_BLUE] = in[blue];
+      if (keepAlpha)
+        out[FI_RGBA_ALPHA] = in[alpha];
+    }
+  }
+
+  int flags;
+  FREE_IMAGE_FORMAT fif;
+  if (_fileFormat == JPEG)
+  {
+    fif = FIF_JPEG;
+    flags = _level < 0 ? JPEG_DEFAULT : std::min(std::max(_level, 1), 100);
+  }
+  else
+  {
+    fif = FIF_PNG;
+    if (_level < 0)
+      flags = PNG_DEFAULT;
+    else if (_level == 0)
+      flags = PNG_Z_NO_COMPRESSION;
+    else
+      flags = std::min(_level, 9);
+  }
+
+  const bool result = FreeImage_Save(fif, bitmap, _filename.c_str(), flags);
+  FreeImage_Unload(bitmap);
+
+  if (!result)
+    gzerr << "Unable to write frame[" << _filename << "]\n";
+  return result;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_FRAMEWRITER_HH_
+#define GAZEBO_COMMON_FRAMEWRITER_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/Image.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class
+    class FrameWriterPrivate;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class FrameWriter FrameWriter.hh common/common.hh
+    /// \brief Saves and encodes image frames on a pool of worker threads,
+    /// so that the thread producing the frames doesn't wait for image
+    /// compression or disk writes. Frames are copied into a bounded queue;
+    /// when the queue is full new frames are either dropped or the caller
+    /// waits for room, depending on the backpressure policy.
+    ///
+    /// A writer can be shared, for instance by all the cameras saving
+    /// frames of a dataset.
+    class GZ_COMMON_VISIBLE FrameWriter
+    {
+      /// \brief What to do with a frame when the queue is full.
+      public: enum Policy
+              {
+                /// \brief Drop the frame.
+                DROP,
+
+                /// \brief Wait until there is room in the queue.
+                BLOCK
+              };
+
+      /// \brief File format of the saved frames.
+      public: enum FileFormat
+              {
+                /// \brief PNG, lossless. The level is the zlib compression
+                /// level, from 0 (none) to 9 (best).
+                PNG,
+
+                /// \brief JPEG, lossy. The level is the quality, from 1 to
+                /// 100.
+                JPEG,
+
+                /// \brief The pixels as they are in memory, without header.
+                RAW
+              };
+
+      /// \brief Constructor.
+      /// \param[in] _threads Number of worker threads, at least 1.
+      /// \param[in] _capacity Maximum number of queued frames, at least 1.
+      /// \param[in] _policy What to do with a frame when the queue is full.
+      public: explicit FrameWriter(const unsigned int _threads = 1,
+                  const unsigned int _capacity = 16,
+                  const Policy _policy = BLOCK);
+
+      /// \brief Destructor. Waits for the queued frames to be written.
+      public: virtual ~FrameWriter();
+
+      /// \brief Set the file format of the frames saved with Save().
+      /// \param[in] _format File format.
+      /// \param[in] _level PNG compression level or JPEG quality, -1 for
+      /// the default of the format.
+      public: void SetFileFormat(const FileFormat _format,
+                  const int _level = -1);
+
+      /// \brief Get the file format of the frames saved with Save().
+      /// \return File format.
+      public: FileFormat Format() const;
+
+      /// \brief Get the PNG compression level or JPEG quality.
+      /// \return Level, -1 for the default of the format.
+      public: int Level() const;
+
+      /// \brief Get the file extension of the file format, without dot.
+      /// \return "png", "jpg" or "raw".
+      public: std::string Extension() const;
+
+      /// \brief Set what to do with a frame when the queue is full.
+      /// \param[in] _policy Backpressure policy.
+      public: void SetPolicy(const Policy _policy);
+
+      /// \brief Get what is done with a frame when the queue is full.
+      /// \return Backpressure policy.
+      public: Policy BackpressurePolicy() const;
+
+      /// \brief Get the maximum number of queued frames.
+      /// \return Capacity of the queue.
+      public: unsigned int Capacity() const;
+
+      /// \brief Get the number of worker threads.
+      /// \return Number of threads.
+      public: unsigned int ThreadCount() const;
+
+      /// \brief Whether frames of a pixel format can be saved in the current
+      /// file format.
+      /// \param[in] _format Pixel format.
+      /// \return True if Save() accepts the pixel format.
+      public: bool Supports(const Image::PixelFormat _format) const;
+
+      /// \brief Queue a copy of a frame to be saved in the current file
+      /// format.
+      /// \param[in] _data Pixels, row by row from the top of the image.
+      /// \param[in] _width Width of the frame in pixels.
+      /// \param[in] _height Height of the frame in pixels.
+      /// \param[in] _format Pixel format.
+      /// \param[in] _filename Path of the file to write.
+      /// \return False if the pixel format isn't supported or the frame
+      /// was dropped.
+      public: bool Save(const unsigned char *_data,
+                  const unsigned int _width, const unsigned int _height,
+                  const Image::PixelFormat _format,
+                  const std::string &_filename);
+
+      /// \brief Queue a job, such as encoding a video frame. Jobs are
+      /// started in order, but run concurrently on the worker threads.
+      /// \param[in] _job Function to run on a worker thread.
+      /// \return False if the job was dropped.
+      public: bool Push(const std::function<void()> &_job);
+
+      /// \brief Wait until all the queued frames are written.
+      public: void Flush();
+
+      /// \brief Get the number of queued or running jobs.
+      /// \return Number of jobs.
+      public: unsigned int Pending() const;
+
+      /// \brief Get the number of frames dropped because the queue was
+      /// full.
+      /// \return Number of dropped frames.
+      public: uint64_t Dropped() const;
+
+      /// \brief Write a frame to a file on the calling thread.
+      /// \param[in] _data Pixels, row by row from the top of the image.
+      /// \param[in] _width Width of the frame in pixels.
+      /// \param[in] _height Height of the frame in pixels.
+      /// \param[in] _format Pixel format.
+      /// \param[in] _filename Path of the file to write.
+      /// \param[in] _fileFormat File format.
+      /// \param[in] _level PNG compression level or JPEG quality, -1 for
+      /// the default of the format.
+      /// \return True if the file was written.
+      public: static bool Write(const unsigned char *_data,
+                  const unsigned int _width, const unsigned int _height,
+                  const Image::PixelFormat _format,
+                  const std::string &_filename,
+                  const FileFormat _fileFormat, const int _level = -1);
+
+      /// \brief Get the size of a pixel.
+      /// \param[in] _format Pixel format.
+      /// \return Size in bytes, 0 for an unknown format.
+      public: static unsigned int PixelSize(const Image::PixelFormat _format);
+
+      /// \brief Worker thread loop.
+      private: void Run();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<FrameWriterPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
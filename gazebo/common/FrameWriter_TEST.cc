@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/FrameWriter.hh"
+#include "gazebo/common/Image.hh"
+#include "gazebo/common/Time.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace common;
+
+class FrameWriterTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(FrameWriterTest, Formats)
+{
+  FrameWriter writer(2);
+  EXPECT_EQ(2u, writer.ThreadCount());
+  EXPECT_EQ(16u, writer.Capacity());
+  EXPECT_EQ(FrameWriter::BLOCK, writer.BackpressurePolicy());
+  EXPECT_EQ(FrameWriter::PNG, writer.Format());
+  EXPECT_EQ(-1, writer.Level());
+  EXPECT_EQ("png", writer.Extension());
+
+  // 4x2 image
+  const unsigned int width = 4;
+  const unsigned int height = 2;
+  std::vector<unsigned char> rgb(width * height * 3);
+  for (unsigned int i = 0; i < rgb.size(); ++i)
+    rgb[i] = static_cast<unsigned char>(i * 10);
+
+  const std::string dir = common::cwd();
+
+  // Raw pixels are written as they are
+  writer.SetFileFormat(FrameWriter::RAW);
+  EXPECT_EQ("raw", writer.Extension());
+  EXPECT_TRUE(writer.Supports(Image::RGB_INT16));
+  EXPECT_TRUE(writer.Save(rgb.data(), width, height, Image::RGB_INT8,
+      dir + "/frame_writer.raw"));
+
+  // Encoded formats only take 8 bit pixels
+  writer.SetFileFormat(FrameWriter::PNG, 1);
+  EXPECT_EQ(1, writer.Level());
+  EXPECT_FALSE(writer.Supports(Image::RGB_INT16));
+  EXPECT_FALSE(writer.Save(rgb.data(), width, height, Image::RGB_INT16,
+      dir + "/frame_writer_16.png"));
+  EXPECT_TRUE(writer.Save(rgb.data(), width, height, Image::RGB_INT8,
+      dir + "/frame_writer.png"));
+  EXPECT_TRUE(writer.Save(rgb.data(), width * 3, height, Image::L_INT8,
+      dir + "/frame_writer_l8.png"));
+
+  writer.SetFileFormat(FrameWriter::JPEG, 90);
+  EXPECT_EQ("jpg", writer.Extension());
+  EXPECT_TRUE(writer.Save(rgb.data(), width, height, Image::BGR_INT8,
+      dir + "/frame_writer.jpg"));
+
+  // The caller can reuse its buffer right away
+  std::fill(rgb.begin(), rgb.end(), 0);
+
+  writer.Flush();
+  EXPECT_EQ(0u, writer.Pending());
+  EXPECT_EQ(0u, writer.Dropped());
+
+  std::ifstream raw(dir + "/frame_writer.raw", std::ios::binary);
+  std::vector<char> rawData((std::istreambuf_iterator<char>(raw)),
+      std::istreambuf_iterator<char>());
+  ASSERT_EQ(width * height * 3, rawData.size());
+  for (unsigned int i = 0; i < rawData.size(); ++i)
+    EXPECT_EQ(static_cast<unsigned char>(i * 10),
+        static_cast<unsigned char>(rawData[i]));
+
+  Image png(dir + "/frame_writer.png");
+  EXPECT_TRUE(png.Valid());
+  EXPECT_EQ(width, png.GetWidth());
+  EXPECT_EQ(height, png.GetHeight());
+
+  Image grey(dir + "/frame_writer_l8.png");
+  EXPECT_TRUE(grey.Valid());
+  EXPECT_EQ(width * 3, grey.GetWidth());
+  EXPECT_EQ(8u, grey.GetBPP());
+
+  Image jpeg(dir + "/frame_writer.jpg");
+  EXPECT_TRUE(jpeg.Valid());
+  EXPECT_EQ(width, jpeg.GetWidth());
+
+  EXPECT_FALSE(common::exists(dir + "/frame_writer_16.png"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(FrameWriterTest, Backpressure)
+{
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool open = false;
+  std::atomic<unsigned int> started(0);
+  std::atomic<unsigned int> count(0);
+
+  // Jobs wait for the gate to open, so that the queue fills up
+  auto job = [&]()
+  {
+    ++started;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!open)
+      condition.wait(lock);
+    ++count;
+  };
+
+  {
+    FrameWriter writer(1, 2, FrameWriter::DROP);
+
+    // One job runs and two are queued, the others are dropped
+    unsigned int accepted = 0;
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+      if (writer.Push(job))
+        ++accepted;
+      if (i == 0)
+      {
+        // Let the worker start the first job
+        while (started == 0)
+          common::Time::MSleep(1);
+      }
+    }
+    EXPECT_EQ(3u, accepted);
+    EXPECT_EQ(7u, writer.Dropped());
+    EXPECT_EQ(3u, writer.Pending());
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      open = true;
+    }
+    condition.notify_all();
+
+    writer.Flush();
+    EXPECT_EQ(3u, count);
+  }
+
+  // With the blocking policy every job runs
+  count = 0;
+  {
+    FrameWriter writer(3, 2, FrameWriter::BLOCK);
+    for (unsigned int i = 0; i < 50; ++i)
+      EXPECT_TRUE(writer.Push(job));
+    // The destructor waits for the queued jobs
+  }
+  EXPECT_EQ(50u, count);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
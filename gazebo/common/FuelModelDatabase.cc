@@ -33,6 +33,7 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/FuelModelDatabase.hh"
+#include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/SemanticVersion.hh"
 #include "gazebo/common/SystemPaths.hh"
 
@@ -121,6 +122,9 @@ std::string FuelModelDatabase::ModelFile(const std::string &_uri)
 {
   std::string result;
 
+  // Reuse a download started by ModelDatabase::PrefetchModel
+  ModelDatabase::Instance()->WaitForDownload(_uri);
+
   // This will download the model if necessary
   std::string path = this->ModelPath(_uri);
   std::string manifestPath =
@@ -248,6 +252,9 @@ std::string FuelModelDatabase::CachedFilePath(const std::string &_uri)
     return std::string();
   }
 
+  // Reuse a download started by ModelDatabase::PrefetchModel
+  ModelDatabase::Instance()->WaitForDownload(_uri);
+
   std::string path;
   if (!this->dataPtr->fuelClient->CachedModelFile(fuelUri, path))
   {
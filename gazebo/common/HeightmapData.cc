@@ -15,6 +15,7 @@
  *
 */
 
+#include <algorithm>
 #include <gazebo/gazebo_config.h>
 
 #ifdef HAVE_GDAL
@@ -34,6 +35,33 @@
 using namespace gazebo;
 using namespace common;
 
+//////////////////////////////////////////////////
+void HeightmapData::FillHeightMapRegion(int _subSampling,
+    unsigned int _vertSize, const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, bool _flipY,
+    unsigned int _x, unsigned int _y, unsigned int _width,
+    unsigned int _height, std::vector<float> &_heights)
+{
+  if (_x + _width > _vertSize || _y + _height > _vertSize)
+  {
+    gzerr << "Heightmap region [" << _x << ", " << _y << ", " << _width
+          << ", " << _height << "] is outside of the " << _vertSize << "x"
+          << _vertSize << " heightmap" << std::endl;
+    _heights.clear();
+    return;
+  }
+
+  std::vector<float> all;
+  this->FillHeightMap(_subSampling, _vertSize, _size, _scale, _flipY, all);
+
+  _heights.resize(_width * _height);
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    auto row = all.begin() + (_y + y) * _vertSize + _x;
+    std::copy(row, row + _width, _heights.begin() + y * _width);
+  }
+}
+
 //////////////////////////////////////////////////
 HeightmapData *HeightmapDataLoader::LoadImageAsTerrain(
     const std::string &_filename)
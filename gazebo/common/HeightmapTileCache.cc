@@ -0,0 +1,886 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/HeightmapTileCache.hh"
+#include "gazebo/common/SystemPaths.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Magic number identifying a tile cache file ("GZHT").
+static const uint32_t kTileCacheMagic = 0x54485a47;
+
+/// \brief Version of the tile cache file format.
+static const uint32_t kTileCacheVersion = 2;
+
+/// \brief Minimum alignment of the tiles inside the cache file.
+static const uint64_t kMinTileAlignment = 4096;
+
+/// \brief Directory, relative to the log path, holding the tile caches.
+static const char *kTileCacheDirname = "heightmap_tiles";
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \internal
+    /// \brief Header written at the beginning of a tile cache file.
+    struct HeightmapTileCacheHeader
+    {
+      /// \brief Must be kTileCacheMagic.
+      uint32_t magic;
+
+      /// \brief Must be kTileCacheVersion.
+      uint32_t version;
+
+      /// \brief Vertices per side of level 0.
+      uint32_t vertSize;
+
+      /// \brief Cells per tile side.
+      uint32_t tileSize;
+
+      /// \brief Tiles per side of level 0.
+      uint32_t tileCount;
+
+      /// \brief Number of pyramid levels.
+      uint32_t levelCount;
+
+      /// \brief Minimum height.
+      float minHeight;
+
+      /// \brief Maximum height.
+      float maxHeight;
+
+      /// \brief Byte offset of the first tile.
+      uint64_t dataOffset;
+
+      /// \brief Byte distance between two consecutive tiles.
+      uint64_t tileStride;
+    };
+
+    /// \internal
+    /// \brief Layout of one pyramid level.
+    struct HeightmapTileLevel
+    {
+      /// \brief Vertices per side.
+      unsigned int vertSize;
+
+      /// \brief Tiles per side.
+      unsigned int tileCount;
+
+      /// \brief Index of the first tile of the level in the file.
+      unsigned int firstTile;
+    };
+
+    /// \internal
+    /// \brief HeightmapTileCache private data.
+    class HeightmapTileCachePrivate
+    {
+      /// \brief Map a tile in memory.
+      /// \param[in] _index Tile index.
+      /// \return Pointer to the tile heights, nullptr on error.
+      public: const float *MapTile(const unsigned int _index);
+
+      /// \brief Map a tile if needed and pin it, so that it is not unmapped
+      /// until UnpinTile is called.
+      /// \param[in] _index Tile index.
+      /// \return Pointer to the tile heights, nullptr on error. The tile is
+      /// only pinned when the pointer isn't null.
+      public: const float *PinTile(const unsigned int _index);
+
+      /// \brief Release a pin taken by PinTile.
+      /// \param[in] _index Tile index.
+      public: void UnpinTile(const unsigned int _index);
+
+      /// \brief Copy heights of a tile. A resident tile is pinned while it
+      /// is copied, other tiles are read from the file without being mapped.
+      /// \param[in] _index Tile index.
+      /// \param[in] _offset Index of the first height inside the tile.
+      /// \param[in] _count Number of heights to copy.
+      /// \param[out] _out Output heights.
+      /// \return False on read error.
+      public: bool CopyTile(const unsigned int _index,
+                  const unsigned int _offset, const unsigned int _count,
+                  float *_out);
+
+      /// \brief Unmap a tile, unless a reader has pinned it.
+      /// \param[in] _index Tile index.
+      /// \param[in] _force Unmap the tile even if it is pinned.
+      public: void ReleaseTile(const unsigned int _index,
+                  const bool _force = false);
+
+      /// \brief Cache file header.
+      public: HeightmapTileCacheHeader header;
+
+      /// \brief Layout of the pyramid levels.
+      public: std::vector<HeightmapTileLevel> levels;
+
+      /// \brief Total number of tiles over all the levels.
+      public: unsigned int totalTiles = 0;
+
+      /// \brief True when a cache file is loaded.
+      public: bool valid = false;
+
+      /// \brief Number of heights in one tile.
+      public: unsigned int tileValues = 0;
+
+      /// \brief Mapped tiles, nullptr when not resident.
+      public: std::unique_ptr<std::atomic<const float *>[]> tiles;
+
+      /// \brief Number of readers using each tile. A tile is only unmapped
+      /// when nobody uses it. Readers pin a tile before loading its pointer,
+      /// and ReleaseTile clears the pointer before checking the pins, so
+      /// that one of them always sees the other.
+      public: std::unique_ptr<std::atomic<unsigned int>[]> pins;
+
+      /// \brief Number of resident tiles.
+      public: std::atomic<unsigned int> residentCount;
+
+      /// \brief Protects mapping and unmapping of tiles.
+      public: std::mutex mutex;
+
+#ifndef _WIN32
+      /// \brief File descriptor of the cache file.
+      public: int fd = -1;
+#else
+      /// \brief Cache file stream, tiles are read into memory on Windows.
+      public: std::ifstream file;
+#endif
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Alignment used for the tiles of a new cache file.
+/// \return Alignment in bytes, a multiple of the system page size.
+static uint64_t tileAlignment()
+{
+  uint64_t alignment = kMinTileAlignment;
+#ifndef _WIN32
+  long pageSize = sysconf(_SC_PAGESIZE);
+  if (pageSize > 0)
+    alignment = std::max(alignment, static_cast<uint64_t>(pageSize));
+#endif
+  return alignment;
+}
+
+/////////////////////////////////////////////////
+/// \brief Compute the layout of the pyramid levels. Each level halves the
+/// resolution of the previous one, until a level fits in a single tile or
+/// can no longer be halved exactly.
+/// \param[in] _vertSize Vertices per side of level 0.
+/// \param[in] _tileSize Cells per tile side.
+/// \return Levels of the pyramid.
+static std::vector<HeightmapTileLevel> computeLevels(
+    const unsigned int _vertSize, const unsigned int _tileSize)
+{
+  std::vector<HeightmapTileLevel> levels;
+  HeightmapTileLevel level;
+  level.vertSize = _vertSize;
+  level.firstTile = 0;
+
+  while (true)
+  {
+    level.tileCount = (level.vertSize - 2) / _tileSize + 1;
+    levels.push_back(level);
+
+    if (level.tileCount == 1 || (level.vertSize - 1) % 2 != 0 ||
+        level.vertSize <= 3)
+    {
+      break;
+    }
+
+    level.firstTile += level.tileCount * level.tileCount;
+    level.vertSize = (level.vertSize - 1) / 2 + 1;
+  }
+
+  return levels;
+}
+
+/////////////////////////////////////////////////
+const float *HeightmapTileCachePrivate::MapTile(const unsigned int _index)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Another thread may have mapped the tile while we waited for the lock.
+  const float *data = this->tiles[_index].load(std::memory_order_acquire);
+  if (data)
+    return data;
+
+  const uint64_t offset =
+      this->header.dataOffset + _index * this->header.tileStride;
+  const size_t bytes = this->tileValues * sizeof(float);
+
+#ifndef _WIN32
+  void *ptr = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, this->fd,
+      static_cast<off_t>(offset));
+  if (ptr == MAP_FAILED)
+  {
+    gzerr << "Unable to map heightmap tile [" << _index << "]: "
+          << strerror(errno) << std::endl;
+    return nullptr;
+  }
+  data = static_cast<const float *>(ptr);
+#else
+  float *buffer = new float[this->tileValues];
+  this->file.clear();
+  this->file.seekg(static_cast<std::streamoff>(offset));
+  if (!this->file.read(reinterpret_cast<char *>(buffer), bytes))
+  {
+    gzerr << "Unable to read heightmap tile [" << _index << "]" << std::endl;
+    delete [] buffer;
+    return nullptr;
+  }
+  data = buffer;
+#endif
+
+  this->tiles[_index].store(data, std::memory_order_release);
+  ++this->residentCount;
+  return data;
+}
+
+/////////////////////////////////////////////////
+const float *HeightmapTileCachePrivate::PinTile(const unsigned int _index)
+{
+  ++this->pins[_index];
+  const float *data = this->tiles[_index].load();
+  if (!data)
+    data = this->MapTile(_index);
+  if (!data)
+    --this->pins[_index];
+  return data;
+}
+
+/////////////////////////////////////////////////
+void HeightmapTileCachePrivate::UnpinTile(const unsigned int _index)
+{
+  --this->pins[_index];
+}
+
+/////////////////////////////////////////////////
+bool HeightmapTileCachePrivate::CopyTile(const unsigned int _index,
+    const unsigned int _offset, const unsigned int _count, float *_out)
+{
+  ++this->pins[_index];
+  const float *data = this->tiles[_index].load();
+  if (data)
+  {
+    std::copy(data + _offset, data + _offset + _count, _out);
+    --this->pins[_index];
+    return true;
+  }
+  --this->pins[_index];
+
+  const uint64_t offset = this->header.dataOffset +
+      _index * this->header.tileStride + _offset * sizeof(float);
+  const size_t bytes = _count * sizeof(float);
+
+#ifndef _WIN32
+  if (pread(this->fd, _out, bytes, static_cast<off_t>(offset)) !=
+      static_cast<ssize_t>(bytes))
+  {
+    gzerr << "Unable to read heightmap tile [" << _index << "]" << std::endl;
+    return false;
+  }
+#else
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->file.clear();
+  this->file.seekg(static_cast<std::streamoff>(offset));
+  if (!this->file.read(reinterpret_cast<char *>(_out), bytes))
+  {
+    gzerr << "Unable to read heightmap tile [" << _index << "]" << std::endl;
+    return false;
+  }
+#endif
+  return true;
+}
+
+/////////////////////////////////////////////////
+void HeightmapTileCachePrivate::ReleaseTile(const unsigned int _index,
+    const bool _force)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  const float *data = this->tiles[_index].exchange(nullptr);
+  if (!data)
+    return;
+
+  // A reader is using the tile, it stays resident until a later release
+  if (!_force && this->pins[_index] > 0)
+  {
+    this->tiles[_index].store(data);
+    return;
+  }
+
+#ifndef _WIN32
+  munmap(const_cast<float *>(data), this->tileValues * sizeof(float));
+#else
+  delete [] data;
+#endif
+  --this->residentCount;
+}
+
+const unsigned int HeightmapTileCache::DefaultTileSize = 128;
+
+/////////////////////////////////////////////////
+HeightmapTileCache::HeightmapTileCache()
+  : dataPtr(new HeightmapTileCachePrivate)
+{
+  this->dataPtr->residentCount = 0;
+  memset(&this->dataPtr->header, 0, sizeof(this->dataPtr->header));
+}
+
+/////////////////////////////////////////////////
+HeightmapTileCache::~HeightmapTileCache()
+{
+  this->Unload();
+}
+
+/////////////////////////////////////////////////
+bool HeightmapTileCache::Build(const std::string &_filename,
+    const std::vector<float> &_heights, const unsigned int _vertSize,
+    const unsigned int _tileSize)
+{
+  if (_heights.size() != static_cast<size_t>(_vertSize) * _vertSize)
+  {
+    gzerr << "Invalid heightmap tile cache parameters: " << _heights.size()
+          << " heights, " << _vertSize << " vertices per side" << std::endl;
+    return false;
+  }
+
+  return Build(_filename, _vertSize, _tileSize,
+      [&_heights, _vertSize](unsigned int _x, unsigned int _y,
+        unsigned int _width, unsigned int _height, std::vector<float> &_out)
+      {
+        _out.resize(_width * _height);
+        for (unsigned int y = 0; y < _height; ++y)
+        {
+          auto row = _heights.begin() + (_y + y) * _vertSize + _x;
+          std::copy(row, row + _width, _out.begin() + y * _width);
+        }
+      });
+}
+
+/////////////////////////////////////////////////
+bool HeightmapTileCache::Build(const std::string &_filename,
+    const unsigned int _vertSize, const unsigned int _tileSize,
+    const FillRegionFunc &_fill)
+{
+  if (_vertSize < 2 || _tileSize == 0 || !_fill)
+  {
+    gzerr << "Invalid heightmap tile cache parameters: " << _vertSize
+          << " vertices per side, tile size " << _tileSize << std::endl;
+    return false;
+  }
+
+  std::vector<HeightmapTileLevel> levels = computeLevels(_vertSize, _tileSize);
+
+  HeightmapTileCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = kTileCacheVersion;
+  header.vertSize = _vertSize;
+  header.tileSize = _tileSize;
+  header.tileCount = levels[0].tileCount;
+  header.levelCount = static_cast<uint32_t>(levels.size());
+  header.minHeight = std::numeric_limits<float>::max();
+  header.maxHeight = -std::numeric_limits<float>::max();
+
+  const uint64_t alignment = tileAlignment();
+  const unsigned int tileVerts = _tileSize + 1;
+  const uint64_t tileBytes =
+      static_cast<uint64_t>(tileVerts) * tileVerts * sizeof(float);
+  header.dataOffset =
+      (sizeof(header) + alignment - 1) / alignment * alignment;
+  header.tileStride = (tileBytes + alignment - 1) / alignment * alignment;
+
+  boost::system::error_code ec;
+
+  // The file is read back while it is written: each level after the first
+  // is sampled from the tiles of the previous level, so that _fill is only
+  // called once per row of level 0 tiles.
+  // The cache is written to a temporary file that is renamed at the end:
+  // another process (e.g. gzclient and gzserver) may have the previous
+  // version mapped, or be building the same cache at the same time.
+  boost::filesystem::path tmpPath = _filename + "." +
+      boost::filesystem::unique_path().string() + ".tmp";
+  std::fstream file(tmpPath.string().c_str(), std::ios::in | std::ios::out |
+      std::ios::trunc | std::ios::binary);
+  if (!file.is_open())
+  {
+    gzerr << "Unable to create heightmap tile cache [" << _filename << "]"
+          << std::endl;
+    return false;
+  }
+
+  auto tileOffset = [&header](const unsigned int _index)
+  {
+    return static_cast<std::streamoff>(
+        header.dataOffset + _index * header.tileStride);
+  };
+
+  // Read one row of a level that has already been written.
+  auto readRow = [&](const HeightmapTileLevel &_level, const unsigned int _y,
+      std::vector<float> &_row)
+  {
+    _row.resize(_level.vertSize);
+    const unsigned int ty = std::min(_y / _tileSize, _level.tileCount - 1);
+    const unsigned int ly = _y - ty * _tileSize;
+    for (unsigned int tx = 0; tx < _level.tileCount; ++tx)
+    {
+      const unsigned int count = (tx == _level.tileCount - 1) ?
+          _level.vertSize - tx * _tileSize : _tileSize;
+      file.seekg(tileOffset(_level.firstTile + ty * _level.tileCount + tx) +
+          static_cast<std::streamoff>(ly * tileVerts * sizeof(float)));
+      file.read(reinterpret_cast<char *>(&_row[tx * _tileSize]),
+          count * sizeof(float));
+    }
+  };
+
+  // The header is written again once the height range is known. Until then
+  // the magic number is left out, so an interrupted build is never loaded.
+  std::vector<char> padding(alignment, 0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(padding.data(), header.dataOffset - sizeof(header));
+
+  std::vector<float> strip;
+  std::vector<float> row;
+  std::vector<float> tile(tileVerts * tileVerts);
+  for (size_t l = 0; l < levels.size() && file.good(); ++l)
+  {
+    const HeightmapTileLevel &level = levels[l];
+    for (unsigned int ty = 0; ty < level.tileCount && file.good(); ++ty)
+    {
+      // Gather the rows of this row of tiles, clamped to the last row.
+      const unsigned int firstRow = ty * _tileSize;
+      const unsigned int rows = std::min(tileVerts, level.vertSize - firstRow);
+      if (l == 0)
+      {
+        _fill(0, firstRow, level.vertSize, rows, strip);
+        if (strip.size() != rows * level.vertSize)
+        {
+          gzerr << "Heightmap region has " << strip.size() << " heights, "
+                << "expected " << rows * level.vertSize << std::endl;
+          file.close();
+          boost::filesystem::remove(tmpPath, ec);
+          return false;
+        }
+
+        auto minmax = std::minmax_element(strip.begin(), strip.end());
+        header.minHeight = std::min(header.minHeight, *minmax.first);
+        header.maxHeight = std::max(header.maxHeight, *minmax.second);
+      }
+      else
+      {
+        strip.resize(rows * level.vertSize);
+        for (unsigned int y = 0; y < rows; ++y)
+        {
+          readRow(levels[l - 1], (firstRow + y) * 2, row);
+          for (unsigned int x = 0; x < level.vertSize; ++x)
+            strip[y * level.vertSize + x] = row[x * 2];
+        }
+      }
+
+      for (unsigned int tx = 0; tx < level.tileCount; ++tx)
+      {
+        // Copy the tile, clamping the indices of the last row and column of
+        // tiles to the heightmap border.
+        for (unsigned int y = 0; y < tileVerts; ++y)
+        {
+          unsigned int sy = std::min(y, rows - 1);
+          for (unsigned int x = 0; x < tileVerts; ++x)
+          {
+            unsigned int sx =
+                std::min(tx * _tileSize + x, level.vertSize - 1);
+            tile[y * tileVerts + x] = strip[sy * level.vertSize + sx];
+          }
+        }
+        file.seekp(tileOffset(level.firstTile + ty * level.tileCount + tx));
+        file.write(reinterpret_cast<const char *>(tile.data()), tileBytes);
+        file.write(padding.data(), header.tileStride - tileBytes);
+      }
+    }
+  }
+
+  header.magic = kTileCacheMagic;
+  file.seekp(0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  bool good = file.good();
+  file.close();
+
+  if (good)
+    boost::filesystem::rename(tmpPath, _filename, ec);
+
+  if (!good || ec)
+  {
+    gzerr << "Error writing heightmap tile cache [" << _filename << "]"
+          << std::endl;
+    boost::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string HeightmapTileCache::CacheFilename(const std::string &_filename,
+    const int _subSampling, const unsigned int _vertSize,
+    const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, const unsigned int _tileSize)
+{
+  // The name is keyed on everything that changes the sampled heights.
+  std::ostringstream key;
+  key << _filename << ";" << _vertSize << ";" << _subSampling << ";"
+      << _size << ";" << _scale << ";" << _tileSize;
+  try
+  {
+    key << ";" << boost::filesystem::file_size(_filename) << ";"
+        << boost::filesystem::last_write_time(_filename);
+  }
+  catch(const boost::filesystem::filesystem_error &_e)
+  {
+    gzwarn << "Unable to stat heightmap file [" << _filename << "]: "
+           << _e.what() << std::endl;
+  }
+
+  boost::filesystem::path path =
+      boost::filesystem::path(SystemPaths::Instance()->GetLogPath()) /
+      kTileCacheDirname / (get_sha1<std::string>(key.str()) + ".tiles");
+
+  return path.string();
+}
+
+/////////////////////////////////////////////////
+bool HeightmapTileCache::Load(const std::string &_filename)
+{
+  this->Unload();
+
+  HeightmapTileCacheHeader header;
+  uint64_t fileSize = 0;
+
+#ifndef _WIN32
+  int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      pread(fd, &header, sizeof(header), 0) !=
+      static_cast<ssize_t>(sizeof(header)))
+  {
+    close(fd);
+    return false;
+  }
+  fileSize = static_cast<uint64_t>(st.st_size);
+#else
+  std::ifstream &file = this->dataPtr->file;
+  file.open(_filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    return false;
+  file.seekg(0, std::ios::end);
+  fileSize = static_cast<uint64_t>(file.tellg());
+  file.seekg(0, std::ios::beg);
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+  {
+    file.close();
+    return false;
+  }
+#endif
+
+  bool valid = header.magic == kTileCacheMagic &&
+      header.version == kTileCacheVersion &&
+      header.vertSize >= 2 && header.tileSize > 0 &&
+      header.tileStride >= static_cast<uint64_t>(header.tileSize + 1) *
+        (header.tileSize + 1) * sizeof(float) &&
+      header.dataOffset >= sizeof(header);
+
+  std::vector<HeightmapTileLevel> levels;
+  uint64_t tiles = 0;
+  if (valid)
+  {
+    levels = computeLevels(header.vertSize, header.tileSize);
+    tiles = levels.back().firstTile + static_cast<uint64_t>(
+        levels.back().tileCount) * levels.back().tileCount;
+    valid = header.tileCount == levels[0].tileCount &&
+        header.levelCount == levels.size() &&
+        fileSize >= header.dataOffset + tiles * header.tileStride;
+  }
+
+#ifndef _WIN32
+  // Tiles are mapped individually, so their offsets must be page aligned.
+  long pageSize = sysconf(_SC_PAGESIZE);
+  valid = valid && pageSize > 0 &&
+      header.dataOffset % static_cast<uint64_t>(pageSize) == 0 &&
+      header.tileStride % static_cast<uint64_t>(pageSize) == 0;
+#endif
+
+  if (!valid)
+  {
+    gzwarn << "Ignoring invalid heightmap tile cache [" << _filename << "]"
+           << std::endl;
+#ifndef _WIN32
+    close(fd);
+#else
+    file.close();
+#endif
+    return false;
+  }
+
+#ifndef _WIN32
+  this->dataPtr->fd = fd;
+#endif
+  this->dataPtr->header = header;
+  this->dataPtr->levels = levels;
+  this->dataPtr->totalTiles = static_cast<unsigned int>(tiles);
+  this->dataPtr->tileValues = (header.tileSize + 1) * (header.tileSize + 1);
+  this->dataPtr->tiles.reset(new std::atomic<const float *>[tiles]);
+  this->dataPtr->pins.reset(new std::atomic<unsigned int>[tiles]);
+  for (uint64_t i = 0; i < tiles; ++i)
+  {
+    this->dataPtr->tiles[i].store(nullptr);
+    this->dataPtr->pins[i].store(0);
+  }
+  this->dataPtr->residentCount = 0;
+  this->dataPtr->valid = true;
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void HeightmapTileCache::Unload()
+{
+  if (!this->dataPtr->valid)
+    return;
+
+  for (unsigned int i = 0; i < this->dataPtr->totalTiles; ++i)
+    this->dataPtr->ReleaseTile(i, true);
+  this->dataPtr->tiles.reset();
+  this->dataPtr->pins.reset();
+  this->dataPtr->levels.clear();
+  this->dataPtr->totalTiles = 0;
+
+#ifndef _WIN32
+  close(this->dataPtr->fd);
+  this->dataPtr->fd = -1;
+#else
+  this->dataPtr->file.close();
+#endif
+
+  memset(&this->dataPtr->header, 0, sizeof(this->dataPtr->header));
+  this->dataPtr->valid = false;
+}
+
+/////////////////////////////////////////////////
+bool HeightmapTileCache::Valid() const
+{
+  return this->dataPtr->valid;
+}
+
+/////////////////////////////////////////////////
+unsigned int HeightmapTileCache::LevelCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->levels.size());
+}
+
+/////////////////////////////////////////////////
+unsigned int HeightmapTileCache::VertexCount(const unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levels.size())
+    return 0u;
+  return this->dataPtr->levels[_level].vertSize;
+}
+
+/////////////////////////////////////////////////
+unsigned int HeightmapTileCache::TileSize() const
+{
+  return this->dataPtr->header.tileSize;
+}
+
+/////////////////////////////////////////////////
+unsigned int HeightmapTileCache::TileCount(const unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levels.size())
+    return 0u;
+  return this->dataPtr->levels[_level].tileCount;
+}
+
+/////////////////////////////////////////////////
+float HeightmapTileCache::MinHeight() const
+{
+  return this->dataPtr->header.minHeight;
+}
+
+/////////////////////////////////////////////////
+float HeightmapTileCache::MaxHeight() const
+{
+  return this->dataPtr->header.maxHeight;
+}
+
+/////////////////////////////////////////////////
+float HeightmapTileCache::Height(const unsigned int _x,
+    const unsigned int _y, const unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levels.size())
+    return 0.0f;
+
+  const HeightmapTileLevel &level = this->dataPtr->levels[_level];
+  if (_x >= level.vertSize || _y >= level.vertSize)
+    return 0.0f;
+
+  const unsigned int tileSize = this->dataPtr->header.tileSize;
+  const unsigned int tx = std::min(_x / tileSize, level.tileCount - 1);
+  const unsigned int ty = std::min(_y / tileSize, level.tileCount - 1);
+  const unsigned int index = level.firstTile + ty * level.tileCount + tx;
+
+  const float *data = this->dataPtr->PinTile(index);
+  if (!data)
+    return 0.0f;
+
+  const unsigned int lx = _x - tx * tileSize;
+  const unsigned int ly = _y - ty * tileSize;
+  const float height = data[ly * (tileSize + 1) + lx];
+  this->dataPtr->UnpinTile(index);
+  return height;
+}
+
+/////////////////////////////////////////////////
+bool HeightmapTileCache::FillRegion(const unsigned int _x,
+    const unsigned int _y, const unsigned int _width,
+    const unsigned int _height, std::vector<float> &_heights,
+    const unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levels.size())
+    return false;
+
+  const HeightmapTileLevel &level = this->dataPtr->levels[_level];
+  if (_x + _width > level.vertSize || _y + _height > level.vertSize)
+    return false;
+
+  _heights.resize(_width * _height);
+
+  // Copy each row one tile span at a time.
+  const unsigned int tileSize = this->dataPtr->header.tileSize;
+  for (unsigned int y = _y; y < _y + _height; ++y)
+  {
+    const unsigned int ty = std::min(y / tileSize, level.tileCount - 1);
+    const unsigned int ly = y - ty * tileSize;
+
+    unsigned int x = _x;
+    while (x < _x + _width)
+    {
+      const unsigned int tx = std::min(x / tileSize, level.tileCount - 1);
+      const unsigned int end = (tx == level.tileCount - 1) ?
+          _x + _width : std::min(_x + _width, (tx + 1) * tileSize);
+
+      if (!this->dataPtr->CopyTile(level.firstTile + ty * level.tileCount + tx,
+            ly * (tileSize + 1) + (x - tx * tileSize), end - x,
+            &_heights[(y - _y) * _width + (x - _x)]))
+      {
+        return false;
+      }
+      x = end;
+    }
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool HeightmapTileCache::Tile(const unsigned int _tx,
+    const unsigned int _ty, std::vector<float> &_heights,
+    const unsigned int _level) const
+{
+  if (_level >= this->dataPtr->levels.size())
+    return false;
+
+  const HeightmapTileLevel &level = this->dataPtr->levels[_level];
+  if (_tx >= level.tileCount || _ty >= level.tileCount)
+    return false;
+
+  _heights.resize(this->dataPtr->tileValues);
+  return this->dataPtr->CopyTile(level.firstTile + _ty * level.tileCount + _tx,
+      0, this->dataPtr->tileValues, _heights.data());
+}
+
+/////////////////////////////////////////////////
+void HeightmapTileCache::UpdateResidency(
+    const std::vector<std::pair<int, int>> &_centers,
+    const unsigned int _radius, const unsigned int _level)
+{
+  if (_level >= this->dataPtr->levels.size())
+    return;
+
+  const HeightmapTileLevel &level = this->dataPtr->levels[_level];
+  const int count = static_cast<int>(level.tileCount);
+  const int tileSize = static_cast<int>(this->TileSize());
+  const int radius = static_cast<int>(
+      std::min(_radius, static_cast<unsigned int>(
+          std::numeric_limits<int>::max() / 2)));
+  std::vector<bool> keep(count * count, false);
+
+  for (auto const &center : _centers)
+  {
+    int minX = std::max(0, (center.first - radius) / tileSize);
+    int maxX = std::min(count - 1, (center.first + radius) / tileSize);
+    int minY = std::max(0, (center.second - radius) / tileSize);
+    int maxY = std::min(count - 1, (center.second + radius) / tileSize);
+
+    for (int ty = minY; ty <= maxY; ++ty)
+    {
+      for (int tx = minX; tx <= maxX; ++tx)
+      {
+        const unsigned int index = level.firstTile + ty * count + tx;
+        keep[ty * count + tx] = true;
+        if (!this->dataPtr->tiles[index].load(std::memory_order_acquire))
+          this->dataPtr->MapTile(index);
+      }
+    }
+  }
+
+  for (int i = 0; i < count * count; ++i)
+  {
+    if (!keep[i])
+      this->dataPtr->ReleaseTile(level.firstTile + i);
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int HeightmapTileCache::ResidentTileCount() const
+{
+  return this->dataPtr->residentCount;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_HEIGHTMAPTILECACHE_HH_
+#define GAZEBO_COMMON_HEIGHTMAPTILECACHE_HH_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class
+    class HeightmapTileCachePrivate;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class HeightmapTileCache HeightmapTileCache.hh common/common.hh
+    /// \brief On-disk pyramid of a sampled heightmap split in square tiles.
+    ///
+    /// The cache file stores the same height values that
+    /// HeightmapData::FillHeightMap produces, but grouped in tiles of
+    /// TileSize() x TileSize() cells. Neighbouring tiles share their border
+    /// vertices so that a tile can be used on its own. Level 0 holds every
+    /// vertex, and each following level keeps every other vertex of the
+    /// previous one, down to a single tile. Tiles are memory mapped from the
+    /// file on first access and can be released again with UpdateResidency,
+    /// so only the tiles near the regions of interest use memory. A tile
+    /// which is being read is never unmapped, so the heights can be read
+    /// from several threads while UpdateResidency runs.
+    ///
+    /// The heights are always stored with unflipped rows, i.e. with
+    /// _flipY set to false, and the physics engines which need flipped rows
+    /// flip them when reading. So the physics and rendering sides share the
+    /// same cache file when they sample a heightmap with the same
+    /// parameters, see CacheFilename.
+    class GZ_COMMON_VISIBLE HeightmapTileCache
+    {
+      /// \brief Function filling a region of the level 0 heights.
+      /// Arguments are the first column, first row, width and height of the
+      /// region, in vertices, and the row-major output vector.
+      /// \sa HeightmapData::FillHeightMapRegion
+      public: using FillRegionFunc = std::function<void(
+                  unsigned int, unsigned int, unsigned int, unsigned int,
+                  std::vector<float> &)>;
+
+      /// \brief Default number of cells per tile side. Physics and rendering
+      /// use it so that they share the same cache file.
+      public: static const unsigned int DefaultTileSize;
+
+      /// \brief Constructor.
+      public: HeightmapTileCache();
+
+      /// \brief Destructor. Unmaps all the tiles.
+      public: virtual ~HeightmapTileCache();
+
+      /// \brief Write a tile cache file from a dense height grid.
+      /// \param[in] _filename Path of the cache file to write.
+      /// \param[in] _heights Row-major heights, _vertSize x _vertSize.
+      /// \param[in] _vertSize Number of vertices per side.
+      /// \param[in] _tileSize Number of cells per tile side.
+      /// \return True if the file was written.
+      public: static bool Build(const std::string &_filename,
+                  const std::vector<float> &_heights,
+                  const unsigned int _vertSize,
+                  const unsigned int _tileSize);
+
+      /// \brief Write a tile cache file, requesting the heights one strip
+      /// of rows at a time. The whole heightmap is never held in memory.
+      /// \param[in] _filename Path of the cache file to write.
+      /// \param[in] _vertSize Number of vertices per side.
+      /// \param[in] _tileSize Number of cells per tile side.
+      /// \param[in] _fill Function providing the heights of a region.
+      /// \return True if the file was written.
+      public: static bool Build(const std::string &_filename,
+                  const unsigned int _vertSize,
+                  const unsigned int _tileSize,
+                  const FillRegionFunc &_fill);
+
+      /// \brief Get the path of the shared cache file of a sampled
+      /// heightmap. The name depends on the heightmap file, its modification
+      /// time and every parameter passed to HeightmapData::FillHeightMap,
+      /// except _flipY which is always false.
+      /// \param[in] _filename Full path to the heightmap file.
+      /// \param[in] _subSampling Subsampling used to fill the heights.
+      /// \param[in] _vertSize Number of vertices per side.
+      /// \param[in] _size Size of the terrain.
+      /// \param[in] _scale Scale applied to the heights.
+      /// \param[in] _tileSize Number of cells per tile side.
+      /// \return Path to the cache file, inside the Gazebo log directory.
+      public: static std::string CacheFilename(const std::string &_filename,
+                  const int _subSampling, const unsigned int _vertSize,
+                  const ignition::math::Vector3d &_size,
+                  const ignition::math::Vector3d &_scale,
+                  const unsigned int _tileSize);
+
+      /// \brief Open a cache file previously written with Build. No tile is
+      /// mapped until it is accessed.
+      /// \param[in] _filename Path of the cache file.
+      /// \return True if the file exists and has a valid header.
+      public: bool Load(const std::string &_filename);
+
+      /// \brief Release all tiles and close the cache file.
+      public: void Unload();
+
+      /// \brief Whether a cache file is currently loaded.
+      /// \return True if Load succeeded.
+      public: bool Valid() const;
+
+      /// \brief Number of levels in the pyramid.
+      /// \return Level count, at least 1 when the cache is valid.
+      public: unsigned int LevelCount() const;
+
+      /// \brief Number of vertices per side of a level.
+      /// \param[in] _level Pyramid level, 0 is the full resolution.
+      /// \return Vertex count per side.
+      public: unsigned int VertexCount(const unsigned int _level = 0) const;
+
+      /// \brief Number of cells per tile side.
+      /// \return Tile size.
+      public: unsigned int TileSize() const;
+
+      /// \brief Number of tiles per side of a level.
+      /// \param[in] _level Pyramid level, 0 is the full resolution.
+      /// \return Tile count per side.
+      public: unsigned int TileCount(const unsigned int _level = 0) const;
+
+      /// \brief Minimum height stored in the cache.
+      /// \return Minimum height.
+      public: float MinHeight() const;
+
+      /// \brief Maximum height stored in the cache.
+      /// \return Maximum height.
+      public: float MaxHeight() const;
+
+      /// \brief Get the height at a vertex. The tile holding the vertex is
+      /// mapped if it is not resident yet.
+      /// \param[in] _x Vertex index along the width.
+      /// \param[in] _y Vertex index along the height.
+      /// \param[in] _level Pyramid level, 0 is the full resolution.
+      /// \return The height, or 0 if the cache is not valid or the indices
+      /// are out of range.
+      public: float Height(const unsigned int _x, const unsigned int _y,
+                  const unsigned int _level = 0) const;
+
+      /// \brief Copy a region of a level into a row-major vector. Tiles
+      /// which are not resident are read from the file without being mapped,
+      /// so large regions can be copied without changing the residency.
+      /// \param[in] _x First column of the region.
+      /// \param[in] _y First row of the region.
+      /// \param[in] _width Number of columns.
+      /// \param[in] _height Number of rows.
+      /// \param[out] _heights Heights of the region.
+      /// \param[in] _level Pyramid level, 0 is the full resolution.
+      /// \return False if the region is out of range.
+      public: bool FillRegion(const unsigned int _x, const unsigned int _y,
+                  const unsigned int _width, const unsigned int _height,
+                  std::vector<float> &_heights,
+                  const unsigned int _level = 0) const;
+
+      /// \brief Copy the heights of a tile, see FillRegion. The tile has
+      /// (TileSize()+1) x (TileSize()+1) row-major values.
+      /// \param[in] _tx Tile index along the width.
+      /// \param[in] _ty Tile index along the height.
+      /// \param[out] _heights Heights of the tile.
+      /// \param[in] _level Pyramid level, 0 is the full resolution.
+      /// \return False if the tile is out of range or can't be read.
+      public: bool Tile(const unsigned int _tx, const unsigned int _ty,
+                  std::vector<float> &_heights,
+                  const unsigned int _level = 0) const;
+
+      /// \brief Keep the tiles of a level around a set of vertices resident
+      /// and release every other tile of that level.
+      /// \param[in] _centers Vertex coordinates (x, y) of interest, in the
+      /// coordinates of the level.
+      /// \param[in] _radius Half size, in vertices, of the square window
+      /// around each center whose tiles must stay resident.
+      /// \param[in] _level Pyramid level, 0 is the full resolution.
+      public: void UpdateResidency(
+                  const std::vector<std::pair<int, int>> &_centers,
+                  const unsigned int _radius,
+                  const unsigned int _level = 0);
+
+      /// \brief Number of tiles currently mapped.
+      /// \return Resident tile count.
+      public: unsigned int ResidentTileCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<HeightmapTileCachePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/common/HeightmapTileCache.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class HeightmapTileCacheTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Create a heightmap with a distinct height per vertex.
+  /// \param[in] _vertSize Vertices per side.
+  /// \return Row-major heights.
+  protected: std::vector<float> Heights(const unsigned int _vertSize)
+  {
+    std::vector<float> heights(_vertSize * _vertSize);
+    for (unsigned int i = 0; i < heights.size(); ++i)
+      heights[i] = 0.25f * i - 10.0f;
+    return heights;
+  }
+
+  /// \brief Path of a temporary cache file.
+  /// \param[in] _name File name.
+  /// \return Full path.
+  protected: std::string CachePath(const std::string &_name)
+  {
+    boost::filesystem::path path =
+        boost::filesystem::temp_directory_path() / "gazebo";
+    boost::filesystem::create_directories(path);
+    path /= _name;
+    boost::filesystem::remove(path);
+    return path.string();
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, InvalidFile)
+{
+  common::HeightmapTileCache cache;
+  EXPECT_FALSE(cache.Load("/file/shouldn/never/exist.tiles"));
+  EXPECT_FALSE(cache.Valid());
+  EXPECT_FLOAT_EQ(cache.Height(0, 0), 0.0f);
+  std::vector<float> tile;
+  EXPECT_FALSE(cache.Tile(0, 0, tile));
+
+  std::vector<float> heights = this->Heights(5);
+  EXPECT_FALSE(common::HeightmapTileCache::Build(
+      this->CachePath("bad.tiles"), heights, 6, 2));
+  EXPECT_FALSE(common::HeightmapTileCache::Build(
+      this->CachePath("bad.tiles"), heights, 5, 0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, Heights)
+{
+  const unsigned int vertSize = 129;
+  std::vector<float> heights = this->Heights(vertSize);
+  std::string path = this->CachePath("heights.tiles");
+
+  ASSERT_TRUE(common::HeightmapTileCache::Build(path, heights, vertSize, 32));
+
+  common::HeightmapTileCache cache;
+  ASSERT_TRUE(cache.Load(path));
+  EXPECT_TRUE(cache.Valid());
+  EXPECT_EQ(cache.VertexCount(), vertSize);
+  EXPECT_EQ(cache.TileSize(), 32u);
+  EXPECT_EQ(cache.TileCount(), 4u);
+  EXPECT_FLOAT_EQ(cache.MinHeight(), heights.front());
+  EXPECT_FLOAT_EQ(cache.MaxHeight(), heights.back());
+
+  // Nothing is resident until it is accessed
+  EXPECT_EQ(cache.ResidentTileCount(), 0u);
+
+  for (unsigned int y = 0; y < vertSize; ++y)
+  {
+    for (unsigned int x = 0; x < vertSize; ++x)
+      EXPECT_FLOAT_EQ(cache.Height(x, y), heights[y * vertSize + x]);
+  }
+  EXPECT_EQ(cache.ResidentTileCount(), 16u);
+
+  // Out of range
+  EXPECT_FLOAT_EQ(cache.Height(vertSize, 0), 0.0f);
+  EXPECT_FLOAT_EQ(cache.Height(0, vertSize), 0.0f);
+
+  // Neighbouring tiles share their border vertices
+  std::vector<float> tile0;
+  std::vector<float> tile1;
+  ASSERT_TRUE(cache.Tile(0, 0, tile0));
+  ASSERT_TRUE(cache.Tile(1, 0, tile1));
+  ASSERT_EQ(tile0.size(), 33u * 33u);
+  ASSERT_EQ(tile1.size(), 33u * 33u);
+  EXPECT_FALSE(cache.Tile(4, 0, tile0));
+  for (unsigned int y = 0; y <= 32; ++y)
+    EXPECT_FLOAT_EQ(tile0[y * 33 + 32], tile1[y * 33]);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, Residency)
+{
+  const unsigned int vertSize = 257;
+  std::vector<float> heights = this->Heights(vertSize);
+  std::string path = this->CachePath("residency.tiles");
+
+  ASSERT_TRUE(common::HeightmapTileCache::Build(path, heights, vertSize, 64));
+
+  common::HeightmapTileCache cache;
+  ASSERT_TRUE(cache.Load(path));
+  EXPECT_EQ(cache.TileCount(), 4u);
+
+  // A point in the middle of a tile keeps a single tile resident
+  cache.UpdateResidency({{10, 10}}, 5);
+  EXPECT_EQ(cache.ResidentTileCount(), 1u);
+
+  // A point on a tile corner keeps the four surrounding tiles
+  cache.UpdateResidency({{64, 64}}, 1);
+  EXPECT_EQ(cache.ResidentTileCount(), 4u);
+
+  // Two distant points
+  cache.UpdateResidency({{10, 10}, {250, 250}}, 2);
+  EXPECT_EQ(cache.ResidentTileCount(), 2u);
+
+  // Points outside the heightmap do not load anything
+  cache.UpdateResidency({{-1000, -1000}, {5000, 5000}}, 10);
+  EXPECT_EQ(cache.ResidentTileCount(), 0u);
+
+  // Evicted tiles are loaded again on access
+  EXPECT_FLOAT_EQ(cache.Height(200, 100), heights[100 * vertSize + 200]);
+  EXPECT_EQ(cache.ResidentTileCount(), 1u);
+
+  cache.Unload();
+  EXPECT_FALSE(cache.Valid());
+  EXPECT_EQ(cache.ResidentTileCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, Pyramid)
+{
+  const unsigned int vertSize = 257;
+  std::vector<float> heights = this->Heights(vertSize);
+  std::string path = this->CachePath("pyramid.tiles");
+
+  ASSERT_TRUE(common::HeightmapTileCache::Build(path, heights, vertSize, 32));
+
+  common::HeightmapTileCache cache;
+  ASSERT_TRUE(cache.Load(path));
+
+  // 257 -> 129 -> 65 -> 33, the last level fits in a single tile
+  ASSERT_EQ(cache.LevelCount(), 4u);
+  EXPECT_EQ(cache.VertexCount(1), 129u);
+  EXPECT_EQ(cache.VertexCount(3), 33u);
+  EXPECT_EQ(cache.TileCount(0), 8u);
+  EXPECT_EQ(cache.TileCount(1), 4u);
+  EXPECT_EQ(cache.TileCount(3), 1u);
+  EXPECT_EQ(cache.VertexCount(4), 0u);
+  EXPECT_EQ(cache.TileCount(4), 0u);
+
+  // Each level keeps every other vertex of the previous one
+  for (unsigned int level = 0; level < cache.LevelCount(); ++level)
+  {
+    const unsigned int step = 1u << level;
+    const unsigned int levelSize = cache.VertexCount(level);
+    for (unsigned int y = 0; y < levelSize; ++y)
+    {
+      for (unsigned int x = 0; x < levelSize; ++x)
+      {
+        EXPECT_FLOAT_EQ(cache.Height(x, y, level),
+            heights[y * step * vertSize + x * step]);
+      }
+    }
+  }
+
+  // Regions spanning several tiles
+  std::vector<float> region;
+  ASSERT_TRUE(cache.FillRegion(30, 60, 100, 7, region));
+  ASSERT_EQ(region.size(), 700u);
+  for (unsigned int y = 0; y < 7; ++y)
+  {
+    for (unsigned int x = 0; x < 100; ++x)
+    {
+      EXPECT_FLOAT_EQ(region[y * 100 + x],
+          heights[(60 + y) * vertSize + 30 + x]);
+    }
+  }
+
+  ASSERT_TRUE(cache.FillRegion(0, 128, 129, 1, region, 1));
+  for (unsigned int x = 0; x < 129; ++x)
+    EXPECT_FLOAT_EQ(region[x], heights[256 * vertSize + x * 2]);
+
+  EXPECT_FALSE(cache.FillRegion(200, 0, 58, 1, region));
+  EXPECT_FALSE(cache.FillRegion(0, 0, 1, 1, region, 4));
+
+  // Residency is handled per level
+  cache.UpdateResidency({}, 1);
+  cache.UpdateResidency({}, 1, 1);
+  cache.UpdateResidency({}, 1, 2);
+  cache.UpdateResidency({{16, 16}}, 1, 3);
+  EXPECT_EQ(cache.ResidentTileCount(), 1u);
+  cache.UpdateResidency({{16, 16}}, 1, 1);
+  EXPECT_EQ(cache.ResidentTileCount(), 2u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, StreamingBuild)
+{
+  const unsigned int vertSize = 129;
+  std::vector<float> heights = this->Heights(vertSize);
+  std::string path = this->CachePath("streaming.tiles");
+
+  // The heights are requested in full width strips of one row of tiles
+  unsigned int calls = 0;
+  ASSERT_TRUE(common::HeightmapTileCache::Build(path, vertSize, 16,
+      [&](unsigned int _x, unsigned int _y, unsigned int _width,
+        unsigned int _height, std::vector<float> &_out)
+      {
+        ++calls;
+        EXPECT_EQ(_x, 0u);
+        EXPECT_EQ(_width, vertSize);
+        EXPECT_LE(_height, 17u);
+        _out.resize(_width * _height);
+        for (unsigned int i = 0; i < _out.size(); ++i)
+          _out[i] = heights[_y * vertSize + i];
+      }));
+  EXPECT_EQ(calls, 8u);
+
+  common::HeightmapTileCache cache;
+  ASSERT_TRUE(cache.Load(path));
+  EXPECT_FLOAT_EQ(cache.MinHeight(), heights.front());
+  EXPECT_FLOAT_EQ(cache.MaxHeight(), heights.back());
+
+  // Copying a region doesn't map the tiles which aren't resident
+  std::vector<float> all;
+  ASSERT_TRUE(cache.FillRegion(0, 0, vertSize, vertSize, all));
+  EXPECT_EQ(all, heights);
+  EXPECT_EQ(cache.ResidentTileCount(), 0u);
+
+  cache.UpdateResidency({{0, 0}}, 1);
+  EXPECT_EQ(cache.ResidentTileCount(), 1u);
+  ASSERT_TRUE(cache.FillRegion(0, 0, vertSize, vertSize, all));
+  EXPECT_EQ(all, heights);
+  EXPECT_EQ(cache.ResidentTileCount(), 1u);
+
+  // A fill function returning the wrong number of heights fails the build,
+  // and leaves any previous cache file untouched
+  auto badFill = [](unsigned int, unsigned int, unsigned int, unsigned int,
+      std::vector<float> &_out)
+  {
+    _out.clear();
+  };
+  EXPECT_FALSE(common::HeightmapTileCache::Build(path, vertSize, 16, badFill));
+  EXPECT_TRUE(cache.Load(path));
+
+  std::string badPath = this->CachePath("bad_streaming.tiles");
+  EXPECT_FALSE(common::HeightmapTileCache::Build(
+      badPath, vertSize, 16, badFill));
+  EXPECT_FALSE(boost::filesystem::exists(badPath));
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTileCacheTest, ConcurrentResidency)
+{
+  const unsigned int vertSize = 257;
+  std::vector<float> heights = this->Heights(vertSize);
+  std::string path = this->CachePath("concurrent.tiles");
+
+  ASSERT_TRUE(common::HeightmapTileCache::Build(path, heights, vertSize, 32));
+
+  common::HeightmapTileCache cache;
+  ASSERT_TRUE(cache.Load(path));
+
+  // Tiles are released while other threads read them, as when the physics
+  // update moves the resident window while sensors and requests read heights
+  std::atomic<bool> done(false);
+  std::atomic<unsigned int> errors(0);
+  std::vector<std::thread> readers;
+  for (unsigned int t = 0; t < 4; ++t)
+  {
+    readers.push_back(std::thread([&, t]()
+      {
+        std::vector<float> region;
+        unsigned int i = t;
+        while (!done)
+        {
+          const unsigned int x = (i * 37) % vertSize;
+          const unsigned int y = (i * 91) % vertSize;
+          if (!ignition::math::equal(cache.Height(x, y),
+                heights[y * vertSize + x]))
+          {
+            ++errors;
+          }
+          if (!cache.FillRegion(0, y, vertSize, 1, region) ||
+              region[x] != heights[y * vertSize + x])
+          {
+            ++errors;
+          }
+          ++i;
+        }
+      }));
+  }
+
+  for (int i = 0; i < 2000; ++i)
+  {
+    const int c = (i * 13) % vertSize;
+    cache.UpdateResidency({{c, c}}, 1);
+  }
+  done = true;
+  for (auto &reader : readers)
+    reader.join();
+
+  EXPECT_EQ(errors, 0u);
+  cache.UpdateResidency({}, 1);
+  EXPECT_EQ(cache.ResidentTileCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
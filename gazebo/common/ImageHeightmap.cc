@@ -45,8 +45,28 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
     const ignition::math::Vector3d &_scale, bool _flipY,
     std::vector<float> &_heights)
 {
-  // Resize the vector to match the size of the vertices.
-  _heights.resize(_vertSize * _vertSize);
+  this->FillHeightMapRegion(_subSampling, _vertSize, _size, _scale, _flipY,
+      0, 0, _vertSize, _vertSize, _heights);
+}
+
+//////////////////////////////////////////////////
+void ImageHeightmap::FillHeightMapRegion(int _subSampling,
+    unsigned int _vertSize, const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, bool _flipY,
+    unsigned int _x, unsigned int _y, unsigned int _width,
+    unsigned int _height, std::vector<float> &_heights)
+{
+  if (_x + _width > _vertSize || _y + _height > _vertSize)
+  {
+    gzerr << "Heightmap region [" << _x << ", " << _y << ", " << _width
+          << ", " << _height << "] is outside of the " << _vertSize << "x"
+          << _vertSize << " heightmap" << std::endl;
+    _heights.clear();
+    return;
+  }
+
+  // Resize the vector to match the size of the region.
+  _heights.resize(_width * _height);
 
   int imgHeight = this->GetHeight();
   int imgWidth = this->GetWidth();
@@ -59,13 +79,18 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
   // Bytes per pixel
   unsigned int bpp = pitch / imgWidth;
 
+  // FreeImage has no partial decoding, so the whole image is accessed even
+  // when only a few rows are needed.
   unsigned char *data = nullptr;
   unsigned int count;
   this->img.GetData(&data, count);
 
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
+  // Iterate over the vertices of the region
+  for (unsigned int row = _y; row < _y + _height; ++row)
   {
+    // Row of the image sampled by this row of the region
+    unsigned int y = _flipY ? _vertSize - row - 1 : row;
+
     // yf ranges between 0 and 4
     double yf = y / static_cast<double>(_subSampling);
     int y1 = floor(yf);
@@ -74,7 +99,7 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
       y2 = imgHeight-1;
     double dy = yf - y1;
 
-    for (unsigned int x = 0; x < _vertSize; ++x)
+    for (unsigned int x = _x; x < _x + _width; ++x)
     {
       double xf = x / static_cast<double>(_subSampling);
       int x1 = floor(xf);
@@ -100,10 +125,7 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
         h = 1.0 - h;
 
       // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      _heights[(row - _y) * _width + (x - _x)] = h;
     }
   }
 
@@ -103,6 +103,49 @@ TEST_F(ImageHeightmapTest, FillHeightmap)
   EXPECT_NEAR(5.0, elevations.at(elevations.size() / 2), ELEVATION_TOL);
 }
 
+/////////////////////////////////////////////////
+TEST_F(ImageHeightmapTest, FillHeightmapRegion)
+{
+  common::ImageHeightmap img;
+  std::string path;
+
+  path = "file://media/materials/textures/heightmap_bowl.png";
+  EXPECT_EQ(0, img.Load(path));
+
+  int subsampling = 2;
+  unsigned int vertSize = (img.GetWidth() * subsampling) - 1;
+  ignition::math::Vector3d size(129, 129, 10);
+  ignition::math::Vector3d scale(size.X() / vertSize, size.Y() / vertSize,
+      fabs(size.Z()) / img.GetMaxElevation());
+
+  // A region must match the same part of the full lookup table
+  for (bool flipY : {false, true})
+  {
+    std::vector<float> elevations;
+    img.FillHeightMap(subsampling, vertSize, size, scale, flipY, elevations);
+
+    std::vector<float> region;
+    img.FillHeightMapRegion(subsampling, vertSize, size, scale, flipY,
+        31, 200, 40, 57, region);
+    ASSERT_EQ(40u * 57u, region.size());
+
+    for (unsigned int y = 0; y < 57; ++y)
+    {
+      for (unsigned int x = 0; x < 40; ++x)
+      {
+        EXPECT_FLOAT_EQ(elevations[(200 + y) * vertSize + 31 + x],
+            region[y * 40 + x]);
+      }
+    }
+  }
+
+  // Regions outside of the lookup table are rejected
+  std::vector<float> region;
+  img.FillHeightMapRegion(subsampling, vertSize, size, scale, false,
+      vertSize - 1, 0, 2, 1, region);
+  EXPECT_TRUE(region.empty());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -22,9 +22,18 @@
 #include <curl/curl.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/function.hpp>
@@ -37,6 +46,7 @@
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/FuelModelDatabase.hh"
 #include "gazebo/common/ModelDatabasePrivate.hh"
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/SemanticVersion.hh"
@@ -65,6 +75,233 @@ size_t get_models_cb(void *_buffer, size_t _size, size_t _nmemb, void *_userp)
   return _size;
 }
 
+/// \brief Default number of model download worker threads.
+static const unsigned int kDefaultDownloadThreads = 4;
+
+/// \brief Maximum number of model download worker threads.
+static const unsigned int kMaxDownloadThreads = 64;
+
+/////////////////////////////////////////////////
+/// \brief Number of model download worker threads.
+/// \return Value of GAZEBO_MODEL_DOWNLOAD_THREADS, or the default.
+static unsigned int downloadThreadCount()
+{
+  unsigned int count = kDefaultDownloadThreads;
+  char *countStr = getenv("GAZEBO_MODEL_DOWNLOAD_THREADS");
+  if (countStr)
+  {
+    int value = atoi(countStr);
+    if (value > 0)
+      count = std::min(static_cast<unsigned int>(value), kMaxDownloadThreads);
+    else
+      gzwarn << "Invalid GAZEBO_MODEL_DOWNLOAD_THREADS [" << countStr
+             << "], using " << count << " threads.\n";
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+/// \brief Main loop of a model download worker thread.
+/// \param[in] _data Model database private data.
+static void downloadWorker(ModelDatabasePrivate *_data)
+{
+  std::unique_lock<std::mutex> lock(_data->downloadMutex);
+  while (true)
+  {
+    _data->downloadCondition.wait(lock, [_data]
+        {
+          return _data->stopDownloads || !_data->downloadTasks.empty();
+        });
+
+    if (_data->stopDownloads)
+      break;
+
+    ModelDatabasePrivate::DownloadTask task =
+        std::move(_data->downloadTasks.front().second);
+    _data->downloadTasks.pop_front();
+
+    lock.unlock();
+    task(false);
+    lock.lock();
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Queue a download task, starting a worker thread if the pool is
+/// not full yet.
+/// \param[in] _data Model database private data.
+/// \param[in] _key Key of the pending download.
+/// \param[in] _task Task to run.
+static void queueDownload(ModelDatabasePrivate *_data,
+    const std::string &_key, ModelDatabasePrivate::DownloadTask _task)
+{
+  {
+    std::lock_guard<std::mutex> lock(_data->downloadMutex);
+    if (!_data->stopDownloads)
+    {
+      _data->downloadTasks.emplace_back(_key, std::move(_task));
+      if (_data->downloadThreads.size() < downloadThreadCount())
+        _data->downloadThreads.emplace_back(downloadWorker, _data);
+      _data->downloadCondition.notify_one();
+      return;
+    }
+  }
+
+  // The database is stopped
+  _task(true);
+}
+
+/////////////////////////////////////////////////
+/// \brief Wait for a download. A worker thread waiting for the dependencies
+/// of a model runs the download itself if it is still queued, so that the
+/// workers can't all wait for tasks that no worker is free to run. Other
+/// threads only wait, and leave the queue to the workers.
+/// \param[in] _data Model database private data.
+/// \param[in] _key Key of the pending download.
+/// \param[in] _future Download to wait for.
+/// \return Result of the download.
+static std::string waitForDownload(ModelDatabasePrivate *_data,
+    const std::string &_key, const std::shared_future<std::string> &_future)
+{
+  ModelDatabasePrivate::DownloadTask task;
+  {
+    std::lock_guard<std::mutex> lock(_data->downloadMutex);
+    auto worker = std::find_if(_data->downloadThreads.begin(),
+        _data->downloadThreads.end(), [](const std::thread &_thread)
+        {
+          return _thread.get_id() == std::this_thread::get_id();
+        });
+    if (worker != _data->downloadThreads.end())
+    {
+      auto queued = std::find_if(_data->downloadTasks.begin(),
+          _data->downloadTasks.end(),
+          [&_key](const ModelDatabasePrivate::KeyedDownloadTask &_task)
+          {
+            return _task.first == _key;
+          });
+      if (queued != _data->downloadTasks.end())
+      {
+        task = std::move(queued->second);
+        _data->downloadTasks.erase(queued);
+      }
+    }
+  }
+
+  if (task)
+    task(false);
+
+  return _future.get();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a future that is already holding a value.
+/// \param[in] _value Value of the future.
+/// \return The future.
+static std::shared_future<std::string> readyFuture(const std::string &_value)
+{
+  std::promise<std::string> promise;
+  promise.set_value(_value);
+  return promise.get_future().share();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the name of a model on the model database from its URI.
+/// \param[in] _uri model:// URI, or URI on the model database.
+/// \param[out] _suffix Part of the URI after the model name.
+/// \return The model name, empty if the URI is invalid.
+static std::string databaseModelName(const std::string &_uri,
+    std::string &_suffix)
+{
+  _suffix.clear();
+  if (_uri.find("://") == std::string::npos)
+    return std::string();
+
+  std::string modelName = _uri;
+  boost::replace_first(modelName, "model://", "");
+  boost::replace_first(modelName, ModelDatabase::GetURI(), "");
+
+  size_t startIndex = modelName[0] == '/' ? 1 : 0;
+  size_t endIndex = modelName.find_first_of("/", startIndex);
+  size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
+    endIndex - startIndex;
+
+  if (endIndex != std::string::npos)
+    _suffix = modelName.substr(endIndex, std::string::npos);
+
+  return modelName.substr(startIndex, modelNameLen);
+}
+
+/////////////////////////////////////////////////
+/// \brief Find a model in the local model paths, without downloading it.
+/// \param[in] _modelName Name of the model directory.
+/// \return Path to the model directory, empty if not found.
+static std::string localModelPath(const std::string &_modelName)
+{
+  std::list<std::string> paths = SystemPaths::Instance()->GetModelPaths();
+  for (auto const &dir : paths)
+  {
+    boost::filesystem::path path = boost::filesystem::path(dir) / _modelName;
+    if (boost::filesystem::exists(path))
+      return path.string();
+  }
+  return std::string();
+}
+
+/////////////////////////////////////////////////
+/// \brief Whether a URI should be resolved by Ignition Fuel.
+/// \param[in] _uri The URI.
+/// \return True for http and https URIs outside of the model database.
+static bool isFuelURI(const std::string &_uri)
+{
+  return (_uri.compare(0, 7, "http://") == 0 ||
+          _uri.compare(0, 8, "https://") == 0) &&
+         _uri.compare(0, ModelDatabase::GetURI().size(),
+           ModelDatabase::GetURI()) != 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the key of the pending download of a model.
+/// \param[in] _uri URI of the model.
+/// \return The URI for Fuel models, model://<name> for the models of the
+/// model database, or an empty string if the URI is invalid.
+static std::string downloadKey(const std::string &_uri)
+{
+  if (isFuelURI(_uri))
+    return _uri;
+
+  std::string suffix;
+  std::string modelName = databaseModelName(_uri, suffix);
+  if (modelName.empty())
+    return std::string();
+  return "model://" + modelName;
+}
+
+/////////////////////////////////////////////////
+/// \brief Collect the URIs of all the includes in an XML element.
+/// \param[in] _elem Element to search recursively.
+/// \param[out] _uris URIs found.
+static void includeURIs(TiXmlElement *_elem, std::set<std::string> &_uris)
+{
+  for (TiXmlElement *child = _elem->FirstChildElement(); child;
+       child = child->NextSiblingElement())
+  {
+    if (child->ValueStr() == "include")
+    {
+      TiXmlElement *uriElem = child->FirstChildElement("uri");
+      if (uriElem && uriElem->GetText())
+      {
+        std::string uri = uriElem->GetText();
+        boost::algorithm::trim(uri);
+        _uris.insert(uri);
+      }
+    }
+    else
+    {
+      includeURIs(child, _uris);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 ModelDatabase::ModelDatabase()
   : dataPtr(new ModelDatabasePrivate)
@@ -86,6 +323,11 @@ void ModelDatabase::Start(bool _fetchImmediately)
 {
   boost::recursive_mutex::scoped_lock lock(this->dataPtr->startCacheMutex);
 
+  {
+    std::lock_guard<std::mutex> downloadLock(this->dataPtr->downloadMutex);
+    this->dataPtr->stopDownloads = false;
+  }
+
   if (!this->dataPtr->updateCacheThread)
   {
     this->dataPtr->stop = false;
@@ -112,6 +354,28 @@ void ModelDatabase::Fini()
     delete this->dataPtr->updateCacheThread;
     this->dataPtr->updateCacheThread = nullptr;
   }
+
+  // Stop the download threads, and cancel the downloads that didn't start.
+  std::deque<ModelDatabasePrivate::KeyedDownloadTask> tasks;
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+    this->dataPtr->stopDownloads = true;
+    tasks.swap(this->dataPtr->downloadTasks);
+    threads.swap(this->dataPtr->downloadThreads);
+  }
+  this->dataPtr->downloadCondition.notify_all();
+
+  for (auto &thread : threads)
+  {
+    if (thread.get_id() != std::this_thread::get_id())
+      thread.join();
+    else
+      thread.detach();
+  }
+
+  for (auto &task : tasks)
+    task.second(true);
 }
 
 /////////////////////////////////////////////////
@@ -415,130 +679,187 @@ std::string ModelDatabase::GetModelPath(const std::string &_uri,
     }
 
     // Get the model name from the uri
-    size_t startIndex = _uri.find_first_of("://");
-    if (startIndex == std::string::npos)
+    std::string modelName = databaseModelName(_uri, suffix);
+    if (modelName.empty())
     {
       gzerr << "URI[" << _uri << "] is missing ://\n";
       return std::string();
     }
 
-    std::string modelName = _uri;
-    boost::replace_first(modelName, "model://", "");
-    boost::replace_first(modelName, ModelDatabase::GetURI(), "");
-
-    startIndex = modelName[0] == '/' ? 1 : 0;
-    size_t endIndex = modelName.find_first_of("/", startIndex);
-    size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
-      endIndex - startIndex;
-
-    if (endIndex != std::string::npos)
-      suffix = modelName.substr(endIndex, std::string::npos);
-
-    modelName = modelName.substr(startIndex, modelNameLen);
-
-    // Store downloaded .tar.gz and intermediate .tar files in temp location
-    boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
-    tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
-    std::string tarfilename = tmppath.string() + ".tar";
-    std::string tgzfilename = tarfilename + ".gz";
-
-    CURL *curl = curl_easy_init();
-    if (!curl)
-    {
-      gzerr << "Unable to initialize libcurl\n";
-      return std::string();
-    }
-
-    curl_easy_setopt(curl, CURLOPT_URL,
-        (ModelDatabase::GetURI() + "/" +
-         modelName + "/model.tar.gz").c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-
-    bool retry = true;
-    int iterations = 0;
-    while (retry && iterations < 4)
+    // Wait for a download of the same model that is already pending,
+    // otherwise download the model on this thread.
+    std::string key = "model://" + modelName;
+    std::shared_future<std::string> pending;
+    std::shared_ptr<std::promise<std::string>> promise;
     {
-      retry = false;
-      iterations++;
-
-      FILE *fp = fopen(tgzfilename.c_str(), "wb");
-      if (!fp)
+      std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+      auto iter = this->dataPtr->pendingDownloads.find(key);
+      if (iter != this->dataPtr->pendingDownloads.end())
       {
-        gzerr << "Could not download model[" << _uri << "] because we were"
-          << "unable to write to file[" << tgzfilename << "]."
-          << "Please fix file permissions.";
-        return std::string();
+        pending = iter->second;
       }
-
-      /// Download the model tarball
-      curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-      CURLcode success = curl_easy_perform(curl);
-
-      if (success != CURLE_OK)
+      else
       {
-        gzwarn << "Unable to connect to model database using ["
-               << _uri << "]\n";
-        retry = true;
-        continue;
+        promise = std::make_shared<std::promise<std::string>>();
+        this->dataPtr->pendingDownloads[key] = promise->get_future().share();
       }
+    }
 
-      fclose(fp);
-
+    if (promise)
+    {
+      // The promise must be fulfilled whatever happens, or the waits on
+      // this model would never return
       try
       {
-        // Unzip model tarball
-        std::ifstream file(tgzfilename.c_str(),
-            std::ios_base::in | std::ios_base::binary);
-        std::ofstream out(tarfilename.c_str(),
-            std::ios_base::out | std::ios_base::binary);
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-        in.push(boost::iostreams::gzip_decompressor());
-        in.push(file);
-        boost::iostreams::copy(in, out);
+        path = this->DownloadModel(modelName, _uri);
+      }
+      catch(const std::exception &_e)
+      {
+        gzerr << "Unable to download model[" << _uri << "]: "
+              << _e.what() << "\n";
       }
       catch(...)
       {
-        gzerr << "Failed to unzip model tarball. Trying again...\n";
-        retry = true;
-        continue;
+        gzerr << "Unable to download model[" << _uri << "]\n";
       }
 
-#ifndef _WIN32
-      TAR *tar;
-      tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
-          nullptr, O_RDONLY, 0644, TAR_GNU);
+      promise->set_value(path);
 
-      std::string outputPath = getenv("HOME");
-      outputPath += "/.gazebo/models";
+      std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+      this->dataPtr->pendingDownloads.erase(key);
+    }
+    else
+    {
+      path = waitForDownload(this->dataPtr, key, pending);
+    }
+  }
 
-      tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
-      path = outputPath + "/" + modelName;
+  return path + suffix;
+}
 
-      ModelDatabase::DownloadDependencies(path);
-#endif
+/////////////////////////////////////////////////
+std::string ModelDatabase::DownloadModel(const std::string &_modelName,
+    const std::string &_uri)
+{
+  const std::string key = "model://" + _modelName;
+  std::string path;
+
+  // Store downloaded .tar.gz and intermediate .tar files in temp location
+  boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
+  tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
+  std::string tarfilename = tmppath.string() + ".tar";
+  std::string tgzfilename = tarfilename + ".gz";
+
+  CURL *curl = curl_easy_init();
+  if (!curl)
+  {
+    gzerr << "Unable to initialize libcurl\n";
+    return std::string();
+  }
+
+  curl_easy_setopt(curl, CURLOPT_URL,
+      (ModelDatabase::GetURI() + "/" +
+       _modelName + "/model.tar.gz").c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
+
+  bool retry = true;
+  int iterations = 0;
+  while (retry && iterations < 4)
+  {
+    retry = false;
+    iterations++;
+
+    FILE *fp = fopen(tgzfilename.c_str(), "wb");
+    if (!fp)
+    {
+      gzerr << "Could not download model[" << _uri << "] because we were"
+        << "unable to write to file[" << tgzfilename << "]."
+        << "Please fix file permissions.";
+      return std::string();
     }
 
-    curl_easy_cleanup(curl);
-    if (retry)
+    /// Download the model tarball
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
+    CURLcode success = curl_easy_perform(curl);
+
+    if (success != CURLE_OK)
     {
-      gzerr << "Could not download model[" << _uri << "]."
-        << "The model may be corrupt.\n";
-      path.clear();
+      gzwarn << "Unable to connect to model database using ["
+             << _uri << "]\n";
+      fclose(fp);
+      retry = true;
+      continue;
     }
 
-    // Clean up
+    fclose(fp);
+
     try
     {
-      boost::filesystem::remove(tarfilename);
-      boost::filesystem::remove(tgzfilename);
+      // Unzip model tarball
+      std::ifstream file(tgzfilename.c_str(),
+          std::ios_base::in | std::ios_base::binary);
+      std::ofstream out(tarfilename.c_str(),
+          std::ios_base::out | std::ios_base::binary);
+      boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+      in.push(boost::iostreams::gzip_decompressor());
+      in.push(file);
+      boost::iostreams::copy(in, out);
     }
     catch(...)
     {
-      gzwarn << "Failed to remove temporary model files after download.";
+      gzerr << "Failed to unzip model tarball. Trying again...\n";
+      retry = true;
+      continue;
+    }
+
+#ifndef _WIN32
+    TAR *tar;
+    tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
+        nullptr, O_RDONLY, 0644, TAR_GNU);
+
+    std::string outputPath = getenv("HOME");
+    outputPath += "/.gazebo/models";
+
+    tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
+    tar_close(tar);
+    path = outputPath + "/" + _modelName;
+
+    // The model is usable from now on by the models it depends on, in
+    // case of circular dependencies.
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+      this->dataPtr->extractedDownloads[key] = path;
+    }
+
+    this->DownloadDependencies(path);
+
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+      this->dataPtr->extractedDownloads.erase(key);
     }
+#endif
   }
 
-  return path + suffix;
+  curl_easy_cleanup(curl);
+  if (retry)
+  {
+    gzerr << "Could not download model[" << _uri << "]."
+      << "The model may be corrupt.\n";
+    path.clear();
+  }
+
+  // Clean up
+  try
+  {
+    boost::filesystem::remove(tarfilename);
+    boost::filesystem::remove(tgzfilename);
+  }
+  catch(...)
+  {
+    gzwarn << "Failed to remove temporary model files after download.";
+  }
+
+  return path;
 }
 
 /////////////////////////////////////////////////
@@ -569,14 +890,17 @@ void ModelDatabase::DownloadDependencies(const std::string &_path)
     if (!dependXML)
       return;
 
+    // Download the models that don't exist, all at the same time.
+    std::vector<std::pair<std::string, std::shared_future<std::string>>>
+        downloads;
     for (TiXmlElement *depXML = dependXML->FirstChildElement("model");
          depXML; depXML = depXML->NextSiblingElement())
     {
       TiXmlElement *uriXML = depXML->FirstChildElement("uri");
-      if (uriXML)
+      if (uriXML && uriXML->GetText())
       {
-        // Download the model if it doesn't exist.
-        ModelDatabase::GetModelPath(uriXML->GetText());
+        downloads.push_back(std::make_pair(downloadKey(uriXML->GetText()),
+            this->PrefetchModel(uriXML->GetText())));
       }
       else
       {
@@ -584,11 +908,147 @@ void ModelDatabase::DownloadDependencies(const std::string &_path)
               << manifestPath << "]\n";
       }
     }
+
+    for (auto const &download : downloads)
+      waitForDownload(this->dataPtr, download.first, download.second);
   }
   else
     gzerr << "Unable to load manifest file[" << manifestPath << "]\n";
 }
 
+/////////////////////////////////////////////////
+std::shared_future<std::string> ModelDatabase::PrefetchModel(
+    const std::string &_uri)
+{
+  bool fuel = isFuelURI(_uri);
+  std::string modelName;
+  std::string key = _uri;
+  if (!fuel)
+  {
+    std::string suffix;
+    modelName = databaseModelName(_uri, suffix);
+    if (modelName.empty())
+    {
+      gzerr << "URI[" << _uri << "] is missing ://\n";
+      return readyFuture(std::string());
+    }
+    key = "model://" + modelName;
+  }
+
+  std::shared_ptr<std::promise<std::string>> promise;
+  std::shared_future<std::string> future;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+
+    auto extracted = this->dataPtr->extractedDownloads.find(key);
+    if (extracted != this->dataPtr->extractedDownloads.end())
+      return readyFuture(extracted->second);
+
+    auto pending = this->dataPtr->pendingDownloads.find(key);
+    if (pending != this->dataPtr->pendingDownloads.end())
+      return pending->second;
+
+    // Models installed locally don't need a worker
+    if (!fuel)
+    {
+      std::string path = localModelPath(modelName);
+      if (!path.empty())
+        return readyFuture(path);
+    }
+
+    promise = std::make_shared<std::promise<std::string>>();
+    future = promise->get_future().share();
+    this->dataPtr->pendingDownloads[key] = future;
+  }
+
+  queueDownload(this->dataPtr, key,
+      [this, promise, key, modelName, fuel, _uri](bool _cancel)
+      {
+        // The promise must be fulfilled whatever happens, or the waits on
+        // this model would never return
+        std::string path;
+        if (!_cancel)
+        {
+          try
+          {
+            if (fuel)
+              path = FuelModelDatabase::Instance()->ModelPath(_uri);
+            else if (this->HasModel(_uri))
+              path = this->DownloadModel(modelName, _uri);
+          }
+          catch(const std::exception &_e)
+          {
+            gzerr << "Unable to download model[" << _uri << "]: "
+                  << _e.what() << "\n";
+          }
+          catch(...)
+          {
+            gzerr << "Unable to download model[" << _uri << "]\n";
+          }
+        }
+
+        promise->set_value(path);
+
+        std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+        this->dataPtr->pendingDownloads.erase(key);
+      });
+
+  return future;
+}
+
+/////////////////////////////////////////////////
+std::map<std::string, std::shared_future<std::string>>
+    ModelDatabase::PrefetchIncludes(const std::string &_sdf)
+{
+  std::map<std::string, std::shared_future<std::string>> result;
+
+  TiXmlDocument xmlDoc;
+  xmlDoc.Parse(_sdf.c_str());
+  if (xmlDoc.Error() || !xmlDoc.RootElement())
+    return result;
+
+  std::set<std::string> uris;
+  includeURIs(xmlDoc.RootElement(), uris);
+
+  for (auto const &uri : uris)
+  {
+    if (uri.compare(0, 8, "model://") == 0 || isFuelURI(uri) ||
+        uri.compare(0, ModelDatabase::GetURI().size(),
+          ModelDatabase::GetURI()) == 0)
+    {
+      result[uri] = this->PrefetchModel(uri);
+    }
+  }
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::WaitForDownload(const std::string &_uri)
+{
+  std::vector<std::pair<std::string, std::shared_future<std::string>>>
+      downloads;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+    for (auto const &pending : this->dataPtr->pendingDownloads)
+    {
+      // Models that are extracted can already be used
+      if (this->dataPtr->extractedDownloads.count(pending.first))
+        continue;
+
+      const std::string &key = pending.first;
+      if (_uri.compare(0, key.size(), key) == 0 &&
+          (_uri.size() == key.size() || _uri[key.size()] == '/'))
+      {
+        downloads.push_back(pending);
+      }
+    }
+  }
+
+  for (auto const &download : downloads)
+    waitForDownload(this->dataPtr, download.first, download.second);
+}
+
 /////////////////////////////////////////////////
 std::string ModelDatabase::GetModelFile(const std::string &_uri)
 {
@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_MODELDATABSE_HH_
 #define _GAZEBO_MODELDATABSE_HH_
 
+#include <future>
 #include <string>
 #include <map>
 #include <utility>
@@ -129,6 +130,38 @@ namespace gazebo
       /// \param[in] _path Path to a model.
       public: void DownloadDependencies(const std::string &_path);
 
+      /// \brief Start downloading a model and its dependencies in the
+      /// background.
+      ///
+      /// Downloads run on a bounded pool of worker threads. The pool size is
+      /// read from the GAZEBO_MODEL_DOWNLOAD_THREADS environment variable
+      /// and defaults to 4. Concurrent requests for the same model share a
+      /// single download, and GetModelPath waits for a pending download
+      /// instead of starting a new one. Both model:// URIs and Ignition Fuel
+      /// (http and https) URIs are supported.
+      /// \param[in] _uri URI of the model.
+      /// \return Future holding the local path to the model directory, or an
+      /// empty string if the model could not be found. The future is ready
+      /// immediately for models that are installed locally.
+      public: std::shared_future<std::string> PrefetchModel(
+                  const std::string &_uri);
+
+      /// \brief Start downloading, in the background, every model included
+      /// by an SDF document. Calling this before parsing a world lets the
+      /// downloads run in parallel, instead of one at a time as the includes
+      /// are resolved by the parser.
+      /// \param[in] _sdf SDF document.
+      /// \return Futures holding the local path to each model directory,
+      /// indexed by the URI of the include.
+      /// \sa PrefetchModel
+      public: std::map<std::string, std::shared_future<std::string>>
+                  PrefetchIncludes(const std::string &_sdf);
+
+      /// \brief Wait for pending downloads of a model. Queued downloads are
+      /// run on the calling thread while waiting.
+      /// \param[in] _uri URI of the model, or of a file inside the model.
+      public: void WaitForDownload(const std::string &_uri);
+
       /// \brief Returns true if the model exists on the database.
       ///
       /// \param[in] _modelName URI of the model (eg:
@@ -136,6 +169,14 @@ namespace gazebo
       /// \return True if the model was found.
       public: bool HasModel(const std::string &_modelName);
 
+      /// \brief Download and extract a model from the database, then
+      /// download its dependencies.
+      /// \param[in] _modelName Name of the model on the database.
+      /// \param[in] _uri URI of the model.
+      /// \return Path to the model directory, empty on failure.
+      private: std::string DownloadModel(const std::string &_modelName,
+                   const std::string &_uri);
+
       /// \brief A helper function that uses CURL to get a manifest file.
       /// \param[in] _uri URI of a manifest XML file.
       /// \return The contents of the manifest file.
@@ -17,9 +17,17 @@
 #ifndef _GAZEBO_MODELDATABSE_PRIVATE_HH_
 #define _GAZEBO_MODELDATABSE_PRIVATE_HH_
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/thread.hpp>
@@ -68,6 +76,38 @@ namespace gazebo
       /// calling ModelDatabase::GetModels()
       public: event::EventT<
                void (std::map<std::string, std::string>)> modelDBUpdated;
+
+      /// \brief A model download waiting for a worker thread. The argument
+      /// is true when the download is cancelled.
+      public: using DownloadTask = std::function<void (bool)>;
+
+      /// \brief Protects the download queue, the worker threads and the
+      /// pending downloads.
+      public: std::mutex downloadMutex;
+
+      /// \brief Signals new download tasks to the worker threads.
+      public: std::condition_variable downloadCondition;
+
+      /// \brief A download task with the key of its pending download.
+      public: using KeyedDownloadTask = std::pair<std::string, DownloadTask>;
+
+      /// \brief Download tasks waiting for a worker thread.
+      public: std::deque<KeyedDownloadTask> downloadTasks;
+
+      /// \brief Bounded pool of download worker threads, started on demand.
+      public: std::vector<std::thread> downloadThreads;
+
+      /// \brief True to stop the download worker threads.
+      public: bool stopDownloads = false;
+
+      /// \brief Downloads in progress or queued, indexed by model URI.
+      public: std::map<std::string, std::shared_future<std::string>>
+              pendingDownloads;
+
+      /// \brief Pending downloads whose model has already been extracted
+      /// while its dependencies are being fetched, indexed by model URI.
+      /// Used to resolve circular dependencies.
+      public: std::map<std::string, std::string> extractedDownloads;
     };
   }
 }
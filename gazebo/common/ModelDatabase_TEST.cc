@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <libtar.h>
+#endif
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <gtest/gtest.h>
+
+#include "gazebo/common/ModelDatabase.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+#ifndef _WIN32
+/// \brief Tests of the model downloads, using a model database served from
+/// a local directory through file:// URIs.
+class ModelDatabaseTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Create the model database directory. The model database caches
+  /// the list of models, so the database is shared by all the tests.
+  public: static void SetUpTestCase()
+  {
+    suffix = boost::filesystem::unique_path("%%%%%%%%").string();
+    dbPath = boost::filesystem::temp_directory_path() /
+        ("gz_model_db_" + suffix);
+    boost::filesystem::create_directories(dbPath / "src");
+
+    // Models are installed in $HOME/.gazebo/models, use a temporary home so
+    // that the tests don't write to the user's models
+    const char *home = getenv("HOME");
+    if (home)
+      homeBackup = home;
+    homePath = boost::filesystem::temp_directory_path() /
+        ("gz_model_home_" + suffix);
+    boost::filesystem::create_directories(homePath / ".gazebo" / "models");
+    setenv("HOME", homePath.string().c_str(), 1);
+
+    // a and b depend on each other
+    AddModel("a", {"b", "c"});
+    AddModel("b", {"a"});
+    AddModel("c", {});
+    AddModel("d", {});
+    AddModel("e", {});
+
+    std::ofstream config((dbPath / GZ_MODEL_DB_MANIFEST_FILENAME).string());
+    config << "<database><name>test</name><models>";
+    for (auto const &name : {"a", "b", "c", "d", "e"})
+      config << "<uri>file://" << ModelName(name) << "</uri>";
+    config << "</models></database>";
+    config.close();
+
+    setenv("GAZEBO_MODEL_DATABASE_URI",
+        ("file://" + dbPath.string()).c_str(), 1);
+    setenv("GAZEBO_MODEL_DOWNLOAD_THREADS", "2", 1);
+  }
+
+  /// \brief Remove the model database and the downloaded models.
+  public: static void TearDownTestCase()
+  {
+    boost::filesystem::remove_all(dbPath);
+    boost::filesystem::remove_all(homePath);
+    if (!homeBackup.empty())
+      setenv("HOME", homeBackup.c_str(), 1);
+  }
+
+  /// \brief Name of a test model on the database.
+  /// \param[in] _name Short name of the model.
+  /// \return Name unique to this test run.
+  public: static std::string ModelName(const std::string &_name)
+  {
+    return "prefetch_" + _name + "_" + suffix;
+  }
+
+  /// \brief Path where a test model is installed once downloaded.
+  /// \param[in] _name Short name of the model.
+  /// \return Model directory.
+  public: static std::string InstallPath(const std::string &_name)
+  {
+    return (homePath / ".gazebo" / "models" / ModelName(_name)).string();
+  }
+
+  /// \brief Add a model to the database.
+  /// \param[in] _name Short name of the model.
+  /// \param[in] _depends Short names of the models it depends on.
+  public: static void AddModel(const std::string &_name,
+              const std::vector<std::string> &_depends)
+  {
+    std::string name = ModelName(_name);
+    boost::filesystem::path src = dbPath / "src" / name;
+    boost::filesystem::path dst = dbPath / name;
+    boost::filesystem::create_directories(src);
+    boost::filesystem::create_directories(dst);
+
+    std::ofstream config((src / GZ_MODEL_MANIFEST_FILENAME).string());
+    config << "<model><name>" << name << "</name>"
+           << "<sdf version='1.6'>model.sdf</sdf><depend>";
+    for (auto const &depend : _depends)
+    {
+      config << "<model><uri>model://" << ModelName(depend)
+             << "</uri></model>";
+    }
+    config << "</depend></model>";
+    config.close();
+
+    std::ofstream sdf((src / "model.sdf").string());
+    sdf << "<sdf version='1.6'><model name='" << name << "'>"
+        << "<static>true</static><link name='link'/></model></sdf>";
+    sdf.close();
+
+    boost::filesystem::copy_file(src / GZ_MODEL_MANIFEST_FILENAME,
+        dst / GZ_MODEL_MANIFEST_FILENAME);
+
+    // Archive the model
+    std::string tarPath = (dbPath / (name + ".tar")).string();
+    TAR *tar;
+    ASSERT_EQ(0, tar_open(&tar, const_cast<char *>(tarPath.c_str()),
+          nullptr, O_WRONLY | O_CREAT, 0644, TAR_GNU));
+    EXPECT_EQ(0, tar_append_tree(tar, const_cast<char *>(src.c_str()),
+          const_cast<char *>(name.c_str())));
+    tar_append_eof(tar);
+    tar_close(tar);
+
+    std::ifstream in(tarPath, std::ios_base::in | std::ios_base::binary);
+    std::ofstream file((dst / "model.tar.gz").string(),
+        std::ios_base::out | std::ios_base::binary);
+    boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
+    out.push(boost::iostreams::gzip_compressor());
+    out.push(file);
+    boost::iostreams::copy(in, out);
+  }
+
+  /// \brief Unique suffix of the test model names.
+  public: static std::string suffix;
+
+  /// \brief Directory of the model database.
+  public: static boost::filesystem::path dbPath;
+
+  /// \brief Temporary home directory where the models are installed.
+  public: static boost::filesystem::path homePath;
+
+  /// \brief Value of HOME before the tests.
+  public: static std::string homeBackup;
+};
+
+std::string ModelDatabaseTest::suffix;
+boost::filesystem::path ModelDatabaseTest::dbPath;
+boost::filesystem::path ModelDatabaseTest::homePath;
+std::string ModelDatabaseTest::homeBackup;
+
+/////////////////////////////////////////////////
+TEST_F(ModelDatabaseTest, PrefetchIncludes)
+{
+  auto modelDB = common::ModelDatabase::Instance();
+
+  std::string world =
+      "<sdf version='1.6'><world name='default'>"
+      "<include><uri>model://" + ModelName("a") + "</uri></include>"
+      "<model name='nested'>"
+      "<include><uri> model://" + ModelName("d") + " </uri></include>"
+      "</model>"
+      "<include><uri>model://missing_" + suffix + "</uri></include>"
+      "<include><uri>file://media/materials</uri></include>"
+      "</world></sdf>";
+
+  auto futures = modelDB->PrefetchIncludes(world);
+  ASSERT_EQ(3u, futures.size());
+
+  // Includes are found at any depth
+  auto a = futures.find("model://" + ModelName("a"));
+  auto d = futures.find("model://" + ModelName("d"));
+  auto missing = futures.find("model://missing_" + suffix);
+  ASSERT_TRUE(a != futures.end());
+  ASSERT_TRUE(d != futures.end());
+  ASSERT_TRUE(missing != futures.end());
+
+  EXPECT_EQ(InstallPath("a"), a->second.get());
+  EXPECT_EQ(InstallPath("d"), d->second.get());
+  EXPECT_EQ("", missing->second.get());
+
+  // Dependencies, including circular ones, are downloaded with the model
+  EXPECT_TRUE(boost::filesystem::exists(InstallPath("a") + "/model.sdf"));
+  EXPECT_TRUE(boost::filesystem::exists(InstallPath("b") + "/model.sdf"));
+  EXPECT_TRUE(boost::filesystem::exists(InstallPath("c") + "/model.sdf"));
+
+  // Installed models don't need a download anymore
+  auto installed = modelDB->PrefetchModel("model://" + ModelName("b"));
+  EXPECT_EQ(std::future_status::ready,
+      installed.wait_for(std::chrono::seconds(0)));
+  EXPECT_EQ(InstallPath("b"), installed.get());
+  EXPECT_EQ(InstallPath("c") + "/model.sdf",
+      modelDB->GetModelFile("model://" + ModelName("c")));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ModelDatabaseTest, SharedDownload)
+{
+  auto modelDB = common::ModelDatabase::Instance();
+  std::string uri = "model://" + ModelName("e");
+
+  // Requests for the same model share a single download, and the blocking
+  // API waits for it
+  auto first = modelDB->PrefetchModel(uri);
+  auto second = modelDB->PrefetchModel(uri + "/model.sdf");
+  std::string path = modelDB->GetModelPath(uri, true);
+
+  EXPECT_EQ(InstallPath("e"), first.get());
+  EXPECT_EQ(InstallPath("e"), second.get());
+  EXPECT_EQ(InstallPath("e"), path);
+
+  modelDB->WaitForDownload(uri);
+  EXPECT_TRUE(boost::filesystem::exists(InstallPath("e") + "/model.sdf"));
+}
+#endif
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -315,6 +315,10 @@ std::string SystemPaths::FindFileURI(const std::string &_uri)
   // paths
   if (prefix == "model")
   {
+    // Don't pick up a model that is being extracted by a background
+    // download.
+    ModelDatabase::Instance()->WaitForDownload(_uri);
+
     boost::filesystem::path path;
     for (std::list<std::string>::iterator iter = this->modelPaths.begin();
          iter != this->modelPaths.end(); ++iter)
@@ -0,0 +1,843 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/TriangleBvh.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Leaves with this many triangles or less aren't split.
+static const unsigned int LeafSize = 4;
+
+/// \brief Leaves with more triangles are always split.
+static const unsigned int MaxLeafSize = 16;
+
+/// \brief Number of bins used to find the best split of a node.
+static const unsigned int BinCount = 12;
+
+/// \brief Maximum depth of the hierarchy, which bounds the traversal stack.
+static const unsigned int MaxDepth = 60;
+
+/// \brief Maximum number of rays traversed together.
+static const unsigned int PacketSize = 64;
+
+/// \brief The hierarchy is built again when refitting makes the root box
+/// larger than this factor times its area when it was built.
+static const double RebuildFactor = 4.0;
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \internal
+    /// \brief Node of a TriangleBvh.
+    class TriangleBvhNode
+    {
+      /// \brief Minimum corner of the box around the triangles of the node.
+      public: ignition::math::Vector3d min;
+
+      /// \brief Maximum corner of the box around the triangles of the node.
+      public: ignition::math::Vector3d max;
+
+      /// \brief Index of the first child for inner nodes, the second child
+      /// follows it. Position of the first triangle in order for leaves.
+      public: unsigned int index = 0;
+
+      /// \brief Number of triangles of a leaf, 0 for inner nodes.
+      public: unsigned int count = 0;
+    };
+
+    /// \internal
+    /// \brief Mesh added to a TriangleBvh.
+    class TriangleBvhObject
+    {
+      /// \brief Index of the first triangle.
+      public: unsigned int first = 0;
+
+      /// \brief Number of triangles.
+      public: unsigned int count = 0;
+
+      /// \brief Pose of the mesh.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief True if the pose changed since the triangles were placed.
+      public: bool dirty = false;
+    };
+
+    /// \internal
+    /// \brief Private data for the TriangleBvh class.
+    class TriangleBvhPrivate
+    {
+      /// \brief Place the triangles of an object at its pose.
+      /// \param[in] _object Index of the object.
+      public: void Transform(const unsigned int _object);
+
+      /// \brief Place the triangles of the objects which moved.
+      public: void TransformDirty();
+
+      /// \brief Get the box around triangles.
+      /// \param[in] _first Position of the first triangle in order.
+      /// \param[in] _count Number of triangles.
+      /// \param[out] _min Minimum corner of the box.
+      /// \param[out] _max Maximum corner of the box.
+      public: void Bounds(const unsigned int _first, const unsigned int _count,
+                  ignition::math::Vector3d &_min,
+                  ignition::math::Vector3d &_max) const;
+
+      /// \brief Intersect a ray with a triangle.
+      /// \param[in] _triangle Index of the triangle.
+      /// \param[in] _origin Start of the ray.
+      /// \param[in] _dir Direction of the ray.
+      /// \param[in] _minDist Minimum distance of the hit.
+      /// \param[in] _maxDist Maximum distance of the hit.
+      /// \param[out] _dist Distance of the hit.
+      /// \return True if the triangle was hit.
+      public: bool Hit(const unsigned int _triangle,
+                  const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_dir, const double _minDist,
+                  const double _maxDist, double &_dist) const;
+
+      /// \brief Intersect a packet of at most PacketSize rays.
+      /// \sa TriangleBvh::Intersect
+      public: void IntersectPacket(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d *_dirs,
+                  const unsigned int _count, const double _minDist,
+                  double *_dists, int *_triangles) const;
+
+      /// \brief Objects, by index.
+      public: std::vector<TriangleBvhObject> objects;
+
+      /// \brief Vertices of the triangles in the frame of their object,
+      /// three per triangle.
+      public: std::vector<ignition::math::Vector3d> local;
+
+      /// \brief First vertex of the triangles, in the world frame.
+      public: std::vector<ignition::math::Vector3d> v0;
+
+      /// \brief First edge of the triangles, from v0 to the second vertex.
+      public: std::vector<ignition::math::Vector3d> e1;
+
+      /// \brief Second edge of the triangles, from v0 to the third vertex.
+      public: std::vector<ignition::math::Vector3d> e2;
+
+      /// \brief Object of each triangle.
+      public: std::vector<unsigned int> triangleObject;
+
+      /// \brief Submesh of each triangle.
+      public: std::vector<unsigned int> triangleSubMesh;
+
+      /// \brief Nodes of the hierarchy, parents before their children. Empty
+      /// until the hierarchy is built.
+      public: std::vector<TriangleBvhNode> nodes;
+
+      /// \brief Triangles, ordered by leaf.
+      public: std::vector<unsigned int> order;
+
+      /// \brief Area of the root box when the hierarchy was built.
+      public: double buildArea = 0;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the surface area of a box.
+/// \param[in] _min Minimum corner.
+/// \param[in] _max Maximum corner.
+/// \return Surface area.
+static double area(const ignition::math::Vector3d &_min,
+    const ignition::math::Vector3d &_max)
+{
+  const ignition::math::Vector3d d = _max - _min;
+  return 2.0 * (d.X() * d.Y() + d.Y() * d.Z() + d.Z() * d.X());
+}
+
+/////////////////////////////////////////////////
+/// \brief Intersect a ray with a box.
+/// \param[in] _node Node with the box.
+/// \param[in] _origin Start of the ray.
+/// \param[in] _inv Inverse of the direction of the ray.
+/// \param[in] _minDist Minimum distance.
+/// \param[in] _maxDist Maximum distance.
+/// \param[out] _near Distance at which the ray enters the box.
+/// \return True if the ray hits the box between the distances.
+static inline bool slab(const TriangleBvhNode &_node,
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_inv, double _minDist, double _maxDist,
+    double &_near)
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const double t1 = (_node.min[i] - _origin[i]) * _inv[i];
+    const double t2 = (_node.max[i] - _origin[i]) * _inv[i];
+    _minDist = std::max(_minDist, std::min(t1, t2));
+    _maxDist = std::min(_maxDist, std::max(t1, t2));
+  }
+  _near = _minDist;
+  return _minDist <= _maxDist;
+}
+
+/////////////////////////////////////////////////
+TriangleBvh::TriangleBvh()
+: dataPtr(new TriangleBvhPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+TriangleBvh::~TriangleBvh()
+{
+}
+
+/////////////////////////////////////////////////
+unsigned int TriangleBvh::AddMesh(const Mesh &_mesh,
+    const ignition::math::Vector3d &_scale,
+    const ignition::math::Pose3d &_pose)
+{
+  const unsigned int index = this->dataPtr->objects.size();
+
+  TriangleBvhObject object;
+  object.first = this->dataPtr->triangleObject.size();
+  object.pose = _pose;
+
+  for (unsigned int s = 0; s < _mesh.GetSubMeshCount(); ++s)
+  {
+    const common::SubMesh *subMesh = _mesh.GetSubMesh(s);
+    if (!subMesh || subMesh->GetPrimitiveType() != common::SubMesh::TRIANGLES)
+      continue;
+
+    const unsigned int vertexCount = subMesh->GetVertexCount();
+    const bool indexed = subMesh->GetIndexCount() > 0;
+    const unsigned int count =
+        indexed ? subMesh->GetIndexCount() : vertexCount;
+
+    for (unsigned int i = 0; i + 2 < count; i += 3)
+    {
+      std::array<unsigned int, 3> vertices;
+      bool valid = true;
+      for (unsigned int k = 0; k < 3; ++k)
+      {
+        vertices[k] = indexed ? subMesh->GetIndex(i + k) : i + k;
+        valid = valid && vertices[k] < vertexCount;
+      }
+      if (!valid)
+        continue;
+
+      for (auto const v : vertices)
+        this->dataPtr->local.push_back(subMesh->Vertex(v) * _scale);
+      this->dataPtr->triangleObject.push_back(index);
+      this->dataPtr->triangleSubMesh.push_back(s);
+    }
+  }
+
+  object.count = this->dataPtr->triangleObject.size() - object.first;
+  this->dataPtr->objects.push_back(object);
+
+  const size_t triangleCount = this->dataPtr->triangleObject.size();
+  this->dataPtr->v0.resize(triangleCount);
+  this->dataPtr->e1.resize(triangleCount);
+  this->dataPtr->e2.resize(triangleCount);
+  this->dataPtr->Transform(index);
+
+  // The hierarchy needs to be built again
+  this->dataPtr->nodes.clear();
+
+  return index;
+}
+
+/////////////////////////////////////////////////
+void TriangleBvh::SetPose(const unsigned int _object,
+    const ignition::math::Pose3d &_pose)
+{
+  if (_object >= this->dataPtr->objects.size())
+    return;
+
+  this->dataPtr->objects[_object].pose = _pose;
+  this->dataPtr->objects[_object].dirty = true;
+}
+
+/////////////////////////////////////////////////
+void TriangleBvh::Build()
+{
+  this->dataPtr->TransformDirty();
+
+  auto &nodes = this->dataPtr->nodes;
+  auto &order = this->dataPtr->order;
+
+  const unsigned int triangleCount = this->dataPtr->triangleObject.size();
+  nodes.clear();
+  order.resize(triangleCount);
+  std::iota(order.begin(), order.end(), 0u);
+  this->dataPtr->buildArea = 0;
+
+  if (triangleCount == 0)
+    return;
+
+  std::vector<ignition::math::Vector3d> centroids(triangleCount);
+  for (unsigned int t = 0; t < triangleCount; ++t)
+  {
+    centroids[t] = this->dataPtr->v0[t] +
+        (this->dataPtr->e1[t] + this->dataPtr->e2[t]) / 3.0;
+  }
+
+  nodes.reserve(2 * triangleCount);
+  TriangleBvhNode root;
+  root.index = 0;
+  root.count = triangleCount;
+  nodes.push_back(root);
+
+  // Nodes to split, with their depth
+  std::vector<std::pair<unsigned int, unsigned int>> stack;
+  stack.push_back(std::make_pair(0u, 0u));
+
+  while (!stack.empty())
+  {
+    const unsigned int n = stack.back().first;
+    const unsigned int depth = stack.back().second;
+    stack.pop_back();
+
+    const unsigned int first = nodes[n].index;
+    const unsigned int count = nodes[n].count;
+    this->dataPtr->Bounds(first, count, nodes[n].min, nodes[n].max);
+
+    if (count <= LeafSize || depth >= MaxDepth)
+      continue;
+
+    // Split along the longest axis of the box around the centroids
+    ignition::math::Vector3d cmin(ignition::math::MAX_D, ignition::math::MAX_D,
+        ignition::math::MAX_D);
+    ignition::math::Vector3d cmax(ignition::math::LOW_D, ignition::math::LOW_D,
+        ignition::math::LOW_D);
+    for (unsigned int i = first; i < first + count; ++i)
+    {
+      cmin.Min(centroids[order[i]]);
+      cmax.Max(centroids[order[i]]);
+    }
+
+    const ignition::math::Vector3d extent = cmax - cmin;
+    unsigned int axis = 0;
+    if (extent.Y() > extent[axis])
+      axis = 1;
+    if (extent.Z() > extent[axis])
+      axis = 2;
+
+    unsigned int mid = first;
+    if (extent[axis] > 0)
+    {
+      // Find the split with the lowest surface area heuristic cost among
+      // evenly spaced bins
+      const double scale = BinCount / extent[axis];
+      auto bin = [&](const unsigned int _t)
+      {
+        return std::min(BinCount - 1, static_cast<unsigned int>(
+            (centroids[_t][axis] - cmin[axis]) * scale));
+      };
+
+      std::array<unsigned int, BinCount> binCounts;
+      std::array<ignition::math::Vector3d, BinCount> binMin;
+      std::array<ignition::math::Vector3d, BinCount> binMax;
+      binCounts.fill(0);
+      binMin.fill(ignition::math::Vector3d(ignition::math::MAX_D,
+          ignition::math::MAX_D, ignition::math::MAX_D));
+      binMax.fill(ignition::math::Vector3d(ignition::math::LOW_D,
+          ignition::math::LOW_D, ignition::math::LOW_D));
+
+      for (unsigned int i = first; i < first + count; ++i)
+      {
+        const unsigned int t = order[i];
+        const unsigned int b = bin(t);
+        ++binCounts[b];
+        ignition::math::Vector3d tmin, tmax;
+        this->dataPtr->Bounds(i, 1, tmin, tmax);
+        binMin[b].Min(tmin);
+        binMax[b].Max(tmax);
+      }
+
+      // Area and count on the right of each split
+      std::array<double, BinCount> rightArea;
+      std::array<unsigned int, BinCount> rightCount;
+      ignition::math::Vector3d rmin = binMin[BinCount - 1];
+      ignition::math::Vector3d rmax = binMax[BinCount - 1];
+      unsigned int rcount = binCounts[BinCount - 1];
+      for (unsigned int b = BinCount - 1; b > 0; --b)
+      {
+        rmin.Min(binMin[b]);
+        rmax.Max(binMax[b]);
+        rcount += b < BinCount - 1 ? binCounts[b] : 0;
+        rightArea[b] = rcount > 0 ? area(rmin, rmax) : 0;
+        rightCount[b] = rcount;
+      }
+
+      double bestCost = ignition::math::MAX_D;
+      unsigned int bestSplit = 0;
+      ignition::math::Vector3d lmin = binMin[0];
+      ignition::math::Vector3d lmax = binMax[0];
+      unsigned int lcount = 0;
+      for (unsigned int b = 1; b < BinCount; ++b)
+      {
+        lcount += binCounts[b - 1];
+        lmin.Min(binMin[b - 1]);
+        lmax.Max(binMax[b - 1]);
+        if (lcount == 0 || rightCount[b] == 0)
+          continue;
+
+        const double cost = area(lmin, lmax) * lcount +
+            rightArea[b] * rightCount[b];
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestSplit = b;
+        }
+      }
+
+      // Splitting costs one box test more than testing the triangles
+      const double nodeArea = area(nodes[n].min, nodes[n].max);
+      const bool split = bestSplit > 0 && (count > MaxLeafSize ||
+          (nodeArea > 0 && 1.0 + bestCost / nodeArea < count));
+      if (!split && count <= MaxLeafSize)
+        continue;
+
+      if (bestSplit > 0)
+      {
+        mid = std::partition(order.begin() + first,
+            order.begin() + first + count,
+            [&](const unsigned int _t) {return bin(_t) < bestSplit;}) -
+            order.begin();
+      }
+    }
+    else if (count <= MaxLeafSize)
+    {
+      continue;
+    }
+
+    // Fall back to a median split when the bins don't separate the
+    // triangles
+    if (mid == first || mid == first + count)
+    {
+      mid = first + count / 2;
+      std::nth_element(order.begin() + first, order.begin() + mid,
+          order.begin() + first + count,
+          [&](const unsigned int _a, const unsigned int _b)
+          {
+            return centroids[_a][axis] < centroids[_b][axis];
+          });
+    }
+
+    const unsigned int left = nodes.size();
+    TriangleBvhNode child;
+    child.index = first;
+    child.count = mid - first;
+    nodes.push_back(child);
+    child.index = mid;
+    child.count = first + count - mid;
+    nodes.push_back(child);
+
+    nodes[n].index = left;
+    nodes[n].count = 0;
+
+    stack.push_back(std::make_pair(left, depth + 1));
+    stack.push_back(std::make_pair(left + 1, depth + 1));
+  }
+
+  this->dataPtr->buildArea = area(nodes[0].min, nodes[0].max);
+}
+
+/////////////////////////////////////////////////
+void TriangleBvh::Refit()
+{
+  auto &nodes = this->dataPtr->nodes;
+  if (nodes.empty())
+  {
+    this->Build();
+    return;
+  }
+
+  this->dataPtr->TransformDirty();
+
+  // Children follow their parents
+  for (size_t i = nodes.size(); i-- > 0;)
+  {
+    TriangleBvhNode &node = nodes[i];
+    if (node.count > 0)
+    {
+      this->dataPtr->Bounds(node.index, node.count, node.min, node.max);
+    }
+    else
+    {
+      node.min = nodes[node.index].min;
+      node.min.Min(nodes[node.index + 1].min);
+      node.max = nodes[node.index].max;
+      node.max.Max(nodes[node.index + 1].max);
+    }
+  }
+
+  // The objects moved too far apart for the hierarchy to be efficient
+  if (area(nodes[0].min, nodes[0].max) >
+      RebuildFactor * this->dataPtr->buildArea)
+  {
+    this->Build();
+  }
+}
+
+/////////////////////////////////////////////////
+void TriangleBvh::Clear()
+{
+  this->dataPtr->objects.clear();
+  this->dataPtr->local.clear();
+  this->dataPtr->v0.clear();
+  this->dataPtr->e1.clear();
+  this->dataPtr->e2.clear();
+  this->dataPtr->triangleObject.clear();
+  this->dataPtr->triangleSubMesh.clear();
+  this->dataPtr->nodes.clear();
+  this->dataPtr->order.clear();
+  this->dataPtr->buildArea = 0;
+}
+
+/////////////////////////////////////////////////
+unsigned int TriangleBvh::ObjectCount() const
+{
+  return this->dataPtr->objects.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int TriangleBvh::TriangleCount() const
+{
+  return this->dataPtr->triangleObject.size();
+}
+
+/////////////////////////////////////////////////
+ignition::math::AxisAlignedBox TriangleBvh::Box() const
+{
+  if (this->dataPtr->nodes.empty())
+  {
+    if (this->dataPtr->v0.empty())
+      return ignition::math::AxisAlignedBox();
+
+    ignition::math::AxisAlignedBox box;
+    for (size_t t = 0; t < this->dataPtr->v0.size(); ++t)
+    {
+      const ignition::math::Vector3d &a = this->dataPtr->v0[t];
+      box.Merge(ignition::math::AxisAlignedBox(a, a + this->dataPtr->e1[t]));
+      box.Merge(ignition::math::AxisAlignedBox(a, a + this->dataPtr->e2[t]));
+    }
+    return box;
+  }
+
+  return ignition::math::AxisAlignedBox(this->dataPtr->nodes[0].min,
+      this->dataPtr->nodes[0].max);
+}
+
+/////////////////////////////////////////////////
+bool TriangleBvh::Intersect(const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, const double _minDist,
+    double &_dist, int &_triangle) const
+{
+  auto const &nodes = this->dataPtr->nodes;
+  if (nodes.empty())
+    return false;
+
+  const ignition::math::Vector3d inv(1.0 / _dir.X(), 1.0 / _dir.Y(),
+      1.0 / _dir.Z());
+
+  std::array<unsigned int, MaxDepth + 2> stack;
+  unsigned int top = 0;
+  stack[top++] = 0;
+
+  bool hit = false;
+  double near;
+  while (top > 0)
+  {
+    const TriangleBvhNode &node = nodes[stack[--top]];
+    if (!slab(node, _origin, inv, _minDist, _dist, near))
+      continue;
+
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.index; i < node.index + node.count; ++i)
+      {
+        const unsigned int t = this->dataPtr->order[i];
+        double dist;
+        if (this->dataPtr->Hit(t, _origin, _dir, _minDist, _dist, dist))
+        {
+          _dist = dist;
+          _triangle = t;
+          hit = true;
+        }
+      }
+      continue;
+    }
+
+    // Visit the nearest child first, so that the other can be skipped
+    double nearLeft;
+    double nearRight;
+    const bool left = slab(nodes[node.index], _origin, inv, _minDist, _dist,
+        nearLeft);
+    const bool right = slab(nodes[node.index + 1], _origin, inv, _minDist,
+        _dist, nearRight);
+    if (left && right)
+    {
+      if (nearLeft < nearRight)
+      {
+        stack[top++] = node.index + 1;
+        stack[top++] = node.index;
+      }
+      else
+      {
+        stack[top++] = node.index;
+        stack[top++] = node.index + 1;
+      }
+    }
+    else if (left)
+    {
+      stack[top++] = node.index;
+    }
+    else if (right)
+    {
+      stack[top++] = node.index + 1;
+    }
+  }
+
+  return hit;
+}
+
+/////////////////////////////////////////////////
+void TriangleBvh::Intersect(const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d *_dirs, const unsigned int _count,
+    const double _minDist, double *_dists, int *_triangles) const
+{
+  for (unsigned int first = 0; first < _count; first += PacketSize)
+  {
+    this->dataPtr->IntersectPacket(_origin, _dirs + first,
+        std::min(PacketSize, _count - first), _minDist, _dists + first,
+        _triangles + first);
+  }
+}
+
+/////////////////////////////////////////////////
+ignition::math::Vector3d TriangleBvh::Normal(const int _triangle) const
+{
+  if (_triangle < 0 ||
+      static_cast<size_t>(_triangle) >= this->dataPtr->e1.size())
+  {
+    return ignition::math::Vector3d::Zero;
+  }
+
+  ignition::math::Vector3d normal =
+      this->dataPtr->e1[_triangle].Cross(this->dataPtr->e2[_triangle]);
+  normal.Normalize();
+  return normal;
+}
+
+/////////////////////////////////////////////////
+unsigned int TriangleBvh::Object(const int _triangle) const
+{
+  if (_triangle < 0 ||
+      static_cast<size_t>(_triangle) >= this->dataPtr->triangleObject.size())
+  {
+    return 0;
+  }
+  return this->dataPtr->triangleObject[_triangle];
+}
+
+/////////////////////////////////////////////////
+unsigned int TriangleBvh::SubMesh(const int _triangle) const
+{
+  if (_triangle < 0 ||
+      static_cast<size_t>(_triangle) >= this->dataPtr->triangleSubMesh.size())
+  {
+    return 0;
+  }
+  return this->dataPtr->triangleSubMesh[_triangle];
+}
+
+/////////////////////////////////////////////////
+void TriangleBvhPrivate::Transform(const unsigned int _object)
+{
+  TriangleBvhObject &object = this->objects[_object];
+  for (unsigned int t = object.first; t < object.first + object.count; ++t)
+  {
+    const ignition::math::Vector3d a =
+        object.pose.CoordPositionAdd(this->local[3 * t]);
+    this->v0[t] = a;
+    this->e1[t] = object.pose.CoordPositionAdd(this->local[3 * t + 1]) - a;
+    this->e2[t] = object.pose.CoordPositionAdd(this->local[3 * t + 2]) - a;
+  }
+  object.dirty = false;
+}
+
+/////////////////////////////////////////////////
+void TriangleBvhPrivate::TransformDirty()
+{
+  for (unsigned int i = 0; i < this->objects.size(); ++i)
+  {
+    if (this->objects[i].dirty)
+      this->Transform(i);
+  }
+}
+
+/////////////////////////////////////////////////
+void TriangleBvhPrivate::Bounds(const unsigned int _first,
+    const unsigned int _count, ignition::math::Vector3d &_min,
+    ignition::math::Vector3d &_max) const
+{
+  _min.Set(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  _max.Set(ignition::math::LOW_D, ignition::math::LOW_D,
+      ignition::math::LOW_D);
+  for (unsigned int i = _first; i < _first + _count; ++i)
+  {
+    const unsigned int t = this->order[i];
+    const ignition::math::Vector3d &a = this->v0[t];
+    const ignition::math::Vector3d b = a + this->e1[t];
+    const ignition::math::Vector3d c = a + this->e2[t];
+    _min.Min(a);
+    _min.Min(b);
+    _min.Min(c);
+    _max.Max(a);
+    _max.Max(b);
+    _max.Max(c);
+  }
+}
+
+/////////////////////////////////////////////////
+bool TriangleBvhPrivate::Hit(const unsigned int _triangle,
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, const double _minDist,
+    const double _maxDist, double &_dist) const
+{
+  // Moller-Trumbore, without culling back faces
+  const ignition::math::Vector3d &e1 = this->e1[_triangle];
+  const ignition::math::Vector3d &e2 = this->e2[_triangle];
+
+  const ignition::math::Vector3d p = _dir.Cross(e2);
+  const double det = e1.Dot(p);
+  if (std::abs(det) < 1e-14)
+    return false;
+
+  const double inv = 1.0 / det;
+  const ignition::math::Vector3d s = _origin - this->v0[_triangle];
+  const double u = s.Dot(p) * inv;
+  if (u < 0.0 || u > 1.0)
+    return false;
+
+  const ignition::math::Vector3d q = s.Cross(e1);
+  const double v = _dir.Dot(q) * inv;
+  if (v < 0.0 || u + v > 1.0)
+    return false;
+
+  const double t = e2.Dot(q) * inv;
+  if (t < _minDist || t >= _maxDist)
+    return false;
+
+  _dist = t;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TriangleBvhPrivate::IntersectPacket(
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d *_dirs, const unsigned int _count,
+    const double _minDist, double *_dists, int *_triangles) const
+{
+  for (unsigned int r = 0; r < _count; ++r)
+    _triangles[r] = -1;
+
+  if (this->nodes.empty())
+    return;
+
+  // Inverse directions, laid out by axis so that the box tests of the whole
+  // packet can be vectorized
+  std::array<std::array<double, PacketSize>, 3> inv;
+  std::array<std::array<double, PacketSize>, 3> origin;
+  for (unsigned int r = 0; r < _count; ++r)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      inv[i][r] = 1.0 / _dirs[r][i];
+      origin[i][r] = _origin[i];
+    }
+  }
+
+  std::array<unsigned int, MaxDepth + 2> stack;
+  unsigned int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const TriangleBvhNode &node = this->nodes[stack[--top]];
+
+    // Visit the node if any ray of the packet hits its box
+    bool visit = false;
+    for (unsigned int r = 0; r < _count && !visit; ++r)
+    {
+      double tmin = _minDist;
+      double tmax = _dists[r];
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        const double t1 = (node.min[i] - origin[i][r]) * inv[i][r];
+        const double t2 = (node.max[i] - origin[i][r]) * inv[i][r];
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+      }
+      visit = tmin <= tmax;
+    }
+
+    if (!visit)
+      continue;
+
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.index; i < node.index + node.count; ++i)
+      {
+        const unsigned int t = this->order[i];
+        for (unsigned int r = 0; r < _count; ++r)
+        {
+          double dist;
+          if (this->Hit(t, _origin, _dirs[r], _minDist, _dists[r], dist))
+          {
+            _dists[r] = dist;
+            _triangles[r] = t;
+          }
+        }
+      }
+      continue;
+    }
+
+    // Visit first the child on the side the packet comes from
+    const TriangleBvhNode &left = this->nodes[node.index];
+    const TriangleBvhNode &right = this->nodes[node.index + 1];
+    const ignition::math::Vector3d between =
+        (right.min + right.max) - (left.min + left.max);
+    if (between.Dot(_dirs[0]) > 0)
+    {
+      stack[top++] = node.index + 1;
+      stack[top++] = node.index;
+    }
+    else
+    {
+      stack[top++] = node.index;
+      stack[top++] = node.index + 1;
+    }
+  }
+}
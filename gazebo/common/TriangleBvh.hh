@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_TRIANGLEBVH_HH_
+#define GAZEBO_COMMON_TRIANGLEBVH_HH_
+
+#include <memory>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class.
+    class TriangleBvhPrivate;
+    class Mesh;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class TriangleBvh TriangleBvh.hh common/common.hh
+    /// \brief A bounding volume hierarchy over the triangles of a set of
+    /// meshes, used to cast rays on the CPU.
+    ///
+    /// Each mesh added is an object with its own pose. Moving objects only
+    /// requires the boxes of the hierarchy to be refit, which is much
+    /// cheaper than building it again.
+    class GZ_COMMON_VISIBLE TriangleBvh
+    {
+      /// \brief Constructor.
+      public: TriangleBvh();
+
+      /// \brief Destructor.
+      public: virtual ~TriangleBvh();
+
+      /// \brief Add the triangles of a mesh. Only the triangle lists of the
+      /// mesh are used. Build must be called before casting rays.
+      /// \param[in] _mesh Mesh.
+      /// \param[in] _scale Scale applied to the vertices of the mesh.
+      /// \param[in] _pose Pose of the mesh.
+      /// \return Index of the new object.
+      public: unsigned int AddMesh(const Mesh &_mesh,
+                  const ignition::math::Vector3d &_scale,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Set the pose of an object. Refit must be called before
+      /// casting rays.
+      /// \param[in] _object Index of the object.
+      /// \param[in] _pose New pose.
+      public: void SetPose(const unsigned int _object,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Build the hierarchy.
+      public: void Build();
+
+      /// \brief Update the hierarchy after objects moved. The hierarchy is
+      /// built again if the boxes grew too large.
+      public: void Refit();
+
+      /// \brief Remove all the objects.
+      public: void Clear();
+
+      /// \brief Get the number of objects.
+      /// \return Number of objects.
+      public: unsigned int ObjectCount() const;
+
+      /// \brief Get the number of triangles.
+      /// \return Number of triangles.
+      public: unsigned int TriangleCount() const;
+
+      /// \brief Get the box around all the triangles.
+      /// \return Bounding box, which is empty if there are no triangles.
+      public: ignition::math::AxisAlignedBox Box() const;
+
+      /// \brief Find the closest triangle hit by a ray. Distances are
+      /// multiples of the direction, which doesn't need to be normalized.
+      /// \param[in] _origin Start of the ray.
+      /// \param[in] _dir Direction of the ray.
+      /// \param[in] _minDist Minimum distance of the hit.
+      /// \param[in,out] _dist Maximum distance of the hit, set to the distance
+      /// of the hit.
+      /// \param[out] _triangle Index of the triangle hit.
+      /// \return True if a triangle was hit.
+      public: bool Intersect(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_dir, const double _minDist,
+                  double &_dist, int &_triangle) const;
+
+      /// \brief Find the closest triangles hit by a packet of rays starting
+      /// at the same point. The packet is traversed together, which is faster
+      /// than casting the rays one at a time when they point in similar
+      /// directions.
+      /// \param[in] _origin Start of the rays.
+      /// \param[in] _dirs Directions of the rays.
+      /// \param[in] _count Number of rays.
+      /// \param[in] _minDist Minimum distance of the hits.
+      /// \param[in,out] _dists Maximum distance of each hit, set to the
+      /// distance of the hits.
+      /// \param[out] _triangles Index of the triangle hit by each ray, -1 if
+      /// none was hit.
+      public: void Intersect(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d *_dirs,
+                  const unsigned int _count, const double _minDist,
+                  double *_dists, int *_triangles) const;
+
+      /// \brief Get the normal of a triangle, in the world frame.
+      /// \param[in] _triangle Index of the triangle.
+      /// \return Unit normal, following the winding of the triangle.
+      public: ignition::math::Vector3d Normal(const int _triangle) const;
+
+      /// \brief Get the object a triangle belongs to.
+      /// \param[in] _triangle Index of the triangle.
+      /// \return Index of the object.
+      public: unsigned int Object(const int _triangle) const;
+
+      /// \brief Get the submesh of its object a triangle belongs to.
+      /// \param[in] _triangle Index of the triangle.
+      /// \return Index of the submesh.
+      public: unsigned int SubMesh(const int _triangle) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<TriangleBvhPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
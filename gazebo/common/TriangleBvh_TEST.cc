@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/TriangleBvh.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace common;
+
+class TriangleBvhTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(TriangleBvhTest, Boxes)
+{
+  const Mesh *box = MeshManager::Instance()->GetMesh("unit_box");
+  ASSERT_TRUE(box != nullptr);
+
+  TriangleBvh bvh;
+  EXPECT_EQ(0u, bvh.TriangleCount());
+
+  double dist = 100;
+  int triangle = -1;
+  EXPECT_FALSE(bvh.Intersect(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::UnitX, 0, dist, triangle));
+
+  // A 2x2x2 box 5 m in front of the origin, and a 1 m box behind it
+  EXPECT_EQ(0u, bvh.AddMesh(*box, ignition::math::Vector3d(2, 2, 2),
+      ignition::math::Pose3d(5, 0, 0, 0, 0, 0)));
+  EXPECT_EQ(1u, bvh.AddMesh(*box, ignition::math::Vector3d::One,
+      ignition::math::Pose3d(10, 0, 0, 0, 0, 0)));
+  bvh.Build();
+  EXPECT_EQ(2u, bvh.ObjectCount());
+  EXPECT_EQ(24u, bvh.TriangleCount());
+
+  ignition::math::AxisAlignedBox bounds = bvh.Box();
+  EXPECT_EQ(ignition::math::Vector3d(4, -1, -1), bounds.Min());
+  EXPECT_EQ(ignition::math::Vector3d(10.5, 1, 1), bounds.Max());
+
+  dist = 100;
+  EXPECT_TRUE(bvh.Intersect(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::UnitX, 0, dist, triangle));
+  EXPECT_NEAR(4.0, dist, 1e-9);
+  EXPECT_EQ(0u, bvh.Object(triangle));
+  EXPECT_EQ(0u, bvh.SubMesh(triangle));
+  EXPECT_NEAR(1.0, std::abs(bvh.Normal(triangle).X()), 1e-9);
+
+  // Distances are in multiples of the direction
+  dist = 100;
+  EXPECT_TRUE(bvh.Intersect(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d(2, 0, 0), 0, dist, triangle));
+  EXPECT_NEAR(2.0, dist, 1e-9);
+
+  // Hits closer than the minimum distance or further than the maximum are
+  // ignored
+  dist = 100;
+  EXPECT_TRUE(bvh.Intersect(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::UnitX, 7, dist, triangle));
+  EXPECT_NEAR(9.5, dist, 1e-9);
+  EXPECT_EQ(1u, bvh.Object(triangle));
+
+  dist = 3;
+  EXPECT_FALSE(bvh.Intersect(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::UnitX, 0, dist, triangle));
+
+  // Move the first box out of the way
+  bvh.SetPose(0, ignition::math::Pose3d(5, 5, 0, 0, 0, 0));
+  bvh.Refit();
+  dist = 100;
+  EXPECT_TRUE(bvh.Intersect(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::UnitX, 0, dist, triangle));
+  EXPECT_NEAR(9.5, dist, 1e-9);
+
+  bvh.Clear();
+  EXPECT_EQ(0u, bvh.ObjectCount());
+  EXPECT_EQ(0u, bvh.TriangleCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TriangleBvhTest, Packets)
+{
+  ignition::math::Rand::Seed(42);
+
+  const Mesh *sphere = MeshManager::Instance()->GetMesh("unit_sphere");
+  ASSERT_TRUE(sphere != nullptr);
+
+  // Spheres scattered around the origin
+  TriangleBvh bvh;
+  for (unsigned int i = 0; i < 50; ++i)
+  {
+    bvh.AddMesh(*sphere, ignition::math::Vector3d::One *
+        ignition::math::Rand::DblUniform(0.5, 3),
+        ignition::math::Pose3d(ignition::math::Rand::DblUniform(-20, 20),
+        ignition::math::Rand::DblUniform(-20, 20),
+        ignition::math::Rand::DblUniform(-2, 2), 0, 0, 0));
+  }
+  bvh.Build();
+
+  for (unsigned int frame = 0; frame < 3; ++frame)
+  {
+    // A packet of rays gives the same hits as single rays
+    std::vector<ignition::math::Vector3d> dirs;
+    for (unsigned int i = 0; i < 500; ++i)
+    {
+      dirs.push_back(ignition::math::Vector3d(
+          ignition::math::Rand::DblUniform(-1, 1),
+          ignition::math::Rand::DblUniform(-1, 1),
+          ignition::math::Rand::DblUniform(-0.1, 0.1)));
+    }
+
+    std::vector<double> dists(dirs.size(), 100);
+    std::vector<int> triangles(dirs.size());
+    bvh.Intersect(ignition::math::Vector3d::Zero, dirs.data(), dirs.size(),
+        0, dists.data(), triangles.data());
+
+    unsigned int hits = 0;
+    for (unsigned int i = 0; i < dirs.size(); ++i)
+    {
+      double dist = 100;
+      int triangle = -1;
+      const bool hit = bvh.Intersect(ignition::math::Vector3d::Zero, dirs[i],
+          0, dist, triangle);
+      EXPECT_EQ(hit, triangles[i] >= 0);
+      if (hit)
+      {
+        ++hits;
+        EXPECT_NEAR(dist, dists[i], 1e-9);
+        EXPECT_EQ(triangle, triangles[i]);
+      }
+    }
+    EXPECT_GT(hits, 0u);
+
+    // Move the spheres
+    for (unsigned int i = 0; i < bvh.ObjectCount(); ++i)
+    {
+      bvh.SetPose(i, ignition::math::Pose3d(
+          ignition::math::Rand::DblUniform(-20, 20),
+          ignition::math::Rand::DblUniform(-20, 20),
+          ignition::math::Rand::DblUniform(-2, 2), 0, 0, 0));
+    }
+    bvh.Refit();
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
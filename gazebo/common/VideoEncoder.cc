@@ -14,8 +14,12 @@
  * limitations under the License.
  *
 */
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
 #include <stdio.h>
+#include <vector>
 #include <gazebo/gazebo_config.h>
 
 #include <sys/types.h>
@@ -49,6 +53,7 @@ extern "C"
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/FrameWriter.hh"
 #include "gazebo/common/VideoEncoder.hh"
 
 using namespace gazebo;
@@ -115,6 +120,37 @@ class gazebo::common::VideoEncoderPrivate
 
   /// \brief Mutex for thread safety.
   public: std::mutex mutex;
+
+  /// \brief Frame writer encoding the frames, null to encode them in
+  /// AddFrame.
+  public: FrameWriterPtr writer;
+
+  /// \brief A frame queued for the frame writer.
+  public: struct QueuedFrame
+          {
+            /// \brief RGB pixels.
+            std::vector<unsigned char> data;
+
+            /// \brief Width in pixels.
+            unsigned int width;
+
+            /// \brief Height in pixels.
+            unsigned int height;
+          };
+
+  /// \brief Frames queued for the frame writer, in order. Each queued job
+  /// encodes the oldest frame, so that the frames stay in order however
+  /// many threads the writer has.
+  public: std::deque<QueuedFrame> queuedFrames;
+
+  /// \brief Protects queuedFrames.
+  public: std::mutex queueMutex;
+
+  /// \brief Serializes the calls queuing frames.
+  public: std::mutex addMutex;
+
+  /// \brief Signaled when the last queued frame is encoded.
+  public: std::condition_variable queueEmpty;
 };
 
 /////////////////////////////////////////////////
@@ -538,22 +574,54 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
     const unsigned int _height,
     const std::chrono::steady_clock::time_point &_timestamp)
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
-  if (!this->dataPtr->encoding)
+  FrameWriterPtr writer;
   {
-    gzerr << "Start encoding before adding a frame\n";
-    return false;
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+    if (!this->dataPtr->encoding)
+    {
+      gzerr << "Start encoding before adding a frame\n";
+      return false;
+    }
+
+    auto dt = _timestamp - this->dataPtr->timePrev;
+
+    // Skip frames that arrive faster than the video's fps
+    if (dt < std::chrono::duration<double>(1.0/this->dataPtr->fps))
+      return false;
+
+    this->dataPtr->timePrev = _timestamp;
+
+    if (!this->dataPtr->writer)
+      return this->EncodeFrame(_frame, _width, _height);
+    writer = this->dataPtr->writer;
   }
 
-  auto dt = _timestamp - this->dataPtr->timePrev;
+  // Queue a copy of the frame, and a job encoding the oldest queued frame
+  std::lock_guard<std::mutex> addLock(this->dataPtr->addMutex);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->queueMutex);
+    this->dataPtr->queuedFrames.push_back({std::vector<unsigned char>(
+        _frame, _frame + _width * _height * 3), _width, _height});
+  }
 
-  // Skip frames that arrive faster than the video's fps
-  if (dt < std::chrono::duration<double>(1.0/this->dataPtr->fps))
-    return false;
+  if (writer->Push(std::bind(&VideoEncoder::EncodeQueuedFrame, this)))
+    return true;
 
-  this->dataPtr->timePrev = _timestamp;
+  // No job will encode the frame. Jobs only encode frames queued before
+  // theirs, so the frame is still the newest one.
+  std::lock_guard<std::mutex> lock(this->dataPtr->queueMutex);
+  this->dataPtr->queuedFrames.pop_back();
+  if (this->dataPtr->queuedFrames.empty())
+    this->dataPtr->queueEmpty.notify_all();
+  return false;
+}
 
+/////////////////////////////////////////////////
+bool VideoEncoder::EncodeFrame(const unsigned char *_frame,
+    const unsigned int _width,
+    const unsigned int _height)
+{
   // Cause the sws to be recreated on image resize
   if (this->dataPtr->swsCtx &&
       (this->dataPtr->inWidth != _width || this->dataPtr->inHeight != _height))
@@ -724,11 +792,65 @@ bool VideoEncoder::AddFrame(const unsigned char */*_frame*/,
       << std::endl;
   return false;
 }
+
+/////////////////////////////////////////////////
+bool VideoEncoder::EncodeFrame(const unsigned char */*_frame*/,
+    const unsigned int /*_width*/,
+    const unsigned int /*_height*/)
+{
+  return false;
+}
 #endif
 
+/////////////////////////////////////////////////
+void VideoEncoder::SetFrameWriter(FrameWriterPtr _writer)
+{
+  // Frames queued for the previous writer are encoded first
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->queueMutex);
+    while (!this->dataPtr->queuedFrames.empty())
+      this->dataPtr->queueEmpty.wait(lock);
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->writer = _writer;
+}
+
+/////////////////////////////////////////////////
+void VideoEncoder::EncodeQueuedFrame()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  VideoEncoderPrivate::QueuedFrame frame;
+  {
+    std::lock_guard<std::mutex> queueLock(this->dataPtr->queueMutex);
+    if (this->dataPtr->queuedFrames.empty())
+      return;
+    frame = std::move(this->dataPtr->queuedFrames.front());
+    this->dataPtr->queuedFrames.pop_front();
+  }
+
+  if (this->dataPtr->encoding)
+    this->EncodeFrame(frame.data.data(), frame.width, frame.height);
+
+  // Notify while the encoder is locked, so that it isn't destroyed before
+  std::lock_guard<std::mutex> queueLock(this->dataPtr->queueMutex);
+  if (this->dataPtr->queuedFrames.empty())
+    this->dataPtr->queueEmpty.notify_all();
+}
+
 /////////////////////////////////////////////////
 bool VideoEncoder::Stop()
 {
+  // Encode the frames queued for the frame writer first
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->queueMutex);
+    while (!this->dataPtr->queuedFrames.empty())
+      this->dataPtr->queueEmpty.wait(lock);
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
 #ifdef HAVE_FFMPEG
   if (this->dataPtr->encoding && this->dataPtr->formatCtx)
     av_write_trailer(this->dataPtr->formatCtx);
@@ -20,6 +20,7 @@
 #include <chrono>
 #include <string>
 #include <memory>
+#include <gazebo/common/CommonTypes.hh>
 #include <gazebo/util/system.hh>
 
 // Default bitrate (0) indicates that a bitrate should be calculated when
@@ -105,6 +106,12 @@ namespace gazebo
                   const unsigned int _height,
                   const std::chrono::steady_clock::time_point &_timestamp);
 
+      /// \brief Encode the frames on the worker threads of a frame writer,
+      /// in order, instead of in AddFrame. AddFrame then only copies the
+      /// frame, and returns false if the writer drops it.
+      /// \param[in] _writer Frame writer, null to encode in AddFrame.
+      public: void SetFrameWriter(FrameWriterPtr _writer);
+
       /// \brief Write the video to disk
       /// param[in] _filename File in which to save the encoded data
       /// \return True on success.
@@ -122,6 +129,18 @@ namespace gazebo
       /// memory. This will also delete any temporary files.
       public: void Reset();
 
+      /// \brief Scale and encode a frame. The mutex must be locked.
+      /// \param[in] _frame Image buffer to be encoded
+      /// \param[in] _width Input frame width
+      /// \param[in] _height Input frame height
+      /// \return True on success.
+      private: bool EncodeFrame(const unsigned char *_frame,
+                   const unsigned int _width,
+                   const unsigned int _height);
+
+      /// \brief Encode the oldest frame queued for the frame writer.
+      private: void EncodeQueuedFrame();
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<VideoEncoderPrivate> dataPtr;
@@ -15,7 +15,13 @@
 */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
 #include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/FrameWriter.hh"
 #include "gazebo/common/VideoEncoder.hh"
 #include "test/util.hh"
 
@@ -75,3 +81,34 @@ TEST_F(VideoEncoderTest, Exists)
   EXPECT_FALSE(common::exists(common::cwd() + "/TMP_RECORDING.mp4"));
 #endif
 }
+
+/////////////////////////////////////////////////
+TEST_F(VideoEncoderTest, FrameWriter)
+{
+  VideoEncoder video;
+  FrameWriterPtr writer(new FrameWriter(2, 4));
+  video.SetFrameWriter(writer);
+
+#ifdef HAVE_FFMPEG
+  const unsigned int width = 320;
+  const unsigned int height = 240;
+  EXPECT_TRUE(video.Start("mp4", "", width, height));
+
+  // Frames are encoded in order on the writer's threads
+  std::vector<unsigned char> frame(width * height * 3);
+  auto time = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < 20; ++i)
+  {
+    std::fill(frame.begin(), frame.end(), static_cast<unsigned char>(i * 10));
+    time += std::chrono::milliseconds(100);
+    EXPECT_TRUE(video.AddFrame(frame.data(), width, height, time));
+  }
+
+  // Saving waits for the queued frames
+  const std::string filename = common::cwd() + "/frame_writer_video.mp4";
+  EXPECT_TRUE(video.SaveToFile(filename));
+  EXPECT_EQ(0u, writer->Pending());
+  EXPECT_TRUE(common::exists(filename));
+  std::remove(filename.c_str());
+#endif
+}
@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/msgs/PoseStream.hh"
+
+using namespace gazebo;
+using namespace msgs;
+
+/// \brief Scale of the quantized orientation components.
+static const double kOrientationScale = 32767.0;
+
+/////////////////////////////////////////////////
+/// \brief Round a value to the nearest int32.
+/// \param[in] _value Value to round.
+/// \return Rounded value, clamped to the int32 range.
+static int32_t Quantize(const double _value)
+{
+  const double clamped = std::max(
+      static_cast<double>(std::numeric_limits<int32_t>::min()),
+      std::min(static_cast<double>(std::numeric_limits<int32_t>::max()),
+        std::round(_value)));
+  return static_cast<int32_t>(clamped);
+}
+
+/////////////////////////////////////////////////
+PoseStreamEncoder::PoseStreamEncoder()
+{
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::SetEncoding(
+    const msgs::PosesCompact::Encoding _encoding)
+{
+  this->encoding = _encoding;
+  this->Reset();
+}
+
+/////////////////////////////////////////////////
+msgs::PosesCompact::Encoding PoseStreamEncoder::Encoding() const
+{
+  return this->encoding;
+}
+
+/////////////////////////////////////////////////
+bool PoseStreamEncoder::SetResolution(const double _resolution)
+{
+  if (!(_resolution > 0))
+  {
+    gzerr << "Invalid pose stream resolution[" << _resolution << "]\n";
+    return false;
+  }
+
+  this->resolution = _resolution;
+  this->Reset();
+  return true;
+}
+
+/////////////////////////////////////////////////
+double PoseStreamEncoder::Resolution() const
+{
+  return this->resolution;
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::SetKeyframePeriod(const unsigned int _period)
+{
+  this->keyframePeriod = std::max(1u, _period);
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::SetThresholds(const double _position,
+    const double _rotation)
+{
+  this->positionThreshold = std::max(0.0, _position);
+  this->rotationThreshold = std::max(0.0, _rotation);
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::SetThresholds(const uint32_t _id,
+    const double _position, const double _rotation)
+{
+  EntityState &entity = this->entities[_id];
+  entity.hasThresholds = true;
+  entity.positionThreshold = std::max(0.0, _position);
+  entity.rotationThreshold = std::max(0.0, _rotation);
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::Begin(const common::Time &_time,
+    msgs::PosesCompact &_msg)
+{
+  _msg.Clear();
+  msgs::Set(_msg.mutable_time(), _time);
+  _msg.set_encoding(this->encoding);
+  _msg.set_sequence(this->sequence);
+
+  this->keyframe = this->sequence == this->nextKeyframe;
+  if (this->keyframe)
+    this->nextKeyframe = this->sequence + this->keyframePeriod;
+  _msg.set_keyframe(this->keyframe);
+
+  if (this->encoding == msgs::PosesCompact::QUANTIZED)
+    _msg.set_resolution(this->resolution);
+
+  this->msg = &_msg;
+}
+
+/////////////////////////////////////////////////
+bool PoseStreamEncoder::Keyframe() const
+{
+  return this->keyframe;
+}
+
+/////////////////////////////////////////////////
+bool PoseStreamEncoder::Add(const uint32_t _id,
+    const ignition::math::Pose3d &_pose)
+{
+  if (!this->msg)
+  {
+    gzerr << "PoseStreamEncoder::Begin must be called before Add\n";
+    return false;
+  }
+
+  EntityState &entity = this->entities[_id];
+
+  // Skip the entities which didn't move enough since they were last sent
+  if (!this->keyframe && entity.named)
+  {
+    const double positionThreshold = entity.hasThresholds ?
+        entity.positionThreshold : this->positionThreshold;
+    const double rotationThreshold = entity.hasThresholds ?
+        entity.rotationThreshold : this->rotationThreshold;
+
+    const double dot = std::min(1.0,
+        std::abs(entity.pose.Rot().Dot(_pose.Rot())));
+    if (entity.pose.Pos().Distance(_pose.Pos()) <= positionThreshold &&
+        2.0 * std::acos(dot) <= rotationThreshold)
+    {
+      return false;
+    }
+  }
+
+  if (this->encoding == msgs::PosesCompact::QUANTIZED)
+  {
+    const std::array<int32_t, 7> values{{
+        Quantize(_pose.Pos().X() / this->resolution),
+        Quantize(_pose.Pos().Y() / this->resolution),
+        Quantize(_pose.Pos().Z() / this->resolution),
+        Quantize(_pose.Rot().X() * kOrientationScale),
+        Quantize(_pose.Rot().Y() * kOrientationScale),
+        Quantize(_pose.Rot().Z() * kOrientationScale),
+        Quantize(_pose.Rot().W() * kOrientationScale)}};
+
+    // The change is below the resolution
+    if (!this->keyframe && entity.named && values == entity.quantized)
+      return false;
+
+    for (unsigned int i = 0; i < values.size(); ++i)
+    {
+      this->msg->add_quantized(this->keyframe ? values[i] :
+          values[i] - entity.quantized[i]);
+    }
+    entity.quantized = values;
+  }
+  else
+  {
+    this->msg->add_value(static_cast<float>(_pose.Pos().X()));
+    this->msg->add_value(static_cast<float>(_pose.Pos().Y()));
+    this->msg->add_value(static_cast<float>(_pose.Pos().Z()));
+    this->msg->add_value(static_cast<float>(_pose.Rot().X()));
+    this->msg->add_value(static_cast<float>(_pose.Rot().Y()));
+    this->msg->add_value(static_cast<float>(_pose.Rot().Z()));
+    this->msg->add_value(static_cast<float>(_pose.Rot().W()));
+  }
+
+  this->msg->add_id(_id);
+  entity.pose = _pose;
+
+  // Names are sent with the first pose of an entity, and in keyframes
+  const bool needsName = this->keyframe || !entity.named;
+  entity.named = true;
+  return needsName;
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::AddName(const uint32_t _id, const std::string &_name)
+{
+  if (!this->msg)
+    return;
+
+  this->msg->add_name_id(_id);
+  this->msg->add_name(_name);
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::End()
+{
+  this->msg = nullptr;
+  ++this->sequence;
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::Reset()
+{
+  // Keep the thresholds of the entities
+  for (auto iter = this->entities.begin(); iter != this->entities.end();)
+  {
+    if (iter->second.hasThresholds)
+    {
+      const double position = iter->second.positionThreshold;
+      const double rotation = iter->second.rotationThreshold;
+      iter->second = EntityState();
+      iter->second.hasThresholds = true;
+      iter->second.positionThreshold = position;
+      iter->second.rotationThreshold = rotation;
+      ++iter;
+    }
+    else
+    {
+      iter = this->entities.erase(iter);
+    }
+  }
+
+  this->msg = nullptr;
+  this->nextKeyframe = this->sequence;
+}
+
+/////////////////////////////////////////////////
+void PoseStreamEncoder::Remove(const uint32_t _id)
+{
+  this->entities.erase(_id);
+}
+
+/////////////////////////////////////////////////
+bool PoseStreamDecoder::Decode(const msgs::PosesCompact &_msg,
+    const PoseCallback &_callback)
+{
+  for (int i = 0; i < _msg.name_id_size() && i < _msg.name_size(); ++i)
+    this->names[_msg.name_id(i)] = _msg.name(i);
+
+  if (_msg.encoding() == msgs::PosesCompact::FLOAT32)
+  {
+    if (_msg.value_size() != _msg.id_size() * 7)
+    {
+      gzerr << "Invalid compact poses message: [" << _msg.id_size()
+            << "] ids and [" << _msg.value_size() << "] values\n";
+      return false;
+    }
+
+    for (int i = 0; i < _msg.id_size(); ++i)
+    {
+      const float *v = _msg.value().data() + i * 7;
+      ignition::math::Pose3d pose(v[0], v[1], v[2], v[6], v[3], v[4], v[5]);
+      pose.Rot().Normalize();
+      if (_callback)
+        _callback(_msg.id(i), pose);
+    }
+    return true;
+  }
+
+  if (_msg.quantized_size() != _msg.id_size() * 7 ||
+      !(_msg.resolution() > 0))
+  {
+    gzerr << "Invalid compact poses message: [" << _msg.id_size()
+          << "] ids and [" << _msg.quantized_size() << "] values\n";
+    return false;
+  }
+
+  // The differences can only be applied to the previous message
+  if (_msg.keyframe())
+  {
+    this->quantized.clear();
+    this->synced = true;
+  }
+  else if (!this->synced || _msg.sequence() != this->sequence)
+  {
+    this->synced = false;
+    return false;
+  }
+  this->sequence = _msg.sequence() + 1;
+
+  const double resolution = _msg.resolution();
+  for (int i = 0; i < _msg.id_size(); ++i)
+  {
+    const int32_t *v = _msg.quantized().data() + i * 7;
+    std::array<int32_t, 7> &values = this->quantized[_msg.id(i)];
+    if (_msg.keyframe())
+      std::copy(v, v + 7, values.begin());
+    else
+    {
+      for (unsigned int j = 0; j < values.size(); ++j)
+        values[j] += v[j];
+    }
+
+    ignition::math::Pose3d pose(
+        values[0] * resolution,
+        values[1] * resolution,
+        values[2] * resolution,
+        values[6] / kOrientationScale,
+        values[3] / kOrientationScale,
+        values[4] / kOrientationScale,
+        values[5] / kOrientationScale);
+    pose.Rot().Normalize();
+    if (_callback)
+      _callback(_msg.id(i), pose);
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string PoseStreamDecoder::Name(const uint32_t _id) const
+{
+  auto iter = this->names.find(_id);
+  if (iter == this->names.end())
+    return "";
+  return iter->second;
+}
+
+/////////////////////////////////////////////////
+void PoseStreamDecoder::Reset()
+{
+  this->quantized.clear();
+  this->synced = false;
+}
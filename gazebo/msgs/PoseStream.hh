@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_MSGS_POSESTREAM_HH_
+#define GAZEBO_MSGS_POSESTREAM_HH_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/MessageTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace msgs
+  {
+    /// \addtogroup gazebo_msgs Messages
+    /// \{
+
+    /// \class PoseStreamEncoder PoseStream.hh msgs/msgs.hh
+    /// \brief Fills msgs::PosesCompact messages of a pose stream. Entities
+    /// are identified by id, and their names are only sent when they first
+    /// appear and in keyframes. An entity is only sent when it moved more
+    /// than its change thresholds since it was last sent.
+    ///
+    /// Usage, for each message:
+    /// \code
+    ///   encoder.Begin(time, msg);
+    ///   for (...)
+    ///     if (encoder.Add(id, pose))
+    ///       encoder.AddName(id, name);
+    ///   encoder.End();
+    /// \endcode
+    class GAZEBO_VISIBLE PoseStreamEncoder
+    {
+      /// \brief Constructor.
+      public: PoseStreamEncoder();
+
+      /// \brief Set the encoding of the values. Starts a new stream.
+      /// \param[in] _encoding Encoding.
+      public: void SetEncoding(const msgs::PosesCompact::Encoding _encoding);
+
+      /// \brief Get the encoding of the values.
+      /// \return Encoding.
+      public: msgs::PosesCompact::Encoding Encoding() const;
+
+      /// \brief Set the position resolution of the quantized encoding.
+      /// Starts a new stream.
+      /// \param[in] _resolution Resolution in meters, must be positive.
+      /// \return False if the resolution is invalid.
+      public: bool SetResolution(const double _resolution);
+
+      /// \brief Get the position resolution of the quantized encoding.
+      /// \return Resolution in meters.
+      public: double Resolution() const;
+
+      /// \brief Set the number of messages between two keyframes.
+      /// \param[in] _period Number of messages, 1 to only send keyframes.
+      public: void SetKeyframePeriod(const unsigned int _period);
+
+      /// \brief Set the default change thresholds. An entity is sent when
+      /// its position or orientation changed by more than the thresholds.
+      /// \param[in] _position Position threshold in meters.
+      /// \param[in] _rotation Rotation threshold in radians.
+      public: void SetThresholds(const double _position,
+                  const double _rotation);
+
+      /// \brief Set the change thresholds of an entity, which override the
+      /// default thresholds.
+      /// \param[in] _id Id of the entity.
+      /// \param[in] _position Position threshold in meters.
+      /// \param[in] _rotation Rotation threshold in radians.
+      public: void SetThresholds(const uint32_t _id, const double _position,
+                  const double _rotation);
+
+      /// \brief Start a message.
+      /// \param[in] _time Time stamp of the poses.
+      /// \param[out] _msg Message to fill. It is cleared.
+      public: void Begin(const common::Time &_time,
+                  msgs::PosesCompact &_msg);
+
+      /// \brief Whether the current message is a keyframe. Every entity
+      /// should be added to keyframes, not only those which moved.
+      /// \return True for a keyframe.
+      public: bool Keyframe() const;
+
+      /// \brief Add the pose of an entity to the current message.
+      /// \param[in] _id Id of the entity.
+      /// \param[in] _pose Pose of the entity.
+      /// \return True if the name of the entity must be added with AddName.
+      public: bool Add(const uint32_t _id,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Add the name of an entity to the current message.
+      /// \param[in] _id Id of the entity.
+      /// \param[in] _name Name of the entity.
+      public: void AddName(const uint32_t _id, const std::string &_name);
+
+      /// \brief Finish the current message.
+      public: void End();
+
+      /// \brief Start a new stream. The next message is a keyframe.
+      public: void Reset();
+
+      /// \brief Forget an entity, for example when it is deleted.
+      /// \param[in] _id Id of the entity.
+      public: void Remove(const uint32_t _id);
+
+      /// \brief Last state sent for an entity.
+      private: class EntityState
+      {
+        /// \brief Last pose sent.
+        public: ignition::math::Pose3d pose;
+
+        /// \brief Last quantized values sent.
+        public: std::array<int32_t, 7> quantized{{0, 0, 0, 0, 0, 0, 0}};
+
+        /// \brief True if the name was sent.
+        public: bool named = false;
+
+        /// \brief True if the entity has its own thresholds.
+        public: bool hasThresholds = false;
+
+        /// \brief Position threshold of the entity.
+        public: double positionThreshold = 0;
+
+        /// \brief Rotation threshold of the entity.
+        public: double rotationThreshold = 0;
+      };
+
+      /// \brief State per entity id.
+      private: std::unordered_map<uint32_t, EntityState> entities;
+
+      /// \brief Message being filled.
+      private: msgs::PosesCompact *msg = nullptr;
+
+      /// \brief Encoding of the values.
+      private: msgs::PosesCompact::Encoding encoding =
+          msgs::PosesCompact::QUANTIZED;
+
+      /// \brief Position resolution of the quantized encoding.
+      private: double resolution = 1e-4;
+
+      /// \brief Number of messages between keyframes.
+      private: unsigned int keyframePeriod = 60;
+
+      /// \brief Default position threshold.
+      private: double positionThreshold = 0;
+
+      /// \brief Default rotation threshold.
+      private: double rotationThreshold = 0;
+
+      /// \brief Sequence number of the next message.
+      private: uint32_t sequence = 0;
+
+      /// \brief Sequence number of the next keyframe.
+      private: uint32_t nextKeyframe = 0;
+
+      /// \brief True if the current message is a keyframe.
+      private: bool keyframe = false;
+    };
+
+    /// \class PoseStreamDecoder PoseStream.hh msgs/msgs.hh
+    /// \brief Reads the msgs::PosesCompact messages of a pose stream
+    /// written by a PoseStreamEncoder.
+    class GAZEBO_VISIBLE PoseStreamDecoder
+    {
+      /// \brief Callback with the id and pose of an entity.
+      public: using PoseCallback =
+          std::function<void (const uint32_t, const ignition::math::Pose3d &)>;
+
+      /// \brief Read a message of the stream.
+      /// \param[in] _msg Message to read.
+      /// \param[in] _callback Function called for each pose in the message.
+      /// \return False if the message can't be read, for example if it
+      /// follows a missing message of a quantized stream. The stream is
+      /// read again from the next keyframe.
+      public: bool Decode(const msgs::PosesCompact &_msg,
+                  const PoseCallback &_callback);
+
+      /// \brief Get the name of an entity received in the stream.
+      /// \param[in] _id Id of the entity.
+      /// \return Name of the entity, empty if it is unknown.
+      public: std::string Name(const uint32_t _id) const;
+
+      /// \brief Start a new stream. Quantized streams are read from the
+      /// next keyframe.
+      public: void Reset();
+
+      /// \brief Names of the entities, by id.
+      private: std::unordered_map<uint32_t, std::string> names;
+
+      /// \brief Last quantized values of the entities, by id.
+      private: std::unordered_map<uint32_t, std::array<int32_t, 7>> quantized;
+
+      /// \brief Expected sequence number of the next message.
+      private: uint32_t sequence = 0;
+
+      /// \brief True once a keyframe of a quantized stream was read.
+      private: bool synced = false;
+    };
+    /// \}
+  }
+}
+#endif
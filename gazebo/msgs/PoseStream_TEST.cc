@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <map>
+#include <gtest/gtest.h>
+
+#include "gazebo/msgs/PoseStream.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class PoseStreamTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Decode a message into a map of poses.
+  /// \param[in] _decoder Decoder.
+  /// \param[in] _msg Message.
+  /// \param[out] _poses Decoded poses by id.
+  /// \return Result of the decoder.
+  protected: bool Decode(msgs::PoseStreamDecoder &_decoder,
+                 const msgs::PosesCompact &_msg,
+                 std::map<uint32_t, ignition::math::Pose3d> &_poses)
+  {
+    return _decoder.Decode(_msg,
+        [&_poses](const uint32_t _id, const ignition::math::Pose3d &_pose)
+        {
+          _poses[_id] = _pose;
+        });
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(PoseStreamTest, Float32)
+{
+  msgs::PoseStreamEncoder encoder;
+  encoder.SetEncoding(msgs::PosesCompact::FLOAT32);
+  msgs::PoseStreamDecoder decoder;
+  msgs::PosesCompact msg;
+  std::map<uint32_t, ignition::math::Pose3d> poses;
+
+  ignition::math::Pose3d pose1(1.5, -2, 3, 0.1, 0.2, 0.3);
+  ignition::math::Pose3d pose2(-4, 5, 0.25, 0, 0, 1.2);
+
+  encoder.Begin(common::Time(1, 0), msg);
+  EXPECT_TRUE(encoder.Keyframe());
+  EXPECT_TRUE(encoder.Add(7, pose1));
+  encoder.AddName(7, "model::link");
+  EXPECT_TRUE(encoder.Add(9, pose2));
+  encoder.AddName(9, "model");
+  encoder.End();
+
+  EXPECT_EQ(2, msg.id_size());
+  EXPECT_EQ(14, msg.value_size());
+  EXPECT_EQ(1, msg.time().sec());
+
+  ASSERT_TRUE(this->Decode(decoder, msg, poses));
+  ASSERT_EQ(2u, poses.size());
+  EXPECT_NEAR(poses[7].Pos().Distance(pose1.Pos()), 0, 1e-6);
+  EXPECT_NEAR(poses[9].Rot().Euler().Z(), 1.2, 1e-6);
+  EXPECT_EQ("model::link", decoder.Name(7));
+  EXPECT_EQ("", decoder.Name(8));
+
+  // Entities which didn't move aren't sent, and names are only sent once
+  encoder.Begin(common::Time(2, 0), msg);
+  EXPECT_FALSE(encoder.Keyframe());
+  EXPECT_FALSE(encoder.Add(7, pose1));
+  pose2.Pos().X() += 1;
+  EXPECT_FALSE(encoder.Add(9, pose2));
+  encoder.End();
+  ASSERT_EQ(1, msg.id_size());
+  EXPECT_EQ(9u, msg.id(0));
+  EXPECT_EQ(0, msg.name_size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(PoseStreamTest, QuantizedDeltas)
+{
+  msgs::PoseStreamEncoder encoder;
+  EXPECT_EQ(msgs::PosesCompact::QUANTIZED, encoder.Encoding());
+  EXPECT_FALSE(encoder.SetResolution(0));
+  EXPECT_TRUE(encoder.SetResolution(1e-3));
+  encoder.SetKeyframePeriod(10);
+
+  msgs::PoseStreamDecoder decoder;
+  msgs::PosesCompact msg;
+  std::map<uint32_t, ignition::math::Pose3d> poses;
+
+  ignition::math::Pose3d pose(10, 20, 30, 0.5, -0.5, 1.0);
+  for (unsigned int i = 0; i < 25; ++i)
+  {
+    encoder.Begin(common::Time(i, 0), msg);
+    EXPECT_EQ(i % 10 == 0, encoder.Keyframe()) << i;
+    if (encoder.Add(1, pose))
+      encoder.AddName(1, "box");
+    encoder.End();
+
+    ASSERT_TRUE(this->Decode(decoder, msg, poses)) << i;
+    EXPECT_NEAR(poses[1].Pos().Distance(pose.Pos()), 0, 1e-3) << i;
+    EXPECT_NEAR((poses[1].Rot().Inverse() * pose.Rot()).Euler().Length(),
+        0, 1e-3) << i;
+
+    // Small motions are encoded as small differences
+    if (!msg.keyframe())
+    {
+      for (int j = 0; j < 3; ++j)
+        EXPECT_LE(std::abs(msg.quantized(j)), 10) << i;
+    }
+    pose.Pos() += ignition::math::Vector3d(0.001, -0.002, 0.005);
+    pose.Rot() = pose.Rot() * ignition::math::Quaterniond(0, 0, 0.01);
+  }
+  EXPECT_EQ("box", decoder.Name(1));
+
+  // A missing message stops the stream until the next keyframe
+  encoder.Begin(common::Time(25, 0), msg);
+  encoder.Add(1, pose);
+  encoder.End();
+  pose.Pos().Z() += 1;
+  for (unsigned int i = 26; i < 30; ++i)
+  {
+    encoder.Begin(common::Time(i, 0), msg);
+    encoder.Add(1, pose);
+    encoder.End();
+    EXPECT_FALSE(this->Decode(decoder, msg, poses)) << i;
+  }
+  encoder.Begin(common::Time(30, 0), msg);
+  EXPECT_TRUE(encoder.Keyframe());
+  encoder.Add(1, pose);
+  encoder.End();
+  ASSERT_TRUE(this->Decode(decoder, msg, poses));
+  EXPECT_NEAR(poses[1].Pos().Distance(pose.Pos()), 0, 1e-3);
+
+  // A new decoder starts reading at the next keyframe
+  msgs::PoseStreamDecoder lateDecoder;
+  encoder.Begin(common::Time(31, 0), msg);
+  pose.Pos().X() += 1;
+  encoder.Add(1, pose);
+  encoder.End();
+  EXPECT_FALSE(this->Decode(lateDecoder, msg, poses));
+}
+
+/////////////////////////////////////////////////
+TEST_F(PoseStreamTest, Thresholds)
+{
+  msgs::PoseStreamEncoder encoder;
+  encoder.SetEncoding(msgs::PosesCompact::FLOAT32);
+  encoder.SetThresholds(0.1, 0.2);
+  encoder.SetThresholds(2, 0.0, 0.0);
+  msgs::PosesCompact msg;
+
+  ignition::math::Pose3d pose;
+  encoder.Begin(common::Time::Zero, msg);
+  encoder.Add(1, pose);
+  encoder.Add(2, pose);
+  encoder.End();
+  EXPECT_EQ(2, msg.id_size());
+
+  // Below the default thresholds, but above the thresholds of entity 2
+  pose.Set(0.05, 0, 0, 0, 0, 0.1);
+  encoder.Begin(common::Time::Zero, msg);
+  encoder.Add(1, pose);
+  encoder.Add(2, pose);
+  encoder.End();
+  ASSERT_EQ(1, msg.id_size());
+  EXPECT_EQ(2u, msg.id(0));
+
+  // Changes are measured from the last pose sent
+  pose.Set(0.11, 0, 0, 0, 0, 0);
+  encoder.Begin(common::Time::Zero, msg);
+  encoder.Add(1, pose);
+  encoder.End();
+  EXPECT_EQ(1, msg.id_size());
+
+  pose.Set(0.11, 0, 0, 0, 0, 0.25);
+  encoder.Begin(common::Time::Zero, msg);
+  encoder.Add(1, pose);
+  encoder.End();
+  EXPECT_EQ(1, msg.id_size());
+
+  // Keyframes have every entity
+  encoder.Reset();
+  encoder.Begin(common::Time::Zero, msg);
+  EXPECT_TRUE(encoder.Keyframe());
+  EXPECT_TRUE(encoder.Add(1, pose));
+  EXPECT_TRUE(encoder.Add(2, pose));
+  encoder.End();
+  EXPECT_EQ(2, msg.id_size());
+
+  // Entity thresholds survive a reset
+  pose.Set(0.12, 0, 0, 0, 0, 0.25);
+  encoder.Begin(common::Time::Zero, msg);
+  encoder.Add(1, pose);
+  encoder.Add(2, pose);
+  encoder.End();
+  ASSERT_EQ(1, msg.id_size());
+  EXPECT_EQ(2u, msg.id(0));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,9 +14,14 @@
  * limitations under the License.
  *
 */
-#include <sstream>
-#include <limits>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <sstream>
 
 #include "gazebo/common/BVHLoader.hh"
 #include "gazebo/common/Console.hh"
@@ -35,6 +40,76 @@
 
 #include "gazebo/transport/Node.hh"
 
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Skeleton animation sampled at a fixed rate. The samples hold
+    /// the transform of each bone of the skin relative to its parent, by
+    /// bone handle, with the BVH alignment already applied. The root bone
+    /// holds the transform of the animation root, which is combined with
+    /// the trajectory of the actor when playing.
+    class BakedAnimation
+    {
+      /// \brief Get the poses of the bones at a time, interpolated between
+      /// the two closest samples.
+      /// \param[in] _time Time in seconds, looped over the animation.
+      /// \param[out] _poses Poses of the bones.
+      public: void Sample(const double _time,
+                  std::vector<ignition::math::Pose3d> &_poses) const;
+
+      /// \brief Get the time at which the root of the animation reaches a
+      /// position along X. Equivalent to SkeletonAnimation::PoseAtX.
+      /// \param[in] _x Position along X.
+      /// \return Time in seconds.
+      public: double TimeAtX(const double _x) const;
+
+      /// \brief Samples per second.
+      public: double rate = 0;
+
+      /// \brief Length of the animation in seconds.
+      public: double length = 0;
+
+      /// \brief Number of samples.
+      public: unsigned int sampleCount = 0;
+
+      /// \brief Number of bones per sample.
+      public: unsigned int boneCount = 0;
+
+      /// \brief Handle of the root bone.
+      public: unsigned int rootBone = 0;
+
+      /// \brief True if the root of the animation has keyframes.
+      public: bool rootAnimated = false;
+
+      /// \brief True if the animation comes from a BVH file.
+      public: bool bvh = false;
+
+      /// \brief BVH translation aligner of the root bone.
+      public: ignition::math::Matrix4d rootTranslationAligner =
+          ignition::math::Matrix4d::Identity;
+
+      /// \brief BVH rotation aligner of the root bone.
+      public: ignition::math::Matrix4d rootRotationAligner =
+          ignition::math::Matrix4d::Identity;
+
+      /// \brief Poses of the bones, boneCount per sample.
+      public: std::vector<ignition::math::Pose3d> poses;
+    };
+  }
+}
+
+/// \brief Rate at which the skeleton animations are sampled.
+static const double kBakeRate = 60.0;
+
+/// \brief Baked animations, shared by the actors using the same skin and
+/// animation files.
+static std::map<std::string,
+    std::weak_ptr<const gazebo::physics::BakedAnimation>> g_bakedAnimations;
+
+/// \brief Protects g_bakedAnimations.
+static std::mutex g_bakedAnimationsMutex;
+
 /// \brief Private data for Actor class
 class gazebo::physics::ActorPrivate
 {
@@ -48,12 +123,228 @@ class gazebo::physics::ActorPrivate
   /// \brief Rotations to align BVH skeleton to DAE skin
   public: std::map<std::string, ignition::math::Matrix4d>
       rotationAligner;
+
+  /// \brief Baked skeleton animations, indexed by their names.
+  public: std::map<std::string, std::shared_ptr<const BakedAnimation>>
+      bakedAnimations;
+
+  /// \brief Link of each bone, by bone handle.
+  public: Link_V boneLinks;
+
+  /// \brief Handle of the parent of each bone, -1 for the root.
+  public: std::vector<int> boneParents;
+
+  /// \brief Bone handles, parents before their children.
+  public: std::vector<unsigned int> boneOrder;
+
+  /// \brief True if UpdateFrame computed poses to apply.
+  public: bool frameReady = false;
+
+  /// \brief True if the frame animates the skeleton, otherwise only the
+  /// model pose is set.
+  public: bool frameSkeleton = false;
+
+  /// \brief Model pose of a frame without skeleton animation.
+  public: ignition::math::Pose3d frameModelPose;
+
+  /// \brief Pose of each bone relative to its parent.
+  public: std::vector<ignition::math::Pose3d> boneLocalPoses;
+
+  /// \brief World pose of each bone.
+  public: std::vector<ignition::math::Pose3d> boneWorldPoses;
+
+  /// \brief World pose of the actor in the frame.
+  public: ignition::math::Pose3d mainLinkPose;
+
+  /// \brief Sim time of the frame.
+  public: double frameTime = 0;
+
+  /// \brief True to publish the skeleton poses.
+  public: bool publishSkeletonPose = true;
 };
 
 using namespace gazebo;
 using namespace physics;
 using namespace common;
 
+//////////////////////////////////////////////////
+void BakedAnimation::Sample(const double _time,
+    std::vector<ignition::math::Pose3d> &_poses) const
+{
+  _poses.resize(this->boneCount);
+  if (this->sampleCount == 0)
+    return;
+
+  double time = std::max(0.0, _time);
+  if (this->length > 0 && time > this->length)
+    time = std::fmod(time, this->length);
+
+  const double s = time * this->rate;
+  unsigned int k = static_cast<unsigned int>(s);
+  double t = s - k;
+  if (k + 1 >= this->sampleCount)
+  {
+    k = this->sampleCount - 1;
+    t = 0;
+  }
+
+  const ignition::math::Pose3d *prev = &this->poses[k * this->boneCount];
+  if (t <= 0)
+  {
+    std::copy(prev, prev + this->boneCount, _poses.begin());
+    return;
+  }
+
+  const ignition::math::Pose3d *next = prev + this->boneCount;
+  for (unsigned int i = 0; i < this->boneCount; ++i)
+  {
+    _poses[i].Set(prev[i].Pos() + (next[i].Pos() - prev[i].Pos()) * t,
+        ignition::math::Quaterniond::Slerp(t, prev[i].Rot(), next[i].Rot(),
+          true));
+  }
+}
+
+//////////////////////////////////////////////////
+double BakedAnimation::TimeAtX(const double _x) const
+{
+  if (!this->rootAnimated || this->sampleCount == 0)
+    return 0;
+
+  auto rootX = [this](const unsigned int _k)
+  {
+    return this->poses[_k * this->boneCount + this->rootBone].Pos().X();
+  };
+
+  double x = std::max(_x, rootX(0));
+  const double lastX = rootX(this->sampleCount - 1);
+  if (lastX > 0 && x > lastX)
+    x = std::fmod(x, lastX);
+
+  unsigned int k = 0;
+  while (k < this->sampleCount && rootX(k) < x)
+    ++k;
+
+  if (k == this->sampleCount)
+    return this->length;
+
+  if (k == 0 || ignition::math::equal(rootX(k), x))
+    return k / this->rate;
+
+  const double x1 = rootX(k - 1);
+  const double x2 = rootX(k);
+  return (k - 1 + (x - x1) / (x2 - x1)) / this->rate;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get an aligner of a BVH node.
+/// \param[in] _aligners Aligners by node name.
+/// \param[in] _node Name of the node.
+/// \return The aligner, identity if the node has none.
+static ignition::math::Matrix4d Aligner(
+    const std::map<std::string, ignition::math::Matrix4d> &_aligners,
+    const std::string &_node)
+{
+  auto iter = _aligners.find(_node);
+  if (iter == _aligners.end())
+    return ignition::math::Matrix4d::Identity;
+  return iter->second;
+}
+
+//////////////////////////////////////////////////
+/// \brief Sample a skeleton animation for the bones of a skin.
+/// \param[in] _skin Skeleton of the skin.
+/// \param[in] _anim Animation.
+/// \param[in] _skelMap Names of the animation nodes by skin node name.
+/// \param[in] _bvh True if the animation comes from a BVH file.
+/// \param[in] _translationAligner BVH translation aligners.
+/// \param[in] _rotationAligner BVH rotation aligners.
+/// \return The baked animation.
+static std::shared_ptr<const BakedAnimation> BakeAnimation(
+    Skeleton *_skin, SkeletonAnimation *_anim,
+    const std::map<std::string, std::string> &_skelMap, const bool _bvh,
+    const std::map<std::string, ignition::math::Matrix4d> &_translationAligner,
+    const std::map<std::string, ignition::math::Matrix4d> &_rotationAligner)
+{
+  auto baked = std::make_shared<BakedAnimation>();
+  baked->length = std::max(0.0, _anim->GetLength());
+  baked->sampleCount =
+      static_cast<unsigned int>(std::ceil(baked->length * kBakeRate)) + 1;
+  // Spread the samples evenly over the animation
+  baked->rate = baked->sampleCount > 1 ?
+      (baked->sampleCount - 1) / baked->length : kBakeRate;
+  baked->boneCount = _skin->GetNumNodes();
+  baked->rootBone = _skin->GetRootNode()->GetHandle();
+  baked->bvh = _bvh;
+  baked->poses.resize(baked->sampleCount * baked->boneCount);
+
+  std::string animRoot;
+  auto rootIter = _skelMap.find(_skin->GetRootNode()->GetName());
+  if (rootIter != _skelMap.end())
+    animRoot = rootIter->second;
+  baked->rootAnimated = _anim->HasNode(animRoot);
+
+  if (_bvh)
+  {
+    baked->rootTranslationAligner = Aligner(_translationAligner, animRoot);
+    baked->rootRotationAligner = Aligner(_rotationAligner, animRoot);
+  }
+
+  for (unsigned int k = 0; k < baked->sampleCount; ++k)
+  {
+    const double time = std::min(k / baked->rate, baked->length);
+    std::map<std::string, ignition::math::Matrix4d> frame =
+        _anim->PoseAt(time);
+
+    for (unsigned int i = 0; i < baked->boneCount; ++i)
+    {
+      SkeletonNode *bone = _skin->GetNodeByHandle(i);
+
+      auto frameIter = frame.end();
+      auto nameIter = _skelMap.find(bone->GetName());
+      if (nameIter != _skelMap.end())
+        frameIter = frame.find(nameIter->second);
+
+      ignition::math::Matrix4d transform(ignition::math::Matrix4d::Identity);
+      if (i == baked->rootBone)
+      {
+        if (frameIter != frame.end())
+          transform = frameIter->second;
+      }
+      else if (frameIter == frame.end())
+      {
+        transform = bone->Transform();
+      }
+      else if (_bvh)
+      {
+        transform = frameIter->second;
+
+        ignition::math::Vector3d bvhOffset = transform.Translation();
+        ignition::math::Vector3d daeOffset = bone->Transform().Translation();
+        // scale bvh offset to dae link length
+        transform.SetTranslation(daeOffset.Length() * bvhOffset.Normalize());
+
+        transform = Aligner(_translationAligner, frameIter->first) *
+            transform * Aligner(_rotationAligner, frameIter->first);
+      }
+      else
+      {
+        transform = frameIter->second;
+      }
+
+      ignition::math::Pose3d pose = transform.Pose();
+      if (!pose.IsFinite())
+      {
+        gzerr << "ACTOR: " << time << " " << bone->GetName()
+              << " " << pose << "\n";
+        pose.Correct();
+      }
+      baked->poses[k * baked->boneCount + i] = pose;
+    }
+  }
+
+  return baked;
+}
+
 //////////////////////////////////////////////////
 Actor::Actor(BasePtr _parent)
   : Model(_parent), dataPtr(new ActorPrivate)
@@ -508,6 +799,21 @@ void Actor::LoadAnimation(sdf::ElementPtr _sdf)
   this->skelAnimation[animName] = skel->GetAnimation(0);
   this->interpolateX[animName] = _sdf->Get<bool>("interpolate_x");
   this->skelNodesMap[animName] = skelMap;
+
+  // Bake the animation, or reuse the one baked by another actor
+  std::ostringstream key;
+  key << this->skinFile << "|" << animFile << "|" << animScale;
+  std::lock_guard<std::mutex> lock(g_bakedAnimationsMutex);
+  std::shared_ptr<const BakedAnimation> baked =
+      g_bakedAnimations[key.str()].lock();
+  if (!baked)
+  {
+    baked = BakeAnimation(this->skeleton, skel->GetAnimation(0), skelMap,
+        extension == "bvh", this->dataPtr->translationAligner,
+        this->dataPtr->rotationAligner);
+    g_bakedAnimations[key.str()] = baked;
+  }
+  this->dataPtr->bakedAnimations[animName] = baked;
 }
 
 //////////////////////////////////////////////////
@@ -643,6 +949,33 @@ void Actor::Init()
   if (this->autoStart)
     this->Play();
   this->mainLink = this->GetChildLink(this->GetName() + "_pose");
+
+  // Index the bones by handle, so that updates don't look them up by name
+  this->dataPtr->boneLinks.clear();
+  this->dataPtr->boneParents.clear();
+  this->dataPtr->boneOrder.clear();
+  if (!this->skeleton)
+    return;
+
+  const unsigned int boneCount = this->skeleton->GetNumNodes();
+  for (unsigned int i = 0; i < boneCount; ++i)
+  {
+    SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
+    this->dataPtr->boneLinks.push_back(this->GetChildLink(bone->GetName()));
+    this->dataPtr->boneParents.push_back(bone->GetParent() ?
+        static_cast<int>(bone->GetParent()->GetHandle()) : -1);
+    if (!bone->GetParent())
+      this->dataPtr->boneOrder.push_back(i);
+  }
+
+  // Parents before their children
+  for (unsigned int i = 0; i < this->dataPtr->boneOrder.size(); ++i)
+  {
+    SkeletonNode *bone =
+        this->skeleton->GetNodeByHandle(this->dataPtr->boneOrder[i]);
+    for (unsigned int j = 0; j < bone->GetChildCount(); ++j)
+      this->dataPtr->boneOrder.push_back(bone->GetChild(j)->GetHandle());
+  }
 }
 
 //////////////////////////////////////////////////
@@ -667,17 +1000,42 @@ bool Actor::IsActive() const
 ///////////////////////////////////////////////////
 void Actor::Update()
 {
+  if (this->UpdateFrame())
+    this->ApplyFrame();
+}
+
+//////////////////////////////////////////////////
+void Actor::UpdateActors(const Actor_V &_actors)
+{
+  // Sampling the animations only modifies each actor
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, _actors.size(), 8),
+      [&_actors](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+          _actors[i]->UpdateFrame();
+      });
+
+  // Setting the poses of the links modifies the world
+  for (auto const &actor : _actors)
+    actor->ApplyFrame();
+}
+
+///////////////////////////////////////////////////
+bool Actor::UpdateFrame()
+{
+  this->dataPtr->frameReady = false;
+
   if (!this->active)
-    return;
+    return false;
 
   if (this->skelAnimation.empty() && this->trajectories.empty())
-    return;
+    return false;
 
   common::Time currentTime = this->world->SimTime();
 
   // do not refresh animation faster than 30 Hz sim time
   if ((currentTime - this->prevFrameTime).Double() < (1.0 / 30.0))
-    return;
+    return false;
 
   // Get trajectory
   TrajectoryInfo *tinfo = nullptr;
@@ -688,13 +1046,13 @@ void Actor::Update()
 
     // waiting for delayed start
     if (this->scriptTime < 0)
-      return;
+      return false;
 
     if (this->scriptTime >= this->scriptLength)
     {
       if (!this->loop)
       {
-        return;
+        return false;
       }
       else
       {
@@ -718,7 +1076,7 @@ void Actor::Update()
     {
       gzerr << "Trajectory not found at time [" << this->scriptTime << "]"
           << std::endl;
-      return;
+      return false;
     }
 
     this->scriptTime = this->scriptTime - tinfo->startTime;
@@ -730,16 +1088,18 @@ void Actor::Update()
 
   // at this point we are certain that a new frame will be animated
   this->prevFrameTime = currentTime;
+  this->dataPtr->frameReady = true;
+  this->dataPtr->frameTime = currentTime.Double();
 
   // Update global trajectory (not skeleton animation)
   ignition::math::Pose3d modelPose;
-  if (!this->customTrajectoryInfo &&
-      this->trajectories.find(tinfo->id) != this->trajectories.end())
+  auto trajIter = this->trajectories.find(tinfo->id);
+  if (!this->customTrajectoryInfo && trajIter != this->trajectories.end())
   {
     // Get the pose keyframe calculated for this script time
     common::PoseKeyFrame posFrame(0.0);
-    this->trajectories[tinfo->id]->SetTime(this->scriptTime);
-    this->trajectories[tinfo->id]->GetInterpolatedKeyFrame(posFrame);
+    trajIter->second->SetTime(this->scriptTime);
+    trajIter->second->GetInterpolatedKeyFrame(posFrame);
 
     modelPose.Pos() = posFrame.Translation();
     modelPose.Rot() = posFrame.Rotation();
@@ -754,56 +1114,44 @@ void Actor::Update()
     else
     {
       auto frame0 = dynamic_cast<common::PoseKeyFrame *>
-        (this->trajectories[tinfo->id]->GetKeyFrame(0));
+        (trajIter->second->GetKeyFrame(0));
       ignition::math::Vector3d vector3Ign = frame0->Translation();
       this->pathLength = modelPose.Pos().Distance(vector3Ign);
     }
     this->lastPos = modelPose.Pos();
   }
 
-  SkeletonAnimation *skelAnim = this->skelAnimation[tinfo->type];
+  auto bakedIter = this->dataPtr->bakedAnimations.find(tinfo->type);
 
   // If there's no skeleton animation, we just update the global pose
-  if (!skelAnim)
+  if (bakedIter == this->dataPtr->bakedAnimations.end() ||
+      bakedIter->second->boneCount != this->dataPtr->boneParents.size())
   {
-    this->SetWorldPose(modelPose);
-    return;
+    this->dataPtr->frameSkeleton = false;
+    this->dataPtr->frameModelPose = modelPose;
+    return true;
   }
+  this->dataPtr->frameSkeleton = true;
 
-  auto skelMap = this->skelNodesMap[tinfo->type];
+  const BakedAnimation &baked = *bakedIter->second;
+  auto &localPoses = this->dataPtr->boneLocalPoses;
+  auto &worldPoses = this->dataPtr->boneWorldPoses;
 
-  std::map<std::string, ignition::math::Matrix4d> frame;
-  if (!this->customTrajectoryInfo)
-  {
-    if (this->interpolateX[tinfo->type] &&
-          this->trajectories.find(tinfo->id) != this->trajectories.end())
-    {
-      frame = skelAnim->PoseAtX(this->pathLength,
-                skelMap[this->skeleton->GetRootNode()->GetName()]);
-    }
-    else
-    {
-      frame = skelAnim->PoseAt(this->scriptTime);
-    }
-  }
-  else
+  double animTime = this->scriptTime;
+  auto interpIter = this->interpolateX.find(tinfo->type);
+  if (!this->customTrajectoryInfo && interpIter != this->interpolateX.end() &&
+      interpIter->second && trajIter != this->trajectories.end())
   {
-    frame = skelAnim->PoseAt(this->scriptTime);
+    animTime = baked.TimeAtX(this->pathLength);
   }
+  baked.Sample(animTime, localPoses);
 
   this->lastTraj = tinfo->id;
 
-  ignition::math::Matrix4d rootTrans = ignition::math::Matrix4d::Identity;
-  auto iter = frame.find(skelMap[this->skeleton->GetRootNode()->GetName()]);
-  if (iter != frame.end())
-  {
-    rootTrans = frame[skelMap[this->skeleton->GetRootNode()->GetName()]];
-  }
-
-  ignition::math::Vector3d rootPos = rootTrans.Translation();
-  ignition::math::Quaterniond rootRot = rootTrans.Rotation();
+  ignition::math::Vector3d rootPos = localPoses[baked.rootBone].Pos();
+  ignition::math::Quaterniond rootRot = localPoses[baked.rootBone].Rot();
   // Zero root pos for BVH
-  if (this->dataPtr->bvhFile)
+  if (baked.bvh)
   {
     rootPos = ignition::math::Vector3d::Zero;
   }
@@ -825,142 +1173,130 @@ void Actor::Update()
 
   ignition::math::Matrix4d rootM(actorPose.Rot());
 
-  rootM.SetTranslation(actorPose.Pos());
+  // workaround for rotation bug, the skin scale is only applied to the
+  // translation
+  rootM.SetTranslation(actorPose.Pos() * this->skinScale);
 
-  // TODO: Possible bug here? Rotation changed after scaling. Maybe the
-  // rotation algorithm is not suppose to work on non unit quaternion.
-//    gzdbg << "before: " << rootM.Rotation() << std::endl;
-//    rootM.Scale(this->skinScale, this->skinScale, this->skinScale);
-//    auto scaleTrans = ignition::math::Matrix4d::Identity;
-//    scaleTrans.Scale(this->skinScale, this->skinScale, this->skinScale);
-//    rootM = scaleTrans * rootM;
-//    gzdbg << "after: " << rootM.Rotation() << std::endl;
+  if (baked.bvh)
+    rootM = baked.rootTranslationAligner * rootM * baked.rootRotationAligner;
 
-  // workaround for rotation bug
-  rootM.SetTranslation(rootM.Translation() * this->skinScale);
+  localPoses[baked.rootBone] = rootM.Pose();
+  if (!localPoses[baked.rootBone].IsFinite())
+  {
+    gzerr << "ACTOR: " << this->dataPtr->frameTime << " "
+          << this->skeleton->GetRootNode()->GetName() << " "
+          << localPoses[baked.rootBone] << "\n";
+    localPoses[baked.rootBone].Correct();
+  }
 
-  frame[skelMap[this->skeleton->GetRootNode()->GetName()]] = rootM;
+  if (this->customTrajectoryInfo)
+    this->dataPtr->mainLinkPose = this->worldPose;
 
-  this->SetPose(frame, skelMap, currentTime.Double());
+  // Compose the poses from the root to the leaves
+  worldPoses.resize(baked.boneCount);
+  for (auto const i : this->dataPtr->boneOrder)
+  {
+    const int parent = this->dataPtr->boneParents[i];
+    if (parent < 0)
+    {
+      worldPoses[i] = localPoses[i];
+      if (!this->customTrajectoryInfo)
+        this->dataPtr->mainLinkPose = localPoses[i];
+    }
+    else
+    {
+      worldPoses[i] = localPoses[i] + worldPoses[parent];
+    }
+  }
+
+  return true;
 }
 
 //////////////////////////////////////////////////
-void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
-    std::map<std::string, std::string> _skelMap, const double _time)
+void Actor::ApplyFrame()
 {
-  msgs::PoseAnimation msg;
-  msg.set_model_name(this->visualName);
-  msg.set_model_id(this->visualId);
+  if (!this->dataPtr->frameReady)
+    return;
+  this->dataPtr->frameReady = false;
+
+  if (!this->dataPtr->frameSkeleton)
+  {
+    this->SetWorldPose(this->dataPtr->frameModelPose);
+    return;
+  }
 
-  ignition::math::Matrix4d modelTrans(ignition::math::Matrix4d::Identity);
-  ignition::math::Pose3d mainLinkPose;
+  const auto &localPoses = this->dataPtr->boneLocalPoses;
+  const auto &worldPoses = this->dataPtr->boneWorldPoses;
+  const ignition::math::Pose3d &mainLinkPose = this->dataPtr->mainLinkPose;
 
-  if (this->customTrajectoryInfo)
+  for (unsigned int i = 0; i < this->dataPtr->boneLinks.size(); ++i)
   {
-    mainLinkPose.Pos() = this->worldPose.Pos();
-    mainLinkPose.Rot() = this->worldPose.Rot();
+    if (this->dataPtr->boneLinks[i])
+      this->dataPtr->boneLinks[i]->SetWorldPose(worldPoses[i], true, false);
   }
 
-  for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); ++i)
+  // The skeleton pose is only needed to animate the skin in the client
+  if (this->dataPtr->publishSkeletonPose && this->bonePosePub &&
+      this->bonePosePub->HasConnections())
   {
-    SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
-    SkeletonNode *parentBone = bone->GetParent();
-    ignition::math::Matrix4d transform(ignition::math::Matrix4d::Identity);
+    msgs::PoseAnimation msg;
+    msg.set_model_name(this->visualName);
+    msg.set_model_id(this->visualId);
 
-    if (_frame.find(_skelMap[bone->GetName()]) != _frame.end())
+    for (unsigned int i = 0; i < this->dataPtr->boneLinks.size(); ++i)
     {
-      if (this->dataPtr->bvhFile)
+      SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
+      LinkPtr currentLink = this->dataPtr->boneLinks[i];
+      if (!currentLink)
+        continue;
+
+      msgs::Pose *bone_pose = msg.add_pose();
+      bone_pose->set_name(bone->GetName());
+      if (this->dataPtr->boneParents[i] < 0)
       {
-        std::string tempStr(_skelMap[bone->GetName()]);
-        transform = _frame[tempStr];
-
-        if (bone->GetName() != this->skeleton->GetRootNode()->GetName())
-        {
-          ignition::math::Vector3d bvhOffset = transform.Translation();
-          ignition::math::Vector3d daeOffset = bone->Transform().Translation();
-          // scale bvh offset to dae link length
-          transform.SetTranslation(daeOffset.Length() * bvhOffset.Normalize());
-        }
-
-        transform = this->dataPtr->translationAligner[tempStr] * transform *
-            this->dataPtr->rotationAligner[tempStr];
+        msgs::Set(bone_pose, ignition::math::Pose3d::Zero);
       }
       else
       {
-        transform = _frame[_skelMap[bone->GetName()]];
+        msgs::Set(bone_pose, localPoses[i]);
       }
-    }
-    else
-    {
-      transform = bone->Transform();
-    }
 
-    LinkPtr currentLink = this->GetChildLink(bone->GetName());
-    ignition::math::Pose3d bonePose = transform.Pose();
-    if (!bonePose.IsFinite())
-    {
-      gzerr << "ACTOR: " << _time << " " << bone->GetName()
-                << " " << bonePose << "\n";
-      bonePose.Correct();
+      msgs::Pose *link_pose = msg.add_pose();
+      link_pose->set_name(currentLink->GetScopedName());
+      link_pose->set_id(currentLink->GetId());
+      msgs::Set(link_pose, worldPoses[i] - mainLinkPose);
     }
 
-    msgs::Pose *bone_pose = msg.add_pose();
-    bone_pose->set_name(bone->GetName());
+    msgs::Time *stamp = msg.add_time();
+    stamp->CopyFrom(msgs::Convert(this->dataPtr->frameTime));
 
-    if (!parentBone)
-    {
-      bone_pose->mutable_position()->CopyFrom(
-          msgs::Convert(ignition::math::Vector3d()));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(
-          ignition::math::Quaterniond()));
-      if (!this->customTrajectoryInfo)
-        mainLinkPose = bonePose;
-    }
+    msgs::Pose *model_pose = msg.add_pose();
+    model_pose->set_name(this->GetScopedName());
+    model_pose->set_id(this->GetId());
+    if (!this->customTrajectoryInfo)
+      msgs::Set(model_pose, mainLinkPose);
     else
-    {
-      bone_pose->mutable_position()->CopyFrom(msgs::Convert(bonePose.Pos()));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(bonePose.Rot()));
-      LinkPtr parentLink = this->GetChildLink(parentBone->GetName());
-      auto parentPose = parentLink->WorldPose();
-      ignition::math::Matrix4d parentTrans(parentPose);
-      transform = parentTrans * transform;
-    }
+      msgs::Set(model_pose, this->worldPose);
 
-    msgs::Pose *link_pose = msg.add_pose();
-    link_pose->set_name(currentLink->GetScopedName());
-    link_pose->set_id(currentLink->GetId());
-    ignition::math::Pose3d linkPose = transform.Pose() - mainLinkPose;
-    link_pose->mutable_position()->CopyFrom(msgs::Convert(linkPose.Pos()));
-    link_pose->mutable_orientation()->CopyFrom(msgs::Convert(linkPose.Rot()));
-    currentLink->SetWorldPose(transform.Pose(), true, false);
-  }
-
-  msgs::Time *stamp = msg.add_time();
-  stamp->CopyFrom(msgs::Convert(_time));
-
-  msgs::Pose *model_pose = msg.add_pose();
-  model_pose->set_name(this->GetScopedName());
-  model_pose->set_id(this->GetId());
-  if (!this->customTrajectoryInfo)
-  {
-    model_pose->mutable_position()->CopyFrom(msgs::Convert(mainLinkPose.Pos()));
-    model_pose->mutable_orientation()->CopyFrom(
-        msgs::Convert(mainLinkPose.Rot()));
-  }
-  else
-  {
-    model_pose->mutable_position()->CopyFrom(
-        msgs::Convert(this->worldPose.Pos()));
-    model_pose->mutable_orientation()->CopyFrom(
-        msgs::Convert(this->worldPose.Rot()));
+    this->bonePosePub->Publish(msg);
   }
 
-  if (this->bonePosePub && this->bonePosePub->HasConnections())
-    this->bonePosePub->Publish(msg);
   if (!this->customTrajectoryInfo)
     this->SetWorldPose(mainLinkPose, true, false);
 }
 
+//////////////////////////////////////////////////
+void Actor::SetPublishSkeletonPose(const bool _publish)
+{
+  this->dataPtr->publishSkeletonPose = _publish;
+}
+
+//////////////////////////////////////////////////
+bool Actor::PublishSkeletonPose() const
+{
+  return this->dataPtr->publishSkeletonPose;
+}
+
 //////////////////////////////////////////////////
 void Actor::Fini()
 {
@@ -114,6 +114,24 @@ namespace gazebo
       /// \brief Update the actor
       public: void Update();
 
+      /// \brief Update a batch of actors. The animations of the actors are
+      /// sampled in parallel, then the poses of their links are set one
+      /// actor at a time. The world updates all its actors this way.
+      /// \param[in] _actors Actors to update.
+      public: static void UpdateActors(const Actor_V &_actors);
+
+      /// \brief Set whether the poses of the skeleton are published on
+      /// ~/skeleton_pose/info, which is used to animate the skin in the
+      /// client. The message is only built when it has subscribers.
+      /// \param[in] _publish True to publish the skeleton poses.
+      /// \sa PublishSkeletonPose
+      public: void SetPublishSkeletonPose(const bool _publish);
+
+      /// \brief Get whether the poses of the skeleton are published.
+      /// \return True if the skeleton poses are published.
+      /// \sa SetPublishSkeletonPose
+      public: bool PublishSkeletonPose() const;
+
       /// \brief Finalize the actor
       public: virtual void Fini();
 
@@ -277,15 +295,15 @@ namespace gazebo
       /// \param[in] _sdf SDF element containing the trajectory script.
       private: void LoadScript(sdf::ElementPtr _sdf);
 
-      /// \brief Set the actor's pose. This sets the pose for each bone in the
-      /// skeleton and also the actor's pose in the world.
-      /// \param[in] _frame Each frame name and transform.
-      /// \param[in] _skelMap Map of bone relationships.
-      /// \param[in] _time Time over which to animate the set pose.
-      private: void SetPose(
-                   std::map<std::string, ignition::math::Matrix4d> _frame,
-                   std::map<std::string, std::string> _skelMap,
-                   const double _time);
+      /// \brief Compute the poses of the links for the current time, without
+      /// modifying the world. This can be called for several actors in
+      /// parallel.
+      /// \return True if the poses must be set with ApplyFrame.
+      private: bool UpdateFrame();
+
+      /// \brief Set the poses computed by UpdateFrame on the links and
+      /// publish the skeleton pose.
+      private: void ApplyFrame();
 
       /// \brief Pointer to the actor's mesh.
       protected: const common::Mesh *mesh = nullptr;
@@ -15,6 +15,9 @@
  *
 */
 
+#include <map>
+#include <string>
+
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/physics/Actor.hh"
 
@@ -102,6 +105,53 @@ TEST_F(ActorTest, TrajectoryFromSDF)
   EXPECT_LT(fabs(actor->ScriptTime() - world->SimTime().Double()), 1.0 / 30);
 }
 
+//////////////////////////////////////////////////
+TEST_F(ActorTest, SkeletonFrames)
+{
+  // Load a world with an actor
+  this->Load("worlds/actor.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto actor = boost::dynamic_pointer_cast<physics::Actor>(
+      world->ModelByName("actor"));
+  ASSERT_TRUE(actor != nullptr);
+
+  EXPECT_TRUE(actor->PublishSkeletonPose());
+  actor->SetPublishSkeletonPose(false);
+  EXPECT_FALSE(actor->PublishSkeletonPose());
+
+  // Every bone link follows the animation, close to the actor
+  world->Step(500);
+  auto links = actor->GetLinks();
+  ASSERT_GT(links.size(), 1u);
+  std::map<std::string, ignition::math::Pose3d> poses;
+  for (auto const &link : links)
+  {
+    EXPECT_TRUE(link->WorldPose().IsFinite()) << link->GetName();
+    EXPECT_LT((link->WorldPose().Pos() - actor->WorldPose().Pos()).Length(),
+        3.0) << link->GetName();
+    poses[link->GetName()] = link->WorldPose();
+  }
+
+  // The actors are updated in a batch by the world
+  world->Step(100);
+  unsigned int moved = 0;
+  for (auto const &link : links)
+  {
+    if (link->WorldPose() != poses[link->GetName()])
+      ++moved;
+    poses[link->GetName()] = link->WorldPose();
+  }
+  EXPECT_GT(moved, 0u);
+
+  // Frames aren't refreshed faster than 30 Hz
+  physics::Actor::UpdateActors({actor});
+  physics::Actor::UpdateActors({});
+  for (auto const &link : links)
+    EXPECT_EQ(poses[link->GetName()], link->WorldPose()) << link->GetName();
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
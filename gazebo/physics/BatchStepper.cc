@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/BatchStepper.hh"
+#include "gazebo/physics/BatchStepperPrivate.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+/// \brief Copy the state of the observed links and joints into a frame.
+/// \param[in] _data Private data of the stepper.
+/// \param[in] _frame Index of the frame.
+/// \param[out] _obs Observation to fill.
+static void ObserveFrame(const BatchStepperPrivate &_data,
+    const unsigned int _frame, BatchObservation &_obs)
+{
+  _obs.iterations[_frame] = _data.world->Iterations();
+
+  const size_t linkCount = _data.links.size();
+  double *pose = _obs.linkPoses.data() + _frame * linkCount * 7;
+  double *vel = _obs.linkVelocities.data() + _frame * linkCount * 6;
+  for (auto const &link : _data.links)
+  {
+    const ignition::math::Pose3d &p = link->WorldPose();
+    *pose++ = p.Pos().X();
+    *pose++ = p.Pos().Y();
+    *pose++ = p.Pos().Z();
+    *pose++ = p.Rot().W();
+    *pose++ = p.Rot().X();
+    *pose++ = p.Rot().Y();
+    *pose++ = p.Rot().Z();
+
+    const ignition::math::Vector3d linear = link->WorldLinearVel();
+    const ignition::math::Vector3d angular = link->WorldAngularVel();
+    *vel++ = linear.X();
+    *vel++ = linear.Y();
+    *vel++ = linear.Z();
+    *vel++ = angular.X();
+    *vel++ = angular.Y();
+    *vel++ = angular.Z();
+  }
+
+  double *position = _obs.jointPositions.data() + _frame * _data.axisCount;
+  double *velocity = _obs.jointVelocities.data() + _frame * _data.axisCount;
+  for (auto const &joint : _data.joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+    {
+      *position++ = joint->Position(i);
+      *velocity++ = joint->GetVelocity(i);
+    }
+  }
+
+  if (!_data.observeContacts)
+    return;
+
+  uint32_t *counts = _obs.contactCounts.data() + _frame * linkCount;
+  double *forces = _obs.contactForces.data() + _frame * linkCount * 3;
+  std::fill(counts, counts + linkCount, 0u);
+  std::fill(forces, forces + linkCount * 3, 0.0);
+
+  ContactManager *manager = _data.world->Physics()->GetContactManager();
+  const unsigned int contactCount = manager->GetContactCount();
+  const std::vector<Contact *> &contacts = manager->GetContacts();
+  for (unsigned int c = 0; c < contactCount; ++c)
+  {
+    const Contact *contact = contacts[c];
+    for (int side = 0; side < 2; ++side)
+    {
+      const Collision *collision =
+          side == 0 ? contact->collision1 : contact->collision2;
+      if (!collision)
+        continue;
+
+      auto iter = _data.linkIndices.find(collision->GetLink().get());
+      if (iter == _data.linkIndices.end())
+        continue;
+
+      ignition::math::Vector3d force;
+      for (int j = 0; j < contact->count; ++j)
+      {
+        force += side == 0 ? contact->wrench[j].body1Force :
+            contact->wrench[j].body2Force;
+      }
+
+      counts[iter->second] += contact->count;
+      forces[iter->second * 3] += force.X();
+      forces[iter->second * 3 + 1] += force.Y();
+      forces[iter->second * 3 + 2] += force.Z();
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+BatchStepper::BatchStepper(WorldPtr _world)
+  : dataPtr(new BatchStepperPrivate)
+{
+  this->dataPtr->world = _world;
+}
+
+/////////////////////////////////////////////////
+BatchStepper::~BatchStepper()
+{
+}
+
+/////////////////////////////////////////////////
+int BatchStepper::AddLink(const std::string &_name)
+{
+  LinkPtr link;
+  if (this->dataPtr->world)
+  {
+    link = boost::dynamic_pointer_cast<Link>(
+        this->dataPtr->world->BaseByName(_name));
+  }
+
+  if (!link)
+  {
+    gzerr << "Unable to find link [" << _name << "]\n";
+    return -1;
+  }
+
+  const unsigned int index = this->dataPtr->links.size();
+  this->dataPtr->links.push_back(link);
+  this->dataPtr->linkIndices[link.get()] = index;
+  this->dataPtr->hasWrench.push_back(false);
+  this->dataPtr->linkForces.push_back(ignition::math::Vector3d::Zero);
+  this->dataPtr->linkTorques.push_back(ignition::math::Vector3d::Zero);
+  return index;
+}
+
+/////////////////////////////////////////////////
+int BatchStepper::AddJoint(const std::string &_name)
+{
+  JointPtr joint;
+  if (this->dataPtr->world)
+  {
+    joint = boost::dynamic_pointer_cast<Joint>(
+        this->dataPtr->world->BaseByName(_name));
+  }
+
+  if (!joint)
+  {
+    gzerr << "Unable to find joint [" << _name << "]\n";
+    return -1;
+  }
+
+  const unsigned int index = this->dataPtr->joints.size();
+  this->dataPtr->joints.push_back(joint);
+  this->dataPtr->jointOffsets.push_back(this->dataPtr->axisCount);
+  this->dataPtr->axisCount += joint->DOF();
+  this->dataPtr->hasForce.resize(this->dataPtr->axisCount, false);
+  this->dataPtr->forces.resize(this->dataPtr->axisCount, 0.0);
+  this->dataPtr->hasVelocity.resize(this->dataPtr->axisCount, false);
+  this->dataPtr->velocities.resize(this->dataPtr->axisCount, 0.0);
+  return index;
+}
+
+/////////////////////////////////////////////////
+unsigned int BatchStepper::LinkCount() const
+{
+  return this->dataPtr->links.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int BatchStepper::JointAxisCount() const
+{
+  return this->dataPtr->axisCount;
+}
+
+/////////////////////////////////////////////////
+int BatchStepper::JointOffset(const unsigned int _index) const
+{
+  if (_index >= this->dataPtr->jointOffsets.size())
+    return -1;
+  return this->dataPtr->jointOffsets[_index];
+}
+
+/////////////////////////////////////////////////
+void BatchStepper::SetObservationPeriod(const unsigned int _period)
+{
+  this->dataPtr->period = _period;
+}
+
+/////////////////////////////////////////////////
+unsigned int BatchStepper::ObservationPeriod() const
+{
+  return this->dataPtr->period;
+}
+
+/////////////////////////////////////////////////
+void BatchStepper::SetObserveContacts(const bool _observe)
+{
+  this->dataPtr->observeContacts = _observe;
+
+  // Contacts are only kept when someone listens to them
+  if (_observe && this->dataPtr->world)
+  {
+    this->dataPtr->world->Physics()->GetContactManager()->
+        SetNeverDropContacts(true);
+  }
+}
+
+/////////////////////////////////////////////////
+bool BatchStepper::ObserveContacts() const
+{
+  return this->dataPtr->observeContacts;
+}
+
+/////////////////////////////////////////////////
+void BatchStepper::ClearCommands()
+{
+  std::fill(this->dataPtr->hasForce.begin(),
+      this->dataPtr->hasForce.end(), false);
+  std::fill(this->dataPtr->hasVelocity.begin(),
+      this->dataPtr->hasVelocity.end(), false);
+  std::fill(this->dataPtr->hasWrench.begin(),
+      this->dataPtr->hasWrench.end(), false);
+}
+
+/////////////////////////////////////////////////
+bool BatchStepper::Step(const unsigned int _iterations,
+    const std::vector<BatchCommand> &_commands, BatchObservation &_obs)
+{
+  if (!this->dataPtr->world)
+  {
+    gzerr << "Unable to step a null world\n";
+    return false;
+  }
+
+  // Check the commands before changing anything
+  for (auto const &cmd : _commands)
+  {
+    if (cmd.type == BatchCommand::LINK_WRENCH)
+    {
+      if (cmd.index >= this->dataPtr->links.size())
+      {
+        gzerr << "Invalid link index [" << cmd.index << "]\n";
+        return false;
+      }
+    }
+    else if (cmd.index >= this->dataPtr->joints.size() ||
+        cmd.axis >= this->dataPtr->joints[cmd.index]->DOF())
+    {
+      gzerr << "Invalid joint index [" << cmd.index << "] or axis ["
+            << cmd.axis << "]\n";
+      return false;
+    }
+  }
+
+  this->dataPtr->commands = _commands;
+  std::stable_sort(this->dataPtr->commands.begin(),
+      this->dataPtr->commands.end(),
+      [](const BatchCommand &_a, const BatchCommand &_b)
+      {
+        return _a.iteration < _b.iteration;
+      });
+  this->dataPtr->nextCommand = 0;
+
+  // Size the buffers once for the whole batch
+  const unsigned int period = this->dataPtr->period;
+  // The last frame holds the final state, even after a partial period
+  _obs.frames = period > 0 && _iterations > 0 ?
+      (_iterations + period - 1) / period : 1;
+  const size_t linkCount = this->dataPtr->links.size();
+  _obs.iterations.resize(_obs.frames);
+  _obs.linkPoses.resize(_obs.frames * linkCount * 7);
+  _obs.linkVelocities.resize(_obs.frames * linkCount * 6);
+  _obs.jointPositions.resize(_obs.frames * this->dataPtr->axisCount);
+  _obs.jointVelocities.resize(_obs.frames * this->dataPtr->axisCount);
+  _obs.contactCounts.resize(
+      this->dataPtr->observeContacts ? _obs.frames * linkCount : 0);
+  _obs.contactForces.resize(
+      this->dataPtr->observeContacts ? _obs.frames * linkCount * 3 : 0);
+
+  if (_iterations == 0)
+  {
+    ObserveFrame(*this->dataPtr, 0, _obs);
+    return true;
+  }
+
+  BatchStepperPrivate &data = *this->dataPtr;
+  auto beforeUpdate = [&data](const unsigned int _i)
+  {
+    for (; data.nextCommand < data.commands.size() &&
+        data.commands[data.nextCommand].iteration <= _i; ++data.nextCommand)
+    {
+      const BatchCommand &cmd = data.commands[data.nextCommand];
+      if (cmd.type == BatchCommand::LINK_WRENCH)
+      {
+        data.hasWrench[cmd.index] = true;
+        data.linkForces[cmd.index] = cmd.force;
+        data.linkTorques[cmd.index] = cmd.torque;
+        continue;
+      }
+
+      const unsigned int axis = data.jointOffsets[cmd.index] + cmd.axis;
+      switch (cmd.type)
+      {
+        case BatchCommand::JOINT_FORCE:
+          data.hasForce[axis] = true;
+          data.forces[axis] = cmd.value;
+          break;
+        case BatchCommand::JOINT_VELOCITY:
+          data.hasVelocity[axis] = true;
+          data.velocities[axis] = cmd.value;
+          break;
+        case BatchCommand::JOINT_POSITION:
+          data.joints[cmd.index]->SetPosition(cmd.axis, cmd.value);
+          break;
+        default:
+          break;
+      }
+    }
+
+    // Forces are cleared by the physics engine at each iteration
+    for (unsigned int j = 0; j < data.joints.size(); ++j)
+    {
+      const JointPtr &joint = data.joints[j];
+      for (unsigned int i = 0; i < joint->DOF(); ++i)
+      {
+        const unsigned int axis = data.jointOffsets[j] + i;
+        if (data.hasForce[axis])
+          joint->SetForce(i, data.forces[axis]);
+        if (data.hasVelocity[axis])
+          joint->SetVelocity(i, data.velocities[axis]);
+      }
+    }
+
+    for (unsigned int l = 0; l < data.links.size(); ++l)
+    {
+      if (data.hasWrench[l])
+      {
+        data.links[l]->AddForce(data.linkForces[l]);
+        data.links[l]->AddTorque(data.linkTorques[l]);
+      }
+    }
+  };
+
+  auto afterUpdate = [&data, &_obs, _iterations](const unsigned int _i)
+  {
+    if (data.period > 0 && (_i + 1) % data.period == 0)
+      ObserveFrame(data, (_i + 1) / data.period - 1, _obs);
+    else if (_i + 1 == _iterations)
+      ObserveFrame(data, _obs.frames - 1, _obs);
+  };
+
+  return this->dataPtr->world->StepBatch(_iterations, beforeUpdate,
+      afterUpdate);
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BATCHSTEPPER_HH_
+#define GAZEBO_PHYSICS_BATCHSTEPPER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class BatchStepperPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class BatchCommand BatchStepper.hh physics/physics.hh
+    /// \brief A command applied by BatchStepper at an iteration of a batch.
+    class GZ_PHYSICS_VISIBLE BatchCommand
+    {
+      /// \brief Type of command.
+      public: enum Type
+      {
+        /// \brief Force or torque of a joint axis, applied at every
+        /// iteration until another force command for the axis.
+        JOINT_FORCE,
+
+        /// \brief Velocity of a joint axis, applied at every iteration
+        /// until another velocity command for the axis.
+        JOINT_VELOCITY,
+
+        /// \brief Position of a joint axis, applied once.
+        JOINT_POSITION,
+
+        /// \brief Force and torque on a link, in the world frame, applied at
+        /// every iteration until another wrench command for the link.
+        LINK_WRENCH
+      };
+
+      /// \brief Type of command.
+      public: Type type = JOINT_FORCE;
+
+      /// \brief Index of the iteration in the batch at which the command
+      /// starts, 0 for the first iteration.
+      public: unsigned int iteration = 0;
+
+      /// \brief Index of the joint returned by BatchStepper::AddJoint, or of
+      /// the link returned by BatchStepper::AddLink.
+      public: unsigned int index = 0;
+
+      /// \brief Joint axis.
+      public: unsigned int axis = 0;
+
+      /// \brief Force, velocity or position of the joint axis.
+      public: double value = 0;
+
+      /// \brief Force on the link.
+      public: ignition::math::Vector3d force;
+
+      /// \brief Torque on the link.
+      public: ignition::math::Vector3d torque;
+    };
+
+    /// \class BatchObservation BatchStepper.hh physics/physics.hh
+    /// \brief Dense observation buffers filled by BatchStepper. The buffers
+    /// hold one block per observed frame, in order, and are reused from one
+    /// batch to the next.
+    class GZ_PHYSICS_VISIBLE BatchObservation
+    {
+      /// \brief Number of observed frames.
+      public: unsigned int frames = 0;
+
+      /// \brief World iteration count of each frame.
+      public: std::vector<uint64_t> iterations;
+
+      /// \brief World pose of each link, 7 values per link and frame:
+      /// x y z qw qx qy qz.
+      public: std::vector<double> linkPoses;
+
+      /// \brief World velocity of each link, 6 values per link and frame:
+      /// linear x y z, then angular x y z.
+      public: std::vector<double> linkVelocities;
+
+      /// \brief Position of each joint axis, 1 value per axis and frame.
+      public: std::vector<double> jointPositions;
+
+      /// \brief Velocity of each joint axis, 1 value per axis and frame.
+      public: std::vector<double> jointVelocities;
+
+      /// \brief Number of contact points of each link, 1 value per link and
+      /// frame. Only filled when contacts are observed.
+      public: std::vector<uint32_t> contactCounts;
+
+      /// \brief Sum of the contact forces on each link, as reported in
+      /// physics::Contact, 3 values per link and frame. Only filled when
+      /// contacts are observed.
+      public: std::vector<double> contactForces;
+    };
+
+    /// \class BatchStepper BatchStepper.hh physics/physics.hh
+    /// \brief Steps a world in batches of iterations, applies commands at
+    /// given iterations and copies the state of a set of links and joints
+    /// into dense buffers, without using transport. It is meant for
+    /// programs which control the simulation in lockstep, for example
+    /// learning agents running in a server plugin or in a program which
+    /// embeds the server with gazebo::setupServer.
+    ///
+    /// \code
+    ///   physics::BatchStepper stepper(world);
+    ///   int arm = stepper.AddJoint("robot::arm_joint");
+    ///   std::vector<physics::BatchCommand> commands(1);
+    ///   commands[0].index = arm;
+    ///   commands[0].value = 2.0;
+    ///   physics::BatchObservation obs;
+    ///   stepper.Step(100, commands, obs);
+    /// \endcode
+    /// \sa World::StepBatch
+    class GZ_PHYSICS_VISIBLE BatchStepper
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World to step.
+      public: explicit BatchStepper(WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~BatchStepper();
+
+      /// \brief Add a link to the observed and commanded links.
+      /// \param[in] _name Scoped name of the link.
+      /// \return Index of the link, -1 if the link doesn't exist.
+      public: int AddLink(const std::string &_name);
+
+      /// \brief Add a joint to the observed and commanded joints. Every
+      /// axis of the joint is observed.
+      /// \param[in] _name Scoped name of the joint.
+      /// \return Index of the joint, -1 if the joint doesn't exist.
+      public: int AddJoint(const std::string &_name);
+
+      /// \brief Get the number of observed links.
+      /// \return Number of links.
+      public: unsigned int LinkCount() const;
+
+      /// \brief Get the number of observed joint axes, which is the number
+      /// of joint values per frame.
+      /// \return Number of joint axes.
+      public: unsigned int JointAxisCount() const;
+
+      /// \brief Get the index of the first value of a joint in the joint
+      /// buffers of a frame.
+      /// \param[in] _index Index of the joint returned by AddJoint.
+      /// \return Offset of the joint, -1 if the index is invalid.
+      public: int JointOffset(const unsigned int _index) const;
+
+      /// \brief Set the number of iterations between two observed frames.
+      /// The state at the end of each batch is always observed, in the
+      /// last frame.
+      /// \param[in] _period Number of iterations, 0 to only observe the
+      /// state at the end of each batch.
+      public: void SetObservationPeriod(const unsigned int _period);
+
+      /// \brief Get the number of iterations between two observed frames.
+      /// \return Number of iterations, 0 if only the end of each batch is
+      /// observed.
+      public: unsigned int ObservationPeriod() const;
+
+      /// \brief Observe the contacts of the links. Contacts are then kept
+      /// by the contact manager even without subscribers.
+      /// \param[in] _observe True to observe the contacts.
+      public: void SetObserveContacts(const bool _observe);
+
+      /// \brief Whether contacts are observed.
+      /// \return True if contacts are observed.
+      public: bool ObserveContacts() const;
+
+      /// \brief Stop applying the commands held from previous batches.
+      public: void ClearCommands();
+
+      /// \brief Step the world.
+      /// \param[in] _iterations Number of iterations.
+      /// \param[in] _commands Commands, applied before the iteration they
+      /// are given for. Commands for an iteration after the batch are
+      /// ignored.
+      /// \param[out] _obs Observations of the batch. With 0 iterations,
+      /// holds the current state.
+      /// \return False if a command is invalid or if the world couldn't be
+      /// stepped.
+      /// \sa World::StepBatch
+      public: bool Step(const unsigned int _iterations,
+                  const std::vector<BatchCommand> &_commands,
+                  BatchObservation &_obs);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<BatchStepperPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
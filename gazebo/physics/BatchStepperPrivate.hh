@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BATCHSTEPPERPRIVATE_HH_
+#define GAZEBO_PHYSICS_BATCHSTEPPERPRIVATE_HH_
+
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/BatchStepper.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Private data for BatchStepper.
+    class BatchStepperPrivate
+    {
+      /// \brief World to step.
+      public: WorldPtr world;
+
+      /// \brief Observed links.
+      public: Link_V links;
+
+      /// \brief Index of the observed links, to map contacts to links.
+      public: std::unordered_map<const Link *, unsigned int> linkIndices;
+
+      /// \brief Observed joints.
+      public: Joint_V joints;
+
+      /// \brief Offset of the first axis of each joint in the joint values
+      /// of a frame.
+      public: std::vector<unsigned int> jointOffsets;
+
+      /// \brief Number of observed joint axes.
+      public: unsigned int axisCount = 0;
+
+      /// \brief Number of iterations between two observed frames, 0 to only
+      /// observe the end of a batch.
+      public: unsigned int period = 0;
+
+      /// \brief True to observe contacts.
+      public: bool observeContacts = false;
+
+      /// \brief Commands of the current batch, sorted by iteration.
+      public: std::vector<BatchCommand> commands;
+
+      /// \brief Index of the next command to apply.
+      public: unsigned int nextCommand = 0;
+
+      /// \brief True for the joint axes with a held force.
+      public: std::vector<bool> hasForce;
+
+      /// \brief Held force of each joint axis.
+      public: std::vector<double> forces;
+
+      /// \brief True for the joint axes with a held velocity.
+      public: std::vector<bool> hasVelocity;
+
+      /// \brief Held velocity of each joint axis.
+      public: std::vector<double> velocities;
+
+      /// \brief True for the links with a held wrench.
+      public: std::vector<bool> hasWrench;
+
+      /// \brief Held force on each link.
+      public: std::vector<ignition::math::Vector3d> linkForces;
+
+      /// \brief Held torque on each link.
+      public: std::vector<ignition::math::Vector3d> linkTorques;
+    };
+  }
+}
+#endif
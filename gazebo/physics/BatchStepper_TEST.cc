@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <vector>
+
+#include "gazebo/physics/BatchStepper.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class BatchStepperTest : public ServerFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(BatchStepperTest, Observations)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  this->SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 2));
+  this->WaitUntilEntitySpawn("box", 100, 100);
+  ASSERT_TRUE(world->ModelByName("box") != nullptr);
+
+  physics::BatchStepper stepper(world);
+  EXPECT_EQ(-1, stepper.AddLink("missing::link"));
+  EXPECT_EQ(-1, stepper.AddJoint("missing::joint"));
+  EXPECT_EQ(0, stepper.AddLink("box::link"));
+  EXPECT_EQ(1u, stepper.LinkCount());
+  EXPECT_EQ(0u, stepper.JointAxisCount());
+
+  stepper.SetObservationPeriod(100);
+  stepper.SetObserveContacts(true);
+
+  // The box falls on the ground
+  physics::BatchObservation obs;
+  uint64_t iterations = world->Iterations();
+  std::vector<physics::BatchCommand> commands;
+  ASSERT_TRUE(stepper.Step(2000, commands, obs));
+  EXPECT_EQ(iterations + 2000, world->Iterations());
+  EXPECT_TRUE(world->IsPaused());
+
+  ASSERT_EQ(20u, obs.frames);
+  ASSERT_EQ(20u, obs.iterations.size());
+  ASSERT_EQ(20u * 7, obs.linkPoses.size());
+  ASSERT_EQ(20u * 6, obs.linkVelocities.size());
+  ASSERT_EQ(20u, obs.contactCounts.size());
+  EXPECT_EQ(iterations + 100, obs.iterations[0]);
+  EXPECT_EQ(iterations + 2000, obs.iterations[19]);
+  EXPECT_LT(obs.linkPoses[2], 2.0);
+  EXPECT_LT(obs.linkVelocities[2], 0.0);
+  EXPECT_NEAR(obs.linkPoses[19 * 7 + 2], 0.5, 0.01);
+  EXPECT_NEAR(obs.linkPoses[19 * 7 + 3], 1.0, 1e-3);
+  EXPECT_EQ(0u, obs.contactCounts[0]);
+  EXPECT_GT(obs.contactCounts[19], 0u);
+
+  // A partial last period still observes the final state
+  iterations = world->Iterations();
+  ASSERT_TRUE(stepper.Step(250, commands, obs));
+  ASSERT_EQ(3u, obs.frames);
+  ASSERT_EQ(3u, obs.iterations.size());
+  ASSERT_EQ(3u * 7, obs.linkPoses.size());
+  EXPECT_EQ(iterations + 100, obs.iterations[0]);
+  EXPECT_EQ(iterations + 200, obs.iterations[1]);
+  EXPECT_EQ(iterations + 250, obs.iterations[2]);
+
+  // Fewer iterations than the period observe a single frame
+  iterations = world->Iterations();
+  ASSERT_TRUE(stepper.Step(50, commands, obs));
+  ASSERT_EQ(1u, obs.frames);
+  EXPECT_EQ(iterations + 50, obs.iterations[0]);
+
+  // An upward force lifts the box from the 10th iteration on
+  physics::BatchCommand lift;
+  lift.type = physics::BatchCommand::LINK_WRENCH;
+  lift.iteration = 10;
+  lift.force.Set(0, 0, 100);
+  commands.push_back(lift);
+  stepper.SetObservationPeriod(0);
+  ASSERT_TRUE(stepper.Step(500, commands, obs));
+  ASSERT_EQ(1u, obs.frames);
+  EXPECT_GT(obs.linkPoses[2], 1.0);
+
+  // The wrench is held until it is cleared
+  const double z = obs.linkPoses[2];
+  commands.clear();
+  ASSERT_TRUE(stepper.Step(100, commands, obs));
+  EXPECT_GT(obs.linkPoses[2], z);
+  stepper.ClearCommands();
+
+  // Invalid commands don't step the world
+  iterations = world->Iterations();
+  lift.index = 1;
+  commands.push_back(lift);
+  EXPECT_FALSE(stepper.Step(100, commands, obs));
+  EXPECT_EQ(iterations, world->Iterations());
+
+  // Without iterations, the current state is observed
+  commands.clear();
+  ASSERT_TRUE(stepper.Step(0, commands, obs));
+  EXPECT_EQ(iterations, obs.iterations[0]);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BatchStepperTest, JointCommands)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  world->SetGravity(ignition::math::Vector3d::Zero);
+
+  std::ostringstream sdfStr;
+  sdfStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='arm'>"
+    << "<pose>0 0 1 0 0 0</pose>"
+    << "<link name='base'><inertial><mass>1</mass></inertial></link>"
+    << "<link name='upper'><inertial><mass>1</mass></inertial></link>"
+    << "<joint name='fixed' type='fixed'>"
+    << "<parent>world</parent><child>base</child></joint>"
+    << "<joint name='elbow' type='revolute'>"
+    << "<parent>base</parent><child>upper</child>"
+    << "<axis><xyz>0 0 1</xyz></axis></joint>"
+    << "</model></sdf>";
+  this->SpawnSDF(sdfStr.str());
+  this->WaitUntilEntitySpawn("arm", 100, 100);
+  ASSERT_TRUE(world->ModelByName("arm") != nullptr);
+
+  physics::BatchStepper stepper(world);
+  EXPECT_EQ(0, stepper.AddJoint("arm::elbow"));
+  EXPECT_EQ(1u, stepper.JointAxisCount());
+  EXPECT_EQ(0, stepper.JointOffset(0));
+  EXPECT_EQ(-1, stepper.JointOffset(1));
+
+  // Move to a position, then hold a velocity
+  std::vector<physics::BatchCommand> commands(2);
+  commands[0].type = physics::BatchCommand::JOINT_POSITION;
+  commands[0].value = 0.5;
+  commands[1].type = physics::BatchCommand::JOINT_VELOCITY;
+  commands[1].iteration = 1;
+  commands[1].value = 1.0;
+
+  physics::BatchObservation obs;
+  stepper.SetObservationPeriod(1);
+  ASSERT_TRUE(stepper.Step(1000, commands, obs));
+  ASSERT_EQ(1000u, obs.frames);
+  ASSERT_EQ(1000u, obs.jointPositions.size());
+  EXPECT_NEAR(obs.jointPositions[0], 0.5, 1e-3);
+  EXPECT_NEAR(obs.jointVelocities[999], 1.0, 1e-3);
+  const double stepSize = world->Physics()->GetMaxStepSize();
+  EXPECT_NEAR(obs.jointPositions[999], 0.5 + 999 * stepSize, 1e-2);
+
+  // The commands of a new batch replace the held commands
+  commands[0].value = 0.0;
+  commands[1].value = -1.0;
+  ASSERT_TRUE(stepper.Step(1000, commands, obs));
+  EXPECT_NEAR(obs.jointPositions[999], -999 * stepSize, 1e-2);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,650 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <unordered_map>
+
+#include <ignition/math/Plane.hh>
+
+#include "gazebo/physics/BoundingBoxTree.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief A node of the tree.
+struct BoundingBoxTreeNode
+{
+  /// \brief Minimum corner of the enlarged box.
+  ignition::math::Vector3d min;
+
+  /// \brief Maximum corner of the enlarged box.
+  ignition::math::Vector3d max;
+
+  /// \brief Parent node, or next free node when the node is free.
+  int parent = -1;
+
+  /// \brief First child, -1 for a leaf.
+  int child1 = -1;
+
+  /// \brief Second child, -1 for a leaf.
+  int child2 = -1;
+
+  /// \brief Height of the subtree, 0 for a leaf, -1 for a free node.
+  int height = -1;
+
+  /// \brief Id of the object of a leaf.
+  uint32_t id = 0;
+};
+
+/// \brief An object of the tree.
+struct BoundingBoxTreeObject
+{
+  /// \brief Leaf of the object, -1 if its box can't be placed in the tree.
+  int node = -1;
+
+  /// \brief Box the object was updated with.
+  ignition::math::AxisAlignedBox box;
+};
+
+/// \brief Private data for the BoundingBoxTree class.
+class gazebo::physics::BoundingBoxTreePrivate
+{
+  /// \brief Get a free node.
+  /// \return Index of the node.
+  public: int Allocate();
+
+  /// \brief Return a node to the free list.
+  /// \param[in] _node Index of the node.
+  public: void Free(const int _node);
+
+  /// \brief Insert a leaf in the tree.
+  /// \param[in] _leaf Index of the leaf.
+  public: void Insert(const int _leaf);
+
+  /// \brief Remove a leaf from the tree, without freeing it.
+  /// \param[in] _leaf Index of the leaf.
+  public: void Remove(const int _leaf);
+
+  /// \brief Rotate a subtree if its children are unbalanced.
+  /// \param[in] _node Index of the root of the subtree.
+  /// \return Index of the new root of the subtree.
+  public: int Balance(const int _node);
+
+  /// \brief Set the box and height of a node from its children.
+  /// \param[in] _node Index of the node.
+  public: void Refit(const int _node);
+
+  /// \brief Collect the objects of the leaves accepted by a test, and the
+  /// objects outside the tree.
+  /// \param[in] _test Test of the box of a node, given its minimum and
+  /// maximum corners.
+  /// \param[out] _ids Ids of the objects.
+  public: template<typename Test>
+          void Collect(const Test &_test, std::vector<uint32_t> &_ids) const;
+
+  /// \brief Get the surface area of a box.
+  /// \param[in] _min Minimum corner.
+  /// \param[in] _max Maximum corner.
+  /// \return Surface area.
+  public: static double Area(const ignition::math::Vector3d &_min,
+              const ignition::math::Vector3d &_max);
+
+  /// \brief Nodes, used or free.
+  public: std::vector<BoundingBoxTreeNode> nodes;
+
+  /// \brief Root node, -1 for an empty tree.
+  public: int root = -1;
+
+  /// \brief First free node, -1 if there are none.
+  public: int freeList = -1;
+
+  /// \brief Objects, by id.
+  public: std::unordered_map<uint32_t, BoundingBoxTreeObject> objects;
+
+  /// \brief Ids of the objects outside the tree.
+  public: std::set<uint32_t> unbounded;
+
+  /// \brief Distance by which the boxes are enlarged.
+  public: double margin = 0.1;
+
+  /// \brief Stack used by the queries.
+  public: mutable std::vector<int> stack;
+};
+
+/////////////////////////////////////////////////
+int BoundingBoxTreePrivate::Allocate()
+{
+  int node;
+  if (this->freeList == -1)
+  {
+    node = static_cast<int>(this->nodes.size());
+    this->nodes.emplace_back();
+  }
+  else
+  {
+    node = this->freeList;
+    this->freeList = this->nodes[node].parent;
+  }
+
+  BoundingBoxTreeNode &n = this->nodes[node];
+  n.parent = -1;
+  n.child1 = -1;
+  n.child2 = -1;
+  n.height = 0;
+  return node;
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTreePrivate::Free(const int _node)
+{
+  this->nodes[_node].parent = this->freeList;
+  this->nodes[_node].height = -1;
+  this->freeList = _node;
+}
+
+/////////////////////////////////////////////////
+double BoundingBoxTreePrivate::Area(const ignition::math::Vector3d &_min,
+    const ignition::math::Vector3d &_max)
+{
+  const ignition::math::Vector3d size = _max - _min;
+  return 2.0 * (size.X() * size.Y() + size.Y() * size.Z() +
+      size.Z() * size.X());
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTreePrivate::Refit(const int _node)
+{
+  BoundingBoxTreeNode &n = this->nodes[_node];
+  const BoundingBoxTreeNode &c1 = this->nodes[n.child1];
+  const BoundingBoxTreeNode &c2 = this->nodes[n.child2];
+  n.min = c1.min;
+  n.min.Min(c2.min);
+  n.max = c1.max;
+  n.max.Max(c2.max);
+  n.height = 1 + std::max(c1.height, c2.height);
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTreePrivate::Insert(const int _leaf)
+{
+  if (this->root == -1)
+  {
+    this->root = _leaf;
+    this->nodes[_leaf].parent = -1;
+    return;
+  }
+
+  const ignition::math::Vector3d leafMin = this->nodes[_leaf].min;
+  const ignition::math::Vector3d leafMax = this->nodes[_leaf].max;
+
+  // Find the sibling for which adding the leaf increases the area of the
+  // tree the least
+  int index = this->root;
+  while (this->nodes[index].child1 != -1)
+  {
+    const BoundingBoxTreeNode &n = this->nodes[index];
+
+    ignition::math::Vector3d min = n.min;
+    min.Min(leafMin);
+    ignition::math::Vector3d max = n.max;
+    max.Max(leafMax);
+    const double area = Area(n.min, n.max);
+    const double combinedArea = Area(min, max);
+
+    // Cost of a new parent for this node and the leaf
+    const double cost = 2.0 * combinedArea;
+
+    // Cost of pushing the leaf further down the tree
+    const double inheritanceCost = 2.0 * (combinedArea - area);
+
+    double childCost[2];
+    const int children[2] = {n.child1, n.child2};
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      const BoundingBoxTreeNode &child = this->nodes[children[i]];
+      ignition::math::Vector3d childMin = child.min;
+      childMin.Min(leafMin);
+      ignition::math::Vector3d childMax = child.max;
+      childMax.Max(leafMax);
+      childCost[i] = Area(childMin, childMax) + inheritanceCost;
+      if (child.child1 != -1)
+        childCost[i] -= Area(child.min, child.max);
+    }
+
+    if (cost < childCost[0] && cost < childCost[1])
+      break;
+
+    index = childCost[0] < childCost[1] ? children[0] : children[1];
+  }
+
+  const int sibling = index;
+  const int oldParent = this->nodes[sibling].parent;
+  const int newParent = this->Allocate();
+
+  BoundingBoxTreeNode &p = this->nodes[newParent];
+  p.parent = oldParent;
+  p.child1 = sibling;
+  p.child2 = _leaf;
+  this->nodes[sibling].parent = newParent;
+  this->nodes[_leaf].parent = newParent;
+  this->Refit(newParent);
+
+  if (oldParent == -1)
+    this->root = newParent;
+  else if (this->nodes[oldParent].child1 == sibling)
+    this->nodes[oldParent].child1 = newParent;
+  else
+    this->nodes[oldParent].child2 = newParent;
+
+  // Fix the boxes and heights of the ancestors
+  index = this->nodes[_leaf].parent;
+  while (index != -1)
+  {
+    index = this->Balance(index);
+    this->Refit(index);
+    index = this->nodes[index].parent;
+  }
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTreePrivate::Remove(const int _leaf)
+{
+  if (_leaf == this->root)
+  {
+    this->root = -1;
+    return;
+  }
+
+  const int parent = this->nodes[_leaf].parent;
+  const int grandParent = this->nodes[parent].parent;
+  const int sibling = this->nodes[parent].child1 == _leaf ?
+      this->nodes[parent].child2 : this->nodes[parent].child1;
+
+  // The sibling takes the place of the parent
+  this->nodes[sibling].parent = grandParent;
+  this->Free(parent);
+  this->nodes[_leaf].parent = -1;
+
+  if (grandParent == -1)
+  {
+    this->root = sibling;
+    return;
+  }
+
+  if (this->nodes[grandParent].child1 == parent)
+    this->nodes[grandParent].child1 = sibling;
+  else
+    this->nodes[grandParent].child2 = sibling;
+
+  int index = grandParent;
+  while (index != -1)
+  {
+    index = this->Balance(index);
+    this->Refit(index);
+    index = this->nodes[index].parent;
+  }
+}
+
+/////////////////////////////////////////////////
+int BoundingBoxTreePrivate::Balance(const int _node)
+{
+  const int iA = _node;
+  if (this->nodes[iA].child1 == -1 || this->nodes[iA].height < 2)
+    return iA;
+
+  const int iB = this->nodes[iA].child1;
+  const int iC = this->nodes[iA].child2;
+  const int balance = this->nodes[iC].height - this->nodes[iB].height;
+
+  // Rotate the higher child up
+  int iUp, iSide;
+  if (balance > 1)
+  {
+    iUp = iC;
+    iSide = iB;
+  }
+  else if (balance < -1)
+  {
+    iUp = iB;
+    iSide = iC;
+  }
+  else
+    return iA;
+
+  const int iF = this->nodes[iUp].child1;
+  const int iG = this->nodes[iUp].child2;
+
+  // The higher child replaces the node, which becomes its first child
+  this->nodes[iUp].child1 = iA;
+  this->nodes[iUp].parent = this->nodes[iA].parent;
+  this->nodes[iA].parent = iUp;
+
+  const int parent = this->nodes[iUp].parent;
+  if (parent == -1)
+    this->root = iUp;
+  else if (this->nodes[parent].child1 == iA)
+    this->nodes[parent].child1 = iUp;
+  else
+    this->nodes[parent].child2 = iUp;
+
+  // The higher grandchild stays with the rotated child, the other one
+  // moves to the node
+  int iKeep = iF;
+  int iMove = iG;
+  if (this->nodes[iF].height <= this->nodes[iG].height)
+    std::swap(iKeep, iMove);
+
+  this->nodes[iUp].child2 = iKeep;
+  this->nodes[iA].child1 = iSide;
+  this->nodes[iA].child2 = iMove;
+  this->nodes[iMove].parent = iA;
+
+  this->Refit(iA);
+  this->Refit(iUp);
+  return iUp;
+}
+
+/////////////////////////////////////////////////
+template<typename Test>
+void BoundingBoxTreePrivate::Collect(const Test &_test,
+    std::vector<uint32_t> &_ids) const
+{
+  if (this->root != -1)
+  {
+    this->stack.clear();
+    this->stack.push_back(this->root);
+    while (!this->stack.empty())
+    {
+      const BoundingBoxTreeNode &n = this->nodes[this->stack.back()];
+      this->stack.pop_back();
+
+      if (!_test(n.min, n.max))
+        continue;
+
+      if (n.child1 == -1)
+      {
+        _ids.push_back(n.id);
+      }
+      else
+      {
+        this->stack.push_back(n.child1);
+        this->stack.push_back(n.child2);
+      }
+    }
+  }
+
+  _ids.insert(_ids.end(), this->unbounded.begin(), this->unbounded.end());
+}
+
+/////////////////////////////////////////////////
+BoundingBoxTree::BoundingBoxTree(const double _margin)
+  : dataPtr(new BoundingBoxTreePrivate)
+{
+  this->SetMargin(_margin);
+}
+
+/////////////////////////////////////////////////
+BoundingBoxTree::~BoundingBoxTree()
+{
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTree::SetMargin(const double _margin)
+{
+  this->dataPtr->margin = std::max(0.0, _margin);
+}
+
+/////////////////////////////////////////////////
+double BoundingBoxTree::Margin() const
+{
+  return this->dataPtr->margin;
+}
+
+/////////////////////////////////////////////////
+bool BoundingBoxTree::Update(const uint32_t _id,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  const bool valid = Valid(_box);
+
+  auto iter = this->dataPtr->objects.find(_id);
+  if (iter != this->dataPtr->objects.end())
+  {
+    BoundingBoxTreeObject &object = iter->second;
+    object.box = _box;
+
+    if (object.node == -1)
+    {
+      if (!valid)
+        return false;
+      this->dataPtr->unbounded.erase(_id);
+    }
+    else
+    {
+      // Nothing to do while the object stays within its enlarged box
+      const BoundingBoxTreeNode &n = this->dataPtr->nodes[object.node];
+      if (valid &&
+          n.min.X() <= _box.Min().X() && n.min.Y() <= _box.Min().Y() &&
+          n.min.Z() <= _box.Min().Z() && n.max.X() >= _box.Max().X() &&
+          n.max.Y() >= _box.Max().Y() && n.max.Z() >= _box.Max().Z())
+      {
+        return false;
+      }
+
+      this->dataPtr->Remove(object.node);
+      if (!valid)
+      {
+        this->dataPtr->Free(object.node);
+        object.node = -1;
+        this->dataPtr->unbounded.insert(_id);
+        return true;
+      }
+    }
+  }
+  else
+  {
+    BoundingBoxTreeObject object;
+    object.box = _box;
+    iter = this->dataPtr->objects.emplace(_id, object).first;
+    if (!valid)
+    {
+      this->dataPtr->unbounded.insert(_id);
+      return true;
+    }
+  }
+
+  BoundingBoxTreeObject &object = iter->second;
+  if (object.node == -1)
+  {
+    object.node = this->dataPtr->Allocate();
+    this->dataPtr->nodes[object.node].id = _id;
+  }
+
+  const ignition::math::Vector3d margin(this->dataPtr->margin,
+      this->dataPtr->margin, this->dataPtr->margin);
+  BoundingBoxTreeNode &n = this->dataPtr->nodes[object.node];
+  n.min = _box.Min() - margin;
+  n.max = _box.Max() + margin;
+  this->dataPtr->Insert(object.node);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BoundingBoxTree::Remove(const uint32_t _id)
+{
+  auto iter = this->dataPtr->objects.find(_id);
+  if (iter == this->dataPtr->objects.end())
+    return false;
+
+  if (iter->second.node == -1)
+  {
+    this->dataPtr->unbounded.erase(_id);
+  }
+  else
+  {
+    this->dataPtr->Remove(iter->second.node);
+    this->dataPtr->Free(iter->second.node);
+  }
+
+  this->dataPtr->objects.erase(iter);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BoundingBoxTree::Has(const uint32_t _id) const
+{
+  return this->dataPtr->objects.find(_id) != this->dataPtr->objects.end();
+}
+
+/////////////////////////////////////////////////
+bool BoundingBoxTree::Box(const uint32_t _id,
+    ignition::math::AxisAlignedBox &_box) const
+{
+  auto iter = this->dataPtr->objects.find(_id);
+  if (iter == this->dataPtr->objects.end())
+    return false;
+
+  _box = iter->second.box;
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::vector<uint32_t> BoundingBoxTree::Ids() const
+{
+  std::vector<uint32_t> ids;
+  ids.reserve(this->dataPtr->objects.size());
+  for (auto const &object : this->dataPtr->objects)
+    ids.push_back(object.first);
+  return ids;
+}
+
+/////////////////////////////////////////////////
+unsigned int BoundingBoxTree::Size() const
+{
+  return this->dataPtr->objects.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int BoundingBoxTree::Height() const
+{
+  if (this->dataPtr->root == -1)
+    return 0;
+  return this->dataPtr->nodes[this->dataPtr->root].height + 1;
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTree::Clear()
+{
+  this->dataPtr->nodes.clear();
+  this->dataPtr->root = -1;
+  this->dataPtr->freeList = -1;
+  this->dataPtr->objects.clear();
+  this->dataPtr->unbounded.clear();
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTree::Query(const ignition::math::Frustum &_frustum,
+    std::vector<uint32_t> &_ids) const
+{
+  // A box is outside the frustum if it is behind one of its planes, which
+  // is the first test of Frustum::Contains
+  ignition::math::Planed planes[6];
+  for (int i = 0; i < 6; ++i)
+  {
+    planes[i] = _frustum.Plane(
+        static_cast<ignition::math::FrustumPlane>(i));
+  }
+
+  this->dataPtr->Collect(
+      [&planes](const ignition::math::Vector3d &_min,
+                const ignition::math::Vector3d &_max)
+      {
+        const ignition::math::Vector3d center = (_min + _max) * 0.5;
+        const ignition::math::Vector3d extent = (_max - _min) * 0.5;
+        for (auto const &plane : planes)
+        {
+          const ignition::math::Vector3d &normal = plane.Normal();
+          const double distance = normal.Dot(center) - plane.Offset();
+          const double radius = std::abs(normal.X()) * extent.X() +
+              std::abs(normal.Y()) * extent.Y() +
+              std::abs(normal.Z()) * extent.Z();
+          if (distance < -radius)
+            return false;
+        }
+        return true;
+      }, _ids);
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTree::Query(const ignition::math::Vector3d &_center,
+    const double _radius, std::vector<uint32_t> &_ids) const
+{
+  const double radius2 = _radius * _radius;
+  this->dataPtr->Collect(
+      [&_center, radius2](const ignition::math::Vector3d &_min,
+                          const ignition::math::Vector3d &_max)
+      {
+        ignition::math::Vector3d closest = _center;
+        closest.Max(_min);
+        closest.Min(_max);
+        return (closest - _center).SquaredLength() <= radius2;
+      }, _ids);
+}
+
+/////////////////////////////////////////////////
+void BoundingBoxTree::Query(const ignition::math::AxisAlignedBox &_box,
+    std::vector<uint32_t> &_ids) const
+{
+  const ignition::math::Vector3d &min = _box.Min();
+  const ignition::math::Vector3d &max = _box.Max();
+  this->dataPtr->Collect(
+      [&min, &max](const ignition::math::Vector3d &_min,
+                   const ignition::math::Vector3d &_max)
+      {
+        return _min.X() <= max.X() && _max.X() >= min.X() &&
+               _min.Y() <= max.Y() && _max.Y() >= min.Y() &&
+               _min.Z() <= max.Z() && _max.Z() >= min.Z();
+      }, _ids);
+}
+
+/////////////////////////////////////////////////
+bool BoundingBoxTree::Valid(const ignition::math::AxisAlignedBox &_box)
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (!std::isfinite(_box.Min()[i]) || !std::isfinite(_box.Max()[i]) ||
+        _box.Min()[i] > _box.Max()[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BoundingBoxTree::Intersects(const ignition::math::AxisAlignedBox &_box,
+    const ignition::math::Vector3d &_center, const double _radius)
+{
+  if (!Valid(_box))
+    return false;
+
+  ignition::math::Vector3d closest = _center;
+  closest.Max(_box.Min());
+  closest.Min(_box.Max());
+  return (closest - _center).SquaredLength() <= _radius * _radius;
+}
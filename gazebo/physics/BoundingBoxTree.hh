@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BOUNDINGBOXTREE_HH_
+#define GAZEBO_PHYSICS_BOUNDINGBOXTREE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class BoundingBoxTreePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class BoundingBoxTree BoundingBoxTree.hh physics/physics.hh
+    /// \brief A dynamic tree of axis aligned bounding boxes, used to find
+    /// the objects overlapping a frustum, a sphere or a box without testing
+    /// every object.
+    ///
+    /// Each object is stored with its box enlarged by a margin, so that
+    /// an object moving less than the margin doesn't change the tree. The
+    /// tree is kept balanced as objects are added, moved and removed.
+    ///
+    /// Queries are conservative: they return every object whose box
+    /// overlaps the volume, and possibly objects which are only near it.
+    /// Objects with an empty or infinite box can't be placed in the tree
+    /// and are returned by every query.
+    class GZ_PHYSICS_VISIBLE BoundingBoxTree
+    {
+      /// \brief Constructor.
+      /// \param[in] _margin Distance by which the boxes are enlarged.
+      public: explicit BoundingBoxTree(const double _margin = 0.1);
+
+      /// \brief Destructor.
+      public: virtual ~BoundingBoxTree();
+
+      /// \brief Set the distance by which the boxes are enlarged. Applies to
+      /// the objects added or moved out of their box afterwards.
+      /// \param[in] _margin Margin, in meters.
+      public: void SetMargin(const double _margin);
+
+      /// \brief Get the distance by which the boxes are enlarged.
+      /// \return Margin, in meters.
+      public: double Margin() const;
+
+      /// \brief Add an object, or update the box of an object.
+      /// \param[in] _id Id of the object.
+      /// \param[in] _box Bounding box of the object.
+      /// \return True if the tree changed, false if the object stayed within
+      /// its enlarged box.
+      public: bool Update(const uint32_t _id,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Remove an object.
+      /// \param[in] _id Id of the object.
+      /// \return False if the object isn't in the tree.
+      public: bool Remove(const uint32_t _id);
+
+      /// \brief Whether an object is in the tree.
+      /// \param[in] _id Id of the object.
+      /// \return True if the object was added.
+      public: bool Has(const uint32_t _id) const;
+
+      /// \brief Get the box an object was last updated with.
+      /// \param[in] _id Id of the object.
+      /// \param[out] _box Bounding box of the object.
+      /// \return False if the object isn't in the tree.
+      public: bool Box(const uint32_t _id,
+                  ignition::math::AxisAlignedBox &_box) const;
+
+      /// \brief Get the ids of all the objects.
+      /// \return Ids, in no particular order.
+      public: std::vector<uint32_t> Ids() const;
+
+      /// \brief Get the number of objects.
+      /// \return Number of objects.
+      public: unsigned int Size() const;
+
+      /// \brief Get the height of the tree.
+      /// \return Number of levels, 0 for an empty tree.
+      public: unsigned int Height() const;
+
+      /// \brief Remove all the objects.
+      public: void Clear();
+
+      /// \brief Find the objects whose box may intersect a frustum.
+      /// \param[in] _frustum Frustum.
+      /// \param[out] _ids Ids of the objects, appended to the vector.
+      public: void Query(const ignition::math::Frustum &_frustum,
+                  std::vector<uint32_t> &_ids) const;
+
+      /// \brief Find the objects whose box may intersect a sphere.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[out] _ids Ids of the objects, appended to the vector.
+      public: void Query(const ignition::math::Vector3d &_center,
+                  const double _radius, std::vector<uint32_t> &_ids) const;
+
+      /// \brief Find the objects whose box may intersect a box.
+      /// \param[in] _box Box.
+      /// \param[out] _ids Ids of the objects, appended to the vector.
+      public: void Query(const ignition::math::AxisAlignedBox &_box,
+                  std::vector<uint32_t> &_ids) const;
+
+      /// \brief Whether a box is finite and not empty, and can be placed in
+      /// the tree.
+      /// \param[in] _box Box.
+      /// \return True if the box is valid.
+      public: static bool Valid(const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Whether a box intersects a sphere.
+      /// \param[in] _box Box.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return True if the box and the sphere intersect.
+      public: static bool Intersects(const ignition::math::AxisAlignedBox &_box,
+                  const ignition::math::Vector3d &_center,
+                  const double _radius);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<BoundingBoxTreePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/physics/BoundingBoxTree.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+class BoundingBoxTreeTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Get a random box of size up to 2 m within 50 m of the origin.
+ignition::math::AxisAlignedBox randomBox()
+{
+  ignition::math::Vector3d center(ignition::math::Rand::DblUniform(-50, 50),
+      ignition::math::Rand::DblUniform(-50, 50),
+      ignition::math::Rand::DblUniform(-50, 50));
+  ignition::math::Vector3d half(ignition::math::Rand::DblUniform(0, 1),
+      ignition::math::Rand::DblUniform(0, 1),
+      ignition::math::Rand::DblUniform(0, 1));
+  return ignition::math::AxisAlignedBox(center - half, center + half);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, UpdateRemove)
+{
+  BoundingBoxTree tree(0.5);
+  EXPECT_DOUBLE_EQ(0.5, tree.Margin());
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_EQ(0u, tree.Height());
+
+  ignition::math::AxisAlignedBox box(ignition::math::Vector3d(0, 0, 0),
+      ignition::math::Vector3d(1, 1, 1));
+  EXPECT_TRUE(tree.Update(1, box));
+  EXPECT_TRUE(tree.Has(1));
+  EXPECT_FALSE(tree.Has(2));
+  EXPECT_EQ(1u, tree.Size());
+  EXPECT_EQ(1u, tree.Height());
+
+  // Moving within the margin doesn't change the tree
+  ignition::math::AxisAlignedBox moved(ignition::math::Vector3d(0.4, 0, 0),
+      ignition::math::Vector3d(1.4, 1, 1));
+  EXPECT_FALSE(tree.Update(1, moved));
+  ignition::math::AxisAlignedBox result;
+  EXPECT_TRUE(tree.Box(1, result));
+  EXPECT_EQ(moved, result);
+
+  moved = ignition::math::AxisAlignedBox(ignition::math::Vector3d(2, 0, 0),
+      ignition::math::Vector3d(3, 1, 1));
+  EXPECT_TRUE(tree.Update(1, moved));
+
+  std::vector<uint32_t> ids;
+  tree.Query(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(2.5, 0.5, 0.5),
+      ignition::math::Vector3d(2.6, 0.6, 0.6)), ids);
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(1u, ids[0]);
+
+  ids.clear();
+  tree.Query(ignition::math::Vector3d(0, 0.5, 0.5), 1.0, ids);
+  EXPECT_TRUE(ids.empty());
+
+  // Empty boxes are kept out of the tree and returned by every query
+  ignition::math::AxisAlignedBox empty;
+  empty.Min().Set(1, 1, 1);
+  empty.Max().Set(-1, -1, -1);
+  EXPECT_FALSE(BoundingBoxTree::Valid(empty));
+  EXPECT_TRUE(tree.Update(2, empty));
+  EXPECT_TRUE(tree.Has(2));
+  EXPECT_EQ(2u, tree.Size());
+  EXPECT_EQ(1u, tree.Height());
+
+  ids.clear();
+  tree.Query(ignition::math::Vector3d(100, 100, 100), 1.0, ids);
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(2u, ids[0]);
+
+  // Until they get a valid box
+  EXPECT_TRUE(tree.Update(2, box));
+  EXPECT_EQ(2u, tree.Height());
+  ids.clear();
+  tree.Query(ignition::math::Vector3d(100, 100, 100), 1.0, ids);
+  EXPECT_TRUE(ids.empty());
+
+  EXPECT_TRUE(tree.Remove(1));
+  EXPECT_FALSE(tree.Remove(1));
+  EXPECT_FALSE(tree.Has(1));
+  EXPECT_EQ(1u, tree.Size());
+  EXPECT_EQ(1u, tree.Height());
+
+  tree.Clear();
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_EQ(0u, tree.Height());
+  EXPECT_FALSE(tree.Has(2));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoundingBoxTreeTest, Queries)
+{
+  ignition::math::Rand::Seed(42);
+
+  const unsigned int count = 2000;
+  BoundingBoxTree tree(0.2);
+  std::map<uint32_t, ignition::math::AxisAlignedBox> boxes;
+  for (uint32_t id = 0; id < count; ++id)
+  {
+    boxes[id] = randomBox();
+    tree.Update(id, boxes[id]);
+  }
+
+  // Move and remove some of the objects
+  for (uint32_t id = 0; id < count; id += 3)
+  {
+    boxes[id] = randomBox();
+    tree.Update(id, boxes[id]);
+  }
+  for (uint32_t id = 1; id < count; id += 7)
+  {
+    boxes.erase(id);
+    EXPECT_TRUE(tree.Remove(id));
+  }
+  EXPECT_EQ(boxes.size(), tree.Size());
+
+  // The tree stays balanced
+  EXPECT_LT(tree.Height(), 30u);
+
+  std::vector<uint32_t> ids = tree.Ids();
+  EXPECT_EQ(boxes.size(), ids.size());
+
+  for (unsigned int i = 0; i < 50; ++i)
+  {
+    // Every box intersecting the sphere is returned
+    ignition::math::Vector3d center(ignition::math::Rand::DblUniform(-50, 50),
+        ignition::math::Rand::DblUniform(-50, 50),
+        ignition::math::Rand::DblUniform(-50, 50));
+    const double radius = ignition::math::Rand::DblUniform(1, 20);
+
+    ids.clear();
+    tree.Query(center, radius, ids);
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids.end(), std::unique(ids.begin(), ids.end()));
+    EXPECT_LT(ids.size(), boxes.size());
+
+    for (auto const &box : boxes)
+    {
+      if (BoundingBoxTree::Intersects(box.second, center, radius))
+      {
+        EXPECT_TRUE(std::binary_search(ids.begin(), ids.end(), box.first));
+      }
+    }
+
+    // Every box in the frustum is returned
+    ignition::math::Frustum frustum(0.1, radius, IGN_DTOR(60), 1.33,
+        ignition::math::Pose3d(center, ignition::math::Quaterniond(
+        0, 0, ignition::math::Rand::DblUniform(-IGN_PI, IGN_PI))));
+
+    ids.clear();
+    tree.Query(frustum, ids);
+    std::sort(ids.begin(), ids.end());
+    EXPECT_LT(ids.size(), boxes.size());
+
+    for (auto const &box : boxes)
+    {
+      if (frustum.Contains(box.second))
+      {
+        EXPECT_TRUE(std::binary_search(ids.begin(), ids.end(), box.first));
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,693 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/weak_ptr.hpp>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/TriangleBvh.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/BoxShape.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/CylinderShape.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/MeshShape.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/PlaneShape.hh"
+#include "gazebo/physics/SphereShape.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/CollisionBvh.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Maximum number of rays traced together.
+static const unsigned int PacketSize = 64;
+
+/// \brief Distance below which the origins of rays are the same.
+static const double OriginTolerance = 1e-9;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Collision intersected by a CollisionBvh.
+    class CollisionBvhEntry
+    {
+      /// \brief The collision.
+      public: boost::weak_ptr<Collision> collision;
+
+      /// \brief Scoped name of the collision.
+      public: std::string name;
+
+      /// \brief Laser retro value of the collision.
+      public: float retro = 0;
+
+      /// \brief True if the collision belongs to a model which isn't
+      /// static.
+      public: bool dynamic = false;
+
+      /// \brief Index of the collision in the dynamic hierarchy, or -1.
+      public: int object = -1;
+
+      /// \brief Index of the collision in the primitives, or -1.
+      public: int primitive = -1;
+    };
+
+    /// \internal
+    /// \brief Sphere, cylinder or plane intersected exactly.
+    class CollisionBvhPrimitive
+    {
+      /// \brief Index of the collision.
+      public: int entry = -1;
+
+      /// \brief Shape type, one of Base::SPHERE_SHAPE,
+      /// Base::CYLINDER_SHAPE and Base::PLANE_SHAPE.
+      public: unsigned int type = 0;
+
+      /// \brief Pose of the collision in the world frame.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Radius of a sphere or a cylinder.
+      public: double radius = 0;
+
+      /// \brief Length of a cylinder.
+      public: double length = 0;
+
+      /// \brief Normal of a plane.
+      public: ignition::math::Vector3d normal;
+
+      /// \brief Distance of a plane to the origin along its normal.
+      public: double offset = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for the CollisionBvh class.
+    class CollisionBvhPrivate
+    {
+      /// \brief Build the hierarchies from the collisions of the world.
+      /// \param[in] _collisions Collisions of the world.
+      public: void Build(const Collision_V &_collisions);
+
+      /// \brief Add a collision to the hierarchies or to the primitives.
+      /// \param[in] _collision Collision.
+      public: void AddCollision(const CollisionPtr &_collision);
+
+      /// \brief Move a primitive to the pose of its collision.
+      /// \param[in] _primitive Primitive.
+      /// \param[in] _pose Pose of the collision.
+      public: static void SetPose(CollisionBvhPrimitive &_primitive,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Get the collisions of a model and of its nested models.
+      /// \param[in] _model Model.
+      /// \param[out] _collisions Collisions, appended to the vector.
+      /// \return False if a collision can't be intersected.
+      public: static bool Collisions(const ModelPtr &_model,
+                  Collision_V &_collisions);
+
+      /// \brief Find the closest primitive hit by a ray.
+      /// \param[in] _origin Start of the ray.
+      /// \param[in] _dir Direction of the ray.
+      /// \param[in] _minDist Minimum distance of the hit.
+      /// \param[in,out] _dist Maximum distance of the hit, set to the distance
+      /// of the hit.
+      /// \param[in,out] _collision Set to the index of the collision hit.
+      public: void IntersectPrimitives(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_dir, const double _minDist,
+                  double &_dist, int &_collision) const;
+
+      /// \brief World whose collisions are intersected.
+      public: WorldPtr world;
+
+      /// \brief Boxes and meshes of the static models.
+      public: common::TriangleBvh staticBvh;
+
+      /// \brief Boxes and meshes of the other models, refit at each update.
+      public: common::TriangleBvh dynamicBvh;
+
+      /// \brief Index of the collision of each object of staticBvh.
+      public: std::vector<int> staticEntries;
+
+      /// \brief Index of the collision of each object of dynamicBvh.
+      public: std::vector<int> dynamicEntries;
+
+      /// \brief Spheres, cylinders and planes.
+      public: std::vector<CollisionBvhPrimitive> primitives;
+
+      /// \brief Collisions, by index.
+      public: std::vector<CollisionBvhEntry> entries;
+
+      /// \brief Meshes made of a single submesh of a mesh.
+      public: std::vector<std::unique_ptr<common::Mesh>> subMeshes;
+
+      /// \brief Ids of the collisions, sorted.
+      public: std::vector<uint32_t> ids;
+
+      /// \brief World::StaticModelsRevision when the hierarchies were built.
+      public: uint64_t staticRevision = 0;
+
+      /// \brief World iteration of the last update.
+      public: uint32_t iterations = 0;
+
+      /// \brief True once the hierarchies were built.
+      public: bool built = false;
+
+      /// \brief True if all the collisions can be intersected.
+      public: bool supported = false;
+
+      /// \brief Protects the hierarchies.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Solve a quadratic equation a.t^2 + 2.b.t + c = 0.
+/// \param[in] _a Quadratic coefficient.
+/// \param[in] _b Half of the linear coefficient.
+/// \param[in] _c Constant coefficient.
+/// \param[out] _t1 Smallest root.
+/// \param[out] _t2 Largest root.
+/// \return False if there is no real root.
+static bool quadraticRoots(const double _a, const double _b, const double _c,
+    double &_t1, double &_t2)
+{
+  const double disc = _b * _b - _a * _c;
+  if (disc < 0 || ignition::math::equal(_a, 0.0))
+    return false;
+
+  const double sq = std::sqrt(disc);
+  _t1 = (-_b - sq) / _a;
+  _t2 = (-_b + sq) / _a;
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the distance of the intersection of a ray with a primitive.
+/// \param[in] _primitive Primitive.
+/// \param[in] _origin Start of the ray.
+/// \param[in] _dir Direction of the ray.
+/// \param[in] _minDist Minimum distance of the hit.
+/// \param[in] _maxDist Maximum distance of the hit.
+/// \param[out] _dist Distance of the hit.
+/// \return True if the primitive is hit.
+static bool intersectPrimitive(const CollisionBvhPrimitive &_primitive,
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, const double _minDist,
+    const double _maxDist, double &_dist)
+{
+  bool hit = false;
+  _dist = _maxDist;
+
+  auto keep = [&](const double _t)
+  {
+    if (_t >= _minDist && _t < _dist)
+    {
+      _dist = _t;
+      hit = true;
+    }
+  };
+
+  switch (_primitive.type)
+  {
+    case Base::SPHERE_SHAPE:
+    {
+      const ignition::math::Vector3d oc = _origin - _primitive.pose.Pos();
+      double t1, t2;
+      if (quadraticRoots(_dir.Dot(_dir), oc.Dot(_dir),
+          oc.Dot(oc) - _primitive.radius * _primitive.radius, t1, t2))
+      {
+        keep(t1);
+        keep(t2);
+      }
+      break;
+    }
+    case Base::CYLINDER_SHAPE:
+    {
+      // Intersect in the frame of the cylinder, whose axis is Z
+      const ignition::math::Vector3d o =
+          _primitive.pose.Rot().RotateVectorReverse(
+          _origin - _primitive.pose.Pos());
+      const ignition::math::Vector3d d =
+          _primitive.pose.Rot().RotateVectorReverse(_dir);
+      const double halfLength = _primitive.length * 0.5;
+      const double r2 = _primitive.radius * _primitive.radius;
+
+      double t1, t2;
+      if (quadraticRoots(d.X() * d.X() + d.Y() * d.Y(),
+          o.X() * d.X() + o.Y() * d.Y(),
+          o.X() * o.X() + o.Y() * o.Y() - r2, t1, t2))
+      {
+        if (std::abs(o.Z() + t1 * d.Z()) <= halfLength)
+          keep(t1);
+        if (std::abs(o.Z() + t2 * d.Z()) <= halfLength)
+          keep(t2);
+      }
+
+      if (!ignition::math::equal(d.Z(), 0.0))
+      {
+        for (const double z : {-halfLength, halfLength})
+        {
+          const double t = (z - o.Z()) / d.Z();
+          const double x = o.X() + t * d.X();
+          const double y = o.Y() + t * d.Y();
+          if (x * x + y * y <= r2)
+            keep(t);
+        }
+      }
+      break;
+    }
+    case Base::PLANE_SHAPE:
+    {
+      // Planes are infinite, and hit from both sides
+      const double denom = _primitive.normal.Dot(_dir);
+      if (!ignition::math::equal(denom, 0.0))
+      {
+        keep((_primitive.offset - _primitive.normal.Dot(_origin)) /
+            denom);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+
+  return hit;
+}
+
+/////////////////////////////////////////////////
+CollisionBvh::CollisionBvh(WorldPtr _world)
+: dataPtr(new CollisionBvhPrivate)
+{
+  this->dataPtr->world = _world;
+}
+
+/////////////////////////////////////////////////
+CollisionBvh::~CollisionBvh()
+{
+}
+
+/////////////////////////////////////////////////
+bool CollisionBvh::Update()
+{
+  if (!this->dataPtr->world)
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const uint32_t iterations = this->dataPtr->world->Iterations();
+  if (this->dataPtr->built && iterations == this->dataPtr->iterations)
+    return this->dataPtr->supported;
+  this->dataPtr->iterations = iterations;
+
+  const uint64_t revision = this->dataPtr->world->StaticModelsRevision();
+
+  // Acquire the mutex for avoiding race condition with the physics engine
+  boost::recursive_mutex::scoped_lock physicsLock(*(
+        this->dataPtr->world->Physics()->GetPhysicsUpdateMutex()));
+
+  Collision_V collisions;
+  bool supported = true;
+  for (auto const &model : this->dataPtr->world->Models())
+    supported = CollisionBvhPrivate::Collisions(model, collisions) && supported;
+
+  std::vector<uint32_t> ids;
+  ids.reserve(collisions.size());
+  for (auto const &collision : collisions)
+    ids.push_back(collision->GetId());
+  std::sort(ids.begin(), ids.end());
+
+  if (!this->dataPtr->built || ids != this->dataPtr->ids ||
+      revision != this->dataPtr->staticRevision ||
+      supported != this->dataPtr->supported)
+  {
+    this->dataPtr->ids.swap(ids);
+    this->dataPtr->staticRevision = revision;
+    this->dataPtr->supported = supported;
+    this->dataPtr->Build(supported ? collisions : Collision_V());
+    return supported;
+  }
+
+  if (!supported)
+    return false;
+
+  // Only the collisions of the dynamic models move
+  for (auto &entry : this->dataPtr->entries)
+  {
+    CollisionPtr collision = entry.collision.lock();
+    if (!collision)
+      continue;
+
+    entry.retro = collision->GetLaserRetro();
+    if (!entry.dynamic)
+      continue;
+
+    if (entry.object >= 0)
+    {
+      this->dataPtr->dynamicBvh.SetPose(entry.object,
+          collision->WorldPose());
+    }
+    else if (entry.primitive >= 0)
+    {
+      CollisionBvhPrivate::SetPose(
+          this->dataPtr->primitives[entry.primitive],
+          collision->WorldPose());
+    }
+  }
+  this->dataPtr->dynamicBvh.Refit();
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void CollisionBvh::Intersect(const ignition::math::Vector3d *_origins,
+    const ignition::math::Vector3d *_dirs, const unsigned int _count,
+    const double _minDist, double *_dists, int *_collisions) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  const CollisionBvhPrivate *data = this->dataPtr.get();
+
+  const unsigned int packets = (_count + PacketSize - 1) / PacketSize;
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, packets),
+      [&](const tbb::blocked_range<unsigned int> &_r)
+  {
+    int triangles[PacketSize];
+    for (unsigned int p = _r.begin(); p != _r.end(); ++p)
+    {
+      const unsigned int begin = p * PacketSize;
+      const unsigned int count = std::min(PacketSize, _count - begin);
+
+      // Rays starting at the same point are traced as a packet
+      bool packet = true;
+      for (unsigned int i = 1; i < count && packet; ++i)
+      {
+        packet = (_origins[begin + i] - _origins[begin]).Length() <
+            OriginTolerance;
+      }
+      for (unsigned int i = 0; i < count; ++i)
+        _collisions[begin + i] = -1;
+
+      const std::pair<const common::TriangleBvh *, const std::vector<int> *>
+          bvhs[2] = {{&data->staticBvh, &data->staticEntries},
+                     {&data->dynamicBvh, &data->dynamicEntries}};
+
+      for (auto const &bvh : bvhs)
+      {
+        if (bvh.first->TriangleCount() == 0)
+          continue;
+
+        if (packet)
+        {
+          bvh.first->Intersect(_origins[begin], _dirs + begin, count,
+              _minDist, _dists + begin, triangles);
+        }
+        else
+        {
+          for (unsigned int i = 0; i < count; ++i)
+          {
+            if (!bvh.first->Intersect(_origins[begin + i], _dirs[begin + i],
+                _minDist, _dists[begin + i], triangles[i]))
+            {
+              triangles[i] = -1;
+            }
+          }
+        }
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+          if (triangles[i] >= 0)
+          {
+            _collisions[begin + i] =
+                (*bvh.second)[bvh.first->Object(triangles[i])];
+          }
+        }
+      }
+
+      if (!data->primitives.empty())
+      {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+          data->IntersectPrimitives(_origins[begin + i], _dirs[begin + i],
+              _minDist, _dists[begin + i], _collisions[begin + i]);
+        }
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////
+unsigned int CollisionBvh::CollisionCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->entries.size();
+}
+
+/////////////////////////////////////////////////
+float CollisionBvh::LaserRetro(const int _index) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_index < 0 ||
+      static_cast<unsigned int>(_index) >= this->dataPtr->entries.size())
+  {
+    return 0;
+  }
+  return this->dataPtr->entries[_index].retro;
+}
+
+/////////////////////////////////////////////////
+std::string CollisionBvh::CollisionName(const int _index) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_index < 0 ||
+      static_cast<unsigned int>(_index) >= this->dataPtr->entries.size())
+  {
+    return std::string();
+  }
+  return this->dataPtr->entries[_index].name;
+}
+
+/////////////////////////////////////////////////
+void CollisionBvhPrivate::IntersectPrimitives(
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, const double _minDist,
+    double &_dist, int &_collision) const
+{
+  for (auto const &primitive : this->primitives)
+  {
+    double dist;
+    if (intersectPrimitive(primitive, _origin, _dir, _minDist, _dist, dist))
+    {
+      _dist = dist;
+      _collision = primitive.entry;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool CollisionBvhPrivate::Collisions(const ModelPtr &_model,
+    Collision_V &_collisions)
+{
+  bool supported = true;
+  for (auto const &link : _model->GetLinks())
+  {
+    for (auto const &collision : link->GetCollisions())
+    {
+      ShapePtr shape = collision->GetShape();
+      if (!shape || shape->HasType(Base::RAY_SHAPE) ||
+          shape->HasType(Base::MULTIRAY_SHAPE))
+      {
+        continue;
+      }
+
+      if (shape->HasType(Base::BOX_SHAPE) ||
+          shape->HasType(Base::SPHERE_SHAPE) ||
+          shape->HasType(Base::CYLINDER_SHAPE) ||
+          shape->HasType(Base::PLANE_SHAPE) ||
+          shape->HasType(Base::MESH_SHAPE))
+      {
+        _collisions.push_back(collision);
+      }
+      else
+      {
+        supported = false;
+      }
+    }
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    supported = Collisions(nested, _collisions) && supported;
+
+  return supported;
+}
+
+/////////////////////////////////////////////////
+void CollisionBvhPrivate::Build(const Collision_V &_collisions)
+{
+  this->staticBvh.Clear();
+  this->dynamicBvh.Clear();
+  this->staticEntries.clear();
+  this->dynamicEntries.clear();
+  this->primitives.clear();
+  this->entries.clear();
+  this->subMeshes.clear();
+
+  for (auto const &collision : _collisions)
+    this->AddCollision(collision);
+
+  this->staticBvh.Build();
+  this->dynamicBvh.Build();
+  this->built = true;
+}
+
+/////////////////////////////////////////////////
+void CollisionBvhPrivate::SetPose(CollisionBvhPrimitive &_primitive,
+    const ignition::math::Pose3d &_pose)
+{
+  _primitive.pose = _pose;
+
+  // Like ODE, the normal of a plane isn't rotated by its pose
+  if (_primitive.type == Base::PLANE_SHAPE)
+    _primitive.offset = _primitive.normal.Dot(_pose.Pos());
+}
+
+/////////////////////////////////////////////////
+void CollisionBvhPrivate::AddCollision(const CollisionPtr &_collision)
+{
+  ShapePtr shape = _collision->GetShape();
+  ModelPtr model = _collision->GetModel();
+
+  CollisionBvhEntry entry;
+  entry.collision = _collision;
+  entry.name = _collision->GetScopedName();
+  entry.retro = _collision->GetLaserRetro();
+  entry.dynamic = !model || !model->IsStatic();
+  const int index = static_cast<int>(this->entries.size());
+  const ignition::math::Pose3d pose = _collision->WorldPose();
+
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const common::Mesh *mesh = nullptr;
+  ignition::math::Vector3d scale = ignition::math::Vector3d::One;
+
+  if (shape->HasType(Base::BOX_SHAPE))
+  {
+    mesh = meshManager->GetMesh("unit_box");
+    scale = boost::static_pointer_cast<BoxShape>(shape)->Size();
+  }
+  else if (shape->HasType(Base::MESH_SHAPE))
+  {
+    msgs::Geometry msg;
+    boost::static_pointer_cast<MeshShape>(shape)->FillMsg(msg);
+
+    const std::string uri = msg.mesh().filename();
+    mesh = meshManager->GetMesh(uri);
+    if (!mesh)
+    {
+      const std::string path = common::find_file(uri);
+      if (path.empty() || path == "__default__")
+      {
+        gzerr << "Failed to find mesh file [" << uri << "]" << std::endl;
+        return;
+      }
+      mesh = meshManager->Load(path);
+    }
+    if (!mesh)
+      return;
+
+    scale = msgs::ConvertIgn(msg.mesh().scale());
+
+    if (msg.mesh().has_submesh() && !msg.mesh().submesh().empty())
+    {
+      const common::SubMesh *subMesh =
+          mesh->GetSubMesh(msg.mesh().submesh());
+      if (!subMesh)
+        return;
+
+      auto copy = new common::SubMesh(subMesh);
+      if (msg.mesh().center_submesh())
+        copy->Center(ignition::math::Vector3d::Zero);
+
+      std::unique_ptr<common::Mesh> single(new common::Mesh());
+      single->AddSubMesh(copy);
+      mesh = single.get();
+      this->subMeshes.push_back(std::move(single));
+    }
+  }
+  else
+  {
+    CollisionBvhPrimitive primitive;
+    primitive.entry = index;
+    if (shape->HasType(Base::SPHERE_SHAPE))
+    {
+      primitive.type = Base::SPHERE_SHAPE;
+      primitive.radius =
+          boost::static_pointer_cast<SphereShape>(shape)->GetRadius();
+    }
+    else if (shape->HasType(Base::CYLINDER_SHAPE))
+    {
+      auto cylinder = boost::static_pointer_cast<CylinderShape>(shape);
+      primitive.type = Base::CYLINDER_SHAPE;
+      primitive.radius = cylinder->GetRadius();
+      primitive.length = cylinder->GetLength();
+    }
+    else
+    {
+      primitive.type = Base::PLANE_SHAPE;
+      primitive.normal =
+          boost::static_pointer_cast<PlaneShape>(shape)->Normal().Normalized();
+    }
+    SetPose(primitive, pose);
+
+    entry.primitive = static_cast<int>(this->primitives.size());
+    this->primitives.push_back(primitive);
+    this->entries.push_back(entry);
+    return;
+  }
+
+  if (!mesh)
+    return;
+
+  if (entry.dynamic)
+  {
+    entry.object = static_cast<int>(this->dynamicBvh.AddMesh(*mesh, scale,
+        pose));
+    this->dynamicEntries.push_back(index);
+  }
+  else
+  {
+    this->staticBvh.AddMesh(*mesh, scale, pose);
+    this->staticEntries.push_back(index);
+  }
+  this->entries.push_back(entry);
+}
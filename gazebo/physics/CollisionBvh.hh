@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_COLLISIONBVH_HH_
+#define GAZEBO_PHYSICS_COLLISIONBVH_HH_
+
+#include <memory>
+#include <string>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class CollisionBvhPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class CollisionBvh CollisionBvh.hh physics/physics.hh
+    /// \brief Bounding volume hierarchies over the collisions of a world,
+    /// used to cast rays on the CPU without going through the collision
+    /// library of the physics engine.
+    ///
+    /// Boxes and meshes are split in triangles. The collisions of static
+    /// models are in a hierarchy built again when World::StaticModelsRevision
+    /// changes, the other collisions are in a hierarchy refit as they move.
+    /// Spheres, cylinders and planes are intersected exactly, so that the
+    /// distances match the ones of the physics engine.
+    ///
+    /// Rays are cast in packets on several threads. This class is thread
+    /// safe.
+    class GZ_PHYSICS_VISIBLE CollisionBvh
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World whose collisions are intersected.
+      public: explicit CollisionBvh(WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~CollisionBvh();
+
+      /// \brief Update the hierarchies with the collisions of the world.
+      /// They are only updated once per world iteration.
+      /// \return False if the world has heightmaps, polylines or other
+      /// collisions which can't be intersected, in which case rays must be
+      /// cast by the physics engine.
+      public: bool Update();
+
+      /// \brief Find the closest collisions hit by rays.
+      /// \param[in] _origins Start of each ray.
+      /// \param[in] _dirs Unit direction of each ray.
+      /// \param[in] _count Number of rays.
+      /// \param[in] _minDist Minimum distance of the hits.
+      /// \param[in,out] _dists Maximum distance of each hit, set to the
+      /// distance of the hits.
+      /// \param[out] _collisions Index of the collision hit by each ray, -1
+      /// if none was hit.
+      public: void Intersect(const ignition::math::Vector3d *_origins,
+                  const ignition::math::Vector3d *_dirs,
+                  const unsigned int _count, const double _minDist,
+                  double *_dists, int *_collisions) const;
+
+      /// \brief Get the number of collisions intersected.
+      /// \return Number of collisions.
+      public: unsigned int CollisionCount() const;
+
+      /// \brief Get the laser retro value of a collision, as it was at the
+      /// last update.
+      /// \param[in] _index Index of the collision.
+      /// \return Laser retro value.
+      public: float LaserRetro(const int _index) const;
+
+      /// \brief Get the scoped name of a collision.
+      /// \param[in] _index Index of the collision.
+      /// \return Scoped name, empty if the index is invalid.
+      public: std::string CollisionName(const int _index) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<CollisionBvhPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string>
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/physics/CollisionBvh.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/RayShape.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class CollisionBvhTest : public ServerFixture {};
+
+//////////////////////////////////////////////////
+/// \brief Rays cast against the hierarchy hit the same collisions at the
+/// same distances as the rays of the physics engine.
+TEST_F(CollisionBvhTest, MatchPhysics)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Shapes turned at various angles around the origin
+  this->SpawnBox("box", ignition::math::Vector3d(1, 2, 0.5),
+      ignition::math::Vector3d(3, 0, 1), ignition::math::Vector3d(0.3, 0, 0.5),
+      true);
+  this->SpawnSphere("sphere", ignition::math::Vector3d(0, 3, 1),
+      ignition::math::Vector3d::Zero);
+  this->SpawnCylinder("cylinder", ignition::math::Vector3d(-3, 0, 1),
+      ignition::math::Vector3d(0.4, 1.0, 0));
+
+  physics::CollisionBvh bvh(world);
+  EXPECT_EQ(0u, bvh.CollisionCount());
+  EXPECT_TRUE(bvh.Update());
+
+  // The ground plane, the box, the sphere and the cylinder
+  EXPECT_EQ(4u, bvh.CollisionCount());
+  EXPECT_TRUE(bvh.CollisionName(-1).empty());
+  EXPECT_TRUE(bvh.CollisionName(4).empty());
+
+  physics::RayShapePtr ray = boost::dynamic_pointer_cast<physics::RayShape>(
+      world->Physics()->CreateShape("ray", physics::CollisionPtr()));
+  ASSERT_TRUE(ray != nullptr);
+
+  ignition::math::Rand::Seed(7);
+  const ignition::math::Vector3d origin(0, 0, 1);
+  const double maxDist = 10;
+
+  std::vector<ignition::math::Vector3d> origins;
+  std::vector<ignition::math::Vector3d> dirs;
+  for (unsigned int i = 0; i < 1000; ++i)
+  {
+    origins.push_back(origin);
+    dirs.push_back(ignition::math::Vector3d(
+        ignition::math::Rand::DblUniform(-1, 1),
+        ignition::math::Rand::DblUniform(-1, 1),
+        ignition::math::Rand::DblUniform(-0.5, 0.5)).Normalize());
+  }
+
+  std::vector<double> dists(dirs.size(), maxDist);
+  std::vector<int> collisions(dirs.size());
+  bvh.Intersect(origins.data(), dirs.data(), dirs.size(), 0, dists.data(),
+      collisions.data());
+
+  unsigned int hits = 0;
+  for (unsigned int i = 0; i < dirs.size(); ++i)
+  {
+    double dist;
+    std::string name;
+    ray->SetPoints(origin, origin + dirs[i] * maxDist);
+    ray->GetIntersection(dist, name);
+
+    if (dist < maxDist)
+    {
+      ++hits;
+      EXPECT_NEAR(dist, dists[i], 1e-6) << i;
+      EXPECT_EQ(name, bvh.CollisionName(collisions[i])) << i;
+    }
+    else
+    {
+      EXPECT_EQ(-1, collisions[i]) << i;
+    }
+  }
+  EXPECT_GT(hits, 100u);
+}
+
+//////////////////////////////////////////////////
+/// \brief Rays which don't start at the same point are cast one at a time,
+/// and the hierarchy follows the dynamic models.
+TEST_F(CollisionBvhTest, MovingModels)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  this->SpawnSphere("sphere", ignition::math::Vector3d(0, 0, 1),
+      ignition::math::Vector3d::Zero);
+  physics::ModelPtr sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(sphere != nullptr);
+
+  physics::CollisionBvh bvh(world);
+  EXPECT_TRUE(bvh.Update());
+
+  // Looking down at the sphere from above, and at the ground next to it
+  const ignition::math::Vector3d origins[2] = {
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d(2, 0, 5)};
+  const ignition::math::Vector3d dirs[2] = {
+      -ignition::math::Vector3d::UnitZ, -ignition::math::Vector3d::UnitZ};
+  double dists[2] = {100, 100};
+  int collisions[2];
+  bvh.Intersect(origins, dirs, 2, 0, dists, collisions);
+  EXPECT_NEAR(3.5, dists[0], 1e-6);
+  EXPECT_NEAR(5.0, dists[1], 1e-6);
+  EXPECT_EQ("sphere::body::geom", bvh.CollisionName(collisions[0]));
+  EXPECT_EQ("ground_plane::link::collision",
+      bvh.CollisionName(collisions[1]));
+
+  // Hits closer than the minimum distance are ignored
+  dists[0] = 100;
+  bvh.Intersect(origins, dirs, 1, 4, dists, collisions);
+  EXPECT_NEAR(4.5, dists[0], 1e-6);
+
+  // Move the sphere under the second ray
+  sphere->SetWorldPose(ignition::math::Pose3d(2, 0, 1, 0, 0, 0));
+  world->Step(1);
+  EXPECT_TRUE(bvh.Update());
+
+  dists[0] = dists[1] = 100;
+  bvh.Intersect(origins, dirs, 2, 0, dists, collisions);
+  EXPECT_NEAR(5.0, dists[0], 1e-6);
+  EXPECT_NEAR(3.5, dists[1], 1e-3);
+  EXPECT_EQ("sphere::body::geom", bvh.CollisionName(collisions[1]));
+
+  // Removed models are removed from the hierarchy
+  world->RemoveModel("sphere");
+  world->Step(1);
+  EXPECT_TRUE(bvh.Update());
+  EXPECT_EQ(1u, bvh.CollisionCount());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
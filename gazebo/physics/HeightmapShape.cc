@@ -16,7 +16,10 @@
 */
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <string>
+#include <utility>
+#include <boost/filesystem.hpp>
 #include <ignition/math/Helpers.hh>
 #include <gazebo/gazebo_config.h>
 
@@ -24,14 +27,23 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Image.hh"
 #include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Events.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
+#include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/HeightmapShape.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/transport/transport.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Default distance around active links where tiles are kept.
+static const double kDefaultTileRadius = 20.0;
+
+/// \brief Sim time between two updates of the resident tiles.
+static const common::Time kTileUpdatePeriod(0.1);
 
 //////////////////////////////////////////////////
 HeightmapShape::HeightmapShape(CollisionPtr _parent)
@@ -42,12 +54,16 @@ HeightmapShape::HeightmapShape(CollisionPtr _parent)
       std::is_same<HeightType, double>::value,
       "Height field needs to be double or float");
   this->vertSize = 0;
+  this->tilingSupported = false;
+  this->tileSize = common::HeightmapTileCache::DefaultTileSize;
+  this->tileRadius = kDefaultTileRadius;
   this->AddType(Base::HEIGHTMAP_SHAPE);
 }
 
 //////////////////////////////////////////////////
 HeightmapShape::~HeightmapShape()
 {
+  this->updateConnection.reset();
   this->requestSub.reset();
   this->responsePub.reset();
   if (this->node)
@@ -245,8 +261,164 @@ void HeightmapShape::Init()
   else
     this->scale.Z() = fabs(terrainSize.Z()) / heightmapSizeZ;
 
-  // Construct the heightmap lookup table
-  this->FillHeightfield(this->heights);
+  // Serve the heights from a tile cache when paging is requested. Otherwise
+  // construct the heightmap lookup table.
+  if (this->tilingSupported && this->sdf->HasElement("use_terrain_paging") &&
+      this->sdf->Get<bool>("use_terrain_paging") && this->LoadTileCache())
+  {
+    this->updateConnection = event::Events::ConnectWorldUpdateBegin(
+        std::bind(&HeightmapShape::OnWorldUpdateBegin, this,
+          std::placeholders::_1));
+  }
+  else
+  {
+    this->FillHeightfield(this->heights);
+  }
+}
+
+//////////////////////////////////////////////////
+bool HeightmapShape::LoadTileCache()
+{
+  std::string filename = common::find_file(this->GetURI());
+  std::string cachePath = common::HeightmapTileCache::CacheFilename(filename,
+      this->subSampling, this->vertSize, this->Size(), this->scale,
+      this->tileSize);
+
+  this->tileCache.reset(new common::HeightmapTileCache());
+  if (this->tileCache->Load(cachePath) &&
+      this->tileCache->VertexCount() == this->vertSize &&
+      this->tileCache->TileSize() == this->tileSize)
+  {
+    return true;
+  }
+
+  gzmsg << "Saving heightmap tile cache to " << cachePath << std::endl;
+
+  // Sample the heightmap one strip at a time, the dense grid is never built.
+  // The rows are stored unflipped and flipped by GetHeight, so that the
+  // file is shared by every physics engine and the rendering.
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(
+      boost::filesystem::path(cachePath).parent_path(), ec);
+  if (common::HeightmapTileCache::Build(cachePath, this->vertSize,
+        this->tileSize,
+        [this](unsigned int _x, unsigned int _y, unsigned int _width,
+          unsigned int _height, std::vector<float> &_heights)
+        {
+          this->heightmapData->FillHeightMapRegion(this->subSampling,
+              this->vertSize, this->Size(), this->scale, false,
+              _x, _y, _width, _height, _heights);
+        }) &&
+      this->tileCache->Load(cachePath))
+  {
+    return true;
+  }
+
+  gzwarn << "Unable to create a heightmap tile cache, tiling is disabled."
+         << std::endl;
+  this->tileCache.reset();
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool HeightmapShape::TilingEnabled() const
+{
+  return this->tileCache != nullptr;
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::SetTileRadius(const double _radius)
+{
+  this->tileRadius = std::max(0.0, _radius);
+}
+
+//////////////////////////////////////////////////
+double HeightmapShape::TileRadius() const
+{
+  return this->tileRadius;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapShape::ResidentTileCount() const
+{
+  if (!this->tileCache)
+    return 0u;
+  return this->tileCache->ResidentTileCount();
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::UpdateTiles(
+    const std::vector<ignition::math::Vector3d> &_positions)
+{
+  if (!this->tileCache || this->vertSize < 2)
+    return;
+
+  ignition::math::Vector3d size = this->Size();
+  if (ignition::math::equal(size.X(), 0.0) ||
+      ignition::math::equal(size.Y(), 0.0))
+  {
+    return;
+  }
+
+  // The heightmap is centered on its collision.
+  ignition::math::Vector3d center = this->collisionParent->WorldPose().Pos();
+  double cellsPerMeterX = (this->vertSize - 1) / size.X();
+  double cellsPerMeterY = (this->vertSize - 1) / size.Y();
+
+  std::vector<std::pair<int, int>> centers;
+  centers.reserve(_positions.size());
+  for (auto const &pos : _positions)
+  {
+    double x = (pos.X() - center.X() + size.X() * 0.5) * cellsPerMeterX;
+    double y = (pos.Y() - center.Y() + size.Y() * 0.5) * cellsPerMeterY;
+
+    // Row 0 of the cache is the north edge, the rows are never flipped.
+    y = (this->vertSize - 1) - y;
+
+    centers.push_back(std::make_pair(
+          static_cast<int>(std::floor(x)), static_cast<int>(std::floor(y))));
+  }
+
+  unsigned int radius = static_cast<unsigned int>(std::ceil(
+        this->tileRadius * std::max(cellsPerMeterX, cellsPerMeterY)));
+  this->tileCache->UpdateResidency(centers, radius);
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::OnWorldUpdateBegin(const common::UpdateInfo &_info)
+{
+  if (!this->world || _info.worldName != this->world->Name())
+    return;
+
+  // Sim time goes backwards when the world is reset.
+  if (_info.simTime >= this->lastTileUpdate &&
+      _info.simTime - this->lastTileUpdate < kTileUpdatePeriod)
+  {
+    return;
+  }
+  this->lastTileUpdate = _info.simTime;
+
+  std::vector<ignition::math::Vector3d> positions;
+  std::function<void(const ModelPtr &)> addLinks =
+    [&positions, &addLinks](const ModelPtr &_model)
+    {
+      if (_model->IsStatic())
+        return;
+
+      for (auto const &link : _model->GetLinks())
+      {
+        if (link->GetEnabled())
+          positions.push_back(link->WorldPose().Pos());
+      }
+
+      for (auto const &nested : _model->NestedModels())
+        addLinks(nested);
+    };
+
+  for (auto const &model : this->world->Models())
+    addLinks(model);
+
+  this->UpdateTiles(positions);
 }
 
 //////////////////////////////////////////////////
@@ -294,12 +466,48 @@ void HeightmapShape::FillMsg(msgs::Geometry &_msg)
 //////////////////////////////////////////////////
 void HeightmapShape::FillHeights(msgs::Geometry &_msg) const
 {
+  auto heightmapMsg = _msg.mutable_heightmap();
+  heightmapMsg->mutable_heights()->Reserve(this->vertSize * this->vertSize);
+
+  if (this->tileCache)
+  {
+    // Copy the heights one strip of rows at a time, straight from the cache
+    // file for the tiles which aren't resident, so that a request doesn't
+    // map the whole heightmap.
+    // The message starts with the last row of the heights, which is the
+    // first row of the cache when the heights are flipped.
+    const unsigned int strip = this->tileCache->TileSize();
+    std::vector<float> region;
+    for (unsigned int y = 0; y < this->vertSize; y += strip)
+    {
+      const unsigned int rows = std::min(strip, this->vertSize - y);
+      const unsigned int first = this->flipY ? y : this->vertSize - y - rows;
+      if (!this->tileCache->FillRegion(0, first, this->vertSize, rows,
+            region))
+      {
+        gzerr << "Unable to read the heights of heightmap["
+              << this->GetURI() << "]" << std::endl;
+        heightmapMsg->clear_heights();
+        return;
+      }
+
+      for (unsigned int r = 0; r < rows; ++r)
+      {
+        auto row = region.begin() +
+            (this->flipY ? r : rows - r - 1) * this->vertSize;
+        for (auto h = row; h != row + this->vertSize; ++h)
+          heightmapMsg->add_heights(*h);
+      }
+    }
+    return;
+  }
+
   for (unsigned int y = 0; y < this->vertSize; ++y)
   {
     for (unsigned int x = 0; x < this->vertSize; ++x)
     {
-      int index = (this->vertSize - y - 1) * this->vertSize + x;
-      _msg.mutable_heightmap()->add_heights(this->heights[index]);
+      _msg.mutable_heightmap()->add_heights(
+          this->GetHeight(x, this->vertSize - y - 1));
     }
   }
 }
@@ -319,6 +527,14 @@ ignition::math::Vector2i HeightmapShape::VertexCount() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 {
+  if (this->tileCache)
+  {
+    if (_x < 0 || _y < 0 || _y >= static_cast<int>(this->vertSize))
+      return 0.0;
+    return this->tileCache->Height(_x,
+        this->flipY ? this->vertSize - _y - 1 : _y);
+  }
+
   int index =  _y * this->vertSize + _x;
   if (_x < 0 || _y < 0 || index >= static_cast<int>(this->heights.size()))
     return 0.0;
@@ -329,6 +545,9 @@ HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 {
+  if (this->tileCache)
+    return this->tileCache->MaxHeight();
+
   HeightType max = -std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
@@ -342,6 +561,9 @@ HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMinHeight() const
 {
+  if (this->tileCache)
+    return this->tileCache->MinHeight();
+
   HeightType min = std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 #define GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <ignition/transport/Node.hh>
@@ -25,7 +26,10 @@
 
 #include "gazebo/common/ImageHeightmap.hh"
 #include "gazebo/common/HeightmapData.hh"
+#include "gazebo/common/HeightmapTileCache.hh"
 #include "gazebo/common/Dem.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Shape.hh"
@@ -42,6 +46,11 @@ namespace gazebo
     /// \brief HeightmapShape collision shape builds a heightmap from
     /// an image.  The supplied image must be square with
     /// N*N+1 pixels per side, where N is an integer.
+    ///
+    /// When <use_terrain_paging> is true and the physics engine supports it,
+    /// the sampled heights are not kept in memory. They are written once to
+    /// a tile cache in the Gazebo log directory and memory mapped from there.
+    /// Only the tiles around enabled, non-static links stay resident.
     class GZ_PHYSICS_VISIBLE HeightmapShape : public Shape
     {
       /// \brief height field type, float or double
@@ -148,6 +157,42 @@ namespace gazebo
       /// \brief Version of FillHeightfield() for double vectors.
       public: void FillHeightfield(std::vector<double>& heights);
 
+      /// \brief Whether the heights are served from a tile cache instead of
+      /// the dense \e heights vector.
+      /// \return True if tiling is enabled.
+      public: bool TilingEnabled() const;
+
+      /// \brief Set the distance around active links within which heightmap
+      /// tiles are kept in memory.
+      /// \param[in] _radius Distance in meters.
+      public: void SetTileRadius(const double _radius);
+
+      /// \brief Get the distance around active links within which heightmap
+      /// tiles are kept in memory.
+      /// \return Distance in meters.
+      public: double TileRadius() const;
+
+      /// \brief Get the number of tiles currently in memory.
+      /// \return Number of resident tiles, 0 if tiling is disabled.
+      public: unsigned int ResidentTileCount() const;
+
+      /// \brief Keep the tiles around a set of world positions resident and
+      /// release the others. Called periodically with the positions of the
+      /// enabled, non-static links of the world.
+      /// \param[in] _positions Positions in the world frame.
+      public: void UpdateTiles(
+                  const std::vector<ignition::math::Vector3d> &_positions);
+
+      /// \brief Open the tile cache of this heightmap, building it from the
+      /// heightmap data if it does not exist yet.
+      /// \return True if the tile cache is ready to be used.
+      private: bool LoadTileCache();
+
+      /// \brief Refresh the resident tiles at the beginning of a world
+      /// update.
+      /// \param[in] _info World update information.
+      private: void OnWorldUpdateBegin(const common::UpdateInfo &_info);
+
       /// \brief Lookup table of heights.
       protected: std::vector<HeightType> heights;
 
@@ -166,6 +211,11 @@ namespace gazebo
       /// \brief The amount of subsampling. Default is 2.
       protected: int subSampling;
 
+      /// \brief True if the physics engine can read the heights through
+      /// GetHeight, which allows the heightmap to be tiled. Engines that
+      /// need the dense \e heights vector must leave it false.
+      protected: bool tilingSupported;
+
       /// \brief Transportation node.
       private: transport::NodePtr node;
 
@@ -186,6 +236,21 @@ namespace gazebo
       private: common::Dem dem;
       #endif
 
+      /// \brief Tile cache used instead of \e heights when tiling is enabled.
+      private: std::unique_ptr<common::HeightmapTileCache> tileCache;
+
+      /// \brief Number of cells per tile side.
+      private: unsigned int tileSize;
+
+      /// \brief Distance around active links within which tiles are kept.
+      private: double tileRadius;
+
+      /// \brief Sim time of the last tile residency update.
+      private: common::Time lastTileUpdate;
+
+      /// \brief Connection to the world update begin event.
+      private: event::ConnectionPtr updateConnection;
+
       // Place ignition::transport objects at the end of this file to
       // guarantee they are destructed first.
 
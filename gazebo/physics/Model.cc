@@ -324,7 +324,9 @@ void Model::Init()
 //////////////////////////////////////////////////
 void Model::Update()
 {
-  if (this->IsStatic())
+  // Models without joints or nested models, such as the resting boxes of a
+  // large world, have nothing to update
+  if (this->IsStatic() || (this->joints.empty() && this->models.empty()))
     return;
 
   boost::recursive_mutex::scoped_lock lock(this->updateMutex);
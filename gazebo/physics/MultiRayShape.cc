@@ -16,6 +16,7 @@
 */
 #include "gazebo/common/Exception.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/CollisionBvh.hh"
 #include "gazebo/physics/MultiRayShape.hh"
 
 using namespace gazebo;
@@ -183,7 +184,10 @@ void MultiRayShape::Update()
   }
 
   // do actual collision checks
-  this->UpdateRays();
+  if (this->collisionBvh && this->collisionBvh->Update())
+    this->UpdateRaysBvh();
+  else
+    this->UpdateRays();
 
   // for plugin
   this->newLaserScans();
@@ -325,3 +329,51 @@ RayShapePtr MultiRayShape::Ray(const unsigned int _rayIndex) const
   else
     return RayShapePtr();
 }
+
+//////////////////////////////////////////////////
+void MultiRayShape::SetCollisionBvh(CollisionBvhPtr _bvh)
+{
+  this->collisionBvh = _bvh;
+}
+
+//////////////////////////////////////////////////
+CollisionBvhPtr MultiRayShape::Bvh() const
+{
+  return this->collisionBvh;
+}
+
+//////////////////////////////////////////////////
+void MultiRayShape::UpdateRaysBvh()
+{
+  const unsigned int raySize = this->rays.size();
+  std::vector<ignition::math::Vector3d> origins(raySize);
+  std::vector<ignition::math::Vector3d> dirs(raySize);
+  std::vector<double> dists(raySize);
+  std::vector<int> collisions(raySize);
+
+  // The rays are cast from the center of the shape, so that they can be
+  // traced together, and hits closer than the min range are ignored.
+  const double minDist = this->GetMinRange();
+  for (unsigned int i = 0; i < raySize; ++i)
+  {
+    ignition::math::Vector3d start, end;
+    this->rays[i]->GlobalPoints(start, end);
+    dirs[i] = (end - start).Normalize();
+    origins[i] = start - dirs[i] * minDist;
+    dists[i] = minDist + start.Distance(end);
+  }
+
+  this->collisionBvh->Intersect(origins.data(), dirs.data(), raySize,
+      minDist, dists.data(), collisions.data());
+
+  for (unsigned int i = 0; i < raySize; ++i)
+  {
+    if (collisions[i] < 0)
+      continue;
+
+    this->rays[i]->SetLength(dists[i] - minDist);
+    this->rays[i]->SetRetro(this->collisionBvh->LaserRetro(collisions[i]));
+    this->rays[i]->SetCollisionName(
+        this->collisionBvh->CollisionName(collisions[i]));
+  }
+}
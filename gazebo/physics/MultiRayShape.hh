@@ -179,6 +179,21 @@ namespace gazebo
       /// \sa RayCount()
       public: RayShapePtr Ray(const unsigned int _rayIndex) const;
 
+      /// \brief Cast the rays against a hierarchy of the collisions of the
+      /// world instead of using the physics engine. The physics engine is
+      /// still used while the world has collisions the hierarchy can't
+      /// intersect.
+      /// \param[in] _bvh Hierarchy, null to always use the physics engine.
+      /// \sa CollisionBvh
+      public: void SetCollisionBvh(CollisionBvhPtr _bvh);
+
+      /// \brief Get the hierarchy the rays are cast against.
+      /// \return Hierarchy, null if the rays are cast by the physics engine.
+      public: CollisionBvhPtr Bvh() const;
+
+      /// \brief Cast the rays against the hierarchy.
+      private: void UpdateRaysBvh();
+
       /// \brief Ray data
       protected: std::vector<RayShapePtr> rays;
 
@@ -208,6 +223,9 @@ namespace gazebo
 
       /// \brief Max range of a ray
       private: double maxRange = 1000;
+
+      /// \brief Hierarchy the rays are cast against, if any.
+      private: CollisionBvhPtr collisionBvh;
     };
     /// \}
   }
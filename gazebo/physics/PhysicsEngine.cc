@@ -295,6 +295,11 @@ bool PhysicsEngine::GetParam(const std::string &_key,
     _value = this->world->Gravity();
   else if (_key == "magnetic_field")
     _value = this->world->MagneticField();
+  else if (_key == "sleeping_bodies")
+  {
+    // Engines which put bodies to sleep report their own count
+    _value = 0;
+  }
   else
   {
     gzwarn << "GetParam failed for [" << _key << "] in physics engine "
@@ -305,6 +310,55 @@ bool PhysicsEngine::GetParam(const std::string &_key,
   return true;
 }
 
+//////////////////////////////////////////////////
+void PhysicsEngine::SaveSnapshot(const Link_V &_links,
+    const Joint_V &/*_joints*/, std::vector<double> &_data) const
+{
+  _data.resize(_links.size() * 13);
+  double *value = _data.data();
+  for (auto const &link : _links)
+  {
+    const ignition::math::Pose3d &pose = link->WorldPose();
+    const ignition::math::Vector3d linear = link->WorldLinearVel();
+    const ignition::math::Vector3d angular = link->WorldAngularVel();
+    *value++ = pose.Pos().X();
+    *value++ = pose.Pos().Y();
+    *value++ = pose.Pos().Z();
+    *value++ = pose.Rot().W();
+    *value++ = pose.Rot().X();
+    *value++ = pose.Rot().Y();
+    *value++ = pose.Rot().Z();
+    *value++ = linear.X();
+    *value++ = linear.Y();
+    *value++ = linear.Z();
+    *value++ = angular.X();
+    *value++ = angular.Y();
+    *value++ = angular.Z();
+  }
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::RestoreSnapshot(const Link_V &_links,
+    const Joint_V &/*_joints*/, const std::vector<double> &_data)
+{
+  if (_data.size() != _links.size() * 13)
+    return false;
+
+  const double *value = _data.data();
+  for (auto const &link : _links)
+  {
+    link->SetWorldPose(ignition::math::Pose3d(
+          value[0], value[1], value[2], value[3], value[4], value[5],
+          value[6]));
+    link->SetLinearVel(
+        ignition::math::Vector3d(value[7], value[8], value[9]));
+    link->SetAngularVel(
+        ignition::math::Vector3d(value[10], value[11], value[12]));
+    value += 13;
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 ContactManager *PhysicsEngine::GetContactManager() const
 {
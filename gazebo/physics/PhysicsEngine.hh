@@ -20,6 +20,7 @@
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/any.hpp>
 #include <string>
+#include <vector>
 #include <ignition/transport/Node.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -55,6 +56,13 @@ namespace gazebo
       /// \brief Initialize the physics engine.
       public: virtual void Init() = 0;
 
+      /// \brief Finish initializing the models initialized since the last
+      /// call. The world calls it after initializing a batch of models, such
+      /// as the models of a world file or the models spawned during a step,
+      /// so engines which rebuild their whole system when models are added
+      /// only do it once per batch.
+      public: virtual void InitPendingModels() {}
+
       /// \brief Finilize the physics engine.
       public: virtual void Fini();
 
@@ -215,6 +223,21 @@ namespace gazebo
       ///          (defined but not used in ode).
       ///       -# "max_step_size" (double) - maximum physics step size when
       ///          physics update step must return.
+      ///       -# "auto_disable_islands" (bool) - only put bodies to sleep
+      ///          when every body they are connected to, by joints or
+      ///          contacts, is idle. Models with joints can only sleep
+      ///          by island. (ODE)
+      ///       -# "auto_disable_linear_threshold" (double),
+      ///          "auto_disable_angular_threshold" (double) - velocities
+      ///          below which a body is idle. (ODE)
+      ///       -# "auto_disable_time" (double), "auto_disable_steps" (int) -
+      ///          time and number of steps a body must stay idle before
+      ///          it sleeps. (ODE)
+      ///       -# "auto_disable_average_samples" (int) - number of steps the
+      ///          velocities are averaged over, 0 to never sleep. (ODE)
+      ///
+      /// The "sleeping_bodies" (int) parameter can be read to get the
+      /// number of bodies which were asleep at the last step.
       ///
       /// \param[in] _value The value to set to
       /// \return true if SetParam is successful, false if operation fails.
@@ -238,6 +261,27 @@ namespace gazebo
       /// \brief Debug print out of the physic engine state.
       public: virtual void DebugPrint() const = 0;
 
+      /// \brief Save the dynamic state of links and joints into a buffer.
+      /// The default implementation saves the world pose and velocities of
+      /// the links. Engines which keep more state between two steps save it
+      /// too, so that a restored world follows the same trajectory.
+      /// \param[in] _links Links to save.
+      /// \param[in] _joints Joints to save.
+      /// \param[out] _data Buffer to fill. Its memory is reused.
+      /// \sa World::SaveSnapshot
+      public: virtual void SaveSnapshot(const Link_V &_links,
+                  const Joint_V &_joints, std::vector<double> &_data) const;
+
+      /// \brief Restore the dynamic state of links and joints saved by
+      /// SaveSnapshot.
+      /// \param[in] _links Links to restore, the same as when saving.
+      /// \param[in] _joints Joints to restore, the same as when saving.
+      /// \param[in] _data Buffer filled by SaveSnapshot.
+      /// \return False if the buffer doesn't match the links and joints.
+      /// \sa World::RestoreSnapshot
+      public: virtual bool RestoreSnapshot(const Link_V &_links,
+                  const Joint_V &_joints, const std::vector<double> &_data);
+
       /// \brief Get a pointer to the world.
       /// \return Pointer to the world.
       public: WorldPtr World() const;
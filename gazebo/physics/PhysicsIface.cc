@@ -96,6 +96,12 @@ bool physics::has_world(const std::string &_name)
   return false;
 }
 
+/////////////////////////////////////////////////
+physics::World_V physics::get_worlds()
+{
+  return g_worlds;
+}
+
 /////////////////////////////////////////////////
 void physics::load_worlds(sdf::ElementPtr _sdf)
 {
@@ -61,6 +61,11 @@ namespace gazebo
     GZ_PHYSICS_VISIBLE
     bool has_world(const std::string &_name = "");
 
+    /// \brief Get all the worlds, in the order they were created.
+    /// \return The worlds.
+    GZ_PHYSICS_VISIBLE
+    World_V get_worlds();
+
     /// \brief Load world from sdf::Element pointer.
     /// \param[in] _world Pointer to a world.
     /// \param[in] _sdf SDF values to load from.
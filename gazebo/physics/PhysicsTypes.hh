@@ -42,6 +42,7 @@ namespace gazebo
     class Light;
     class Link;
     class Collision;
+    class CollisionBvh;
     class FrictionPyramid;
     class Gripper;
     class Joint;
@@ -113,6 +114,10 @@ namespace gazebo
     /// \brief Boost shared pointer to a Collision object
     typedef boost::shared_ptr<Collision> CollisionPtr;
 
+    /// \def CollisionBvhPtr
+    /// \brief Shared pointer to a CollisionBvh object
+    typedef std::shared_ptr<CollisionBvh> CollisionBvhPtr;
+
     /// \def JointPtr
     /// \brief Boost shared pointer to a Joint object
     typedef boost::shared_ptr<Joint> JointPtr;
@@ -201,6 +206,10 @@ namespace gazebo
     /// \brief Vector of BasePtr
     typedef std::vector<BasePtr> Base_V;
 
+    /// \def World_V
+    /// \brief Vector of WorldPtr
+    typedef std::vector<WorldPtr> World_V;
+
     /// \def Model_V
     /// \brief Vector of ModelPtr
     typedef std::vector<ModelPtr> Model_V;
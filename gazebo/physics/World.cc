@@ -16,13 +16,19 @@
 */
 
 #include <time.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
 #include <deque>
+#include <functional>
 #include <list>
 #include <set>
 #include <string>
@@ -89,9 +95,48 @@
 using namespace gazebo;
 using namespace physics;
 
-/// \brief Flag used to say if/when to clear all models.
-/// This will be replaced with a class member variable in Gazebo 3.0
-bool g_clearModels;
+/// \brief Minimum wall time between two compact pose messages.
+static const common::Time kCompactPosePeriod(1.0 / 60.0);
+
+//////////////////////////////////////////////////
+/// \brief Configure the compact pose stream from the
+/// GAZEBO_COMPACT_POSES_ENCODING (float32 or quantized) and
+/// GAZEBO_COMPACT_POSES_RESOLUTION (meters) environment variables.
+/// \param[in] _encoder Encoder of the stream.
+static void configureCompactPoses(msgs::PoseStreamEncoder &_encoder)
+{
+  const char *encodingStr = getenv("GAZEBO_COMPACT_POSES_ENCODING");
+  if (encodingStr)
+  {
+    const std::string encoding = encodingStr;
+    if (encoding == "float32")
+      _encoder.SetEncoding(msgs::PosesCompact::FLOAT32);
+    else if (encoding == "quantized")
+      _encoder.SetEncoding(msgs::PosesCompact::QUANTIZED);
+    else
+    {
+      gzwarn << "Invalid GAZEBO_COMPACT_POSES_ENCODING [" << encoding
+             << "], using quantized poses.\n";
+    }
+  }
+
+  const char *resolutionStr = getenv("GAZEBO_COMPACT_POSES_RESOLUTION");
+  if (resolutionStr && !_encoder.SetResolution(atof(resolutionStr)))
+  {
+    gzwarn << "Invalid GAZEBO_COMPACT_POSES_RESOLUTION [" << resolutionStr
+           << "], using " << _encoder.Resolution() << " m.\n";
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a new identifier for the models of a world, unique among
+/// all the worlds of the process.
+/// \return Snapshot layout identifier, never 0.
+static uint64_t nextSnapshotLayout()
+{
+  static std::atomic<uint64_t> counter{0};
+  return ++counter;
+}
 
 class ModelUpdate_TBB
 {
@@ -111,7 +156,6 @@ class ModelUpdate_TBB
 World::World(const std::string &_name)
   : dataPtr(new WorldPrivate)
 {
-  g_clearModels = false;
   this->dataPtr->sdf.reset(new sdf::Element);
   sdf::initFile("world.sdf", this->dataPtr->sdf);
 
@@ -130,6 +174,7 @@ World::World(const std::string &_name)
   this->dataPtr->thread = nullptr;
   this->dataPtr->logThread = nullptr;
   this->dataPtr->stop = false;
+  this->dataPtr->layout = nextSnapshotLayout();
   this->dataPtr->sensorsInitialized = false;
 
   this->dataPtr->currentStateBuffer = 0;
@@ -226,6 +271,14 @@ void World::Load(sdf::ElementPtr _sdf)
   this->dataPtr->posePub = this->dataPtr->node->Advertise<msgs::PosesStamped>(
     "~/pose/info", 10, 60);
 
+  // compact pose pub, which identifies entities by id and only sends the
+  // poses which changed. It is rate limited by the world, because the
+  // quantized stream can't drop messages.
+  this->dataPtr->poseCompactPub =
+    this->dataPtr->node->Advertise<msgs::PosesCompact>(
+        "~/pose/compact/info", 100);
+  configureCompactPoses(this->dataPtr->poseCompactEncoder);
+
   this->dataPtr->guiPub = this->dataPtr->node->Advertise<msgs::GUI>("~/gui", 5);
   if (this->dataPtr->sdf->HasElement("gui"))
   {
@@ -484,7 +537,46 @@ void World::Run(const unsigned int _iterations)
   this->dataPtr->stop = false;
   this->dataPtr->stopIterations = _iterations;
 
-  this->dataPtr->thread = new std::thread(std::bind(&World::RunLoop, this));
+  // Mark the loop as running before its thread starts, so that StepBatch
+  // hands its batch to the loop instead of stepping the world at the same
+  // time
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->batchMutex);
+    this->dataPtr->runLoopActive = true;
+    this->dataPtr->thread = new std::thread(std::bind(&World::RunLoop, this));
+    this->dataPtr->runLoopThreadId = this->dataPtr->thread->get_id();
+  }
+
+#ifdef __linux__
+  if (this->dataPtr->cpuAffinity >= 0)
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(this->dataPtr->cpuAffinity, &cpuSet);
+    if (pthread_setaffinity_np(this->dataPtr->thread->native_handle(),
+          sizeof(cpu_set_t), &cpuSet) != 0)
+    {
+      gzwarn << "Unable to run world [" << this->Name() << "] on CPU ["
+             << this->dataPtr->cpuAffinity << "]\n";
+    }
+  }
+#endif
+}
+
+//////////////////////////////////////////////////
+void World::SetCpuAffinity(const int _cpu)
+{
+#ifndef __linux__
+  if (_cpu >= 0)
+    gzwarn << "World CPU affinity is only supported on Linux\n";
+#endif
+  this->dataPtr->cpuAffinity = _cpu;
+}
+
+//////////////////////////////////////////////////
+int World::CpuAffinity() const
+{
+  return this->dataPtr->cpuAffinity;
 }
 
 //////////////////////////////////////////////////
@@ -528,6 +620,12 @@ void World::Stop()
 //////////////////////////////////////////////////
 void World::RunLoop()
 {
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->batchMutex);
+    this->dataPtr->runLoopThreadId = std::this_thread::get_id();
+    this->dataPtr->runLoopActive = true;
+  }
+
   this->dataPtr->physicsEngine->InitForThread();
 
   this->dataPtr->startTime = common::Time::GetWallTime();
@@ -568,6 +666,14 @@ void World::RunLoop()
 
   this->dataPtr->stop = true;
 
+  // Release the callers of StepBatch
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->batchMutex);
+    this->dataPtr->runLoopActive = false;
+    this->dataPtr->runLoopThreadId = std::thread::id();
+  }
+  this->dataPtr->batchCondition.notify_all();
+
   if (this->dataPtr->logThread)
   {
     this->dataPtr->logCondition.notify_all();
@@ -693,6 +799,18 @@ void World::Step()
   IGN_PROFILE_END();
   DIAG_TIMER_LAP("World::Step", "loadPlugins");
 
+  // Run the batch requested by StepBatch from another thread
+  if (this->dataPtr->batchPending)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->batchMutex);
+    this->UpdateBatch(this->dataPtr->batchSteps,
+        this->dataPtr->batchBeforeUpdate, this->dataPtr->batchAfterUpdate);
+    this->dataPtr->batchBeforeUpdate = nullptr;
+    this->dataPtr->batchAfterUpdate = nullptr;
+    this->dataPtr->batchPending = false;
+    this->dataPtr->batchCondition.notify_all();
+  }
+
   IGN_PROFILE_BEGIN("publishWorldStats");
   // Send statistics about the world simulation
   this->PublishWorldStats();
@@ -772,7 +890,7 @@ void World::Step()
 
   DIAG_TIMER_STOP("World::Step");
 
-  if (g_clearModels)
+  if (this->dataPtr->clearModels)
     this->ClearModels();
   IGN_PROFILE_END();
 }
@@ -802,6 +920,108 @@ void World::Step(const unsigned int _steps)
   }
 }
 
+//////////////////////////////////////////////////
+bool World::StepBatch(const unsigned int _steps,
+    const BatchCallback &_beforeUpdate, const BatchCallback &_afterUpdate)
+{
+  if (_steps == 0)
+    return true;
+
+  bool runLoopActive;
+  bool runLoopThread;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->batchMutex);
+    runLoopActive = this->dataPtr->runLoopActive;
+    runLoopThread =
+        std::this_thread::get_id() == this->dataPtr->runLoopThreadId;
+  }
+
+  if (!runLoopActive)
+  {
+    // Nothing else steps the world, run the batch in this thread
+    this->dataPtr->physicsEngine->InitForThread();
+    this->UpdateBatch(_steps, _beforeUpdate, _afterUpdate);
+    gazebo::util::IntrospectionManager::Instance()->NotifyUpdates();
+    this->ProcessMessages();
+    return true;
+  }
+
+  if (runLoopThread)
+  {
+    gzerr << "World::StepBatch can't be called from the world thread\n";
+    return false;
+  }
+
+  if (!this->IsPaused())
+  {
+    gzwarn << "Calling World::StepBatch while world is not paused\n";
+    this->SetPaused(true);
+  }
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->batchMutex);
+
+  // Wait for the batch of another caller
+  this->dataPtr->batchCondition.wait(lock, [this]
+      {
+        return !this->dataPtr->batchPending || !this->dataPtr->runLoopActive;
+      });
+
+  if (!this->dataPtr->runLoopActive)
+    return false;
+
+  this->dataPtr->batchSteps = _steps;
+  this->dataPtr->batchBeforeUpdate = _beforeUpdate;
+  this->dataPtr->batchAfterUpdate = _afterUpdate;
+  this->dataPtr->batchPending = true;
+
+  this->dataPtr->batchCondition.wait(lock, [this]
+      {
+        return !this->dataPtr->batchPending || !this->dataPtr->runLoopActive;
+      });
+
+  if (this->dataPtr->batchPending)
+  {
+    // The world stopped before running the batch
+    this->dataPtr->batchBeforeUpdate = nullptr;
+    this->dataPtr->batchAfterUpdate = nullptr;
+    this->dataPtr->batchPending = false;
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void World::UpdateBatch(const unsigned int _steps,
+    const BatchCallback &_beforeUpdate, const BatchCallback &_afterUpdate)
+{
+  IGN_PROFILE("World::UpdateBatch");
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  if (!this->dataPtr->pluginsLoaded && this->SensorsInitialized())
+  {
+    this->LoadPlugins();
+    this->dataPtr->pluginsLoaded = true;
+  }
+
+  for (unsigned int i = 0; i < _steps; ++i)
+  {
+    if (_beforeUpdate)
+      _beforeUpdate(i);
+
+    // query timestep to allow dynamic time step size updates
+    this->dataPtr->simTime += this->dataPtr->physicsEngine->GetMaxStepSize();
+    this->dataPtr->iterations++;
+    this->Update();
+
+    if (_afterUpdate)
+      _afterUpdate(i);
+  }
+
+  this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
+}
+
 //////////////////////////////////////////////////
 void World::Update()
 {
@@ -940,6 +1160,7 @@ void World::Fini()
 
     this->dataPtr->poseLocalPub.reset();
     this->dataPtr->posePub.reset();
+    this->dataPtr->poseCompactPub.reset();
     this->dataPtr->guiPub.reset();
     this->dataPtr->responsePub.reset();
     this->dataPtr->statPub.reset();
@@ -972,6 +1193,8 @@ void World::Fini()
   this->dataPtr->publishModelPoses.clear();
   this->dataPtr->publishModelScales.clear();
   this->dataPtr->publishLightPoses.clear();
+  this->dataPtr->compactPoseModels.clear();
+  this->dataPtr->compactPoseLights.clear();
 
   // Clean entities
   for (auto &model : this->dataPtr->models)
@@ -980,6 +1203,9 @@ void World::Fini()
       model->Fini();
   }
   this->dataPtr->models.clear();
+  this->dataPtr->layout = nextSnapshotLayout();
+  this->dataPtr->snapshotLinks.clear();
+  this->dataPtr->snapshotJoints.clear();
 
   for (auto &road : this->dataPtr->roads)
   {
@@ -1036,14 +1262,14 @@ void World::Fini()
 //////////////////////////////////////////////////
 void World::Clear()
 {
-  g_clearModels = true;
+  this->dataPtr->clearModels = true;
   /// \todo Clear lights too?
 }
 
 //////////////////////////////////////////////////
 void World::ClearModels()
 {
-  g_clearModels = false;
+  this->dataPtr->clearModels = false;
   bool pauseState = this->IsPaused();
   this->SetPaused(true);
 
@@ -1052,6 +1278,7 @@ void World::ClearModels()
     this->RemoveModel(this->dataPtr->models[0]);
   }
   this->dataPtr->models.clear();
+  this->dataPtr->layout = nextSnapshotLayout();
 
   for (auto &road : this->dataPtr->roads)
   {
@@ -1205,6 +1432,7 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
   }
 
   this->PublishModelPose(model);
+  this->dataPtr->layout = nextSnapshotLayout();
   this->dataPtr->models.push_back(model);
   return model;
 }
@@ -1260,6 +1488,7 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->EnableAllModels();
   this->PublishModelPose(actor);
+  this->dataPtr->layout = nextSnapshotLayout();
   this->dataPtr->models.push_back(actor);
 
   return actor;
@@ -1357,6 +1586,140 @@ Model_V World::Models() const
   return this->dataPtr->models;
 }
 
+//////////////////////////////////////////////////
+Model_V World::ModelsInFrustum(const ignition::math::Frustum &_frustum) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->modelTreeMutex);
+  this->UpdateModelTree();
+
+  std::vector<uint32_t> ids;
+  this->dataPtr->modelTree.Query(_frustum, ids);
+  std::sort(ids.begin(), ids.end());
+
+  Model_V models;
+  for (auto const id : ids)
+  {
+    ignition::math::AxisAlignedBox box;
+    if (!this->dataPtr->modelTree.Box(id, box) || !_frustum.Contains(box))
+      continue;
+
+    ModelPtr model = this->dataPtr->modelTreeModels[id].lock();
+    if (model)
+      models.push_back(model);
+  }
+  return models;
+}
+
+//////////////////////////////////////////////////
+Model_V World::ModelsInSphere(const ignition::math::Vector3d &_center,
+    const double _radius) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->modelTreeMutex);
+  this->UpdateModelTree();
+
+  std::vector<uint32_t> ids;
+  this->dataPtr->modelTree.Query(_center, _radius, ids);
+  std::sort(ids.begin(), ids.end());
+
+  Model_V models;
+  for (auto const id : ids)
+  {
+    ignition::math::AxisAlignedBox box;
+    if (!this->dataPtr->modelTree.Box(id, box) ||
+        !BoundingBoxTree::Intersects(box, _center, _radius))
+    {
+      continue;
+    }
+
+    ModelPtr model = this->dataPtr->modelTreeModels[id].lock();
+    if (model)
+      models.push_back(model);
+  }
+  return models;
+}
+
+//////////////////////////////////////////////////
+uint64_t World::StaticModelsRevision() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->modelTreeMutex);
+  this->UpdateModelTree();
+  return this->dataPtr->staticModelsRevision;
+}
+
+//////////////////////////////////////////////////
+void World::UpdateModelTree() const
+{
+  std::vector<ModelPtr> dirty;
+  std::vector<uint32_t> removed;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+    if (!this->dataPtr->modelTreeActive)
+    {
+      // Build the tree, after which ProcessMessages keeps track of the
+      // models which moved
+      this->dataPtr->modelTreeActive = true;
+      dirty = this->dataPtr->models;
+    }
+
+    // Models which moved since the last step are still in the publish
+    // lists
+    this->dataPtr->modelTreeDirty.insert(
+        this->dataPtr->publishModelPoses.begin(),
+        this->dataPtr->publishModelPoses.end());
+    this->dataPtr->modelTreeDirty.insert(
+        this->dataPtr->publishModelScales.begin(),
+        this->dataPtr->publishModelScales.end());
+    dirty.insert(dirty.end(), this->dataPtr->modelTreeDirty.begin(),
+        this->dataPtr->modelTreeDirty.end());
+    this->dataPtr->modelTreeDirty.clear();
+
+    removed.swap(this->dataPtr->modelTreeRemoved);
+  }
+
+  // Actors animate their links without publishing their pose
+  for (auto const id : this->dataPtr->modelTreeActors)
+  {
+    ModelPtr actor = this->dataPtr->modelTreeModels[id].lock();
+    if (actor)
+      dirty.push_back(actor);
+  }
+
+  // Update the dirty models and their nested models
+  while (!dirty.empty())
+  {
+    ModelPtr model = dirty.back();
+    dirty.pop_back();
+    if (!model)
+      continue;
+
+    const uint32_t id = model->GetId();
+    const ignition::math::AxisAlignedBox box = model->BoundingBox();
+    if (model->IsStatic())
+    {
+      ignition::math::AxisAlignedBox previous;
+      if (!this->dataPtr->modelTree.Box(id, previous) || previous != box)
+        ++this->dataPtr->staticModelsRevision;
+    }
+    this->dataPtr->modelTree.Update(id, box);
+    this->dataPtr->modelTreeModels[id] = model;
+    if (model->HasType(Base::ACTOR))
+      this->dataPtr->modelTreeActors.insert(id);
+
+    for (auto const &nested : model->NestedModels())
+      dirty.push_back(nested);
+  }
+
+  // Removed models may still be in the publish lists, so they are removed
+  // last
+  for (auto const id : removed)
+  {
+    if (this->dataPtr->modelTree.Remove(id))
+      ++this->dataPtr->staticModelsRevision;
+    this->dataPtr->modelTreeModels.erase(id);
+    this->dataPtr->modelTreeActors.erase(id);
+  }
+}
+
 //////////////////////////////////////////////////
 Light_V World::Lights() const
 {
@@ -1684,9 +2047,24 @@ void World::BuildSceneMsg(msgs::Scene &_scene, BasePtr _entity)
 //////////////////////////////////////////////////
 void World::ModelUpdateSingleLoop()
 {
-  // Update all the models
+  // Update all the models. The actors are updated together, so that their
+  // animations are sampled in parallel.
   for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
-    this->dataPtr->rootElement->GetChild(i)->Update();
+  {
+    BasePtr child = this->dataPtr->rootElement->GetChild(i);
+    if (child->HasType(Base::ACTOR))
+      this->dataPtr->actorBatch.push_back(
+          boost::static_pointer_cast<Actor>(child));
+    else
+      child->Update();
+  }
+
+  if (!this->dataPtr->actorBatch.empty())
+  {
+    Actor::UpdateActors(this->dataPtr->actorBatch);
+    // Don't keep the actors alive after they're removed from the world
+    this->dataPtr->actorBatch.clear();
+  }
 }
 
 
@@ -2259,20 +2637,36 @@ void World::ProcessFactoryMsgs()
     }
   }
 
-  // Load models
-  for (auto const &elem : modelsToLoad)
+  // Load models, and finish initializing them in the physics engine once for
+  // all of them before loading their plugins
+  if (!modelsToLoad.empty())
   {
-    try
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
+    std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
 
-      ModelPtr model = this->LoadModel(elem, this->dataPtr->rootElement);
-      if (model != nullptr)
+    Model_V models;
+    for (auto const &elem : modelsToLoad)
+    {
+      try
       {
-        model->Init();
-        model->LoadPlugins();
+        ModelPtr model = this->LoadModel(elem, this->dataPtr->rootElement);
+        if (model != nullptr)
+        {
+          model->Init();
+          models.push_back(model);
+        }
+      }
+      catch(...)
+      {
+        gzerr << "Loading model from factory message failed\n";
       }
     }
+
+    try
+    {
+      this->dataPtr->physicsEngine->InitPendingModels();
+      for (auto const &model : models)
+        model->LoadPlugins();
+    }
     catch(...)
     {
       gzerr << "Loading model from factory message failed\n";
@@ -2395,6 +2789,7 @@ void World::SetState(const WorldState &_state)
         if (model != nullptr)
         {
           model->Init();
+          this->dataPtr->physicsEngine->InitPendingModels();
           if (!util::LogPlay::Instance()->IsOpen())
             model->LoadPlugins();
         }
@@ -2456,6 +2851,88 @@ void World::SetState(const WorldState &_state)
   }
 }
 
+//////////////////////////////////////////////////
+void World::UpdateSnapshotLayout()
+{
+  if (this->dataPtr->snapshotLayout == this->dataPtr->layout)
+    return;
+
+  this->dataPtr->snapshotLinks.clear();
+  this->dataPtr->snapshotJoints.clear();
+
+  std::list<ModelPtr> modelList(this->dataPtr->models.begin(),
+      this->dataPtr->models.end());
+  while (!modelList.empty())
+  {
+    ModelPtr model = modelList.front();
+    modelList.pop_front();
+
+    const Link_V &links = model->GetLinks();
+    this->dataPtr->snapshotLinks.insert(this->dataPtr->snapshotLinks.end(),
+        links.begin(), links.end());
+    const Joint_V &joints = model->GetJoints();
+    this->dataPtr->snapshotJoints.insert(this->dataPtr->snapshotJoints.end(),
+        joints.begin(), joints.end());
+
+    Model_V nested = model->NestedModels();
+    modelList.insert(modelList.end(), nested.begin(), nested.end());
+  }
+
+  this->dataPtr->snapshotLayout = this->dataPtr->layout;
+}
+
+//////////////////////////////////////////////////
+void World::SaveSnapshot(WorldSnapshot &_snapshot)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->UpdateSnapshotLayout();
+
+  _snapshot.simTime = this->dataPtr->simTime;
+  _snapshot.iterations = this->dataPtr->iterations;
+  _snapshot.layout = this->dataPtr->layout;
+
+  boost::recursive_mutex::scoped_lock plock(
+      *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+  this->dataPtr->physicsEngine->SaveSnapshot(this->dataPtr->snapshotLinks,
+      this->dataPtr->snapshotJoints, _snapshot.data);
+}
+
+//////////////////////////////////////////////////
+bool World::RestoreSnapshot(const WorldSnapshot &_snapshot)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  if (_snapshot.layout != this->dataPtr->layout)
+  {
+    gzerr << "Unable to restore a snapshot in world [" << this->Name()
+          << "], it was saved by another world or before models were added "
+          << "or removed\n";
+    return false;
+  }
+  this->UpdateSnapshotLayout();
+
+  {
+    boost::recursive_mutex::scoped_lock plock(
+        *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+    if (!this->dataPtr->physicsEngine->RestoreSnapshot(
+          this->dataPtr->snapshotLinks, this->dataPtr->snapshotJoints,
+          _snapshot.data))
+    {
+      gzerr << "Invalid snapshot for world [" << this->Name() << "]\n";
+      return false;
+    }
+
+    // Propagate the poses set by the physics engine, as after a step
+    for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
+      dirtyEntity->SetWorldPose(dirtyEntity->DirtyPose(), false);
+    this->dataPtr->dirtyPoses.clear();
+  }
+
+  this->dataPtr->simTime = _snapshot.simTime;
+  this->dataPtr->iterations = _snapshot.iterations;
+  return true;
+}
+
 //////////////////////////////////////////////////
 void World::InsertModelFile(const std::string &_sdfFilename)
 {
@@ -2688,6 +3165,83 @@ bool World::OnLog(std::ostringstream &_stream)
   return true;
 }
 
+//////////////////////////////////////////////////
+void World::PublishCompactPoses()
+{
+  common::Time wallTime = common::Time::GetWallTime();
+  if (wallTime - this->dataPtr->compactPoseTime < kCompactPosePeriod)
+    return;
+  this->dataPtr->compactPoseTime = wallTime;
+
+  msgs::PoseStreamEncoder &encoder = this->dataPtr->poseCompactEncoder;
+  msgs::PosesCompact &msg = this->dataPtr->poseCompactMsg;
+  encoder.Begin(this->SimTime(), msg);
+
+  // Names are only needed the first time an entity is sent
+  auto addModel = [&encoder](const ModelPtr &_model)
+  {
+    std::list<ModelPtr> modelList;
+    modelList.push_back(_model);
+    while (!modelList.empty())
+    {
+      ModelPtr m = modelList.front();
+      modelList.pop_front();
+
+      if (encoder.Add(m->GetId(), m->RelativePose()))
+        encoder.AddName(m->GetId(), m->GetScopedName());
+
+      for (auto const &link : m->GetLinks())
+      {
+        if (encoder.Add(link->GetId(), link->RelativePose()))
+          encoder.AddName(link->GetId(), link->GetScopedName());
+      }
+
+      for (auto const &n : m->NestedModels())
+        modelList.push_back(n);
+    }
+  };
+
+  auto addLight = [&encoder](const LightPtr &_light)
+  {
+    if (encoder.Add(_light->GetId(), _light->RelativePose()))
+      encoder.AddName(_light->GetId(), _light->GetScopedName());
+  };
+
+  // Keyframes have every entity, so that new subscribers can start reading
+  // the stream
+  if (encoder.Keyframe())
+  {
+    for (auto const &model : this->dataPtr->models)
+      addModel(model);
+    for (auto const &light : this->dataPtr->lights)
+      addLight(light);
+  }
+  else
+  {
+    for (auto const &model : this->dataPtr->compactPoseModels)
+      addModel(model);
+    for (auto const &light : this->dataPtr->compactPoseLights)
+      addLight(light);
+  }
+  encoder.End();
+
+  this->dataPtr->compactPoseModels.clear();
+  this->dataPtr->compactPoseLights.clear();
+
+  // Messages of a quantized stream are always published, so that the
+  // subscribers can detect missing messages
+  if (msg.id_size() > 0 || msg.encoding() == msgs::PosesCompact::QUANTIZED)
+    this->dataPtr->poseCompactPub->Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void World::SetCompactPoseThresholds(const uint32_t _id,
+    const double _position, const double _rotation)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  this->dataPtr->poseCompactEncoder.SetThresholds(_id, _position, _rotation);
+}
+
 //////////////////////////////////////////////////
 void World::ProcessMessages()
 {
@@ -2772,6 +3326,36 @@ void World::ProcessMessages()
       }
     }
 
+    if (this->dataPtr->poseCompactPub &&
+        this->dataPtr->poseCompactPub->HasConnections())
+    {
+      this->dataPtr->compactPoseModels.insert(
+          this->dataPtr->publishModelPoses.begin(),
+          this->dataPtr->publishModelPoses.end());
+      this->dataPtr->compactPoseLights.insert(
+          this->dataPtr->publishLightPoses.begin(),
+          this->dataPtr->publishLightPoses.end());
+      this->PublishCompactPoses();
+    }
+    else if (!this->dataPtr->compactPoseModels.empty() ||
+        !this->dataPtr->compactPoseLights.empty() ||
+        this->dataPtr->poseCompactMsg.has_time())
+    {
+      // Start with a keyframe when there are subscribers again
+      this->dataPtr->compactPoseModels.clear();
+      this->dataPtr->compactPoseLights.clear();
+      this->dataPtr->poseCompactMsg.Clear();
+      this->dataPtr->poseCompactEncoder.Reset();
+    }
+
+    // Keep the moved models for the next model query
+    if (this->dataPtr->modelTreeActive)
+    {
+      this->dataPtr->modelTreeDirty.insert(
+          this->dataPtr->publishModelPoses.begin(),
+          this->dataPtr->publishModelPoses.end());
+    }
+
     this->dataPtr->publishModelPoses.clear();
     this->dataPtr->publishLightPoses.clear();
   }
@@ -2841,6 +3425,13 @@ void World::ProcessMessages()
         }
       }
     }
+
+    if (this->dataPtr->modelTreeActive)
+    {
+      this->dataPtr->modelTreeDirty.insert(
+          this->dataPtr->publishModelScales.begin(),
+          this->dataPtr->publishModelScales.end());
+    }
     this->dataPtr->publishModelScales.clear();
   }
 
@@ -3067,6 +3658,7 @@ void World::RemoveModel(const std::string &_name)
   }
 
   // remove objects in world
+  ModelPtr removedModel;
   {
     boost::recursive_mutex::scoped_lock lock(
         *this->Physics()->GetPhysicsUpdateMutex());
@@ -3077,7 +3669,9 @@ void World::RemoveModel(const std::string &_name)
     {
       if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
       {
+        removedModel = *model;
         this->dataPtr->models.erase(model);
+        this->dataPtr->layout = nextSnapshotLayout();
         this->dataPtr->rootElement->RemoveChild(_name);
         break;
       }
@@ -3129,6 +3723,33 @@ void World::RemoveModel(const std::string &_name)
         break;
       }
     }
+
+    for (auto model = this->dataPtr->compactPoseModels.begin();
+             model != this->dataPtr->compactPoseModels.end(); ++model)
+    {
+      if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
+      {
+        this->dataPtr->compactPoseModels.erase(model);
+        break;
+      }
+    }
+
+    // Remove the model and its nested models from the model tree at the
+    // next query
+    if (removedModel && this->dataPtr->modelTreeActive)
+    {
+      this->dataPtr->modelTreeDirty.erase(removedModel);
+
+      Model_V removed = {removedModel};
+      while (!removed.empty())
+      {
+        ModelPtr model = removed.back();
+        removed.pop_back();
+        this->dataPtr->modelTreeRemoved.push_back(model->GetId());
+        for (auto const &nested : model->NestedModels())
+          removed.push_back(nested);
+      }
+    }
   }
 
   // Cleanup the publishLightPoses list.
@@ -3142,6 +3763,15 @@ void World::RemoveModel(const std::string &_name)
         break;
       }
     }
+
+    for (auto light : this->dataPtr->compactPoseLights)
+    {
+      if (light->GetName() == _name || light->GetScopedName() == _name)
+      {
+        this->dataPtr->compactPoseLights.erase(light);
+        break;
+      }
+    }
   }
 }
 
@@ -3251,6 +3881,24 @@ void World::RegisterIntrospectionItems()
   // Add here all the items that might be introspected.
   gazebo::util::IntrospectionManager::Instance()->Register<common::Time>(
       timeURI.Str(), std::bind(&World::SimTime, this));
+
+  // Number of bodies put to sleep by the physics engine
+  auto sleepingBodies = [this]()
+  {
+    boost::any value;
+    if (!this->dataPtr->physicsEngine ||
+        !this->dataPtr->physicsEngine->GetParam("sleeping_bodies", value))
+    {
+      return 0;
+    }
+    return boost::any_cast<int>(value);
+  };
+
+  common::URI sleepingURI(uri);
+  sleepingURI.Query().Insert("p", "physics/sleeping_bodies");
+  this->dataPtr->introspectionItems.push_back(sleepingURI);
+  gazebo::util::IntrospectionManager::Instance()->Register<int>(
+      sleepingURI.Str(), sleepingBodies);
 }
 
 /////////////////////////////////////////////////
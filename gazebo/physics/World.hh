@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_WORLD_HH_
 #define GAZEBO_PHYSICS_WORLD_HH_
 
+#include <functional>
 #include <vector>
 #include <list>
 #include <set>
@@ -26,6 +27,8 @@
 
 #include <boost/enable_shared_from_this.hpp>
 
+#include <ignition/math/Frustum.hh>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -40,6 +43,7 @@
 #include "gazebo/physics/Base.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/WorldState.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
 #include "gazebo/physics/Wind.hh"
 #include "gazebo/util/system.hh"
 
@@ -120,6 +124,19 @@ namespace gazebo
       /// \return True if the world is running.
       public: bool Running() const;
 
+      /// \brief Set the CPU on which the thread started by Run executes,
+      /// so that several worlds running in one process each step on their
+      /// own core. Must be called before Run. Only supported on Linux.
+      /// \param[in] _cpu Index of the CPU, negative to let the operating
+      /// system schedule the thread.
+      /// \sa CpuAffinity
+      public: void SetCpuAffinity(const int _cpu);
+
+      /// \brief Get the CPU on which the thread started by Run executes.
+      /// \return Index of the CPU, negative if the thread isn't pinned.
+      /// \sa SetCpuAffinity
+      public: int CpuAffinity() const;
+
       /// \brief Stop the world.
       /// Request the update loop thread to stop. Wait for it to join if this
       /// function is called from another thread. Return immediately otherwise.
@@ -194,6 +211,31 @@ namespace gazebo
       /// \return A list of all the Models in the world.
       public: Model_V Models() const;
 
+      /// \brief Get the models, including nested models, whose bounding box
+      /// is in a frustum, as tested by ignition::math::Frustum::Contains.
+      /// The models are looked up in a tree of their bounding boxes, which
+      /// is updated with the models that moved since the last query.
+      /// \param[in] _frustum Frustum, in the world frame.
+      /// \return Models in the frustum, in the order they were created.
+      public: Model_V ModelsInFrustum(
+                  const ignition::math::Frustum &_frustum) const;
+
+      /// \brief Get the models, including nested models, whose bounding box
+      /// intersects a sphere. The models are looked up in the same tree as
+      /// ModelsInFrustum.
+      /// \param[in] _center Center of the sphere, in the world frame.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return Models intersecting the sphere, in the order they were
+      /// created.
+      public: Model_V ModelsInSphere(const ignition::math::Vector3d &_center,
+                  const double _radius) const;
+
+      /// \brief Get a number which changes when a static model is added,
+      /// moved or resized, or when a model is removed. Used to know when data
+      /// computed from the static geometry of the world needs to be updated.
+      /// \return Revision of the static models.
+      public: uint64_t StaticModelsRevision() const;
+
       /// \brief Get the number of lights.
       /// \return The number of lights in the World.
       public: unsigned int LightCount() const;
@@ -297,6 +339,25 @@ namespace gazebo
       /// \param _state The state to set the World to.
       public: void SetState(const WorldState &_state);
 
+      /// \brief Save the dynamic state of the links and joints of the world,
+      /// as well as the simulation time and iterations, into a snapshot.
+      /// The state of the physics engine which is kept between two steps,
+      /// such as the warm start data of ODE, is saved too, so that the
+      /// world follows the same trajectory after RestoreSnapshot. This is
+      /// much faster than building a WorldState, and meant for rollouts
+      /// which save and restore the world many times per second.
+      /// The state of plugins isn't saved.
+      /// \param[out] _snapshot Snapshot to fill. Its memory is reused.
+      /// \sa RestoreSnapshot
+      public: void SaveSnapshot(WorldSnapshot &_snapshot);
+
+      /// \brief Restore a snapshot saved by SaveSnapshot.
+      /// \param[in] _snapshot Snapshot to restore.
+      /// \return False if the snapshot wasn't saved by this world, or if
+      /// models were added or removed since it was saved.
+      /// \sa SaveSnapshot
+      public: bool RestoreSnapshot(const WorldSnapshot &_snapshot);
+
       /// \brief Insert a model from an SDF file.
       /// Spawns a model into the world base on and SDF file.
       /// \param[in] _sdfFilename The name of the SDF file (including path).
@@ -331,6 +392,29 @@ namespace gazebo
       /// \param[in] _steps The number of steps the World should take.
       public: void Step(const unsigned int _steps);
 
+      /// \brief Callback of StepBatch, called with the index of the
+      /// iteration in the batch, starting at 0.
+      public: using BatchCallback = std::function<void(const unsigned int)>;
+
+      /// \brief Run a batch of iterations in lockstep, without throttling
+      /// to the real time update rate and without publishing anything
+      /// between the iterations. The callbacks run while the world update
+      /// mutex is held, so they can safely apply commands and read the
+      /// state of the world.
+      ///
+      /// If the world is running in its own thread, it is paused and the
+      /// batch runs in that thread. The function returns once the batch is
+      /// done. Otherwise, for example in a program which only called
+      /// gazebo::loadWorld, the batch runs in the calling thread.
+      /// \param[in] _steps Number of iterations.
+      /// \param[in] _beforeUpdate Called before each iteration, may be empty.
+      /// \param[in] _afterUpdate Called after each iteration, may be empty.
+      /// \return False if the batch couldn't run, for example when called
+      /// from a world update callback or when the world stopped.
+      public: bool StepBatch(const unsigned int _steps,
+                  const BatchCallback &_beforeUpdate,
+                  const BatchCallback &_afterUpdate);
+
       /// \brief Load a plugin
       /// \param[in] _filename The filename of the plugin.
       /// \param[in] _name A unique name for the plugin.
@@ -400,6 +484,15 @@ namespace gazebo
       /// \param[in] _light Pointer to the light to publish.
       public: void PublishLightPose(const physics::LightPtr _light);
 
+      /// \brief Set the change thresholds of an entity on the compact pose
+      /// topic, ~/pose/compact/info. The pose of the entity is only
+      /// published when it moved more than the thresholds.
+      /// \param[in] _id Id of the model, link or light.
+      /// \param[in] _position Position threshold in meters.
+      /// \param[in] _rotation Rotation threshold in radians.
+      public: void SetCompactPoseThresholds(const uint32_t _id,
+                  const double _position, const double _rotation);
+
       /// \brief Get the total number of iterations.
       /// \return Number of iterations that simulation has taken.
       public: uint32_t Iterations() const;
@@ -514,6 +607,23 @@ namespace gazebo
       /// \brief Step the world once.
       private: void Step();
 
+      /// \brief Run the iterations of a batch. Called by StepBatch or by
+      /// Step when a batch was requested from another thread.
+      /// \param[in] _steps Number of iterations.
+      /// \param[in] _beforeUpdate Called before each iteration.
+      /// \param[in] _afterUpdate Called after each iteration.
+      private: void UpdateBatch(const unsigned int _steps,
+                   const BatchCallback &_beforeUpdate,
+                   const BatchCallback &_afterUpdate);
+
+      /// \brief Update the tree of model bounding boxes with the models
+      /// which moved or were removed. The caller must hold modelTreeMutex.
+      private: void UpdateModelTree() const;
+
+      /// \brief Update the links and joints saved in snapshots, if models
+      /// were added or removed.
+      private: void UpdateSnapshotLayout();
+
       /// \brief Step the world once by reading from a log file.
       private: void LogStep();
 
@@ -610,6 +720,9 @@ namespace gazebo
       /// \brief Process all incoming messages.
       private: void ProcessMessages();
 
+      /// \brief Publish the poses which changed on ~/pose/compact/info.
+      private: void PublishCompactPoses();
+
       /// \brief Publish the world stats message.
       private: void PublishWorldStats();
 
@@ -19,6 +19,7 @@
 
 #include <atomic>
 #include <deque>
+#include <functional>
 #include <vector>
 #include <list>
 #include <memory>
@@ -27,8 +28,10 @@
 #include <string>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <condition_variable>
 
+#include <boost/weak_ptr.hpp>
 #include <ignition/transport.hh>
 
 #include "gazebo/common/Event.hh"
@@ -36,9 +39,11 @@
 #include "gazebo/common/URI.hh"
 
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/msgs/PoseStream.hh"
 
 #include "gazebo/transport/TransportTypes.hh"
 
+#include "gazebo/physics/BoundingBoxTree.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/WorldState.hh"
 
@@ -71,9 +76,40 @@ namespace gazebo
       /// \brief thread in which the world is updated.
       public: std::thread *thread;
 
+      /// \brief CPU on which the world thread runs, negative if the thread
+      /// isn't pinned.
+      public: int cpuAffinity = -1;
+
+      /// \brief True to remove all the models at the end of the next step.
+      public: std::atomic_bool clearModels{false};
+
       /// \brief True to stop the world from running.
       public: bool stop;
 
+      /// \brief True while RunLoop steps the world.
+      public: std::atomic_bool runLoopActive{false};
+
+      /// \brief Id of the thread of RunLoop.
+      public: std::thread::id runLoopThreadId;
+
+      /// \brief Protects the batch requested by World::StepBatch.
+      public: std::mutex batchMutex;
+
+      /// \brief Signals the end of a batch requested by World::StepBatch.
+      public: std::condition_variable batchCondition;
+
+      /// \brief True when a batch waits to be run by RunLoop.
+      public: std::atomic_bool batchPending{false};
+
+      /// \brief Number of iterations of the pending batch.
+      public: unsigned int batchSteps = 0;
+
+      /// \brief Called before each iteration of the pending batch.
+      public: std::function<void(const unsigned int)> batchBeforeUpdate;
+
+      /// \brief Called after each iteration of the pending batch.
+      public: std::function<void(const unsigned int)> batchAfterUpdate;
+
       /// \brief Name of the world.
       public: std::string name;
 
@@ -122,6 +158,24 @@ namespace gazebo
       /// \brief Publisher for local pose messages.
       public: transport::PublisherPtr poseLocalPub;
 
+      /// \brief Publisher for compact pose messages.
+      public: transport::PublisherPtr poseCompactPub;
+
+      /// \brief Encoder of the compact pose messages.
+      public: msgs::PoseStreamEncoder poseCompactEncoder;
+
+      /// \brief Compact pose message, reused between publications.
+      public: msgs::PosesCompact poseCompactMsg;
+
+      /// \brief Models which moved since the last compact pose message.
+      public: std::set<ModelPtr> compactPoseModels;
+
+      /// \brief Lights which moved since the last compact pose message.
+      public: std::set<LightPtr> compactPoseLights;
+
+      /// \brief Wall time of the last compact pose message.
+      public: common::Time compactPoseTime;
+
       /// \brief Subscriber to world control messages.
       public: transport::SubscriberPtr controlSub;
 
@@ -158,6 +212,10 @@ namespace gazebo
       /// \brief Function pointer to the model update function.
       public: void (World::*modelUpdateFunc)();
 
+      /// \brief Actors updated together in a model update, reused to avoid
+      /// allocating every iteration.
+      public: Actor_V actorBatch;
+
       /// \brief Last time a world statistics message was sent.
       public: common::Time prevStatTime;
 
@@ -343,6 +401,19 @@ namespace gazebo
       /// physics::Link in World::Update.
       public: std::list<Entity*> dirtyPoses;
 
+      /// \brief Identifies the current set of models in snapshots. Changes
+      /// when a model is added or removed.
+      public: uint64_t layout = 0;
+
+      /// \brief Layout of snapshotLinks and snapshotJoints.
+      public: uint64_t snapshotLayout = 0;
+
+      /// \brief Links saved in snapshots.
+      public: Link_V snapshotLinks;
+
+      /// \brief Joints saved in snapshots.
+      public: Joint_V snapshotJoints;
+
       /// \brief Class to manage preset simulation parameter profiles.
       public: PresetManagerPtr presetManager;
 
@@ -385,6 +456,37 @@ namespace gazebo
 
       /// \brief SDF World DOM object
       public: std::unique_ptr<sdf::World> worldSDFDom;
+
+      /// \brief Bounding boxes of the models and nested models, by model id,
+      /// built by the first model query.
+      public: BoundingBoxTree modelTree;
+
+      /// \brief Models in modelTree, by id.
+      public: std::unordered_map<uint32_t, boost::weak_ptr<Model>>
+              modelTreeModels;
+
+      /// \brief Ids of the actors in modelTree, which move without
+      /// publishing their pose.
+      public: std::set<uint32_t> modelTreeActors;
+
+      /// \brief Models which moved since modelTree was updated, filled from
+      /// publishModelPoses and publishModelScales once modelTree is built.
+      public: std::set<ModelPtr> modelTreeDirty;
+
+      /// \brief Ids of the models removed since modelTree was updated.
+      public: std::vector<uint32_t> modelTreeRemoved;
+
+      /// \brief True once modelTree is built.
+      public: bool modelTreeActive = false;
+
+      /// \brief Incremented when modelTree finds a static model which was
+      /// added, moved or resized, or a removed model.
+      public: uint64_t staticModelsRevision = 0;
+
+      /// \brief Mutex to protect modelTree and staticModelsRevision.
+      /// modelTreeDirty, modelTreeRemoved
+      /// and modelTreeActive are protected by receiveMutex.
+      public: std::mutex modelTreeMutex;
     };
   }
 }
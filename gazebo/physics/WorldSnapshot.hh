@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WORLDSNAPSHOT_HH_
+#define GAZEBO_PHYSICS_WORLDSNAPSHOT_HH_
+
+#include <cstdint>
+#include <vector>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WorldSnapshot WorldSnapshot.hh physics/physics.hh
+    /// \brief Binary copy of the dynamic state of a world, saved by
+    /// World::SaveSnapshot and restored by World::RestoreSnapshot. Unlike
+    /// WorldState, it isn't meant to be serialized or edited: it holds the
+    /// raw state of the physics engine, and it can only be restored in the
+    /// world which saved it, as long as no model was added or removed.
+    /// Saving into the same snapshot again reuses its memory.
+    class GZ_PHYSICS_VISIBLE WorldSnapshot
+    {
+      /// \brief Get the size of the snapshot in memory.
+      /// \return Size in bytes.
+      public: size_t ByteSize() const
+              {
+                return sizeof(*this) + this->data.capacity() * sizeof(double);
+              }
+
+      /// \brief Simulation time.
+      public: common::Time simTime;
+
+      /// \brief Number of iterations.
+      public: uint64_t iterations = 0;
+
+      /// \brief Identifies the models of the world when the snapshot was
+      /// saved, 0 if the snapshot is empty.
+      public: uint64_t layout = 0;
+
+      /// \brief State saved by the physics engine.
+      public: std::vector<double> data;
+    };
+    /// \}
+  }
+}
+#endif
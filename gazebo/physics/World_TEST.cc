@@ -15,6 +15,15 @@
  *
 */
 
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/test/ServerFixture.hh"
@@ -216,6 +225,261 @@ TEST_F(WorldTest, Stop)
   EXPECT_TRUE(world->Running());
 }
 
+//////////////////////////////////////////////////
+/// \brief A batch requested right after Run is stepped by the world thread,
+/// never by the caller at the same time.
+TEST_F(WorldTest, RunThenStepBatch)
+{
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  for (unsigned int i = 0; i < 20; ++i)
+  {
+    world->Stop();
+    EXPECT_FALSE(world->Running());
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    unsigned int calls = 0;
+    auto record = [&](const unsigned int)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          threads.insert(std::this_thread::get_id());
+          ++calls;
+        };
+
+    // The iteration count restarts with the loop, the simulation time
+    // doesn't
+    const common::Time simTime = world->SimTime();
+    world->Run();
+    EXPECT_TRUE(world->StepBatch(10, record, record));
+    EXPECT_NEAR((world->SimTime() - simTime).Double(),
+        10 * world->Physics()->GetMaxStepSize(), 1e-9);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(20u, calls);
+    ASSERT_EQ(1u, threads.size());
+    EXPECT_NE(std::this_thread::get_id(), *threads.begin());
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the world poses and velocities of all the links of a world.
+/// \param[in] _world World.
+/// \return Pose and velocity values.
+static std::vector<double> linkStates(physics::WorldPtr _world)
+{
+  std::vector<double> states;
+  for (auto const &model : _world->Models())
+  {
+    for (auto const &link : model->GetLinks())
+    {
+      ignition::math::Pose3d pose = link->WorldPose();
+      ignition::math::Vector3d vel = link->WorldLinearVel();
+      ignition::math::Vector3d angVel = link->WorldAngularVel();
+      states.insert(states.end(), {pose.Pos().X(), pose.Pos().Y(),
+          pose.Pos().Z(), pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(),
+          pose.Rot().Z(), vel.X(), vel.Y(), vel.Z(), angVel.X(), angVel.Y(),
+          angVel.Z()});
+    }
+  }
+  return states;
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Snapshot)
+{
+  // Stacks of boxes, with a box falling on one of them and a pendulum
+  this->Load("worlds/stacks.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  this->SpawnBox("falling_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0.4, 0.3, 6));
+  this->WaitUntilEntitySpawn("falling_box", 100, 100);
+
+  std::ostringstream sdfStr;
+  sdfStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='pendulum'><pose>5 5 3 0 0 0</pose>"
+    << "<link name='arm'><pose>0.5 0 0 0 0 0</pose>"
+    << "<collision name='collision'><geometry><box>"
+    << "<size>1 0.1 0.1</size></box></geometry></collision></link>"
+    << "<joint name='hinge' type='revolute'>"
+    << "<parent>world</parent><child>arm</child>"
+    << "<pose>-0.5 0 0 0 0 0</pose>"
+    << "<axis><xyz>0 1 0</xyz></axis></joint>"
+    << "</model></sdf>";
+  this->SpawnSDF(sdfStr.str());
+  this->WaitUntilEntitySpawn("pendulum", 100, 100);
+  ASSERT_NE(nullptr, world->ModelByName("pendulum"));
+
+  world->Step(300);
+
+  physics::WorldSnapshot snapshot;
+  EXPECT_EQ(0u, snapshot.layout);
+  EXPECT_FALSE(world->RestoreSnapshot(snapshot));
+
+  world->SaveSnapshot(snapshot);
+  EXPECT_NE(0u, snapshot.layout);
+  EXPECT_GT(snapshot.ByteSize(), snapshot.data.size() * sizeof(double));
+  const std::vector<double> savedStates = linkStates(world);
+  const common::Time savedTime = world->SimTime();
+  const uint64_t savedIterations = world->Iterations();
+
+  world->Step(700);
+  const std::vector<double> states = linkStates(world);
+  const double pendulumAngle =
+      world->ModelByName("pendulum")->GetJoint("hinge")->Position(0);
+  EXPECT_NE(savedStates, states);
+
+  // The restored world is where it was
+  ASSERT_TRUE(world->RestoreSnapshot(snapshot));
+  EXPECT_EQ(savedTime, world->SimTime());
+  EXPECT_EQ(savedIterations, world->Iterations());
+  EXPECT_EQ(savedStates, linkStates(world));
+
+  // And it follows the same trajectory, several times
+  for (int i = 0; i < 3; ++i)
+  {
+    world->Step(700);
+    std::vector<double> replayed = linkStates(world);
+    ASSERT_EQ(states.size(), replayed.size());
+    for (size_t j = 0; j < states.size(); ++j)
+      EXPECT_NEAR(states[j], replayed[j], 1e-9) << i << " " << j;
+    EXPECT_NEAR(pendulumAngle,
+        world->ModelByName("pendulum")->GetJoint("hinge")->Position(0),
+        1e-9);
+
+    ASSERT_TRUE(world->RestoreSnapshot(snapshot));
+  }
+
+  // Snapshots can't be restored once the models changed
+  world->RemoveModel("falling_box");
+  EXPECT_FALSE(world->RestoreSnapshot(snapshot));
+  world->SaveSnapshot(snapshot);
+  EXPECT_TRUE(world->RestoreSnapshot(snapshot));
+}
+
+//////////////////////////////////////////////////
+/// \brief Get whether each link of a world is enabled.
+/// \param[in] _world World.
+/// \return Enabled flags.
+static std::vector<bool> linksEnabled(physics::WorldPtr _world)
+{
+  std::vector<bool> enabled;
+  for (auto const &model : _world->Models())
+  {
+    for (auto const &link : model->GetLinks())
+      enabled.push_back(link->GetEnabled());
+  }
+  return enabled;
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, SnapshotAutoDisable)
+{
+  // Resting stacks of boxes, which are disabled once their velocities
+  // averaged over several steps stay below the thresholds
+  this->Load("worlds/stacks.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+  ASSERT_TRUE(world->Physics()->SetParam("auto_disable_average_samples", 10));
+
+  world->Step(500);
+
+  physics::WorldSnapshot snapshot;
+  world->SaveSnapshot(snapshot);
+
+  std::vector<std::vector<bool>> enabled;
+  for (int i = 0; i < 1000; ++i)
+  {
+    world->Step(1);
+    enabled.push_back(linksEnabled(world));
+  }
+  EXPECT_NE(enabled.front(), enabled.back());
+
+  // The links of the restored world are disabled at the same steps
+  ASSERT_TRUE(world->RestoreSnapshot(snapshot));
+  for (int i = 0; i < 1000; ++i)
+  {
+    world->Step(1);
+    ASSERT_EQ(enabled[i], linksEnabled(world)) << i;
+  }
+
+  // Snapshots can't be restored once the number of samples changed
+  ASSERT_TRUE(world->Physics()->SetParam("auto_disable_average_samples", 5));
+  EXPECT_FALSE(world->RestoreSnapshot(snapshot));
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the names of models.
+std::set<std::string> modelNames(const physics::Model_V &_models)
+{
+  std::set<std::string> names;
+  for (auto const &model : _models)
+    names.insert(model->GetScopedName());
+  return names;
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, ModelQueries)
+{
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  this->SpawnBox("box_a", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(5, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  this->SpawnBox("box_b", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(5, 6, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  this->SpawnBox("box_c", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(-5, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  this->WaitUntilEntitySpawn("box_a", 100, 100);
+  this->WaitUntilEntitySpawn("box_b", 100, 100);
+  this->WaitUntilEntitySpawn("box_c", 100, 100);
+
+  // Camera at the origin looking along +X
+  ignition::math::Frustum frustum(0.1, 10, IGN_DTOR(60), 1.33,
+      ignition::math::Pose3d(0, 0, 0.5, 0, 0, 0));
+  EXPECT_EQ(std::set<std::string>({"box_a"}),
+      modelNames(world->ModelsInFrustum(frustum)));
+  EXPECT_EQ(std::set<std::string>({"box_b"}),
+      modelNames(world->ModelsInSphere(
+      ignition::math::Vector3d(5, 5, 0.5), 1)));
+
+  // Moved models are found at their new pose
+  world->ModelByName("box_c")->SetWorldPose(
+      ignition::math::Pose3d(8, 1, 0.5, 0, 0, 0));
+  EXPECT_EQ(std::set<std::string>({"box_a", "box_c"}),
+      modelNames(world->ModelsInFrustum(frustum)));
+
+  world->Step(10);
+  world->ModelByName("box_a")->SetWorldPose(
+      ignition::math::Pose3d(0, -5, 0.5, 0, 0, 0));
+  world->Step(10);
+  EXPECT_EQ(std::set<std::string>({"box_c"}),
+      modelNames(world->ModelsInFrustum(frustum)));
+  EXPECT_EQ(std::set<std::string>({"box_a"}),
+      modelNames(world->ModelsInSphere(
+      ignition::math::Vector3d(0, -4, 0.5), 1)));
+
+  // Removed models aren't
+  world->RemoveModel("box_c");
+  EXPECT_TRUE(world->ModelsInFrustum(frustum).empty());
+
+  // Same results as testing every model
+  for (auto const &model : world->Models())
+  {
+    EXPECT_EQ(frustum.Contains(model->BoundingBox()),
+        modelNames(world->ModelsInFrustum(frustum)).count(
+        model->GetScopedName()) == 1);
+  }
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -28,12 +28,50 @@
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Bullet heightfield reading its heights from a tiled
+  /// HeightmapShape instead of a dense array.
+  class TiledHeightfieldTerrainShape : public btHeightfieldTerrainShape
+  {
+    /// \brief Constructor.
+    /// \param[in] _shape Heightmap providing the heights.
+    /// \param[in] _minHeight Minimum height.
+    /// \param[in] _maxHeight Maximum height.
+    public: TiledHeightfieldTerrainShape(const HeightmapShape *_shape,
+                const float _minHeight, const float _maxHeight)
+      : btHeightfieldTerrainShape(
+          _shape->VertexCount().X(),  // # of heights along width
+          _shape->VertexCount().Y(),  // # of height along height
+          _shape,       // Never dereferenced, see getRawHeightFieldValue
+          1,            // Height scaling
+          _minHeight,   // Min height
+          _maxHeight,   // Max height
+          2,            // Up axis
+          PHY_FLOAT,
+          false),       // Flip quad edges
+        shape(_shape)
+    {
+    }
+
+    // Documentation inherited
+    protected: virtual btScalar getRawHeightFieldValue(int _x, int _y) const
+    {
+      return this->shape->GetHeight(_x, _y);
+    }
+
+    /// \brief Heightmap providing the heights.
+    private: const HeightmapShape *shape;
+  };
+}
+
 //////////////////////////////////////////////////
 BulletHeightmapShape::BulletHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
 {
   // Bullet need the height values flipped in the y direction
   this->flipY = true;
+  this->tilingSupported = true;
 }
 
 //////////////////////////////////////////////////
@@ -53,16 +91,24 @@ void BulletHeightmapShape::Init()
   int upIndex = 2;
   btVector3 localScaling(this->scale.X(), this->scale.Y(), 1.0);
 
-  this->heightFieldShape  = new btHeightfieldTerrainShape(
-      this->vertSize,     // # of heights along width
-      this->vertSize,     // # of height along height
-      &this->heights[0],  // The heights
-      1,                  // Height scaling
-      minHeight,          // Min height
-      maxHeight,          // Max height
-      upIndex,            // Up axis
-      PHY_FLOAT,
-      false);             // Flip quad edges
+  if (this->TilingEnabled())
+  {
+    this->heightFieldShape =
+        new TiledHeightfieldTerrainShape(this, minHeight, maxHeight);
+  }
+  else
+  {
+    this->heightFieldShape  = new btHeightfieldTerrainShape(
+        this->vertSize,     // # of heights along width
+        this->vertSize,     // # of height along height
+        &this->heights[0],  // The heights
+        1,                  // Height scaling
+        minHeight,          // Min height
+        maxHeight,          // Max height
+        upIndex,            // Up axis
+        PHY_FLOAT,
+        false);             // Flip quad edges
+  }
 
   this->heightFieldShape->setLocalScaling(localScaling);
 
@@ -16,6 +16,9 @@
 */
 
 #include <algorithm>
+#include <map>
+#include <mutex>
+#include <set>
 #include <string>
 
 #include <ignition/common/Profiler.hh>
@@ -238,6 +241,49 @@ void InternalTickCallback(btDynamicsWorld *_world, btScalar _timeStep)
   UpdateContacts(_world, _timeStep);
 }
 
+#if BT_BULLET_VERSION >= 287
+//////////////////////////////////////////////////
+/// \brief Get one of the task schedulers shipped with Bullet. Bullet uses a
+/// single global scheduler, so schedulers are created once and shared by all
+/// the BulletPhysics instances.
+/// \param[in] _name One of "default", "openmp", "tbb", "ppl" or
+/// "sequential".
+/// \return The scheduler, or the sequential one if Bullet was built without
+/// the requested scheduler.
+static btITaskScheduler *BulletTaskScheduler(const std::string &_name)
+{
+  static std::mutex mutex;
+  static std::map<std::string, btITaskScheduler *> schedulers;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto iter = schedulers.find(_name);
+  if (iter != schedulers.end())
+    return iter->second;
+
+  btITaskScheduler *scheduler = nullptr;
+  if (_name == "default")
+    scheduler = btCreateDefaultTaskScheduler();
+  else if (_name == "openmp")
+    scheduler = btGetOpenMPTaskScheduler();
+  else if (_name == "tbb")
+    scheduler = btGetTBBTaskScheduler();
+  else if (_name == "ppl")
+    scheduler = btGetPPLTaskScheduler();
+  else
+    scheduler = btGetSequentialTaskScheduler();
+
+  if (!scheduler)
+  {
+    gzwarn << "Bullet was built without the [" << _name << "] task "
+           << "scheduler, steps will run on a single thread" << std::endl;
+    scheduler = btGetSequentialTaskScheduler();
+  }
+
+  schedulers[_name] = scheduler;
+  return scheduler;
+}
+#endif
+
 //////////////////////////////////////////////////
 bool ContactCallback(btManifoldPoint &_cp,
     const btCollisionObjectWrapper *_obj0, int /*_partId0*/, int /*_index0*/,
@@ -263,13 +309,23 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
     : PhysicsEngine(_world)
 {
   // This function currently follows the pattern of bullet/Demos/HelloWorld
+  this->CreateDynamicsWorld(false);
+
+  // TODO: Enable this to do custom contact setting
+  gContactAddedCallback = ContactCallback;
+  gContactProcessedCallback = ContactProcessed;
+
+  // Set random seed for physics engine based on gazebo's random seed.
+  // Note: this was moved from physics::PhysicsEngine constructor.
+  this->SetSeed(ignition::math::Rand::Seed());
+}
 
+//////////////////////////////////////////////////
+void BulletPhysics::CreateDynamicsWorld(const bool _multithreaded)
+{
   // Default setup for memory and collisions
   this->collisionConfig = new btDefaultCollisionConfiguration();
 
-  // Default collision dispatcher, a multi-threaded dispatcher may be available
-  this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
-
   // Broadphase collision detection uses axis-aligned bounding boxes (AABB)
   // to detect pairs of objects that may be in contact.
   // The narrow-phase collision detection evaluates each pair generated by the
@@ -282,34 +338,80 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // Here we are using btDbvtBroadphase.
   this->broadPhase = new btDbvtBroadphase();
 
-  // Create btSequentialImpulseConstraintSolver, the default constraint solver.
-  // Note that a multi-threaded solver may be available.
-  this->solver = new btSequentialImpulseConstraintSolver;
+#if BT_BULLET_VERSION >= 287
+  if (_multithreaded)
+  {
+    // The multithreaded pipeline runs the narrowphase over the overlapping
+    // pairs in parallel, and solves the simulation islands in parallel with
+    // a pool of btSequentialImpulseConstraintSolver. The work is spread by
+    // the global Bullet task scheduler, see SetThreading.
+    this->dispatcher = new btCollisionDispatcherMt(this->collisionConfig);
+    this->solverPool = new btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT);
+    this->dynamicsWorld = new btDiscreteDynamicsWorldMt(this->dispatcher,
+        this->broadPhase, this->solverPool,
+#if BT_BULLET_VERSION >= 288
+        nullptr,
+#endif
+        this->collisionConfig);
+  }
+  else
+#endif
+  {
+    GZ_ASSERT(!_multithreaded,
+        "Multithreaded Bullet pipeline requires Bullet 2.87 or newer");
+
+    // Default collision dispatcher
+    this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
+
+    // Create btSequentialImpulseConstraintSolver, the default constraint
+    // solver.
+    this->solver = new btSequentialImpulseConstraintSolver;
 
-  // Create a btDiscreteDynamicsWorld, which is used for discrete rigid bodies.
-  // An alternative is btSoftRigidDynamicsWorld, which handles both soft and
-  // rigid bodies.
-  this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
-      this->broadPhase, this->solver, this->collisionConfig);
+    // Create a btDiscreteDynamicsWorld, which is used for discrete rigid
+    // bodies. An alternative is btSoftRigidDynamicsWorld, which handles both
+    // soft and rigid bodies.
+    this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
+        this->broadPhase, this->solver, this->collisionConfig);
+  }
 
-  btOverlapFilterCallback *filterCallback = new CollisionFilter();
+  this->filterCallback = new CollisionFilter();
   btOverlappingPairCache* pairCache = this->dynamicsWorld->getPairCache();
   GZ_ASSERT(pairCache != nullptr,
       "Bullet broadphase overlapping pair cache is null");
-  pairCache->setOverlapFilterCallback(filterCallback);
-
-  // TODO: Enable this to do custom contact setting
-  gContactAddedCallback = ContactCallback;
-  gContactProcessedCallback = ContactProcessed;
+  pairCache->setOverlapFilterCallback(this->filterCallback);
 
   this->dynamicsWorld->setInternalTickCallback(
       InternalTickCallback, static_cast<void *>(this));
 
-  // Set random seed for physics engine based on gazebo's random seed.
-  // Note: this was moved from physics::PhysicsEngine constructor.
-  this->SetSeed(ignition::math::Rand::Seed());
+  btGImpactCollisionAlgorithm::registerAlgorithm(this->dispatcher);
+}
+
+//////////////////////////////////////////////////
+void BulletPhysics::DestroyDynamicsWorld()
+{
+  // Delete in reverse-order of creation
+  delete this->filterCallback;
+  this->filterCallback = nullptr;
+
+  delete this->dynamicsWorld;
+  this->dynamicsWorld = nullptr;
+
+  delete this->solver;
+  this->solver = nullptr;
+
+#if BT_BULLET_VERSION >= 287
+  delete this->solverPool;
+#endif
+  this->solverPool = nullptr;
+
+  delete this->dispatcher;
+  this->dispatcher = nullptr;
+
+  delete this->broadPhase;
+  this->broadPhase = nullptr;
 
-  btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
+  delete this->collisionConfig;
+  this->collisionConfig = nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -325,6 +427,19 @@ void BulletPhysics::Load(sdf::ElementPtr _sdf)
 
   sdf::ElementPtr bulletElem = this->sdf->GetElement("bullet");
 
+  // Multithreaded stepping is configured with the optional <threads> and
+  // <task_scheduler> elements of <solver>. The dynamics world is still
+  // empty, so it can be replaced.
+  sdf::ElementPtr solverElem = bulletElem->GetElement("solver");
+  int threads = this->threads;
+  std::string scheduler = this->taskScheduler;
+  if (solverElem->HasElement("threads"))
+    threads = solverElem->Get<int>("threads");
+  if (solverElem->HasElement("task_scheduler"))
+    scheduler = solverElem->Get<std::string>("task_scheduler");
+  if (!this->SetThreading(threads, scheduler))
+    gzerr << "Unable to set up Bullet with [" << threads << "] threads\n";
+
   auto g = this->world->Gravity();
   // ODEPhysics checks this, so we will too.
   if (g == ignition::math::Vector3d::Zero)
@@ -533,26 +648,7 @@ void BulletPhysics::UpdatePhysics()
 //////////////////////////////////////////////////
 void BulletPhysics::Fini()
 {
-  // Delete in reverse-order of creation
-  if (this->dynamicsWorld)
-    delete this->dynamicsWorld;
-  this->dynamicsWorld = nullptr;
-
-  if (this->solver)
-    delete this->solver;
-  this->solver = nullptr;
-
-  if (this->broadPhase)
-    delete this->broadPhase;
-  this->broadPhase = nullptr;
-
-  if (this->dispatcher)
-    delete this->dispatcher;
-  this->dispatcher = nullptr;
-
-  if (this->collisionConfig)
-    delete this->collisionConfig;
-  this->collisionConfig = nullptr;
+  this->DestroyDynamicsWorld();
 
   PhysicsEngine::Fini();
 }
@@ -568,6 +664,82 @@ void BulletPhysics::Reset()
 
 //////////////////////////////////////////////////
 
+//////////////////////////////////////////////////
+bool BulletPhysics::SetThreading(const int _threads,
+    const std::string &_scheduler)
+{
+  if (_threads < 0)
+  {
+    gzerr << "Number of Bullet threads must be positive, or zero to use "
+          << "every thread of the task scheduler" << std::endl;
+    return false;
+  }
+
+  static const std::set<std::string> kTaskSchedulers =
+      {"default", "openmp", "tbb", "ppl", "sequential"};
+  if (kTaskSchedulers.count(_scheduler) == 0)
+  {
+    gzerr << "Unknown Bullet task scheduler [" << _scheduler << "], expected "
+          << "default, openmp, tbb, ppl or sequential" << std::endl;
+    return false;
+  }
+
+  const bool multithreaded = _threads != 1;
+
+#if BT_BULLET_VERSION >= 287
+  // Only create the scheduler, and its threads, when it is used
+  btITaskScheduler *scheduler = nullptr;
+  if (multithreaded)
+    scheduler = BulletTaskScheduler(_scheduler);
+#else
+  if (multithreaded)
+  {
+    gzerr << "Multithreaded stepping requires Bullet 2.87 or newer"
+          << std::endl;
+    return false;
+  }
+#endif
+
+  // need to lock, otherwise might conflict with a running step
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  if (multithreaded != (this->solverPool != nullptr))
+  {
+    // Links and joints keep pointers to the dynamics world, so it can only
+    // be replaced while it is empty
+    if (this->dynamicsWorld->getNumCollisionObjects() > 0 ||
+        this->dynamicsWorld->getNumConstraints() > 0)
+    {
+      gzerr << "Bullet can only switch between single and multithreaded "
+            << "stepping before any model is loaded" << std::endl;
+      return false;
+    }
+
+    btContactSolverInfo info = this->dynamicsWorld->getSolverInfo();
+    btVector3 gravity = this->dynamicsWorld->getGravity();
+
+    this->DestroyDynamicsWorld();
+    this->CreateDynamicsWorld(multithreaded);
+
+    this->dynamicsWorld->getSolverInfo() = info;
+    this->dynamicsWorld->setGravity(gravity);
+  }
+
+#if BT_BULLET_VERSION >= 287
+  if (scheduler)
+  {
+    btSetTaskScheduler(scheduler);
+    int maxThreads = scheduler->getMaxNumThreads();
+    scheduler->setNumThreadsUsed(
+        _threads == 0 ? maxThreads : std::min(_threads, maxThreads));
+  }
+#endif
+
+  this->threads = _threads;
+  this->taskScheduler = _scheduler;
+  return true;
+}
+
 //////////////////////////////////////////////////
 void BulletPhysics::SetSORPGSIters(unsigned int _iters)
 {
@@ -659,6 +831,15 @@ bool BulletPhysics::SetParam(const std::string &_key, const boost::any &_value)
       double value = any_cast<double>(_value);
       bulletElem->GetElement("solver")->GetElement("min_step_size")->Set(value);
     }
+    else if (_key == "threads")
+    {
+      return this->SetThreading(any_cast<int>(_value), this->taskScheduler);
+    }
+    else if (_key == "task_scheduler")
+    {
+      return this->SetThreading(this->threads,
+          any_cast<std::string>(_value));
+    }
     else
     {
       return PhysicsEngine::SetParam(_key, _value);
@@ -721,6 +902,10 @@ bool BulletPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->sdf->GetElement("max_contacts")->Get<int>();
   else if (_key == "min_step_size")
     _value = bulletElem->GetElement("solver")->Get<double>("min_step_size");
+  else if (_key == "threads")
+    _value = this->threads;
+  else if (_key == "task_scheduler")
+    _value = this->taskScheduler;
   else
   {
     return PhysicsEngine::GetParam(_key, _value);
@@ -32,6 +32,8 @@
 #include "gazebo/physics/Shape.hh"
 #include "gazebo/util/system.hh"
 
+class btConstraintSolverPoolMt;
+
 namespace gazebo
 {
   namespace physics
@@ -158,7 +160,21 @@ namespace gazebo
 
       public: virtual void DebugPrint() const;
 
-      /// Documentation inherited
+      /// \brief Set a parameter of the Bullet engine. Besides the keys of
+      /// the SDF <bullet> element, "threads" (int) sets the number of
+      /// threads used to step the world: 1 keeps the single-threaded
+      /// btDiscreteDynamicsWorld, any other value uses
+      /// btDiscreteDynamicsWorldMt, and 0 uses every thread of the task
+      /// scheduler. "task_scheduler" (string) selects the Bullet task
+      /// scheduler: "default", "openmp", "tbb", "ppl" or "sequential".
+      /// Both can also be set with <threads> and <task_scheduler> in the
+      /// <solver> element. Switching between single and multithreaded
+      /// stepping is only possible before any model is loaded. The task
+      /// scheduler is global to Bullet, so it is shared by every world of
+      /// the process.
+      /// \param[in] _key Parameter name.
+      /// \param[in] _value Parameter value.
+      /// \return True if the parameter was set.
       public: virtual bool SetParam(const std::string &_key,
                   const boost::any &_value);
 
@@ -172,11 +188,43 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSORPGSIters(unsigned int iters);
 
-      private: btBroadphaseInterface *broadPhase;
-      private: btDefaultCollisionConfiguration *collisionConfig;
-      private: btCollisionDispatcher *dispatcher;
-      private: btSequentialImpulseConstraintSolver *solver;
-      private: btDiscreteDynamicsWorld *dynamicsWorld;
+      /// \brief Create the collision dispatcher, broadphase, constraint
+      /// solver and dynamics world.
+      /// \param[in] _multithreaded True to create the multithreaded
+      /// pipeline, which requires Bullet 2.87 or newer.
+      private: void CreateDynamicsWorld(const bool _multithreaded);
+
+      /// \brief Delete everything created by CreateDynamicsWorld.
+      private: void DestroyDynamicsWorld();
+
+      /// \brief Set the number of threads and the task scheduler, replacing
+      /// the dynamics world if it switches between single and
+      /// multithreaded stepping.
+      /// \param[in] _threads Number of threads, see SetParam.
+      /// \param[in] _scheduler Name of the task scheduler.
+      /// \return False if the values are invalid or the world can't be
+      /// replaced.
+      private: bool SetThreading(const int _threads,
+                   const std::string &_scheduler);
+
+      private: btBroadphaseInterface *broadPhase = nullptr;
+      private: btDefaultCollisionConfiguration *collisionConfig = nullptr;
+      private: btCollisionDispatcher *dispatcher = nullptr;
+      private: btSequentialImpulseConstraintSolver *solver = nullptr;
+      private: btDiscreteDynamicsWorld *dynamicsWorld = nullptr;
+
+      /// \brief Constraint solvers of the multithreaded pipeline, null
+      /// when stepping on a single thread.
+      private: btConstraintSolverPoolMt *solverPool = nullptr;
+
+      /// \brief Filter of the broadphase pairs.
+      private: btOverlapFilterCallback *filterCallback = nullptr;
+
+      /// \brief Number of threads used to step the world.
+      private: int threads = 1;
+
+      /// \brief Name of the Bullet task scheduler.
+      private: std::string taskScheduler = "default";
 
       private: common::Time lastUpdateTime;
 
@@ -256,6 +256,8 @@ void DARTLink::Init()
 //////////////////////////////////////////////////
 void DARTLink::Fini()
 {
+  if (this->dataPtr->dartPhysics)
+    this->dataPtr->dartPhysics->BodyNodeLinksChanged();
   Link::Fini();
 }
 
@@ -997,6 +999,8 @@ DARTBodyNodePropPtr DARTLink::DARTProperties() const
 void DARTLink::SetDARTBodyNode(dart::dynamics::BodyNode *_dtBodyNode)
 {
   this->dataPtr->dtBodyNode = _dtBodyNode;
+  if (this->dataPtr->dartPhysics)
+    this->dataPtr->dartPhysics->BodyNodeLinksChanged();
 }
 
 //////////////////////////////////////////////////
@@ -15,6 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+
 // required for HAVE_DART_BULLET define
 #include <gazebo/gazebo_config.h>
 
@@ -97,6 +102,21 @@ void DARTPhysics::Load(sdf::ElementPtr _sdf)
   if (g == ignition::math::Vector3d::Zero)
     gzwarn << "Gravity vector is (0, 0, 0). Objects will float.\n";
   this->dataPtr->dtWorld->setGravity(Eigen::Vector3d(g.X(), g.Y(), g.Z()));
+
+  // Contacts detected by DART and reported per link pair
+  this->dataPtr->maxContacts = _sdf->Get<unsigned int>("max_contacts");
+  this->dataPtr->dtWorld->getConstraintSolver()->getCollisionOption()
+      .maxNumContacts = this->dataPtr->maxContacts;
+
+  if (_sdf->HasElement("dart"))
+  {
+    sdf::ElementPtr dartElem = _sdf->GetElement("dart");
+    if (dartElem->HasElement("collision_detector"))
+    {
+      this->SetParam("collision_detector",
+          dartElem->Get<std::string>("collision_detector"));
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -131,95 +151,6 @@ void DARTPhysics::InitForThread()
 }
 
 
-//////////////////////////////////////////////////
-// Helper class to maintain unique pairs of links in maps
-class LinkPair
-{
-  /// \brief Constructor.
-  /// \param _link1[in] and _link2[in] are the DART links for the contact.
-  ///   Their order may be swapped around.
-  public: LinkPair(const DARTLinkPtr &_link1,
-                   const DARTLinkPtr &_link2)
-          {
-            this->SetDARTLinks(_link1, _link2);
-          }
-
-  /// \brief Copy constructor
-  public: LinkPair(const LinkPair&_linkPair):
-            dtLink1(_linkPair.dtLink1),
-            dtLink2(_linkPair.dtLink2)
-          {}
-
-  /// \brief Destructor.
-  public: virtual ~LinkPair() {}
-
-  /// \brief Comparison operator
-  /// which always chooses the link which evaluates to lower by operator <
-  /// \param[in] _dtLink1 the first link
-  /// \param[in] _dtLink2 the second link
-  public: void SetDARTLinks(const DARTLinkPtr &_dtLink1,
-                            const DARTLinkPtr &_dtLink2)
-          {
-            if (cmpLink(_dtLink1, _dtLink2) < 0)
-            {
-              this->dtLink1 = _dtLink1;
-              this->dtLink2 = _dtLink2;
-            }
-            else
-            {
-              this->dtLink2 = _dtLink1;
-              this->dtLink1 = _dtLink2;
-            }
-          }
-
-  /// \brief Assignment operator
-  /// \param[in] _c Link pair to copy
-  /// \return *this
-  public: LinkPair &operator =(const LinkPair& _linkPair)
-          {
-            this->dtLink1 = _linkPair.dtLink1;
-            this->dtLink2 = _linkPair.dtLink2;
-            return *this;
-          }
-
-  /// \brief Comparison operator
-  /// \param[in] c the link pair
-  /// \return true if this is lower than \e c
-  public: bool operator<(const LinkPair& c) const
-          {
-            int cmp1 = cmpLink(this->dtLink1, c.dtLink1);
-            if (cmp1 < 0) return true;
-            int cmp2 = cmpLink(this->dtLink2, c.dtLink2);
-            return (cmp1 == 0) && (cmp2 < 0);
-          }
-
-  // \brief returns the first link
-  public: DARTLinkPtr DARTLink1() const { return this->dtLink1; }
-
-  // \brief returns the second link
-  public: DARTLinkPtr DARTLink2() const { return this->dtLink2; }
-
-  // \brief internally used comparison operator for links
-  // \param[in] l1 the first link
-  // \param[in] l2 the second link
-  // \retval -1 l1 < l2
-  // \retval 0 l1 == l2
-  // \retval 1 l1 > l2
-  private: int cmpLink(const DARTLinkPtr &l1, const DARTLinkPtr &l2) const
-           {
-            // Comparing by address is required because names can be
-            // the same for different links. Could use the model name of the
-            // link in addition, but that's even more expensive.
-             return l1.get() < l2.get() ? -1 : l1.get() == l2.get() ? 0 : 1;
-           }
-
-  /// \brief Pointer to the first link object
-  private: DARTLinkPtr dtLink1;
-
-  /// \brief Pointer to the second link object
-  private: DARTLinkPtr dtLink2;
-};
-
 //////////////////////////////////////////////////
 static DARTLinkPtr StaticFindDARTLink(
     DARTPhysics *_dtPhysics,
@@ -251,35 +182,75 @@ static DARTLinkPtr StaticFindDARTLink(
 }
 
 //////////////////////////////////////////////////
-static void RetrieveDARTCollisions(
-    DARTPhysics* _dtPhysics,
-    const dart::collision::CollisionResult *_dtLastResult,
-    ContactManager *_mgr)
+/// \brief Add the body nodes of the links of models and of their nested
+/// models to a table.
+/// \param[in] _models Models whose links are added.
+/// \param[in,out] _table Table of body nodes and links.
+static void addBodyNodeLinks(const Model_V &_models,
+    std::vector<std::pair<const dart::dynamics::BodyNode *, DARTLink *>>
+    &_table)
 {
-  _mgr->ResetCount();
-  int numContacts = _dtLastResult->getNumContacts();
+  for (auto const &model : _models)
+  {
+    for (auto const &link : model->GetLinks())
+    {
+      DARTLink *dartLink = dynamic_cast<DARTLink *>(link.get());
+      if (dartLink && dartLink->DARTBodyNode())
+        _table.emplace_back(dartLink->DARTBodyNode(), dartLink);
+    }
+    addBodyNodeLinks(model->NestedModels(), _table);
+  }
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::BodyNodeLinksChanged()
+{
+  this->dataPtr->bodyNodeLinksDirty = true;
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::RetrieveDARTCollisions(
+    const dart::collision::CollisionResult &_dtResult)
+{
+  ContactManager *mgr = this->GetContactManager();
+  mgr->ResetCount();
+  const std::size_t numContacts = _dtResult.getNumContacts();
+  if (numContacts == 0)
+    return;
+
+  // Map the DART body nodes to the Gazebo links. The table is only built
+  // again when links are added or removed, and the contact buffer is kept
+  // between steps, so they don't allocate once they've grown to the size
+  // of the scene.
+  auto &bodyNodeLinks = this->dataPtr->bodyNodeLinks;
+  if (this->dataPtr->bodyNodeLinksDirty.exchange(false))
+  {
+    bodyNodeLinks.clear();
+    addBodyNodeLinks(this->world->Models(), bodyNodeLinks);
+    std::sort(bodyNodeLinks.begin(), bodyNodeLinks.end());
+  }
+
+  auto findLink = [&bodyNodeLinks](const dart::dynamics::BodyNode *_node)
+      -> DARTLink *
+  {
+    auto iter = std::lower_bound(bodyNodeLinks.begin(), bodyNodeLinks.end(),
+        std::make_pair(_node, static_cast<DARTLink *>(nullptr)));
+    if (iter == bodyNodeLinks.end() || iter->first != _node)
+      return nullptr;
+    return iter->second;
+  };
 
   // DART returns all contact points individually, without grouping
   // them to link pairs first. The majority of the Gazebo code assumes
   // the contacts will come per link pair (e.g. all contacts of
   // link1 and link2 grouped together in one Contact object).
-  // We will have to do this mapping here first.
-  // This could be skipped for performance reasons by supplying
-  // an additional std::vector<std::pair<LinkPair, dart::collision::Contact>
-  // which is just filled with duplicates, skipping the map step.
-
-  typedef std::map<LinkPair, std::deque<const dart::collision::Contact*>>
-    PairedContactsMap;
-  // Attention: The map uses a reference to dart::collision::Contact&, but this
-  // is retrieved from dtLastResult directly and used only within this function,
-  // so it will be safe to use within the scope of this function.
-  PairedContactsMap pairedContacts;
-
-  // insert all the contacts
-  for (int i = 0; i < numContacts; ++i)
+  // Tag each contact with its link pair, ordered by address, and sort them
+  // so that the contacts of a pair are next to each other.
+  auto &pairedContacts = this->dataPtr->pairedContacts;
+  pairedContacts.clear();
+  for (std::size_t i = 0; i < numContacts; ++i)
   {
-    const dart::collision::Contact &dtContact =
-        _dtLastResult->getContact(i);
+    const dart::collision::Contact &dtContact = _dtResult.getContact(i);
 
     dart::collision::CollisionObject *dtCollObj1 = dtContact.collisionObject1;
     dart::collision::CollisionObject *dtCollObj2 = dtContact.collisionObject2;
@@ -287,9 +258,6 @@ static void RetrieveDARTCollisions(
     GZ_ASSERT(dtCollObj1, "collision object 1 is null!");
     GZ_ASSERT(dtCollObj2, "collision object 2 is null!");
 
-    dart::dynamics::ConstBodyNodePtr dtBodyNode1;
-    dart::dynamics::ConstBodyNodePtr dtBodyNode2;
-
     const dart::dynamics::ShapeFrame *dtShapeFrame1 =
       dtCollObj1->getShapeFrame();
     const dart::dynamics::ShapeFrame *dtShapeFrame2 =
@@ -297,36 +265,56 @@ static void RetrieveDARTCollisions(
 
     GZ_ASSERT(dtShapeFrame1, "shape frame 1 is null!");
     GZ_ASSERT(dtShapeFrame2, "shape frame 2 is null!");
-    GZ_ASSERT(dtShapeFrame1->asShapeNode(), "shape frame 1 is no shape node!");
-    GZ_ASSERT(dtShapeFrame2->asShapeNode(), "shape frame 2 is no shape node!");
 
-    if (dtShapeFrame1->isShapeNode())
-      dtBodyNode1 = dtShapeFrame1->asShapeNode()->getBodyNodePtr();
-    if (dtShapeFrame2->isShapeNode())
-      dtBodyNode2 = dtShapeFrame2->asShapeNode()->getBodyNodePtr();
-
-    GZ_ASSERT(dtBodyNode1, "body node 1 is null!");
-    GZ_ASSERT(dtBodyNode2, "body node 2 is null!");
+    if (!dtShapeFrame1->isShapeNode() || !dtShapeFrame2->isShapeNode())
+      continue;
 
-    DARTLinkPtr dartLink1 = StaticFindDARTLink(_dtPhysics, dtBodyNode1);
-    DARTLinkPtr dartLink2 = StaticFindDARTLink(_dtPhysics, dtBodyNode2);
+    DARTLink *dartLink1 =
+      findLink(dtShapeFrame1->asShapeNode()->getBodyNodePtr().get());
+    DARTLink *dartLink2 =
+      findLink(dtShapeFrame2->asShapeNode()->getBodyNodePtr().get());
 
     GZ_ASSERT(dartLink1, "dartLink1 in collision pair is null");
     GZ_ASSERT(dartLink2, "dartLink2 in collision pair is null");
 
-    LinkPair dtLinkPair(dartLink1, dartLink2);
-    pairedContacts[dtLinkPair].push_back(&dtContact);
+    if (!dartLink1 || !dartLink2)
+      continue;
+
+    // Comparing by address is required because names can be
+    // the same for different links.
+    if (std::less<DARTLink *>()(dartLink2, dartLink1))
+      std::swap(dartLink1, dartLink2);
+
+    pairedContacts.push_back({dartLink1, dartLink2, i});
   }
 
-  for (PairedContactsMap::iterator it = pairedContacts.begin();
-       it != pairedContacts.end(); ++it)
+  // The contact index keeps the DART order of the contacts within a pair
+  std::sort(pairedContacts.begin(), pairedContacts.end(),
+      [](const DARTPairedContact &_a, const DARTPairedContact &_b)
+      {
+        if (_a.link1 != _b.link1)
+          return std::less<DARTLink *>()(_a.link1, _b.link1);
+        if (_a.link2 != _b.link2)
+          return std::less<DARTLink *>()(_a.link2, _b.link2);
+        return _a.index < _b.index;
+      });
+
+  const unsigned int maxContacts = std::min(this->dataPtr->maxContacts,
+      static_cast<unsigned int>(MAX_CONTACT_JOINTS));
+
+  for (std::size_t begin = 0, end = 0; begin < pairedContacts.size();
+       begin = end)
   {
-    DARTLinkPtr dartLink1 = it->first.DARTLink1();
-    DARTLinkPtr dartLink2 = it->first.DARTLink2();
-    const std::deque<const dart::collision::Contact*> &dtContacts = it->second;
+    DARTLink *dartLink1 = pairedContacts[begin].link1;
+    DARTLink *dartLink2 = pairedContacts[begin].link2;
 
-    GZ_ASSERT(!dtContacts.empty(),
-           "dtContacts is empty, at least one contact should have been added");
+    end = begin + 1;
+    while (end < pairedContacts.size() &&
+           pairedContacts[end].link1 == dartLink1 &&
+           pairedContacts[end].link2 == dartLink2)
+    {
+      ++end;
+    }
 
     unsigned int colIndex = 0;
     CollisionPtr collisionPtr1 = dartLink1->GetCollision(colIndex);
@@ -334,15 +322,9 @@ static void RetrieveDARTCollisions(
 
     // Add a new contact to the manager. This will return nullptr if no one is
     // listening for contact information.
-    // It would be nice to do this in the first loop in order to save
-    // computation, but we can only add a new contact once per link pair,
-    // which is information we only have after the first loop.
-    // We could avoid all the computation however if the contact manager
-    // had a function returning in advance whether the ContactManger::NewContact
-    // will return NULL!
-    Contact *contactFeedback = _mgr->NewContact(
+    Contact *contactFeedback = mgr->NewContact(
                                  collisionPtr1.get(), collisionPtr2.get(),
-                                 _dtPhysics->World()->SimTime());
+                                 this->world->SimTime());
     if (!contactFeedback)
       continue;
 
@@ -353,13 +335,13 @@ static void RetrieveDARTCollisions(
 
     contactFeedback->count = 0;
 
-    std::deque<const dart::collision::Contact*>::const_iterator contIt;
-    int contNum = 0;
-    for (contIt = dtContacts.begin();
-         (contNum < MAX_CONTACT_JOINTS) && (contIt != dtContacts.end());
-         ++contIt, ++contNum)
+    for (std::size_t c = begin;
+         (contactFeedback->count < static_cast<int>(maxContacts)) && (c < end);
+         ++c)
     {
-      const dart::collision::Contact *dtContact = *contIt;
+      const dart::collision::Contact &dtContact =
+          _dtResult.getContact(pairedContacts[c].index);
+      const int contNum = contactFeedback->count;
 
       ignition::math::Vector3d localForce1;
       ignition::math::Vector3d localForce2;
@@ -367,14 +349,14 @@ static void RetrieveDARTCollisions(
       ignition::math::Vector3d localTorque2;
 
       // calculate force in world frame
-      Eigen::Vector3d force = dtContact->force;
+      Eigen::Vector3d force = dtContact.force;
 
       // calculate torque in world frame
       Eigen::Vector3d torqueA =
-          (dtContact->point -
+          (dtContact.point -
            dtBodyNode1->getTransform().translation()).cross(force);
       Eigen::Vector3d torqueB =
-          (dtContact->point -
+          (dtContact.point -
            dtBodyNode2->getTransform().translation()).cross(-force);
 
       // Convert from world to link frame
@@ -388,11 +370,11 @@ static void RetrieveDARTCollisions(
           DARTTypes::ConvVec3Ign(torqueB));
 
       contactFeedback->positions[contNum] =
-        DARTTypes::ConvVec3Ign(dtContact->point);
+        DARTTypes::ConvVec3Ign(dtContact.point);
       contactFeedback->normals[contNum] =
-        DARTTypes::ConvVec3Ign(dtContact->normal);
+        DARTTypes::ConvVec3Ign(dtContact.normal);
       contactFeedback->depths[contNum] =
-        dtContact->penetrationDepth;
+        dtContact.penetrationDepth;
 
       if (!dartLink1->IsStatic())
       {
@@ -423,15 +405,14 @@ void DARTPhysics::UpdateCollision()
 
     // collision computation is disabled when UpdatePhysics() is not
     // being called, so do collision detection separately here.
-    std::size_t maxContacts = 1000u;
-    dart::collision::CollisionOption opt(true, maxContacts);
+    dart::collision::CollisionOption opt(true, this->dataPtr->maxContacts);
     // call of checkCollision will not update the result which
     // can be retrieved with
     // this->dataPtr->dtWorld->getLastCollisionResult()
     // so get the results and store them locally.
     this->dataPtr->dtWorld->checkCollision(opt, &localResult);
 
-    RetrieveDARTCollisions(this, &localResult, this->GetContactManager());
+    this->RetrieveDARTCollisions(localResult);
   }
   IGN_PROFILE_END();
 }
@@ -472,10 +453,8 @@ void DARTPhysics::UpdatePhysics()
     }
   }
 
-  RetrieveDARTCollisions(
-        this,
-        &(this->dataPtr->dtWorld->getLastCollisionResult()),
-        this->GetContactManager());
+  this->RetrieveDARTCollisions(
+        this->dataPtr->dtWorld->getLastCollisionResult());
   IGN_PROFILE_END();
 }
 
@@ -685,6 +664,17 @@ boost::any DARTPhysics::GetParam(const std::string &_key) const
 //////////////////////////////////////////////////
 bool DARTPhysics::GetParam(const std::string &_key, boost::any &_value) const
 {
+  if (_key == "max_contacts")
+  {
+    _value = static_cast<int>(this->dataPtr->maxContacts);
+    return true;
+  }
+  else if (_key == "collision_detector")
+  {
+    _value = this->CollisionDetectorInUse();
+    return true;
+  }
+
   if (!this->sdf->HasElement("dart"))
   {
     return PhysicsEngine::GetParam(_key, _value);
@@ -698,10 +688,6 @@ bool DARTPhysics::GetParam(const std::string &_key, boost::any &_value) const
   {
     _value = this->GetSolverType();
   }
-  else if (_key == "max_contacts")
-  {
-    _value = dartElem->GetElement("max_contacts")->Get<int>();
-  }
   else if (_key == "min_step_size")
   {
     _value = dartElem->GetElement("solver")->Get<double>("min_step_size");
@@ -727,8 +713,16 @@ bool DARTPhysics::SetParam(const std::string &_key, const boost::any &_value)
     else if (_key == "max_contacts")
     {
       int value = any_cast<int>(_value);
-      gzerr << "Setting [" << _key << "] in DART to [" << value
-            << "] not yet supported.\n";
+      if (value < 0)
+      {
+        gzerr << "max_contacts must be non-negative, got [" << value
+              << "]\n";
+        return false;
+      }
+      this->dataPtr->maxContacts = static_cast<unsigned int>(value);
+      this->dataPtr->dtWorld->getConstraintSolver()->getCollisionOption()
+          .maxNumContacts = this->dataPtr->maxContacts;
+      this->sdf->GetElement("max_contacts")->Set(value);
     }
     else if (_key == "min_step_size")
     {
@@ -746,7 +740,12 @@ bool DARTPhysics::SetParam(const std::string &_key, const boost::any &_value)
       // set collision detector
       std::string useCollisionDetector = any_cast<std::string>(_value);
       std::shared_ptr<dart::collision::CollisionDetector> cd;
-      if (useCollisionDetector == "bullet")
+      if (useCollisionDetector == this->CollisionDetectorInUse())
+      {
+        // Already in use, the SDF and the presets can both set it
+        return true;
+      }
+      else if (useCollisionDetector == "bullet")
       {
         gzdbg << "Using BULLET collision detector" << std::endl;
 #ifdef HAVE_DART_BULLET
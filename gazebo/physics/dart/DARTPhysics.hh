@@ -165,12 +165,26 @@ namespace gazebo
       // Documentation inherited
       protected: virtual void OnPhysicsMsg(ConstPhysicsPtr &_msg);
 
+      /// \brief Group the DART contacts by link pair and pass them to the
+      /// contact manager.
+      /// \param[in] _dtResult Result of the DART collision detection.
+      private: void RetrieveDARTCollisions(
+          const dart::collision::CollisionResult &_dtResult);
+
       /// \brief Find DART Link corresponding to DART BodyNode.
       /// \param[in] _dtBodyNode The DART BodyNode.
       /// \return Pointer to the DART Link.
       private: DARTLinkPtr FindDARTLink(
           const dart::dynamics::BodyNode *_dtBodyNode);
 
+      /// \brief Mark the table of the links of the DART body nodes as out
+      /// of date, so that it is built again before the next contacts are
+      /// retrieved. Called by DARTLink when its body node changes.
+      private: void BodyNodeLinksChanged();
+
+      /// \brief DARTLink updates the table of the links of the body nodes.
+      private: friend class DARTLink;
+
       /// \internal
       /// \brief Pointer to private data.
       private: DARTPhysicsPrivate *dataPtr = nullptr;
@@ -18,12 +18,34 @@
 #ifndef _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 #define _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 #include "gazebo/physics/dart/dart_inc.h"
+#include "gazebo/physics/dart/DARTTypes.hh"
 
 namespace gazebo
 {
   namespace physics
   {
+    /// \internal
+    /// \brief A DART contact with the links it is between. The links are
+    /// ordered by address, so that sorting puts the contacts of a link pair
+    /// next to each other.
+    class DARTPairedContact
+    {
+      /// \brief Link with the lower address.
+      public: DARTLink *link1;
+
+      /// \brief Link with the higher address.
+      public: DARTLink *link2;
+
+      /// \brief Index of the contact in the DART collision result.
+      public: std::size_t index;
+    };
+
     /// \internal
     /// \brief Private data class for DARTPhysics
     class DARTPhysicsPrivate
@@ -50,6 +72,23 @@ namespace gazebo
       /// and torques (both internal and external) after completing a simulation
       /// step. Default value is true.
       public: bool resetAllForcesAfterSimulationStep;
+
+      /// \brief Maximum number of contacts detected by DART in a step, and
+      /// reported per link pair.
+      public: unsigned int maxContacts = 20;
+
+      /// \brief DART body nodes and their links, sorted by body node.
+      /// Built again when links are added or removed.
+      public: std::vector<std::pair<const dart::dynamics::BodyNode *,
+                  DARTLink *>> bodyNodeLinks;
+
+      /// \brief True if links were added or removed since bodyNodeLinks
+      /// was built.
+      public: std::atomic<bool> bodyNodeLinksDirty{true};
+
+      /// \brief Contacts of the last step sorted by link pair, kept to
+      /// reuse its memory.
+      public: std::vector<DARTPairedContact> pairedContacts;
     };
   }
 }
@@ -274,6 +274,12 @@ double ODEJoint::GetCFM()
   return this->GetParam(dParamSuspensionCFM);
 }
 
+//////////////////////////////////////////////////
+dJointID ODEJoint::JointId() const
+{
+  return this->jointId;
+}
+
 //////////////////////////////////////////////////
 dJointFeedback *ODEJoint::GetFeedback()
 {
@@ -132,6 +132,10 @@ namespace gazebo
       /// \return Pointer to the joint feedback.
       public: dJointFeedback *GetFeedback();
 
+      /// \brief Get the ODE id of the joint.
+      /// \return ODE joint id, null if the joint wasn't created.
+      public: dJointID JointId() const;
+
       /// \brief Get flag indicating whether implicit spring damper is enabled.
       /// \return True if implicit spring damper is used.
       public: bool UsesImplicitSpringDamper();
@@ -65,19 +65,7 @@ void ODELink::Init()
   {
     this->linkId = dBodyCreate(this->odePhysics->GetWorldId());
     dBodySetData(this->linkId, this);
-
-    // Only use auto disable if no joints and no sensors are present
-    if (this->GetModel()->GetAutoDisable() &&
-        this->GetModel()->GetJointCount() == 0 &&
-        this->GetSensorCount() == 0)
-    {
-      dBodySetAutoDisableDefaults(this->linkId);
-      dBodySetAutoDisableFlag(this->linkId, 1);
-    }
-    else
-    {
-      dBodySetAutoDisableFlag(this->linkId, 0);
-    }
+    this->ResetAutoDisable();
   }
 
   GZ_ASSERT(this->sdf != nullptr, "Unable to initialize link, SDF is null");
@@ -225,7 +213,19 @@ void ODELink::SetSelfCollide(bool _collide)
 {
   this->sdf->GetElement("self_collide")->Set(_collide);
   if (_collide)
-    this->spaceId = dSimpleSpaceCreate(this->odePhysics->GetSpaceId());
+  {
+    unsigned int geomCount = 0;
+    if (this->sdf->HasElement("collision"))
+    {
+      for (sdf::ElementPtr collisionElem = this->sdf->GetElement("collision");
+          collisionElem;
+          collisionElem = collisionElem->GetNextElement("collision"))
+      {
+        ++geomCount;
+      }
+    }
+    this->spaceId = this->odePhysics->CreateCollisionSpace(geomCount);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -766,17 +766,53 @@ bool ODELink::GetKinematic() const
 //////////////////////////////////////////////////
 void ODELink::SetAutoDisable(bool _disable)
 {
-  if (this->GetModel()->GetJointCount() == 0 && this->linkId)
+  if (!this->linkId)
   {
-    dBodySetAutoDisableFlag(this->linkId, _disable);
-  }
-  else if (!this->linkId)
     gzlog << "ODE body for link [" << this->GetScopedName() << "]"
           << " does not exist, unable to SetAutoDisable" << std::endl;
+  }
+  else if (this->GetModel()->GetJointCount() == 0 ||
+      dWorldGetAutoDisableIslands(this->odePhysics->GetWorldId()))
+  {
+    dBodySetAutoDisableFlag(this->linkId, _disable);
+
+    // Remember the choice, so that ResetAutoDisable keeps it
+    this->autoDisableSet = true;
+    this->autoDisable = _disable;
+  }
   else
     gzlog << "ODE model has joints, unable to SetAutoDisable" << std::endl;
 }
 
+//////////////////////////////////////////////////
+void ODELink::ResetAutoDisable()
+{
+  if (!this->linkId)
+    return;
+
+  dWorldID worldId = this->odePhysics->GetWorldId();
+
+  dBodySetAutoDisableLinearThreshold(this->linkId,
+      dWorldGetAutoDisableLinearThreshold(worldId));
+  dBodySetAutoDisableAngularThreshold(this->linkId,
+      dWorldGetAutoDisableAngularThreshold(worldId));
+  dBodySetAutoDisableAverageSamplesCount(this->linkId,
+      dWorldGetAutoDisableAverageSamplesCount(worldId));
+  dBodySetAutoDisableSteps(this->linkId, dWorldGetAutoDisableSteps(worldId));
+  dBodySetAutoDisableTime(this->linkId, dWorldGetAutoDisableTime(worldId));
+
+  // Unless SetAutoDisable was called, links with sensors never sleep. Links
+  // of models with joints only sleep when bodies are disabled by island,
+  // together with the bodies they are connected to.
+  const bool allowed = this->autoDisableSet ? this->autoDisable :
+      this->GetModel()->GetAutoDisable() && this->GetSensorCount() == 0;
+  const bool autoDisable = allowed &&
+      (this->GetModel()->GetJointCount() == 0 ||
+       dWorldGetAutoDisableIslands(worldId));
+  dBodySetAutoDisableFlag(this->linkId, autoDisable);
+  dBodyEnable(this->linkId);
+}
+
 //////////////////////////////////////////////////
 void ODELink::SetLinkStatic(bool /*_static*/)
 {
@@ -158,6 +158,10 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetAutoDisable(bool _disable);
 
+      /// \brief Apply the auto-disable parameters of the ODE world to the
+      /// body, and wake it up. A choice made with SetAutoDisable is kept.
+      public: void ResetAutoDisable();
+
       /// \brief Return the ID of this link
       /// \return ODE link id
       public: dBodyID GetODEId() const;
@@ -185,6 +189,12 @@ namespace gazebo
       /// \brief ODE link handle
       private: dBodyID linkId;
 
+      /// \brief True once SetAutoDisable applied a choice to the body.
+      private: bool autoDisableSet = false;
+
+      /// \brief Auto-disable choice applied by SetAutoDisable.
+      private: bool autoDisable = false;
+
       /// \brief Pointer to the ODE Physics engine
       private: ODEPhysicsPtr odePhysics;
 
@@ -21,11 +21,13 @@
 #include <sdf/sdf.hh>
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 #include <ignition/math/Vector3.hh>
 #include <ignition/common/Profiler.hh>
@@ -51,6 +53,7 @@
 
 #include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODELink.hh"
+#include "gazebo/physics/ode/ODEJoint.hh"
 #include "gazebo/physics/ode/ODEScrewJoint.hh"
 #include "gazebo/physics/ode/ODEHingeJoint.hh"
 #include "gazebo/physics/ode/ODEGearboxJoint.hh"
@@ -78,6 +81,16 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Number of values saved per body in a snapshot, not counting the
+/// samples of the average velocities used by auto-disable.
+static const size_t kSnapshotBodySize = 25;
+
+/// \brief Number of values saved per sample of the average velocities.
+static const size_t kSnapshotSampleSize = 6;
+
+/// \brief Number of values saved per joint in a snapshot.
+static const size_t kSnapshotJointSize = 12;
+
 GZ_REGISTER_PHYSICS_ENGINE("ode", ODEPhysics)
 
 /*
@@ -144,8 +157,8 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
 
   this->dataPtr->worldId = dWorldCreate();
 
-  this->dataPtr->spaceId = dHashSpaceCreate(0);
-  dHashSpaceSetLevels(this->dataPtr->spaceId, -2, 8);
+  this->dataPtr->spaceId = nullptr;
+  this->SetBroadphase(this->dataPtr->broadphase);
 
   this->dataPtr->contactGroup = dJointGroupCreate(0);
 
@@ -201,14 +214,20 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
         "contact_surface_layer"));
 
   // Enable auto-disable by default. Models with joints are excluded from
-  // auto-disable
+  // auto-disable, unless bodies are disabled by island with the
+  // <auto_disable><islands> element, so that they sleep as a whole.
   dWorldSetAutoDisableFlag(this->dataPtr->worldId, 1);
+  dWorldSetAutoDisableIslands(this->dataPtr->worldId, 0);
 
   dWorldSetAutoDisableTime(this->dataPtr->worldId, 1);
   dWorldSetAutoDisableLinearThreshold(this->dataPtr->worldId, 0.1);
   dWorldSetAutoDisableAngularThreshold(this->dataPtr->worldId, 0.1);
   dWorldSetAutoDisableSteps(this->dataPtr->worldId, 5);
 
+  // The thresholds are configured with the optional <auto_disable> element
+  if (odeElem->HasElement("auto_disable"))
+    this->LoadAutoDisable(odeElem->GetElement("auto_disable"));
+
   auto g = this->world->Gravity();
 
   if (g == ignition::math::Vector3d::Zero)
@@ -230,6 +249,10 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
     this->GetSORPGSIters());
   dWorldSetQuickStepW(this->dataPtr->worldId, this->GetSORPGSW());
 
+  // The broadphase is configured with the optional <broadphase> element
+  if (odeElem->HasElement("broadphase"))
+    this->LoadBroadphase(odeElem->GetElement("broadphase"));
+
   // Set the physics update function
   this->SetStepType(this->dataPtr->stepType);
   if (this->dataPtr->physicsStepFunc == nullptr)
@@ -488,6 +511,195 @@ void ODEPhysics::Fini()
   PhysicsEngine::Fini();
 }
 
+//////////////////////////////////////////////////
+void ODEPhysics::LoadBroadphase(sdf::ElementPtr _sdf)
+{
+  std::string type = this->dataPtr->broadphase;
+  if (_sdf->HasElement("type"))
+    type = _sdf->Get<std::string>("type");
+
+  if (_sdf->HasElement("hash_min_level"))
+    this->dataPtr->hashLevels[0] = _sdf->Get<int>("hash_min_level");
+  if (_sdf->HasElement("hash_max_level"))
+    this->dataPtr->hashLevels[1] = _sdf->Get<int>("hash_max_level");
+  if (this->dataPtr->hashLevels[0] > this->dataPtr->hashLevels[1])
+  {
+    gzerr << "Hash space min level [" << this->dataPtr->hashLevels[0]
+          << "] is greater than its max level ["
+          << this->dataPtr->hashLevels[1] << "], using [-2, 8]\n";
+    this->dataPtr->hashLevels[0] = -2;
+    this->dataPtr->hashLevels[1] = 8;
+  }
+
+  if (_sdf->HasElement("sap_axes"))
+  {
+    static const std::map<std::string, int> axes = {
+      {"xyz", dSAP_AXES_XYZ}, {"xzy", dSAP_AXES_XZY},
+      {"yxz", dSAP_AXES_YXZ}, {"yzx", dSAP_AXES_YZX},
+      {"zxy", dSAP_AXES_ZXY}, {"zyx", dSAP_AXES_ZYX}};
+
+    std::string order = _sdf->Get<std::string>("sap_axes");
+    auto iter = axes.find(order);
+    if (iter != axes.end())
+      this->dataPtr->sapAxes = iter->second;
+    else
+      gzerr << "Invalid sweep and prune axis order [" << order << "]\n";
+  }
+
+  if (_sdf->HasElement("quadtree_center"))
+  {
+    this->dataPtr->quadTreeCenter =
+        _sdf->Get<ignition::math::Vector3d>("quadtree_center");
+  }
+  if (_sdf->HasElement("quadtree_extents"))
+  {
+    this->dataPtr->quadTreeExtents =
+        _sdf->Get<ignition::math::Vector3d>("quadtree_extents");
+  }
+  if (_sdf->HasElement("quadtree_depth"))
+    this->dataPtr->quadTreeDepth = _sdf->Get<int>("quadtree_depth");
+
+  if (_sdf->HasElement("space_geom_threshold"))
+  {
+    this->SetParam("space_geom_threshold",
+        _sdf->Get<int>("space_geom_threshold"));
+  }
+
+  // Recreate the top-level space, which is empty before the models load
+  if (!this->SetBroadphase(type))
+  {
+    gzerr << "Unable to use ODE broadphase [" << type << "], keeping ["
+          << this->dataPtr->broadphase << "]\n";
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::LoadAutoDisable(sdf::ElementPtr _sdf)
+{
+  if (_sdf->HasElement("islands"))
+    this->SetParam("auto_disable_islands", _sdf->Get<bool>("islands"));
+  if (_sdf->HasElement("linear_threshold"))
+  {
+    this->SetParam("auto_disable_linear_threshold",
+        _sdf->Get<double>("linear_threshold"));
+  }
+  if (_sdf->HasElement("angular_threshold"))
+  {
+    this->SetParam("auto_disable_angular_threshold",
+        _sdf->Get<double>("angular_threshold"));
+  }
+  if (_sdf->HasElement("time"))
+    this->SetParam("auto_disable_time", _sdf->Get<double>("time"));
+  if (_sdf->HasElement("steps"))
+    this->SetParam("auto_disable_steps", _sdf->Get<int>("steps"));
+  if (_sdf->HasElement("average_samples"))
+  {
+    this->SetParam("auto_disable_average_samples",
+        _sdf->Get<int>("average_samples"));
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::ResetAutoDisable()
+{
+  std::function<void(const ModelPtr &)> resetModel =
+      [&resetModel](const ModelPtr &_model)
+  {
+    for (auto const &link : _model->GetLinks())
+      boost::static_pointer_cast<ODELink>(link)->ResetAutoDisable();
+    for (auto const &nested : _model->NestedModels())
+      resetModel(nested);
+  };
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  for (auto const &model : this->world->Models())
+    resetModel(model);
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::SetBroadphase(const std::string &_type)
+{
+  dSpaceID oldSpace = this->dataPtr->spaceId;
+
+  // The quadtree space can't enumerate its geoms
+  if (oldSpace && dSpaceGetClass(oldSpace) == dQuadTreeSpaceClass &&
+      dSpaceGetNumGeoms(oldSpace) > 0)
+  {
+    gzerr << "Unable to change the broadphase of a quadtree space which "
+          << "isn't empty\n";
+    return false;
+  }
+
+  dSpaceID space = nullptr;
+  if (_type == "simple")
+  {
+    space = dSimpleSpaceCreate(0);
+  }
+  else if (_type == "hash")
+  {
+    space = dHashSpaceCreate(0);
+    dHashSpaceSetLevels(space, this->dataPtr->hashLevels[0],
+        this->dataPtr->hashLevels[1]);
+  }
+  else if (_type == "sap")
+  {
+    space = dSweepAndPruneSpaceCreate(0, this->dataPtr->sapAxes);
+  }
+  else if (_type == "quadtree")
+  {
+    const ignition::math::Vector3d &c = this->dataPtr->quadTreeCenter;
+    const ignition::math::Vector3d &e = this->dataPtr->quadTreeExtents;
+    dVector3 center = {c.X(), c.Y(), c.Z(), 0};
+    dVector3 extents = {e.X(), e.Y(), e.Z(), 0};
+    space = dQuadTreeSpaceCreate(0, center, extents,
+        this->dataPtr->quadTreeDepth);
+  }
+  else if (_type == "bvh")
+  {
+    space = dBVHSpaceCreate(0);
+  }
+  else
+  {
+    gzerr << "Unknown ODE broadphase [" << _type << "], expected simple, "
+          << "hash, sap, quadtree or bvh\n";
+    return false;
+  }
+
+  // Move the model spaces and the geoms, such as rays, to the new space
+  if (oldSpace)
+  {
+    std::vector<dGeomID> geoms;
+    for (int i = 0; i < dSpaceGetNumGeoms(oldSpace); ++i)
+      geoms.push_back(dSpaceGetGeom(oldSpace, i));
+
+    for (auto const &geom : geoms)
+    {
+      dSpaceRemove(oldSpace, geom);
+      dSpaceAdd(space, geom);
+    }
+
+    dSpaceSetCleanup(oldSpace, 0);
+    dSpaceDestroy(oldSpace);
+  }
+
+  this->dataPtr->spaceId = space;
+  this->dataPtr->broadphase = _type;
+  return true;
+}
+
+//////////////////////////////////////////////////
+dSpaceID ODEPhysics::CreateCollisionSpace(const unsigned int _geomCount)
+{
+  // Colliding other spaces with a simple space tests every one of its geoms
+  if (this->dataPtr->spaceGeomThreshold > 0 &&
+      _geomCount >= this->dataPtr->spaceGeomThreshold)
+  {
+    return dBVHSpaceCreate(this->dataPtr->spaceId);
+  }
+
+  return dSimpleSpaceCreate(this->dataPtr->spaceId);
+}
+
 //////////////////////////////////////////////////
 void ODEPhysics::Reset()
 {
@@ -506,8 +718,29 @@ LinkPtr ODEPhysics::CreateLink(ModelPtr _parent)
   iter = this->dataPtr->spaces.find(_parent->GetName());
 
   if (iter == this->dataPtr->spaces.end())
+  {
+    // Count the collisions of the links of the model
+    unsigned int geomCount = 0;
+    sdf::ElementPtr modelElem = _parent->GetSDF();
+    if (modelElem && modelElem->HasElement("link"))
+    {
+      for (sdf::ElementPtr linkElem = modelElem->GetElement("link");
+          linkElem; linkElem = linkElem->GetNextElement("link"))
+      {
+        if (!linkElem->HasElement("collision"))
+          continue;
+        for (sdf::ElementPtr collisionElem =
+            linkElem->GetElement("collision"); collisionElem;
+            collisionElem = collisionElem->GetNextElement("collision"))
+        {
+          ++geomCount;
+        }
+      }
+    }
+
     this->dataPtr->spaces[_parent->GetName()] =
-      dSimpleSpaceCreate(this->dataPtr->spaceId);
+      this->CreateCollisionSpace(geomCount);
+  }
 
   ODELinkPtr link(new ODELink(_parent));
 
@@ -939,9 +1172,15 @@ void ODEPhysics::SetStepType(const std::string &_type)
 //////////////////////////////////////////////////
 void ODEPhysics::SetGravity(const ignition::math::Vector3d &_gravity)
 {
+  const bool changed = this->world->Gravity() != _gravity;
+
   this->world->SetGravitySDF(_gravity);
   dWorldSetGravity(this->dataPtr->worldId, _gravity.X(), _gravity.Y(),
       _gravity.Z());
+
+  // Sleeping bodies wouldn't feel the new gravity
+  if (changed)
+    this->ResetAutoDisable();
 }
 
 //////////////////////////////////////////////////
@@ -1411,6 +1650,189 @@ void ODEPhysics::DebugPrint() const
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the number of values saved in a snapshot for a link.
+/// \param[in] _body Body of the link, null for static links.
+/// \return Number of values.
+static size_t snapshotBodySize(dBodyID _body)
+{
+  if (!_body)
+    return kSnapshotBodySize;
+  return kSnapshotBodySize + kSnapshotSampleSize *
+      static_cast<size_t>(dBodyGetAutoDisableAverageSamplesCount(_body));
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the number of values saved in a snapshot for some links and
+/// joints.
+/// \param[in] _links Links.
+/// \param[in] _joints Joints.
+/// \return Number of values.
+static size_t snapshotSize(const Link_V &_links, const Joint_V &_joints)
+{
+  size_t size = 2 + _joints.size() * kSnapshotJointSize;
+  for (auto const &link : _links)
+    size += snapshotBodySize(static_cast<ODELink *>(link.get())->GetODEId());
+  return size;
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::SaveSnapshot(const Link_V &_links, const Joint_V &_joints,
+    std::vector<double> &_data) const
+{
+  _data.resize(snapshotSize(_links, _joints));
+  double *value = _data.data();
+  *value++ = _links.size();
+  *value++ = _joints.size();
+
+  for (auto const &link : _links)
+  {
+    dBodyID body = static_cast<ODELink *>(link.get())->GetODEId();
+    if (!body)
+    {
+      // Static links don't have a body
+      std::fill(value, value + kSnapshotBodySize, 0.0);
+      value += kSnapshotBodySize;
+      continue;
+    }
+
+    for (const dReal *v : {dBodyGetPosition(body), dBodyGetLinearVel(body),
+        dBodyGetAngularVel(body), dBodyGetForce(body), dBodyGetTorque(body)})
+    {
+      *value++ = v[0];
+      *value++ = v[1];
+      *value++ = v[2];
+    }
+    const dReal *q = dBodyGetQuaternion(body);
+    for (int i = 0; i < 4; ++i)
+      *value++ = q[i];
+
+    dReal timeLeft;
+    int stepsLeft;
+    dBodyGetAutoDisableState(body, &timeLeft, &stepsLeft);
+    *value++ = dBodyIsEnabled(body);
+    *value++ = timeLeft;
+    *value++ = stepsLeft;
+
+    // The samples of the average velocities decide when the body becomes
+    // idle, and so when it is disabled
+    unsigned int counter;
+    int ready;
+    dBodyGetAutoDisableAverageState(body, &counter, &ready);
+    const unsigned int samples = dBodyGetAutoDisableAverageSamplesCount(body);
+    *value++ = counter;
+    *value++ = ready;
+    *value++ = samples;
+
+    dReal lvel[3];
+    dReal avel[3];
+    for (unsigned int i = 0; i < samples; ++i)
+    {
+      dBodyGetAutoDisableAverageSample(body, i, lvel, avel);
+      value = std::copy(lvel, lvel + 3, value);
+      value = std::copy(avel, avel + 3, value);
+    }
+  }
+
+  dReal lambda[6];
+  dReal lambdaErp[6];
+  for (auto const &joint : _joints)
+  {
+    dJointID jointId = static_cast<ODEJoint *>(joint.get())->JointId();
+    if (!jointId)
+    {
+      std::fill(value, value + kSnapshotJointSize, 0.0);
+      value += kSnapshotJointSize;
+      continue;
+    }
+
+    dJointGetWarmStart(jointId, lambda, lambdaErp);
+    value = std::copy(lambda, lambda + 6, value);
+    value = std::copy(lambdaErp, lambdaErp + 6, value);
+  }
+}
+
+/////////////////////////////////////////////////
+bool ODEPhysics::RestoreSnapshot(const Link_V &_links,
+    const Joint_V &_joints, const std::vector<double> &_data)
+{
+  if (_data.size() != snapshotSize(_links, _joints) ||
+      _data[0] != _links.size() || _data[1] != _joints.size())
+  {
+    return false;
+  }
+
+  // Check that the number of samples of the average velocities of each
+  // body didn't change before restoring anything
+  const double *value = _data.data() + 2;
+  for (auto const &link : _links)
+  {
+    dBodyID body = static_cast<ODELink *>(link.get())->GetODEId();
+    if (body && value[24] != dBodyGetAutoDisableAverageSamplesCount(body))
+      return false;
+    value += snapshotBodySize(body);
+  }
+
+  value = _data.data() + 2;
+  for (auto const &link : _links)
+  {
+    dBodyID body = static_cast<ODELink *>(link.get())->GetODEId();
+    if (!body)
+    {
+      value += kSnapshotBodySize;
+      continue;
+    }
+
+    dBodySetPosition(body, value[0], value[1], value[2]);
+    dBodySetLinearVel(body, value[3], value[4], value[5]);
+    dBodySetAngularVel(body, value[6], value[7], value[8]);
+    dBodySetForce(body, value[9], value[10], value[11]);
+    dBodySetTorque(body, value[12], value[13], value[14]);
+    dQuaternion q = {value[15], value[16], value[17], value[18]};
+    dBodySetQuaternion(body, q);
+
+    if (value[19] > 0)
+      dBodyEnable(body);
+    else
+      dBodyDisable(body);
+    dBodySetAutoDisableState(body, value[20], static_cast<int>(value[21]));
+    dBodySetAutoDisableAverageState(body,
+        static_cast<unsigned int>(value[22]), static_cast<int>(value[23]));
+
+    const unsigned int samples = static_cast<unsigned int>(value[24]);
+    value += kSnapshotBodySize;
+
+    dReal lvel[3];
+    dReal avel[3];
+    for (unsigned int i = 0; i < samples; ++i)
+    {
+      std::copy(value, value + 3, lvel);
+      std::copy(value + 3, value + 6, avel);
+      dBodySetAutoDisableAverageSample(body, i, lvel, avel);
+      value += kSnapshotSampleSize;
+    }
+
+    // Update the pose of the link as at the end of a step
+    ODELink::MoveCallback(body);
+  }
+
+  dReal lambda[6];
+  dReal lambdaErp[6];
+  for (auto const &joint : _joints)
+  {
+    dJointID jointId = static_cast<ODEJoint *>(joint.get())->JointId();
+    if (jointId)
+    {
+      std::copy(value, value + 6, lambda);
+      std::copy(value + 6, value + 12, lambdaErp);
+      dJointSetWarmStart(jointId, lambda, lambdaErp);
+    }
+    value += kSnapshotJointSize;
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::SetSeed(uint32_t _seed)
 {
@@ -1555,6 +1977,74 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       }
       dWorldSetIslandThreads(this->dataPtr->worldId, value);
     }
+    else if (_key == "broadphase")
+    {
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      return this->SetBroadphase(any_cast<std::string>(_value));
+    }
+    else if (_key == "space_geom_threshold")
+    {
+      int value = any_cast<int>(_value);
+      if (value < 0)
+      {
+        gzerr << "Space geom threshold must be positive, or zero to disable "
+              << "BVH subspaces\n";
+        return false;
+      }
+      this->dataPtr->spaceGeomThreshold = value;
+    }
+    else if (_key == "auto_disable_islands")
+    {
+      const bool islands = any_cast<bool>(_value);
+      if (islands != (dWorldGetAutoDisableIslands(this->dataPtr->worldId) != 0))
+      {
+        dWorldSetAutoDisableIslands(this->dataPtr->worldId, islands);
+        this->ResetAutoDisable();
+      }
+    }
+    else if (_key == "auto_disable_linear_threshold" ||
+             _key == "auto_disable_angular_threshold" ||
+             _key == "auto_disable_time")
+    {
+      double value = any_cast<double>(_value);
+      if (value < 0)
+      {
+        gzerr << "Parameter [" << _key << "] must be positive\n";
+        return false;
+      }
+      boost::any current;
+      this->GetParam(_key, current);
+      if (ignition::math::equal(any_cast<double>(current), value))
+        return true;
+
+      if (_key == "auto_disable_linear_threshold")
+        dWorldSetAutoDisableLinearThreshold(this->dataPtr->worldId, value);
+      else if (_key == "auto_disable_angular_threshold")
+        dWorldSetAutoDisableAngularThreshold(this->dataPtr->worldId, value);
+      else
+        dWorldSetAutoDisableTime(this->dataPtr->worldId, value);
+      this->ResetAutoDisable();
+    }
+    else if (_key == "auto_disable_steps" ||
+             _key == "auto_disable_average_samples")
+    {
+      int value = any_cast<int>(_value);
+      if (value < 0)
+      {
+        gzerr << "Parameter [" << _key << "] must be positive\n";
+        return false;
+      }
+      boost::any current;
+      this->GetParam(_key, current);
+      if (any_cast<int>(current) == value)
+        return true;
+
+      if (_key == "auto_disable_steps")
+        dWorldSetAutoDisableSteps(this->dataPtr->worldId, value);
+      else
+        dWorldSetAutoDisableAverageSamplesCount(this->dataPtr->worldId, value);
+      this->ResetAutoDisable();
+    }
     else if (_key == "ode_quiet")
     {
       bool odeQuiet = any_cast<bool>(_value);
@@ -1662,6 +2152,33 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->GetFrictionModel();
   else if (_key == "island_threads")
     _value = dWorldGetIslandThreads(this->dataPtr->worldId);
+  else if (_key == "broadphase")
+    _value = this->dataPtr->broadphase;
+  else if (_key == "space_geom_threshold")
+    _value = static_cast<int>(this->dataPtr->spaceGeomThreshold);
+  else if (_key == "auto_disable_islands")
+    _value = dWorldGetAutoDisableIslands(this->dataPtr->worldId) != 0;
+  else if (_key == "auto_disable_linear_threshold")
+  {
+    _value = static_cast<double>(
+        dWorldGetAutoDisableLinearThreshold(this->dataPtr->worldId));
+  }
+  else if (_key == "auto_disable_angular_threshold")
+  {
+    _value = static_cast<double>(
+        dWorldGetAutoDisableAngularThreshold(this->dataPtr->worldId));
+  }
+  else if (_key == "auto_disable_time")
+  {
+    _value = static_cast<double>(
+        dWorldGetAutoDisableTime(this->dataPtr->worldId));
+  }
+  else if (_key == "auto_disable_steps")
+    _value = dWorldGetAutoDisableSteps(this->dataPtr->worldId);
+  else if (_key == "auto_disable_average_samples")
+    _value = dWorldGetAutoDisableAverageSamplesCount(this->dataPtr->worldId);
+  else if (_key == "sleeping_bodies")
+    _value = dWorldGetDisabledBodyCount(this->dataPtr->worldId);
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
   else if (_key == "world_step_solver")
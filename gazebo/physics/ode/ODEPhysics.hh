@@ -210,6 +210,22 @@ namespace gazebo
       // Documentation inherited
       public: virtual void DebugPrint() const;
 
+      /// \brief Save the state of the ODE bodies, including the force
+      /// accumulators and the auto-disable state with its samples of the
+      /// average velocities, and the constraint forces which warm start the
+      /// quickstep solver at the next step.
+      /// \param[in] _links Links to save.
+      /// \param[in] _joints Joints to save.
+      /// \param[out] _data Buffer to fill.
+      public: virtual void SaveSnapshot(const Link_V &_links,
+                  const Joint_V &_joints,
+                  std::vector<double> &_data) const override;
+
+      // Documentation inherited
+      public: virtual bool RestoreSnapshot(const Link_V &_links,
+                  const Joint_V &_joints,
+                  const std::vector<double> &_data) override;
+
       // Documentation inherited
       public: virtual void SetSeed(uint32_t _seed);
 
@@ -228,6 +244,13 @@ namespace gazebo
       /// \return The space id for the world.
       public: dSpaceID GetSpaceId() const;
 
+      /// \brief Create a space for the collisions of a model or of a self
+      /// colliding link, in the world space. Spaces with many collisions
+      /// use a BVH instead of testing every collision.
+      /// \param[in] _geomCount Expected number of collisions in the space.
+      /// \return The new space.
+      public: dSpaceID CreateCollisionSpace(const unsigned int _geomCount);
+
       /// \brief Get the world id.
       /// \return The world id.
       public: dWorldID GetWorldId();
@@ -303,6 +326,26 @@ namespace gazebo
                                              dGeomID _o2);
 
 
+      /// \brief Load the broadphase parameters and create the world space.
+      /// \param[in] _sdf The <broadphase> element.
+      private: void LoadBroadphase(sdf::ElementPtr _sdf);
+
+      /// \brief Load the auto-disable parameters.
+      /// \param[in] _sdf The <auto_disable> element.
+      private: void LoadAutoDisable(sdf::ElementPtr _sdf);
+
+      /// \brief Apply the auto-disable parameters of the world to every
+      /// body, and wake them up. Called when the parameters or the gravity
+      /// change. The choices made with Link::SetAutoDisable are kept.
+      private: void ResetAutoDisable();
+
+      /// \brief Replace the world space with a space of another type. The
+      /// model spaces and geoms of the current space are moved to the new
+      /// one.
+      /// \param[in] _type Type of space: simple, hash, sap, quadtree or bvh.
+      /// \return True if the space was replaced.
+      private: bool SetBroadphase(const std::string &_type);
+
       /// \brief Create a triangle mesh object collider.
       /// \param[in] _collision1 The first collision object.
       /// \param[in] _collision2 The second collision object.
@@ -23,6 +23,8 @@
 #include <vector>
 #include <utility>
 
+#include <ignition/math/Vector3.hh>
+
 #include "gazebo/physics/Contact.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 
@@ -92,6 +94,31 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief Type of the top-level space: simple, hash, sap, quadtree
+      /// or bvh.
+      public: std::string broadphase = "hash";
+
+      /// \brief Minimum and maximum cell levels of a hash space.
+      public: int hashLevels[2] = {-2, 8};
+
+      /// \brief Axis order of a sweep and prune space.
+      public: int sapAxes = dSAP_AXES_XYZ;
+
+      /// \brief Center of a quadtree space.
+      public: ignition::math::Vector3d quadTreeCenter =
+              ignition::math::Vector3d::Zero;
+
+      /// \brief Extents of a quadtree space.
+      public: ignition::math::Vector3d quadTreeExtents =
+              ignition::math::Vector3d(1000, 1000, 1000);
+
+      /// \brief Depth of a quadtree space.
+      public: int quadTreeDepth = 8;
+
+      /// \brief Number of collisions from which a model gets a BVH space
+      /// instead of a simple space, 0 to always use simple spaces.
+      public: unsigned int spaceGeomThreshold = 32;
     };
   }
 }
@@ -15,11 +15,15 @@
  *
 */
 
+#include <sstream>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
+#include "gazebo/physics/ode/ODELink.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 #include "gazebo/test/ServerFixture.hh"
 
@@ -484,6 +488,204 @@ void ODEPhysics_TEST::PhysicsMsgParam()
   phyNode->Fini();
 }
 
+/////////////////////////////////////////////////
+/// Test the broadphase selection of the world space and of the model spaces
+TEST_F(ODEPhysics_TEST, Broadphase)
+{
+  // World with a BVH broadphase
+  Load("worlds/ode_broadphase.world", true, "ode");
+
+  // A model with many collisions
+  const unsigned int collisionCount = 40;
+  std::ostringstream beadsStr;
+  beadsStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='beads'><pose>0 0 0.5 0 0 0</pose><link name='link'>";
+  for (unsigned int i = 0; i < collisionCount; ++i)
+  {
+    beadsStr << "<collision name='collision_" << i << "'>"
+      << "<pose>" << i * 0.25 << " 0 0 0 0 0</pose>"
+      << "<geometry><sphere><radius>0.1</radius></sphere></geometry>"
+      << "</collision>";
+  }
+  beadsStr << "</link></model></sdf>";
+  SpawnSDF(beadsStr.str());
+
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+
+  EXPECT_EQ("bvh",
+      boost::any_cast<std::string>(odePhysics->GetParam("broadphase")));
+  EXPECT_EQ(20,
+      boost::any_cast<int>(odePhysics->GetParam("space_geom_threshold")));
+  EXPECT_EQ(dBVHSpaceClass, dSpaceGetClass(odePhysics->GetSpaceId()));
+
+  // The model with many collisions gets a BVH space, the ground a simple one
+  ModelPtr beads = world->ModelByName("beads");
+  ModelPtr ground = world->ModelByName("ground");
+  ASSERT_TRUE(beads != nullptr);
+  ASSERT_TRUE(ground != nullptr);
+  ODELinkPtr beadsLink =
+      boost::dynamic_pointer_cast<ODELink>(beads->GetLink("link"));
+  ODELinkPtr groundLink =
+      boost::dynamic_pointer_cast<ODELink>(ground->GetLink("link"));
+  ASSERT_TRUE(beadsLink != nullptr);
+  ASSERT_TRUE(groundLink != nullptr);
+  EXPECT_EQ(dBVHSpaceClass, dSpaceGetClass(beadsLink->GetSpaceId()));
+  EXPECT_EQ(static_cast<int>(collisionCount),
+      dSpaceGetNumGeoms(beadsLink->GetSpaceId()));
+  EXPECT_EQ(dSimpleSpaceClass, dSpaceGetClass(groundLink->GetSpaceId()));
+
+  // Invalid values
+  EXPECT_FALSE(odePhysics->SetParam("broadphase", std::string("bogus")));
+  EXPECT_FALSE(odePhysics->SetParam("space_geom_threshold", -1));
+  EXPECT_EQ("bvh",
+      boost::any_cast<std::string>(odePhysics->GetParam("broadphase")));
+
+  // The beads land on the ground
+  world->Step(1000);
+  EXPECT_NEAR(beads->WorldPose().Pos().Z(), 0.1, 1e-2);
+
+  // The broadphase can change while the world is running, and the model
+  // spaces follow the world space. The beads stay on the ground with any of
+  // them.
+  const int spaceCount = dSpaceGetNumGeoms(odePhysics->GetSpaceId());
+  for (auto const &type : {"simple", "hash", "sap", "bvh", "quadtree"})
+  {
+    EXPECT_TRUE(odePhysics->SetParam("broadphase", std::string(type)));
+    EXPECT_EQ(type,
+        boost::any_cast<std::string>(odePhysics->GetParam("broadphase")));
+    EXPECT_EQ(spaceCount, dSpaceGetNumGeoms(odePhysics->GetSpaceId()))
+        << type;
+
+    // Drop the beads again, from slightly above the ground
+    beads->SetWorldPose(ignition::math::Pose3d(0, 0, 0.15, 0, 0, 0));
+    world->Step(300);
+    EXPECT_NEAR(beads->WorldPose().Pos().Z(), 0.1, 1e-2) << type;
+  }
+
+  // A quadtree space that isn't empty can't be replaced
+  EXPECT_FALSE(odePhysics->SetParam("broadphase", std::string("hash")));
+  EXPECT_EQ("quadtree",
+      boost::any_cast<std::string>(odePhysics->GetParam("broadphase")));
+  world->Step(100);
+  EXPECT_NEAR(beads->WorldPose().Pos().Z(), 0.1, 1e-2);
+}
+
+/////////////////////////////////////////////////
+/// Test that resting islands sleep as a whole and wake up when touched
+TEST_F(ODEPhysics_TEST, IslandAutoDisable)
+{
+  // A stack of two boxes, and two boxes connected by a hinge
+  Load("worlds/ode_island_auto_disable.world", true, "ode");
+
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+
+  EXPECT_TRUE(
+      boost::any_cast<bool>(odePhysics->GetParam("auto_disable_islands")));
+  EXPECT_NEAR(0.05, boost::any_cast<double>(
+      odePhysics->GetParam("auto_disable_linear_threshold")), 1e-9);
+  EXPECT_NEAR(0.2, boost::any_cast<double>(
+      odePhysics->GetParam("auto_disable_time")), 1e-9);
+  EXPECT_EQ(20,
+      boost::any_cast<int>(odePhysics->GetParam("auto_disable_steps")));
+  EXPECT_FALSE(odePhysics->SetParam("auto_disable_time", -1.0));
+  EXPECT_FALSE(odePhysics->SetParam("auto_disable_steps", -1));
+
+  ModelPtr bottom = world->ModelByName("box_0");
+  ModelPtr top = world->ModelByName("box_1");
+  ModelPtr hinged = world->ModelByName("hinged");
+  ASSERT_TRUE(bottom != nullptr);
+  ASSERT_TRUE(top != nullptr);
+  ASSERT_TRUE(hinged != nullptr);
+  LinkPtr bottomLink = bottom->GetLink("link");
+  LinkPtr topLink = top->GetLink("link");
+  JointPtr hinge = hinged->GetJoint("hinge");
+  ASSERT_TRUE(hinge != nullptr);
+
+  // Everything comes to rest and sleeps, including the model with a joint
+  world->Step(2000);
+  EXPECT_EQ(4, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+  EXPECT_FALSE(bottomLink->GetEnabled());
+  EXPECT_FALSE(topLink->GetEnabled());
+  for (auto const &link : hinged->GetLinks())
+    EXPECT_FALSE(link->GetEnabled());
+
+  // Sleeping bodies don't move
+  const ignition::math::Pose3d topPose = topLink->WorldPose();
+  world->Step(100);
+  EXPECT_EQ(topPose, topLink->WorldPose());
+
+  // A wrench on the top box wakes up the box it rests on, through contacts
+  topLink->AddForce(ignition::math::Vector3d(0, 0, 1));
+  EXPECT_TRUE(topLink->GetEnabled());
+  world->Step(1);
+  EXPECT_TRUE(bottomLink->GetEnabled());
+  EXPECT_EQ(2, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+
+  // A joint command wakes up both sides of the joint
+  hinge->SetForce(0, 1.0);
+  for (auto const &link : hinged->GetLinks())
+    EXPECT_TRUE(link->GetEnabled());
+
+  // Moving a model wakes it up
+  world->Step(2000);
+  EXPECT_EQ(4, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+  top->SetWorldPose(ignition::math::Pose3d(5, 5, 2, 0, 0, 0));
+  EXPECT_TRUE(topLink->GetEnabled());
+  world->Step(1000);
+  EXPECT_NEAR(topLink->WorldPose().Pos().Z(), 0.5, 1e-2);
+
+  // Setting a parameter to its current value doesn't wake anything up
+  world->Step(1000);
+  EXPECT_EQ(4, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+  const int samples = boost::any_cast<int>(
+      odePhysics->GetParam("auto_disable_average_samples"));
+  EXPECT_TRUE(odePhysics->SetParam("auto_disable_steps", 20));
+  EXPECT_EQ(4, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+
+  // Changing the thresholds wakes everything up
+  bottomLink->SetAutoDisable(false);
+  EXPECT_TRUE(odePhysics->SetParam("auto_disable_average_samples", 0));
+  world->Step(1);
+  EXPECT_EQ(0, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+  world->Step(1000);
+  EXPECT_EQ(0, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+
+  // The choice of a link that mustn't sleep is kept
+  EXPECT_TRUE(odePhysics->SetParam("auto_disable_average_samples", samples));
+  world->Step(2000);
+  EXPECT_EQ(3, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+  EXPECT_TRUE(bottomLink->GetEnabled());
+  EXPECT_FALSE(topLink->GetEnabled());
+
+  // Without islands, the model with a joint doesn't sleep
+  EXPECT_TRUE(odePhysics->SetParam("auto_disable_islands", false));
+  world->Step(2000);
+  EXPECT_EQ(1, boost::any_cast<int>(odePhysics->GetParam("sleeping_bodies")));
+  for (auto const &link : hinged->GetLinks())
+    EXPECT_TRUE(link->GetEnabled());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEPhysics_TEST, IslandAutoDisableDefault)
+{
+  // Bodies aren't disabled by island unless the world asks for it
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_FALSE(
+      boost::any_cast<bool>(physics->GetParam("auto_disable_islands")));
+}
+
 /////////////////////////////////////////////////
 TEST_F(ODEPhysics_TEST, PhysicsMsgParam)
 {
@@ -79,8 +79,8 @@ void SimbodyModel::Init()
     this->GetGripper(i)->Init();
   }
 
-  // rebuild simbody state
-  // this needs to happen before this->joints are used
+  // Add the model to the simbody system. The joints are initialized once
+  // the system is rebuilt, see InitJoints.
   physics::SimbodyPhysicsPtr simbodyPhysics =
     boost::dynamic_pointer_cast<physics::SimbodyPhysics>(
         this->GetWorld()->Physics());
@@ -89,7 +89,15 @@ void SimbodyModel::Init()
     simbodyPhysics->InitModel(
         boost::static_pointer_cast<Model>(shared_from_this()));
   }
+  else
+  {
+    this->InitJoints();
+  }
+}
 
+//////////////////////////////////////////////////
+void SimbodyModel::InitJoints()
+{
   // Initialize the joints last.
   Joint_V myJoints = this->GetJoints();
   for (Joint_V::iterator iter = myJoints.begin();
@@ -44,6 +44,10 @@ namespace gazebo
 
       // Documentation inherited
       public: virtual void Init();
+
+      /// \brief Initialize the joints and publish their messages. Called by
+      /// SimbodyPhysics once the model is part of the simbody system.
+      public: void InitJoints();
     };
     /// \}
   }
@@ -16,6 +16,7 @@
 */
 
 #include <string>
+#include <utility>
 
 #include <ignition/common/Profiler.hh>
 
@@ -251,6 +252,8 @@ void SimbodyPhysics::OnPhysicsMsg(ConstPhysicsPtr &_msg)
 //////////////////////////////////////////////////
 void SimbodyPhysics::Reset()
 {
+  this->InitPendingModels();
+
   this->integ->initialize(this->system.getDefaultState());
 
   // restore potentially user run-time modified gravity
@@ -260,21 +263,24 @@ void SimbodyPhysics::Reset()
 //////////////////////////////////////////////////
 void SimbodyPhysics::Init()
 {
+  // All the models of the world are initialized, build the system once
+  this->InitPendingModels();
   this->simbodyPhysicsInitialized = true;
 }
 
 //////////////////////////////////////////////////
 void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
 {
-  // Before building a new system, transfer all joints in existing
-  // models, save Simbody joint states in Gazebo Model.
+  // Before changing the system, transfer all joints in existing
+  // models, save Simbody joint states in Gazebo Model. The models added
+  // since the last realization aren't part of the current state, so this is
+  // only done for the first model of a batch.
   const SimTK::State& currentState = this->integ->getState();
-  double stateTime = 0;
-  bool simbodyStateSaved = false;
 
-  if (currentState.getSystemStage() != SimTK::Stage::Empty)
+  if (this->pendingModels.empty() &&
+      currentState.getSystemStage() != SimTK::Stage::Empty)
   {
-    stateTime = currentState.getTime();
+    this->savedStateTime = currentState.getTime();
     physics::Model_V models = this->world->Models();
     for (physics::Model_V::iterator mi = models.begin();
          mi != models.end(); ++mi)
@@ -300,7 +306,7 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
         }
       }
     }
-    simbodyStateSaved = true;
+    this->simbodyStateSaved = true;
   }
 
   try
@@ -327,6 +333,19 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
     gzthrow(std::string("Simbody build EXCEPTION: ") + e.what());
   }
 
+  // The topology is realized once for all the models added before the next
+  // call to InitPendingModels
+  this->pendingModels.push_back(_model);
+}
+
+//////////////////////////////////////////////////
+void SimbodyPhysics::InitPendingModels()
+{
+  if (this->pendingModels.empty())
+    return;
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
   try
   {
     //------------------------ CREATE SIMBODY SYSTEM ---------------------------
@@ -335,6 +354,7 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
   }
   catch(const std::exception& e)
   {
+    this->pendingModels.clear();
     gzthrow(std::string("Simbody init EXCEPTION: ") + e.what());
   }
 
@@ -342,10 +362,10 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
 
   // Restore Gazebo saved Joint states
   // back into Simbody state.
-  if (simbodyStateSaved)
+  if (this->simbodyStateSaved)
   {
     // set/retsore state time.
-    state.setTime(stateTime);
+    state.setTime(this->savedStateTime);
 
     physics::Model_V models = this->world->Models();
     for (physics::Model_V::iterator mi = models.begin();
@@ -368,39 +388,54 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
         simbodyLink->RestoreSimbodyState(state);
       }
     }
+    this->simbodyStateSaved = false;
   }
 
   // initialize integrator from state
   this->integ->initialize(state);
 
-  // mark links as initialized
-  Link_V links = _model->GetLinks();
-  for (Link_V::iterator li = links.begin(); li != links.end(); ++li)
+  for (auto const &model : this->pendingModels)
   {
-    physics::SimbodyLinkPtr simbodyLink =
-      boost::dynamic_pointer_cast<physics::SimbodyLink>(*li);
-    if (simbodyLink)
-      simbodyLink->physicsInitialized = true;
-    else
-      gzerr << "failed to cast link [" << (*li)->GetName()
-            << "] as simbody link\n";
-  }
+    // mark links as initialized
+    Link_V links = model->GetLinks();
+    for (Link_V::iterator li = links.begin(); li != links.end(); ++li)
+    {
+      physics::SimbodyLinkPtr simbodyLink =
+        boost::dynamic_pointer_cast<physics::SimbodyLink>(*li);
+      if (simbodyLink)
+        simbodyLink->physicsInitialized = true;
+      else
+        gzerr << "failed to cast link [" << (*li)->GetName()
+              << "] as simbody link\n";
+    }
 
-  // mark joints as initialized
-  physics::Joint_V joints = _model->GetJoints();
-  for (physics::Joint_V::iterator ji = joints.begin();
-       ji != joints.end(); ++ji)
-  {
-    SimbodyJointPtr simbodyJoint =
-      boost::dynamic_pointer_cast<SimbodyJoint>(*ji);
-    if (simbodyJoint)
-      simbodyJoint->physicsInitialized = true;
-    else
-      gzerr << "simbodyJoint [" << (*ji)->GetName()
-            << "]is not a SimbodyJointPtr\n";
+    // mark joints as initialized
+    physics::Joint_V joints = model->GetJoints();
+    for (physics::Joint_V::iterator ji = joints.begin();
+         ji != joints.end(); ++ji)
+    {
+      SimbodyJointPtr simbodyJoint =
+        boost::dynamic_pointer_cast<SimbodyJoint>(*ji);
+      if (simbodyJoint)
+        simbodyJoint->physicsInitialized = true;
+      else
+        gzerr << "simbodyJoint [" << (*ji)->GetName()
+              << "]is not a SimbodyJointPtr\n";
+    }
   }
 
+  // The joints of the new models can use the state now
+  physics::Model_V initialized;
+  std::swap(initialized, this->pendingModels);
   this->simbodyPhysicsInitialized = true;
+
+  for (auto const &model : initialized)
+  {
+    SimbodyModelPtr simbodyModel =
+      boost::dynamic_pointer_cast<SimbodyModel>(model);
+    if (simbodyModel)
+      simbodyModel->InitJoints();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -416,6 +451,9 @@ void SimbodyPhysics::UpdateCollision()
   IGN_PROFILE_BEGIN("UpdateCollision");
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
+  // Models initialized outside of a world or factory batch
+  this->InitPendingModels();
+
   this->contactManager->ResetCount();
 
   // Get all contacts from Simbody
@@ -56,10 +56,15 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Reset();
 
-      /// \brief Add a Model to the Simbody system.
+      /// \brief Add a Model to the Simbody system. The system is rebuilt
+      /// and the model's joints are initialized by the next call to
+      /// InitPendingModels.
       /// \param[in] _model Pointer to the model to add into Simbody.
       public: void InitModel(const physics::ModelPtr _model);
 
+      // Documentation inherited
+      public: virtual void InitPendingModels();
+
       // Documentation inherited
       public: virtual void InitForThread();
 
@@ -282,6 +287,16 @@ namespace gazebo
       ///   SimTK::RungeKutta2Integrator(system)
       ///   SimTK::SemiExplicitEuler2Integrator(system)
       private: std::string integratorType;
+
+      /// \brief Models added since the topology was last realized.
+      private: physics::Model_V pendingModels;
+
+      /// \brief True if the joint states of the existing models were saved
+      /// before adding the pending models.
+      private: bool simbodyStateSaved = false;
+
+      /// \brief Time of the saved state.
+      private: double savedStateTime = 0;
     };
   /// \}
   }
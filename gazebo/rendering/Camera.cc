@@ -15,6 +15,7 @@
  *
 */
 
+#include <algorithm>
 #include <sstream>
 
 #include <boost/algorithm/string.hpp>
@@ -36,6 +37,7 @@
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/FrameWriter.hh"
 #include "gazebo/common/VideoEncoder.hh"
 
 #include "gazebo/rendering/ogre_gazebo.h"
@@ -52,6 +54,33 @@
 using namespace gazebo;
 using namespace rendering;
 
+/////////////////////////////////////////////////
+/// \brief Get the pixel format of the frames read from a render texture.
+/// \param[in] _format Ogre::PixelFormat of the frames.
+/// \return Pixel format, UNKNOWN_PIXEL_FORMAT if it has no equivalent.
+static common::Image::PixelFormat framePixelFormat(const int _format)
+{
+  switch (_format)
+  {
+    case Ogre::PF_L8:
+      return common::Image::L_INT8;
+    case Ogre::PF_L16:
+      return common::Image::L_INT16;
+    case Ogre::PF_BYTE_RGB:
+      return common::Image::RGB_INT8;
+    case Ogre::PF_BYTE_BGR:
+      return common::Image::BGR_INT8;
+    case Ogre::PF_SHORT_RGB:
+      return common::Image::RGB_INT16;
+    case Ogre::PF_FLOAT16_R:
+      return common::Image::R_FLOAT16;
+    case Ogre::PF_FLOAT32_R:
+      return common::Image::R_FLOAT32;
+    default:
+      return common::Image::UNKNOWN_PIXEL_FORMAT;
+  }
+}
+
 
 unsigned int CameraPrivate::cameraCounter = 0;
 
@@ -101,6 +130,7 @@ Camera::Camera(const std::string &_name, ScenePtr _scene,
   this->connections.push_back(
       event::Events::ConnectPreRender(std::bind(&Camera::Update, this)));
 
+  this->dataPtr->autoRender = _autoRender;
   if (_autoRender)
   {
     this->connections.push_back(event::Events::ConnectRender(
@@ -352,6 +382,7 @@ void Camera::Init()
 void Camera::Fini()
 {
   this->dataPtr->videoEncoder.Reset();
+  this->dataPtr->readback.Release();
 
   if (this->saveFrameBuffer)
     delete [] this->saveFrameBuffer;
@@ -557,6 +588,7 @@ void Camera::Render(const bool _force)
         this->dataPtr->renderPeriod))
   {
     this->newData = true;
+    this->dataPtr->renderSimTime = this->scene->SimTime();
     this->RenderImpl();
   }
 }
@@ -575,21 +607,51 @@ void Camera::RenderImpl()
 //////////////////////////////////////////////////
 void Camera::ReadPixelBuffer()
 {
-  if (this->newData && (this->captureData || this->captureDataOnce ||
-      this->dataPtr->videoEncoder.IsEncoding()))
+  this->dataPtr->frameReady = false;
+
+  if (!this->captureData && !this->captureDataOnce &&
+      !this->dataPtr->videoEncoder.IsEncoding())
   {
-    size_t size;
-    unsigned int width = this->ImageWidth();
-    unsigned int height = this->ImageHeight();
+    // Nobody wants the frames being read anymore
+    this->dataPtr->readback.Clear();
+    return;
+  }
+
+  if (!this->newData && this->dataPtr->readback.Pending() == 0)
+    return;
 
-    // Get access to the buffer and make an image and write it to file
-    size = Ogre::PixelUtil::getMemorySize(width, height, 1,
-        static_cast<Ogre::PixelFormat>(this->imageFormat));
+  size_t size;
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+
+  // Get access to the buffer and make an image and write it to file
+  size = Ogre::PixelUtil::getMemorySize(width, height, 1,
+      static_cast<Ogre::PixelFormat>(this->imageFormat));
+
+  // Allocate buffer
+  if (!this->saveFrameBuffer)
+    this->saveFrameBuffer = new unsigned char[size];
+
+  // Queue the new frame and deliver the oldest one the GPU has copied.
+  // Only frames rendered to our own texture can be read this way.
+  if (this->dataPtr->asyncReadback > 1 && this->renderTexture &&
+      this->renderTexture->getBuffer()->getRenderTarget() == this->renderTarget)
+  {
+    if (!this->newData || this->dataPtr->readback.Read(this->renderTexture,
+          this->imageFormat, this->dataPtr->renderSimTime))
+    {
+      this->dataPtr->frameReady = this->dataPtr->readback.Fetch(
+          this->saveFrameBuffer, size, this->dataPtr->frameSimTime);
+      return;
+    }
 
-    // Allocate buffer
-    if (!this->saveFrameBuffer)
-      this->saveFrameBuffer = new unsigned char[size];
+    gzwarn << "Unable to read frames of camera[" << this->Name()
+           << "] asynchronously, reading them synchronously\n";
+    this->SetAsyncReadback(0);
+  }
 
+  if (this->newData)
+  {
     memset(this->saveFrameBuffer, 128, size);
 
     Ogre::PixelBox box(width, height, 1,
@@ -639,15 +701,57 @@ void Camera::ReadPixelBuffer()
     // pixels from buffer into memory.
     this->viewport->getTarget()->copyContentsToMemory(box);
 #endif
+
+    this->dataPtr->frameSimTime = this->dataPtr->renderSimTime;
+    this->dataPtr->frameReady = true;
   }
 }
 
+//////////////////////////////////////////////////
+bool Camera::SetAsyncReadback(const unsigned int _buffers)
+{
+  if (_buffers > 1 && !PixelReadback::Supported())
+  {
+    gzwarn << "Asynchronous readback requires the OpenGL render system, "
+           << "camera[" << this->Name() << "] reads frames synchronously\n";
+    return false;
+  }
+
+  this->dataPtr->asyncReadback = _buffers > 1 ? _buffers : 0;
+  this->dataPtr->readback.SetBufferCount(std::max(_buffers, 2u));
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int Camera::AsyncReadback() const
+{
+  return this->dataPtr->asyncReadback;
+}
+
+//////////////////////////////////////////////////
+bool Camera::FrameReady() const
+{
+  return this->dataPtr->frameReady;
+}
+
+//////////////////////////////////////////////////
+common::Time Camera::FrameSimTime() const
+{
+  return this->dataPtr->frameSimTime;
+}
+
 //////////////////////////////////////////////////
 common::Time Camera::LastRenderWallTime() const
 {
   return this->lastRenderWallTime;
 }
 
+//////////////////////////////////////////////////
+bool Camera::AutoRender() const
+{
+  return this->dataPtr->autoRender;
+}
+
 //////////////////////////////////////////////////
 void Camera::PostRender()
 {
@@ -658,8 +762,7 @@ void Camera::PostRender()
   if (this->newData)
     this->lastRenderWallTime = common::Time::GetWallTime();
 
-  if (this->newData && (this->captureData || this->captureDataOnce ||
-      this->dataPtr->videoEncoder.IsEncoding()))
+  if (this->dataPtr->frameReady)
   {
     unsigned int width = this->ImageWidth();
     unsigned int height = this->ImageHeight();
@@ -678,7 +781,15 @@ void Camera::PostRender()
     if (this->sdf->HasElement("save") &&
         this->sdf->GetElement("save")->Get<bool>("enabled"))
     {
-      this->SaveFrame(this->FrameFilename());
+      common::Image::PixelFormat format = framePixelFormat(this->imageFormat);
+      if (this->dataPtr->frameWriter &&
+          this->dataPtr->frameWriter->Supports(format))
+      {
+        this->dataPtr->frameWriter->Save(this->saveFrameBuffer, width, height,
+            format, this->FrameFilename());
+      }
+      else
+        this->SaveFrame(this->FrameFilename());
     }
 
     // do last minute conversion if Bayer pattern is requested, go from R8G8B8
@@ -1021,6 +1132,19 @@ void Camera::EnableSaveFrame(const bool _enable)
   this->captureData = _enable;
 }
 
+//////////////////////////////////////////////////
+void Camera::SetFrameWriter(common::FrameWriterPtr _writer)
+{
+  this->dataPtr->frameWriter = _writer;
+  this->dataPtr->videoEncoder.SetFrameWriter(_writer);
+}
+
+//////////////////////////////////////////////////
+common::FrameWriterPtr Camera::FrameWriter() const
+{
+  return this->dataPtr->frameWriter;
+}
+
 //////////////////////////////////////////////////
 bool Camera::CaptureData() const
 {
@@ -1193,9 +1317,16 @@ std::string Camera::FrameFilename()
   }
   else
   {
+    std::string extension = "jpg";
+    if (this->dataPtr->frameWriter && this->dataPtr->frameWriter->Supports(
+          framePixelFormat(this->imageFormat)))
+    {
+      extension = this->dataPtr->frameWriter->Extension();
+    }
+
     pathToFile = (path.empty()) ? "." : path;
-    pathToFile /= str(boost::format("%s-%04d.jpg")
-        % friendlyName.c_str() % this->saveCount);
+    pathToFile /= str(boost::format("%s-%04d.%s")
+        % friendlyName.c_str() % this->saveCount % extension);
     this->saveCount++;
   }
 
@@ -1552,6 +1683,7 @@ double Camera::LimitFOV(const double _fov)
 void Camera::SetRenderTarget(Ogre::RenderTarget *_target)
 {
   this->renderTarget = _target;
+  this->dataPtr->readback.Clear();
 
   if (this->renderTarget)
   {
@@ -2110,6 +2242,12 @@ event::ConnectionPtr Camera::ConnectNewImageFrame(
   return this->newImageFrame.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+unsigned int Camera::NewImageFrameConnectionCount() const
+{
+  return this->newImageFrame.ConnectionCount();
+}
+
 //////////////////////////////////////////////////
 VisualPtr Camera::TrackedVisual() const
 {
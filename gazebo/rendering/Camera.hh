@@ -40,6 +40,7 @@
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Subscriber.hh"
 
+#include "gazebo/common/CommonTypes.hh"
 #include "gazebo/common/Event.hh"
 #include "gazebo/common/PID.hh"
 #include "gazebo/common/Time.hh"
@@ -397,6 +398,19 @@ namespace gazebo
       /// \param[in] _enable Set to True to enable saving of frames
       public: void EnableSaveFrame(const bool _enable);
 
+      /// \brief Save the frames enabled with EnableSaveFrame and encode the
+      /// video frames on the worker threads of a frame writer, instead of
+      /// in PostRender. Saved frames get the extension of the writer's file
+      /// format. Pixel formats the writer doesn't support are still saved
+      /// in PostRender.
+      /// \param[in] _writer Frame writer, which can be shared between
+      /// cameras, or null to save frames in PostRender.
+      public: void SetFrameWriter(common::FrameWriterPtr _writer);
+
+      /// \brief Get the frame writer saving the frames.
+      /// \return Frame writer, null if frames are saved in PostRender.
+      public: common::FrameWriterPtr FrameWriter() const;
+
       /// \brief Return the value of this->captureData.
       /// \return True if the camera is set to capture data.
       public: bool CaptureData() const;
@@ -607,6 +621,12 @@ namespace gazebo
           std::function<void (const unsigned char *, unsigned int, unsigned int,
           unsigned int, const std::string &)> _subscriber);
 
+      /// \brief Get the number of callbacks connected to the new image
+      /// signal.
+      /// \return Number of connections.
+      /// \sa ConnectNewImageFrame
+      public: unsigned int NewImageFrameConnectionCount() const;
+
       /// \brief Save a frame using an image buffer
       /// \param[in] _image The raw image buffer
       /// \param[in] _width Width of the image
@@ -624,6 +644,37 @@ namespace gazebo
       /// \return Time the camera was last rendered
       public: common::Time LastRenderWallTime() const;
 
+      /// \brief Get whether the camera renders on every render event, as
+      /// opposed to a camera rendered by its owner, such as a sensor.
+      /// \return True if the camera renders on every render event.
+      public: bool AutoRender() const;
+
+      /// \brief Read the rendered frames asynchronously. A frame is read
+      /// into one of a ring of pixel buffers, and is delivered through the
+      /// new image signal while the next frames render. Frames are therefore
+      /// delivered with a delay of up to _buffers - 1 renders, and should be
+      /// stamped with FrameSimTime(). Only available with the OpenGL render
+      /// system on Linux.
+      /// \param[in] _buffers Number of frames read at the same time: 0 or 1
+      /// to read synchronously, 2 for double buffering, 3 for triple
+      /// buffering.
+      /// \return False if frames can't be read asynchronously.
+      public: bool SetAsyncReadback(const unsigned int _buffers);
+
+      /// \brief Get the number of frames read at the same time.
+      /// \return 0 if frames are read synchronously.
+      public: unsigned int AsyncReadback() const;
+
+      /// \brief Get whether the last PostRender() delivered a frame. With
+      /// synchronous readback this is true after each captured render.
+      /// \return True if ImageData() was updated by the last PostRender().
+      public: bool FrameReady() const;
+
+      /// \brief Get the simulation time at which the frame in ImageData()
+      /// was rendered.
+      /// \return Simulation time of the frame.
+      public: common::Time FrameSimTime() const;
+
       /// \brief Return true if the visual is within the camera's view
       /// frustum
       /// \param[in] _visual The visual to check for visibility
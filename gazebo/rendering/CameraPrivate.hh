@@ -23,9 +23,11 @@
 #include <list>
 #include <ignition/math/Pose3.hh>
 
+#include "gazebo/common/FrameWriter.hh"
 #include "gazebo/common/PID.hh"
 #include "gazebo/common/VideoEncoder.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/rendering/PixelReadback.hh"
 #include "gazebo/util/system.hh"
 
 namespace Ogre
@@ -117,6 +119,29 @@ namespace gazebo
 
       /// \brief Fixed axis to yaw around.
       public: ignition::math::Vector3d yawFixedAxis;
+
+      /// \brief Frame writer saving the frames, null to save them in
+      /// PostRender.
+      public: common::FrameWriterPtr frameWriter;
+
+      /// \brief Asynchronous readback of the rendered frames.
+      public: PixelReadback readback;
+
+      /// \brief Number of frames read at the same time, 0 to read
+      /// synchronously.
+      public: unsigned int asyncReadback = 0;
+
+      /// \brief Simulation time of the last render.
+      public: common::Time renderSimTime;
+
+      /// \brief Simulation time of the frame in the image buffer.
+      public: common::Time frameSimTime;
+
+      /// \brief True if the last PostRender delivered a frame.
+      public: bool frameReady = false;
+
+      /// \brief True if the camera renders on every render event.
+      public: bool autoRender = true;
     };
   }
 }
@@ -16,6 +16,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <vector>
+
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/RenderTypes.hh"
@@ -184,6 +186,87 @@ TEST_F(Camera_TEST, Create)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(Camera_TEST, AsyncReadback)
+{
+  Load("worlds/shapes.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene("default");
+
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("test_camera_async", false);
+  ASSERT_TRUE(camera != nullptr);
+  camera->Load();
+  camera->Init();
+  camera->CreateRenderTexture("test_camera_async_texture");
+  camera->SetWorldPose(ignition::math::Pose3d(-5, 0, 1, 0, 0, 0));
+  camera->SetCaptureData(true);
+
+  unsigned int frames = 0;
+  event::ConnectionPtr connection = camera->ConnectNewImageFrame(
+      [&frames](const unsigned char *, unsigned int, unsigned int,
+        unsigned int, const std::string &)
+      {
+        ++frames;
+      });
+
+  // Synchronous readback delivers each frame right after it is rendered
+  EXPECT_EQ(0u, camera->AsyncReadback());
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_EQ(1u, frames);
+  EXPECT_TRUE(camera->FrameReady());
+  EXPECT_EQ(scene->SimTime(), camera->FrameSimTime());
+
+  unsigned int size = camera->ImageMemorySize();
+  std::vector<unsigned char> syncImage(camera->ImageData(),
+      camera->ImageData() + size);
+
+  if (!camera->SetAsyncReadback(3))
+  {
+    EXPECT_EQ(0u, camera->AsyncReadback());
+    scene->RemoveCamera(camera->Name());
+    return;
+  }
+  EXPECT_EQ(3u, camera->AsyncReadback());
+
+  // Triple buffering delivers each frame at the latest two renders later
+  frames = 0;
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    camera->Render(true);
+    camera->PostRender();
+  }
+  EXPECT_GE(frames, 8u);
+  EXPECT_LE(frames, 10u);
+
+  // The scene is static, so the frames read asynchronously are the same
+  std::vector<unsigned char> asyncImage(camera->ImageData(),
+      camera->ImageData() + size);
+  EXPECT_TRUE(syncImage == asyncImage);
+
+  // Back to synchronous readback
+  EXPECT_TRUE(camera->SetAsyncReadback(0));
+  EXPECT_EQ(0u, camera->AsyncReadback());
+  frames = 0;
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_EQ(1u, frames);
+
+  // Nothing is delivered when data isn't captured
+  camera->SetCaptureData(false);
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_FALSE(camera->FrameReady());
+  EXPECT_EQ(1u, frames);
+
+  scene->RemoveCamera(camera->Name());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
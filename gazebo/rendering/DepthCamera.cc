@@ -21,6 +21,9 @@
   #include "gazebo/common/win_dirent.h"
 #endif
 
+#include <tuple>
+#include <vector>
+
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Console.hh"
 
@@ -216,6 +219,12 @@ void DepthCamera::Fini()
   this->dataPtr->reflectanceTextures = nullptr;
 
   this->dataPtr->reflectanceMaterialSwitcher.reset();
+
+  this->dataPtr->depthReadback.Release();
+  this->dataPtr->pcdReadback.Release();
+  this->dataPtr->reflectanceReadback.Release();
+  this->dataPtr->normalsReadback.Release();
+
   Camera::Fini();
 }
 
@@ -402,7 +411,15 @@ void DepthCamera::PostRender()
   if (this->dataPtr->outputNormals)
     this->dataPtr->normalsTarget->swapBuffers();
 
-  if (this->newData && this->captureData)
+  if (!this->captureData)
+  {
+    this->dataPtr->depthReadback.Clear();
+    this->dataPtr->pcdReadback.Clear();
+    this->dataPtr->reflectanceReadback.Clear();
+    this->dataPtr->normalsReadback.Clear();
+  }
+
+  if (this->newData && this->captureData && !this->QueueReadback())
   {
     unsigned int width = this->ImageWidth();
     unsigned int height = this->ImageHeight();
@@ -427,9 +444,6 @@ void DepthCamera::PostRender()
       pixelBuffer->lock(Ogre::HardwarePixelBuffer::HBL_NORMAL);
       pixelBuffer->blitToMemory(dstBox);
       pixelBuffer->unlock();  // FIXME: do we need to lock/unlock still?
-
-      this->dataPtr->newDepthFrame(
-          this->dataPtr->depthBuffer, width, height, 1, "FLOAT32");
     }
     else
     {
@@ -451,9 +465,6 @@ void DepthCamera::PostRender()
       pcdPixelBuffer->lock(Ogre::HardwarePixelBuffer::HBL_NORMAL);
       pcdPixelBuffer->blitToMemory(pcd_src_box, pcd_dst_box);
       pcdPixelBuffer->unlock();
-
-      this->dataPtr->newRGBPointCloud(
-          this->dataPtr->pcdBuffer, width, height, 1, "RGBPOINTS");
     }
 
     if (this->dataPtr->outputReflectance)
@@ -476,9 +487,6 @@ void DepthCamera::PostRender()
      reflectancePixelBuffer->blitToMemory(reflectance_src_box,
                                           reflectance_dst_box);
      reflectancePixelBuffer->unlock();
-
-     this->dataPtr->newReflectanceFrame(
-         this->dataPtr->reflectanceBuffer, width, height, 1, "REFLECTANCE");
     }
 
     if (this->dataPtr->outputNormals)
@@ -500,17 +508,154 @@ void DepthCamera::PostRender()
       normalsPixelBuffer->lock(Ogre::HardwarePixelBuffer::HBL_NORMAL);
       normalsPixelBuffer->blitToMemory(normals_src_box, normals_dst_box);
       normalsPixelBuffer->unlock();
-
-      this->dataPtr->newNormalsPointCloud(
-          this->dataPtr->normalsBuffer, width, height, 1, "NORMALS");
     }
+
+    this->EmitFrames();
   }
   // also new image frame for camera texture
   Camera::PostRender();
 
+  // The buffers were queued before the image, so they are copied by the
+  // time the image is
+  if (this->FrameReady() && this->FetchReadback())
+    this->EmitFrames();
+
   this->newData = false;
 }
 
+//////////////////////////////////////////////////
+bool DepthCamera::QueueReadback()
+{
+  const unsigned int buffers = this->AsyncReadback();
+  if (buffers < 2)
+    return false;
+
+  std::vector<std::tuple<PixelReadback *, Ogre::Texture *, Ogre::PixelFormat>>
+      reads;
+  if (!this->dataPtr->outputPoints)
+  {
+    reads.emplace_back(&this->dataPtr->depthReadback, this->depthTexture,
+        Ogre::PF_FLOAT32_R);
+  }
+  else
+  {
+    reads.emplace_back(&this->dataPtr->pcdReadback, this->dataPtr->pcdTexture,
+        Ogre::PF_FLOAT32_RGBA);
+  }
+  if (this->dataPtr->outputReflectance)
+  {
+    reads.emplace_back(&this->dataPtr->reflectanceReadback,
+        this->dataPtr->reflectanceTextures, Ogre::PF_FLOAT32_R);
+  }
+  if (this->dataPtr->outputNormals)
+  {
+    reads.emplace_back(&this->dataPtr->normalsReadback,
+        this->dataPtr->normalsTextures, Ogre::PF_FLOAT32_RGBA);
+  }
+
+  const common::Time simTime = this->scene->SimTime();
+  for (auto &read : reads)
+  {
+    PixelReadback *readback = std::get<0>(read);
+    if (readback->BufferCount() != buffers)
+      readback->SetBufferCount(buffers);
+
+    if (!readback->Read(std::get<1>(read), std::get<2>(read), simTime))
+    {
+      gzwarn << "Unable to read depth buffers of camera[" << this->Name()
+             << "] asynchronously, reading them synchronously\n";
+      for (auto &queued : reads)
+        std::get<0>(queued)->Clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool DepthCamera::FetchReadback()
+{
+  if (this->dataPtr->depthReadback.Pending() == 0 &&
+      this->dataPtr->pcdReadback.Pending() == 0)
+  {
+    return false;
+  }
+
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  const size_t depthSize = Ogre::PixelUtil::getMemorySize(
+      width, height, 1, Ogre::PF_FLOAT32_R);
+  const size_t pointsSize = Ogre::PixelUtil::getMemorySize(
+      width, height, 1, Ogre::PF_FLOAT32_RGBA);
+  common::Time simTime;
+
+  // Fetch every buffer, so that they all stay on the same frame
+  bool fetched;
+  if (!this->dataPtr->outputPoints)
+  {
+    if (!this->dataPtr->depthBuffer)
+      this->dataPtr->depthBuffer = new float[depthSize];
+    fetched = this->dataPtr->depthReadback.Fetch(
+        this->dataPtr->depthBuffer, depthSize, simTime);
+  }
+  else
+  {
+    if (!this->dataPtr->pcdBuffer)
+      this->dataPtr->pcdBuffer = new float[width * height * 4];
+    fetched = this->dataPtr->pcdReadback.Fetch(
+        this->dataPtr->pcdBuffer, pointsSize, simTime);
+  }
+
+  if (this->dataPtr->outputReflectance)
+  {
+    if (!this->dataPtr->reflectanceBuffer)
+      this->dataPtr->reflectanceBuffer = new float[width * height * 1];
+    fetched = this->dataPtr->reflectanceReadback.Fetch(
+        this->dataPtr->reflectanceBuffer, depthSize, simTime) && fetched;
+  }
+
+  if (this->dataPtr->outputNormals)
+  {
+    if (!this->dataPtr->normalsBuffer)
+      this->dataPtr->normalsBuffer = new float[width * height * 4];
+    fetched = this->dataPtr->normalsReadback.Fetch(
+        this->dataPtr->normalsBuffer, pointsSize, simTime) && fetched;
+  }
+
+  return fetched;
+}
+
+//////////////////////////////////////////////////
+void DepthCamera::EmitFrames()
+{
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+
+  if (!this->dataPtr->outputPoints)
+  {
+    this->dataPtr->newDepthFrame(
+        this->dataPtr->depthBuffer, width, height, 1, "FLOAT32");
+  }
+  else
+  {
+    this->dataPtr->newRGBPointCloud(
+        this->dataPtr->pcdBuffer, width, height, 1, "RGBPOINTS");
+  }
+
+  if (this->dataPtr->outputReflectance)
+  {
+    this->dataPtr->newReflectanceFrame(
+        this->dataPtr->reflectanceBuffer, width, height, 1, "REFLECTANCE");
+  }
+
+  if (this->dataPtr->outputNormals)
+  {
+    this->dataPtr->newNormalsPointCloud(
+        this->dataPtr->normalsBuffer, width, height, 1, "NORMALS");
+  }
+}
+
 //////////////////////////////////////////////////
 void DepthCamera::UpdateRenderTarget(Ogre::RenderTarget *_target,
           Ogre::Material *_material, const std::string &_matName)
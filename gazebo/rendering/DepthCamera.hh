@@ -138,6 +138,19 @@ namespace gazebo
                                        Ogre::Material *_material,
                                        const std::string &_matName);
 
+      /// \brief Queue asynchronous reads of the depth, point cloud,
+      /// reflectance and normals buffers which are generated.
+      /// \return False if the buffers must be read synchronously.
+      private: bool QueueReadback();
+
+      /// \brief Copy the oldest asynchronously read buffers into memory.
+      /// \return True if the buffers were copied.
+      private: bool FetchReadback();
+
+      /// \brief Signal the depth, point cloud, reflectance and normals
+      /// buffers which are generated.
+      private: void EmitFrames();
+
       /// \brief Pointer to the depth texture
       protected: Ogre::Texture *depthTexture;
 
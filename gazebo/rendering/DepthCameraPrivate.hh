@@ -23,6 +23,7 @@
 #include "gazebo/common/Event.hh"
 
 #include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/PixelReadback.hh"
 
 namespace Ogre
 {
@@ -117,6 +118,18 @@ namespace gazebo
       /// \brief Point cloud texture
       public: Ogre::RenderTarget *normalsTarget = nullptr;
 
+      /// \brief Asynchronous readback of the depth buffer.
+      public: PixelReadback depthReadback;
+
+      /// \brief Asynchronous readback of the point cloud buffer.
+      public: PixelReadback pcdReadback;
+
+      /// \brief Asynchronous readback of the reflectance buffer.
+      public: PixelReadback reflectanceReadback;
+
+      /// \brief Asynchronous readback of the normals buffer.
+      public: PixelReadback normalsReadback;
+
       /// \brief Event used to signal rgb point cloud data
       public: event::EventT<void(const float *, unsigned int, unsigned int,
                    unsigned int, const std::string &)> newRGBPointCloud;
@@ -894,3 +894,9 @@ event::ConnectionPtr GpuLaser::ConnectNewLaserFrame(
 {
   return this->dataPtr->newLaserFrame.Connect(_subscriber);
 }
+
+//////////////////////////////////////////////////
+unsigned int GpuLaser::NewLaserFrameConnectionCount() const
+{
+  return this->dataPtr->newLaserFrame.ConnectionCount();
+}
@@ -105,6 +105,12 @@ namespace gazebo
                   unsigned int _height, unsigned int _depth,
                   const std::string &_format)> _subscriber);
 
+      /// \brief Get the number of callbacks connected to the laser frame
+      /// signal.
+      /// \return Number of connections.
+      /// \sa ConnectNewLaserFrame
+      public: unsigned int NewLaserFrameConnectionCount() const;
+
       /// \brief Set the number of samples in the width and height for the
       /// first pass texture.
       /// \param[in] _w Number of samples in the horizontal sweep
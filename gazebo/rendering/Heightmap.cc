@@ -31,6 +31,7 @@
 #include "gazebo/common/Dem.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/HeightmapData.hh"
+#include "gazebo/common/HeightmapTileCache.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/rendering/ogre_gazebo.h"
@@ -434,17 +435,75 @@ void Heightmap::Load()
       else
         scale.Z(fabs(this->dataPtr->terrainSize.Z()) / heightmapSizeZ);
 
-      // Construct the heightmap lookup table
-      std::vector<float> lookup;
-      this->dataPtr->heightmapData->FillHeightMap(this->dataPtr->sampling,
-          vertSize, this->dataPtr->terrainSize, scale, flipY, lookup);
+      // With paging, read the heights from the tile cache shared with the
+      // physics side, so that the heightmap file is sampled only once and
+      // one strip at a time. The cache stores unflipped rows, like flipY.
+      common::HeightmapData *heightmapData = this->dataPtr->heightmapData;
+      int sampling = this->dataPtr->sampling;
+      ignition::math::Vector3d terrainSize = this->dataPtr->terrainSize;
 
-      for (unsigned int y = 0; y < vertSize; ++y)
+      common::HeightmapTileCache cache;
+      if (this->dataPtr->useTerrainPaging)
       {
-        for (unsigned int x = 0; x < vertSize; ++x)
+        std::string cachePath = common::HeightmapTileCache::CacheFilename(
+            this->dataPtr->filename, sampling, vertSize, terrainSize, scale,
+            common::HeightmapTileCache::DefaultTileSize);
+        if (!cache.Load(cachePath) || cache.VertexCount() != vertSize)
         {
-          int index = (vertSize - y - 1) * vertSize + x;
-          this->dataPtr->heights.push_back(lookup[index] - minElevation);
+          boost::system::error_code ec;
+          boost::filesystem::create_directories(
+              boost::filesystem::path(cachePath).parent_path(), ec);
+          if (common::HeightmapTileCache::Build(cachePath, vertSize,
+                common::HeightmapTileCache::DefaultTileSize,
+                [&](unsigned int _x, unsigned int _y, unsigned int _width,
+                  unsigned int _height, std::vector<float> &_heights)
+                {
+                  heightmapData->FillHeightMapRegion(sampling, vertSize,
+                      terrainSize, scale, flipY, _x, _y, _width, _height,
+                      _heights);
+                }))
+          {
+            cache.Load(cachePath);
+          }
+        }
+      }
+
+      if (cache.Valid())
+      {
+        this->dataPtr->heights.reserve(vertSize * vertSize);
+        std::vector<float> row;
+        for (unsigned int y = 0; y < vertSize; ++y)
+        {
+          if (!cache.FillRegion(0, vertSize - y - 1, vertSize, 1, row))
+          {
+            this->dataPtr->heights.clear();
+            break;
+          }
+
+          for (auto const h : row)
+            this->dataPtr->heights.push_back(h - minElevation);
+
+          // Only a few tiles are needed at a time
+          if ((vertSize - y - 1) % cache.TileSize() == 0)
+            cache.UpdateResidency({}, 0);
+        }
+      }
+
+      // Fall back to the full lookup table if the cache is unused or unusable
+      if (this->dataPtr->heights.empty())
+      {
+        // Construct the heightmap lookup table
+        std::vector<float> lookup;
+        heightmapData->FillHeightMap(sampling, vertSize, terrainSize, scale,
+            flipY, lookup);
+
+        for (unsigned int y = 0; y < vertSize; ++y)
+        {
+          for (unsigned int x = 0; x < vertSize; ++x)
+          {
+            int index = (vertSize - y - 1) * vertSize + x;
+            this->dataPtr->heights.push_back(lookup[index] - minElevation);
+          }
         }
       }
 
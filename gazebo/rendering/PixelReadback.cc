@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Pixel buffers and fences are used through the OpenGL 2.1 and 3.2 entry
+// points exported by the Linux OpenGL libraries.
+#if defined(HAVE_OPENGL) && !defined(_WIN32) && !defined(__APPLE__)
+#define GZ_PIXEL_READBACK_ASYNC
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+#include <cstring>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/rendering/ogre_gazebo.h"
+#include "gazebo/rendering/PixelReadback.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+/// \brief A frame being read.
+struct PixelReadbackFrame
+{
+  /// \brief OpenGL pixel buffer.
+  unsigned int buffer = 0;
+
+  /// \brief Allocated size of the pixel buffer in bytes.
+  size_t capacity = 0;
+
+  /// \brief Size of the frame in bytes.
+  size_t size = 0;
+
+  /// \brief OpenGL fence signaled when the frame is copied.
+  void *fence = nullptr;
+
+  /// \brief Time of the frame.
+  common::Time time;
+};
+
+/// \brief Private data for the PixelReadback class.
+class gazebo::rendering::PixelReadbackPrivate
+{
+  /// \brief Ring of frames.
+  public: std::vector<PixelReadbackFrame> frames;
+
+  /// \brief Index of the oldest queued frame.
+  public: unsigned int first = 0;
+
+  /// \brief Number of queued frames.
+  public: unsigned int pending = 0;
+};
+
+#ifdef GZ_PIXEL_READBACK_ASYNC
+/////////////////////////////////////////////////
+/// \brief Get the OpenGL format and type of a pixel format, as used by the
+/// OpenGL render system to download textures.
+/// \param[in] _format Ogre::PixelFormat.
+/// \param[out] _glFormat OpenGL format.
+/// \param[out] _glType OpenGL type.
+/// \return False if the format isn't supported.
+static bool glPixelFormat(const int _format, GLenum &_glFormat,
+    GLenum &_glType)
+{
+  switch (_format)
+  {
+    case Ogre::PF_L8:
+      _glFormat = GL_LUMINANCE;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    case Ogre::PF_L16:
+      _glFormat = GL_LUMINANCE;
+      _glType = GL_UNSIGNED_SHORT;
+      return true;
+    case Ogre::PF_BYTE_RGB:
+      _glFormat = GL_RGB;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    case Ogre::PF_BYTE_BGR:
+      _glFormat = GL_BGR;
+      _glType = GL_UNSIGNED_BYTE;
+      return true;
+    case Ogre::PF_SHORT_RGB:
+      _glFormat = GL_RGB;
+      _glType = GL_UNSIGNED_SHORT;
+      return true;
+    case Ogre::PF_FLOAT16_R:
+      _glFormat = GL_RED;
+      _glType = GL_HALF_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT32_R:
+      _glFormat = GL_RED;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT32_RGB:
+      _glFormat = GL_RGB;
+      _glType = GL_FLOAT;
+      return true;
+    case Ogre::PF_FLOAT32_RGBA:
+      _glFormat = GL_RGBA;
+      _glType = GL_FLOAT;
+      return true;
+    default:
+      return false;
+  }
+}
+#endif
+
+/////////////////////////////////////////////////
+PixelReadback::PixelReadback()
+  : dataPtr(new PixelReadbackPrivate)
+{
+  this->SetBufferCount(2);
+}
+
+/////////////////////////////////////////////////
+PixelReadback::~PixelReadback()
+{
+}
+
+/////////////////////////////////////////////////
+bool PixelReadback::Supported()
+{
+#ifdef GZ_PIXEL_READBACK_ASYNC
+  Ogre::Root *root = Ogre::Root::getSingletonPtr();
+  return root && root->getRenderSystem() &&
+      root->getRenderSystem()->getName() == "OpenGL Rendering Subsystem";
+#else
+  return false;
+#endif
+}
+
+/////////////////////////////////////////////////
+void PixelReadback::SetBufferCount(const unsigned int _count)
+{
+  this->Release();
+  this->dataPtr->frames.resize(_count);
+}
+
+/////////////////////////////////////////////////
+unsigned int PixelReadback::BufferCount() const
+{
+  return this->dataPtr->frames.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int PixelReadback::Pending() const
+{
+  return this->dataPtr->pending;
+}
+
+/////////////////////////////////////////////////
+bool PixelReadback::Read(Ogre::Texture *_texture, const int _format,
+    const common::Time &_time)
+{
+#ifdef GZ_PIXEL_READBACK_ASYNC
+  const unsigned int count = this->dataPtr->frames.size();
+  if (!_texture || count == 0 || this->dataPtr->pending == count)
+    return false;
+
+  GLenum glFormat, glType;
+  if (!glPixelFormat(_format, glFormat, glType))
+    return false;
+
+  GLuint textureId = 0;
+  _texture->getCustomAttribute("GLID", &textureId);
+  if (textureId == 0)
+    return false;
+
+  PixelReadbackFrame &frame = this->dataPtr->frames[
+      (this->dataPtr->first + this->dataPtr->pending) % count];
+  frame.size = Ogre::PixelUtil::getMemorySize(_texture->getWidth(),
+      _texture->getHeight(), 1, static_cast<Ogre::PixelFormat>(_format));
+  frame.time = _time;
+
+  // Keep the state cached by the render system
+  GLint previousBuffer, previousTexture, previousAlignment;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &previousAlignment);
+
+  if (!frame.buffer)
+    glGenBuffers(1, &frame.buffer);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, frame.buffer);
+  if (frame.capacity < frame.size)
+  {
+    glBufferData(GL_PIXEL_PACK_BUFFER, frame.size, nullptr, GL_STREAM_READ);
+    frame.capacity = frame.size;
+  }
+
+  // The copy goes to the pixel buffer, so this call returns without
+  // waiting for the frame to be rendered
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glBindTexture(GL_TEXTURE_2D, textureId);
+  glGetTexImage(GL_TEXTURE_2D, 0, glFormat, glType, nullptr);
+  frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  glBindTexture(GL_TEXTURE_2D, previousTexture);
+  glPixelStorei(GL_PACK_ALIGNMENT, previousAlignment);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, previousBuffer);
+
+  // Start the copy now rather than at the next frame
+  glFlush();
+
+  ++this->dataPtr->pending;
+  return true;
+#else
+  (void)_texture;
+  (void)_format;
+  (void)_time;
+  return false;
+#endif
+}
+
+/////////////////////////////////////////////////
+bool PixelReadback::Fetch(void *_data, const size_t _size,
+    common::Time &_time)
+{
+#ifdef GZ_PIXEL_READBACK_ASYNC
+  const unsigned int count = this->dataPtr->frames.size();
+  if (this->dataPtr->pending == 0)
+    return false;
+
+  PixelReadbackFrame &frame = this->dataPtr->frames[this->dataPtr->first];
+  GLsync fence = static_cast<GLsync>(frame.fence);
+
+  // Wait for the oldest frame only when no other frame can be queued
+  if (this->dataPtr->pending < count && fence &&
+      glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+  {
+    return false;
+  }
+
+  if (fence)
+  {
+    glDeleteSync(fence);
+    frame.fence = nullptr;
+  }
+
+  // The texture was resized since the frame was queued
+  bool result = frame.size == _size;
+  if (result)
+  {
+    GLint previousBuffer;
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, frame.buffer);
+    const void *pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    result = pixels != nullptr;
+    if (result)
+    {
+      std::memcpy(_data, pixels, frame.size);
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      _time = frame.time;
+    }
+    else
+      gzerr << "Unable to map pixel buffer, dropping frame\n";
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, previousBuffer);
+  }
+
+  this->dataPtr->first = (this->dataPtr->first + 1) % count;
+  --this->dataPtr->pending;
+  return result;
+#else
+  (void)_data;
+  (void)_size;
+  (void)_time;
+  return false;
+#endif
+}
+
+/////////////////////////////////////////////////
+void PixelReadback::Clear()
+{
+#ifdef GZ_PIXEL_READBACK_ASYNC
+  for (auto &frame : this->dataPtr->frames)
+  {
+    if (frame.fence)
+      glDeleteSync(static_cast<GLsync>(frame.fence));
+    frame.fence = nullptr;
+  }
+#endif
+  this->dataPtr->first = 0;
+  this->dataPtr->pending = 0;
+}
+
+/////////////////////////////////////////////////
+void PixelReadback::Release()
+{
+  this->Clear();
+
+#ifdef GZ_PIXEL_READBACK_ASYNC
+  for (auto &frame : this->dataPtr->frames)
+  {
+    if (frame.buffer)
+      glDeleteBuffers(1, &frame.buffer);
+  }
+#endif
+
+  const unsigned int count = this->dataPtr->frames.size();
+  this->dataPtr->frames.clear();
+  this->dataPtr->frames.resize(count);
+}
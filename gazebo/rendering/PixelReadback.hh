@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_PIXELREADBACK_HH_
+#define GAZEBO_RENDERING_PIXELREADBACK_HH_
+
+#include <memory>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/system.hh"
+
+namespace Ogre
+{
+  class Texture;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class PixelReadbackPrivate;
+
+    /// \cond
+    /// \brief Reads the pixels of a texture into memory without waiting for
+    /// the GPU. Each read is queued into one of a ring of OpenGL pixel
+    /// buffers, and the frames are fetched in order once the GPU has copied
+    /// them, at the latest when the ring is full. Each frame keeps the time
+    /// it was queued with, so that it can be stamped with the simulation
+    /// time it was rendered at.
+    ///
+    /// Only available with the OpenGL render system on Linux. Read()
+    /// returns false otherwise, and the caller should read the pixels
+    /// synchronously. All the functions must be called from the rendering
+    /// thread.
+    class GZ_RENDERING_VISIBLE PixelReadback
+    {
+      /// \brief Constructor.
+      public: PixelReadback();
+
+      /// \brief Destructor. The OpenGL objects are not released, Release()
+      /// must be called before from the rendering thread.
+      public: virtual ~PixelReadback();
+
+      /// \brief Whether pixels can be read asynchronously with the current
+      /// render system.
+      /// \return True if Read() can be used.
+      public: static bool Supported();
+
+      /// \brief Set the number of frames which can be read at the same
+      /// time. Frames being read are dropped.
+      /// \param[in] _count Number of pixel buffers, at least 2: 2 for
+      /// double buffering, 3 for triple buffering.
+      public: void SetBufferCount(const unsigned int _count);
+
+      /// \brief Get the number of frames which can be read at the same time.
+      /// \return Number of pixel buffers.
+      public: unsigned int BufferCount() const;
+
+      /// \brief Get the number of frames queued and not fetched yet.
+      /// \return Number of frames.
+      public: unsigned int Pending() const;
+
+      /// \brief Queue a read of the first mipmap of a texture.
+      /// \param[in] _texture Texture to read.
+      /// \param[in] _format Ogre::PixelFormat of the pixels in memory.
+      /// \param[in] _time Time of the frame, returned by Fetch().
+      /// \return False if the texture or the format can't be read
+      /// asynchronously, or if the ring is full.
+      public: bool Read(Ogre::Texture *_texture, const int _format,
+                  const common::Time &_time);
+
+      /// \brief Copy the oldest queued frame into memory, if the GPU has
+      /// copied it or if the ring is full. A frame of a different size,
+      /// queued before the texture was resized, is dropped.
+      /// \param[out] _data Memory to copy the pixels to.
+      /// \param[in] _size Size of _data in bytes.
+      /// \param[out] _time Time the frame was queued with.
+      /// \return True if a frame was copied.
+      public: bool Fetch(void *_data, const size_t _size, common::Time &_time);
+
+      /// \brief Drop the queued frames.
+      public: void Clear();
+
+      /// \brief Drop the queued frames and delete the OpenGL pixel buffers.
+      /// The buffer count is kept, and the buffers are created again by the
+      /// next reads.
+      public: void Release();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<PixelReadbackPrivate> dataPtr;
+    };
+    /// \endcond
+  }
+}
+#endif
@@ -88,6 +88,68 @@ using namespace rendering;
 
 uint32_t ScenePrivate::idCounter = 0;
 
+//////////////////////////////////////////////////
+void ScenePrivate::SetVisual(const uint32_t _id, VisualPtr _vis)
+{
+  this->visuals[_id] = _vis;
+
+  if (_id < kVisualTableSize)
+  {
+    if (_id >= this->visualTable.size())
+      this->visualTable.resize(_id + 1);
+    this->visualTable[_id].visual = _vis;
+    this->visualTable[_id].sequence = 0;
+  }
+}
+
+//////////////////////////////////////////////////
+void ScenePrivate::EraseVisual(const uint32_t _id)
+{
+  this->visuals.erase(_id);
+
+  if (_id < this->visualTable.size())
+    this->visualTable[_id] = VisualTableEntry();
+}
+
+//////////////////////////////////////////////////
+void ScenePrivate::ClearVisuals()
+{
+  this->visuals.clear();
+  this->visualTable.clear();
+}
+
+//////////////////////////////////////////////////
+void ScenePrivate::PushPoses(const common::Time &_time)
+{
+  const uint64_t sequence = ++this->poseSequence;
+
+  PoseBatch *batch = this->poseQueue.Back();
+  if (batch)
+  {
+    // The batch gets the memory of the poses, and the next poses are written
+    // in the memory of the batch
+    batch->poses.swap(this->producerPoses);
+    batch->time = _time;
+    batch->sequence = sequence;
+    this->poseQueue.Push();
+  }
+  else
+  {
+    // The rendering thread is behind, merge the poses with the pending ones
+    std::lock_guard<std::recursive_mutex> lock(this->poseMsgMutex);
+    for (const auto &pose : this->producerPoses)
+    {
+      PendingPose &pending = this->poseMsgs[pose.first];
+      pending.pose = pose.second;
+      pending.sequence = sequence;
+    }
+    this->sceneSimTimePosesReceived = _time;
+    this->poseTimeSequence = sequence;
+  }
+
+  this->producerPoses.clear();
+}
+
 struct VisualMessageLess {
     bool operator() (boost::shared_ptr<msgs::Visual const> _i,
                      boost::shared_ptr<msgs::Visual const> _j)
@@ -167,10 +229,12 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
 
   // When ready to use the direct API for updating scene poses from server,
   // uncomment the following line and delete the if and else directly above
+  // Clients use the compact pose stream, which only carries the ids and
+  // the poses which changed
   if (!_isServer)
   {
-    this->dataPtr->poseSub = this->dataPtr->node->Subscribe("~/pose/info",
-        &Scene::OnPoseMsg, this);
+    this->dataPtr->poseSub = this->dataPtr->node->Subscribe(
+        "~/pose/compact/info", &Scene::OnPoseCompactMsg, this);
   }
 
   this->dataPtr->jointSub =
@@ -250,6 +314,8 @@ void Scene::Clear()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
     this->dataPtr->poseMsgs.clear();
+    while (this->dataPtr->poseQueue.Front())
+      this->dataPtr->poseQueue.Pop();
   }
 
   this->dataPtr->joints.clear();
@@ -260,7 +326,7 @@ void Scene::Clear()
   while (!this->dataPtr->visuals.empty())
     this->RemoveVisual(this->dataPtr->visuals.begin()->first);
 
-  this->dataPtr->visuals.clear();
+  this->dataPtr->ClearVisuals();
 
   if (this->dataPtr->originVisual)
   {
@@ -360,7 +426,7 @@ void Scene::Init()
   this->dataPtr->worldVisual.reset(new Visual("__world_node__",
       shared_from_this()));
   this->dataPtr->worldVisual->SetId(0);
-  this->dataPtr->visuals[0] = this->dataPtr->worldVisual;
+  this->dataPtr->SetVisual(0, this->dataPtr->worldVisual);
 
   // RTShader system self-enables if the render path type is FORWARD,
   RTShaderSystem::Instance()->AddScene(shared_from_this());
@@ -1535,17 +1601,9 @@ bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
     for (int i = 0; i < _msg->model_size(); ++i)
     {
-      PoseMsgs_M::iterator iter =
-          this->dataPtr->poseMsgs.find(_msg->model(i).id());
-      if (iter != this->dataPtr->poseMsgs.end())
-        iter->second.CopyFrom(_msg->model(i).pose());
-      else
-        this->dataPtr->poseMsgs.insert(
-            std::make_pair(_msg->model(i).id(), _msg->model(i).pose()));
-
-      this->dataPtr->poseMsgs[_msg->model(i).id()].set_name(
-          _msg->model(i).name());
-      this->dataPtr->poseMsgs[_msg->model(i).id()].set_id(_msg->model(i).id());
+      PendingPose &pending = this->dataPtr->poseMsgs[_msg->model(i).id()];
+      pending.pose = msgs::ConvertIgn(_msg->model(i).pose());
+      pending.sequence = ++this->dataPtr->poseSequence;
 
       this->ProcessModelMsg(_msg->model(i));
     }
@@ -1629,9 +1687,6 @@ bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
 //////////////////////////////////////////////////
 bool Scene::ProcessModelMsg(const msgs::Model &_msg)
 {
-  std::string modelName, linkName;
-
-  modelName = _msg.name() + "::";
   for (int j = 0; j < _msg.visual_size(); ++j)
   {
     boost::shared_ptr<msgs::Visual> vm(new msgs::Visual(
@@ -1670,22 +1725,13 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
 
   for (int j = 0; j < _msg.link_size(); ++j)
   {
-    linkName = modelName + _msg.link(j).name();
-
     {
       std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
       if (_msg.link(j).has_pose())
       {
-        PoseMsgs_M::iterator iter =
-            this->dataPtr->poseMsgs.find(_msg.link(j).id());
-        if (iter != this->dataPtr->poseMsgs.end())
-          iter->second.CopyFrom(_msg.link(j).pose());
-        else
-          this->dataPtr->poseMsgs.insert(
-              std::make_pair(_msg.link(j).id(), _msg.link(j).pose()));
-
-        this->dataPtr->poseMsgs[_msg.link(j).id()].set_name(linkName);
-        this->dataPtr->poseMsgs[_msg.link(j).id()].set_id(_msg.link(j).id());
+        PendingPose &pending = this->dataPtr->poseMsgs[_msg.link(j).id()];
+        pending.pose = msgs::ConvertIgn(_msg.link(j).pose());
+        pending.sequence = ++this->dataPtr->poseSequence;
       }
     }
 
@@ -1830,64 +1876,24 @@ void Scene::PreRender()
   LinkMsgs_L linkMsgsCopy;
   RoadMsgs_L roadMsgsCopy;
 
+  // Take the messages received since the last frame. Swapping the lists
+  // doesn't copy the messages.
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
 
-    std::copy(this->dataPtr->sceneMsgs.begin(), this->dataPtr->sceneMsgs.end(),
-              std::back_inserter(sceneMsgsCopy));
-    this->dataPtr->sceneMsgs.clear();
-
-    std::copy(this->dataPtr->modelMsgs.begin(), this->dataPtr->modelMsgs.end(),
-              std::back_inserter(modelMsgsCopy));
-    this->dataPtr->modelMsgs.clear();
-
-    std::copy(this->dataPtr->sensorMsgs.begin(),
-              this->dataPtr->sensorMsgs.end(),
-              std::back_inserter(sensorMsgsCopy));
-    this->dataPtr->sensorMsgs.clear();
-
-    std::copy(this->dataPtr->lightFactoryMsgs.begin(),
-              this->dataPtr->lightFactoryMsgs.end(),
-              std::back_inserter(lightFactoryMsgsCopy));
-    this->dataPtr->lightFactoryMsgs.clear();
-
-    std::copy(this->dataPtr->lightModifyMsgs.begin(),
-              this->dataPtr->lightModifyMsgs.end(),
-              std::back_inserter(lightModifyMsgsCopy));
-    this->dataPtr->lightModifyMsgs.clear();
-
-    std::copy(this->dataPtr->modelVisualMsgs.begin(),
-              this->dataPtr->modelVisualMsgs.end(),
-              std::back_inserter(modelVisualMsgsCopy));
-    this->dataPtr->modelVisualMsgs.clear();
-
-    std::copy(this->dataPtr->linkVisualMsgs.begin(),
-              this->dataPtr->linkVisualMsgs.end(),
-              std::back_inserter(linkVisualMsgsCopy));
-    this->dataPtr->linkVisualMsgs.clear();
-
+    sceneMsgsCopy.swap(this->dataPtr->sceneMsgs);
+    modelMsgsCopy.swap(this->dataPtr->modelMsgs);
+    sensorMsgsCopy.swap(this->dataPtr->sensorMsgs);
+    lightFactoryMsgsCopy.swap(this->dataPtr->lightFactoryMsgs);
+    lightModifyMsgsCopy.swap(this->dataPtr->lightModifyMsgs);
+    modelVisualMsgsCopy.swap(this->dataPtr->modelVisualMsgs);
+    linkVisualMsgsCopy.swap(this->dataPtr->linkVisualMsgs);
     this->dataPtr->visualMsgs.sort(VisualMessageLessOp);
-    std::copy(this->dataPtr->visualMsgs.begin(),
-              this->dataPtr->visualMsgs.end(),
-              std::back_inserter(visualMsgsCopy));
-    this->dataPtr->visualMsgs.clear();
-
-    std::copy(this->dataPtr->collisionVisualMsgs.begin(),
-              this->dataPtr->collisionVisualMsgs.end(),
-              std::back_inserter(collisionVisualMsgsCopy));
-    this->dataPtr->collisionVisualMsgs.clear();
-
-    std::copy(this->dataPtr->jointMsgs.begin(), this->dataPtr->jointMsgs.end(),
-              std::back_inserter(jointMsgsCopy));
-    this->dataPtr->jointMsgs.clear();
-
-    std::copy(this->dataPtr->linkMsgs.begin(), this->dataPtr->linkMsgs.end(),
-              std::back_inserter(linkMsgsCopy));
-    this->dataPtr->linkMsgs.clear();
-
-    std::copy(this->dataPtr->roadMsgs.begin(), this->dataPtr->roadMsgs.end(),
-              std::back_inserter(roadMsgsCopy));
-    this->dataPtr->roadMsgs.clear();
+    visualMsgsCopy.swap(this->dataPtr->visualMsgs);
+    collisionVisualMsgsCopy.swap(this->dataPtr->collisionVisualMsgs);
+    jointMsgsCopy.swap(this->dataPtr->jointMsgs);
+    linkMsgsCopy.swap(this->dataPtr->linkMsgs);
+    roadMsgsCopy.swap(this->dataPtr->roadMsgs);
   }
 
   // Process the scene messages. DO THIS FIRST
@@ -2012,41 +2018,39 @@ void Scene::PreRender()
   }
   this->dataPtr->requestMsgs.clear();
 
+  // Put back the messages which couldn't be processed yet, before the
+  // messages received in the meantime.
+  if (!sceneMsgsCopy.empty() || !modelMsgsCopy.empty() ||
+      !sensorMsgsCopy.empty() || !lightFactoryMsgsCopy.empty() ||
+      !lightModifyMsgsCopy.empty() || !modelVisualMsgsCopy.empty() ||
+      !linkVisualMsgsCopy.empty() || !visualMsgsCopy.empty() ||
+      !collisionVisualMsgsCopy.empty() || !jointMsgsCopy.empty() ||
+      !linkMsgsCopy.empty())
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
 
-    std::copy(sceneMsgsCopy.begin(), sceneMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sceneMsgs));
-
-    std::copy(modelMsgsCopy.begin(), modelMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelMsgs));
-
-    std::copy(sensorMsgsCopy.begin(), sensorMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sensorMsgs));
-
-    std::copy(lightFactoryMsgsCopy.begin(), lightFactoryMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightFactoryMsgs));
-
-    std::copy(lightModifyMsgsCopy.begin(), lightModifyMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightModifyMsgs));
-
-    std::copy(modelVisualMsgsCopy.begin(), modelVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelVisualMsgs));
-
-    std::copy(linkVisualMsgsCopy.begin(), linkVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkVisualMsgs));
-
-    std::copy(visualMsgsCopy.begin(), visualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->visualMsgs));
-
-    std::copy(collisionVisualMsgsCopy.begin(), collisionVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->collisionVisualMsgs));
-
-    std::copy(jointMsgsCopy.begin(), jointMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->jointMsgs));
-
-    std::copy(linkMsgsCopy.begin(), linkMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkMsgs));
+    this->dataPtr->sceneMsgs.splice(this->dataPtr->sceneMsgs.begin(),
+        sceneMsgsCopy);
+    this->dataPtr->modelMsgs.splice(this->dataPtr->modelMsgs.begin(),
+        modelMsgsCopy);
+    this->dataPtr->sensorMsgs.splice(this->dataPtr->sensorMsgs.begin(),
+        sensorMsgsCopy);
+    this->dataPtr->lightFactoryMsgs.splice(
+        this->dataPtr->lightFactoryMsgs.begin(), lightFactoryMsgsCopy);
+    this->dataPtr->lightModifyMsgs.splice(
+        this->dataPtr->lightModifyMsgs.begin(), lightModifyMsgsCopy);
+    this->dataPtr->modelVisualMsgs.splice(
+        this->dataPtr->modelVisualMsgs.begin(), modelVisualMsgsCopy);
+    this->dataPtr->linkVisualMsgs.splice(
+        this->dataPtr->linkVisualMsgs.begin(), linkVisualMsgsCopy);
+    this->dataPtr->visualMsgs.splice(this->dataPtr->visualMsgs.begin(),
+        visualMsgsCopy);
+    this->dataPtr->collisionVisualMsgs.splice(
+        this->dataPtr->collisionVisualMsgs.begin(), collisionVisualMsgsCopy);
+    this->dataPtr->jointMsgs.splice(this->dataPtr->jointMsgs.begin(),
+        jointMsgsCopy);
+    this->dataPtr->linkMsgs.splice(this->dataPtr->linkMsgs.begin(),
+        linkMsgsCopy);
   }
 
   // update the rt shader
@@ -2055,45 +2059,94 @@ void Scene::PreRender()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
 
-    // Process all the model messages last. Remove pose message from the list
-    // only when a corresponding visual exits. We may receive pose updates
-    // over the wire before  we recieve the visual
-    pIter = this->dataPtr->poseMsgs.begin();
-    while (pIter != this->dataPtr->poseMsgs.end())
+    // Apply a pose to a visual or a light. Returns false if the pose must
+    // be applied later.
+    auto applyPose = [this](const uint32_t _id,
+        const ignition::math::Pose3d &_pose, const uint64_t _sequence)
     {
-      Visual_M::iterator iter = this->dataPtr->visuals.find(pIter->first);
-      if (iter != this->dataPtr->visuals.end() && iter->second)
+      VisualTableEntry *entry = nullptr;
+      Visual *vis = nullptr;
+      if (_id < this->dataPtr->visualTable.size())
+      {
+        entry = &this->dataPtr->visualTable[_id];
+        vis = entry->visual.get();
+      }
+      else if (_id >= ScenePrivate::kVisualTableSize)
       {
+        auto iter = this->dataPtr->visuals.find(_id);
+        if (iter != this->dataPtr->visuals.end())
+          vis = iter->second.get();
+      }
+
+      if (vis)
+      {
+        // A more recent pose was already applied
+        if (entry && _sequence < entry->sequence)
+          return true;
+
         // If an object is selected, don't let the physics engine move it.
-        if (!this->dataPtr->selectedVis
-            || this->dataPtr->selectionMode != "move" ||
-            (iter->first != this->dataPtr->selectedVis->GetId() &&
-            !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
+        if (this->dataPtr->selectedVis &&
+            this->dataPtr->selectionMode == "move" &&
+            (_id == this->dataPtr->selectedVis->GetId() ||
+             this->dataPtr->selectedVis->IsAncestorOf(
+               vis->shared_from_this())))
         {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          GZ_ASSERT(iter->second, "Visual pointer is NULL");
-          iter->second->SetPose(pose);
-          PoseMsgs_M::iterator prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
+          return false;
         }
-        else
-          ++pIter;
+
+        vis->SetPose(_pose);
+        if (entry)
+          entry->sequence = _sequence;
+        return true;
       }
-      else
+
+      // process light poses
+      auto lIter = this->dataPtr->lights.find(_id);
+      if (lIter != this->dataPtr->lights.end())
       {
-        // process light pose messages
-        auto lIter = this->dataPtr->lights.find(pIter->first);
-        if (lIter != this->dataPtr->lights.end())
+        lIter->second->SetPosition(_pose.Pos());
+        lIter->second->SetRotation(_pose.Rot());
+        return true;
+      }
+
+      return false;
+    };
+
+    // Apply the poses received since the last frame, in order. The poses
+    // which can't be applied yet are kept with the pending poses.
+    while (PoseBatch *batch = this->dataPtr->poseQueue.Front())
+    {
+      for (const auto &pose : batch->poses)
+      {
+        if (!applyPose(pose.first, pose.second, batch->sequence))
         {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          lIter->second->SetPosition(pose.Pos());
-          lIter->second->SetRotation(pose.Rot());
-          auto prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
+          PendingPose &pending = this->dataPtr->poseMsgs[pose.first];
+          if (batch->sequence >= pending.sequence)
+          {
+            pending.pose = pose.second;
+            pending.sequence = batch->sequence;
+          }
         }
-        else
-          ++pIter;
       }
+
+      if (batch->sequence > this->dataPtr->poseTimeSequence)
+      {
+        this->dataPtr->sceneSimTimePosesReceived = batch->time;
+        this->dataPtr->poseTimeSequence = batch->sequence;
+      }
+      this->dataPtr->poseQueue.Pop();
+    }
+
+    // Process the pending poses. Remove a pose from the list only when a
+    // corresponding visual exists. We may receive pose updates over the
+    // wire before we receive the visual
+    pIter = this->dataPtr->poseMsgs.begin();
+    while (pIter != this->dataPtr->poseMsgs.end())
+    {
+      if (applyPose(pIter->first, pIter->second.pose, pIter->second.sequence))
+        this->dataPtr->poseMsgs.erase(pIter++);
+      else
+        ++pIter;
     }
 
     // process skeleton pose msgs
@@ -2151,7 +2204,7 @@ void Scene::PreRender()
       {
         Road2dPtr road(new Road2d(msg->name(), this->dataPtr->worldVisual));
         road->Load(*msg);
-        this->dataPtr->visuals[road->GetId()] = road;
+        this->dataPtr->SetVisual(road->GetId(), road);
       }
     }
 
@@ -2189,7 +2242,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
             rayVisualName+"_GUIONLY_laser_vis", parentVis, _msg->topic()));
       laserVis->Load();
       laserVis->SetId(_msg->id());
-      this->dataPtr->visuals[_msg->id()] = laserVis;
+      this->dataPtr->SetVisual(_msg->id(), laserVis);
     }
   }
   else if ((_msg->type() == "sonar") && _msg->visualize()
@@ -2206,7 +2259,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
             sonarVisualName+"_GUIONLY_sonar_vis", parentVis, _msg->topic()));
       sonarVis->Load();
       sonarVis->SetId(_msg->id());
-      this->dataPtr->visuals[_msg->id()] = sonarVis;
+      this->dataPtr->SetVisual(_msg->id(), sonarVis);
     }
   }
   else if ((_msg->type() == "force_torque") && _msg->visualize()
@@ -2236,7 +2289,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
             _msg->topic()));
       wrenchVis->Load(jointMsg);
       wrenchVis->SetId(_msg->id());
-      this->dataPtr->visuals[_msg->id()] = wrenchVis;
+      this->dataPtr->SetVisual(_msg->id(), wrenchVis);
     }
   }
   else if (_msg->type() == "camera" && _msg->visualize())
@@ -2262,7 +2315,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
         cameraVis->SetPose(msgs::ConvertIgn(_msg->pose()));
         cameraVis->SetId(_msg->id());
         cameraVis->Load(_msg->camera());
-        this->dataPtr->visuals[cameraVis->GetId()] = cameraVis;
+        this->dataPtr->SetVisual(cameraVis->GetId(), cameraVis);
       }
     }
   }
@@ -2285,7 +2338,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
       cameraVis->SetPose(msgs::ConvertIgn(_msg->pose()));
       cameraVis->SetId(_msg->id());
       cameraVis->Load(_msg->logical_camera());
-      this->dataPtr->visuals[cameraVis->GetId()] = cameraVis;
+      this->dataPtr->SetVisual(cameraVis->GetId(), cameraVis);
     }
     else if (_msg->has_pose())
     {
@@ -2301,7 +2354,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
     contactVis->SetId(_msg->id());
 
     this->dataPtr->contactVisId = _msg->id();
-    this->dataPtr->visuals[contactVis->GetId()] = contactVis;
+    this->dataPtr->SetVisual(contactVis->GetId(), contactVis);
   }
   else if (_msg->type() == "rfidtag" && _msg->visualize() &&
            !_msg->topic().empty())
@@ -2314,7 +2367,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
           _msg->name() + "_GUIONLY_rfidtag_vis", parentVis, _msg->topic()));
     rfidVis->SetId(_msg->id());
 
-    this->dataPtr->visuals[rfidVis->GetId()] = rfidVis;
+    this->dataPtr->SetVisual(rfidVis->GetId(), rfidVis);
   }
   else if (_msg->type() == "rfid" && _msg->visualize() &&
            !_msg->topic().empty())
@@ -2326,7 +2379,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
     RFIDVisualPtr rfidVis(new RFIDVisual(
           _msg->name() + "_GUIONLY_rfid_vis", parentVis, _msg->topic()));
     rfidVis->SetId(_msg->id());
-    this->dataPtr->visuals[rfidVis->GetId()] = rfidVis;
+    this->dataPtr->SetVisual(rfidVis->GetId(), rfidVis);
   }
   else if (_msg->type() == "wireless_transmitter" && _msg->visualize() &&
            !_msg->topic().empty())
@@ -2337,7 +2390,7 @@ bool Scene::ProcessSensorMsg(ConstSensorPtr &_msg)
 
     VisualPtr transmitterVis(new TransmitterVisual(
           _msg->name() + "_GUIONLY_transmitter_vis", parentVis, _msg->topic()));
-    this->dataPtr->visuals[transmitterVis->GetId()] = transmitterVis;
+    this->dataPtr->SetVisual(transmitterVis->GetId(), transmitterVis);
     transmitterVis->Load();
   }
 
@@ -2725,7 +2778,7 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
   {
     if (iter != this->dataPtr->visuals.end())
     {
-      this->dataPtr->visuals.erase(iter);
+      this->dataPtr->EraseVisual(iter->first);
       return true;
     }
     else
@@ -2841,7 +2894,7 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
   visual->LoadFromMsg(_msg);
   visual->SetType(_type);
 
-  this->dataPtr->visuals[visual->GetId()] = visual;
+  this->dataPtr->SetVisual(visual->GetId(), visual);
   if (visual->Name().find("__SKELETON_VISUAL__") != std::string::npos)
   {
     visual->SetVisible(false);
@@ -2865,20 +2918,34 @@ common::Time Scene::SimTime() const
 /////////////////////////////////////////////////
 void Scene::OnPoseMsg(ConstPosesStampedPtr &_msg)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
-  this->dataPtr->sceneSimTimePosesReceived =
-    common::Time(_msg->time().sec(), _msg->time().nsec());
+  std::lock_guard<std::mutex> lock(this->dataPtr->poseProducerMutex);
 
+  auto &poses = this->dataPtr->producerPoses;
   for (int i = 0; i < _msg->pose_size(); ++i)
   {
-    auto p = _msg->pose(i);
-    PoseMsgs_M::iterator iter =
-        this->dataPtr->poseMsgs.find(p.id());
-    if (iter != this->dataPtr->poseMsgs.end())
-      iter->second.CopyFrom(p);
-    else
-      this->dataPtr->poseMsgs.insert(std::make_pair(p.id(), p));
+    const msgs::Pose &p = _msg->pose(i);
+    poses.emplace_back(p.id(), msgs::ConvertIgn(p));
   }
+
+  this->dataPtr->PushPoses(msgs::Convert(_msg->time()));
+}
+
+/////////////////////////////////////////////////
+void Scene::OnPoseCompactMsg(ConstPosesCompactPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->poseProducerMutex);
+
+  auto &poses = this->dataPtr->producerPoses;
+  bool decoded = this->dataPtr->poseDecoder.Decode(*_msg,
+      [&poses](const uint32_t _id, const ignition::math::Pose3d &_pose)
+      {
+        poses.emplace_back(_id, _pose);
+      });
+
+  if (decoded)
+    this->dataPtr->PushPoses(msgs::Convert(_msg->time()));
+  else
+    poses.clear();
 }
 
 /////////////////////////////////////////////////
@@ -3292,7 +3359,7 @@ void Scene::AddVisual(VisualPtr _vis)
     gzwarn << "Duplicate visuals detected[" << _vis->Name() << "]\n";
   }
 
-  this->dataPtr->visuals[_vis->GetId()] = _vis;
+  this->dataPtr->SetVisual(_vis->GetId(), _vis);
 }
 
 /////////////////////////////////////////////////
@@ -3318,7 +3385,7 @@ void Scene::RemoveVisual(uint32_t _id)
       else
         ++piter;
     }
-    this->dataPtr->visuals.erase(iter);
+    this->dataPtr->EraseVisual(_id);
 
     this->RemoveVisualizations(vis);
     vis->Fini();
@@ -3344,8 +3411,8 @@ void Scene::SetVisualId(VisualPtr _vis, uint32_t _id)
   auto iter = this->dataPtr->visuals.find(_vis->GetId());
   if (iter != this->dataPtr->visuals.end())
   {
-    this->dataPtr->visuals.erase(_vis->GetId());
-    this->dataPtr->visuals[_id] = _vis;
+    this->dataPtr->EraseVisual(_vis->GetId());
+    this->dataPtr->SetVisual(_id, _vis);
     _vis->SetId(_id);
   }
 }
@@ -3452,7 +3519,7 @@ void Scene::CreateCOMVisual(ConstLinkPtr &_msg, VisualPtr _linkVisual)
                                     _linkVisual));
   comVis->Load(_msg);
   comVis->SetVisible(this->dataPtr->showCOMs);
-  this->dataPtr->visuals[comVis->GetId()] = comVis;
+  this->dataPtr->SetVisual(comVis->GetId(), comVis);
 }
 
 /////////////////////////////////////////////////
@@ -3462,7 +3529,7 @@ void Scene::CreateCOMVisual(sdf::ElementPtr _elem, VisualPtr _linkVisual)
                                     _linkVisual));
   comVis->Load(_elem);
   comVis->SetVisible(false);
-  this->dataPtr->visuals[comVis->GetId()] = comVis;
+  this->dataPtr->SetVisual(comVis->GetId(), comVis);
 }
 
 /////////////////////////////////////////////////
@@ -3472,7 +3539,7 @@ void Scene::CreateInertiaVisual(ConstLinkPtr &_msg, VisualPtr _linkVisual)
       "_INERTIA_VISUAL__", _linkVisual));
   inertiaVis->Load(_msg);
   inertiaVis->SetVisible(this->dataPtr->showInertias);
-  this->dataPtr->visuals[inertiaVis->GetId()] = inertiaVis;
+  this->dataPtr->SetVisual(inertiaVis->GetId(), inertiaVis);
 }
 
 /////////////////////////////////////////////////
@@ -3482,7 +3549,7 @@ void Scene::CreateInertiaVisual(sdf::ElementPtr _elem, VisualPtr _linkVisual)
       "_INERTIA_VISUAL__", _linkVisual));
   inertiaVis->Load(_elem);
   inertiaVis->SetVisible(false);
-  this->dataPtr->visuals[inertiaVis->GetId()] = inertiaVis;
+  this->dataPtr->SetVisual(inertiaVis->GetId(), inertiaVis);
 }
 
 /////////////////////////////////////////////////
@@ -3492,7 +3559,7 @@ void Scene::CreateLinkFrameVisual(ConstLinkPtr &/*_msg*/, VisualPtr _linkVisual)
       "_LINK_FRAME_VISUAL__", _linkVisual));
   linkFrameVis->Load();
   linkFrameVis->SetVisible(this->dataPtr->showLinkFrames);
-  this->dataPtr->visuals[linkFrameVis->GetId()] = linkFrameVis;
+  this->dataPtr->SetVisual(linkFrameVis->GetId(), linkFrameVis);
 }
 
 /////////////////////////////////////////////////
@@ -3612,7 +3679,7 @@ void Scene::ShowContacts(const bool _show)
               this->dataPtr->worldVisual, "~/physics/contacts"));
     vis->SetEnabled(_show);
     this->dataPtr->contactVisId = vis->GetId();
-    this->dataPtr->visuals[this->dataPtr->contactVisId] = vis;
+    this->dataPtr->SetVisual(this->dataPtr->contactVisId, vis);
   }
   else
     vis = std::dynamic_pointer_cast<ContactVisual>(
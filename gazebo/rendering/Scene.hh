@@ -730,6 +730,10 @@ namespace gazebo
       /// \param[in] _msg The message data.
       private: void OnPoseMsg(ConstPosesStampedPtr &_msg);
 
+      /// \brief Compact pose message callback.
+      /// \param[in] _msg The message data.
+      private: void OnPoseCompactMsg(ConstPosesCompactPtr &_msg);
+
       /// \brief Skeleton animation callback.
       /// \param[in] _msg The message data.
       private: void OnSkeletonPoseMsg(ConstPoseAnimationPtr &_msg);
@@ -17,20 +17,28 @@
 #ifndef GAZEBO_RENDERING_SCENE_PRIVATE_HH_
 #define GAZEBO_RENDERING_SCENE_PRIVATE_HH_
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
 
 #include <boost/unordered/unordered_map.hpp>
 
+#include <ignition/math/Pose3.hh>
 #include <sdf/sdf.hh>
 
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/gazebo_config.h"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/msgs/PoseStream.hh"
 #include "gazebo/rendering/MarkerManager.hh"
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -68,9 +76,96 @@ namespace gazebo
     /// \brief List of light messages.
     typedef std::list<boost::shared_ptr<msgs::Light const> > LightMsgs_L;
 
+    /// \brief Pose of a visual waiting to be applied.
+    class PendingPose
+    {
+      /// \brief The pose.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Sequence number of the pose, see
+      /// ScenePrivate::poseSequence.
+      public: uint64_t sequence = 0;
+    };
+
     /// \typedef PoseMsgs_M.
-    /// \brief List of messages.
-    typedef std::map<uint32_t, msgs::Pose> PoseMsgs_M;
+    /// \brief Map of pending poses, by visual id.
+    typedef std::map<uint32_t, PendingPose> PoseMsgs_M;
+
+    /// \brief Entry of the table of visuals indexed by id.
+    class VisualTableEntry
+    {
+      /// \brief The visual, null if there's no visual with this id.
+      public: VisualPtr visual;
+
+      /// \brief Sequence number of the last pose applied to the visual.
+      public: uint64_t sequence = 0;
+    };
+
+    /// \brief Poses received in one message.
+    class PoseBatch
+    {
+      /// \brief Visual ids and poses.
+      public: std::vector<std::pair<uint32_t, ignition::math::Pose3d>> poses;
+
+      /// \brief Sim time of the poses.
+      public: common::Time time;
+
+      /// \brief Sequence number of the poses.
+      public: uint64_t sequence = 0;
+    };
+
+    /// \brief Lock free queue of pose batches, with a single producer (the
+    /// thread receiving the poses) and a single consumer (the rendering
+    /// thread). The slots are reused so that their poses keep their memory.
+    class PoseBatchQueue
+    {
+      /// \brief Number of slots.
+      public: static const std::size_t kCapacity = 64;
+
+      /// \brief Get the slot to fill. Producer only.
+      /// \return The slot, null if the queue is full.
+      public: PoseBatch *Back()
+      {
+        const std::size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - this->head.load(std::memory_order_acquire) >= kCapacity)
+          return nullptr;
+        return &this->slots[tail % kCapacity];
+      }
+
+      /// \brief Make the slot returned by Back available to the consumer.
+      /// Producer only.
+      public: void Push()
+      {
+        this->tail.store(this->tail.load(std::memory_order_relaxed) + 1,
+            std::memory_order_release);
+      }
+
+      /// \brief Get the oldest batch. Consumer only.
+      /// \return The batch, null if the queue is empty.
+      public: PoseBatch *Front()
+      {
+        const std::size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == this->tail.load(std::memory_order_acquire))
+          return nullptr;
+        return &this->slots[head % kCapacity];
+      }
+
+      /// \brief Release the batch returned by Front. Consumer only.
+      public: void Pop()
+      {
+        this->head.store(this->head.load(std::memory_order_relaxed) + 1,
+            std::memory_order_release);
+      }
+
+      /// \brief The slots.
+      private: std::array<PoseBatch, kCapacity> slots;
+
+      /// \brief Index of the next batch to read.
+      private: std::atomic<std::size_t> head{0};
+
+      /// \brief Index of the next batch to write.
+      private: std::atomic<std::size_t> tail{0};
+    };
 
     /// \typedef LightPoseMsgs_M.
     /// \brief List of messages.
@@ -121,6 +216,23 @@ namespace gazebo
     /// \brief Private data for the Visual class
     class ScenePrivate
     {
+      /// \brief Add a visual, or replace the visual with the same id.
+      /// \param[in] _id Id of the visual.
+      /// \param[in] _vis The visual.
+      public: void SetVisual(const uint32_t _id, VisualPtr _vis);
+
+      /// \brief Remove a visual from the maps of visuals.
+      /// \param[in] _id Id of the visual.
+      public: void EraseVisual(const uint32_t _id);
+
+      /// \brief Remove all the visuals from the maps of visuals.
+      public: void ClearVisuals();
+
+      /// \brief Queue the poses in producerPoses for the rendering thread.
+      /// poseProducerMutex must be locked.
+      /// \param[in] _time Sim time of the poses.
+      public: void PushPoses(const common::Time &_time);
+
 /*      public: enum SkyXMode {
         GZ_SKYX_ALL = 0x0FFFFFFF,
         GZ_SKYX_CLOUDS = 0x0000001,
@@ -181,9 +293,28 @@ namespace gazebo
       /// \brief List of light modify message to process.
       public: LightMsgs_L lightModifyMsgs;
 
-      /// \brief List of pose message to process.
+      /// \brief Poses which couldn't be applied yet, because their visual
+      /// doesn't exist yet or is being moved by the user, or because
+      /// poseQueue was full.
       public: PoseMsgs_M poseMsgs;
 
+      /// \brief Poses received from the transport thread.
+      public: PoseBatchQueue poseQueue;
+
+      /// \brief Poses being received, swapped with a slot of poseQueue.
+      public: std::vector<std::pair<uint32_t, ignition::math::Pose3d>>
+          producerPoses;
+
+      /// \brief Serializes the producers of poseQueue.
+      public: std::mutex poseProducerMutex;
+
+      /// \brief Counter of the received poses, used to apply the poses in
+      /// the order they were received, whichever way they took.
+      public: std::atomic<uint64_t> poseSequence{0};
+
+      /// \brief Sequence number of sceneSimTimePosesReceived.
+      public: uint64_t poseTimeSequence = 0;
+
       /// \brief List of pose message to process.
       public: LightPoseMsgs_M lightPoseMsgs;
 
@@ -205,9 +336,20 @@ namespace gazebo
       /// \brief List of request message to process.
       public: RequestMsgs_L requestMsgs;
 
-      /// \brief Map of all the visuals in this scene.
+      /// \brief Map of all the visuals in this scene. Use SetVisual and
+      /// EraseVisual to modify it.
       public: Visual_M visuals;
 
+      /// \brief Visuals indexed by id, for the ids lower than
+      /// kVisualTableSize. Physics entities have small ids, which makes the
+      /// lookup of the visuals of the received poses constant time.
+      public: std::vector<VisualTableEntry> visualTable;
+
+      /// \brief Ids from this value are only stored in the visuals map.
+      /// Visuals created by the rendering library count down from
+      /// MAX_UI32.
+      public: static const uint32_t kVisualTableSize = 1u << 20;
+
       /// \brief Map of all the lights in this scene.
       public: Light_M lights;
 
@@ -256,6 +398,9 @@ namespace gazebo
       /// \brief Subscribe to pose updates
       public: transport::SubscriberPtr poseSub;
 
+      /// \brief Decoder of the compact pose messages.
+      public: msgs::PoseStreamDecoder poseDecoder;
+
       /// \brief Subscribe to joint updates.
       public: transport::SubscriberPtr jointSub;
 
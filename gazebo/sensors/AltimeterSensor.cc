@@ -116,6 +116,13 @@ void AltimeterSensor::Fini()
   this->dataPtr->parentLink.reset();
 }
 
+//////////////////////////////////////////////////
+bool AltimeterSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->altPub && this->dataPtr->altPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void AltimeterSensor::Init()
 {
@@ -15,6 +15,7 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <cmath>
 #include <functional>
 #include <ignition/common/Profiler.hh>
 #include <ignition/msgs/Utility.hh>
@@ -26,6 +27,7 @@
 
 #include "gazebo/msgs/msgs.hh"
 
+#include "gazebo/physics/Entity.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/World.hh"
 
@@ -36,6 +38,7 @@
 
 #include "gazebo/transport/transport.hh"
 
+#include "gazebo/sensors/CpuCamera.hh"
 #include "gazebo/sensors/Noise.hh"
 #include "gazebo/sensors/SensorFactory.hh"
 
@@ -122,7 +125,15 @@ void CameraSensor::Init()
   if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
       rendering::RenderEngine::NONE)
   {
-    gzerr << "Unable to create CameraSensor. Rendering is disabled.\n";
+    if (!this->InitFallbackCamera())
+    {
+      gzerr << "Unable to create CameraSensor. Rendering is disabled.\n";
+      return;
+    }
+
+    gzmsg << "Rendering is disabled, camera sensor[" << this->ScopedName()
+      << "] renders on the CPU\n";
+    Sensor::Init();
     return;
   }
 
@@ -196,6 +207,7 @@ void CameraSensor::Init()
 void CameraSensor::Fini()
 {
   this->imagePub.reset();
+  this->dataPtr->cpuCamera.reset();
 
   if (this->camera)
   {
@@ -292,6 +304,15 @@ void CameraSensor::PrerenderEnded()
       dt = this->updatePeriod.Double();
     this->dataPtr->nextRenderingTime += dt;
 
+    // Skip the periods missed while the sensor didn't render, e.g. while
+    // it was inactive, instead of catching up with a frame per prerender
+    const double simTime = this->scene->SimTime().Double();
+    if (this->dataPtr->nextRenderingTime < simTime)
+    {
+      this->dataPtr->nextRenderingTime += dt * std::ceil(
+          (simTime - this->dataPtr->nextRenderingTime) / dt);
+    }
+
     this->dataPtr->renderNeeded = true;
     this->lastMeasurementTime = this->scene->SimTime();
   }
@@ -329,6 +350,20 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
 {
   IGN_PROFILE("CameraSensor::UpdateImpl");
 
+  if (this->dataPtr->cpuCamera)
+  {
+    IGN_PROFILE_BEGIN("RenderFallbackCamera");
+    this->RenderFallbackCamera();
+    IGN_PROFILE_END();
+
+    this->PublishImage(this->dataPtr->cpuCamera->ImageData(),
+        this->dataPtr->cpuCamera->ImageWidth(),
+        this->dataPtr->cpuCamera->ImageHeight(),
+        this->dataPtr->cpuCamera->ImageDepth(),
+        this->dataPtr->cpuCamera->ImageFormat(), this->lastMeasurementTime);
+    return true;
+  }
+
   if (!this->dataPtr->rendered)
     return false;
 
@@ -338,47 +373,13 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
 
   IGN_PROFILE_BEGIN("fillarray");
 
-  if ((this->imagePub && this->imagePub->HasConnections()) ||
-      this->imagePubIgn.HasConnections())
+  // Frames read asynchronously are delivered a few renders later, stamped
+  // with the time they were rendered at
+  if (this->camera->FrameReady())
   {
-    auto simTime = this->scene->SimTime();
-    if (this->imagePub && this->imagePub->HasConnections())
-    {
-      msgs::ImageStamped msg;
-      msgs::Set(msg.mutable_time(), simTime);
-      msg.mutable_image()->set_width(this->camera->ImageWidth());
-      msg.mutable_image()->set_height(this->camera->ImageHeight());
-      msg.mutable_image()->set_pixel_format(common::Image::ConvertPixelFormat(
-            this->camera->ImageFormat()));
-
-      msg.mutable_image()->set_step(this->camera->ImageWidth() *
-          this->camera->ImageDepth());
-      msg.mutable_image()->set_data(this->camera->ImageData(),
-          msg.image().width() * this->camera->ImageDepth() *
-          msg.image().height());
-
-      this->imagePub->Publish(msg);
-    }
-
-    if (this->imagePubIgn.HasConnections())
-    {
-      ignition::msgs::Image msg;
-      msg.mutable_header()->mutable_stamp()->set_sec(simTime.sec);
-      msg.mutable_header()->mutable_stamp()->set_nsec(simTime.nsec);
-
-      msg.set_width(this->camera->ImageWidth());
-      msg.set_height(this->camera->ImageHeight());
-      msg.set_pixel_format_type(ignition::msgs::ConvertPixelFormatType(
-            this->camera->ImageFormat()));
-
-      msg.set_step(this->camera->ImageWidth() *
-          this->camera->ImageDepth());
-      msg.set_data(this->camera->ImageData(),
-          msg.width() * this->camera->ImageDepth() *
-          msg.height());
-
-      this->imagePubIgn.Publish(msg);
-    }
+    this->PublishImage(this->camera->ImageData(), this->camera->ImageWidth(),
+        this->camera->ImageHeight(), this->camera->ImageDepth(),
+        this->camera->ImageFormat(), this->camera->FrameSimTime());
   }
 
   this->dataPtr->rendered = false;
@@ -386,12 +387,125 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
   return true;
 }
 
+//////////////////////////////////////////////////
+void CameraSensor::PublishImage(const unsigned char *_data,
+    const unsigned int _width, const unsigned int _height,
+    const unsigned int _depth, const std::string &_format,
+    const common::Time &_time)
+{
+  if (this->imagePub && this->imagePub->HasConnections())
+  {
+    msgs::ImageStamped msg;
+    msgs::Set(msg.mutable_time(), _time);
+    msg.mutable_image()->set_width(_width);
+    msg.mutable_image()->set_height(_height);
+    msg.mutable_image()->set_pixel_format(
+        common::Image::ConvertPixelFormat(_format));
+
+    msg.mutable_image()->set_step(_width * _depth);
+    msg.mutable_image()->set_data(_data, _width * _depth * _height);
+
+    this->imagePub->Publish(msg);
+  }
+
+  if (this->imagePubIgn.HasConnections())
+  {
+    ignition::msgs::Image msg;
+    msg.mutable_header()->mutable_stamp()->set_sec(_time.sec);
+    msg.mutable_header()->mutable_stamp()->set_nsec(_time.nsec);
+
+    msg.set_width(_width);
+    msg.set_height(_height);
+    msg.set_pixel_format_type(ignition::msgs::ConvertPixelFormatType(
+          _format));
+
+    msg.set_step(_width * _depth);
+    msg.set_data(_data, _width * _depth * _height);
+
+    this->imagePubIgn.Publish(msg);
+  }
+}
+
+//////////////////////////////////////////////////
+bool CameraSensor::InitFallbackCamera()
+{
+  physics::EntityPtr parent = this->world->EntityByName(this->ParentName());
+  if (!parent)
+  {
+    gzerr << "Unable to find the parent[" << this->ParentName()
+      << "] of camera sensor[" << this->ScopedName() << "]\n";
+    return false;
+  }
+
+  sdf::ElementPtr cameraSdf = this->sdf->GetElement("camera");
+  this->dataPtr->cpuCamera.reset(new sensors::CpuCamera(this->world));
+  this->dataPtr->cpuCamera->Load(cameraSdf);
+
+  if (this->dataPtr->cpuCamera->ImageWidth() == 0 ||
+      this->dataPtr->cpuCamera->ImageHeight() == 0)
+  {
+    gzerr << "image has zero size\n";
+    this->dataPtr->cpuCamera.reset();
+    return false;
+  }
+
+  ignition::math::Pose3d cameraPose = this->pose;
+  if (cameraSdf->HasElement("pose"))
+    cameraPose = cameraSdf->Get<ignition::math::Pose3d>("pose") + cameraPose;
+
+  this->dataPtr->cpuCameraPose = cameraPose;
+  this->dataPtr->cpuCameraParent = parent;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void CameraSensor::RenderFallbackCamera()
+{
+  physics::EntityPtr parent = this->dataPtr->cpuCameraParent.lock();
+  if (parent)
+  {
+    this->dataPtr->cpuCamera->SetWorldPose(
+        this->dataPtr->cpuCameraPose + parent->WorldPose());
+  }
+
+  this->dataPtr->cpuCamera->Render();
+  this->lastMeasurementTime = this->world->SimTime();
+
+  // There is no prerender event to schedule the next rendering
+  if (this->useStrictRate && !std::isnan(this->dataPtr->nextRenderingTime))
+  {
+    double dt;
+    if (this->updatePeriod <= 0.0)
+      dt = this->world->Physics()->GetMaxStepSize();
+    else
+      dt = this->updatePeriod.Double();
+    this->dataPtr->nextRenderingTime += dt;
+
+    // Skip the missed periods, as in PrerenderEnded
+    const double simTime = this->lastMeasurementTime.Double();
+    if (this->dataPtr->nextRenderingTime < simTime)
+    {
+      this->dataPtr->nextRenderingTime += dt * std::ceil(
+          (simTime - this->dataPtr->nextRenderingTime) / dt);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+CpuCameraPtr CameraSensor::FallbackCamera() const
+{
+  return this->dataPtr->cpuCamera;
+}
+
 //////////////////////////////////////////////////
 unsigned int CameraSensor::ImageWidth() const
 {
   if (this->camera)
     return this->camera->ImageWidth();
 
+  if (this->dataPtr->cpuCamera)
+    return this->dataPtr->cpuCamera->ImageWidth();
+
   if (this->sdf && this->sdf->HasElement("camera"))
   {
     sdf::ElementPtr cameraSdf = this->sdf->GetElement("camera");
@@ -409,6 +523,9 @@ unsigned int CameraSensor::ImageHeight() const
   if (this->camera)
     return this->camera->ImageHeight();
 
+  if (this->dataPtr->cpuCamera)
+    return this->dataPtr->cpuCamera->ImageHeight();
+
   if (this->sdf && this->sdf->HasElement("camera"))
   {
     sdf::ElementPtr cameraSdf = this->sdf->GetElement("camera");
@@ -425,6 +542,8 @@ const unsigned char *CameraSensor::ImageData() const
 {
   if (this->camera)
     return this->camera->ImageData(0);
+  else if (this->dataPtr->cpuCamera)
+    return this->dataPtr->cpuCamera->ImageData();
   else
     return nullptr;
 }
@@ -436,8 +555,20 @@ bool CameraSensor::SaveFrame(const std::string &_filename)
 
   if (this->camera)
     return this->camera->SaveFrame(_filename);
-  else
-    return false;
+
+  if (this->dataPtr->cpuCamera)
+  {
+    common::Image image;
+    image.SetFromData(this->dataPtr->cpuCamera->ImageData(),
+        this->dataPtr->cpuCamera->ImageWidth(),
+        this->dataPtr->cpuCamera->ImageHeight(),
+        common::Image::ConvertPixelFormat(
+        this->dataPtr->cpuCamera->ImageFormat()));
+    image.SavePNG(_filename);
+    return true;
+  }
+
+  return false;
 }
 
 //////////////////////////////////////////////////
@@ -448,6 +579,13 @@ bool CameraSensor::IsActive() const
     this->imagePubIgn.HasConnections();
 }
 
+//////////////////////////////////////////////////
+bool CameraSensor::HasListeners() const
+{
+  return Sensor::HasListeners() || (this->camera &&
+      this->camera->NewImageFrameConnectionCount() > 0);
+}
+
 //////////////////////////////////////////////////
 rendering::CameraPtr CameraSensor::Camera() const
 {
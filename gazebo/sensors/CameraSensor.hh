@@ -21,7 +21,9 @@
 #include <string>
 #include <ignition/transport/Node.hh>
 
+#include "gazebo/common/Time.hh"
 #include "gazebo/sensors/Sensor.hh"
+#include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/util/system.hh"
@@ -92,6 +94,11 @@ namespace gazebo
       /// \return The Pointer to the camera sensor.
       public: rendering::CameraPtr Camera() const;
 
+      /// \brief Get the camera which renders on the CPU, used instead of
+      /// the rendering camera when rendering is disabled.
+      /// \return Pointer to the CPU camera, null when Camera() is used.
+      public: CpuCameraPtr FallbackCamera() const;
+
       /// \brief Gets the width of the image in pixels.
       /// \return The image width in pixels.
       public: unsigned int ImageWidth() const;
@@ -112,6 +119,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool IsActive() const override;
 
+      // Documentation inherited
+      protected: virtual bool HasListeners() const override;
+
       // Documentation inherited
       protected: virtual bool UpdateImpl(const bool _force) override;
 
@@ -131,6 +141,27 @@ namespace gazebo
       /// \brief Handle the prerenderEnded event.
       protected: void PrerenderEnded();
 
+      /// \brief Create the camera rendering on the CPU, used when rendering
+      /// is disabled.
+      /// \return True if the camera was created.
+      protected: bool InitFallbackCamera();
+
+      /// \brief Render the CPU camera at the current pose of the parent
+      /// of the sensor.
+      protected: void RenderFallbackCamera();
+
+      /// \brief Publish an image on the image topics which have subscribers.
+      /// \param[in] _data Pixels.
+      /// \param[in] _width Image width.
+      /// \param[in] _height Image height.
+      /// \param[in] _depth Bytes per pixel.
+      /// \param[in] _format Pixel format name.
+      /// \param[in] _time Time the image was rendered at.
+      private: void PublishImage(const unsigned char *_data,
+          const unsigned int _width, const unsigned int _height,
+          const unsigned int _depth, const std::string &_format,
+          const common::Time &_time);
+
       /// \brief Pointer to the camera.
       protected: rendering::CameraPtr camera;
 
@@ -19,6 +19,12 @@
 
 #include <limits>
 
+#include <boost/weak_ptr.hpp>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/SensorTypes.hh"
+
 namespace gazebo
 {
   namespace sensors
@@ -36,6 +42,16 @@ namespace gazebo
       /// \brief Timestamp of the forthcoming rendering
       public: double nextRenderingTime
                            = std::numeric_limits<double>::quiet_NaN();
+
+      /// \brief Camera rendering on the CPU, used when rendering is
+      /// disabled.
+      public: CpuCameraPtr cpuCamera;
+
+      /// \brief Entity cpuCamera is attached to.
+      public: boost::weak_ptr<physics::Entity> cpuCameraParent;
+
+      /// \brief Pose of cpuCamera relative to cpuCameraParent.
+      public: ignition::math::Pose3d cpuCameraPose;
     };
   }
 }
@@ -0,0 +1,638 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include <boost/weak_ptr.hpp>
+#include <ignition/math/Color.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/TriangleBvh.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/sensors/CpuCamera.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+/// \brief Size of the square tiles of pixels traced together.
+static const unsigned int TileSize = 8;
+
+/// \brief Light which doesn't depend on the orientation of the surfaces.
+static const double Ambient = 0.3;
+
+/// \brief Diffuse colors of the common Gazebo materials.
+static const std::map<std::string, ignition::math::Color> MaterialColors = {
+  {"Gazebo/Black", ignition::math::Color(0, 0, 0)},
+  {"Gazebo/Blue", ignition::math::Color(0, 0, 1)},
+  {"Gazebo/DarkGrey", ignition::math::Color(0.175f, 0.175f, 0.175f)},
+  {"Gazebo/Green", ignition::math::Color(0, 1, 0)},
+  {"Gazebo/Grey", ignition::math::Color(0.7f, 0.7f, 0.7f)},
+  {"Gazebo/Orange", ignition::math::Color(1, 0.5088f, 0.0468f)},
+  {"Gazebo/Purple", ignition::math::Color(1, 0, 1)},
+  {"Gazebo/Red", ignition::math::Color(1, 0, 0)},
+  {"Gazebo/Turquoise", ignition::math::Color(0, 1, 1)},
+  {"Gazebo/White", ignition::math::Color(1, 1, 1)},
+  {"Gazebo/Yellow", ignition::math::Color(1, 1, 0)}
+};
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \internal
+    /// \brief Visual in one of the hierarchies of a CpuCamera.
+    class CpuCameraObject
+    {
+      /// \brief Link of the visual.
+      public: boost::weak_ptr<physics::Link> link;
+
+      /// \brief Pose of the mesh relative to the link.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Color of each submesh.
+      public: std::vector<ignition::math::Color> colors;
+    };
+
+    /// \internal
+    /// \brief Private data for the CpuCamera class.
+    class CpuCameraPrivate
+    {
+      /// \brief Build the hierarchies from the visuals of the world.
+      public: void BuildScene();
+
+      /// \brief Add the visuals of a model and of its nested models.
+      /// \param[in] _model Model.
+      public: void AddModel(const physics::ModelPtr &_model);
+
+      /// \brief Add a visual to one of the hierarchies.
+      /// \param[in] _link Link of the visual.
+      /// \param[in] _msg Visual.
+      /// \param[in] _static True to add the visual to the static hierarchy.
+      public: void AddVisual(const physics::LinkPtr &_link,
+                  const msgs::Visual &_msg, const bool _static);
+
+      /// \brief Build the hierarchies again if links were added or removed
+      /// or if static models changed, else move the dynamic visuals.
+      public: void UpdateScene();
+
+      /// \brief Get the ids of the links of a model and of its nested models.
+      /// \param[in] _model Model.
+      /// \param[out] _ids Ids, appended to the vector.
+      public: static void LinkIds(const physics::ModelPtr &_model,
+                  std::vector<uint32_t> &_ids);
+
+      /// \brief World to render.
+      public: physics::WorldPtr world;
+
+      /// \brief Visuals of the static models.
+      public: common::TriangleBvh staticBvh;
+
+      /// \brief Visuals of the other models, refit before each render.
+      public: common::TriangleBvh dynamicBvh;
+
+      /// \brief Objects of staticBvh, by index.
+      public: std::vector<CpuCameraObject> staticObjects;
+
+      /// \brief Objects of dynamicBvh, by index.
+      public: std::vector<CpuCameraObject> dynamicObjects;
+
+      /// \brief Ids of the links in the scene, sorted.
+      public: std::vector<uint32_t> linkIds;
+
+      /// \brief World::StaticModelsRevision when the scene was built.
+      public: uint64_t staticRevision = 0;
+
+      /// \brief True once the scene was built.
+      public: bool sceneBuilt = false;
+
+      /// \brief Pose of the camera.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Image width.
+      public: unsigned int width = 320;
+
+      /// \brief Image height.
+      public: unsigned int height = 240;
+
+      /// \brief Image format.
+      public: std::string format = "R8G8B8";
+
+      /// \brief Bytes per pixel.
+      public: unsigned int depth = 3;
+
+      /// \brief Horizontal field of view.
+      public: double hfov = 1.047;
+
+      /// \brief Near clip distance.
+      public: double nearClip = 0.1;
+
+      /// \brief Far clip distance.
+      public: double farClip = 100;
+
+      /// \brief Color of the pixels where nothing is hit.
+      public: ignition::math::Color background =
+              ignition::math::Color(0.7f, 0.7f, 0.7f);
+
+      /// \brief Last image rendered.
+      public: std::vector<unsigned char> image;
+
+      /// \brief Depth of the last image rendered.
+      public: std::vector<float> depthData;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+CpuCamera::CpuCamera(physics::WorldPtr _world)
+: dataPtr(new CpuCameraPrivate)
+{
+  this->dataPtr->world = _world;
+
+  sdf::ElementPtr worldSdf = _world ? _world->SDF() : nullptr;
+  if (worldSdf && worldSdf->HasElement("scene"))
+  {
+    this->dataPtr->background = worldSdf->GetElement("scene")->Get<
+        ignition::math::Color>("background");
+  }
+}
+
+/////////////////////////////////////////////////
+CpuCamera::~CpuCamera()
+{
+}
+
+/////////////////////////////////////////////////
+void CpuCamera::Load(sdf::ElementPtr _sdf)
+{
+  if (!_sdf)
+    return;
+
+  this->dataPtr->hfov = _sdf->Get<double>("horizontal_fov");
+
+  sdf::ElementPtr imageElem = _sdf->GetElement("image");
+  this->dataPtr->width = imageElem->Get<unsigned int>("width");
+  this->dataPtr->height = imageElem->Get<unsigned int>("height");
+  this->dataPtr->format = imageElem->Get<std::string>("format");
+
+  if (this->dataPtr->format == "L8")
+  {
+    this->dataPtr->depth = 1;
+  }
+  else
+  {
+    if (this->dataPtr->format != "R8G8B8" &&
+        this->dataPtr->format != "B8G8R8")
+    {
+      gzwarn << "Image format[" << this->dataPtr->format << "] isn't "
+        << "supported by the CPU camera, using R8G8B8" << std::endl;
+      this->dataPtr->format = "R8G8B8";
+    }
+    this->dataPtr->depth = 3;
+  }
+
+  sdf::ElementPtr clipElem = _sdf->GetElement("clip");
+  this->dataPtr->nearClip = clipElem->Get<double>("near");
+  this->dataPtr->farClip = clipElem->Get<double>("far");
+
+  const unsigned int pixels = this->dataPtr->width * this->dataPtr->height;
+  this->dataPtr->image.assign(pixels * this->dataPtr->depth, 0);
+  this->dataPtr->depthData.assign(pixels,
+      static_cast<float>(this->dataPtr->farClip));
+}
+
+/////////////////////////////////////////////////
+void CpuCamera::SetWorldPose(const ignition::math::Pose3d &_pose)
+{
+  this->dataPtr->pose = _pose;
+}
+
+/////////////////////////////////////////////////
+ignition::math::Pose3d CpuCamera::WorldPose() const
+{
+  return this->dataPtr->pose;
+}
+
+/////////////////////////////////////////////////
+void CpuCamera::Render()
+{
+  if (!this->dataPtr->world)
+    return;
+
+  this->dataPtr->UpdateScene();
+
+  const unsigned int width = this->dataPtr->width;
+  const unsigned int height = this->dataPtr->height;
+  if (width == 0 || height == 0)
+    return;
+
+  this->dataPtr->image.resize(width * height * this->dataPtr->depth);
+  this->dataPtr->depthData.resize(width * height);
+
+  const ignition::math::Vector3d origin = this->dataPtr->pose.Pos();
+  const ignition::math::Quaterniond rot = this->dataPtr->pose.Rot();
+  const double focal = width * 0.5 / std::tan(this->dataPtr->hfov * 0.5);
+  const double nearClip = this->dataPtr->nearClip;
+  const double farClip = this->dataPtr->farClip;
+
+  const unsigned int tilesX = (width + TileSize - 1) / TileSize;
+  const unsigned int tilesY = (height + TileSize - 1) / TileSize;
+
+  CpuCameraPrivate *data = this->dataPtr.get();
+
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, tilesX * tilesY),
+      [&](const tbb::blocked_range<unsigned int> &_r)
+  {
+    std::vector<unsigned int> pixels;
+    std::vector<ignition::math::Vector3d> dirs;
+    std::vector<double> dists;
+    std::vector<int> triangles;
+    std::vector<double> dynamicDists;
+    std::vector<int> dynamicTriangles;
+
+    for (unsigned int tile = _r.begin(); tile != _r.end(); ++tile)
+    {
+      const unsigned int x0 = (tile % tilesX) * TileSize;
+      const unsigned int y0 = (tile / tilesX) * TileSize;
+
+      // The X coordinate of the directions is 1, so that the distance of a
+      // hit is its depth along the optical axis
+      pixels.clear();
+      dirs.clear();
+      for (unsigned int y = y0; y < std::min(y0 + TileSize, height); ++y)
+      {
+        for (unsigned int x = x0; x < std::min(x0 + TileSize, width); ++x)
+        {
+          pixels.push_back(y * width + x);
+          dirs.push_back(rot.RotateVector(ignition::math::Vector3d(1.0,
+              (width * 0.5 - (x + 0.5)) / focal,
+              (height * 0.5 - (y + 0.5)) / focal)));
+        }
+      }
+
+      const unsigned int count = pixels.size();
+      dists.assign(count, farClip);
+      triangles.resize(count);
+      data->staticBvh.Intersect(origin, dirs.data(), count, nearClip,
+          dists.data(), triangles.data());
+
+      // Dynamic visuals only need to be closer than the static hits
+      dynamicDists = dists;
+      dynamicTriangles.resize(count);
+      data->dynamicBvh.Intersect(origin, dirs.data(), count, nearClip,
+          dynamicDists.data(), dynamicTriangles.data());
+
+      for (unsigned int i = 0; i < count; ++i)
+      {
+        ignition::math::Color color = data->background;
+        double dist = farClip;
+
+        const common::TriangleBvh *bvh = nullptr;
+        const std::vector<CpuCameraObject> *objects = nullptr;
+        int triangle = -1;
+        if (dynamicTriangles[i] >= 0)
+        {
+          bvh = &data->dynamicBvh;
+          objects = &data->dynamicObjects;
+          triangle = dynamicTriangles[i];
+          dist = dynamicDists[i];
+        }
+        else if (triangles[i] >= 0)
+        {
+          bvh = &data->staticBvh;
+          objects = &data->staticObjects;
+          triangle = triangles[i];
+          dist = dists[i];
+        }
+
+        if (bvh)
+        {
+          // Flat shading, lit from the camera
+          const CpuCameraObject &object = (*objects)[bvh->Object(triangle)];
+          const unsigned int subMesh = bvh->SubMesh(triangle);
+          const ignition::math::Color diffuse =
+              subMesh < object.colors.size() ? object.colors[subMesh] :
+              ignition::math::Color(0.7f, 0.7f, 0.7f);
+
+          const double lambert = std::abs(bvh->Normal(triangle).Dot(
+              dirs[i].Normalized()));
+          const float shade =
+              static_cast<float>(Ambient + (1.0 - Ambient) * lambert);
+          color.Set(diffuse.R() * shade, diffuse.G() * shade,
+              diffuse.B() * shade);
+        }
+
+        const unsigned int p = pixels[i];
+        data->depthData[p] = static_cast<float>(dist);
+
+        const unsigned char r = static_cast<unsigned char>(
+            ignition::math::clamp(color.R(), 0.0f, 1.0f) * 255);
+        const unsigned char g = static_cast<unsigned char>(
+            ignition::math::clamp(color.G(), 0.0f, 1.0f) * 255);
+        const unsigned char b = static_cast<unsigned char>(
+            ignition::math::clamp(color.B(), 0.0f, 1.0f) * 255);
+
+        unsigned char *out = data->image.data() + p * data->depth;
+        if (data->depth == 1)
+        {
+          out[0] = static_cast<unsigned char>(0.299 * r + 0.587 * g +
+              0.114 * b);
+        }
+        else if (data->format == "B8G8R8")
+        {
+          out[0] = b;
+          out[1] = g;
+          out[2] = r;
+        }
+        else
+        {
+          out[0] = r;
+          out[1] = g;
+          out[2] = b;
+        }
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////
+unsigned int CpuCamera::ImageWidth() const
+{
+  return this->dataPtr->width;
+}
+
+/////////////////////////////////////////////////
+unsigned int CpuCamera::ImageHeight() const
+{
+  return this->dataPtr->height;
+}
+
+/////////////////////////////////////////////////
+unsigned int CpuCamera::ImageDepth() const
+{
+  return this->dataPtr->depth;
+}
+
+/////////////////////////////////////////////////
+std::string CpuCamera::ImageFormat() const
+{
+  return this->dataPtr->format;
+}
+
+/////////////////////////////////////////////////
+double CpuCamera::HFOV() const
+{
+  return this->dataPtr->hfov;
+}
+
+/////////////////////////////////////////////////
+double CpuCamera::NearClip() const
+{
+  return this->dataPtr->nearClip;
+}
+
+/////////////////////////////////////////////////
+double CpuCamera::FarClip() const
+{
+  return this->dataPtr->farClip;
+}
+
+/////////////////////////////////////////////////
+const unsigned char *CpuCamera::ImageData() const
+{
+  return this->dataPtr->image.data();
+}
+
+/////////////////////////////////////////////////
+const float *CpuCamera::DepthData() const
+{
+  return this->dataPtr->depthData.data();
+}
+
+/////////////////////////////////////////////////
+unsigned int CpuCamera::TriangleCount() const
+{
+  return this->dataPtr->staticBvh.TriangleCount() +
+      this->dataPtr->dynamicBvh.TriangleCount();
+}
+
+/////////////////////////////////////////////////
+void CpuCameraPrivate::UpdateScene()
+{
+  const uint64_t revision = this->world->StaticModelsRevision();
+
+  // Acquire the mutex for avoiding race condition with the physics engine
+  boost::recursive_mutex::scoped_lock lock(*(
+        this->world->Physics()->GetPhysicsUpdateMutex()));
+
+  std::vector<uint32_t> ids;
+  for (auto const &model : this->world->Models())
+    LinkIds(model, ids);
+  std::sort(ids.begin(), ids.end());
+
+  if (!this->sceneBuilt || ids != this->linkIds ||
+      revision != this->staticRevision)
+  {
+    this->linkIds.swap(ids);
+    this->staticRevision = revision;
+    this->BuildScene();
+    return;
+  }
+
+  // Only the visuals of the dynamic models move
+  for (unsigned int i = 0; i < this->dynamicObjects.size(); ++i)
+  {
+    physics::LinkPtr link = this->dynamicObjects[i].link.lock();
+    if (link)
+    {
+      this->dynamicBvh.SetPose(i,
+          this->dynamicObjects[i].pose + link->WorldPose());
+    }
+  }
+  this->dynamicBvh.Refit();
+}
+
+/////////////////////////////////////////////////
+void CpuCameraPrivate::LinkIds(const physics::ModelPtr &_model,
+    std::vector<uint32_t> &_ids)
+{
+  for (auto const &link : _model->GetLinks())
+    _ids.push_back(link->GetId());
+  for (auto const &nested : _model->NestedModels())
+    LinkIds(nested, _ids);
+}
+
+/////////////////////////////////////////////////
+void CpuCameraPrivate::BuildScene()
+{
+  this->staticBvh.Clear();
+  this->dynamicBvh.Clear();
+  this->staticObjects.clear();
+  this->dynamicObjects.clear();
+
+  for (auto const &model : this->world->Models())
+    this->AddModel(model);
+
+  this->staticBvh.Build();
+  this->dynamicBvh.Build();
+  this->sceneBuilt = true;
+}
+
+/////////////////////////////////////////////////
+void CpuCameraPrivate::AddModel(const physics::ModelPtr &_model)
+{
+  for (auto const &link : _model->GetLinks())
+  {
+    for (auto const &visual : link->Visuals())
+      this->AddVisual(link, visual.second, _model->IsStatic());
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    this->AddModel(nested);
+}
+
+/////////////////////////////////////////////////
+void CpuCameraPrivate::AddVisual(const physics::LinkPtr &_link,
+    const msgs::Visual &_msg, const bool _static)
+{
+  if ((_msg.has_visible() && !_msg.visible()) ||
+      (_msg.has_transparency() && _msg.transparency() >= 1.0) ||
+      !_msg.has_geometry())
+  {
+    return;
+  }
+
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const msgs::Geometry &geom = _msg.geometry();
+
+  const common::Mesh *mesh = nullptr;
+  ignition::math::Vector3d scale = ignition::math::Vector3d::One;
+  ignition::math::Pose3d offset;
+
+  switch (geom.type())
+  {
+    case msgs::Geometry::BOX:
+      mesh = meshManager->GetMesh("unit_box");
+      scale = msgs::ConvertIgn(geom.box().size());
+      break;
+    case msgs::Geometry::SPHERE:
+      mesh = meshManager->GetMesh("unit_sphere");
+      scale = ignition::math::Vector3d::One * geom.sphere().radius() * 2.0;
+      break;
+    case msgs::Geometry::CYLINDER:
+      mesh = meshManager->GetMesh("unit_cylinder");
+      scale.Set(geom.cylinder().radius() * 2.0,
+          geom.cylinder().radius() * 2.0, geom.cylinder().length());
+      break;
+    case msgs::Geometry::PLANE:
+    {
+      mesh = meshManager->GetMesh("unit_plane");
+      const ignition::math::Vector2d size =
+          msgs::ConvertIgn(geom.plane().size());
+      scale.Set(size.X(), size.Y(), 1.0);
+      ignition::math::Quaterniond rot;
+      rot.From2Axes(ignition::math::Vector3d::UnitZ,
+          msgs::ConvertIgn(geom.plane().normal()));
+      offset.Rot() = rot;
+      break;
+    }
+    case msgs::Geometry::MESH:
+    {
+      const std::string uri = geom.mesh().filename();
+      mesh = meshManager->GetMesh(uri);
+      if (!mesh)
+      {
+        const std::string path = common::find_file(uri);
+        if (path.empty() || path == "__default__")
+        {
+          gzerr << "Failed to find mesh file [" << uri << "]" << std::endl;
+          return;
+        }
+        mesh = meshManager->Load(path);
+      }
+      if (geom.mesh().has_scale())
+        scale = msgs::ConvertIgn(geom.mesh().scale());
+      break;
+    }
+    default:
+      // Heightmaps, polylines and images aren't rendered
+      return;
+  }
+
+  if (!mesh)
+    return;
+
+  if (_msg.has_scale())
+    scale = scale * msgs::ConvertIgn(_msg.scale());
+
+  CpuCameraObject object;
+  object.link = _link;
+  object.pose = offset + msgs::ConvertIgn(_msg.pose());
+
+  // The color of the visual overrides the colors of the submeshes
+  bool hasColor = false;
+  ignition::math::Color color(0.7f, 0.7f, 0.7f);
+  if (_msg.has_material())
+  {
+    if (_msg.material().has_diffuse())
+    {
+      color = msgs::Convert(_msg.material().diffuse());
+      hasColor = true;
+    }
+    else if (_msg.material().has_script())
+    {
+      auto iter = MaterialColors.find(_msg.material().script().name());
+      if (iter != MaterialColors.end())
+      {
+        color = iter->second;
+        hasColor = true;
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < mesh->GetSubMeshCount(); ++i)
+  {
+    const common::Material *material = hasColor ? nullptr :
+        mesh->GetMaterial(mesh->GetSubMesh(i)->GetMaterialIndex());
+    object.colors.push_back(material ? material->Diffuse() : color);
+  }
+
+  const ignition::math::Pose3d pose = object.pose + _link->WorldPose();
+  if (_static)
+  {
+    this->staticBvh.AddMesh(*mesh, scale, pose);
+    this->staticObjects.push_back(object);
+  }
+  else
+  {
+    this->dynamicBvh.AddMesh(*mesh, scale, pose);
+    this->dynamicObjects.push_back(object);
+  }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_CPUCAMERA_HH_
+#define GAZEBO_SENSORS_CPUCAMERA_HH_
+
+#include <memory>
+#include <string>
+
+#include <ignition/math/Pose3.hh>
+#include <sdf/sdf.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class.
+    class CpuCameraPrivate;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class CpuCamera CpuCamera.hh sensors/sensors.hh
+    /// \brief Camera which casts rays against the visual meshes of a world
+    /// on the CPU, used by the camera sensors when rendering is disabled.
+    ///
+    /// The image is flat shaded with a light at the camera, using the
+    /// diffuse colors of the visuals. Textures, shadows, transparency and
+    /// heightmaps aren't rendered. Each pixel also gets the depth of the
+    /// closest surface along the optical axis.
+    class GZ_SENSORS_VISIBLE CpuCamera
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World to render.
+      public: explicit CpuCamera(physics::WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~CpuCamera();
+
+      /// \brief Load the camera parameters.
+      /// \param[in] _sdf The <camera> element of a sensor.
+      public: void Load(sdf::ElementPtr _sdf);
+
+      /// \brief Set the pose of the camera, which looks along its X axis.
+      /// \param[in] _pose Pose in the world frame.
+      public: void SetWorldPose(const ignition::math::Pose3d &_pose);
+
+      /// \brief Get the pose of the camera.
+      /// \return Pose in the world frame.
+      public: ignition::math::Pose3d WorldPose() const;
+
+      /// \brief Render the image and the depth of the world at its current
+      /// state.
+      public: void Render();
+
+      /// \brief Get the width of the image.
+      /// \return Width in pixels.
+      public: unsigned int ImageWidth() const;
+
+      /// \brief Get the height of the image.
+      /// \return Height in pixels.
+      public: unsigned int ImageHeight() const;
+
+      /// \brief Get the number of bytes per pixel.
+      /// \return Bytes per pixel.
+      public: unsigned int ImageDepth() const;
+
+      /// \brief Get the format of the image, one of R8G8B8, B8G8R8 and L8.
+      /// \return Format name.
+      public: std::string ImageFormat() const;
+
+      /// \brief Get the horizontal field of view.
+      /// \return Field of view in radians.
+      public: double HFOV() const;
+
+      /// \brief Get the near clip distance.
+      /// \return Distance in meters.
+      public: double NearClip() const;
+
+      /// \brief Get the far clip distance.
+      /// \return Distance in meters.
+      public: double FarClip() const;
+
+      /// \brief Get the last image rendered.
+      /// \return Pixels, row after row.
+      public: const unsigned char *ImageData() const;
+
+      /// \brief Get the depth of the last image rendered. Pixels where
+      /// nothing was hit are set to the far clip distance.
+      /// \return Depths in meters, row after row.
+      public: const float *DepthData() const;
+
+      /// \brief Get the number of triangles in the scene.
+      /// \return Number of triangles.
+      public: unsigned int TriangleCount() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<CpuCameraPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
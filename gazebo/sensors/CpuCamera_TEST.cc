@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/sensors/CpuCamera.hh"
+
+using namespace gazebo;
+class CpuCamera_TEST : public ServerFixture
+{
+};
+
+// A camera looking along its X axis
+static std::string cameraSensorString =
+"<sdf version='1.6'>"
+"  <sensor name='camera' type='camera'>"
+"    <camera>"
+"      <horizontal_fov>1.0472</horizontal_fov>"
+"      <image>"
+"        <width>64</width>"
+"        <height>48</height>"
+"        <format>R8G8B8</format>"
+"      </image>"
+"      <clip>"
+"        <near>0.1</near>"
+"        <far>100</far>"
+"      </clip>"
+"    </camera>"
+"  </sensor>"
+"</sdf>";
+
+/////////////////////////////////////////////////
+/// \brief Render a box standing on the ground plane
+TEST_F(CpuCamera_TEST, Box)
+{
+  Load("worlds/empty.world");
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // A 1 m box whose front face is 2.5 m in front of the camera
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(3, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  sdf::ElementPtr sdf(new sdf::Element);
+  sdf::initFile("sensor.sdf", sdf);
+  sdf::readString(cameraSensorString, sdf);
+
+  sensors::CpuCamera camera(world);
+  camera.Load(sdf->GetElement("camera"));
+  EXPECT_EQ(64u, camera.ImageWidth());
+  EXPECT_EQ(48u, camera.ImageHeight());
+  EXPECT_EQ(3u, camera.ImageDepth());
+  EXPECT_EQ("R8G8B8", camera.ImageFormat());
+  EXPECT_NEAR(1.0472, camera.HFOV(), 1e-6);
+  EXPECT_DOUBLE_EQ(0.1, camera.NearClip());
+  EXPECT_DOUBLE_EQ(100, camera.FarClip());
+
+  camera.SetWorldPose(ignition::math::Pose3d(0, 0, 0.5, 0, 0, 0));
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 0.5, 0, 0, 0), camera.WorldPose());
+  camera.Render();
+  EXPECT_GT(camera.TriangleCount(), 0u);
+
+  const float *depth = camera.DepthData();
+  const unsigned char *image = camera.ImageData();
+  ASSERT_TRUE(depth != nullptr);
+  ASSERT_TRUE(image != nullptr);
+
+  const unsigned int width = camera.ImageWidth();
+  const unsigned int height = camera.ImageHeight();
+
+  // The box is in the middle of the image
+  const unsigned int center = height / 2 * width + width / 2;
+  EXPECT_NEAR(2.5, depth[center], 0.01);
+
+  // The sky is at the top, and the ground at the bottom
+  const unsigned int top = width / 2;
+  const unsigned int bottom = (height - 1) * width + width / 2;
+  EXPECT_FLOAT_EQ(100, depth[top]);
+  EXPECT_LT(depth[bottom], 100);
+
+  // The ground is seen at an angle, so it is darker than the background
+  EXPECT_LT(image[bottom * 3], image[top * 3]);
+
+  // Move the camera up so that the box is below the middle of the image
+  camera.SetWorldPose(ignition::math::Pose3d(0, 0, 5, 0, 0, 0));
+  camera.Render();
+  EXPECT_FLOAT_EQ(100, depth[center]);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
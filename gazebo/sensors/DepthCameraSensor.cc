@@ -14,10 +14,20 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "ignition/common/Profiler.hh"
 
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/msgs/msgs.hh"
+
 #include "gazebo/physics/World.hh"
 
 #include "gazebo/rendering/DepthCamera.hh"
@@ -27,6 +37,7 @@
 
 #include "gazebo/transport/transport.hh"
 
+#include "gazebo/sensors/CpuCamera.hh"
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/CameraSensor.hh"
 #include "gazebo/sensors/DepthCameraSensorPrivate.hh"
@@ -37,6 +48,99 @@ using namespace sensors;
 
 GZ_REGISTER_STATIC_SENSOR("depth", DepthCameraSensor)
 
+/// \brief Number of floats per point of a point cloud message.
+static const unsigned int kPointFloats = 4;
+
+/////////////////////////////////////////////////
+/// \brief Replace the points in each voxel of a grid by their centroid.
+/// \param[in] _points Points as x, y, z and color, NaN if invalid.
+/// \param[in] _count Number of points.
+/// \param[in] _size Size of the voxels.
+/// \param[in] _colored True to average the colors of the points.
+/// \param[in,out] _voxels Buffer for the voxel of each point.
+/// \param[out] _centroids Centroids, packed as the points.
+/// \return Number of centroids.
+static unsigned int downsampleVoxels(const float *_points,
+    const unsigned int _count, const float _size, const bool _colored,
+    std::vector<std::pair<uint64_t, uint32_t>> &_voxels,
+    std::string &_centroids)
+{
+  // 21 bits per coordinate of the voxels, centered on the camera
+  const uint64_t bits = 21;
+  const float half = static_cast<float>(1 << (bits - 1));
+  const uint64_t invalid = std::numeric_limits<uint64_t>::max();
+  const float invSize = 1.0f / _size;
+
+  // Straight arithmetic on contiguous floats without branches, which the
+  // compiler turns into vector instructions
+  _voxels.resize(_count);
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    const float *point = _points + i * kPointFloats;
+    const float x = std::floor(point[0] * invSize) + half;
+    const float y = std::floor(point[1] * invSize) + half;
+    const float z = std::floor(point[2] * invSize) + half;
+
+    // False for NaN points
+    const bool inside = x >= 0 && x < 2 * half && y >= 0 && y < 2 * half &&
+        z >= 0 && z < 2 * half;
+
+    const uint64_t key =
+        (static_cast<uint64_t>(inside ? x : 0) << (2 * bits)) |
+        (static_cast<uint64_t>(inside ? y : 0) << bits) |
+        static_cast<uint64_t>(inside ? z : 0);
+    _voxels[i] = std::make_pair(inside ? key : invalid, i);
+  }
+
+  // Points of the same voxel are next to each other once sorted, and the
+  // invalid points are last
+  std::sort(_voxels.begin(), _voxels.end());
+
+  _centroids.clear();
+  unsigned int centroidCount = 0;
+  for (unsigned int begin = 0; begin < _count &&
+      _voxels[begin].first != invalid;)
+  {
+    unsigned int end = begin;
+    double sum[3] = {0, 0, 0};
+    double color[3] = {0, 0, 0};
+    for (; end < _count && _voxels[end].first == _voxels[begin].first; ++end)
+    {
+      const float *point = _points + _voxels[end].second * kPointFloats;
+      for (unsigned int j = 0; j < 3; ++j)
+        sum[j] += point[j];
+
+      if (_colored)
+      {
+        uint32_t rgb;
+        memcpy(&rgb, point + 3, sizeof(rgb));
+        color[0] += (rgb >> 16) & 0xFF;
+        color[1] += (rgb >> 8) & 0xFF;
+        color[2] += rgb & 0xFF;
+      }
+    }
+
+    const double n = end - begin;
+    float centroid[kPointFloats] = {static_cast<float>(sum[0] / n),
+        static_cast<float>(sum[1] / n), static_cast<float>(sum[2] / n), 0};
+    if (_colored)
+    {
+      const uint32_t rgb =
+          (static_cast<uint32_t>(std::round(color[0] / n)) << 16) |
+          (static_cast<uint32_t>(std::round(color[1] / n)) << 8) |
+          static_cast<uint32_t>(std::round(color[2] / n));
+      memcpy(centroid + 3, &rgb, sizeof(rgb));
+    }
+    _centroids.append(reinterpret_cast<const char *>(centroid),
+        sizeof(centroid));
+
+    ++centroidCount;
+    begin = end;
+  }
+
+  return centroidCount;
+}
+
 //////////////////////////////////////////////////
 DepthCameraSensor::DepthCameraSensor()
     : CameraSensor(),
@@ -55,6 +159,9 @@ DepthCameraSensor::~DepthCameraSensor()
 void DepthCameraSensor::Load(const std::string &_worldName)
 {
   CameraSensor::Load(_worldName);
+
+  this->dataPtr->pointsPub = this->node->Advertise<msgs::PointCloud>(
+      this->PointCloudTopic(), 50);
 }
 
 //////////////////////////////////////////////////
@@ -63,8 +170,16 @@ void DepthCameraSensor::Init()
   if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
       rendering::RenderEngine::NONE)
   {
-    gzerr << "Unable to create DepthCameraSensor. Rendering is disabled."
-        << std::endl;
+    if (!this->InitFallbackCamera())
+    {
+      gzerr << "Unable to create DepthCameraSensor. Rendering is disabled."
+          << std::endl;
+      return;
+    }
+
+    gzmsg << "Rendering is disabled, depth camera sensor["
+      << this->ScopedName() << "] renders on the CPU" << std::endl;
+    Sensor::Init();
     return;
   }
 
@@ -90,6 +205,13 @@ void DepthCameraSensor::Init()
     sdf::ElementPtr cameraSdf = this->sdf->GetElement("camera");
     this->dataPtr->depthCamera->Load(cameraSdf);
 
+    this->dataPtr->pointCloudConnection =
+        this->dataPtr->depthCamera->ConnectNewRGBPointCloud(
+        std::bind(&DepthCameraSensor::OnNewRGBPointCloud, this,
+          std::placeholders::_1, std::placeholders::_2,
+          std::placeholders::_3, std::placeholders::_4,
+          std::placeholders::_5));
+
     // Do some sanity checks
     if (this->dataPtr->depthCamera->ImageWidth() == 0u ||
         this->dataPtr->depthCamera->ImageHeight() == 0u)
@@ -137,9 +259,41 @@ void DepthCameraSensor::Init()
 bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
 {
   IGN_PROFILE("DepthCameraSensor::UpdateImpl");
+
+  CpuCameraPtr cpuCamera = this->FallbackCamera();
+  if (cpuCamera)
+  {
+    IGN_PROFILE_BEGIN("RenderFallbackCamera");
+    this->RenderFallbackCamera();
+    IGN_PROFILE_END();
+
+    if (this->imagePub && this->imagePub->HasConnections())
+    {
+      this->PublishDepth(cpuCamera->DepthData(), cpuCamera->ImageWidth(),
+          cpuCamera->ImageHeight(), cpuCamera->ImageWidth() * sizeof(float),
+          cpuCamera->NearClip(), cpuCamera->FarClip(),
+          this->LastMeasurementTime());
+    }
+
+    if (this->dataPtr->pointsPub && this->dataPtr->pointsPub->HasConnections())
+    {
+      IGN_PROFILE_BEGIN("PublishPoints");
+      this->PublishPoints(nullptr, cpuCamera->DepthData(),
+          cpuCamera->ImageData(), cpuCamera->ImageDepth(),
+          cpuCamera->ImageWidth(), cpuCamera->ImageHeight(),
+          cpuCamera->HFOV(), cpuCamera->NearClip(), cpuCamera->FarClip(),
+          this->LastMeasurementTime());
+      IGN_PROFILE_END();
+    }
+    return true;
+  }
+
   if (!this->Rendered())
     return false;
 
+  // Set by OnNewRGBPointCloud if the camera outputs points
+  this->dataPtr->pointCloud = nullptr;
+
   IGN_PROFILE_BEGIN("PostRender");
   this->camera->PostRender();
   IGN_PROFILE_END();
@@ -147,50 +301,217 @@ bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
   IGN_PROFILE_BEGIN("fillarray");
 
   if (this->imagePub && this->imagePub->HasConnections() &&
+      this->camera->FrameReady() &&
       // check if depth data is available. If not, the depth camera could be
       // generating point clouds instead
       this->dataPtr->depthCamera->DepthData())
   {
-    msgs::ImageStamped msg;
-    msgs::Set(msg.mutable_time(), this->scene->SimTime());
-    msg.mutable_image()->set_width(this->camera->ImageWidth());
-    msg.mutable_image()->set_height(this->camera->ImageHeight());
-    msg.mutable_image()->set_pixel_format(common::Image::R_FLOAT32);
+    this->PublishDepth(this->dataPtr->depthCamera->DepthData(),
+        this->camera->ImageWidth(), this->camera->ImageHeight(),
+        this->camera->ImageWidth() * this->camera->ImageDepth(),
+        this->camera->NearClip(), this->camera->FarClip(),
+        this->camera->FrameSimTime());
+  }
 
+  // The points are published once the image of the same frame is copied,
+  // straight from the buffer of the camera
+  if (this->dataPtr->pointsPub && this->dataPtr->pointsPub->HasConnections() &&
+      this->camera->FrameReady() && (this->dataPtr->pointCloud ||
+      this->dataPtr->depthCamera->DepthData()))
+  {
+    IGN_PROFILE_BEGIN("PublishPoints");
+    this->PublishPoints(this->dataPtr->pointCloud,
+        this->dataPtr->depthCamera->DepthData(), this->camera->ImageData(),
+        this->camera->ImageDepth(), this->camera->ImageWidth(),
+        this->camera->ImageHeight(), this->camera->HFOV().Radian(),
+        this->camera->NearClip(), this->camera->FarClip(),
+        this->camera->FrameSimTime());
+    IGN_PROFILE_END();
+  }
 
-    msg.mutable_image()->set_step(this->camera->ImageWidth() *
-        this->camera->ImageDepth());
+  this->SetRendered(false);
+  IGN_PROFILE_END();
+  return true;
+}
 
-    unsigned int depthSamples = msg.image().width() * msg.image().height();
-    float f;
-    // cppchecker recommends using sizeof(varname)
-    unsigned int depthBufferSize = depthSamples * sizeof(f);
+//////////////////////////////////////////////////
+void DepthCameraSensor::PublishDepth(const float *_depth,
+    const unsigned int _width, const unsigned int _height,
+    const unsigned int _step, const double _near, const double _far,
+    const common::Time &_time)
+{
+  msgs::ImageStamped msg;
+  msgs::Set(msg.mutable_time(), _time);
+  msg.mutable_image()->set_width(_width);
+  msg.mutable_image()->set_height(_height);
+  msg.mutable_image()->set_pixel_format(common::Image::R_FLOAT32);
+  msg.mutable_image()->set_step(_step);
 
-    if (!this->dataPtr->depthBuffer)
-      this->dataPtr->depthBuffer = new float[depthSamples];
+  unsigned int depthSamples = _width * _height;
+  float f;
+  // cppchecker recommends using sizeof(varname)
+  unsigned int depthBufferSize = depthSamples * sizeof(f);
 
-    memcpy(this->dataPtr->depthBuffer, this->dataPtr->depthCamera->DepthData(),
-        depthBufferSize);
+  if (!this->dataPtr->depthBuffer)
+    this->dataPtr->depthBuffer = new float[depthSamples];
 
-    for (unsigned int i = 0; i < depthSamples; ++i)
+  memcpy(this->dataPtr->depthBuffer, _depth, depthBufferSize);
+
+  for (unsigned int i = 0; i < depthSamples; ++i)
+  {
+    // Mask ranges outside of min/max to +/- inf, as per REP 117
+    if (this->dataPtr->depthBuffer[i] >= _far)
     {
-      // Mask ranges outside of min/max to +/- inf, as per REP 117
-      if (this->dataPtr->depthBuffer[i] >= this->camera->FarClip())
-      {
-        this->dataPtr->depthBuffer[i] = ignition::math::INF_D;
-      }
-      else if (this->dataPtr->depthBuffer[i] <= this->camera->NearClip())
+      this->dataPtr->depthBuffer[i] = ignition::math::INF_D;
+    }
+    else if (this->dataPtr->depthBuffer[i] <= _near)
+    {
+      this->dataPtr->depthBuffer[i] = -ignition::math::INF_D;
+    }
+  }
+  msg.mutable_image()->set_data(this->dataPtr->depthBuffer, depthBufferSize);
+  this->imagePub->Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void DepthCameraSensor::PublishPoints(const float *_points,
+    const float *_depth, const unsigned char *_image,
+    const unsigned int _imageDepth, const unsigned int _width,
+    const unsigned int _height, const double _hfov, const double _near,
+    const double _far, const common::Time &_time)
+{
+  bool colored;
+  double voxelSize;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->pointCloudMutex);
+    colored = this->dataPtr->pointCloudColored && _image && _imageDepth > 0;
+    voxelSize = this->dataPtr->pointCloudVoxelSize;
+  }
+
+  const unsigned int count = _width * _height;
+
+  msgs::PointCloud msg;
+  msgs::Set(msg.mutable_time(), _time);
+  msg.set_width(_width);
+  msg.set_height(_height);
+  msg.set_point_step(kPointFloats * sizeof(float));
+  msg.set_rgb(colored);
+
+  // The points are written in the message itself
+  std::string *data = msg.mutable_data();
+  data->resize(count * msg.point_step());
+  float *points = reinterpret_cast<float *>(&(*data)[0]);
+
+  if (_points)
+  {
+    memcpy(points, _points, data->size());
+  }
+  else if (_depth)
+  {
+    const float invFocal = static_cast<float>(
+        std::tan(_hfov * 0.5) / (_width * 0.5));
+    for (unsigned int v = 0; v < _height; ++v)
+    {
+      const float y = (v + 0.5f - _height * 0.5f) * invFocal;
+      for (unsigned int u = 0; u < _width; ++u)
       {
-        this->dataPtr->depthBuffer[i] = -ignition::math::INF_D;
+        const unsigned int i = v * _width + u;
+        const float z = _depth[i];
+        points[i * kPointFloats] = (u + 0.5f - _width * 0.5f) * invFocal * z;
+        points[i * kPointFloats + 1] = y * z;
+        points[i * kPointFloats + 2] = z;
       }
     }
-    msg.mutable_image()->set_data(this->dataPtr->depthBuffer, depthBufferSize);
-    this->imagePub->Publish(msg);
   }
 
-  this->SetRendered(false);
-  IGN_PROFILE_END();
-  return true;
+  const float nearClip = static_cast<float>(_near);
+  const float farClip = static_cast<float>(_far);
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    float *point = points + i * kPointFloats;
+
+    // Points outside of the clip distances have no valid depth
+    if (!(point[2] > nearClip && point[2] < farClip))
+      point[0] = point[1] = point[2] = nan;
+
+    uint32_t rgb = 0;
+    if (colored)
+    {
+      const unsigned char *pixel = _image + i * _imageDepth;
+      if (_imageDepth >= 3)
+        rgb = (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
+      else
+        rgb = (pixel[0] << 16) | (pixel[0] << 8) | pixel[0];
+    }
+    memcpy(point + 3, &rgb, sizeof(rgb));
+  }
+
+  if (voxelSize > 0)
+  {
+    std::string centroids;
+    const unsigned int centroidCount = downsampleVoxels(points, count,
+        static_cast<float>(voxelSize), colored, this->dataPtr->voxels,
+        centroids);
+    data->swap(centroids);
+    msg.set_width(centroidCount);
+    msg.set_height(1);
+  }
+
+  this->dataPtr->pointsPub->Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void DepthCameraSensor::OnNewRGBPointCloud(const float *_pcd,
+    const unsigned int /*_width*/, const unsigned int /*_height*/,
+    const unsigned int /*_depth*/, const std::string &/*_format*/)
+{
+  this->dataPtr->pointCloud = _pcd;
+}
+
+//////////////////////////////////////////////////
+std::string DepthCameraSensor::PointCloudTopic() const
+{
+  std::string topicName = "~/";
+  topicName += this->ParentName() + "/" + this->Name() + "/points";
+  common::replaceAll(topicName, topicName, "::", "/");
+
+  return topicName;
+}
+
+//////////////////////////////////////////////////
+void DepthCameraSensor::SetPointCloudColored(const bool _colored)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->pointCloudMutex);
+  this->dataPtr->pointCloudColored = _colored;
+}
+
+//////////////////////////////////////////////////
+bool DepthCameraSensor::PointCloudColored() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->pointCloudMutex);
+  return this->dataPtr->pointCloudColored;
+}
+
+//////////////////////////////////////////////////
+void DepthCameraSensor::SetPointCloudVoxelSize(const double _size)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->pointCloudMutex);
+  this->dataPtr->pointCloudVoxelSize = std::max(_size, 0.0);
+}
+
+//////////////////////////////////////////////////
+double DepthCameraSensor::PointCloudVoxelSize() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->pointCloudMutex);
+  return this->dataPtr->pointCloudVoxelSize;
+}
+
+//////////////////////////////////////////////////
+bool DepthCameraSensor::IsActive() const
+{
+  return CameraSensor::IsActive() ||
+    (this->dataPtr->pointsPub && this->dataPtr->pointsPub->HasConnections());
 }
 
 //////////////////////////////////////////////////
@@ -59,6 +59,37 @@ namespace gazebo
       /// \return Depth Camera pointer
       public: virtual rendering::DepthCameraPtr DepthCamera() const;
 
+      /// \brief Get the topic on which the points seen by the camera are
+      /// published. Point clouds are only computed while the topic has
+      /// subscribers.
+      /// \return Name of the point cloud topic.
+      public: std::string PointCloudTopic() const;
+
+      /// \brief Set whether the published points have the colors of the
+      /// camera image.
+      /// \param[in] _colored True to publish XYZRGB points, false to
+      /// publish XYZ points.
+      public: void SetPointCloudColored(const bool _colored);
+
+      /// \brief Get whether the published points have colors.
+      /// \return True if XYZRGB points are published.
+      public: bool PointCloudColored() const;
+
+      /// \brief Set the size of the voxels the published point clouds are
+      /// downsampled with. The points in a voxel are replaced by their
+      /// centroid, and the cloud isn't organized anymore.
+      /// \param[in] _size Size of the voxels, zero to publish one point per
+      /// pixel.
+      public: void SetPointCloudVoxelSize(const double _size);
+
+      /// \brief Get the size of the voxels point clouds are downsampled
+      /// with.
+      /// \return Size of the voxels, zero if clouds aren't downsampled.
+      public: double PointCloudVoxelSize() const;
+
+      // Documentation inherited
+      public: virtual bool IsActive() const override;
+
       /// \brief Load the sensor with default parameters
       /// \param[in] _worldName Name of world to load from
       protected: virtual void Load(const std::string &_worldName);
@@ -66,6 +97,53 @@ namespace gazebo
       // Documentation inherited
       protected: virtual bool UpdateImpl(const bool _force);
 
+      /// \brief Publish a depth image, masking the depths outside of the
+      /// clip distances to infinity.
+      /// \param[in] _depth Depths, row after row.
+      /// \param[in] _width Width of the image.
+      /// \param[in] _height Height of the image.
+      /// \param[in] _step Size of a row in the message.
+      /// \param[in] _near Near clip distance.
+      /// \param[in] _far Far clip distance.
+      /// \param[in] _time Time the image was captured at.
+      private: void PublishDepth(const float *_depth,
+                   const unsigned int _width, const unsigned int _height,
+                   const unsigned int _step, const double _near,
+                   const double _far, const common::Time &_time);
+
+      /// \brief Publish the points seen by the camera, in the optical
+      /// frame of the camera: x right, y down and z forward.
+      /// \param[in] _points Points as x, y, z and an unused float, as
+      /// rendered by the depth camera. Null to compute the points from
+      /// _depth.
+      /// \param[in] _depth Depths along the optical axis, row after row.
+      /// Only used if _points is null.
+      /// \param[in] _image Image whose colors are given to the points, or
+      /// null.
+      /// \param[in] _imageDepth Number of bytes per pixel of the image.
+      /// \param[in] _width Width of the image.
+      /// \param[in] _height Height of the image.
+      /// \param[in] _hfov Horizontal field of view of the camera.
+      /// \param[in] _near Near clip distance.
+      /// \param[in] _far Far clip distance.
+      /// \param[in] _time Time the points were captured at.
+      private: void PublishPoints(const float *_points, const float *_depth,
+                   const unsigned char *_image,
+                   const unsigned int _imageDepth,
+                   const unsigned int _width, const unsigned int _height,
+                   const double _hfov, const double _near,
+                   const double _far, const common::Time &_time);
+
+      /// \brief Callback with the points of the depth camera.
+      /// \param[in] _pcd Points as x, y, z and an unused float.
+      /// \param[in] _width Width of the image.
+      /// \param[in] _height Height of the image.
+      /// \param[in] _depth Depth of the image.
+      /// \param[in] _format Format of the points.
+      private: void OnNewRGBPointCloud(const float *_pcd,
+                   const unsigned int _width, const unsigned int _height,
+                   const unsigned int _depth, const std::string &_format);
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<DepthCameraSensorPrivate> dataPtr;
@@ -17,7 +17,14 @@
 #ifndef _GAZEBO_SENSORS_DEPTHCAMERASENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_DEPTHCAMERASENSOR_PRIVATE_HH_
 
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/Event.hh"
 #include "gazebo/rendering/RenderTypes.hh"
+#include "gazebo/transport/TransportTypes.hh"
 
 namespace gazebo
 {
@@ -32,6 +39,30 @@ namespace gazebo
 
       /// \brief Local pointer to the depthCamera.
       public: rendering::DepthCameraPtr depthCamera;
+
+      /// \brief Publisher of point clouds.
+      public: transport::PublisherPtr pointsPub;
+
+      /// \brief Connection to the point clouds of the depth camera, when
+      /// it outputs points instead of depths.
+      public: event::ConnectionPtr pointCloudConnection;
+
+      /// \brief Last point cloud of the depth camera, owned by the camera.
+      public: const float *pointCloud = nullptr;
+
+      /// \brief Protects the point cloud settings.
+      public: std::mutex pointCloudMutex;
+
+      /// \brief True if the points have the colors of the image.
+      public: bool pointCloudColored = false;
+
+      /// \brief Size of the voxels the point clouds are downsampled with,
+      /// zero to publish organized clouds.
+      public: double pointCloudVoxelSize = 0.0;
+
+      /// \brief Voxel of each point and index of the point, kept between
+      /// updates to avoid allocations.
+      public: std::vector<std::pair<uint64_t, uint32_t>> voxels;
     };
   }
 }
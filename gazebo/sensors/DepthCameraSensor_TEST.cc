@@ -273,6 +273,100 @@ TEST_F(DepthCameraSensor_normals_TEST, CreateDepthCamera)
   depthCamera.reset();
 }
 
+class DepthCameraSensor_points_TEST : public ServerFixture
+{
+};
+
+std::mutex g_pointsMutex;
+unsigned int g_pointsCounter = 0;
+msgs::PointCloud g_pointsMsg;
+
+/////////////////////////////////////////////////
+void OnPoints(ConstPointCloudPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_pointsMutex);
+  g_pointsMsg = *_msg;
+  g_pointsCounter++;
+}
+
+/////////////////////////////////////////////////
+/// \brief Test the point clouds published by a depth camera sensor
+TEST_F(DepthCameraSensor_points_TEST, PointCloud)
+{
+  Load("worlds/depth_camera.world");
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+
+  std::string sensorName = "default::camera_model::my_link::camera";
+  sensors::DepthCameraSensorPtr sensor =
+     std::dynamic_pointer_cast<sensors::DepthCameraSensor>
+     (mgr->GetSensor(sensorName));
+  ASSERT_NE(nullptr, sensor);
+
+  EXPECT_FALSE(sensor->PointCloudColored());
+  EXPECT_DOUBLE_EQ(0.0, sensor->PointCloudVoxelSize());
+  sensor->SetPointCloudColored(true);
+  EXPECT_TRUE(sensor->PointCloudColored());
+
+  transport::SubscriberPtr sub =
+      this->node->Subscribe(sensor->PointCloudTopic(), &OnPoints);
+
+  // wait for a few point clouds
+  unsigned int cloudsToWait = 5;
+  int i = 0;
+  while (i < 300 && g_pointsCounter < cloudsToWait)
+  {
+    common::Time::MSleep(20);
+    i++;
+  }
+  EXPECT_GE(g_pointsCounter, cloudsToWait);
+
+  {
+    std::lock_guard<std::mutex> lock(g_pointsMutex);
+
+    // one point per pixel, x right, y down and z forward
+    EXPECT_EQ(sensor->ImageWidth(), g_pointsMsg.width());
+    EXPECT_EQ(sensor->ImageHeight(), g_pointsMsg.height());
+    EXPECT_EQ(16u, g_pointsMsg.point_step());
+    EXPECT_TRUE(g_pointsMsg.rgb());
+    ASSERT_EQ(g_pointsMsg.width() * g_pointsMsg.height() * 16u,
+        g_pointsMsg.data().size());
+
+    // sphere with radius 1m is at 2m in front of depth camera
+    const float *points =
+        reinterpret_cast<const float *>(g_pointsMsg.data().data());
+    unsigned int center = (g_pointsMsg.height() / 2) * g_pointsMsg.width() +
+        g_pointsMsg.width() / 2;
+    EXPECT_NEAR(0.0, points[center * 4], 0.01);
+    EXPECT_NEAR(0.0, points[center * 4 + 1], 0.01);
+    EXPECT_NEAR(1.0, points[center * 4 + 2], 0.01);
+
+    // points on the left of the image have a negative x
+    unsigned int left = center - g_pointsMsg.width() / 4;
+    EXPECT_LT(points[left * 4], 0.0);
+  }
+
+  // downsampled clouds are not organized
+  sensor->SetPointCloudVoxelSize(0.1);
+  EXPECT_DOUBLE_EQ(0.1, sensor->PointCloudVoxelSize());
+  i = 0;
+  while (i < 300)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_pointsMutex);
+      if (g_pointsMsg.height() == 1u)
+        break;
+    }
+    common::Time::MSleep(20);
+    i++;
+  }
+
+  std::lock_guard<std::mutex> lock(g_pointsMutex);
+  EXPECT_EQ(1u, g_pointsMsg.height());
+  EXPECT_GT(g_pointsMsg.width(), 0u);
+  EXPECT_LT(g_pointsMsg.width(), sensor->ImageWidth() * sensor->ImageHeight());
+  EXPECT_EQ(g_pointsMsg.width() * 16u, g_pointsMsg.data().size());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -287,6 +287,12 @@ bool ForceTorqueSensor::IsActive() const
   return Sensor::IsActive() || this->dataPtr->wrenchPub->HasConnections();
 }
 
+//////////////////////////////////////////////////
+bool ForceTorqueSensor::HasListeners() const
+{
+  return Sensor::HasListeners() || this->dataPtr->update.ConnectionCount() > 0;
+}
+
 //////////////////////////////////////////////////
 event::ConnectionPtr ForceTorqueSensor::ConnectUpdate(
     std::function<void (msgs::WrenchStamped)> _subscriber)
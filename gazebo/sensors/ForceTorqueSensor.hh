@@ -76,6 +76,9 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
+      // Documentation inherited.
+      protected: virtual bool HasListeners() const override;
+
       /// \brief Connect a to the  update signal.
       /// \param[in] _subscriber Callback function.
       /// \return The connection, which must be kept in scope.
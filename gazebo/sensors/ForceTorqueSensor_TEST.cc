@@ -74,6 +74,17 @@ void ForceTorqueSensor_TEST::ForceTorqueTest(const std::string &_physicsEngine)
   EXPECT_EQ(sensor->Force(), ignition::math::Vector3d(0, 0, 0));
 
   EXPECT_TRUE(sensor->IsActive());
+
+  // A demand driven sensor is active while a callback is connected to its
+  // update event
+  mgr->SetDemandDriven(true);
+  EXPECT_FALSE(sensor->IsActive());
+  event::ConnectionPtr connection = sensor->ConnectUpdate(
+      [](msgs::WrenchStamped /*_msg*/) {});
+  EXPECT_TRUE(sensor->IsActive());
+  connection.reset();
+  mgr->SetDemandDriven(false);
+  EXPECT_TRUE(sensor->IsActive());
 }
 
 /////////////////////////////////////////////////
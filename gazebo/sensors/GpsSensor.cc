@@ -114,6 +114,13 @@ void GpsSensor::Fini()
   this->dataPtr->sphericalCoordinates.reset();
 }
 
+//////////////////////////////////////////////////
+bool GpsSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->gpsPub && this->dataPtr->gpsPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void GpsSensor::Init()
 {
@@ -16,6 +16,7 @@
 */
 #include <boost/algorithm/string.hpp>
 #include <ignition/common/Profiler.hh>
+#include <cmath>
 #include <functional>
 #include <ignition/math.hh>
 #include <ignition/math/Helpers.hh>
@@ -665,6 +666,15 @@ void GpuRaySensor::PrerenderEnded()
       dt = this->updatePeriod.Double();
     this->dataPtr->nextRenderingTime += dt;
 
+    // Skip the periods missed while the sensor didn't render, e.g. while
+    // it was inactive, instead of catching up with a frame per prerender
+    const double simTime = this->scene->SimTime().Double();
+    if (this->dataPtr->nextRenderingTime < simTime)
+    {
+      this->dataPtr->nextRenderingTime += dt * std::ceil(
+          (simTime - this->dataPtr->nextRenderingTime) / dt);
+    }
+
     this->dataPtr->renderNeeded = true;
     this->lastMeasurementTime = this->scene->SimTime();
   }
@@ -788,6 +798,13 @@ bool GpuRaySensor::IsActive() const
     (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
 }
 
+//////////////////////////////////////////////////
+bool GpuRaySensor::HasListeners() const
+{
+  return Sensor::HasListeners() || (this->dataPtr->laserCam &&
+      this->dataPtr->laserCam->NewLaserFrameConnectionCount() > 0);
+}
+
 //////////////////////////////////////////////////
 rendering::GpuLaserPtr GpuRaySensor::LaserCamera() const
 {
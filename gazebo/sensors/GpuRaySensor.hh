@@ -267,6 +267,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool IsActive() const override;
 
+      // Documentation inherited
+      protected: virtual bool HasListeners() const override;
+
       /// brief Render the camera.
       private: void Render();
 
@@ -110,33 +110,6 @@ void LogicalCameraSensor::Fini()
   Sensor::Fini();
 }
 
-//////////////////////////////////////////////////
-void LogicalCameraSensorPrivate::AddVisibleModels(
-    ignition::math::Pose3d &_myPose, const physics::Model_V &_models)
-{
-  for (auto const &model : _models)
-  {
-    auto const &scopedName = model->GetScopedName();
-    auto const aabb = model->BoundingBox();
-
-    if (this->modelName != scopedName && this->frustum.Contains(aabb))
-    {
-      // Add new model msg
-      msgs::LogicalCameraImage::Model *modelMsg = this->msg.add_model();
-
-      // Set the name and pose reported by the sensor.
-      modelMsg->set_name(scopedName);
-      msgs::Set(modelMsg->mutable_pose(),
-          model->WorldPose() - _myPose);
-    }
-    // Check nested models
-    // Note, the model AABB does not necessarily contain the nested model
-    // so nested models must be searched even if the frustum does not contain
-    // the parent model.
-    AddVisibleModels(_myPose, model->NestedModels());
-  }
-}
-
 //////////////////////////////////////////////////
 bool LogicalCameraSensor::UpdateImpl(const bool _force)
 {
@@ -158,8 +131,24 @@ bool LogicalCameraSensor::UpdateImpl(const bool _force)
     // Set the camera's pose in the message.
     msgs::Set(this->dataPtr->msg.mutable_pose(), myPose);
 
-    // Recursively check if models and nested models are in the frustum.
-    this->dataPtr->AddVisibleModels(myPose, this->world->Models());
+    // Find the models and nested models in the frustum. Note, the model AABB
+    // does not necessarily contain the nested models, which are tested
+    // separately.
+    for (auto const &model :
+        this->world->ModelsInFrustum(this->dataPtr->frustum))
+    {
+      auto const &scopedName = model->GetScopedName();
+      if (scopedName == this->dataPtr->modelName)
+        continue;
+
+      // Add new model msg
+      msgs::LogicalCameraImage::Model *modelMsg =
+        this->dataPtr->msg.add_model();
+
+      // Set the name and pose reported by the sensor.
+      modelMsg->set_name(scopedName);
+      msgs::Set(modelMsg->mutable_pose(), model->WorldPose() - myPose);
+    }
     IGN_PROFILE_END();
 
     IGN_PROFILE_BEGIN("Publish");
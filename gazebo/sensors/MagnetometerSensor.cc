@@ -119,6 +119,13 @@ void MagnetometerSensor::Fini()
   this->dataPtr->parentLink.reset();
 }
 
+//////////////////////////////////////////////////
+bool MagnetometerSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->magPub && this->dataPtr->magPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void MagnetometerSensor::Init()
 {
@@ -108,6 +108,13 @@ void RFIDSensor::Fini()
   Sensor::Fini();
 }
 
+//////////////////////////////////////////////////
+bool RFIDSensor::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void RFIDSensor::Init()
 {
@@ -66,6 +66,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Fini();
 
+      // Documentation inherited
+      public: virtual bool IsActive() const;
+
       /// \brief Iterates through all the RFID tags, and finds the ones which
       /// are in range of the sensor.
       private: void EvaluateTags();
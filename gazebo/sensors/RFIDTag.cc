@@ -84,6 +84,13 @@ void RFIDTag::Fini()
   this->dataPtr->entity.reset();
 }
 
+//////////////////////////////////////////////////
+bool RFIDTag::IsActive() const
+{
+  return Sensor::IsActive() ||
+    (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 void RFIDTag::Init()
 {
@@ -60,6 +60,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Fini();
 
+      // Documentation inherited
+      public: virtual bool IsActive() const;
+
       /// \brief Returns pose of tag in world coordinate.
       /// \return Pose of object.
       public: ignition::math::Pose3d TagPose() const;
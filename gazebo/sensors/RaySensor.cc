@@ -16,9 +16,13 @@
 */
 #include <boost/algorithm/string.hpp>
 
+#include <map>
+#include <mutex>
+
 #include <ignition/common/Profiler.hh>
 
 #include "gazebo/physics/World.hh"
+#include "gazebo/physics/CollisionBvh.hh"
 #include "gazebo/physics/MultiRayShape.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/PhysicsIface.hh"
@@ -42,6 +46,12 @@ using namespace sensors;
 
 GZ_REGISTER_STATIC_SENSOR("ray", RaySensor)
 
+/// \brief Collision hierarchies shared by the ray sensors, by world name.
+static std::map<std::string, std::weak_ptr<physics::CollisionBvh>> worldBvhs;
+
+/// \brief Protects worldBvhs.
+static std::mutex worldBvhsMutex;
+
 void RegisterLidarSensor()
 {
   SensorFactory::RegisterSensor("lidar", NewRaySensor);
@@ -522,3 +532,39 @@ physics::MultiRayShapePtr RaySensor::LaserShape() const
 {
   return this->dataPtr->laserShape;
 }
+
+//////////////////////////////////////////////////
+void RaySensor::SetUseCollisionBvh(const bool _enable)
+{
+  if (!this->dataPtr->laserShape || !this->world)
+    return;
+
+  if (!_enable)
+  {
+    this->dataPtr->laserShape->SetCollisionBvh(physics::CollisionBvhPtr());
+    return;
+  }
+
+  if (this->dataPtr->laserShape->Bvh())
+    return;
+
+  physics::CollisionBvhPtr bvh;
+  {
+    std::lock_guard<std::mutex> lock(worldBvhsMutex);
+    std::weak_ptr<physics::CollisionBvh> &shared =
+        worldBvhs[this->world->Name()];
+    bvh = shared.lock();
+    if (!bvh)
+    {
+      bvh.reset(new physics::CollisionBvh(this->world));
+      shared = bvh;
+    }
+  }
+  this->dataPtr->laserShape->SetCollisionBvh(bvh);
+}
+
+//////////////////////////////////////////////////
+bool RaySensor::UseCollisionBvh() const
+{
+  return this->dataPtr->laserShape && this->dataPtr->laserShape->Bvh();
+}
@@ -164,6 +164,20 @@ namespace gazebo
       /// \return Pointer to ray shape
       public: physics::MultiRayShapePtr LaserShape() const;
 
+      /// \brief Cast the rays against a bounding volume hierarchy of the
+      /// collisions of the world, on several threads, instead of going
+      /// through the collision library of the physics engine. The hierarchy
+      /// is shared by the ray sensors of a world. The ranges, retro and
+      /// fiducial values are the same.
+      /// \param[in] _enable True to use the hierarchy.
+      /// \sa physics::CollisionBvh
+      public: void SetUseCollisionBvh(const bool _enable);
+
+      /// \brief Get whether the rays are cast against a bounding volume
+      /// hierarchy of the collisions of the world.
+      /// \return True if the hierarchy is used.
+      public: bool UseCollisionBvh() const;
+
       // Documentation inherited
       public: virtual bool IsActive() const;
 
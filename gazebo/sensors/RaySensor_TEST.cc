@@ -16,8 +16,10 @@
 */
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <ignition/math/Helpers.hh>
 #include <sdf/sdf.hh>
+#include "gazebo/physics/physics.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -198,6 +200,102 @@ TEST_F(RaySensor_TEST, LaserScanResolution)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that a ray sensor casting rays against a hierarchy of the
+/// collisions gets the same values as the physics engine
+TEST_F(RaySensor_TEST, CollisionBvh)
+{
+  Load("worlds/empty.world", true);
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // A static box in front, a sphere on the left and a cylinder lying along
+  // the X axis behind, so that the rays hit its cap
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(2, 0, 0), ignition::math::Vector3d::Zero,
+      true);
+  SpawnSphere("sphere", ignition::math::Vector3d(0, 3, 0),
+      ignition::math::Vector3d::Zero);
+  SpawnCylinder("cylinder", ignition::math::Vector3d(-3, 0, 0),
+      ignition::math::Vector3d(0, IGN_PI * 0.5, 0));
+
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+  box->GetLink("body")->GetCollision("geom")->SetLaserRetro(100);
+
+  sdf::ElementPtr sdf(new sdf::Element);
+  sdf::initFile("sensor.sdf", sdf);
+  sdf::readString(raySensorString, sdf);
+
+  std::string sensorName = mgr->CreateSensor(sdf, "default",
+      "ground_plane::link", 0);
+  mgr->Update();
+
+  sensors::RaySensorPtr sensor = std::dynamic_pointer_cast<sensors::RaySensor>
+    (mgr->GetSensor(sensorName));
+  ASSERT_TRUE(sensor != nullptr);
+  EXPECT_FALSE(sensor->UseCollisionBvh());
+
+  // Cast the rays with the physics engine
+  sensor->Update(true);
+  std::vector<double> ranges;
+  sensor->Ranges(ranges);
+  ASSERT_EQ(ranges.size(), static_cast<size_t>(640));
+
+  std::vector<double> retros;
+  for (unsigned int i = 0; i < ranges.size(); ++i)
+    retros.push_back(sensor->Retro(i));
+
+  // The box, the sphere and the cylinder are seen
+  const unsigned int center = ranges.size() / 2;
+  EXPECT_NEAR(1.5, ranges[center], 1e-4);
+  EXPECT_NEAR(100, retros[center], 1e-6);
+  unsigned int hits = 0;
+  for (auto const &range : ranges)
+  {
+    if (!std::isinf(range))
+      ++hits;
+  }
+  EXPECT_GT(hits, 100u);
+
+  // Cast the same rays against the hierarchy
+  sensor->SetUseCollisionBvh(true);
+  EXPECT_TRUE(sensor->UseCollisionBvh());
+  sensor->Update(true);
+
+  std::vector<double> bvhRanges;
+  sensor->Ranges(bvhRanges);
+  ASSERT_EQ(ranges.size(), bvhRanges.size());
+  for (unsigned int i = 0; i < ranges.size(); ++i)
+  {
+    if (std::isinf(ranges[i]))
+      EXPECT_DOUBLE_EQ(ranges[i], bvhRanges[i]) << i;
+    else
+      EXPECT_NEAR(ranges[i], bvhRanges[i], 1e-6) << i;
+    EXPECT_NEAR(retros[i], sensor->Retro(i), 1e-6) << i;
+    EXPECT_EQ(-1, sensor->Fiducial(i));
+  }
+
+  // Moving the sphere refits the hierarchy
+  physics::ModelPtr sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(sphere != nullptr);
+  sphere->SetWorldPose(ignition::math::Pose3d(0, 5, 0, 0, 0, 0));
+  world->Step(1);
+
+  sensor->Update(true);
+  sensor->Ranges(bvhRanges);
+  const unsigned int left = static_cast<unsigned int>(std::round(
+      (IGN_PI * 0.5 - sensor->AngleMin().Radian()) /
+      sensor->AngleResolution()));
+  EXPECT_NEAR(2.5, ranges[left], 0.05);
+  EXPECT_NEAR(4.5, bvhRanges[left], 0.05);
+
+  sensor->SetUseCollisionBvh(false);
+  EXPECT_FALSE(sensor->UseCollisionBvh());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
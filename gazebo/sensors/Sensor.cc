@@ -14,7 +14,12 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "ignition/common/Profiler.hh"
+#include "ignition/math/Helpers.hh"
 
 #include "gazebo/transport/transport.hh"
 
@@ -140,7 +145,10 @@ void Sensor::Load(const std::string &_worldName)
   }
 
   if (this->sdf->Get<bool>("always_on"))
+  {
     this->SetActive(true);
+    this->dataPtr->alwaysOn = true;
+  }
 
   this->useStrictRate = rendering::lockstep_enabled();
 
@@ -236,19 +244,24 @@ void Sensor::Update(const bool _force)
 {
   if (this->IsActive() || _force)
   {
+    common::Time simTime;
+    if (this->dataPtr->category == IMAGE && this->scene)
+      simTime = this->scene->SimTime();
+    else
+      simTime = this->world->SimTime();
+
     if (this->useStrictRate)
     {
+      common::Timer timer;
+      timer.Start();
       if (this->UpdateImpl(_force))
+      {
+        this->RecordUpdate(simTime, timer.GetElapsed());
         this->updated();
+      }
     }
     else
     {
-      common::Time simTime;
-      if (this->dataPtr->category == IMAGE && this->scene)
-        simTime = this->scene->SimTime();
-      else
-        simTime = this->world->SimTime();
-
       {
         std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
 
@@ -276,14 +289,37 @@ void Sensor::Update(const bool _force)
           this->dataPtr->updateDelay = common::Time::Zero;
       }
 
+      common::Timer timer;
+      timer.Start();
       if (this->UpdateImpl(_force))
       {
+        this->RecordUpdate(simTime, timer.GetElapsed());
         std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
         this->lastUpdateTime = simTime;
         this->updated();
       }
     }
   }
+  else if (this->dataPtr->demandDriven && this->dataPtr->alwaysOn)
+  {
+    common::Time simTime;
+    if (this->dataPtr->category == IMAGE && this->scene)
+      simTime = this->scene->SimTime();
+    else
+      simTime = this->world->SimTime();
+
+    // Count the updates which would have happened at the update rate
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+    if (simTime < this->dataPtr->lastSkipTime)
+      this->dataPtr->lastSkipTime = common::Time::Zero;
+
+    if (simTime > this->dataPtr->lastSkipTime &&
+        simTime - this->dataPtr->lastSkipTime >= this->updatePeriod)
+    {
+      this->dataPtr->lastSkipTime = simTime;
+      ++this->dataPtr->skippedUpdates;
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -354,14 +390,45 @@ void Sensor::LoadPlugin(sdf::ElementPtr _sdf)
 void Sensor::SetActive(const bool _value)
 {
   this->active = _value;
+  this->dataPtr->alwaysOn = false;
 }
 
 //////////////////////////////////////////////////
 bool Sensor::IsActive() const
 {
+  // Sensors with publishers also override this function to be active while
+  // their topics have subscribers
+  if (this->dataPtr->demandDriven && this->dataPtr->alwaysOn)
+    return this->HasListeners();
+
   return this->active;
 }
 
+//////////////////////////////////////////////////
+bool Sensor::HasListeners() const
+{
+  return this->updated.ConnectionCount() > 0 || !this->plugins.empty();
+}
+
+//////////////////////////////////////////////////
+void Sensor::SetDemandDriven(const bool _demandDriven)
+{
+  this->dataPtr->demandDriven = _demandDriven;
+}
+
+//////////////////////////////////////////////////
+bool Sensor::DemandDriven() const
+{
+  return this->dataPtr->demandDriven;
+}
+
+//////////////////////////////////////////////////
+uint64_t Sensor::SkippedUpdateCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+  return this->dataPtr->skippedUpdates;
+}
+
 //////////////////////////////////////////////////
 ignition::math::Pose3d Sensor::Pose() const
 {
@@ -391,8 +458,8 @@ void Sensor::SetPose(const ignition::math::Pose3d &_pose)
 //////////////////////////////////////////////////
 double Sensor::UpdateRate() const
 {
-  if (this->updatePeriod.Double() > 0.0)
-    return 1.0/this->updatePeriod.Double();
+  if (this->dataPtr->requestedPeriod.Double() > 0.0)
+    return 1.0/this->dataPtr->requestedPeriod.Double();
   else
     return 0.0;
 }
@@ -401,9 +468,122 @@ double Sensor::UpdateRate() const
 void Sensor::SetUpdateRate(const double _hz)
 {
   if (_hz > 0.0)
-    this->updatePeriod = 1.0/_hz;
+    this->dataPtr->requestedPeriod = 1.0/_hz;
   else
-    this->updatePeriod = 0.0;
+    this->dataPtr->requestedPeriod = 0.0;
+
+  this->updatePeriod = this->dataPtr->requestedPeriod;
+  if (this->dataPtr->updateRateLimit > 0.0)
+  {
+    this->updatePeriod = std::max(this->updatePeriod,
+        common::Time(1.0/this->dataPtr->updateRateLimit));
+  }
+}
+
+//////////////////////////////////////////////////
+void Sensor::SetUpdateRateLimit(const double _hz)
+{
+  this->dataPtr->updateRateLimit = std::max(0.0, _hz);
+  this->SetUpdateRate(this->UpdateRate());
+}
+
+//////////////////////////////////////////////////
+double Sensor::UpdateRateLimit() const
+{
+  return this->dataPtr->updateRateLimit;
+}
+
+//////////////////////////////////////////////////
+void Sensor::SetPriority(const int _priority)
+{
+  this->dataPtr->priority = _priority;
+}
+
+//////////////////////////////////////////////////
+int Sensor::Priority() const
+{
+  return this->dataPtr->priority;
+}
+
+//////////////////////////////////////////////////
+double Sensor::MeasuredUpdateRate() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStatistics);
+  return this->dataPtr->measuredRate;
+}
+
+//////////////////////////////////////////////////
+common::Time Sensor::MeanUpdateWallTime() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStatistics);
+  return this->dataPtr->meanWallTime;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &Sensor::UpdateLatencyBounds()
+{
+  static const std::vector<double> bounds = {
+      1e-5, 2e-5, 5e-5, 1e-4, 2e-4, 5e-4, 1e-3, 2e-3, 5e-3,
+      1e-2, 2e-2, 5e-2, 1e-1, 2e-1, 5e-1, 1.0};
+  return bounds;
+}
+
+//////////////////////////////////////////////////
+std::vector<uint64_t> Sensor::UpdateLatencyCounts() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStatistics);
+  if (this->dataPtr->latencyCounts.empty())
+    return std::vector<uint64_t>(UpdateLatencyBounds().size() + 1, 0);
+  return this->dataPtr->latencyCounts;
+}
+
+//////////////////////////////////////////////////
+void Sensor::AddUpdateWallTime(const common::Time &_wallTime)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStatistics);
+  this->dataPtr->pendingWallTime += _wallTime;
+}
+
+//////////////////////////////////////////////////
+void Sensor::RecordUpdate(const common::Time &_simTime,
+    const common::Time &_wallTime)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexStatistics);
+
+  const common::Time wallTime = _wallTime + this->dataPtr->pendingWallTime;
+  this->dataPtr->pendingWallTime = common::Time::Zero;
+
+  const std::vector<double> &bounds = UpdateLatencyBounds();
+  if (this->dataPtr->latencyCounts.empty())
+    this->dataPtr->latencyCounts.resize(bounds.size() + 1, 0);
+  const size_t bin = std::lower_bound(bounds.begin(), bounds.end(),
+      wallTime.Double()) - bounds.begin();
+  ++this->dataPtr->latencyCounts[bin];
+
+  // The world was reset
+  if (_simTime < this->dataPtr->windowStart)
+  {
+    this->dataPtr->windowStart = common::Time::Zero;
+    this->dataPtr->windowUpdates = 0;
+    this->dataPtr->windowWallTime = common::Time::Zero;
+  }
+
+  // The rate and cost of the updates are measured over windows of one
+  // second of simulation time
+  ++this->dataPtr->windowUpdates;
+  this->dataPtr->windowWallTime += wallTime;
+
+  const double elapsed = (_simTime - this->dataPtr->windowStart).Double();
+  if (elapsed >= 1.0)
+  {
+    this->dataPtr->measuredRate = this->dataPtr->windowUpdates / elapsed;
+    this->dataPtr->meanWallTime = this->dataPtr->windowWallTime.Double() /
+        this->dataPtr->windowUpdates;
+
+    this->dataPtr->windowStart = _simTime;
+    this->dataPtr->windowUpdates = 0;
+    this->dataPtr->windowWallTime = common::Time::Zero;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -418,6 +598,33 @@ common::Time Sensor::LastMeasurementTime() const
   return this->lastMeasurementTime;
 }
 
+//////////////////////////////////////////////////
+bool Sensor::UpdateDue() const
+{
+  if (!this->world)
+    return false;
+
+  common::Time simTime = this->world->SimTime();
+
+  // The world was reset, NeedsUpdate resets the last update time
+  if (simTime < this->lastMeasurementTime)
+    return true;
+
+  // Sensors following a strict rate are due at their next rendering time,
+  // which the world waits for
+  const double next = this->NextRequiredTimestamp();
+  if (this->useStrictRate && !std::isnan(next))
+  {
+    return ignition::math::lessOrNearEqual(
+        next - this->world->Physics()->GetMaxStepSize() / 2.0,
+        simTime.Double());
+  }
+
+  return simTime > this->lastMeasurementTime &&
+      (simTime - this->lastMeasurementTime + this->dataPtr->updateDelay) >=
+      this->updatePeriod;
+}
+
 //////////////////////////////////////////////////
 std::string Sensor::Type() const
 {
@@ -520,6 +727,7 @@ void Sensor::ResetLastUpdateTime()
   this->lastUpdateTime = 0.0;
   this->lastMeasurementTime = 0.0;
   this->dataPtr->updateDelay = 0.0;
+  this->dataPtr->lastSkipTime = 0.0;
 }
 
 //////////////////////////////////////////////////
@@ -93,6 +93,56 @@ namespace gazebo
       /// \param[in] _hz update rate of sensor.
       public: void SetUpdateRate(const double _hz);
 
+      /// \brief Limit the update rate of the sensor below the rate set with
+      /// SetUpdateRate. The SensorManager sets this limit to fit its CPU
+      /// budget.
+      /// \param[in] _hz Maximum update rate, 0 for no limit.
+      /// \sa SensorManager::SetCpuBudget
+      public: void SetUpdateRateLimit(const double _hz);
+
+      /// \brief Get the limit of the update rate.
+      /// \return Maximum update rate, 0 if there is no limit.
+      public: double UpdateRateLimit() const;
+
+      /// \brief Set the priority of the sensor. When the SensorManager has
+      /// a CPU budget, the update rates of the sensors with the lowest
+      /// priorities are limited first.
+      /// \param[in] _priority Priority of the sensor, 0 by default.
+      /// \sa SensorManager::SetCpuBudget
+      public: void SetPriority(const int _priority);
+
+      /// \brief Get the priority of the sensor.
+      /// \return Priority of the sensor.
+      public: int Priority() const;
+
+      /// \brief Get the update rate measured over the last second of
+      /// simulation time.
+      /// \return Updates per second of simulation time.
+      public: double MeasuredUpdateRate() const;
+
+      /// \brief Get the mean wall time of an update over the last second of
+      /// simulation time. The rendering of a frame is shared between the
+      /// rendering sensors updated from it.
+      /// \return Mean wall time of an update.
+      public: common::Time MeanUpdateWallTime() const;
+
+      /// \brief Get the upper bounds of the bins of the latency histograms,
+      /// from 10 us to 1 s.
+      /// \return Upper bound of each bin, in seconds.
+      /// \sa UpdateLatencyCounts
+      public: static const std::vector<double> &UpdateLatencyBounds();
+
+      /// \brief Get the histogram of the wall time taken by the updates of
+      /// the sensor since it was loaded.
+      /// \return Number of updates in each bin of UpdateLatencyBounds,
+      /// followed by the number of updates slower than the last bound.
+      public: std::vector<uint64_t> UpdateLatencyCounts() const;
+
+      /// \brief Add wall time spent on the sensor outside of Update, such
+      /// as rendering, to the latency of its next update.
+      /// \param[in] _wallTime Wall time spent on the sensor.
+      public: void AddUpdateWallTime(const common::Time &_wallTime);
+
       /// \brief Finalize the sensor.
       public: virtual void Fini();
 
@@ -122,6 +172,28 @@ namespace gazebo
       /// \return True if active, false if not.
       public: virtual bool IsActive() const;
 
+      /// \brief Set whether the sensor is demand driven. A demand driven
+      /// sensor which is only active because of <always_on> skips its
+      /// updates while nothing consumes its data: no subscriber to its
+      /// topics, no callback connected with ConnectUpdated or to the events
+      /// of the sensor type, and no sensor plugin, see HasListeners. It
+      /// resumes on the next update after something does.
+      /// Sensors activated with SetActive always update.
+      /// \param[in] _demandDriven True to make the sensor demand driven.
+      /// \sa SensorManager::SetDemandDriven
+      public: void SetDemandDriven(const bool _demandDriven);
+
+      /// \brief Get whether the sensor is demand driven.
+      /// \return True if the sensor is demand driven.
+      /// \sa SetDemandDriven
+      public: bool DemandDriven() const;
+
+      /// \brief Get the number of updates skipped by a demand driven sensor
+      /// because nothing consumed its data, counted at the update rate of
+      /// the sensor.
+      /// \return Number of skipped updates.
+      public: uint64_t SkippedUpdateCount() const;
+
       /// \brief Get sensor type.
       /// \return Type of sensor.
       public: std::string Type() const;
@@ -134,6 +206,14 @@ namespace gazebo
       /// \return Time of last measurement.
       public: common::Time LastMeasurementTime() const;
 
+      /// \brief Get whether the update period of the sensor has elapsed at
+      /// the current simulation time of the world. Rendering sensors measure
+      /// time with the scene, which lags the world, so a rendering sensor
+      /// which isn't due at world time won't update either. A sensor
+      /// following a strict rate is due at its NextRequiredTimestamp.
+      /// \return True if the sensor is due to update.
+      public: bool UpdateDue() const;
+
       /// \brief Return true if user requests the sensor to be visualized
       ///        via tag:  <visualize>true</visualize> in SDF.
       /// \return True if visualized, false if not.
@@ -201,10 +281,25 @@ namespace gazebo
       /// \return True when sensor should be updated.
       protected: virtual bool NeedsUpdate();
 
+      /// \brief Get whether something consumes the data of the sensor other
+      /// than the subscribers to its topics. Sensor types with their own
+      /// events override it to count the callbacks connected to them.
+      /// \return True if a callback is connected with ConnectUpdated or a
+      /// sensor plugin is loaded.
+      /// \sa SetDemandDriven
+      protected: virtual bool HasListeners() const;
+
       /// \brief Load a plugin for this sensor.
       /// \param[in] _sdf SDF parameters.
       private: void LoadPlugin(sdf::ElementPtr _sdf);
 
+      /// \brief Add an update to the latency histogram and to the
+      /// measured update rate.
+      /// \param[in] _simTime Simulation time of the update.
+      /// \param[in] _wallTime Wall time taken by the update.
+      private: void RecordUpdate(const common::Time &_simTime,
+                   const common::Time &_wallTime);
+
       /// \brief Whether to enforce strict sensor update rate, even if physics
       ///        time has to slow down to wait for sensor updates to satisfy
       ///        the desired rate.
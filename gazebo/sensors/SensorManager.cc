@@ -16,18 +16,25 @@
 */
 #include "ignition/common/Profiler.hh"
 
+#include <algorithm>
 #include <functional>
 #include <boost/bind.hpp>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/common/Timer.hh"
 
 #include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/RenderEngine.hh"
+#include "gazebo/rendering/RenderingIface.hh"
+#include "gazebo/rendering/Scene.hh"
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/sensors/SensorsIface.hh"
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/transport/Node.hh"
 #include "gazebo/util/LogPlay.hh"
 
 using namespace gazebo;
@@ -134,11 +141,15 @@ void SensorManager::Update(bool _force)
   {
     boost::recursive_mutex::scoped_lock lock(this->mutex);
 
-    if (this->worlds.empty() && physics::worlds_running() && this->initialized)
+    // Every world of the server waits for the sensors before loading its
+    // plugins, including worlds without sensors
+    if (this->initialized && physics::worlds_running())
     {
-      auto world = physics::get_world();
-      this->worlds[world->Name()] = world;
-      world->_SetSensorsInitialized(true);
+      for (auto const &world : physics::get_worlds())
+      {
+        if (this->worlds.emplace(world->Name(), world).second)
+          world->_SetSensorsInitialized(true);
+      }
     }
 
     if (!this->initSensors.empty())
@@ -200,6 +211,8 @@ void SensorManager::Update(bool _force)
     }
   }
 
+  this->UpdateDiagnostics();
+
   // Only update if there are sensors
   if (this->sensorContainers[sensors::IMAGE]->sensors.size() > 0)
     this->sensorContainers[sensors::IMAGE]->Update(_force);
@@ -225,6 +238,183 @@ void SensorManager::ResetLastUpdateTimes()
   }
 }
 
+//////////////////////////////////////////////////
+void SensorManager::SetDemandDriven(const bool _demandDriven)
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  this->demandDriven = _demandDriven;
+
+  for (auto &sensor : this->GetSensors())
+    sensor->SetDemandDriven(_demandDriven);
+
+  for (auto &sensor : this->initSensors)
+    sensor->SetDemandDriven(_demandDriven);
+}
+
+//////////////////////////////////////////////////
+bool SensorManager::DemandDriven() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  return this->demandDriven;
+}
+
+//////////////////////////////////////////////////
+void SensorManager::SetCpuBudget(const double _budget)
+{
+  // In lockstep the sensors keep their rates by slowing down the world
+  if (_budget > 0 && rendering::lockstep_enabled())
+  {
+    gzerr << "A CPU budget can't be set for the sensors while lockstep is "
+          << "enabled" << std::endl;
+    return;
+  }
+
+  this->cpuBudget = std::max(0.0, _budget);
+
+  // Lift the limits right away, the next diagnostics set them again
+  if (this->cpuBudget <= 0)
+  {
+    for (auto &sensor : this->GetSensors())
+      sensor->SetUpdateRateLimit(0);
+  }
+}
+
+//////////////////////////////////////////////////
+double SensorManager::CpuBudget() const
+{
+  return this->cpuBudget;
+}
+
+//////////////////////////////////////////////////
+void SensorManager::UpdateDiagnostics()
+{
+  common::Time wallTime = common::Time::GetWallTime();
+  if (wallTime - this->diagnosticsTime < common::Time(1.0))
+    return;
+  this->diagnosticsTime = wallTime;
+
+  Sensor_V sensors = this->GetSensors();
+
+  const double budget = this->cpuBudget;
+  if (budget > 0)
+  {
+    // Lowest update rate a budget imposes
+    const double minRate = 1.0;
+
+    std::stable_sort(sensors.begin(), sensors.end(),
+        [](const SensorPtr &_a, const SensorPtr &_b)
+        {
+          return _a->Priority() > _b->Priority();
+        });
+
+    // Hand out the budget from the highest priority down. The sensors of
+    // a priority share what is left in proportion of their needs.
+    double remaining = budget;
+    auto group = sensors.begin();
+    while (group != sensors.end())
+    {
+      const int priority = (*group)->Priority();
+      auto groupEnd = std::find_if(group, sensors.end(),
+          [priority](const SensorPtr &_sensor)
+          {
+            return _sensor->Priority() != priority;
+          });
+
+      // Wall time the sensors need per second of simulation time at their
+      // requested rates. A sensor without an update rate would take a
+      // whole core.
+      double demand = 0;
+      for (auto iter = group; iter != groupEnd; ++iter)
+      {
+        const double cost = (*iter)->MeanUpdateWallTime().Double();
+        if ((*iter)->IsActive() && cost > 0)
+        {
+          const double rate = (*iter)->UpdateRate();
+          demand += rate > 0 ? cost * rate : 1.0;
+        }
+      }
+
+      const double scale = demand > remaining ? remaining / demand : 1.0;
+      for (auto iter = group; iter != groupEnd; ++iter)
+      {
+        const double cost = (*iter)->MeanUpdateWallTime().Double();
+        if (!(*iter)->IsActive() || cost <= 0 || scale >= 1.0)
+        {
+          (*iter)->SetUpdateRateLimit(0);
+          continue;
+        }
+
+        const double rate = (*iter)->UpdateRate() > 0 ?
+            (*iter)->UpdateRate() : 1.0 / cost;
+        const double limit =
+            std::max(rate * scale, std::min(rate, minRate));
+        (*iter)->SetUpdateRateLimit(limit);
+        remaining -= cost * limit;
+      }
+
+      if (scale >= 1.0)
+        remaining -= demand;
+      remaining = std::max(0.0, remaining);
+      group = groupEnd;
+    }
+  }
+
+  std::map<std::string, physics::WorldPtr> worlds;
+  {
+    boost::recursive_mutex::scoped_lock lock(this->mutex);
+    worlds = this->worlds;
+  }
+
+  for (auto const &world : worlds)
+  {
+    if (!world.second)
+      continue;
+
+    transport::PublisherPtr &pub = this->diagnosticsPubs[world.first];
+    if (!pub)
+    {
+      if (!this->diagnosticsNode)
+      {
+        this->diagnosticsNode = transport::NodePtr(new transport::Node());
+        this->diagnosticsNode->Init(world.first);
+      }
+      pub = this->diagnosticsNode->Advertise<msgs::SensorDiagnostics>(
+          "/gazebo/" + world.first + "/sensor_diagnostics");
+    }
+
+    if (!pub->HasConnections())
+      continue;
+
+    msgs::SensorDiagnostics msg;
+    msgs::Set(msg.mutable_time(), world.second->SimTime());
+    msg.set_cpu_budget(budget);
+    for (auto const bound : Sensor::UpdateLatencyBounds())
+      msg.add_latency_bound(bound);
+
+    double usage = 0;
+    for (auto const &sensor : sensors)
+    {
+      if (sensor->WorldName() != world.first)
+        continue;
+
+      auto sensorMsg = msg.add_sensor();
+      sensorMsg->set_name(sensor->ScopedName());
+      sensorMsg->set_priority(sensor->Priority());
+      sensorMsg->set_requested_rate(sensor->UpdateRate());
+      sensorMsg->set_rate_limit(sensor->UpdateRateLimit());
+      sensorMsg->set_actual_rate(sensor->MeasuredUpdateRate());
+      sensorMsg->set_mean_latency(sensor->MeanUpdateWallTime().Double());
+      for (auto const count : sensor->UpdateLatencyCounts())
+        sensorMsg->add_latency_count(count);
+
+      usage += sensorMsg->actual_rate() * sensorMsg->mean_latency();
+    }
+    msg.set_cpu_usage(usage);
+
+    pub->Publish(msg);
+  }
+}
+
 //////////////////////////////////////////////////
 double SensorManager::NextRequiredTimestamp()
 {
@@ -296,6 +486,11 @@ void SensorManager::Fini()
   this->initSensors.clear();
   this->worlds.clear();
 
+  this->diagnosticsPubs.clear();
+  if (this->diagnosticsNode)
+    this->diagnosticsNode->Fini();
+  this->diagnosticsNode.reset();
+
   delete this->simTimeEventHandler;
   this->simTimeEventHandler = nullptr;
 
@@ -335,6 +530,11 @@ std::string SensorManager::CreateSensor(sdf::ElementPtr _elem,
   // Must come before sensor->Load
   sensor->SetParent(_parentName, _parentId);
 
+  {
+    boost::recursive_mutex::scoped_lock lock(this->mutex);
+    sensor->SetDemandDriven(this->demandDriven);
+  }
+
   // Load the sensor
   sensor->Load(_worldName, _elem);
   this->worlds[_worldName] = physics::get_world(_worldName);
@@ -809,6 +1009,30 @@ void SensorManager::SensorContainer::RemoveSensors()
 //////////////////////////////////////////////////
 void SensorManager::ImageSensorContainer::Update(bool _force)
 {
+  // Render a frame only when a sensor needs one. The sensors which are due
+  // at the same time then render in one batch, after a single update of the
+  // poses of the scene, instead of paying for a frame on every loop.
+  if (!_force && !this->RenderNeeded())
+  {
+    SensorContainer::Update(_force);
+    return;
+  }
+
+  // The sensors rendered in this frame share its wall time in their update
+  // latencies
+  Sensor_V rendered;
+  {
+    boost::recursive_mutex::scoped_lock lock(this->mutex);
+    for (auto const &sensor : this->sensors)
+    {
+      if (sensor->IsActive() && sensor->UpdateDue())
+        rendered.push_back(sensor);
+    }
+  }
+
+  common::Timer timer;
+  timer.Start();
+
   // Prerender phase
   event::Events::preRender();
 
@@ -823,10 +1047,45 @@ void SensorManager::ImageSensorContainer::Update(bool _force)
 
   event::Events::postRender();
 
+  if (!rendered.empty())
+  {
+    const common::Time share = timer.GetElapsed().Double() / rendered.size();
+    for (auto const &sensor : rendered)
+      sensor->AddUpdateWallTime(share);
+  }
+
   // Update the sensors, which will produce data messages.
   SensorContainer::Update(_force);
 }
 
+//////////////////////////////////////////////////
+bool SensorManager::ImageSensorContainer::RenderNeeded() const
+{
+  {
+    boost::recursive_mutex::scoped_lock lock(this->mutex);
+    for (auto const &sensor : this->sensors)
+    {
+      if (sensor->IsActive() && sensor->UpdateDue())
+        return true;
+    }
+  }
+
+  // Cameras which aren't owned by a sensor render on every frame
+  rendering::RenderEngine *engine = rendering::RenderEngine::Instance();
+  for (unsigned int i = 0; i < engine->SceneCount(); ++i)
+  {
+    rendering::ScenePtr scene = engine->GetScene(i);
+    for (uint32_t j = 0; scene && j < scene->CameraCount(); ++j)
+    {
+      rendering::CameraPtr camera = scene->GetCamera(j);
+      if (camera && camera->AutoRender())
+        return true;
+    }
+  }
+
+  return false;
+}
+
 //////////////////////////////////////////////////
 bool SensorManager::ImageSensorContainer::WaitForPrerendered(double _timeoutsec)
 {
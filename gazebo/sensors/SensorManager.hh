@@ -18,6 +18,7 @@
 #define _GAZEBO_SENSORMANAGER_HH_
 
 #include <boost/thread.hpp>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <list>
@@ -179,6 +180,34 @@ namespace gazebo
       /// \brief Reset last update times in all sensors.
       public: void ResetLastUpdateTimes();
 
+      /// \brief Set whether all sensors, including the ones created
+      /// afterwards, are demand driven.
+      /// \param[in] _demandDriven True to make the sensors demand driven.
+      /// \sa Sensor::SetDemandDriven
+      public: void SetDemandDriven(const bool _demandDriven);
+
+      /// \brief Get whether the sensors are made demand driven.
+      /// \return True if the sensors are demand driven.
+      public: bool DemandDriven() const;
+
+      /// \brief Set a CPU budget for the sensors: the wall time their
+      /// updates may take per second of simulation time. Once per second of
+      /// wall time, the update rates of the sensors with the lowest
+      /// priorities are limited until the sensors fit the budget, down to
+      /// 1 Hz. A budget can't be set while lockstep is enabled, since the
+      /// sensors then keep their rates by slowing down the world.
+      /// Statistics of the sensors are published as msgs::SensorDiagnostics
+      /// on ~/sensor_diagnostics, with or without a budget.
+      /// \param[in] _budget Seconds of wall time per second of simulation
+      /// time, 0 for no budget.
+      /// \sa Sensor::SetPriority
+      public: void SetCpuBudget(const double _budget);
+
+      /// \brief Get the CPU budget of the sensors.
+      /// \return Seconds of wall time per second of simulation time, 0 if
+      /// there is no budget.
+      public: double CpuBudget() const;
+
       /// \brief Block until all sensors do not need current world tick
       /// \param[in] _clk simulated clock of the world
       /// \param[in] _dt world time step
@@ -189,6 +218,10 @@ namespace gazebo
       /// \return True if timeout has NOT been met
       private: bool WaitForPrerendered(double _timeoutsec);
 
+      /// \brief Limit the update rates of the sensors to fit the CPU budget
+      /// and publish their diagnostics, once per second of wall time.
+      private: void UpdateDiagnostics();
+
       /// \brief Add a new sensor to a sensor container.
       /// \param[in] _sensor Pointer to a sensor to add.
       private: void AddSensor(SensorPtr _sensor);
@@ -269,7 +302,7 @@ namespace gazebo
                  private: boost::thread *runThread;
 
                  /// \brief A mutex to manage access to the sensors vector.
-                 private: mutable boost::recursive_mutex mutex;
+                 protected: mutable boost::recursive_mutex mutex;
 
                  /// \brief Condition used to block the RunLoop if no
                  /// sensors are present.
@@ -292,6 +325,12 @@ namespace gazebo
                  /// even if they are not active.
                  public: virtual void Update(bool _force = false);
 
+                 /// \brief Check whether a frame must be rendered: a sensor
+                 /// is due, follows a strict rate, or a camera renders on
+                 /// every frame.
+                 /// \return True if a frame must be rendered.
+                 private: bool RenderNeeded() const;
+
                  /// \brief used to wait for the end of prerendering
                  private: std::condition_variable conditionPrerendered;
                };
@@ -304,6 +343,21 @@ namespace gazebo
       /// \brief True removes all sensors from all sensor containers.
       private: bool removeAllSensors;
 
+      /// \brief True if the sensors are demand driven.
+      private: bool demandDriven = false;
+
+      /// \brief CPU budget of the sensors, 0 if there is none.
+      private: std::atomic<double> cpuBudget{0.0};
+
+      /// \brief Wall time of the last diagnostics.
+      private: common::Time diagnosticsTime;
+
+      /// \brief Node used to publish the diagnostics.
+      private: transport::NodePtr diagnosticsNode;
+
+      /// \brief Diagnostics publisher of each world.
+      private: std::map<std::string, transport::PublisherPtr> diagnosticsPubs;
+
       /// \brief Mutex used when adding and removing sensors.
       private: mutable boost::recursive_mutex mutex;
 
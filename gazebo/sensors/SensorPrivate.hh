@@ -18,6 +18,7 @@
 #define GAZEBO_SENSORS_SENSOR_PRIVATE_HH_
 
 #include <mutex>
+#include <vector>
 #include <sdf/sdf.hh>
 
 #include "gazebo/rendering/RenderTypes.hh"
@@ -51,6 +52,54 @@ namespace gazebo
       /// \brief The sensors unique ID.
       public: uint32_t id;
 
+      /// \brief True if the sensor is only active because of <always_on>.
+      public: bool alwaysOn = false;
+
+      /// \brief True if the sensor skips its updates while nothing
+      /// consumes its data.
+      public: bool demandDriven = false;
+
+      /// \brief Number of updates skipped because nothing consumed the data.
+      public: uint64_t skippedUpdates = 0;
+
+      /// \brief Time of the last skipped update.
+      public: common::Time lastSkipTime;
+
+      /// \brief Update period set with SetUpdateRate, before the limit.
+      public: common::Time requestedPeriod;
+
+      /// \brief Maximum update rate, 0 for no limit.
+      public: double updateRateLimit = 0;
+
+      /// \brief Priority of the sensor under a CPU budget.
+      public: int priority = 0;
+
+      /// \brief Protects the update statistics below.
+      public: mutable std::mutex mutexStatistics;
+
+      /// \brief Number of updates in each latency bin.
+      public: std::vector<uint64_t> latencyCounts;
+
+      /// \brief Wall time spent on the sensor outside of its updates, added
+      /// to the next update.
+      public: common::Time pendingWallTime;
+
+      /// \brief Simulation time at which the current measurement window
+      /// started.
+      public: common::Time windowStart;
+
+      /// \brief Number of updates in the current measurement window.
+      public: unsigned int windowUpdates = 0;
+
+      /// \brief Wall time taken by the updates of the current window.
+      public: common::Time windowWallTime;
+
+      /// \brief Update rate measured over the last window.
+      public: double measuredRate = 0;
+
+      /// \brief Mean wall time of an update over the last window.
+      public: common::Time meanWallTime;
+
       /// \brief An SDF pointer that allows us to only read the sensor.sdf
       /// file once, which in turns limits disk reads.
       public: static sdf::ElementPtr sdfSensor;
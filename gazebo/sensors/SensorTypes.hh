@@ -54,6 +54,7 @@ namespace gazebo
     class WirelessTransceiver;
     class WirelessTransmitter;
     class WirelessReceiver;
+    class CpuCamera;
 
     /// \def AltimeterSensorPtr
     /// \brief Shared pointer to AltimeterSensor
@@ -143,6 +144,10 @@ namespace gazebo
     /// \brief Shared pointer to WirelessReceiver
     typedef std::shared_ptr<WirelessReceiver> WirelessReceiverPtr;
 
+    /// \def CpuCameraPtr
+    /// \brief Shared pointer to CpuCamera
+    typedef std::shared_ptr<CpuCamera> CpuCameraPtr;
+
     /// \def AltimeterSensor_V
     /// \brief Vector of AltimeterSensor shared pointers
     typedef std::vector<AltimeterSensor> AltimeterSensor_V;
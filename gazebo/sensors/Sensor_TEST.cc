@@ -16,9 +16,14 @@
 */
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <vector>
 #include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -198,6 +203,197 @@ TEST_F(Sensor_TEST, UpdateAfterReset)
               updateRateImu*(now-then) * 0.5);
 }
 
+/////////////////////////////////////////////////
+/// \brief Demand driven sensors only update while something consumes
+/// their data
+TEST_F(Sensor_TEST, DemandDriven)
+{
+  Load("worlds/ray_test.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  sensors::SensorPtr imuSensor =
+      mgr->GetSensor("default::box_model::box_link::box_imu_sensor");
+  ASSERT_TRUE(imuSensor != nullptr);
+
+  // The imu is always on
+  EXPECT_FALSE(mgr->DemandDriven());
+  EXPECT_FALSE(imuSensor->DemandDriven());
+  EXPECT_TRUE(imuSensor->IsActive());
+
+  mgr->SetDemandDriven(true);
+  EXPECT_TRUE(mgr->DemandDriven());
+  EXPECT_TRUE(imuSensor->DemandDriven());
+  EXPECT_FALSE(imuSensor->IsActive());
+  EXPECT_EQ(0u, imuSensor->SkippedUpdateCount());
+
+  // Nothing consumes the data of the imu, so its updates are skipped
+  world->Step(100);
+  int i = 0;
+  while (i < 100 && imuSensor->SkippedUpdateCount() == 0u)
+  {
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_GT(imuSensor->SkippedUpdateCount(), 0u);
+  common::Time lastUpdateTime = imuSensor->LastUpdateTime();
+  EXPECT_LT(lastUpdateTime, world->SimTime());
+
+  // A callback resumes the updates
+  std::atomic<unsigned int> updates(0);
+  event::ConnectionPtr connection = imuSensor->ConnectUpdated(
+      [&updates]() {++updates;});
+  EXPECT_TRUE(imuSensor->IsActive());
+
+  world->Step(100);
+  i = 0;
+  while (i < 100 && updates.load() == 0u)
+  {
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_GT(updates.load(), 0u);
+  EXPECT_GT(imuSensor->LastUpdateTime(), lastUpdateTime);
+
+  connection.reset();
+  EXPECT_FALSE(imuSensor->IsActive());
+
+  // So does a subscriber
+  g_imuMsgCount = 0;
+  transport::SubscriberPtr imuSub = this->node->Subscribe(
+      "~/box_model/box_link/box_imu_sensor/imu", &ReceiveImuMsg);
+  i = 0;
+  while (i < 100 && !imuSensor->IsActive())
+  {
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_TRUE(imuSensor->IsActive());
+
+  imuSub.reset();
+
+  // Sensors activated explicitly always update
+  imuSensor->SetActive(true);
+  EXPECT_TRUE(imuSensor->IsActive());
+
+  mgr->SetDemandDriven(false);
+  EXPECT_FALSE(imuSensor->DemandDriven());
+}
+
+// global variable and callback for tracking sensor diagnostics
+std::mutex g_diagnosticsMutex;
+msgs::SensorDiagnostics g_diagnosticsMsg;
+void ReceiveDiagnosticsMsg(ConstSensorDiagnosticsPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_diagnosticsMutex);
+  g_diagnosticsMsg = *_msg;
+}
+
+/////////////////////////////////////////////////
+/// \brief A CPU budget limits the update rates of the sensors, which
+/// publish their statistics.
+TEST_F(Sensor_TEST, CpuBudget)
+{
+  Load("worlds/ray_test.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  sensors::SensorPtr imuSensor =
+      mgr->GetSensor("default::box_model::box_link::box_imu_sensor");
+  ASSERT_TRUE(imuSensor != nullptr);
+
+  EXPECT_DOUBLE_EQ(0.0, mgr->CpuBudget());
+  EXPECT_DOUBLE_EQ(0.0, imuSensor->UpdateRateLimit());
+  EXPECT_EQ(0, imuSensor->Priority());
+  imuSensor->SetPriority(2);
+  EXPECT_EQ(2, imuSensor->Priority());
+
+  // A limit doesn't change the requested rate
+  imuSensor->SetUpdateRate(500);
+  imuSensor->SetUpdateRateLimit(100);
+  EXPECT_DOUBLE_EQ(500.0, imuSensor->UpdateRate());
+  EXPECT_DOUBLE_EQ(100.0, imuSensor->UpdateRateLimit());
+  imuSensor->SetUpdateRateLimit(0);
+  imuSensor->SetUpdateRate(0);
+
+  transport::SubscriberPtr diagnosticsSub = this->node->Subscribe(
+      "~/sensor_diagnostics", &ReceiveDiagnosticsMsg);
+
+  // The rate and latency are measured over a second of simulation time
+  world->Step(1500);
+  int i = 0;
+  while (i < 100 && imuSensor->MeasuredUpdateRate() <= 0)
+  {
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_GT(imuSensor->MeasuredUpdateRate(), 0.0);
+  EXPECT_GT(imuSensor->MeanUpdateWallTime(), common::Time::Zero);
+
+  std::vector<uint64_t> counts = imuSensor->UpdateLatencyCounts();
+  ASSERT_EQ(sensors::Sensor::UpdateLatencyBounds().size() + 1,
+      counts.size());
+  EXPECT_GT(std::accumulate(counts.begin(), counts.end(), uint64_t(0)), 0u);
+
+  // A budget can't be set in lockstep
+  rendering::set_lockstep_enabled(true);
+  mgr->SetCpuBudget(1e-9);
+  EXPECT_DOUBLE_EQ(0.0, mgr->CpuBudget());
+  rendering::set_lockstep_enabled(false);
+
+  // Nothing fits in this budget, so the rate is limited down to 1 Hz
+  mgr->SetCpuBudget(1e-9);
+  EXPECT_DOUBLE_EQ(1e-9, mgr->CpuBudget());
+  i = 0;
+  while (i < 300 && imuSensor->UpdateRateLimit() <= 0)
+  {
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_DOUBLE_EQ(1.0, imuSensor->UpdateRateLimit());
+  EXPECT_DOUBLE_EQ(0.0, imuSensor->UpdateRate());
+
+  // The diagnostics report the budget and the imu
+  bool received = false;
+  i = 0;
+  while (i < 300 && !received)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_diagnosticsMutex);
+      received = g_diagnosticsMsg.cpu_budget() > 0;
+    }
+    common::Time::MSleep(10);
+    ++i;
+  }
+  ASSERT_TRUE(received);
+  {
+    std::lock_guard<std::mutex> lock(g_diagnosticsMutex);
+    EXPECT_DOUBLE_EQ(1e-9, g_diagnosticsMsg.cpu_budget());
+    EXPECT_EQ(sensors::Sensor::UpdateLatencyBounds().size(),
+        static_cast<size_t>(g_diagnosticsMsg.latency_bound_size()));
+
+    bool found = false;
+    for (auto const &sensorMsg : g_diagnosticsMsg.sensor())
+    {
+      if (sensorMsg.name() != imuSensor->ScopedName())
+        continue;
+      found = true;
+      EXPECT_EQ(2, sensorMsg.priority());
+      EXPECT_DOUBLE_EQ(0.0, sensorMsg.requested_rate());
+      EXPECT_GT(sensorMsg.actual_rate(), 0.0);
+      EXPECT_EQ(g_diagnosticsMsg.latency_bound_size() + 1,
+          sensorMsg.latency_count_size());
+    }
+    EXPECT_TRUE(found);
+  }
+
+  // Without a budget the limits are lifted
+  mgr->SetCpuBudget(0);
+  EXPECT_DOUBLE_EQ(0.0, imuSensor->UpdateRateLimit());
+}
+
 /////////////////////////////////////////////////
 /// \brief Set pose
 TEST_F(Sensor_TEST, SetPose)
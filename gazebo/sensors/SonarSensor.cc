@@ -369,6 +369,12 @@ bool SonarSensor::IsActive() const
   return Sensor::IsActive() || this->dataPtr->sonarPub->HasConnections();
 }
 
+//////////////////////////////////////////////////
+bool SonarSensor::HasListeners() const
+{
+  return Sensor::HasListeners() || this->dataPtr->update.ConnectionCount() > 0;
+}
+
 //////////////////////////////////////////////////
 void SonarSensor::OnContacts(ConstContactsPtr &_msg)
 {
@@ -101,6 +101,12 @@ void WirelessTransceiver::Fini()
   Sensor::Fini();
 }
 
+/////////////////////////////////////////////////
+bool WirelessTransceiver::IsActive() const
+{
+  return Sensor::IsActive() || (this->pub && this->pub->HasConnections());
+}
+
 /////////////////////////////////////////////////
 double WirelessTransceiver::Power() const
 {
@@ -14,6 +14,12 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -36,6 +42,54 @@ const double WirelessTransmitterPrivate::NObstacle = 12.0;
 const double WirelessTransmitterPrivate::ModelStdDev = 6.0;
 const double WirelessTransmitterPrivate::Step = 1.0;
 const double WirelessTransmitterPrivate::MaxRadius = 10.0;
+const double WirelessTransmitterPrivate::CacheResolution = 0.001;
+const size_t WirelessTransmitterPrivate::CacheSize = 100000;
+
+/////////////////////////////////////////////////
+/// \brief Get the key of a point in WirelessTransmitterPrivate::obstructed.
+/// \param[in] _point Point.
+/// \return Coordinates of the point in multiples of the cache resolution.
+static std::array<int64_t, 3> cacheKey(const ignition::math::Vector3d &_point)
+{
+  const double res = WirelessTransmitterPrivate::CacheResolution;
+  return {{std::llround(_point.X() / res), std::llround(_point.Y() / res),
+      std::llround(_point.Z() / res)}};
+}
+
+/////////////////////////////////////////////////
+/// \brief Whether a segment intersects a box.
+/// \param[in] _start Start of the segment.
+/// \param[in] _end End of the segment.
+/// \param[in] _box Box.
+/// \return True if a point of the segment is in the box.
+static bool segmentIntersects(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  const ignition::math::Vector3d dir = _end - _start;
+  double tMin = 0.0;
+  double tMax = 1.0;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (std::abs(dir[i]) < 1e-12)
+    {
+      // Parallel to the slab
+      if (_start[i] < _box.Min()[i] || _start[i] > _box.Max()[i])
+        return false;
+      continue;
+    }
+
+    double t1 = (_box.Min()[i] - _start[i]) / dir[i];
+    double t2 = (_box.Max()[i] - _start[i]) / dir[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    tMin = std::max(tMin, t1);
+    tMax = std::min(tMax, t2);
+    if (tMin > tMax)
+      return false;
+  }
+  return true;
+}
 
 /////////////////////////////////////////////////
 WirelessTransmitter::WirelessTransmitter()
@@ -90,13 +144,15 @@ bool WirelessTransmitter::UpdateImpl(const bool /*_force*/)
 {
   this->referencePose = this->pose + this->parentEntity.lock()->WorldPose();
 
-  if (this->dataPtr->visualize)
+  // The grid is only used by the transmitter visual, don't compute it when
+  // nobody is listening
+  if (this->dataPtr->visualize && this->pub->HasConnections())
   {
     msgs::PropagationGrid msg;
     ignition::math::Pose3d pos;
     ignition::math::Pose3d worldPose;
-    double strength;
-    msgs::PropagationParticle *p;
+    std::vector<ignition::math::Vector3d> points;
+    std::vector<ignition::math::Vector3d> ends;
 
     // Iterate using a rectangular grid, but only choose the points within
     // a circunference of radius MaxRadius
@@ -113,18 +169,31 @@ bool WirelessTransmitter::UpdateImpl(const bool /*_force*/)
         if (this->referencePose.Pos().Distance(worldPose.Pos()) <=
             this->dataPtr->MaxRadius)
         {
-          // For the propagation model assume the receiver antenna has the same
-          // gain as the transmitter
-          strength = this->SignalStrength(worldPose, this->Gain());
-
-          // Add a new particle to the grid
-          p = msg.add_particle();
-          p->set_x(x);
-          p->set_y(y);
-          p->set_signal_level(strength);
+          points.push_back(ignition::math::Vector3d(x, y, 0.0));
+          ends.push_back(worldPose.Pos());
         }
       }
     }
+
+    // Check all the points for obstacles at once
+    std::vector<bool> obstructed;
+    this->Obstructed(ends, this->MovingModels(this->referencePose.Pos(),
+        this->dataPtr->MaxRadius), obstructed);
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      // For the propagation model assume the receiver antenna has the same
+      // gain as the transmitter
+      double strength = this->Propagation(
+          this->referencePose.Pos().Distance(ends[i]), this->Gain(),
+          obstructed[i]);
+
+      // Add a new particle to the grid
+      msgs::PropagationParticle *p = msg.add_particle();
+      p->set_x(points[i].X());
+      p->set_y(points[i].Y());
+      p->set_signal_level(strength);
+    }
     this->pub->Publish(msg);
   }
 
@@ -148,37 +217,26 @@ double WirelessTransmitter::SignalStrength(
     const ignition::math::Pose3d &_receiver,
     const double _rxGain)
 {
-  std::string entityName;
-  double dist;
-  ignition::math::Vector3d end = _receiver.Pos();
-  ignition::math::Vector3d start = this->referencePose.Pos();
+  const ignition::math::Vector3d start = this->referencePose.Pos();
+  const ignition::math::Vector3d end = _receiver.Pos();
 
-  // Avoid computing the intersection of coincident points
-  // This prevents an assertion in bullet (issue #849)
-  if (start == end)
-  {
-    end.Z() += 0.00001;
-  }
+  std::vector<bool> obstructed;
+  this->Obstructed({end},
+      this->MovingModels((start + end) * 0.5, start.Distance(end) * 0.5),
+      obstructed);
 
-  // Acquire the mutex for avoiding race condition with the physics engine
-  boost::recursive_mutex::scoped_lock lock(*(
-        this->world->Physics()->GetPhysicsUpdateMutex()));
+  return this->Propagation(start.Distance(end), _rxGain, obstructed[0]);
+}
 
+/////////////////////////////////////////////////
+double WirelessTransmitter::Propagation(const double _distance,
+    const double _rxGain, const bool _obstructed) const
+{
   // Compute the value of n depending on the obstacles between Tx and Rx
-  double n = WirelessTransmitterPrivate::NEmpty;
+  double n = _obstructed ? WirelessTransmitterPrivate::NObstacle :
+      WirelessTransmitterPrivate::NEmpty;
 
-  // Looking for obstacles between start and end points
-  this->dataPtr->testRay->SetPoints(start, end);
-  this->dataPtr->testRay->GetIntersection(dist, entityName);
-
-  // ToDo: The ray intersects with my own collision model. Fix it.
-  if (entityName != "")
-  {
-    n = WirelessTransmitterPrivate::NObstacle;
-  }
-
-  double distance = std::max(1.0,
-      this->referencePose.Pos().Distance(_receiver.Pos()));
+  double distance = std::max(1.0, _distance);
   double x = std::abs(ignition::math::Rand::DblNormal(0.0,
         WirelessTransmitterPrivate::ModelStdDev));
   double wavelength = common::SpeedOfLight / (this->Freq() * 1000000);
@@ -190,6 +248,124 @@ double WirelessTransmitter::SignalStrength(
   return rxPower;
 }
 
+/////////////////////////////////////////////////
+std::vector<ignition::math::AxisAlignedBox> WirelessTransmitter::MovingModels(
+    const ignition::math::Vector3d &_center, const double _radius)
+{
+  std::vector<ignition::math::AxisAlignedBox> boxes;
+
+  physics::ModelPtr ownModel;
+  physics::EntityPtr parent = this->parentEntity.lock();
+  if (parent)
+    ownModel = parent->GetParentModel();
+
+  for (auto const &model : this->world->ModelsInSphere(_center, _radius))
+  {
+    if (model->IsStatic())
+      continue;
+
+    // The model of the transmitter and its nested models move with the
+    // transmitter, which invalidates the cache
+    physics::BasePtr top = model;
+    while (top->GetParent() && top->GetParent()->HasType(physics::Base::MODEL))
+      top = top->GetParent();
+    if (top == ownModel)
+      continue;
+
+    boxes.push_back(model->BoundingBox());
+  }
+
+  return boxes;
+}
+
+/////////////////////////////////////////////////
+void WirelessTransmitter::Obstructed(
+    const std::vector<ignition::math::Vector3d> &_ends,
+    const std::vector<ignition::math::AxisAlignedBox> &_moving,
+    std::vector<bool> &_obstructed)
+{
+  const ignition::math::Vector3d start = this->referencePose.Pos();
+  _obstructed.assign(_ends.size(), false);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+
+  // The cached results are only valid for the static geometry and the
+  // transmitter pose they were computed with
+  const uint64_t revision = this->world->StaticModelsRevision();
+  if (revision != this->dataPtr->cacheRevision ||
+      this->referencePose != this->dataPtr->cachePose ||
+      this->dataPtr->obstructed.size() > WirelessTransmitterPrivate::CacheSize)
+  {
+    this->dataPtr->obstructed.clear();
+    this->dataPtr->cacheRevision = revision;
+    this->dataPtr->cachePose = this->referencePose;
+  }
+
+  // Points to test with rays, and whether a moving model is in the way
+  std::vector<std::pair<size_t, bool>> rays;
+  for (size_t i = 0; i < _ends.size(); ++i)
+  {
+    bool moving = false;
+    for (auto const &box : _moving)
+    {
+      if (segmentIntersects(start, _ends[i], box))
+      {
+        moving = true;
+        break;
+      }
+    }
+
+    if (!moving)
+    {
+      auto iter = this->dataPtr->obstructed.find(cacheKey(_ends[i]));
+      if (iter != this->dataPtr->obstructed.end())
+      {
+        _obstructed[i] = iter->second;
+        continue;
+      }
+    }
+    rays.push_back(std::make_pair(i, moving));
+  }
+
+  if (rays.empty())
+    return;
+
+  // Acquire the mutex for avoiding race condition with the physics engine,
+  // once for all the rays
+  boost::recursive_mutex::scoped_lock physicsLock(*(
+        this->world->Physics()->GetPhysicsUpdateMutex()));
+
+  std::string entityName;
+  double dist;
+  for (auto const &ray : rays)
+  {
+    ignition::math::Vector3d end = _ends[ray.first];
+
+    // Avoid computing the intersection of coincident points
+    // This prevents an assertion in bullet (issue #849)
+    if (start == end)
+    {
+      end.Z() += 0.00001;
+    }
+
+    // Looking for obstacles between start and end points
+    entityName.clear();
+    this->dataPtr->testRay->SetPoints(start, end);
+    this->dataPtr->testRay->GetIntersection(dist, entityName);
+
+    // ToDo: The ray intersects with my own collision model. Fix it.
+    _obstructed[ray.first] = !entityName.empty();
+
+    // Only the static geometry was in the way, the result holds until it
+    // changes
+    if (!ray.second)
+    {
+      this->dataPtr->obstructed[cacheKey(_ends[ray.first])] =
+          _obstructed[ray.first];
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 double WirelessTransmitter::ModelStdDev() const
 {
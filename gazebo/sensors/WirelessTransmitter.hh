@@ -19,6 +19,8 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <ignition/math/AxisAlignedBox.hh>
 #include "gazebo/physics/physics.hh"
 #include "gazebo/sensors/WirelessTransceiver.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -73,6 +75,38 @@ namespace gazebo
       /// \return The standard deviation of the propagation model.
       public: double ModelStdDev() const;
 
+      /// \brief Compute the signal strength given by the propagation model.
+      /// \param[in] _distance Distance between transmitter and receiver.
+      /// \param[in] _rxGain Receiver gain value.
+      /// \param[in] _obstructed True if there are obstacles between
+      /// transmitter and receiver.
+      /// \return Signal strength (dBm).
+      private: double Propagation(const double _distance, const double _rxGain,
+          const bool _obstructed) const;
+
+      /// \brief Get the bounding boxes of the models near a sphere which
+      /// can move. The model of the transmitter moves with the transmitter,
+      /// so it is left out.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return Bounding boxes of the models.
+      private: std::vector<ignition::math::AxisAlignedBox> MovingModels(
+          const ignition::math::Vector3d &_center, const double _radius);
+
+      /// \brief Check for obstacles between the transmitter and a set of
+      /// points. Points out of the way of moving models use the cached result
+      /// for the static geometry, and the other points are tested together
+      /// with rays.
+      /// \param[in] _ends Points to check.
+      /// \param[in] _moving Bounding boxes of the moving models, from
+      /// MovingModels.
+      /// \param[out] _obstructed True for the points with obstacles between
+      /// them and the transmitter.
+      private: void Obstructed(
+          const std::vector<ignition::math::Vector3d> &_ends,
+          const std::vector<ignition::math::AxisAlignedBox> &_moving,
+          std::vector<bool> &_obstructed);
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<WirelessTransmitterPrivate> dataPtr;
@@ -17,7 +17,14 @@
 #ifndef _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <string>
+
+#include <ignition/math/Pose3.hh>
+
 #include "gazebo/physics/PhysicsTypes.hh"
 
 namespace gazebo
@@ -59,6 +66,27 @@ namespace gazebo
 
       // \brief Ray used to test for collisions when placing entities
       public: physics::RayShapePtr testRay;
+
+      /// \brief Whether the static geometry of the world is between the
+      /// transmitter and a point, by point rounded to CacheResolution.
+      /// Valid while the transmitter stays at cachePose and the static models
+      /// don't change.
+      public: std::map<std::array<int64_t, 3>, bool> obstructed;
+
+      /// \brief Pose of the transmitter when obstructed was filled.
+      public: ignition::math::Pose3d cachePose;
+
+      /// \brief World::StaticModelsRevision when obstructed was filled.
+      public: uint64_t cacheRevision = 0;
+
+      /// \brief Resolution of the points in obstructed, in meters.
+      public: static const double CacheResolution;
+
+      /// \brief Number of points in obstructed above which it is cleared.
+      public: static const size_t CacheSize;
+
+      /// \brief Mutex to protect obstructed, cachePose and cacheRevision.
+      public: std::mutex cacheMutex;
     };
   }
 }
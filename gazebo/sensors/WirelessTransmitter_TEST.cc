@@ -27,6 +27,7 @@ class WirelessTransmitter_TEST : public ServerFixture
     public: void TestUpdateImpl();
     public: void TestUpdateImplNoVisual();
     public: void TestInvalidFreq();
+    public: void TestObstacles();
     private: void TxMsg(const ConstPropagationGridPtr &_msg);
 
     private: std::mutex mutex;
@@ -159,6 +160,64 @@ void WirelessTransmitter_TEST::TestSignalStrength()
   EXPECT_NEAR(signStrengthAvg, -62.0, this->tx->ModelStdDev());
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the average signal strength of a transmitter at a point.
+/// \param[in] _tx Transmitter.
+/// \param[in] _pose Pose of the receiver.
+/// \return Average signal strength.
+static double averageSignalStrength(sensors::WirelessTransmitterPtr _tx,
+    const ignition::math::Pose3d &_pose)
+{
+  int samples = 100;
+  double signStrengthAvg = 0.0;
+  for (int i = 0; i < samples; ++i)
+  {
+    _tx->Update(true);
+    signStrengthAvg += _tx->SignalStrength(_pose, _tx->Gain());
+  }
+  return signStrengthAvg / samples;
+}
+
+/////////////////////////////////////////////////
+/// \brief Test that the cached obstacles follow the static and the moving
+/// models
+void WirelessTransmitter_TEST::TestObstacles()
+{
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ignition::math::Pose3d rxPose(
+      ignition::math::Vector3d(3.0, 3.0, 0.055),
+      ignition::math::Quaterniond(0, 0, 0));
+  const double unobstructed = -62.0;
+
+  EXPECT_NEAR(averageSignalStrength(this->tx, rxPose), unobstructed,
+      this->tx->ModelStdDev());
+
+  // A static wall between the transmitter and the receiver
+  SpawnBox("wall", ignition::math::Vector3d(0.5, 0.5, 1.0),
+      ignition::math::Vector3d(1.5, 1.5, 0.5),
+      ignition::math::Vector3d::Zero, true);
+  physics::ModelPtr wall = world->ModelByName("wall");
+  ASSERT_TRUE(wall != nullptr);
+
+  EXPECT_LT(averageSignalStrength(this->tx, rxPose),
+      unobstructed - 3 * this->tx->ModelStdDev());
+
+  // Moving the wall out of the way clears the cache
+  wall->SetWorldPose(ignition::math::Pose3d(10, -10, 0.5, 0, 0, 0));
+  EXPECT_NEAR(averageSignalStrength(this->tx, rxPose), unobstructed,
+      this->tx->ModelStdDev());
+
+  // Models which can move are always checked
+  SpawnBox("box", ignition::math::Vector3d(0.5, 0.5, 1.0),
+      ignition::math::Vector3d(1.5, 1.5, 0.5));
+  ASSERT_TRUE(world->ModelByName("box") != nullptr);
+
+  EXPECT_LT(averageSignalStrength(this->tx, rxPose),
+      unobstructed - 3 * this->tx->ModelStdDev());
+}
+
 /////////////////////////////////////////////////
 /// \brief Callback executed for every propagation grid message received
 void WirelessTransmitter_TEST::TxMsg(const ConstPropagationGridPtr &_msg)
@@ -254,6 +313,12 @@ TEST_F(WirelessTransmitter_TEST, TestSignalStrength)
   TestSignalStrength();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WirelessTransmitter_TEST, TestObstacles)
+{
+  TestObstacles();
+}
+
 /////////////////////////////////////////////////
 TEST_F(WirelessTransmitter_TEST, TestUpdateImpl)
 {
@@ -181,6 +181,39 @@ TEST_F(IntrospectionClientTest, NewAndRemoveFilter)
   EXPECT_FALSE(this->callbackExecuted);
 }
 
+/////////////////////////////////////////////////
+TEST_F(IntrospectionClientTest, NewFilterRate)
+{
+  std::string filterId;
+  std::string topic;
+
+  // Let's create a filter publishing "item1" and "item2" every two seconds.
+  std::set<std::string> items = {"item1", "item2"};
+  EXPECT_TRUE(this->client.NewFilter(this->managerId, items, 0.5, filterId,
+      topic));
+
+  // Subscribe to my custom topic for receiving updates.
+  this->Subscribe(topic);
+
+  // The first update is published.
+  this->manager->Update();
+
+  this->WaitForCallback();
+
+  EXPECT_TRUE(this->callbackExecuted);
+  this->callbackExecuted = false;
+
+  // The next updates are skipped until the period elapsed.
+  for (int i = 0; i < 10; ++i)
+    this->manager->Update();
+
+  this->WaitForCallback();
+
+  EXPECT_FALSE(this->callbackExecuted);
+
+  EXPECT_TRUE(this->client.RemoveFilter(this->managerId, filterId));
+}
+
 /////////////////////////////////////////////////
 TEST_F(IntrospectionClientTest, RemoveAllFilters)
 {
@@ -14,7 +14,9 @@
  * limitations under the License.
  *
  */
+#include <chrono>
 #include <functional>
+#include <map>
 #include <set>
 #include <string>
 #include <ignition/math/Rand.hh>
@@ -114,6 +116,7 @@ bool IntrospectionManager::Register(const std::string &_item,
   this->dataPtr->allItems[_item] = _cb;
 
   this->dataPtr->itemsUpdated = true;
+  this->dataPtr->filtersChanged = true;
 
   return true;
 }
@@ -135,6 +138,7 @@ bool IntrospectionManager::Unregister(const std::string &_item)
   this->dataPtr->allItems.erase(_item);
 
   this->dataPtr->itemsUpdated = true;
+  this->dataPtr->filtersChanged = true;
 
   return true;
 }
@@ -146,6 +150,7 @@ void IntrospectionManager::Clear()
   this->dataPtr->allItemsKeys.clear();
   this->dataPtr->allItems.clear();
   this->dataPtr->itemsUpdated = true;
+  this->dataPtr->filtersChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -162,107 +167,151 @@ std::set<std::string> IntrospectionManager::Items() const
 }
 
 //////////////////////////////////////////////////
-void IntrospectionManager::Update()
+void IntrospectionManagerPrivate::CompileFilters()
 {
-  std::map<std::string, IntrospectionFilter> filtersCopy;
-  std::map<std::string, ObservedItem> observedItemsCopy;
-  std::map<std::string, std::function <gazebo::msgs::Any ()>> usedItemsCopy;
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Keep the schedule of the existing filters
+  std::map<std::string, std::chrono::steady_clock::time_point> nextUpdates;
+  for (auto const &filter : this->compiledFilters)
+    nextUpdates[filter.id] = filter.nextUpdate;
+
+  this->compiledItems.clear();
+  this->compiledFilters.clear();
 
+  std::map<std::string, size_t> itemIndices;
+  for (auto const &filter : this->filters)
   {
-    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto pubIter = this->filterPubs.find(this->prefix + "filter/" +
+        filter.first);
+    if (pubIter == this->filterPubs.end())
+      continue;
+
+    CompiledFilter compiled;
+    compiled.id = filter.first;
+    compiled.topic = pubIter->first;
+    compiled.publisher = pubIter->second;
+    if (filter.second.rate > 0)
+    {
+      compiled.period =
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / filter.second.rate));
+    }
 
-    filtersCopy = this->dataPtr->filters;
-    observedItemsCopy = this->dataPtr->observedItems;
+    auto nextIter = nextUpdates.find(filter.first);
+    if (nextIter != nextUpdates.end())
+      compiled.nextUpdate = nextIter->second;
 
-    for (const auto &observedItem: this->dataPtr->observedItems)
+    for (auto const &item : filter.second.items)
     {
-      auto &item = observedItem.first;
       // Sanity check: Make sure that someone registered this item.
-      if (this->dataPtr->allItemsKeys.count(item) == 0)
-      {
+      auto itemIter = this->allItems.find(item);
+      if (itemIter == this->allItems.end())
         continue;
-      }
 
-      usedItemsCopy[item] = this->dataPtr->allItems[item];
-    }
-
-    for (auto& filter: filtersCopy)
-    {
-      for (auto const &item : filter.second.items)
+      auto index = itemIndices.find(item);
+      if (index == itemIndices.end())
       {
-        // Sanity check: Make sure that someone registered this item.
-        if (this->dataPtr->allItemsKeys.count(item) == 0)
-        {
-          continue;
-        }
-        usedItemsCopy[item] = this->dataPtr->allItems[item];
+        index = itemIndices.emplace(item, this->compiledItems.size()).first;
+        CompiledItem compiledItem;
+        compiledItem.name = item;
+        compiledItem.callback = itemIter->second;
+        this->compiledItems.push_back(std::move(compiledItem));
       }
+      compiled.items.push_back(index->second);
+
+      auto nextParam = compiled.msg.add_param();
+      nextParam->set_name(item);
     }
+
+    this->compiledFilters.push_back(std::move(compiled));
   }
+}
 
-  for (auto &observedItem : observedItemsCopy)
+//////////////////////////////////////////////////
+void IntrospectionManager::Update()
+{
   {
-    auto &item = observedItem.first;
-    auto itemIter = usedItemsCopy.find(item);
-
-    // Sanity check: Make sure that we can update the item.
-    if (itemIter == usedItemsCopy.end())
-      continue;
+    std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
 
-    try
-    {
-      // Update the values of the items under observation.
-      gazebo::msgs::Any value = itemIter->second();
-      auto &lastValue = observedItem.second.lastValue;
-      lastValue.CopyFrom(value);
-    }
-    catch(...)
-    {
-      gzerr << "Exception caught calling user callback" << std::endl;
-      continue;
-    }
-  }
+    // The filters are only compiled again when they or the items change
+    if (this->dataPtr->filtersChanged.exchange(false))
+      this->dataPtr->CompileFilters();
 
-  // Prepare the next message to be sent in each filter.
-  for (auto &filter : filtersCopy)
-  {
-    // First of all, clear the old message.
-    auto &nextMsg = filter.second.msg;
-    nextMsg.Clear();
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t update = ++this->dataPtr->updateCount;
 
-    // Insert the last value of each item under observation for this filter.
-    for (auto const &item : filter.second.items)
+    for (auto &filter : this->dataPtr->compiledFilters)
     {
-      // Sanity check: Make sure that someone registered this item.
-      if (usedItemsCopy.find(item) == usedItemsCopy.end())
+      if (filter.items.empty() || now < filter.nextUpdate)
         continue;
 
-      // Sanity check: Make sure that the value was updated.
-      // (e.g.: an exception was not raised).
-      auto &lastValue = observedItemsCopy[item].lastValue;
-      if (lastValue.type() == gazebo::msgs::Any::NONE)
-        continue;
+      if (filter.period.count() > 0)
+      {
+        filter.nextUpdate += filter.period;
+        if (filter.nextUpdate <= now)
+          filter.nextUpdate = now + filter.period;
+      }
 
-      auto nextParam = nextMsg.add_param();
-      nextParam->set_name(item);
-      nextParam->mutable_value()->CopyFrom(lastValue);
-    }
+      // Insert the last value of each item under observation for this filter.
+      int paramCount = 0;
+      for (auto const index : filter.items)
+      {
+        auto &item = this->dataPtr->compiledItems[index];
 
-    // Sanity check: Make sure that we have at least one item updated.
-    if (nextMsg.param_size() == 0)
-      continue;
+        // Items shared by several filters are only sampled once
+        if (item.sampledUpdate != update)
+        {
+          item.sampledUpdate = update;
+          try
+          {
+            item.value = item.callback();
+            item.valid = item.value.type() != gazebo::msgs::Any::NONE;
+          }
+          catch(...)
+          {
+            gzerr << "Exception caught calling user callback" << std::endl;
+            item.valid = false;
+          }
+        }
 
-    // Publish the update for this filter.
-    std::string topicName = this->dataPtr->prefix + "filter/" + filter.first;
+        // Sanity check: Make sure that the value was updated.
+        // (e.g.: an exception was not raised).
+        if (!item.valid)
+          continue;
 
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-      if (this->dataPtr->filterPubs.find(topicName) ==
-          this->dataPtr->filterPubs.end() ||
-          !this->dataPtr->filterPubs[topicName].Publish(nextMsg))
+        // The params are reused, so they only change when an item failed
+        if (paramCount == filter.msg.param_size())
+          filter.msg.add_param();
+        auto nextParam = filter.msg.mutable_param(paramCount++);
+        if (nextParam->name() != item.name)
+          nextParam->set_name(item.name);
+        nextParam->mutable_value()->CopyFrom(item.value);
+      }
+
+      // Sanity check: Make sure that we have at least one item updated.
+      if (paramCount == 0)
+        continue;
+
+      // Publish the update for this filter.
+      if (paramCount == filter.msg.param_size())
       {
-        gzerr << "Error publishing update for topic [" << topicName << "]"
-          << std::endl;
+        if (!filter.publisher.Publish(filter.msg))
+        {
+          gzerr << "Error publishing update for topic [" << filter.topic
+                << "]" << std::endl;
+        }
+      }
+      else
+      {
+        gazebo::msgs::Param_V msg;
+        for (int i = 0; i < paramCount; ++i)
+          msg.add_param()->CopyFrom(filter.msg.param(i));
+        if (!filter.publisher.Publish(msg))
+        {
+          gzerr << "Error publishing update for topic [" << filter.topic
+                << "]" << std::endl;
+        }
       }
     }
   }
@@ -298,7 +347,7 @@ void IntrospectionManager::NotifyUpdates()
 
 //////////////////////////////////////////////////
 bool IntrospectionManager::NewFilterImpl(const std::set<std::string> &_newItems,
-    std::string &_filterId)
+    const double _rate, std::string &_filterId)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
@@ -331,17 +380,19 @@ bool IntrospectionManager::NewFilterImpl(const std::set<std::string> &_newItems,
 
   // Add the items to the new filter.
   this->dataPtr->filters[_filterId].items = _newItems;
+  this->dataPtr->filters[_filterId].rate = _rate;
 
   // Register the new filter in the list of observed items.
   for (auto const &item : _newItems)
     this->dataPtr->observedItems[item].filters.emplace(_filterId);
 
+  this->dataPtr->filtersChanged = true;
   return true;
 }
 
 //////////////////////////////////////////////////
 bool IntrospectionManager::UpdateFilterImpl(const std::string &_filterId,
-    const std::set<std::string> &_newItems)
+    const std::set<std::string> &_newItems, const double _rate)
 {
   // Sanity check: Make sure that we have at least one item to be observed.
   if (_newItems.empty())
@@ -366,6 +417,8 @@ bool IntrospectionManager::UpdateFilterImpl(const std::string &_filterId,
 
   // Update the list of items for this filter.
   this->dataPtr->filters[_filterId].items = _newItems;
+  if (_rate >= 0)
+    this->dataPtr->filters[_filterId].rate = _rate;
 
   // The next block is needed for updating the 'observedItems' data structure
   // that contains references to the filters.
@@ -393,6 +446,7 @@ bool IntrospectionManager::UpdateFilterImpl(const std::string &_filterId,
     }
   }
 
+  this->dataPtr->filtersChanged = true;
   return true;
 }
 
@@ -441,6 +495,7 @@ bool IntrospectionManager::RemoveFilterImpl(const std::string &_filterId)
       this->dataPtr->observedItems.erase(oldItem);
   }
 
+  this->dataPtr->filtersChanged = true;
   return true;
 }
 
@@ -459,11 +514,22 @@ bool IntrospectionManager::NewFilter(const gazebo::msgs::Param_V &_req,
   }
 
   std::set<std::string> requestedItems;
+  double rate = 0;
 
   // Store the new filter.
   for (auto i = 0; i < _req.param_size(); ++i)
   {
     auto param = _req.param(i);
+    if (param.name() == "rate")
+    {
+      if (!this->ValidateRate(param, rate))
+      {
+        gzwarn << "Ignoring request." << std::endl;
+        return false;
+      }
+      continue;
+    }
+
     if (!this->ValidateParameter(param, {"item"}))
     {
       gzwarn << "Invalid parameter[" << param.name() << "] "
@@ -476,7 +542,14 @@ bool IntrospectionManager::NewFilter(const gazebo::msgs::Param_V &_req,
   }
 
   std::string topicName;
-  if (!this->NewFilterImpl(requestedItems, topicName))
+  if (requestedItems.empty())
+  {
+    gzwarn << "Filter request without items." << std::endl;
+    gzwarn << "Ignoring request." << std::endl;
+    return false;
+  }
+
+  if (!this->NewFilterImpl(requestedItems, rate, topicName))
   {
     gzwarn << "Ignoring request." << std::endl;
     return false;
@@ -501,10 +574,21 @@ bool IntrospectionManager::UpdateFilter(const gazebo::msgs::Param_V &_req,
 
   std::set<std::string> newItems;
   std::string filterId;
+  double rate = -1;
 
   for (auto i = 0; i < _req.param_size(); ++i)
   {
     auto param = _req.param(i);
+    if (param.name() == "rate")
+    {
+      if (!this->ValidateRate(param, rate))
+      {
+        gzwarn << "Ignoring request." << std::endl;
+        return false;
+      }
+      continue;
+    }
+
     if (!this->ValidateParameter(param, {"item", "filter_id"}))
     {
       gzwarn << "Ignoring request." << std::endl;
@@ -545,7 +629,7 @@ bool IntrospectionManager::UpdateFilter(const gazebo::msgs::Param_V &_req,
     return false;
   }
 
-  return this->UpdateFilterImpl(filterId, newItems);
+  return this->UpdateFilterImpl(filterId, newItems, rate);
 }
 
 //////////////////////////////////////////////////
@@ -642,3 +726,26 @@ bool IntrospectionManager::ValidateParameter(const gazebo::msgs::Param &_msg,
 
   return true;
 }
+
+//////////////////////////////////////////////////
+bool IntrospectionManager::ValidateRate(const gazebo::msgs::Param &_msg,
+    double &_rate) const
+{
+  if (!_msg.has_value() ||
+      _msg.value().type() != gazebo::msgs::Any::DOUBLE ||
+      !_msg.value().has_double_value())
+  {
+    gzwarn << "Expected a 'rate' parameter with DOUBLE value." << std::endl;
+    return false;
+  }
+
+  const double rate = _msg.value().double_value();
+  if (!(rate >= 0))
+  {
+    gzwarn << "Invalid filter rate [" << rate << "]." << std::endl;
+    return false;
+  }
+
+  _rate = rate;
+  return true;
+}
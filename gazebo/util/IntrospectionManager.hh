@@ -86,7 +86,9 @@ namespace gazebo
       /// \brief Update all the items under observation and publish updates
       /// through all the topics. The message received in the update will
       /// contain the name and latest values of all the items specified
-      /// in the filter.
+      /// in the filter. Filters with an update rate are only published when
+      /// their period has elapsed, and only the items of the published
+      /// filters are sampled.
       /// If there are changes in the items list since the last update,
       /// a new message is published under the topic
       /// "/introspection/<manager_id>/items_update".
@@ -115,20 +117,25 @@ namespace gazebo
       /// will create a new topic for sending periodic updates of the items
       /// specified in the filter.
       /// \param[in] _newItems Non-empty set of items to observe.
+      /// \param[in] _rate Update rate in Hz, 0 to publish on every update.
       /// \param[out] _filterId Unique ID of the filter. You'll need this ID
       /// for future filter updates or for removing it. After the filter
       /// creation, a client should subscribe to the topic
       /// /introspection/filter/<filter_id> for receiving updates.
       /// \return True if the filter was successfully created or false otherwise
       private: bool NewFilterImpl(const std::set<std::string> &_newItems,
+                                  const double _rate,
                                   std::string &_filterId);
 
       /// \brief Update an existing filter with a different set of items.
       /// \param[in] _filterId ID of the filter to update.
       /// \param[in] _newItems Non-empty set of items to be observed.
+      /// \param[in] _rate Update rate in Hz, 0 to publish on every update,
+      /// negative to keep the current rate.
       /// \return True if the filter was successfuly updated or false otherwise.
       private: bool UpdateFilterImpl(const std::string &_filterId,
-                                     const std::set<std::string> &_newItems);
+                                     const std::set<std::string> &_newItems,
+                                     const double _rate);
 
       /// \brief Remove an existing filter.
       /// \param[in] _filterId ID of the filter to remove.
@@ -139,6 +146,8 @@ namespace gazebo
       /// \param[in] _req Input parameter of the service request. The service
       /// expects a collection of one or more parameters with name "item" and a
       /// value of type STRING containing the name of the item to observe.
+      /// An optional parameter with name "rate" and a value of type DOUBLE
+      /// sets the update rate of the filter in Hz.
       /// \param[out] _rep Output parameter of the service request. It contains
       /// the filter ID created.
       /// \return True when the operation succeed or false
@@ -152,6 +161,8 @@ namespace gazebo
       /// containing the filter ID to be updated. Also, it's expected to have
       /// a collection of one or more parameters with name "item" and a
       /// value of type STRING containing the name of the item to observe.
+      /// An optional parameter with name "rate" and a value of type DOUBLE
+      /// changes the update rate of the filter in Hz.
       /// \param[out] _rep Not used.
       /// \return True when the filter was successfully updated or
       /// false otherwise.
@@ -193,6 +204,13 @@ namespace gazebo
       private: bool ValidateParameter(const gazebo::msgs::Param &_msg,
                              const std::set<std::string> &_allowedValues) const;
 
+      /// \brief Helper function for reading the rate parameter of a filter.
+      /// \param[in] _msg Parameter named "rate".
+      /// \param[out] _rate The rate in Hz.
+      /// \return True when the value is a non-negative DOUBLE.
+      private: bool ValidateRate(const gazebo::msgs::Param &_msg,
+                                 double &_rate) const;
+
       /// \brief This is a singleton.
       private: friend class SingletonT<IntrospectionManager>;
 
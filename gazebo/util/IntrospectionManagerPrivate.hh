@@ -17,11 +17,15 @@
 #ifndef GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 #define GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 #include <ignition/transport.hh>
 #include "gazebo/msgs/any.pb.h"
 #include "gazebo/msgs/param_v.pb.h"
@@ -37,21 +41,63 @@ namespace gazebo
       /// \brief Items observed by this filter.
       std::set<std::string> items;
 
-      /// \brief Message containing the next update. A message is a collection
-      /// of items and values.
-      msgs::Param_V msg;
+      /// \brief Update rate in Hz, 0 to publish on every update.
+      double rate = 0;
     };
 
-    /// \brief Todo.
+    /// \brief An item observed by at least one filter.
     struct ObservedItem
     {
-      /// \brief ToDo.
-      gazebo::msgs::Any lastValue;
-
-      /// \brief ToDo.
+      /// \brief Filters containing the item.
       std::set<std::string> filters;
     };
 
+    /// \brief A registered item used by the compiled filters.
+    struct CompiledItem
+    {
+      /// \brief Name of the item.
+      std::string name;
+
+      /// \brief Callback returning the value of the item.
+      std::function<gazebo::msgs::Any ()> callback;
+
+      /// \brief Last value of the item.
+      gazebo::msgs::Any value;
+
+      /// \brief True if the last callback succeeded.
+      bool valid = false;
+
+      /// \brief Update in which the item was last sampled.
+      uint64_t sampledUpdate = 0;
+    };
+
+    /// \brief A filter prepared for the updates, which doesn't need the
+    /// manager mutex.
+    struct CompiledFilter
+    {
+      /// \brief ID of the filter.
+      std::string id;
+
+      /// \brief Topic of the filter.
+      std::string topic;
+
+      /// \brief Publisher of the filter updates.
+      ignition::transport::Node::Publisher publisher;
+
+      /// \brief Indices of the registered items of the filter in
+      /// IntrospectionManagerPrivate::compiledItems.
+      std::vector<size_t> items;
+
+      /// \brief Time between two updates, zero to publish on every update.
+      std::chrono::steady_clock::duration period{0};
+
+      /// \brief Time of the next update.
+      std::chrono::steady_clock::time_point nextUpdate;
+
+      /// \brief Message of the filter, reused by the updates.
+      msgs::Param_V msg;
+    };
+
     /// \brief Private data for the IntrospectionManager class.
     class IntrospectionManagerPrivate
     {
@@ -102,6 +148,26 @@ namespace gazebo
 
       /// \brief Items update publisher for ignition transport.
       public: ignition::transport::Node::Publisher itemsUpdatePub;
+
+      /// \brief Rebuild compiledItems and compiledFilters from the filters
+      /// and the registered items. Must be called with updateMutex locked.
+      public: void CompileFilters();
+
+      /// \brief True when the filters or the registered items changed since
+      /// the filters were compiled.
+      public: std::atomic<bool> filtersChanged{true};
+
+      /// \brief Items used by the compiled filters.
+      public: std::vector<CompiledItem> compiledItems;
+
+      /// \brief Filters used by the updates.
+      public: std::vector<CompiledFilter> compiledFilters;
+
+      /// \brief Number of updates, used to sample each item once per update.
+      public: uint64_t updateCount = 0;
+
+      /// \brief Serializes the updates, which use the compiled filters.
+      public: std::mutex updateMutex;
     };
   }
 }
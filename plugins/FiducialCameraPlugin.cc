@@ -19,9 +19,13 @@
 #include <functional>
 
 #include <ignition/common/Profiler.hh>
+#include <ignition/math/Frustum.hh>
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Vector2.hh>
 
+#include <gazebo/physics/Model.hh>
+#include <gazebo/physics/PhysicsIface.hh>
+#include <gazebo/physics/World.hh>
 #include <gazebo/sensors/CameraSensor.hh>
 #include <gazebo/rendering/Camera.hh>
 #include <gazebo/rendering/Conversions.hh>
@@ -74,6 +78,10 @@ namespace gazebo
     /// \brief Pointer to the scene.
     public: rendering::ScenePtr scene;
 
+    /// \brief Pointer to the world, used to find the models in the camera
+    /// frustum when all the models are tracked.
+    public: physics::WorldPtr world;
+
     /// \brief Publish the results
     /// \param[in] _results Fiducial data containing id and location in image.
     public: void Publish(const std::vector<FiducialData> &_results) const;
@@ -125,6 +133,12 @@ void FiducialCameraPlugin::Load(sensors::SensorPtr _sensor,
     gzmsg << "No fiducials specified. All models will be tracked."
         << std::endl;
     this->dataPtr->detectAll = true;
+
+    if (physics::has_world(this->dataPtr->parentSensor->WorldName()))
+    {
+      this->dataPtr->world =
+          physics::get_world(this->dataPtr->parentSensor->WorldName());
+    }
   }
 
   this->dataPtr->parentSensor->SetActive(true);
@@ -172,6 +186,28 @@ void FiducialCameraPlugin::PopulateFiducials()
 {
   this->dataPtr->fiducials.clear();
 
+  // Only check the models in the camera frustum, as found in the tree of
+  // model bounding boxes kept by the world
+  if (this->dataPtr->world)
+  {
+    const rendering::CameraPtr &camera = this->dataPtr->camera;
+    ignition::math::Frustum frustum(camera->NearClip(), camera->FarClip(),
+        camera->HFOV(), camera->AspectRatio(), camera->WorldPose());
+
+    for (auto const &model : this->dataPtr->world->ModelsInFrustum(frustum))
+    {
+      // Nested models are part of the visual of their top level model
+      physics::BasePtr top = model;
+      while (top->GetParent() &&
+          top->GetParent()->HasType(physics::Base::MODEL))
+      {
+        top = top->GetParent();
+      }
+      this->dataPtr->fiducials.insert(top->GetName());
+    }
+    return;
+  }
+
   // Check all models for inclusion in the frustum.
   rendering::VisualPtr worldVis = this->dataPtr->scene->WorldVisual();
   for (unsigned int i = 0; i < worldVis->GetChildCount(); ++i)
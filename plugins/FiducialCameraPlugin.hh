@@ -60,8 +60,8 @@ namespace gazebo
         const unsigned int _width, const unsigned int _height,
         const unsigned int _depth, const std::string &_format);
 
-    /// \brief Helper function to fill the list of fiducials with all models
-    /// in the world if none are specified
+    /// \brief Helper function to fill the list of fiducials with the models
+    /// in the camera frustum if none are specified
     private: void PopulateFiducials();
 
     /// \internal
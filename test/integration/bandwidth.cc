@@ -15,6 +15,11 @@
  *
 */
 
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gazebo/msgs/PoseStream.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/test/helper_physics_generator.hh"
 
@@ -97,6 +102,95 @@ TEST_P(BandwidthTest, Bandwidth)
 
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, BandwidthTest, PHYSICS_ENGINE_VALUES,);  // NOLINT
 
+std::vector<int> g_legacyBytes;
+std::vector<int> g_compactBytes;
+msgs::PoseStreamDecoder g_decoder;
+std::map<uint32_t, ignition::math::Pose3d> g_compactPoses;
+
+void LegacyPoseMsg(const std::string &_msg)
+{
+  boost::mutex::scoped_lock lock(g_mutex);
+  g_legacyBytes.push_back(_msg.size());
+}
+
+void CompactPoseBytes(const std::string &_msg)
+{
+  boost::mutex::scoped_lock lock(g_mutex);
+  g_compactBytes.push_back(_msg.size());
+}
+
+void CompactPoseMsg(ConstPosesCompactPtr &_msg)
+{
+  boost::mutex::scoped_lock lock(g_mutex);
+  g_decoder.Decode(*_msg,
+      [](const uint32_t _id, const ignition::math::Pose3d &_pose)
+      {
+        g_compactPoses[_id] = _pose;
+      });
+}
+
+/////////////////////////////////////////////////
+// The compact pose stream has the same poses as ~/pose/info in fewer bytes
+TEST_F(BandwidthTest, CompactPoses)
+{
+  Load("worlds/pr2.world", false, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+
+  transport::SubscriberPtr legacySub =
+      node->Subscribe("/gazebo/default/pose/info", LegacyPoseMsg);
+  transport::SubscriberPtr compactBytesSub =
+      node->Subscribe("/gazebo/default/pose/compact/info", CompactPoseBytes);
+  transport::SubscriberPtr compactSub =
+      node->Subscribe("/gazebo/default/pose/compact/info", CompactPoseMsg);
+
+  int sleep = 0;
+  while (sleep++ < 300)
+  {
+    common::Time::MSleep(100);
+    boost::mutex::scoped_lock lock(g_mutex);
+    if (g_legacyBytes.size() >= 100 && g_compactBytes.size() >= 100)
+      break;
+  }
+
+  world->SetPaused(true);
+  common::Time::MSleep(500);
+
+  boost::mutex::scoped_lock lock(g_mutex);
+  ASSERT_GE(g_legacyBytes.size(), 100u);
+  ASSERT_GE(g_compactBytes.size(), 100u);
+
+  double legacyMean = 0;
+  for (auto const bytes : g_legacyBytes)
+    legacyMean += bytes;
+  legacyMean /= g_legacyBytes.size();
+
+  double compactMean = 0;
+  for (auto const bytes : g_compactBytes)
+    compactMean += bytes;
+  compactMean /= g_compactBytes.size();
+
+  gzdbg << "Mean pose message size: legacy[" << legacyMean << " B] compact["
+        << compactMean << " B]\n";
+  EXPECT_LT(compactMean, legacyMean);
+
+  // The decoded poses and names match the world
+  physics::ModelPtr pr2 = world->ModelByName("pr2");
+  ASSERT_TRUE(pr2 != nullptr);
+  ASSERT_FALSE(g_compactPoses.empty());
+  for (auto const &link : pr2->GetLinks())
+  {
+    auto iter = g_compactPoses.find(link->GetId());
+    ASSERT_TRUE(iter != g_compactPoses.end()) << link->GetScopedName();
+    EXPECT_EQ(link->GetScopedName(), g_decoder.Name(link->GetId()));
+    EXPECT_NEAR(iter->second.Pos().Distance(link->RelativePose().Pos()), 0,
+        1e-3) << link->GetScopedName();
+  }
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -70,6 +70,11 @@ class HeightmapTest : public ServerFixture,
   public: void TerrainCollision(const std::string &_physicsEngine,
                                 const std::string &_dartCollision = "");
 
+  /// \brief Test dropping a sphere on a heightmap whose collision is
+  /// served from a tile cache.
+  /// \param[in] _physicsEngine the physics engine to test
+  public: void TiledTerrainCollision(const std::string &_physicsEngine);
+
   /// \brief Test loading a heightmap that has no visuals
   public: void NoVisual();
 
@@ -884,6 +889,80 @@ void HeightmapTest::TerrainCollision(const std::string &_physicsEngine,
   EXPECT_GE(spherePose.Pos().Z(), (minHeight + radius*0.99));
 }
 
+/////////////////////////////////////////////////
+void HeightmapTest::TiledTerrainCollision(const std::string &_physicsEngine)
+{
+  if (_physicsEngine != "ode" && _physicsEngine != "bullet")
+  {
+    gzerr << "Heightmap tiling is not supported by " << _physicsEngine
+          << ", skipping test." << std::endl;
+    return;
+  }
+
+  Load("worlds/heightmap_test_with_sphere_tiled.world", true, _physicsEngine);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_NE(world, nullptr);
+
+  physics::ModelPtr heightmap = GetModel("heightmap");
+  ASSERT_NE(heightmap, nullptr);
+
+  physics::HeightmapShapePtr heightmapShape =
+    boost::dynamic_pointer_cast<physics::HeightmapShape>(
+        heightmap->GetLink("link")->GetCollision("collision")->GetShape());
+  ASSERT_NE(heightmapShape, nullptr);
+  EXPECT_TRUE(heightmapShape->TilingEnabled());
+  EXPECT_TRUE(heightmapShape->GetMaxHeight() > heightmapShape->GetMinHeight());
+
+  // The heights come from the tile cache
+  auto vertexCount = heightmapShape->VertexCount();
+  common::Image image = heightmapShape->GetImage();
+  EXPECT_EQ(image.GetWidth(),
+      static_cast<unsigned int>((vertexCount.X() + 1) /
+        heightmapShape->GetSubSampling()));
+
+  physics::ModelPtr sphere = GetModel("test_sphere");
+  ASSERT_NE(sphere, nullptr);
+
+  // Nothing needs to be resident far away from the sphere
+  heightmapShape->UpdateTiles({});
+  EXPECT_EQ(heightmapShape->ResidentTileCount(), 0u);
+
+  // Requests for the heights don't map the tiles
+  msgs::Geometry msg;
+  heightmapShape->FillHeights(msg);
+  EXPECT_EQ(heightmapShape->ResidentTileCount(), 0u);
+  ASSERT_EQ(msg.heightmap().heights_size(), vertexCount.X() * vertexCount.Y());
+  for (int y = 0; y < vertexCount.Y(); y += 7)
+  {
+    for (int x = 0; x < vertexCount.X(); x += 7)
+    {
+      EXPECT_FLOAT_EQ(msg.heightmap().heights(y * vertexCount.X() + x),
+          heightmapShape->GetHeight(x, vertexCount.Y() - y - 1));
+    }
+  }
+  heightmapShape->UpdateTiles({});
+
+  if (_physicsEngine == "bullet")
+  {
+    gzerr << "Skipping collision check for bullet. See issue #2506"
+          << std::endl;
+    return;
+  }
+
+  world->Step(5000);
+
+  // The tiles under the sphere are resident
+  EXPECT_GT(heightmapShape->ResidentTileCount(), 0u);
+
+  // verify that the sphere has rolled to the valley
+  double minHeight = heightmapShape->GetMinHeight();
+  double radius = 0.5;
+  ignition::math::Pose3d spherePose = sphere->WorldPose();
+  EXPECT_LE(spherePose.Pos().Z(), (minHeight + radius*1.01));
+  EXPECT_GE(spherePose.Pos().Z(), (minHeight + radius*0.99));
+}
+
 /////////////////////////////////////////////////
 TEST_F(HeightmapTest, NotSquareImage)
 {
@@ -1083,6 +1162,12 @@ TEST_P(HeightmapTest, MaterialShader)
 }
 #endif
 
+/////////////////////////////////////////////////
+TEST_P(HeightmapTest, TiledTerrainCollision)
+{
+  TiledTerrainCollision(GetParam());
+}
+
 /////////////////////////////////////////////////
 TEST_F(HeightmapTest, NoVisual)
 {
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/physics/physics.hh"
+
+#define PHYSICS_TOL 1e-2
+using namespace gazebo;
+
+class PhysicsBulletThreadsTest : public ServerFixture
+{
+  /// \brief Spawn falling shapes and a pendulum in an empty Bullet world,
+  /// step it and get the final link poses.
+  /// \param[in] _threads Number of Bullet threads.
+  /// \param[in] _steps Number of steps.
+  /// \return Pose of every link, by scoped name.
+  public: std::map<std::string, ignition::math::Pose3d> Run(
+              const int _threads, const unsigned int _steps);
+};
+
+/////////////////////////////////////////////////
+std::map<std::string, ignition::math::Pose3d> PhysicsBulletThreadsTest::Run(
+    const int _threads, const unsigned int _steps)
+{
+  std::map<std::string, ignition::math::Pose3d> poses;
+
+  this->Load("worlds/blank.world", true, "bullet");
+  physics::WorldPtr world = physics::get_world("default");
+  EXPECT_TRUE(world != nullptr);
+  if (!world)
+    return poses;
+
+  // Bullet only switches between single and multithreaded stepping while
+  // the world is empty
+  physics::PhysicsEnginePtr physics = world->Physics();
+  EXPECT_EQ(physics->GetType(), "bullet");
+  EXPECT_TRUE(physics->SetParam("threads", _threads));
+  EXPECT_EQ(_threads, boost::any_cast<int>(physics->GetParam("threads")));
+
+  this->SpawnBox("ground", ignition::math::Vector3d(100, 100, 1),
+      ignition::math::Vector3d(0, 0, -0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  // Tilted shapes which tumble when they land, and a stack of boxes
+  for (int i = 0; i < 3; ++i)
+  {
+    const ignition::math::Vector3d rpy(0.3 * i, 0.2, 0.1 * i);
+    this->SpawnBox("box_" + std::to_string(i), ignition::math::Vector3d::One,
+        ignition::math::Vector3d(3.0 * i, 0, 2 + i), rpy);
+    this->SpawnSphere("sphere_" + std::to_string(i),
+        ignition::math::Vector3d(3.0 * i, 3, 2 + i), rpy);
+    this->SpawnCylinder("cylinder_" + std::to_string(i),
+        ignition::math::Vector3d(3.0 * i, -3, 2 + i), rpy);
+    this->SpawnBox("stack_" + std::to_string(i), ignition::math::Vector3d::One,
+        ignition::math::Vector3d(-3, 0, 0.5 + i),
+        ignition::math::Vector3d::Zero);
+  }
+
+  // A pendulum, so that the solver has joint constraints
+  std::ostringstream pendulumStr;
+  pendulumStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='pendulum'><pose>0 -6 2 0 0 0</pose>"
+    << "<link name='bob'><pose>0.5 0 0 0 0 0</pose>"
+    << "<collision name='collision'><geometry><sphere><radius>0.1</radius>"
+    << "</sphere></geometry></collision></link>"
+    << "<joint name='hinge' type='revolute'>"
+    << "<parent>world</parent><child>bob</child>"
+    << "<pose>-0.5 0 0 0 0 0</pose><axis><xyz>0 1 0</xyz></axis>"
+    << "</joint></model></sdf>";
+  this->SpawnSDF(pendulumStr.str());
+
+  world->Step(_steps);
+
+  for (auto const &model : world->Models())
+  {
+    for (auto const &link : model->GetLinks())
+      poses[link->GetScopedName()] = link->WorldPose();
+  }
+
+  this->Unload();
+  return poses;
+}
+
+/////////////////////////////////////////////////
+// The multithreaded pipeline gives the same motion as the single-threaded
+// one
+TEST_F(PhysicsBulletThreadsTest, SameBehavior)
+{
+#ifndef HAVE_BULLET
+  gzerr << "Bullet is not available, skipping test" << std::endl;
+#else
+  const unsigned int steps = 2000;
+
+  auto single = this->Run(1, steps);
+  auto multi = this->Run(4, steps);
+
+  ASSERT_FALSE(single.empty());
+  ASSERT_EQ(single.size(), multi.size());
+  for (auto const &pose : single)
+  {
+    auto iter = multi.find(pose.first);
+    ASSERT_TRUE(iter != multi.end()) << pose.first;
+    EXPECT_NEAR(pose.second.Pos().Distance(iter->second.Pos()), 0.0,
+        PHYSICS_TOL) << pose.first;
+    EXPECT_NEAR((pose.second.Rot().Inverse() * iter->second.Rot()).Euler(
+          ).Length(), 0.0, PHYSICS_TOL) << pose.first;
+  }
+#endif
+}
+
+/////////////////////////////////////////////////
+TEST_F(PhysicsBulletThreadsTest, Param)
+{
+#ifndef HAVE_BULLET
+  gzerr << "Bullet is not available, skipping test" << std::endl;
+#else
+  Load("worlds/blank.world", true, "bullet");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  ASSERT_EQ(physics->GetType(), "bullet");
+
+  // Single-threaded by default
+  EXPECT_EQ(1, boost::any_cast<int>(physics->GetParam("threads")));
+  EXPECT_EQ("default",
+      boost::any_cast<std::string>(physics->GetParam("task_scheduler")));
+
+  // Invalid values
+  EXPECT_FALSE(physics->SetParam("threads", -1));
+  EXPECT_FALSE(physics->SetParam("task_scheduler", std::string("bogus")));
+  EXPECT_EQ(1, boost::any_cast<int>(physics->GetParam("threads")));
+
+  // The world is empty, so it can switch to multithreaded stepping
+  EXPECT_TRUE(physics->SetParam("task_scheduler", std::string("sequential")));
+  EXPECT_TRUE(physics->SetParam("threads", 2));
+  EXPECT_EQ(2, boost::any_cast<int>(physics->GetParam("threads")));
+  EXPECT_EQ("sequential",
+      boost::any_cast<std::string>(physics->GetParam("task_scheduler")));
+
+  // Solver parameters are kept
+  EXPECT_TRUE(physics->SetParam("iters", 37));
+  EXPECT_TRUE(physics->SetParam("threads", 0));
+  EXPECT_TRUE(physics->SetParam("threads", 2));
+  EXPECT_EQ(37, boost::any_cast<int>(physics->GetParam("iters")));
+
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  // The thread count can change at any time, but not the pipeline
+  EXPECT_FALSE(physics->SetParam("threads", 1));
+  EXPECT_EQ(2, boost::any_cast<int>(physics->GetParam("threads")));
+  EXPECT_TRUE(physics->SetParam("threads", 3));
+  EXPECT_TRUE(physics->SetParam("task_scheduler", std::string("default")));
+
+  // Free fall
+  const double dt = physics->GetMaxStepSize();
+  const unsigned int steps = 500;
+  world->Step(steps);
+  const double t = dt * steps;
+  EXPECT_NEAR(box->WorldPose().Pos().Z(), 5.0 - 0.5 * 9.8 * t * t,
+      PHYSICS_TOL);
+#endif
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
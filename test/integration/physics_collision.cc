@@ -15,6 +15,7 @@
  *
 */
 #include <map>
+#include <sstream>
 #include <string>
 #include <ignition/math/Helpers.hh>
 
@@ -361,6 +362,138 @@ TEST_P(PhysicsCollisionTest, PoseOffsets)
   PoseOffsets(GetParam());
 }
 
+/////////////////////////////////////////////////
+// DART contacts are grouped per link pair, and max_contacts caps the
+// contacts DART detects
+TEST_F(PhysicsCollisionTest, DARTContactGrouping)
+{
+#ifndef HAVE_DART
+  gzdbg << "Not testing DART because it is not installed." << std::endl;
+#else
+  Load("worlds/empty.world", true, "dart");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  EXPECT_FALSE(boost::any_cast<std::string>(
+        physics->GetParam("collision_detector")).empty());
+
+  physics::ContactManager *mgr = physics->GetContactManager();
+  ASSERT_TRUE(mgr != nullptr);
+  mgr->SetNeverDropContacts(true);
+
+  SpawnBox("box1", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero);
+  SpawnBox("box2", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(3, 0, 0.5), ignition::math::Vector3d::Zero);
+  world->Step(100);
+
+  // One contact per box and ground pair
+  ASSERT_EQ(2u, mgr->GetContactCount());
+  for (unsigned int i = 0; i < mgr->GetContactCount(); ++i)
+  {
+    physics::Contact *contact = mgr->GetContact(i);
+    ASSERT_TRUE(contact != nullptr);
+    EXPECT_GT(contact->count, 0);
+    EXPECT_LE(contact->count,
+        boost::any_cast<int>(physics->GetParam("max_contacts")));
+    EXPECT_NE(contact->collision1->GetLink(), contact->collision2->GetLink());
+  }
+
+  EXPECT_FALSE(physics->SetParam("max_contacts", -1));
+  EXPECT_TRUE(physics->SetParam("max_contacts", 1));
+  EXPECT_EQ(1, boost::any_cast<int>(physics->GetParam("max_contacts")));
+  world->Step(1);
+
+  // DART stops looking for contacts once it found max_contacts of them
+  ASSERT_EQ(1u, mgr->GetContactCount());
+  EXPECT_EQ(1, mgr->GetContact(0)->count);
+
+  EXPECT_TRUE(physics->SetParam("max_contacts", 20));
+  world->Step(1);
+  EXPECT_EQ(2u, mgr->GetContactCount());
+#endif
+}
+
+/////////////////////////////////////////////////
+// DART contacts follow models as they are added and removed, including
+// models with nested models
+TEST_F(PhysicsCollisionTest, DARTContactsNestedModels)
+{
+#ifndef HAVE_DART
+  gzdbg << "Not testing DART because it is not installed." << std::endl;
+#else
+  Load("worlds/empty.world", true, "dart");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ContactManager *mgr = world->Physics()->GetContactManager();
+  ASSERT_TRUE(mgr != nullptr);
+  mgr->SetNeverDropContacts(true);
+
+  SpawnBox("box1", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero);
+
+  // DART doesn't load the links of models with nested models, but their
+  // contacts must not be mistaken for the contacts of other links
+  std::ostringstream nestedStr;
+  nestedStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='outer'>"
+    << "  <pose>3 0 0.5 0 0 0</pose>"
+    << "  <link name='link'>"
+    << "    <collision name='collision'>"
+    << "      <geometry><box><size>1 1 1</size></box></geometry>"
+    << "    </collision>"
+    << "  </link>"
+    << "  <model name='inner'>"
+    << "    <pose>0 3 0 0 0 0</pose>"
+    << "    <link name='link'>"
+    << "      <collision name='collision'>"
+    << "        <geometry><box><size>1 1 1</size></box></geometry>"
+    << "      </collision>"
+    << "    </link>"
+    << "  </model>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(nestedStr.str());
+
+  world->Step(100);
+  for (unsigned int i = 0; i < mgr->GetContactCount(); ++i)
+  {
+    physics::Contact *contact = mgr->GetContact(i);
+    ASSERT_TRUE(contact != nullptr);
+    ASSERT_TRUE(contact->collision1 != nullptr);
+    ASSERT_TRUE(contact->collision2 != nullptr);
+    EXPECT_NE(contact->collision1->GetLink(), contact->collision2->GetLink());
+  }
+  EXPECT_GE(mgr->GetContactCount(), 1u);
+  const unsigned int count = mgr->GetContactCount();
+
+  // Removing a model removes its contacts
+  world->RemoveModel("box1");
+  world->Step(10);
+  EXPECT_EQ(count - 1, mgr->GetContactCount());
+
+  // A new model gets contacts
+  SpawnBox("box2", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(-3, 0, 0.5), ignition::math::Vector3d::Zero);
+  world->Step(100);
+  EXPECT_EQ(count, mgr->GetContactCount());
+  bool found = false;
+  for (unsigned int i = 0; i < mgr->GetContactCount(); ++i)
+  {
+    physics::Contact *contact = mgr->GetContact(i);
+    if (contact->collision1->GetLink()->GetModel()->GetName() == "box2" ||
+        contact->collision2->GetLink()->GetModel()->GetName() == "box2")
+    {
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+#endif
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, PhysicsCollisionTest,
                         PHYSICS_ENGINE_VALUES,);  // NOLINT
 
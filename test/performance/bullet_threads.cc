@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <string>
+
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class BulletThreadsTest : public ServerFixture
+{
+  /// \brief Step a world of box stacks and measure the wall time.
+  /// \param[in] _threads Number of Bullet threads.
+  /// \return Wall time of the steps.
+  public: common::Time StepStacks(const int _threads);
+
+  /// \brief Number of stacks per side of the grid.
+  public: static const unsigned int kStacksPerSide = 10;
+
+  /// \brief Number of boxes per stack.
+  public: static const unsigned int kStackHeight = 5;
+
+  /// \brief Number of steps to measure.
+  public: static const unsigned int kSteps = 1000;
+};
+
+/////////////////////////////////////////////////
+common::Time BulletThreadsTest::StepStacks(const int _threads)
+{
+  this->Load("worlds/blank.world", true, "bullet");
+  physics::WorldPtr world = physics::get_world("default");
+  EXPECT_TRUE(world != nullptr);
+  if (!world)
+    return common::Time::Zero;
+
+  // Bullet only switches between single and multithreaded stepping while
+  // the world is empty
+  EXPECT_TRUE(world->Physics()->SetParam("threads", _threads));
+  EXPECT_EQ(_threads,
+      boost::any_cast<int>(world->Physics()->GetParam("threads")));
+
+  this->SpawnBox("ground", ignition::math::Vector3d(100, 100, 1),
+      ignition::math::Vector3d(0, 0, -0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  // Each stack is a separate simulation island. The boxes are links of a
+  // single model, so that they are spawned at once.
+  std::ostringstream stacksStr;
+  stacksStr << "<sdf version='" << SDF_VERSION << "'><model name='stacks'>";
+  for (unsigned int x = 0; x < kStacksPerSide; ++x)
+  {
+    for (unsigned int y = 0; y < kStacksPerSide; ++y)
+    {
+      for (unsigned int z = 0; z < kStackHeight; ++z)
+      {
+        stacksStr << "<link name='box_" << x << "_" << y << "_" << z << "'>"
+          << "<pose>" << x * 2.0 << " " << y * 2.0 << " " << z + 0.5
+          << " 0 0 0</pose>"
+          << "<collision name='collision'><geometry><box>"
+          << "<size>1 1 1</size></box></geometry></collision></link>";
+      }
+    }
+  }
+  stacksStr << "</model></sdf>";
+  this->SpawnSDF(stacksStr.str());
+
+  physics::ModelPtr stacks = world->ModelByName("stacks");
+  EXPECT_TRUE(stacks != nullptr);
+  if (!stacks)
+    return common::Time::Zero;
+
+  common::Time startTime = common::Time::GetWallTime();
+  world->Step(kSteps);
+  common::Time elapsed = common::Time::GetWallTime() - startTime;
+
+  // The stacks are resting on the ground
+  physics::LinkPtr top = stacks->GetLink("box_0_0_" +
+      std::to_string(kStackHeight - 1));
+  EXPECT_TRUE(top != nullptr);
+  if (top)
+    EXPECT_NEAR(top->WorldPose().Pos().Z(), kStackHeight - 0.5, 0.05);
+
+  this->Unload();
+  return elapsed;
+}
+
+/////////////////////////////////////////////////
+TEST_F(BulletThreadsTest, Scaling)
+{
+#ifndef HAVE_BULLET
+  gzerr << "Bullet is not available, skipping test" << std::endl;
+#else
+  common::Time single = this->StepStacks(1);
+  gzdbg << "Bullet threads[1] time[" << single << "]\n";
+
+  for (int threads : {2, 4, 8})
+  {
+    common::Time multi = this->StepStacks(threads);
+    gzdbg << "Bullet threads[" << threads << "] time[" << multi
+          << "] speedup[" << single.Double() / multi.Double() << "]\n";
+  }
+#endif
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class MultiWorldTest : public ServerFixture
+{
+  /// \brief Load copies of a world of falling boxes in one server, run them
+  /// for a while and measure the total number of steps per second.
+  /// \param[in] _path World file.
+  /// \param[in] _copies Number of copies of the world.
+  /// \return Total steps per second of all the copies.
+  public: double Throughput(const std::string &_path,
+              const unsigned int _copies);
+
+  /// \brief Number of boxes in test/worlds/multi_world_boxes.world.
+  public: static const unsigned int kBoxCount = 20;
+};
+
+/////////////////////////////////////////////////
+double MultiWorldTest::Throughput(const std::string &_path,
+    const unsigned int _copies)
+{
+  this->LoadArgs(_path + " -u --world_copies " + std::to_string(_copies));
+
+  physics::World_V worlds = physics::get_worlds();
+  EXPECT_EQ(worlds.size(), _copies);
+  if (worlds.size() != _copies)
+    return 0;
+
+  for (unsigned int i = 0; i < worlds.size(); ++i)
+  {
+    if (_copies > 1)
+      EXPECT_EQ(worlds[i]->Name(), "default_" + std::to_string(i));
+    EXPECT_EQ(worlds[i]->ModelCount(), kBoxCount + 1);
+  }
+
+  std::vector<uint64_t> startIterations;
+  for (auto const &world : worlds)
+    startIterations.push_back(world->Iterations());
+
+  common::Time startTime = common::Time::GetWallTime();
+  for (auto const &world : worlds)
+    world->SetPaused(false);
+
+  common::Time::Sleep(common::Time(2, 0));
+
+  for (auto const &world : worlds)
+    world->SetPaused(true);
+  double elapsed = (common::Time::GetWallTime() - startTime).Double();
+
+  uint64_t steps = 0;
+  for (unsigned int i = 0; i < worlds.size(); ++i)
+  {
+    // Every copy made progress
+    EXPECT_GT(worlds[i]->Iterations(), startIterations[i]);
+    steps += worlds[i]->Iterations() - startIterations[i];
+  }
+
+  // The copies are independent
+  if (worlds.size() > 1)
+  {
+    worlds[0]->RemoveModel("box_0");
+    EXPECT_TRUE(worlds[0]->ModelByName("box_0") == nullptr);
+    EXPECT_TRUE(worlds[1]->ModelByName("box_0") != nullptr);
+  }
+
+  double throughput = steps / elapsed;
+  gzdbg << "World copies[" << _copies << "] total steps per second["
+        << throughput << "]\n";
+
+  this->Unload();
+  return throughput;
+}
+
+/////////////////////////////////////////////////
+TEST_F(MultiWorldTest, Throughput)
+{
+  const std::string path = "worlds/multi_world_boxes.world";
+  const unsigned int cpuCount =
+      std::max(1u, std::thread::hardware_concurrency());
+  double single = this->Throughput(path, 1);
+  for (unsigned int copies : {2u, 4u, cpuCount})
+  {
+    if (copies > 1 && copies <= cpuCount)
+    {
+      double total = this->Throughput(path, copies);
+      gzdbg << "Speedup with [" << copies << "] copies["
+            << (single > 0 ? total / single : 0) << "]\n";
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
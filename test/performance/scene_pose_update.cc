@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/rendering/RenderEngine.hh"
+#include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/Visual.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief Measures the cost of applying pose updates in Scene::PreRender.
+/// The scene is the server scene of the fixture, which doesn't need a
+/// display, and there's no camera so the test is the only one rendering it.
+class ScenePoseUpdateTest : public ServerFixture
+{
+  /// \brief Spawn boxes in a blank world, then send pose updates of a part
+  /// of the boxes to the scene and measure the wall time of PreRender.
+  /// \param[in] _modelCount Number of boxes in the world.
+  public: void PoseUpdates(const unsigned int _modelCount);
+
+  /// \brief Number of frames measured for each number of updated poses.
+  public: static const unsigned int kFrames = 100;
+};
+
+/////////////////////////////////////////////////
+void ScenePoseUpdateTest::PoseUpdates(const unsigned int _modelCount)
+{
+  this->Load("worlds/blank.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Spawn the boxes without waiting for each of them
+  for (unsigned int i = 0; i < _modelCount; ++i)
+  {
+    std::ostringstream modelStr;
+    modelStr << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='box_" << i << "'><static>true</static>"
+      << "<pose>" << (i % 100) * 2.0 << " " << (i / 100) * 2.0
+      << " 0.5 0 0 0</pose><link name='link'>"
+      << "<visual name='visual'><geometry><box>"
+      << "<size>1 1 1</size></box></geometry></visual></link></model>"
+      << "</sdf>";
+
+    msgs::Factory msg;
+    msg.set_sdf(modelStr.str());
+    this->factoryPub->Publish(msg);
+  }
+
+  rendering::ScenePtr scene = this->GetScene();
+  ASSERT_TRUE(scene != nullptr);
+
+  // Create the visuals
+  const std::string lastName = "box_" + std::to_string(_modelCount - 1);
+  int sleep = 0;
+  while (!scene->GetVisual(lastName) && sleep++ < 1000)
+  {
+    scene->PreRender();
+    common::Time::MSleep(10);
+  }
+  ASSERT_TRUE(scene->GetVisual(lastName) != nullptr);
+
+  std::vector<uint32_t> ids;
+  for (unsigned int i = 0; i < _modelCount; ++i)
+  {
+    physics::ModelPtr model = world->ModelByName("box_" + std::to_string(i));
+    ASSERT_TRUE(model != nullptr);
+    ids.push_back(model->GetId());
+  }
+
+  // Frames without pose updates
+  common::Time startTime = common::Time::GetWallTime();
+  for (unsigned int f = 0; f < kFrames; ++f)
+    scene->PreRender();
+  double idleTime =
+      (common::Time::GetWallTime() - startTime).Double() / kFrames;
+  gzdbg << "Models[" << _modelCount << "] idle frame[" << idleTime << "]\n";
+
+  for (unsigned int changed : {1u, 10u, 100u, _modelCount})
+  {
+    changed = std::min(changed, _modelCount);
+
+    ignition::math::Pose3d pose;
+    msgs::PosesStamped msg;
+    double elapsed = 0;
+    for (unsigned int f = 0; f < kFrames; ++f)
+    {
+      msg.Clear();
+      msgs::Set(msg.mutable_time(), common::Time(f, 0));
+      pose.Pos().Z() = 1.0 + f * 0.01;
+      for (unsigned int i = 0; i < changed; ++i)
+      {
+        msgs::Pose *poseMsg = msg.add_pose();
+        pose.Pos().X() = (i % 100) * 2.0;
+        pose.Pos().Y() = (i / 100) * 2.0;
+        msgs::Set(poseMsg, pose);
+        poseMsg->set_id(ids[i]);
+        poseMsg->set_name("box_" + std::to_string(i));
+      }
+
+      scene->UpdatePoses(msg);
+      startTime = common::Time::GetWallTime();
+      scene->PreRender();
+      elapsed += (common::Time::GetWallTime() - startTime).Double();
+    }
+
+    gzdbg << "Models[" << _modelCount << "] changed poses[" << changed
+          << "] frame[" << elapsed / kFrames << "]\n";
+
+    // The last poses are applied
+    rendering::VisualPtr vis = scene->GetVisual("box_0");
+    ASSERT_TRUE(vis != nullptr);
+    EXPECT_NEAR(vis->WorldPose().Pos().Z(), pose.Pos().Z(), 1e-6);
+    EXPECT_EQ(scene->SimTime(), common::Time(kFrames - 1, 0));
+  }
+
+  this->Unload();
+}
+
+/////////////////////////////////////////////////
+TEST_F(ScenePoseUpdateTest, PreRender)
+{
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run scene test\n";
+    return;
+  }
+
+  for (unsigned int modelCount : {100u, 1000u})
+    this->PoseUpdates(modelCount);
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
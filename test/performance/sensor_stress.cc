@@ -16,8 +16,19 @@
 */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <string>
+#include <vector>
+
 #include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/common/Timer.hh"
+#include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/RenderingIface.hh"
+#include "gazebo/rendering/Scene.hh"
+#include "gazebo/sensors/CameraSensor.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -25,6 +36,10 @@ class SensorStress_TEST : public ServerFixture
 {
 };
 
+class SensorStressRendering_TEST : public RenderingFixture
+{
+};
+
 boost::condition_variable g_countCondition;
 
 // global variable and callback for tracking hokuyo sensor messages
@@ -100,6 +115,152 @@ TEST_F(SensorStress_TEST, ResetWorldStressTest)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Render a camera for a while and return the number of frames
+/// delivered per second.
+/// \param[in] _camera Camera to render.
+/// \param[in] _buffers Number of frames read at the same time.
+/// \return Frames delivered per wall clock second.
+double CameraThroughput(rendering::CameraPtr _camera,
+    const unsigned int _buffers)
+{
+  _camera->SetAsyncReadback(_buffers);
+
+  unsigned int frames = 0;
+  event::ConnectionPtr connection = _camera->ConnectNewImageFrame(
+      [&frames](const unsigned char *, unsigned int, unsigned int,
+        unsigned int, const std::string &)
+      {
+        ++frames;
+      });
+
+  // Warm up
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    _camera->Render(true);
+    _camera->PostRender();
+  }
+
+  frames = 0;
+  const unsigned int renders = 300;
+  common::Timer timer;
+  timer.Start();
+  for (unsigned int i = 0; i < renders; ++i)
+  {
+    _camera->Render(true);
+    _camera->PostRender();
+  }
+  const double elapsed = timer.GetElapsed().Double();
+
+  // At most _buffers - 1 frames are still being read
+  EXPECT_GE(frames + std::max(_buffers, 1u) - 1, renders);
+  return frames / elapsed;
+}
+
+/////////////////////////////////////////////////
+/// \brief Compare the frames per second delivered by a camera reading its
+/// frames synchronously and asynchronously.
+TEST_F(SensorStressRendering_TEST, CameraAsyncReadback)
+{
+  Load("worlds/shapes.world");
+
+  rendering::ScenePtr scene = rendering::get_scene("default");
+  if (!scene)
+    scene = rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("stress_camera", false);
+  ASSERT_TRUE(camera != nullptr);
+  camera->Load();
+  camera->Init();
+  camera->SetImageWidth(1280);
+  camera->SetImageHeight(960);
+  camera->CreateRenderTexture("stress_camera_texture");
+  camera->SetWorldPose(ignition::math::Pose3d(-5, 0, 1, 0, 0, 0));
+  camera->SetCaptureData(true);
+
+  const double syncRate = CameraThroughput(camera, 0);
+  gzdbg << "Synchronous readback: " << syncRate << " fps\n";
+
+  if (!camera->SetAsyncReadback(2))
+  {
+    gzwarn << "Asynchronous readback isn't supported, skipping\n";
+    scene->RemoveCamera(camera->Name());
+    return;
+  }
+
+  for (unsigned int buffers = 2; buffers <= 3; ++buffers)
+  {
+    const double asyncRate = CameraThroughput(camera, buffers);
+    gzdbg << "Asynchronous readback with " << buffers << " buffers: "
+          << asyncRate << " fps, "
+          << 100.0 * (asyncRate / syncRate - 1.0) << "% gain\n";
+  }
+
+  scene->RemoveCamera(camera->Name());
+}
+
+/////////////////////////////////////////////////
+/// \brief Measure the frames per second delivered by a growing number of
+/// camera sensors rendered in the same frames, along with the real time
+/// factor of the world.
+TEST_F(SensorStress_TEST, CameraCount)
+{
+  Load("worlds/shapes.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  const double rate = 30;
+  std::atomic<unsigned int> frames(0);
+  std::vector<event::ConnectionPtr> connections;
+
+  unsigned int count = 0;
+  for (unsigned int cameras = 1; cameras <= 8; cameras *= 2)
+  {
+    // Cameras on a circle around the shapes, looking at the origin
+    for (; count < cameras; ++count)
+    {
+      const double angle = 2 * IGN_PI * count / 8;
+      const std::string name = "stress_camera_" + std::to_string(count);
+      SpawnCamera(name + "_model", name,
+          ignition::math::Vector3d(-5 * cos(angle), -5 * sin(angle), 1),
+          ignition::math::Vector3d(0, 0, angle), 320, 240, rate);
+
+      sensors::CameraSensorPtr sensor =
+          std::dynamic_pointer_cast<sensors::CameraSensor>(
+          sensors::get_sensor(name));
+      ASSERT_TRUE(sensor != nullptr);
+      connections.push_back(sensor->Camera()->ConnectNewImageFrame(
+          [&frames](const unsigned char *, unsigned int, unsigned int,
+            unsigned int, const std::string &)
+          {
+            ++frames;
+          }));
+    }
+
+    // Let the new cameras settle
+    common::Time::MSleep(500);
+
+    frames = 0;
+    const common::Time simStart = world->SimTime();
+    common::Timer timer;
+    timer.Start();
+    common::Time::MSleep(3000);
+    const double elapsed = timer.GetElapsed().Double();
+    const double simElapsed = (world->SimTime() - simStart).Double();
+    const unsigned int measured = frames;
+
+    gzdbg << cameras << " cameras: "
+          << measured / elapsed << " fps, "
+          << measured / simElapsed / cameras
+          << " frames per simulated second per camera (requested "
+          << rate << "), real time factor " << simElapsed / elapsed
+          << "\n";
+    EXPECT_GT(measured, 0u);
+  }
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <string>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class SimbodySpawnTest : public ServerFixture
+{
+  /// \brief Spawn boxes in a row and wait until they're all in the world.
+  /// \param[in] _world World to spawn the boxes in.
+  /// \param[in] _prefix Prefix of the model names.
+  /// \param[in] _first Index of the first box.
+  /// \param[in] _count Number of boxes.
+  /// \param[in] _z Height of the boxes.
+  /// \return Wall time until the boxes are all in the world.
+  public: common::Time SpawnBoxes(physics::WorldPtr _world,
+              const std::string &_prefix, const unsigned int _first,
+              const unsigned int _count, const double _z);
+
+  /// \brief Number of boxes spawned at once.
+  public: static const unsigned int kBatchSize = 10;
+};
+
+/////////////////////////////////////////////////
+common::Time SimbodySpawnTest::SpawnBoxes(physics::WorldPtr _world,
+    const std::string &_prefix, const unsigned int _first,
+    const unsigned int _count, const double _z)
+{
+  const unsigned int modelCount = _world->ModelCount();
+  common::Time startTime = common::Time::GetWallTime();
+  for (unsigned int i = _first; i < _first + _count; ++i)
+  {
+    std::ostringstream modelStr;
+    modelStr << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='" << _prefix << i << "'>"
+      << "<pose>" << (i % 10) * 2.0 << " " << (i / 10) * 2.0 << " " << _z
+      << " 0 0 0</pose><link name='link'>"
+      << "<collision name='collision'><geometry><box>"
+      << "<size>1 1 1</size></box></geometry></collision></link>"
+      << "</model></sdf>";
+
+    msgs::Factory msg;
+    msg.set_sdf(modelStr.str());
+    this->factoryPub->Publish(msg);
+  }
+
+  // The models published together are added with a single realization
+  int sleep = 0;
+  while (_world->ModelCount() < modelCount + _count && sleep++ < 1000)
+  {
+    _world->Step(1);
+    common::Time::MSleep(1);
+  }
+  EXPECT_EQ(_world->ModelCount(), modelCount + _count);
+
+  return common::Time::GetWallTime() - startTime;
+}
+
+/////////////////////////////////////////////////
+TEST_F(SimbodySpawnTest, BatchLatency)
+{
+#ifndef HAVE_SIMBODY
+  gzerr << "Simbody is not available, skipping test" << std::endl;
+#else
+  Load("worlds/empty.world", true, "simbody");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  unsigned int worldSize = 0;
+  for (unsigned int size : {10u, 50u, 100u})
+  {
+    // Grow the world of resting boxes
+    this->SpawnBoxes(world, "box_", worldSize, size - worldSize, 0.5);
+    worldSize = size;
+    world->Step(100);
+
+    // Spawn a batch of boxes above the existing ones
+    common::Time elapsed =
+        this->SpawnBoxes(world, "spawned_", 0, kBatchSize, 2.0);
+    gzdbg << "Simbody world size[" << worldSize << "] spawn time["
+          << elapsed << "]\n";
+
+    // The existing boxes keep their state and the new ones fall on them
+    world->Step(1000);
+    physics::ModelPtr box = world->ModelByName("box_0");
+    EXPECT_TRUE(box != nullptr);
+    if (box)
+      EXPECT_NEAR(box->WorldPose().Pos().Z(), 0.5, 0.05);
+
+    physics::ModelPtr spawned = world->ModelByName("spawned_0");
+    EXPECT_TRUE(spawned != nullptr);
+    if (spawned)
+      EXPECT_NEAR(spawned->WorldPose().Pos().Z(), 1.5, 0.05);
+
+    // Make room for the next batch
+    for (unsigned int i = 0; i < kBatchSize; ++i)
+      world->RemoveModel("spawned_" + std::to_string(i));
+    world->Step(1);
+  }
+#endif
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/physics/WorldSnapshot.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class WorldSnapshotTest : public ServerFixture
+{
+  /// \brief Number of save and restore cycles measured.
+  public: static const unsigned int kCycles = 1000;
+};
+
+/////////////////////////////////////////////////
+TEST_F(WorldSnapshotTest, SaveRestore)
+{
+  this->Load("worlds/stacks.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  world->Step(100);
+
+  // World states
+  common::Time startTime = common::Time::GetWallTime();
+  for (unsigned int i = 0; i < kCycles; ++i)
+  {
+    physics::WorldState state(world);
+    world->SetState(state);
+  }
+  double stateTime =
+      (common::Time::GetWallTime() - startTime).Double() / kCycles;
+
+  // Snapshots
+  physics::WorldSnapshot snapshot;
+  startTime = common::Time::GetWallTime();
+  for (unsigned int i = 0; i < kCycles; ++i)
+  {
+    world->SaveSnapshot(snapshot);
+    EXPECT_TRUE(world->RestoreSnapshot(snapshot));
+  }
+  double snapshotTime =
+      (common::Time::GetWallTime() - startTime).Double() / kCycles;
+
+  gzdbg << "Models[" << world->ModelCount() << "] snapshot size["
+        << snapshot.ByteSize() << " B] world state cycle[" << stateTime
+        << " s] snapshot cycle[" << snapshotTime << " s]\n";
+  EXPECT_LT(snapshotTime, stateTime);
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}